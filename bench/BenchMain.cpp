@@ -0,0 +1,48 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include "Benchmark.h"
+
+#include <string.h>
+
+using namespace CPPCore;
+
+// Runs all registered benchmarks, the optional arguments are substrings of the benchmarks to run.
+int main(int argc, char *argv[]) {
+    std::vector<Bench::Entry> &entries = Bench::registry();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        bool selected = (argc < 2);
+        for (int arg = 1; arg < argc; ++arg) {
+            if (nullptr != ::strstr(entries[i].m_name, argv[arg])) {
+                selected = true;
+            }
+        }
+        if (!selected) {
+            continue;
+        }
+
+        ::printf("%s\n", entries[i].m_name);
+        entries[i].m_func();
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace CPPCore {
+namespace Bench {
+
+/// @brief  The signature of a benchmark function.
+using BenchFunc = void (*)();
+
+/// @brief  A registered benchmark.
+struct Entry {
+    const char *m_name;
+    BenchFunc m_func;
+};
+
+/// @brief  Returns all registered benchmarks.
+inline std::vector<Entry> &registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+/// @brief  Registers a benchmark at static initialization time, see CPPCORE_BENCHMARK.
+struct Registrar {
+    Registrar(const char *name, BenchFunc func) {
+        Entry entry = { name, func };
+        registry().push_back(entry);
+    }
+};
+
+/// @brief  A simple wall-clock timer with nanosecond resolution.
+class Timer {
+public:
+    Timer() :
+            m_start(std::chrono::steady_clock::now()) {
+        // empty
+    }
+
+    void reset() {
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    double elapsedNs() const {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/// @brief  Keeps the compiler from optimizing away a computed value.
+template <class T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/// @brief  Prints one result line: the name, the time per operation and the throughput.
+inline void report(const char *name, size_t numOps, double elapsedNs) {
+    const double nsPerOp = 0 == numOps ? 0.0 : elapsedNs / static_cast<double>(numOps);
+    const double mops = 0.0 == elapsedNs ? 0.0 : static_cast<double>(numOps) * 1000.0 / elapsedNs;
+    ::printf("  %-48s %12.2f ns/op %12.2f Mops/s\n", name, nsPerOp, mops);
+}
+
+/// @brief  Runs func numOps times and reports the result.
+template <class Func>
+inline double measure(const char *name, size_t numOps, Func func) {
+    Timer timer;
+    for (size_t i = 0; i < numOps; ++i) {
+        func(i);
+    }
+    const double elapsed = timer.elapsedNs();
+    report(name, numOps, elapsed);
+
+    return elapsed;
+}
+
+} // Namespace Bench
+} // Namespace CPPCore
+
+/// @def    CPPCORE_BENCHMARK
+/// @brief  Defines and registers a benchmark function.
+#define CPPCORE_BENCHMARK(name)                                                        \
+    static void name();                                                                \
+    static ::CPPCore::Bench::Registrar name##_registrar(#name, &name);                 \
+    static void name()
@@ -0,0 +1,136 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TGenerator.h>
+#include <cppcore/Async/TTask.h>
+
+#include "../Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+using namespace CPPCore;
+
+static const size_t NumOps = 10000000;
+
+// Counts the global heap allocations of the calling thread, a plain thread-local keeps the
+// overhead for the other benchmarks negligible
+static thread_local size_t t_numHeapAllocations = 0;
+
+void *operator new(size_t size) {
+    ++t_numHeapAllocations;
+    void *ptr = std::malloc(0 == size ? 1 : size);
+    if (nullptr == ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static void reportAllocations(const char *name, size_t numOps, size_t numAllocations) {
+    std::printf("  %-48s %8.3f allocs/op\n", name, static_cast<double>(numAllocations) / static_cast<double>(numOps));
+}
+
+static TTask<int> identity(int value) {
+    co_return value;
+}
+
+static TTask<int> awaitLoop(size_t count) {
+    int sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += co_await identity(1);
+    }
+    co_return sum;
+}
+
+// The callback flavour of identity(), the continuation carries some state like a real one
+static CPPCORE_NOINLINE void identityAsync(int value, std::function<void(int)> callback) {
+    callback(value);
+}
+
+static TGenerator<int> range(int count) {
+    for (int i = 0; i < count; ++i) {
+        co_yield i;
+    }
+}
+
+static CPPCORE_NOINLINE void visitRange(int count, const std::function<void(int)> &visitor) {
+    for (int i = 0; i < count; ++i) {
+        visitor(i);
+    }
+}
+
+CPPCORE_BENCHMARK(Coroutine_Switch) {
+    syncWait(awaitLoop(16));
+    FrameAllocator::resetThreadStats();
+    size_t heapBefore = t_numHeapAllocations;
+    Bench::Timer timer;
+    const int sum = syncWait(awaitLoop(NumOps));
+    Bench::report("co_await TTask<int> (frame + 2 switches)", NumOps, timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+    reportAllocations("TTask frames from FrameAllocator", NumOps, FrameAllocator::getThreadStats().m_numAllocations);
+    reportAllocations("TTask global heap", NumOps, t_numHeapAllocations - heapBefore);
+
+    heapBefore = t_numHeapAllocations;
+    int callbackSum = 0;
+    int numDone = 0;
+    size_t numSteps = 0;
+    timer = Bench::Timer();
+    for (size_t i = 0; i < NumOps; ++i) {
+        identityAsync(1, [&callbackSum, &numDone, &numSteps](int value) {
+            callbackSum += value;
+            ++numDone;
+            ++numSteps;
+        });
+    }
+    Bench::report("std::function callback", NumOps, timer.elapsedNs());
+    Bench::doNotOptimize(callbackSum);
+    reportAllocations("callback global heap", NumOps, t_numHeapAllocations - heapBefore);
+}
+
+CPPCORE_BENCHMARK(Coroutine_Generator) {
+    const int count = static_cast<int>(NumOps);
+    long long sum = 0;
+    Bench::Timer timer;
+    for (int value : range(count)) {
+        sum += value;
+    }
+    Bench::report("TGenerator<int> iteration", NumOps, timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+
+    sum = 0;
+    timer = Bench::Timer();
+    visitRange(count, [&sum](int value) {
+        sum += value;
+    });
+    Bench::report("std::function visitor", NumOps, timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+}
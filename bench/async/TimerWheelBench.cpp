@@ -0,0 +1,148 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TTimerWheel.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace CPPCore;
+
+// Timeouts of up to ~17 minutes in 1 ms ticks
+static const uint64_t MaxDelay = 1u << 20;
+
+// 10M timers by default, CPPCORE_BENCH_SIZE overrides it for smaller machines
+static size_t getNumTimers() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 10000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static std::vector<uint64_t> makeDelays(size_t numTimers) {
+    std::mt19937_64 random(1);
+    std::vector<uint64_t> delays(numTimers);
+    for (size_t i = 0; i < numTimers; ++i) {
+        delays[i] = 1 + random() % MaxDelay;
+    }
+    return delays;
+}
+
+CPPCORE_BENCHMARK(TimerWheel_10M) {
+    const size_t numTimers = getNumTimers();
+    const std::vector<uint64_t> delays = makeDelays(numTimers);
+
+    {
+        TTimerWheel<uint64_t> wheel(0, 1 << 16);
+        std::vector<TTimerWheel<uint64_t>::Handle> handles(numTimers);
+        Bench::Timer timer;
+        for (size_t i = 0; i < numTimers; ++i) {
+            handles[i] = wheel.scheduleAfter(delays[i], i);
+        }
+        Bench::report("TTimerWheel schedule", numTimers, timer.elapsedNs());
+
+        timer = Bench::Timer();
+        for (size_t i = 0; i < numTimers; i += 2) {
+            wheel.cancel(handles[i]);
+        }
+        Bench::report("TTimerWheel cancel (every 2nd)", numTimers / 2, timer.elapsedNs());
+
+        uint64_t sum = 0;
+        timer = Bench::Timer();
+        const size_t numExpired = wheel.advance(MaxDelay, [&sum](uint64_t id) { sum += id; });
+        Bench::report("TTimerWheel expire (1 ms ticks)", numExpired, timer.elapsedNs());
+        Bench::doNotOptimize(sum);
+    }
+
+    {
+        // The ordered map supports cancel, like an intrusive heap or a sorted list would
+        std::multimap<uint64_t, uint64_t> timers;
+        std::vector<std::multimap<uint64_t, uint64_t>::iterator> handles(numTimers);
+        Bench::Timer timer;
+        for (size_t i = 0; i < numTimers; ++i) {
+            handles[i] = timers.insert(std::make_pair(delays[i], i));
+        }
+        Bench::report("std::multimap schedule", numTimers, timer.elapsedNs());
+
+        timer = Bench::Timer();
+        for (size_t i = 0; i < numTimers; i += 2) {
+            timers.erase(handles[i]);
+        }
+        Bench::report("std::multimap cancel (every 2nd)", numTimers / 2, timer.elapsedNs());
+
+        uint64_t sum = 0;
+        size_t numExpired = 0;
+        timer = Bench::Timer();
+        for (uint64_t now = 1; now <= MaxDelay; ++now) {
+            while (!timers.empty() && timers.begin()->first <= now) {
+                sum += timers.begin()->second;
+                timers.erase(timers.begin());
+                ++numExpired;
+            }
+        }
+        Bench::report("std::multimap expire (1 ms ticks)", numExpired, timer.elapsedNs());
+        Bench::doNotOptimize(sum);
+    }
+
+    {
+        // A binary heap has no cancel, so only schedule and expire are compared
+        using Entry = std::pair<uint64_t, uint64_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        Bench::Timer timer;
+        for (size_t i = 0; i < numTimers; ++i) {
+            heap.push(Entry(delays[i], i));
+        }
+        Bench::report("std::priority_queue schedule", numTimers, timer.elapsedNs());
+
+        uint64_t sum = 0;
+        size_t numExpired = 0;
+        timer = Bench::Timer();
+        for (uint64_t now = 1; now <= MaxDelay; ++now) {
+            while (!heap.empty() && heap.top().first <= now) {
+                sum += heap.top().second;
+                heap.pop();
+                ++numExpired;
+            }
+        }
+        Bench::report("std::priority_queue expire (1 ms ticks)", numExpired, timer.elapsedNs());
+        Bench::doNotOptimize(sum);
+    }
+}
+
+CPPCORE_BENCHMARK(TimerWheel_Churn) {
+    // The typical connection timeout: armed, then cancelled before it fires
+    static const size_t NumOps = 10000000;
+    TTimerWheel<uint64_t> wheel;
+    TTimerWheel<uint64_t>::Handle handle;
+    Bench::measure("TTimerWheel schedule + cancel", NumOps, [&](size_t i) {
+        handle = wheel.scheduleAfter(30000, i);
+        wheel.cancel(handle);
+    });
+
+    std::multimap<uint64_t, uint64_t> timers;
+    Bench::measure("std::multimap schedule + cancel", NumOps, [&](size_t i) {
+        timers.erase(timers.insert(std::make_pair(30000 + i / 1000, i)));
+    });
+}
@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Common/TVariant.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <variant>
+#include <vector>
+
+using namespace CPPCore;
+
+// 10M operations by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumOps() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 10000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+using Number = TVariant<int, float, double>;
+using StdNumber = std::variant<int, float, double>;
+
+static constexpr size_t NumValues = 1024;
+
+// The legacy Variant has no visit, the type enum is switched by hand
+static double getLegacyValue(const Variant &variant) {
+    switch (variant.getType()) {
+        case Variant::Int:
+            return variant.getInt();
+        case Variant::Float:
+            return variant.getFloat();
+        default:
+            return 0.0;
+    }
+}
+
+CPPCORE_BENCHMARK(Variant_Assign) {
+    const size_t numOps = getNumOps();
+    double sink = 0.0;
+
+    Variant legacy;
+    Bench::measure("Variant set + read", numOps, [&](size_t i) {
+        if (0 == (i & 1)) {
+            legacy.setInt(static_cast<int>(i));
+        } else {
+            legacy.setFloat(static_cast<float>(i));
+        }
+        sink += getLegacyValue(legacy);
+    });
+
+    StdNumber standard;
+    Bench::measure("std::variant assign + visit", numOps, [&](size_t i) {
+        if (0 == (i & 1)) {
+            standard = static_cast<int>(i);
+        } else {
+            standard = static_cast<float>(i);
+        }
+        sink += std::visit([](auto value) { return static_cast<double>(value); }, standard);
+    });
+
+    Number number;
+    Bench::measure("TVariant assign + visit", numOps, [&](size_t i) {
+        if (0 == (i & 1)) {
+            number = static_cast<int>(i);
+        } else {
+            number = static_cast<float>(i);
+        }
+        sink += number.visit([](auto value) { return static_cast<double>(value); });
+    });
+    Bench::doNotOptimize(sink);
+}
+
+CPPCORE_BENCHMARK(Variant_Visit) {
+    const size_t numOps = getNumOps();
+    std::vector<Variant> legacy(NumValues);
+    std::vector<StdNumber> standard(NumValues);
+    std::vector<Number> numbers(NumValues);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < NumValues; ++i) {
+        // Random types, so the branch predictor cannot learn the order
+        state = state * 1664525u + 1013904223u;
+        switch (state >> 30) {
+            case 0:
+                legacy[i].setInt(static_cast<int>(i));
+                standard[i] = static_cast<int>(i);
+                numbers[i] = static_cast<int>(i);
+                break;
+            case 1:
+                legacy[i].setFloat(static_cast<float>(i));
+                standard[i] = static_cast<float>(i);
+                numbers[i] = static_cast<float>(i);
+                break;
+            default:
+                legacy[i].setFloat(static_cast<float>(i) * 0.5f);
+                standard[i] = static_cast<double>(i) * 0.5;
+                numbers[i] = static_cast<double>(i) * 0.5;
+                break;
+        }
+    }
+
+    double sink = 0.0;
+    Bench::measure("Variant visit, mixed types", numOps, [&](size_t i) {
+        sink += getLegacyValue(legacy[i & (NumValues - 1)]);
+    });
+    Bench::measure("std::variant visit, mixed types", numOps, [&](size_t i) {
+        sink += std::visit([](auto value) { return static_cast<double>(value); }, standard[i & (NumValues - 1)]);
+    });
+    Bench::measure("TVariant visit, mixed types", numOps, [&](size_t i) {
+        sink += numbers[i & (NumValues - 1)].visit([](auto value) { return static_cast<double>(value); });
+    });
+    Bench::doNotOptimize(sink);
+}
@@ -0,0 +1,189 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TArrayExpression.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+
+using namespace CPPCore;
+
+// 1M items by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumItems() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 1000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static void fill(TArray<float> &array, size_t size, float scale) {
+    array.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        array[i] = static_cast<float>(i % 101) * scale - 25.0f;
+    }
+}
+
+// Every operator of the naive version writes a temporary array, like an operator overload per step would
+static void multiplyNaive(const TArray<float> &a, const TArray<float> &b, TArray<float> &out) {
+    out.resize(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+static void addNaive(const TArray<float> &a, const TArray<float> &b, TArray<float> &out) {
+    out.resize(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+CPPCORE_BENCHMARK(ArrayExpression_Evaluate) {
+    const size_t numItems = getNumItems();
+    const size_t numRounds = 20;
+    TArray<float> a, b, c, out;
+    fill(a, numItems, 0.5f);
+    fill(b, numItems, 0.25f);
+    fill(c, numItems, 2.0f);
+    out.resize(numItems);
+
+    ExpressionOptions serial;
+    serial.m_parallelThreshold = std::numeric_limits<size_t>::max();
+
+    Bench::Timer timer;
+    for (size_t round = 0; round < numRounds; ++round) {
+        TArray<float> product, result;
+        multiplyNaive(b, c, product);
+        addNaive(product, a, result);
+        Bench::doNotOptimize(result[round]);
+    }
+    Bench::report("out = b * c + a, temporaries", numItems * numRounds, timer.elapsedNs());
+
+    const float *pa = &a[0], *pb = &b[0], *pc = &c[0];
+    float *po = &out[0];
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (size_t i = 0; i < numItems; ++i) {
+            po[i] = pb[i] * pc[i] + pa[i];
+        }
+        Bench::doNotOptimize(po[round]);
+    }
+    Bench::report("out = b * c + a, hand loop", numItems * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        evaluate(out, lazy(b) * lazy(c) + lazy(a), serial);
+        Bench::doNotOptimize(out[round]);
+    }
+    Bench::report("out = b * c + a, fused", numItems * numRounds, timer.elapsedNs());
+
+    ExpressionOptions parallel;
+    parallel.m_parallelThreshold = 0;
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        evaluate(out, lazy(b) * lazy(c) + lazy(a), parallel);
+        Bench::doNotOptimize(out[round]);
+    }
+    Bench::report("out = b * c + a, fused parallel", numItems * numRounds, timer.elapsedNs());
+}
+
+CPPCORE_BENCHMARK(ArrayExpression_Reduce) {
+    const size_t numItems = getNumItems();
+    const size_t numRounds = 20;
+    TArray<float> a, b;
+    fill(a, numItems, 0.5f);
+    fill(b, numItems, 0.25f);
+    const float *pa = &a[0], *pb = &b[0];
+
+    ExpressionOptions serial;
+    serial.m_parallelThreshold = std::numeric_limits<size_t>::max();
+    float sink = 0.0f;
+
+    Bench::Timer timer;
+    for (size_t round = 0; round < numRounds; ++round) {
+        float result = 0.0f;
+        for (size_t i = 0; i < numItems; ++i) {
+            result += pa[i] * pb[i];
+        }
+        sink += result;
+    }
+    Bench::report("dot, hand loop", numItems * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        sink += dot(lazy(a), lazy(b), serial);
+    }
+    Bench::report("dot, expression", numItems * numRounds, timer.elapsedNs());
+
+    // The masked sum without fusion needs a mask array and a selected array
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        TArray<bool> mask;
+        TArray<float> selected;
+        mask.resize(numItems);
+        selected.resize(numItems);
+        for (size_t i = 0; i < numItems; ++i) {
+            mask[i] = pa[i] > 0.0f;
+        }
+        for (size_t i = 0; i < numItems; ++i) {
+            selected[i] = mask[i] ? pa[i] * pb[i] : 0.0f;
+        }
+        float result = 0.0f;
+        for (size_t i = 0; i < numItems; ++i) {
+            result += selected[i];
+        }
+        sink += result;
+    }
+    Bench::report("masked dot, temporaries", numItems * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        float result = 0.0f;
+        for (size_t i = 0; i < numItems; ++i) {
+            result += pa[i] > 0.0f ? pa[i] * pb[i] : 0.0f;
+        }
+        sink += result;
+    }
+    Bench::report("masked dot, hand loop", numItems * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        sink += sum(where(lazy(a) > 0.0f, lazy(a) * lazy(b), 0.0f), serial);
+    }
+    Bench::report("masked dot, fused", numItems * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    size_t numPositive = 0;
+    for (size_t round = 0; round < numRounds; ++round) {
+        numPositive += count(lazy(a) > 0.0f, serial);
+    }
+    Bench::report("count a > 0, fused", numItems * numRounds, timer.elapsedNs());
+
+    ExpressionOptions parallel;
+    parallel.m_parallelThreshold = 0;
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        sink += sum(where(lazy(a) > 0.0f, lazy(a) * lazy(b), 0.0f), parallel);
+    }
+    Bench::report("masked dot, fused parallel", numItems * numRounds, timer.elapsedNs());
+    Bench::doNotOptimize(sink);
+    Bench::doNotOptimize(numPositive);
+}
@@ -0,0 +1,130 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TDenseHashMap.h>
+#include <cppcore/Container/THashMap.h>
+#include <cppcore/Container/TPerfectHashMap.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace CPPCore;
+
+// 8M keys by default, so every table is far larger than the last level cache,
+// CPPCORE_BENCH_SIZE overrides it
+static size_t getNumKeys() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 8000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// The number of keys per findBatch call, like the rows of one batch in a join
+static constexpr size_t BatchSize = 1024;
+
+template <class TFind>
+static void measureScalar(const char *label, const std::vector<uint32_t> &queries, TFind find) {
+    uint64_t sum = 0;
+    Bench::Timer timer;
+    for (uint32_t query : queries) {
+        const uint32_t *value = find(query);
+        sum += nullptr == value ? 0 : *value;
+    }
+    Bench::report(label, queries.size(), timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+}
+
+template <class TFindBatch>
+static void measureBatch(const char *label, const std::vector<uint32_t> &queries, TFindBatch findBatch) {
+    const uint32_t *values[BatchSize];
+    uint64_t sum = 0;
+    Bench::Timer timer;
+    for (size_t begin = 0; begin < queries.size(); begin += BatchSize) {
+        const size_t count = std::min(BatchSize, queries.size() - begin);
+        findBatch(&queries[begin], count, values);
+        for (size_t i = 0; i < count; ++i) {
+            sum += nullptr == values[i] ? 0 : *values[i];
+        }
+    }
+    Bench::report(label, queries.size(), timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+}
+
+CPPCORE_BENCHMARK(BatchLookup_LargeTables) {
+    const size_t numKeys = getNumKeys();
+    std::vector<uint32_t> keys(numKeys);
+    std::vector<uint32_t> values(numKeys);
+    for (size_t i = 0; i < numKeys; ++i) {
+        keys[i] = static_cast<uint32_t>(i * 2654435761u);
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    // Random probes, every eighth one misses
+    std::vector<uint32_t> queries(numKeys);
+    uint64_t random = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < numKeys; ++i) {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        const uint32_t key = keys[random % numKeys];
+        queries[i] = 0 == i % 8 ? key ^ 1u : key;
+    }
+
+    {
+        THashMap<uint32_t, uint32_t> hashMap(numKeys);
+        for (size_t i = 0; i < numKeys; ++i) {
+            hashMap.insert(keys[i], values[i]);
+        }
+        uint32_t value = 0;
+        measureScalar("THashMap, scalar getValue", queries, [&hashMap, &value](uint32_t key) {
+            return hashMap.getValue(key, value) ? &value : nullptr;
+        });
+        measureBatch("THashMap, findBatch", queries, [&hashMap](const uint32_t *batch, size_t count, const uint32_t **found) {
+            hashMap.findBatch(batch, count, found);
+        });
+    }
+
+    {
+        TDenseHashMap<uint32_t, uint32_t> denseMap;
+        denseMap.reserve(numKeys);
+        for (size_t i = 0; i < numKeys; ++i) {
+            denseMap.insert(keys[i], values[i]);
+        }
+        measureScalar("TDenseHashMap, scalar find", queries, [&denseMap](uint32_t key) {
+            return denseMap.find(key);
+        });
+        measureBatch("TDenseHashMap, findBatch", queries, [&denseMap](const uint32_t *batch, size_t count, const uint32_t **found) {
+            denseMap.findBatch(batch, count, found);
+        });
+    }
+
+    {
+        TPerfectHashMap<uint32_t, uint32_t> perfectMap;
+        perfectMap.init(keys.data(), values.data(), numKeys);
+        measureScalar("TPerfectHashMap, scalar find", queries, [&perfectMap](uint32_t key) {
+            return perfectMap.find(key);
+        });
+        measureBatch("TPerfectHashMap, findBatch", queries, [&perfectMap](const uint32_t *batch, size_t count, const uint32_t **found) {
+            perfectMap.findBatch(batch, count, found);
+        });
+    }
+}
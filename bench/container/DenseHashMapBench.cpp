@@ -0,0 +1,165 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TDenseHashMap.h>
+#include <cppcore/Container/THashMap.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+using namespace CPPCore;
+
+// 1M keys by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumKeys() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 1000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static std::vector<uint32_t> getKeys(size_t numKeys) {
+    std::vector<uint32_t> keys(numKeys);
+    uint32_t random = 0x9e3779b9u;
+    for (size_t i = 0; i < numKeys; ++i) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        // Unique keys, the low bits count up
+        keys[i] = (random & 0xfff00000u) | static_cast<uint32_t>(i);
+    }
+    return keys;
+}
+
+CPPCORE_BENCHMARK(DenseHashMap_Build) {
+    const size_t numKeys = getNumKeys();
+    const std::vector<uint32_t> keys = getKeys(numKeys);
+
+    Bench::Timer timer;
+    TDenseHashMap<uint32_t, uint32_t> denseMap;
+    for (size_t i = 0; i < numKeys; ++i) {
+        denseMap.insert(keys[i], static_cast<uint32_t>(i));
+    }
+    Bench::report("TDenseHashMap insert", numKeys, timer.elapsedNs());
+
+    timer.reset();
+    THashMap<uint32_t, uint32_t> hashMap(numKeys);
+    for (size_t i = 0; i < numKeys; ++i) {
+        hashMap.insert(keys[i], static_cast<uint32_t>(i));
+    }
+    Bench::report("THashMap insert, presized", numKeys, timer.elapsedNs());
+
+    timer.reset();
+    std::unordered_map<uint32_t, uint32_t> unorderedMap;
+    for (size_t i = 0; i < numKeys; ++i) {
+        unorderedMap[keys[i]] = static_cast<uint32_t>(i);
+    }
+    Bench::report("std::unordered_map insert", numKeys, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t i = 0; i < numKeys; i += 2) {
+        denseMap.remove(keys[i]);
+    }
+    Bench::report("TDenseHashMap remove", numKeys / 2, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t i = 0; i < numKeys; i += 2) {
+        unorderedMap.erase(keys[i]);
+    }
+    Bench::report("std::unordered_map erase", numKeys / 2, timer.elapsedNs());
+}
+
+CPPCORE_BENCHMARK(DenseHashMap_Iterate) {
+    const size_t numKeys = getNumKeys();
+    const size_t numRounds = 20;
+    const std::vector<uint32_t> keys = getKeys(numKeys);
+
+    TDenseHashMap<uint32_t, uint32_t> denseMap;
+    THashMap<uint32_t, uint32_t> hashMap(numKeys);
+    std::unordered_map<uint32_t, uint32_t> unorderedMap;
+    for (size_t i = 0; i < numKeys; ++i) {
+        denseMap.insert(keys[i], static_cast<uint32_t>(i));
+        hashMap.insert(keys[i], static_cast<uint32_t>(i));
+        unorderedMap[keys[i]] = static_cast<uint32_t>(i);
+    }
+
+    uint64_t sum = 0;
+    Bench::Timer timer;
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (const auto &entry : denseMap) {
+            sum += entry.m_value;
+        }
+    }
+    Bench::report("TDenseHashMap full scan", numKeys * numRounds, timer.elapsedNs());
+
+    // THashMap cannot be iterated, the keys are shadowed in an array and looked up
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (size_t i = 0; i < numKeys; ++i) {
+            uint32_t value = 0;
+            hashMap.getValue(keys[i], value);
+            sum += value;
+        }
+    }
+    Bench::report("THashMap + shadow key array full scan", numKeys * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (const auto &entry : unorderedMap) {
+            sum += entry.second;
+        }
+    }
+    Bench::report("std::unordered_map full scan", numKeys * numRounds, timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+}
+
+CPPCORE_BENCHMARK(DenseHashMap_Lookup) {
+    const size_t numKeys = getNumKeys();
+    const size_t numLookups = numKeys * 10;
+    const std::vector<uint32_t> keys = getKeys(numKeys);
+
+    TDenseHashMap<uint32_t, uint32_t> denseMap;
+    THashMap<uint32_t, uint32_t> hashMap(numKeys);
+    std::unordered_map<uint32_t, uint32_t> unorderedMap;
+    for (size_t i = 0; i < numKeys; ++i) {
+        denseMap.insert(keys[i], static_cast<uint32_t>(i));
+        hashMap.insert(keys[i], static_cast<uint32_t>(i));
+        unorderedMap[keys[i]] = static_cast<uint32_t>(i);
+    }
+
+    uint64_t sum = 0;
+    Bench::measure("TDenseHashMap lookup", numLookups, [&](size_t i) {
+        sum += *denseMap.find(keys[(i * 7919) % numKeys]);
+    });
+    Bench::measure("THashMap lookup", numLookups, [&](size_t i) {
+        uint32_t value = 0;
+        hashMap.getValue(keys[(i * 7919) % numKeys], value);
+        sum += value;
+    });
+    Bench::measure("std::unordered_map lookup", numLookups, [&](size_t i) {
+        sum += unorderedMap.find(keys[(i * 7919) % numKeys])->second;
+    });
+    Bench::measure("TDenseHashMap miss", numLookups, [&](size_t i) {
+        sum += denseMap.hasKey(keys[(i * 7919) % numKeys] ^ 0x80000u) ? 1 : 0;
+    });
+    Bench::doNotOptimize(sum);
+}
@@ -0,0 +1,122 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TArray.h>
+#include <cppcore/Container/TInlineArray.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+
+using namespace CPPCore;
+
+// 10M operations by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumOps() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 10000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// Collects up to 8 values of a small hot-path query, like the contacts of a body
+template <class TCollection>
+static uint32_t collect(TCollection &values, size_t i) {
+    const uint32_t count = (static_cast<uint32_t>(i * 2654435761u) >> 29) + 1;
+    for (uint32_t j = 0; j < count; ++j) {
+        values.add(static_cast<uint32_t>(i) + j);
+    }
+    uint32_t sum = 0;
+    for (size_t j = 0; j < values.size(); ++j) {
+        sum += values[j];
+    }
+    return sum;
+}
+
+CPPCORE_BENCHMARK(InlineArray_Collect) {
+    const size_t numOps = getNumOps();
+    uint32_t sum = 0;
+
+    Bench::measure("TInlineArray<8> local", numOps, [&sum](size_t i) {
+        TInlineArray<uint32_t, 8> values;
+        sum += collect(values, i);
+    });
+    Bench::measure("TArray local", numOps, [&sum](size_t i) {
+        TArray<uint32_t> values;
+        sum += collect(values, i);
+    });
+
+    TArray<uint32_t> reused;
+    reused.reserve(8);
+    Bench::measure("TArray reused", numOps, [&sum, &reused](size_t i) {
+        reused.resize(0);
+        sum += collect(reused, i);
+    });
+    Bench::doNotOptimize(sum);
+}
+
+CPPCORE_BENCHMARK(InlineArray_Copy) {
+    const size_t numOps = getNumOps();
+    uint32_t sum = 0;
+
+    TInlineArray<uint32_t, 8> inlineValues;
+    TArray<uint32_t> arrayValues;
+    collect(inlineValues, 5);
+    collect(arrayValues, 5);
+
+    // A copy per operation, as when a small collection is returned or stored by value
+    Bench::measure("TInlineArray<8> copy", numOps, [&sum, &inlineValues](size_t i) {
+        inlineValues[0] = static_cast<uint32_t>(i);
+        TInlineArray<uint32_t, 8> copy = inlineValues;
+        Bench::doNotOptimize(copy);
+        sum += copy[0];
+    });
+    Bench::measure("TArray copy", numOps, [&sum, &arrayValues](size_t i) {
+        arrayValues[0] = static_cast<uint32_t>(i);
+        TArray<uint32_t> copy = arrayValues;
+        Bench::doNotOptimize(copy);
+        sum += copy[0];
+    });
+    Bench::doNotOptimize(sum);
+}
+
+CPPCORE_BENCHMARK(InlineArray_InsertRemove) {
+    const size_t numOps = getNumOps();
+    TInlineArray<uint32_t, 16> inlineValues;
+    TArray<uint32_t> arrayValues;
+    for (uint32_t i = 0; i < 8; ++i) {
+        inlineValues.add(i);
+        arrayValues.add(i);
+    }
+
+    // Keeps 8 items, one add and one ordered remove per operation
+    Bench::measure("TInlineArray<16> add + remove", numOps, [&inlineValues](size_t i) {
+        inlineValues.add(static_cast<uint32_t>(i));
+        inlineValues.remove((i >> 3) & 7);
+    });
+    Bench::measure("TArray add + remove", numOps, [&arrayValues](size_t i) {
+        arrayValues.add(static_cast<uint32_t>(i));
+        arrayValues.remove((i >> 3) & 7);
+    });
+    Bench::measure("TInlineArray<16> insert + remove", numOps, [&inlineValues](size_t i) {
+        inlineValues.insert(i & 7, static_cast<uint32_t>(i));
+        inlineValues.remove((i >> 3) & 7);
+    });
+    Bench::doNotOptimize(inlineValues[0] + arrayValues[0]);
+}
@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/THashMap.h>
+#include <cppcore/Container/TPerfectHashMap.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace CPPCore;
+
+// 20M lookups by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumLookups() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 20000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// The C++ keywords as an example of a fixed name set
+static constexpr auto Keywords = makePerfectHashMap<std::string_view, int>({
+        { "alignas", 0 }, { "alignof", 1 }, { "and", 2 }, { "asm", 3 }, { "auto", 4 }, { "bool", 5 },
+        { "break", 6 }, { "case", 7 }, { "catch", 8 }, { "char", 9 }, { "char8_t", 10 }, { "char16_t", 11 },
+        { "char32_t", 12 }, { "class", 13 }, { "concept", 14 }, { "const", 15 }, { "consteval", 16 },
+        { "constexpr", 17 }, { "constinit", 18 }, { "const_cast", 19 }, { "continue", 20 }, { "co_await", 21 },
+        { "co_return", 22 }, { "co_yield", 23 }, { "decltype", 24 }, { "default", 25 }, { "delete", 26 },
+        { "do", 27 }, { "double", 28 }, { "dynamic_cast", 29 }, { "else", 30 }, { "enum", 31 }, { "explicit", 32 },
+        { "export", 33 }, { "extern", 34 }, { "false", 35 }, { "float", 36 }, { "for", 37 }, { "friend", 38 },
+        { "goto", 39 }, { "if", 40 }, { "inline", 41 }, { "int", 42 }, { "long", 43 }, { "mutable", 44 },
+        { "namespace", 45 }, { "new", 46 }, { "noexcept", 47 }, { "not", 48 }, { "nullptr", 49 },
+        { "operator", 50 }, { "or", 51 }, { "private", 52 }, { "protected", 53 }, { "public", 54 },
+        { "register", 55 }, { "reinterpret_cast", 56 }, { "requires", 57 }, { "return", 58 }, { "short", 59 },
+        { "signed", 60 }, { "sizeof", 61 }, { "static", 62 }, { "static_assert", 63 }, { "static_cast", 64 },
+        { "struct", 65 }, { "switch", 66 }, { "template", 67 }, { "this", 68 }, { "thread_local", 69 },
+        { "throw", 70 }, { "true", 71 }, { "try", 72 }, { "typedef", 73 }, { "typeid", 74 }, { "typename", 75 },
+        { "union", 76 }, { "unsigned", 77 }, { "using", 78 }, { "virtual", 79 }, { "void", 80 },
+        { "volatile", 81 }, { "wchar_t", 82 }, { "while", 83 }, { "xor", 84 } });
+
+static const unsigned int HashBase = 1000003;
+
+// Every eighth query is not a keyword
+static std::vector<std::string> getQueries() {
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < 1024; ++i) {
+        const auto &entry = Keywords.begin()[(i * 37) % Keywords.size()];
+        queries.push_back(0 == i % 8 ? std::string(entry.m_key) + "_x" : std::string(entry.m_key));
+    }
+    return queries;
+}
+
+CPPCORE_BENCHMARK(PerfectHash_StaticKeys) {
+    const size_t numLookups = getNumLookups();
+    const std::vector<std::string> queries = getQueries();
+
+    // Looked up by hash only, like the existing call sites do it
+    THashMap<unsigned int, int> hashMap;
+    std::unordered_map<std::string_view, int> unorderedMap;
+    for (const auto &entry : Keywords) {
+        const std::string key(entry.m_key);
+        hashMap.insert(Hash::toHash(key.c_str(), HashBase), entry.m_value);
+        unorderedMap[entry.m_key] = entry.m_value;
+    }
+
+    int sum = 0;
+    Bench::measure("TStaticPerfectHashMap, 85 keywords", numLookups, [&](size_t i) {
+        const int *value = Keywords.find(queries[i & 1023]);
+        sum += nullptr == value ? -1 : *value;
+    });
+    Bench::measure("THashMap + Hash::toHash, 85 keywords", numLookups, [&](size_t i) {
+        int value = -1;
+        hashMap.getValue(Hash::toHash(queries[i & 1023].c_str(), HashBase), value);
+        sum += value;
+    });
+    Bench::measure("std::unordered_map, 85 keywords", numLookups, [&](size_t i) {
+        const auto it = unorderedMap.find(queries[i & 1023]);
+        sum += unorderedMap.end() == it ? -1 : it->second;
+    });
+    Bench::doNotOptimize(sum);
+}
+
+CPPCORE_BENCHMARK(PerfectHash_DynamicKeys) {
+    const size_t numLookups = getNumLookups();
+    const size_t numKeys = 1000000;
+    std::vector<uint64_t> keys(numKeys);
+    std::vector<uint32_t> values(numKeys);
+    uint64_t random = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < numKeys; ++i) {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        keys[i] = random;
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    TPerfectHashMap<uint64_t, uint32_t> perfectMap;
+    Bench::Timer timer;
+    perfectMap.init(keys.data(), values.data(), numKeys);
+    Bench::report("TPerfectHashMap build, 1M keys", numKeys, timer.elapsedNs());
+
+    std::unordered_map<uint64_t, uint32_t> unorderedMap;
+    unorderedMap.reserve(numKeys);
+    timer.reset();
+    for (size_t i = 0; i < numKeys; ++i) {
+        unorderedMap[keys[i]] = values[i];
+    }
+    Bench::report("std::unordered_map build, 1M keys", numKeys, timer.elapsedNs());
+
+    uint64_t sum = 0;
+    Bench::measure("TPerfectHashMap lookup, 1M keys", numLookups, [&](size_t i) {
+        sum += *perfectMap.find(keys[(i * 7919) % numKeys]);
+    });
+    Bench::measure("std::unordered_map lookup, 1M keys", numLookups, [&](size_t i) {
+        sum += unorderedMap.find(keys[(i * 7919) % numKeys])->second;
+    });
+    Bench::doNotOptimize(sum);
+}
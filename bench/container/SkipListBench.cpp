@@ -0,0 +1,125 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TConcurrentSkipList.h>
+
+#include "../Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const size_t MaxThreads = 16;
+static const uint64_t NumKeys = 1 << 20;
+
+// 4M operations by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumOps() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 4000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// 80 % lookups, 10 % inserts and 10 % removes on random keys of a half filled key space
+template <class Map>
+static void runMixed(const char *name, Map &map) {
+    const size_t numOps = getNumOps();
+    for (uint64_t key = 0; key < NumKeys; key += 2) {
+        map.insert(key, key);
+    }
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        const size_t perThread = numOps / numThreads;
+        std::atomic<bool> start(false);
+        std::atomic<uint64_t> numFound(0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&map, &start, &numFound, perThread, t]() {
+                uint64_t random = 0x9e3779b97f4a7c15ull * (t + 1);
+                uint64_t found = 0;
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < perThread; ++i) {
+                    random ^= random << 13;
+                    random ^= random >> 7;
+                    random ^= random << 17;
+                    const uint64_t key = (random >> 8) % NumKeys;
+                    const uint64_t op = random % 10;
+                    if (op < 8) {
+                        found += map.contains(key) ? 1 : 0;
+                    } else if (8 == op) {
+                        map.insert(key, key);
+                    } else {
+                        map.remove(key);
+                    }
+                }
+                numFound.fetch_add(found);
+            }));
+        }
+        Bench::Timer timer;
+        start.store(true, std::memory_order_release);
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " threads=" + std::to_string(numThreads);
+        Bench::report(label.c_str(), perThread * numThreads, timer.elapsedNs());
+        Bench::doNotOptimize(numFound.load());
+    }
+}
+
+class LockedMap {
+public:
+    bool insert(uint64_t key, uint64_t value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_map.insert(std::make_pair(key, value)).second;
+    }
+
+    bool remove(uint64_t key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return 1 == m_map.erase(key);
+    }
+
+    bool contains(uint64_t key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_map.end() != m_map.find(key);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<uint64_t, uint64_t> m_map;
+};
+
+CPPCORE_BENCHMARK(SkipList_Mixed) {
+    {
+        TConcurrentSkipList<uint64_t, uint64_t> list;
+        runMixed("TConcurrentSkipList 80/10/10", list);
+    }
+    TConcurrentSkipList<uint64_t, uint64_t>::flushRetired();
+    Rcu::barrier();
+
+    LockedMap map;
+    runMixed("std::map + std::mutex 80/10/10", map);
+}
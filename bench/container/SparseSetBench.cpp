@@ -0,0 +1,196 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/THashMap.h>
+#include <cppcore/Container/TSparseSet.h>
+
+#include "../Benchmark.h"
+
+#include <bit>
+#include <cstdlib>
+#include <vector>
+
+using namespace CPPCore;
+
+// 1M ids by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumIds() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 1000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// Random ids, a quarter of the id range is in use like in an entity system with many dead ids
+static std::vector<uint32_t> getIds(size_t numIds) {
+    std::vector<uint32_t> ids(numIds);
+    uint32_t random = 0x9e3779b9u;
+    for (size_t i = 0; i < numIds; ++i) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        ids[i] = static_cast<uint32_t>(i * 4) + (random & 3u);
+    }
+    for (size_t i = numIds - 1; i > 0; --i) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        std::swap(ids[i], ids[random % (i + 1)]);
+    }
+    return ids;
+}
+
+// A plain bitset over the id range with a value array indexed by id
+struct BitSet {
+    std::vector<uint64_t> m_bits;
+    std::vector<uint32_t> m_values;
+
+    explicit BitSet(size_t range) :
+            m_bits((range + 63) / 64),
+            m_values(range) {
+        // empty
+    }
+
+    void insert(uint32_t id, uint32_t value) {
+        m_bits[id >> 6] |= uint64_t(1) << (id & 63);
+        m_values[id] = value;
+    }
+
+    bool contains(uint32_t id) const {
+        return 0 != (m_bits[id >> 6] & (uint64_t(1) << (id & 63)));
+    }
+};
+
+CPPCORE_BENCHMARK(SparseSet_Build) {
+    const size_t numIds = getNumIds();
+    const std::vector<uint32_t> ids = getIds(numIds);
+
+    Bench::Timer timer;
+    TSparseSet<uint32_t> sparseSet;
+    for (size_t i = 0; i < numIds; ++i) {
+        sparseSet.insert(ids[i], static_cast<uint32_t>(i));
+    }
+    Bench::report("TSparseSet insert", numIds, timer.elapsedNs());
+
+    timer.reset();
+    THashMap<uint32_t, uint32_t> hashMap(numIds);
+    for (size_t i = 0; i < numIds; ++i) {
+        hashMap.insert(ids[i], static_cast<uint32_t>(i));
+    }
+    Bench::report("THashMap insert, presized", numIds, timer.elapsedNs());
+
+    timer.reset();
+    BitSet bitSet(numIds * 4);
+    for (size_t i = 0; i < numIds; ++i) {
+        bitSet.insert(ids[i], static_cast<uint32_t>(i));
+    }
+    Bench::report("bitset insert", numIds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t i = 0; i < numIds; i += 2) {
+        sparseSet.remove(ids[i]);
+    }
+    Bench::report("TSparseSet remove", numIds / 2, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t i = 0; i < numIds; i += 2) {
+        hashMap.remove(ids[i]);
+    }
+    Bench::report("THashMap remove", numIds / 2, timer.elapsedNs());
+
+    timer.reset();
+    sparseSet.sort();
+    Bench::report("TSparseSet sort", sparseSet.size(), timer.elapsedNs());
+}
+
+CPPCORE_BENCHMARK(SparseSet_Contains) {
+    const size_t numIds = getNumIds();
+    const size_t numLookups = numIds * 4;
+    const std::vector<uint32_t> ids = getIds(numIds);
+
+    TSparseSet<uint32_t> sparseSet;
+    THashMap<uint32_t, uint32_t> hashMap(numIds);
+    BitSet bitSet(numIds * 4);
+    for (size_t i = 0; i < numIds; ++i) {
+        sparseSet.insert(ids[i], static_cast<uint32_t>(i));
+        hashMap.insert(ids[i], static_cast<uint32_t>(i));
+        bitSet.insert(ids[i], static_cast<uint32_t>(i));
+    }
+
+    // Queries over the whole id range, a quarter of them hits
+    const uint32_t range = static_cast<uint32_t>(numIds * 4);
+    size_t hits = 0;
+    Bench::measure("TSparseSet contains, 25% hits", numLookups, [&sparseSet, &hits, range](size_t i) {
+        hits += sparseSet.contains(static_cast<uint32_t>(i * 2654435761u) % range);
+    });
+    Bench::measure("THashMap hasKey, 25% hits", numLookups, [&hashMap, &hits, range](size_t i) {
+        hits += hashMap.hasKey(static_cast<uint32_t>(i * 2654435761u) % range);
+    });
+    Bench::measure("bitset contains, 25% hits", numLookups, [&bitSet, &hits, range](size_t i) {
+        hits += bitSet.contains(static_cast<uint32_t>(i * 2654435761u) % range);
+    });
+    Bench::doNotOptimize(hits);
+}
+
+CPPCORE_BENCHMARK(SparseSet_Iterate) {
+    const size_t numIds = getNumIds();
+    const size_t numRounds = 20;
+    const std::vector<uint32_t> ids = getIds(numIds);
+
+    TSparseSet<uint32_t> sparseSet;
+    THashMap<uint32_t, uint32_t> hashMap(numIds);
+    BitSet bitSet(numIds * 4);
+    for (size_t i = 0; i < numIds; ++i) {
+        sparseSet.insert(ids[i], static_cast<uint32_t>(i));
+        hashMap.insert(ids[i], static_cast<uint32_t>(i));
+        bitSet.insert(ids[i], static_cast<uint32_t>(i));
+    }
+
+    uint64_t sum = 0;
+    Bench::Timer timer;
+    for (size_t round = 0; round < numRounds; ++round) {
+        const uint32_t *values = sparseSet.getValues();
+        for (size_t i = 0; i < sparseSet.size(); ++i) {
+            sum += values[i];
+        }
+    }
+    Bench::report("TSparseSet dense scan", numIds * numRounds, timer.elapsedNs());
+
+    // THashMap cannot be iterated, the ids are shadowed in an array and looked up
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (size_t i = 0; i < numIds; ++i) {
+            uint32_t value = 0;
+            hashMap.getValue(ids[i], value);
+            sum += value;
+        }
+    }
+    Bench::report("THashMap + shadow id array scan", numIds * numRounds, timer.elapsedNs());
+
+    timer.reset();
+    for (size_t round = 0; round < numRounds; ++round) {
+        for (size_t word = 0; word < bitSet.m_bits.size(); ++word) {
+            for (uint64_t bits = bitSet.m_bits[word]; 0 != bits; bits &= bits - 1) {
+                sum += bitSet.m_values[word * 64 + std::countr_zero(bits)];
+            }
+        }
+    }
+    Bench::report("bitset scan", numIds * numRounds, timer.elapsedNs());
+    Bench::doNotOptimize(sum);
+}
@@ -0,0 +1,164 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TStaticArray.h>
+
+#include "../Benchmark.h"
+
+#include <array>
+#include <cstdlib>
+
+using namespace CPPCore;
+
+// 10M operations by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumOps() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 10000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// The previous TStaticArray, with its size member, scalar loops and the compare in operator=
+template <class T, size_t len>
+class LegacyStaticArray {
+public:
+    LegacyStaticArray() :
+            m_len(len) {
+        // empty
+    }
+
+    LegacyStaticArray(const LegacyStaticArray<T, len> &rhs) :
+            m_len(rhs.m_len) {
+        for (size_t i = 0; i < m_len; ++i) {
+            m_array[i] = rhs.m_array[i];
+        }
+    }
+
+    void memset(T value) {
+        for (size_t i = 0; i < m_len; ++i) {
+            m_array[i] = value;
+        }
+    }
+
+    T &operator[](size_t index) {
+        return m_array[index];
+    }
+
+    bool operator==(const LegacyStaticArray<T, len> &rhs) const {
+        for (size_t i = 0; i < m_len; ++i) {
+            if (m_array[i] != rhs.m_array[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    LegacyStaticArray<T, len> &operator=(const LegacyStaticArray<T, len> &rhs) {
+        if (*this == rhs) {
+            return *this;
+        }
+        for (unsigned int i = 0; i < m_len; ++i) {
+            m_array[i] = rhs.m_array[i];
+        }
+        return *this;
+    }
+
+private:
+    T m_array[len];
+    size_t m_len;
+};
+
+static const size_t Length = 256;
+
+template <class TArray>
+static void runBulk(const char *fillName, const char *compareName, const char *copyName) {
+    const size_t numOps = getNumOps();
+    // Same alignment for all, a misaligned array splits every vector store
+    alignas(64) TArray a;
+    alignas(64) TArray b;
+    a.memset(1);
+    b.memset(1);
+
+    // The address is passed, a trivially copyable array would be copied by value
+    Bench::measure(fillName, numOps, [&](size_t i) {
+        a.memset(static_cast<int>(i & 1));
+        Bench::doNotOptimize(&a);
+    });
+
+    a.memset(3);
+    b.memset(3);
+    size_t numEqual = 0;
+    Bench::measure(compareName, numOps, [&](size_t) {
+        Bench::doNotOptimize(&a);
+        numEqual += a == b ? 1 : 0;
+    });
+    Bench::doNotOptimize(numEqual);
+
+    // Copies differing arrays, the legacy operator= compares them first
+    Bench::measure(copyName, numOps, [&](size_t i) {
+        b[i % Length] = static_cast<int>(i);
+        a = b;
+        Bench::doNotOptimize(&a);
+    });
+}
+
+// std::array with the same operations
+struct StdArray {
+    std::array<int, Length> m_array;
+
+    void memset(int value) {
+        m_array.fill(value);
+    }
+
+    int &operator[](size_t index) {
+        return m_array[index];
+    }
+
+    bool operator==(const StdArray &rhs) const {
+        return m_array == rhs.m_array;
+    }
+};
+
+CPPCORE_BENCHMARK(StaticArray_Bulk) {
+    runBulk<TStaticArray<int, Length>>("TStaticArray fill 256 ints", "TStaticArray compare 256 ints",
+            "TStaticArray copy 256 ints");
+    runBulk<LegacyStaticArray<int, Length>>("legacy fill 256 ints", "legacy compare 256 ints",
+            "legacy copy 256 ints");
+    runBulk<StdArray>("std::array fill 256 ints", "std::array compare 256 ints", "std::array copy 256 ints");
+}
+
+CPPCORE_BENCHMARK(StaticArray_Arithmetic) {
+    const size_t numOps = getNumOps();
+    TStaticArray<float, 4> position = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const TStaticArray<float, 4> velocity = { 0.5f, 0.25f, 0.125f, 1.0f };
+    Bench::measure("TStaticArray<float, 4> p += v * 0.5", numOps, [&](size_t) {
+        position += velocity * 0.5f;
+        Bench::doNotOptimize(&position);
+    });
+
+    std::array<float, 4> stdPosition = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const std::array<float, 4> stdVelocity = { 0.5f, 0.25f, 0.125f, 1.0f };
+    Bench::measure("std::array<float, 4> loop p += v * 0.5", numOps, [&](size_t) {
+        for (size_t i = 0; i < 4; ++i) {
+            stdPosition[i] += stdVelocity[i] * 0.5f;
+        }
+        Bench::doNotOptimize(&stdPosition);
+    });
+}
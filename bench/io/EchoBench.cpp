@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/DatagramBatch.h>
+#include <cppcore/IO/Reactor.h>
+#include <cppcore/IO/Socket.h>
+
+#include "../Benchmark.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const size_t NumClients = 8;
+static const size_t MessagesPerClient = 100000;
+static const size_t Window = 32;
+static const size_t MessageSize = 32;
+
+struct EchoServer {
+    int m_fd;
+    DatagramBatch m_batch;
+
+    EchoServer(int fd) :
+            m_fd(fd),
+            m_batch(64, 2048) {
+        // empty
+    }
+};
+
+// Sends a window of datagrams, then waits for the echoes, returns the number of round trips
+static size_t runClient(uint16_t port) {
+    const int fd = Socket::openUdp("127.0.0.1", 0, false);
+    Socket::connectUdp(fd, "127.0.0.1", port);
+    DatagramBatch out(Window, MessageSize);
+    DatagramBatch in(Window, 2048);
+    for (size_t i = 0; i < Window; ++i) {
+        out.setSize(i, MessageSize);
+    }
+
+    size_t numDone = 0;
+    while (numDone < MessagesPerClient) {
+        const int numSent = out.send(fd, Window);
+        size_t numPending = numSent > 0 ? static_cast<size_t>(numSent) : 0;
+        while (0 != numPending) {
+            pollfd waiter = { fd, POLLIN, 0 };
+            if (::poll(&waiter, 1, 100) <= 0) {
+                // Lost datagrams are not resent
+                break;
+            }
+            const int count = in.receive(fd);
+            if (count > 0) {
+                numPending -= static_cast<size_t>(count) < numPending ? static_cast<size_t>(count) : numPending;
+                numDone += static_cast<size_t>(count);
+            }
+        }
+    }
+    Socket::close(fd);
+
+    return numDone;
+}
+
+static void runEcho(size_t numLoops, bool batched) {
+    ReactorGroup group(numLoops);
+    std::vector<EchoServer*> servers;
+    uint16_t port = 0;
+    for (size_t i = 0; i < numLoops; ++i) {
+        const int fd = Socket::openUdp("127.0.0.1", port, true);
+        port = Socket::getLocalPort(fd);
+        servers.push_back(new EchoServer(fd));
+    }
+
+    std::atomic<size_t> numReady(0);
+    for (size_t i = 0; i < numLoops; ++i) {
+        Reactor &reactor = group.getReactor(i);
+        EchoServer *server = servers[i];
+        reactor.post([&reactor, server, batched, &numReady]() {
+            reactor.add(server->m_fd, Reactor::Readable, [server, batched](uint32_t) {
+                if (batched) {
+                    for (int count = server->m_batch.receive(server->m_fd); count > 0; count = server->m_batch.receive(server->m_fd)) {
+                        server->m_batch.send(server->m_fd, static_cast<size_t>(count));
+                    }
+                    return;
+                }
+                char buffer[2048];
+                sockaddr_storage address;
+                for (;;) {
+                    socklen_t length = sizeof(address);
+                    const ssize_t size = ::recvfrom(server->m_fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                            reinterpret_cast<sockaddr*>(&address), &length);
+                    if (size < 0) {
+                        break;
+                    }
+                    ::sendto(server->m_fd, buffer, static_cast<size_t>(size), MSG_DONTWAIT,
+                            reinterpret_cast<sockaddr*>(&address), length);
+                }
+            });
+            ++numReady;
+        });
+    }
+    while (numReady.load() < numLoops) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<size_t> numMessages(0);
+    std::vector<std::thread> clients;
+    Bench::Timer timer;
+    for (size_t i = 0; i < NumClients; ++i) {
+        clients.push_back(std::thread([port, &numMessages]() {
+            numMessages += runClient(port);
+        }));
+    }
+    for (size_t i = 0; i < clients.size(); ++i) {
+        clients[i].join();
+    }
+    const double elapsed = timer.elapsedNs();
+
+    const std::string label = std::string(batched ? "recvmmsg/sendmmsg" : "recvfrom/sendto") +
+            " loops=" + std::to_string(numLoops);
+    Bench::report(label.c_str(), numMessages.load(), elapsed);
+
+    group.stop();
+    for (size_t i = 0; i < servers.size(); ++i) {
+        Socket::close(servers[i]->m_fd);
+        delete servers[i];
+    }
+}
+
+CPPCORE_BENCHMARK(Reactor_UdpEcho) {
+    const size_t maxLoops = std::max<size_t>(4, std::thread::hardware_concurrency());
+    for (size_t numLoops = 1; numLoops <= maxLoops; numLoops *= 2) {
+        runEcho(numLoops, false);
+        runEcho(numLoops, true);
+    }
+}
+
+CPPCORE_BENCHMARK(Reactor_Post) {
+    static const size_t NumTasks = 1000000;
+    ReactorGroup group(1);
+    Reactor &reactor = group.getReactor(0);
+    std::atomic<size_t> numRun(0);
+    Bench::Timer timer;
+    for (size_t i = 0; i < NumTasks; ++i) {
+        reactor.post([&numRun]() {
+            numRun.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    while (numRun.load() < NumTasks) {
+        std::this_thread::yield();
+    }
+    Bench::report("Reactor::post cross-thread", NumTasks, timer.elapsedNs());
+}
@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/AsyncLogger.h>
+
+#include "../Benchmark.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace CPPCore;
+
+// 2M messages by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumMessages() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 2000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// Times every call on its own, so the percentiles show the stalls on a full ring
+template <class Func>
+static void measureLatency(const char *label, size_t numCalls, Func func) {
+    std::vector<uint32_t> samples(numCalls);
+    Bench::Timer total;
+    for (size_t i = 0; i < numCalls; ++i) {
+        Bench::Timer timer;
+        func(i);
+        samples[i] = static_cast<uint32_t>(std::min(timer.elapsedNs(), 4e9));
+    }
+    Bench::report(label, numCalls, total.elapsedNs());
+    std::sort(samples.begin(), samples.end());
+    ::printf("    p50 %u ns, p99 %u ns, p99.9 %u ns\n", samples[numCalls / 2], samples[numCalls * 99 / 100],
+            samples[numCalls * 999 / 1000]);
+}
+
+CPPCORE_BENCHMARK(Logger_Latency) {
+    // Rounds which fit into the ring, the background thread only runs on flush, so the caller
+    // cost and the formatting cost are measured apart even on a single core
+    static const size_t RoundSize = 50000;
+    const size_t numMessages = getNumMessages();
+    const size_t numRounds = (numMessages + RoundSize - 1) / RoundSize;
+    const std::string peer("10.0.0.1:4711");
+
+    {
+        const int fd = ::open("/dev/null", O_WRONLY);
+        LoggerOptions options;
+        options.m_ringSize = 1 << 22;
+        options.m_flushIntervalMs = 60000;
+        AsyncLogger::open(fd, options);
+
+        // Warm up the ring pages
+        for (size_t i = 0; i < RoundSize; ++i) {
+            CPPCORE_LOG_INFO("request %zu from %s took %.3f ms", i, peer, 0.25);
+        }
+        AsyncLogger::flush();
+
+        double callerNs = 0;
+        double backgroundNs = 0;
+        for (size_t round = 0; round < numRounds; ++round) {
+            Bench::Timer timer;
+            for (size_t i = 0; i < RoundSize; ++i) {
+                CPPCORE_LOG_INFO("request %zu from %s took %.3f ms", i, peer, 0.25);
+            }
+            callerNs += timer.elapsedNs();
+            timer.reset();
+            AsyncLogger::flush();
+            backgroundNs += timer.elapsedNs();
+        }
+        Bench::report("CPPCORE_LOG_INFO caller (int, string, double)", numRounds * RoundSize, callerNs);
+        Bench::report("AsyncLogger background format + writev", numRounds * RoundSize, backgroundNs);
+
+        measureLatency("CPPCORE_LOG_INFO per call", RoundSize, [&peer](size_t i) {
+            CPPCORE_LOG_INFO("request %zu from %s took %.3f ms", i, peer, 0.25);
+        });
+        AsyncLogger::flush();
+        Bench::measure("CPPCORE_LOG_DEBUG (runtime filtered)", numMessages, [&peer](size_t i) {
+            CPPCORE_LOG_DEBUG("request %zu from %s took %.3f ms", i, peer, 0.25);
+        });
+        AsyncLogger::close();
+        ::close(fd);
+    }
+
+    FILE *file = ::fopen("/dev/null", "w");
+    Bench::measure("fprintf", numMessages, [file, &peer](size_t i) {
+        ::fprintf(file, "request %zu from %s took %.3f ms\n", i, peer.c_str(), 0.25);
+    });
+    measureLatency("fprintf per call", RoundSize, [file, &peer](size_t i) {
+        ::fprintf(file, "request %zu from %s took %.3f ms\n", i, peer.c_str(), 0.25);
+    });
+    ::fclose(file);
+}
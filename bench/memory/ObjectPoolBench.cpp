@@ -0,0 +1,191 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Memory/TConcurrentObjectPool.h>
+#include <cppcore/Memory/TPoolAllocator.h>
+#include <cppcore/Threading/TBoundedQueue.h>
+
+#include "../Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const size_t MaxThreads = 8;
+static const size_t BurstSize = 64;
+
+struct Message {
+    uint64_t m_id;
+    char m_payload[56];
+};
+
+// 4M objects by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumObjects() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 4000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+class NewDeletePool {
+public:
+    Message *create() {
+        return new Message;
+    }
+
+    void destroy(Message *message) {
+        delete message;
+    }
+};
+
+// TPoolAllocator cannot release single objects, so the freed ones go to a list next to it
+class LockedPool {
+public:
+    LockedPool() :
+            m_allocator(1024) {
+        // empty
+    }
+
+    Message *create() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()) {
+            Message *message = m_free.back();
+            m_free.pop_back();
+            return message;
+        }
+        return m_allocator.alloc();
+    }
+
+    void destroy(Message *message) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(message);
+    }
+
+private:
+    std::mutex m_mutex;
+    TPoolAllocator<Message> m_allocator;
+    std::vector<Message*> m_free;
+};
+
+class ObjectPool {
+public:
+    Message *create() {
+        return m_pool.create();
+    }
+
+    void destroy(Message *message) {
+        m_pool.destroy(message);
+    }
+
+private:
+    TConcurrentObjectPool<Message> m_pool;
+};
+
+// Every thread creates a burst of objects and destroys them again
+template <class Pool>
+static void runLocal(const char *name) {
+    const size_t numObjects = getNumObjects();
+    Pool pool;
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        const size_t numBursts = numObjects / numThreads / BurstSize;
+        std::vector<std::thread> threads;
+        Bench::Timer timer;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&pool, numBursts]() {
+                Message *messages[BurstSize];
+                for (size_t i = 0; i < numBursts; ++i) {
+                    for (size_t j = 0; j < BurstSize; ++j) {
+                        messages[j] = pool.create();
+                        messages[j]->m_id = j;
+                    }
+                    for (size_t j = 0; j < BurstSize; ++j) {
+                        pool.destroy(messages[j]);
+                    }
+                }
+            }));
+        }
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " threads=" + std::to_string(numThreads);
+        Bench::report(label.c_str(), numBursts * BurstSize * numThreads, timer.elapsedNs());
+    }
+}
+
+// Producers create the objects, consumers on other threads destroy them
+template <class Pool>
+static void runCrossThread(const char *name) {
+    const size_t numObjects = getNumObjects();
+    Pool pool;
+    for (size_t numPairs = 1; numPairs <= MaxThreads / 2; numPairs *= 2) {
+        const size_t perPair = numObjects / numPairs;
+        std::vector<std::unique_ptr<TBoundedQueue<Message*>>> queues;
+        std::vector<std::thread> threads;
+        Bench::Timer timer;
+        for (size_t p = 0; p < numPairs; ++p) {
+            queues.push_back(std::unique_ptr<TBoundedQueue<Message*>>(new TBoundedQueue<Message*>(1024)));
+            TBoundedQueue<Message*> *queue = queues.back().get();
+            threads.push_back(std::thread([&pool, queue, perPair]() {
+                for (size_t i = 0; i < perPair; ++i) {
+                    Message *message = pool.create();
+                    message->m_id = i;
+                    while (!queue->tryPush(message)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+            threads.push_back(std::thread([&pool, queue, perPair]() {
+                uint64_t sum = 0;
+                for (size_t i = 0; i < perPair; ++i) {
+                    Message *message = nullptr;
+                    while (!queue->tryPop(message)) {
+                        std::this_thread::yield();
+                    }
+                    sum += message->m_id;
+                    pool.destroy(message);
+                }
+                Bench::doNotOptimize(sum);
+            }));
+        }
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " pairs=" + std::to_string(numPairs);
+        Bench::report(label.c_str(), perPair * numPairs, timer.elapsedNs());
+    }
+}
+
+CPPCORE_BENCHMARK(ObjectPool_Local) {
+    runLocal<ObjectPool>("TConcurrentObjectPool");
+    runLocal<NewDeletePool>("new/delete");
+    runLocal<LockedPool>("TPoolAllocator + std::mutex");
+}
+
+CPPCORE_BENCHMARK(ObjectPool_CrossThread) {
+    runCrossThread<ObjectPool>("TConcurrentObjectPool");
+    runCrossThread<NewDeletePool>("new/delete");
+    runCrossThread<LockedPool>("TPoolAllocator + std::mutex");
+}
@@ -0,0 +1,128 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Parallel/ParallelAlgorithms.h>
+#include <cppcore/Container/TArray.h>
+
+#include "../Benchmark.h"
+
+#include <stdlib.h>
+#include <string>
+
+using namespace CPPCore;
+
+// 100M elements by default, CPPCORE_BENCH_SIZE overrides it for smaller machines
+static size_t getProblemSize() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 100000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static std::vector<size_t> getThreadCounts() {
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        counts.push_back(numThreads);
+    }
+    counts.push_back(maxThreads);
+
+    return counts;
+}
+
+static void fill(TArray<float> &array, size_t size) {
+    array.resize(size);
+    unsigned int state = 12345;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1103515245u + 12345u;
+        array[i] = static_cast<float>(state >> 8) / 16777216.0f;
+    }
+}
+
+template <class Func>
+static void runScaling(const char *name, size_t size, Func func) {
+    const std::vector<size_t> counts = getThreadCounts();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        TaskScheduler scheduler(counts[i]);
+        const std::string label = std::string(name) + " threads=" + std::to_string(counts[i]);
+        Bench::Timer timer;
+        func(scheduler);
+        Bench::report(label.c_str(), size, timer.elapsedNs());
+    }
+}
+
+CPPCORE_BENCHMARK(Parallel_Reduce) {
+    const size_t size = getProblemSize();
+    TArray<float> input;
+    fill(input, size);
+    runScaling("parallelReduce<float>", size, [&](TaskScheduler &scheduler) {
+        Bench::doNotOptimize(parallelReduce(input.begin(), input.end(), 0.0f, std::plus<float>(), DefaultGrainSize, &scheduler));
+    });
+}
+
+CPPCORE_BENCHMARK(Parallel_Transform) {
+    const size_t size = getProblemSize();
+    TArray<float> input, output;
+    fill(input, size);
+    output.resize(size);
+    runScaling("parallelTransform<float>", size, [&](TaskScheduler &scheduler) {
+        parallelTransform(input.begin(), input.end(), output.begin(), [](float value) { return value * 2.0f + 1.0f; },
+                DefaultGrainSize, &scheduler);
+        Bench::doNotOptimize(output[size / 2]);
+    });
+}
+
+CPPCORE_BENCHMARK(Parallel_InclusiveScan) {
+    const size_t size = getProblemSize();
+    TArray<float> input, output;
+    fill(input, size);
+    output.resize(size);
+    runScaling("parallelInclusiveScan<float>", size, [&](TaskScheduler &scheduler) {
+        parallelInclusiveScan(input.begin(), input.end(), output.begin(), std::plus<float>(), DefaultGrainSize, &scheduler);
+        Bench::doNotOptimize(output[size - 1]);
+    });
+}
+
+CPPCORE_BENCHMARK(Parallel_CopyIf) {
+    const size_t size = getProblemSize();
+    TArray<float> input, output;
+    fill(input, size);
+    output.resize(size);
+    runScaling("parallelCopyIf<float>", size, [&](TaskScheduler &scheduler) {
+        float *end = parallelCopyIf(input.begin(), input.end(), output.begin(), [](float value) { return value < 0.5f; },
+                DefaultGrainSize, &scheduler);
+        Bench::doNotOptimize(end);
+    });
+}
+
+CPPCORE_BENCHMARK(Parallel_Sort) {
+    const size_t size = getProblemSize();
+    TArray<float> input;
+    const std::vector<size_t> counts = getThreadCounts();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        fill(input, size);
+        TaskScheduler scheduler(counts[i]);
+        const std::string label = "parallelSort<float> threads=" + std::to_string(counts[i]);
+        Bench::Timer timer;
+        parallelSort(input.begin(), input.end(), std::less<float>(), DefaultGrainSize, &scheduler);
+        Bench::report(label.c_str(), size, timer.elapsedNs());
+        Bench::doNotOptimize(input[0]);
+    }
+}
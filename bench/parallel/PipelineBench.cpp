@@ -0,0 +1,212 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TQueue.h>
+#include <cppcore/Parallel/Pipeline.h>
+
+#include "../Benchmark.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace CPPCore;
+
+// 2M records by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumRecords() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 2000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+struct Record {
+    uint64_t m_id;
+    uint64_t m_value;
+};
+
+// The four stages of the ingestion: read a line, parse it, transform the record, write it
+static void readLine(size_t index, std::string &line) {
+    char buffer[64];
+    const int length = ::snprintf(buffer, sizeof(buffer), "%zu,%zu", index, index * 7919 % 100003);
+    line.assign(buffer, static_cast<size_t>(length));
+}
+
+static Record parseLine(const std::string &line) {
+    Record record;
+    char *end = nullptr;
+    record.m_id = ::strtoull(line.c_str(), &end, 10);
+    record.m_value = ::strtoull(end + 1, nullptr, 10);
+    return record;
+}
+
+static Record transform(Record record) {
+    uint64_t hash = record.m_value * 0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 29;
+    record.m_value = hash;
+    return record;
+}
+
+// The old way: one thread per stage, a TQueue behind a mutex between them, one item at a time
+template <class T>
+class MutexQueue {
+public:
+    void push(const T &item) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.enqueue(item);
+        }
+        m_notEmpty.notify_one();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+    }
+
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return !m_queue.isEmpty() || m_closed; });
+        return m_queue.dequeue(item);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    TQueue<T> m_queue;
+    bool m_closed = false;
+};
+
+static uint64_t runMutexQueues(size_t numRecords) {
+    MutexQueue<std::string> lines;
+    MutexQueue<Record> records;
+    MutexQueue<Record> transformed;
+    uint64_t checksum = 0;
+
+    std::thread reader([&]() {
+        std::string line;
+        for (size_t i = 0; i < numRecords; ++i) {
+            readLine(i, line);
+            lines.push(line);
+        }
+        lines.close();
+    });
+    std::thread parser([&]() {
+        std::string line;
+        while (lines.pop(line)) {
+            records.push(parseLine(line));
+        }
+        records.close();
+    });
+    std::thread transformer([&]() {
+        Record record;
+        while (records.pop(record)) {
+            transformed.push(transform(record));
+        }
+        transformed.close();
+    });
+    std::thread writer([&]() {
+        Record record;
+        while (transformed.pop(record)) {
+            checksum += record.m_id ^ record.m_value;
+        }
+    });
+    reader.join();
+    parser.join();
+    transformer.join();
+    writer.join();
+
+    return checksum;
+}
+
+static uint64_t runPipeline(size_t numRecords, size_t numParsers, size_t batchSize, bool ordered, bool printReport) {
+    PipelineOptions options;
+    options.m_ordered = ordered;
+    options.m_batchSize = batchSize;
+    Pipeline pipeline(options);
+    size_t next = 0;
+    uint64_t checksum = 0;
+    pipeline.source<std::string>("read", [&next, numRecords](std::string &line) {
+                if (next == numRecords) {
+                    return false;
+                }
+                readLine(next++, line);
+                return true;
+            })
+            .then("parse", numParsers, [](std::string &&line) { return parseLine(line); })
+            .then("transform", 1, [](Record &&record) { return transform(record); })
+            .sink("write", 1, [&checksum](Record &&record) { checksum += record.m_id ^ record.m_value; });
+    pipeline.run();
+
+    if (printReport) {
+        std::string report;
+        pipeline.report(report);
+        ::printf("%s", report.c_str());
+    }
+
+    return checksum;
+}
+
+CPPCORE_BENCHMARK(Pipeline_FourStages) {
+    const size_t numRecords = getNumRecords();
+
+    // All four stages in one loop, the lower bound on a single core
+    Bench::Timer timer;
+    uint64_t checksum = 0;
+    std::string line;
+    for (size_t i = 0; i < numRecords; ++i) {
+        readLine(i, line);
+        const Record record = transform(parseLine(line));
+        checksum += record.m_id ^ record.m_value;
+    }
+    Bench::report("serial loop", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+
+    timer.reset();
+    checksum = runMutexQueues(numRecords);
+    Bench::report("thread per stage + mutex TQueue", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+
+    timer.reset();
+    checksum = runPipeline(numRecords, 1, 64, false, false);
+    Bench::report("Pipeline 1/1/1/1", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+
+    timer.reset();
+    checksum = runPipeline(numRecords, 1, 256, false, false);
+    Bench::report("Pipeline 1/1/1/1 batch=256", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+
+    timer.reset();
+    checksum = runPipeline(numRecords, 2, 64, false, false);
+    Bench::report("Pipeline 1/2/1/1 unordered", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+
+    timer.reset();
+    checksum = runPipeline(numRecords, 2, 64, true, true);
+    Bench::report("Pipeline 1/2/1/1 ordered", numRecords, timer.elapsedNs());
+    Bench::doNotOptimize(checksum);
+}
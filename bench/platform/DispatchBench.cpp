@@ -0,0 +1,133 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Platform/CpuFeatures.h>
+#include <cppcore/Platform/TCpuDispatch.h>
+#include <cppcore/Platform/VectorKernels.h>
+
+#include "../Benchmark.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace CPPCore;
+
+// 20M calls by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumCalls() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 20000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static float sumPlain(const float *values, size_t count) {
+    float result = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        result += values[i];
+    }
+    return result;
+}
+
+// ifunc is resolved by the dynamic loader before any constructor runs, so it can only ask the
+// compiler runtime for the features and cannot honor CPPCORE_ISA
+#if defined(__GNUC__) && !defined(__clang__) && defined(__ELF__) && defined(__x86_64__)
+#   define CPPCORE_BENCH_IFUNC
+
+__attribute__((target("avx2"))) static float sumPlainAvx2(const float *values, size_t count) {
+    return sumPlain(values, count);
+}
+
+using SumFunc = float (*)(const float *, size_t);
+
+extern "C" SumFunc resolveSumIfunc() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? &sumPlainAvx2 : &sumPlain;
+}
+
+float sumIfunc(const float *values, size_t count) __attribute__((ifunc("resolveSumIfunc")));
+#endif
+
+struct SumTable {
+    float (*m_sum)(const float *values, size_t count);
+};
+
+CPPCORE_BENCHMARK(Dispatch_CallOverhead) {
+    const size_t numCalls = getNumCalls();
+    std::vector<float> values(8, 1.0f);
+    const float *data = values.data();
+
+    ::printf("  detected %s, active %s, %s\n", CpuFeatures::getLevelName(CpuFeatures::getDetectedLevel()),
+            CpuFeatures::getLevelName(CpuFeatures::getLevel()), CpuFeatures::getBrand());
+
+    // The size is read through a volatile, so the direct call cannot be folded
+    volatile size_t count = values.size();
+    float sink = 0.0f;
+    Bench::measure("direct call, 8 floats", numCalls, [&](size_t) {
+        sink += sumPlain(data, count);
+    });
+
+    static const SumTable table = { &sumPlain };
+    static const TCpuDispatch<SumTable> dispatch(&table);
+    Bench::measure("TCpuDispatch table, 8 floats", numCalls, [&](size_t) {
+        sink += dispatch.get().m_sum(data, count);
+    });
+
+    Bench::measure("VectorKernels::sum, 8 floats", numCalls, [&](size_t) {
+        sink += VectorKernels::sum(data, count);
+    });
+
+#ifdef CPPCORE_BENCH_IFUNC
+    Bench::measure("ifunc, 8 floats", numCalls, [&](size_t) {
+        sink += sumIfunc(data, count);
+    });
+#endif
+    Bench::doNotOptimize(sink);
+}
+
+CPPCORE_BENCHMARK(Dispatch_Throughput) {
+    const size_t count = 1 << 12;
+    const size_t numCalls = getNumCalls() / 500 + 1;
+    std::vector<float> a(count, 0.5f);
+    std::vector<float> b(count, 2.0f);
+    std::vector<uint8_t> bytes(count * 4, 3);
+
+    for (size_t i = 0; i <= static_cast<size_t>(CpuFeatures::getDetectedLevel()); ++i) {
+        const IsaLevel level = static_cast<IsaLevel>(i);
+        const VectorKernels::Table &table = VectorKernels::getTable(level);
+        float sink = 0.0f;
+        size_t numBytes = 0;
+
+        std::string label = std::string("sum 4K floats, ") + CpuFeatures::getLevelName(level);
+        Bench::measure(label.c_str(), numCalls, [&](size_t) {
+            sink += table.m_sum(a.data(), count);
+        });
+        label = std::string("dot 4K floats, ") + CpuFeatures::getLevelName(level);
+        Bench::measure(label.c_str(), numCalls, [&](size_t) {
+            sink += table.m_dot(a.data(), b.data(), count);
+        });
+        label = std::string("countByte 16KB, ") + CpuFeatures::getLevelName(level);
+        Bench::measure(label.c_str(), numCalls, [&](size_t) {
+            numBytes += table.m_countByte(bytes.data(), bytes.size(), 3);
+        });
+        Bench::doNotOptimize(sink);
+        Bench::doNotOptimize(numBytes);
+    }
+}
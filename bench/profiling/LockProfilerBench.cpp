@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/LockProfiler.h>
+
+#include "../Benchmark.h"
+
+#include <thread>
+
+using namespace CPPCore;
+
+static const size_t NumOps = 2000000;
+
+template <class TLock>
+static void runUncontended(const char *name) {
+    TLock lock;
+    size_t counter = 0;
+    Bench::measure(name, NumOps, [&](size_t) {
+        TLockGuard<TLock> guard(lock, CPPCORE_LOCK_SITE("lock"));
+        ++counter;
+    });
+    Bench::doNotOptimize(counter);
+}
+
+template <class TLock>
+static void runContended(const char *name, size_t numThreads) {
+    TLock lock;
+    size_t counter = 0;
+    const size_t opsPerThread = NumOps / numThreads;
+    Bench::Timer timer;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&]() {
+            for (size_t i = 0; i < opsPerThread; ++i) {
+                TLockGuard<TLock> guard(lock, CPPCORE_LOCK_SITE("lock"));
+                ++counter;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    Bench::report(name, opsPerThread * numThreads, timer.elapsedNs());
+    Bench::doNotOptimize(counter);
+}
+
+CPPCORE_BENCHMARK(LockProfiler_Uncontended) {
+    runUncontended<std::mutex>("std::mutex");
+    runUncontended<TProfiledLock<std::mutex>>("TProfiledLock<std::mutex>");
+    runUncontended<SpinLock>("SpinLock");
+    runUncontended<TProfiledLock<SpinLock>>("TProfiledLock<SpinLock>");
+    runUncontended<std::shared_mutex>("std::shared_mutex");
+    runUncontended<TProfiledLock<std::shared_mutex>>("TProfiledLock<std::shared_mutex>");
+}
+
+CPPCORE_BENCHMARK(LockProfiler_Contended) {
+    const size_t numThreads = std::max<size_t>(2, std::thread::hardware_concurrency());
+    runContended<std::mutex>("std::mutex", numThreads);
+    runContended<TProfiledLock<std::mutex>>("TProfiledLock<std::mutex>", numThreads);
+    runContended<SpinLock>("SpinLock", numThreads);
+    runContended<TProfiledLock<SpinLock>>("TProfiledLock<SpinLock>", numThreads);
+}
@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/Metrics.h>
+
+#include "../Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const size_t MaxThreads = 64;
+
+// 8M increments by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumIncrements() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 8000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+template <class Func>
+static void runThreads(const char *name, Func func) {
+    const size_t numIncrements = getNumIncrements();
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        const size_t perThread = numIncrements / numThreads;
+        std::atomic<bool> start(false);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&func, &start, perThread]() {
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < perThread; ++i) {
+                    func();
+                }
+            }));
+        }
+        Bench::Timer timer;
+        start.store(true, std::memory_order_release);
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " threads=" + std::to_string(numThreads);
+        Bench::report(label.c_str(), perThread * numThreads, timer.elapsedNs());
+    }
+}
+
+CPPCORE_BENCHMARK(Metrics_Increment) {
+    std::atomic<int64_t> atomicCounter(0);
+    runThreads("std::atomic fetch_add", [&atomicCounter]() {
+        atomicCounter.fetch_add(1, std::memory_order_relaxed);
+    });
+    Bench::doNotOptimize(atomicCounter.load());
+
+    ShardedCounter counter;
+    runThreads("ShardedCounter increment", [&counter]() {
+        counter.increment();
+    });
+    Bench::doNotOptimize(counter.get());
+
+    // Rising values, so every update writes its shard
+    ShardedMaxTracker tracker;
+    runThreads("ShardedMaxTracker update", [&tracker]() {
+        static thread_local int64_t t_value = 0;
+        tracker.update(++t_value);
+    });
+    Bench::doNotOptimize(tracker.get());
+}
@@ -0,0 +1,129 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TArray.h>
+#include <cppcore/Profiling/RollingWindow.h>
+
+#include "../Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+using namespace CPPCore;
+
+static const size_t WindowSizes[] = { 64, 1024, 16384 };
+
+// 4M samples by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumSamples() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 4000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+// A noisy frame time in milliseconds
+static float getSample(size_t i) {
+    return 16.0f + static_cast<float>((static_cast<uint32_t>(i * 2654435761u) >> 20) & 1023) * 0.01f;
+}
+
+// The old way, the last samples in a TArray which is rescanned on every tick
+struct RescanWindow {
+    TArray<float> m_samples;
+    size_t m_next = 0;
+
+    explicit RescanWindow(size_t capacity) {
+        m_samples.resize(capacity, 0.0f);
+    }
+
+    void add(float sample) {
+        m_samples[m_next] = sample;
+        m_next = m_next + 1 == m_samples.size() ? 0 : m_next + 1;
+    }
+
+    float tick(float &min, float &max) const {
+        float sum = 0.0f;
+        min = m_samples[0];
+        max = m_samples[0];
+        for (size_t i = 0; i < m_samples.size(); ++i) {
+            sum += m_samples[i];
+            min = std::min(min, m_samples[i]);
+            max = std::max(max, m_samples[i]);
+        }
+        return sum / static_cast<float>(m_samples.size());
+    }
+};
+
+CPPCORE_BENCHMARK(RollingWindow_Update) {
+    const size_t numSamples = getNumSamples();
+    for (size_t windowSize : WindowSizes) {
+        RollingWindow window(windowSize);
+        const std::string label = "RollingWindow add, window " + std::to_string(windowSize);
+        Bench::measure(label.c_str(), numSamples, [&window](size_t i) {
+            window.add(getSample(i));
+        });
+        Bench::doNotOptimize(window.getMean());
+    }
+}
+
+CPPCORE_BENCHMARK(RollingWindow_Tick) {
+    // One sample and one min / max / mean query per tick
+    const size_t numSamples = getNumSamples();
+    for (size_t windowSize : WindowSizes) {
+        const size_t numTicks = numSamples * 64 / windowSize;
+        RollingWindow window(windowSize);
+        RescanWindow rescan(windowSize);
+        for (size_t i = 0; i < windowSize; ++i) {
+            window.add(getSample(i));
+            rescan.add(getSample(i));
+        }
+
+        double result = 0.0;
+        std::string label = "RollingWindow incremental, window " + std::to_string(windowSize);
+        Bench::measure(label.c_str(), numTicks, [&window, &result](size_t i) {
+            window.add(getSample(i));
+            result += window.getMean() + window.getMin() + window.getMax();
+        });
+
+        label = "RollingWindow full scan, window " + std::to_string(windowSize);
+        Bench::measure(label.c_str(), numTicks, [&window, &result](size_t i) {
+            window.add(getSample(i));
+            float min = 0.0f;
+            float max = 0.0f;
+            window.computeMinMax(min, max);
+            result += window.computeSum() + min + max;
+        });
+
+        label = "TArray rescan, window " + std::to_string(windowSize);
+        Bench::measure(label.c_str(), numTicks, [&rescan, &result](size_t i) {
+            rescan.add(getSample(i));
+            float min = 0.0f;
+            float max = 0.0f;
+            result += rescan.tick(min, max) + min + max;
+        });
+
+        label = "RollingWindow p99, window " + std::to_string(windowSize);
+        Bench::measure(label.c_str(), numTicks / 8, [&window, &result](size_t i) {
+            window.add(getSample(i));
+            result += window.getPercentile(0.99f);
+        });
+        Bench::doNotOptimize(result);
+    }
+}
@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/SamplingProfiler.h>
+
+#include "../Benchmark.h"
+
+using namespace CPPCore;
+
+// A synthetic, CPU-bound workload with some call depth.
+CPPCORE_NOINLINE static double leafWork(size_t n) {
+    double sum = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+        sum += 1.0 / static_cast<double>(i * i);
+    }
+
+    return sum;
+}
+
+CPPCORE_NOINLINE static double midWork(size_t n) {
+    return leafWork(n) + leafWork(n / 2);
+}
+
+static volatile size_t s_workSize = 100000;
+
+static double runWorkload(size_t rounds) {
+    double sum = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        sum += midWork(s_workSize);
+    }
+
+    return sum;
+}
+
+CPPCORE_BENCHMARK(SamplingProfiler_Overhead) {
+    static const size_t Rounds = 2000;
+
+    Bench::Timer timer;
+    Bench::doNotOptimize(runWorkload(Rounds));
+    const double baseline = timer.elapsedNs();
+    Bench::report("workload, no profiler", Rounds, baseline);
+
+    const size_t frequencies[] = { 99, 999, 4999 };
+    for (size_t i = 0; i < CPPCORE_ARRAY_SIZE(frequencies); ++i) {
+        SamplingProfiler profiler(frequencies[i], 65536);
+        if (!profiler.start()) {
+            ::printf("  profiler not supported on this platform\n");
+            return;
+        }
+        timer.reset();
+        Bench::doNotOptimize(runWorkload(Rounds));
+        const double elapsed = timer.elapsedNs();
+        profiler.stop();
+
+        char name[64];
+        ::snprintf(name, sizeof(name), "workload, profiler at %zu Hz", frequencies[i]);
+        Bench::report(name, Rounds, elapsed);
+        ::printf("    samples %zu, dropped %zu, overhead %.2f %%\n", profiler.numSamples(), profiler.numDropped(),
+                100.0 * (elapsed - baseline) / baseline);
+    }
+}
+
+CPPCORE_BENCHMARK(SamplingProfiler_Symbolize) {
+    SamplingProfiler profiler(999, 65536);
+    if (!profiler.start()) {
+        return;
+    }
+    Bench::doNotOptimize(runWorkload(1000));
+    profiler.stop();
+
+    Bench::Timer timer;
+    std::string folded;
+    profiler.writeFoldedStacks(folded);
+    Bench::report("writeFoldedStacks per sample", profiler.numSamples(), timer.elapsedNs());
+}
@@ -0,0 +1,149 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/Bvh.h>
+#include <cppcore/Spatial/HashGrid.h>
+#include <cppcore/Spatial/KdTree.h>
+
+#include "../Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace CPPCore;
+
+// 1M points by default, CPPCORE_BENCH_SIZE overrides it
+static size_t getNumPoints() {
+    const char *size = ::getenv("CPPCORE_BENCH_SIZE");
+    return nullptr == size ? 1000000 : static_cast<size_t>(::strtoull(size, nullptr, 10));
+}
+
+static constexpr size_t NumQueries = 100000;
+static constexpr size_t NumBruteForceQueries = 100;
+static constexpr size_t K = 8;
+
+// Uniform points in a cube with one point per unit of volume
+static std::vector<Float3> createPoints(size_t count, uint64_t seed) {
+    const float size = std::cbrt(static_cast<float>(count));
+    std::vector<Float3> points(count);
+    uint64_t random = seed;
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            points[i][axis] = static_cast<float>(random >> 40) / static_cast<float>(1 << 24) * size;
+        }
+    }
+    return points;
+}
+
+CPPCORE_BENCHMARK(Spatial_Build) {
+    const std::vector<Float3> points = createPoints(getNumPoints(), 0x9e3779b97f4a7c15ull);
+
+    Bench::Timer timer;
+    Bvh bvh;
+    bvh.build(points.data(), points.size());
+    Bench::report("Bvh, SAH build per point", points.size(), timer.elapsedNs());
+
+    timer.reset();
+    KdTree tree;
+    tree.build(points.data(), points.size());
+    Bench::report("KdTree, build per point", points.size(), timer.elapsedNs());
+
+    timer.reset();
+    HashGrid grid(2.0f);
+    for (size_t i = 0; i < points.size(); ++i) {
+        grid.insert(static_cast<uint32_t>(i), points[i]);
+    }
+    Bench::report("HashGrid, insert", points.size(), timer.elapsedNs());
+
+    // Small random steps, most points stay in their cell
+    std::vector<Float3> moved = createPoints(points.size(), 0x2545f4914f6cdd1dull);
+    const float scale = 0.1f / std::cbrt(static_cast<float>(points.size()));
+    for (size_t i = 0; i < points.size(); ++i) {
+        moved[i] = points[i] + moved[i] * scale;
+    }
+    timer.reset();
+    for (size_t i = 0; i < points.size(); ++i) {
+        grid.move(static_cast<uint32_t>(i), moved[i]);
+    }
+    Bench::report("HashGrid, move", points.size(), timer.elapsedNs());
+}
+
+CPPCORE_BENCHMARK(Spatial_Queries) {
+    const std::vector<Float3> points = createPoints(getNumPoints(), 0x9e3779b97f4a7c15ull);
+    const std::vector<Float3> queries = createPoints(NumQueries, 0x2545f4914f6cdd1dull);
+    const float scale = std::cbrt(static_cast<float>(points.size()) / static_cast<float>(NumQueries));
+    std::vector<Float3> centers(NumQueries);
+    for (size_t i = 0; i < NumQueries; ++i) {
+        centers[i] = queries[i] * scale;
+    }
+
+    Bvh bvh;
+    bvh.build(points.data(), points.size());
+    KdTree tree;
+    tree.build(points.data(), points.size());
+    HashGrid grid(2.0f);
+    for (size_t i = 0; i < points.size(); ++i) {
+        grid.insert(static_cast<uint32_t>(i), points[i]);
+    }
+
+    // A radius of 1.5 finds about 14 points
+    static constexpr float Radius = 1.5f;
+    std::vector<uint32_t> result;
+    size_t numFound = 0;
+    Bench::measure("Bvh, querySphere r=1.5", NumQueries, [&](size_t i) {
+        result.clear();
+        numFound += bvh.querySphere(centers[i], Radius, result);
+    });
+    Bench::measure("KdTree, queryRadius r=1.5", NumQueries, [&](size_t i) {
+        result.clear();
+        numFound += tree.queryRadius(centers[i], Radius, result);
+    });
+    Bench::measure("HashGrid, queryRadius r=1.5", NumQueries, [&](size_t i) {
+        result.clear();
+        numFound += grid.queryRadius(centers[i], Radius, result);
+    });
+    Bench::measure("Brute force, radius", NumBruteForceQueries, [&](size_t i) {
+        for (size_t j = 0; j < points.size(); ++j) {
+            numFound += getDistanceSq(points[j], centers[i]) <= Radius * Radius ? 1 : 0;
+        }
+    });
+
+    uint32_t indices[K];
+    float distancesSq[K];
+    Bench::measure("KdTree, findNearest k=8", NumQueries, [&](size_t i) {
+        numFound += tree.findNearest(centers[i], K, indices, distancesSq);
+    });
+    std::vector<float> bruteDistances(points.size());
+    Bench::measure("Brute force, k=8", NumBruteForceQueries, [&](size_t i) {
+        for (size_t j = 0; j < points.size(); ++j) {
+            bruteDistances[j] = getDistanceSq(points[j], centers[i]);
+        }
+        std::partial_sort(bruteDistances.begin(), bruteDistances.begin() + K, bruteDistances.end());
+        numFound += bruteDistances[0] >= 0.0f ? K : 0;
+    });
+    Bench::doNotOptimize(numFound);
+}
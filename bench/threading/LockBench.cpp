@@ -0,0 +1,108 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/FutexMutex.h>
+#include <cppcore/Threading/McsLock.h>
+#include <cppcore/Threading/ReaderWriterLock.h>
+#include <cppcore/Threading/SpinLock.h>
+#include <cppcore/Threading/TicketLock.h>
+
+#include "../Benchmark.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+using namespace CPPCore;
+
+static const size_t NumOps = 1000000;
+static const size_t MaxThreads = 64;
+
+template <class Func>
+static void runThreads(const std::string &name, size_t numThreads, Func func) {
+    const size_t opsPerThread = NumOps / numThreads;
+    std::vector<std::thread> threads;
+    Bench::Timer timer;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&func, opsPerThread, t]() {
+            func(t, opsPerThread);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    const std::string label = name + " threads=" + std::to_string(numThreads);
+    Bench::report(label.c_str(), opsPerThread * numThreads, timer.elapsedNs());
+}
+
+template <class TLock>
+static void runExclusive(const char *name) {
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        TLock lock;
+        size_t counter = 0;
+        runThreads(name, numThreads, [&](size_t, size_t numOps) {
+            for (size_t i = 0; i < numOps; ++i) {
+                std::lock_guard<TLock> guard(lock);
+                ++counter;
+            }
+        });
+        Bench::doNotOptimize(counter);
+    }
+}
+
+template <class TLock>
+static void runShared(const char *name) {
+    // One of 16 operations writes
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        TLock lock;
+        size_t values[4] = {};
+        runThreads(name, numThreads, [&](size_t thread, size_t numOps) {
+            size_t sum = 0;
+            for (size_t i = 0; i < numOps; ++i) {
+                if (0 == ((i + thread) & 15)) {
+                    lock.lock();
+                    ++values[i & 3];
+                    lock.unlock();
+                } else {
+                    lock.lock_shared();
+                    sum += values[i & 3];
+                    lock.unlock_shared();
+                }
+            }
+            Bench::doNotOptimize(sum);
+        });
+    }
+}
+
+CPPCORE_BENCHMARK(Lock_Exclusive) {
+    runExclusive<std::mutex>("std::mutex");
+    runExclusive<SpinLock>("SpinLock");
+    runExclusive<TicketLock>("TicketLock");
+    runExclusive<McsLock>("McsLock");
+    runExclusive<FutexMutex>("FutexMutex");
+}
+
+CPPCORE_BENCHMARK(Lock_Shared) {
+    runShared<std::shared_mutex>("std::shared_mutex");
+    runShared<ReaderWriterLock>("ReaderWriterLock");
+}
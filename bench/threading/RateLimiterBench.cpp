@@ -0,0 +1,125 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/RateLimiter.h>
+
+#include "../Benchmark.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const size_t NumDecisions = 4000000;
+static const size_t MaxThreads = 16;
+static const unsigned int NumTenants = 1024;
+
+// The textbook limiter: tokens as a double, refilled under a mutex
+class MutexTokenBucket {
+public:
+    MutexTokenBucket(double ratePerSecond, double burst) :
+            m_mutex(),
+            m_tokens(burst),
+            m_burst(burst),
+            m_ratePerNs(ratePerSecond / 1e9),
+            m_last(SteadyClock().now()) {
+        // empty
+    }
+
+    bool tryAcquire() {
+        const uint64_t now = SteadyClock().now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tokens += static_cast<double>(now - m_last) * m_ratePerNs;
+        if (m_tokens > m_burst) {
+            m_tokens = m_burst;
+        }
+        m_last = now;
+        if (m_tokens < 1.0) {
+            return false;
+        }
+        m_tokens -= 1.0;
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    double m_tokens;
+    double m_burst;
+    double m_ratePerNs;
+    uint64_t m_last;
+};
+
+template <class Func>
+static void runThreads(const char *name, Func func) {
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        const size_t perThread = NumDecisions / numThreads;
+        std::atomic<size_t> accepted(0);
+        std::vector<std::thread> threads;
+        Bench::Timer timer;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&func, &accepted, perThread, t]() {
+                size_t count = 0;
+                for (size_t i = 0; i < perThread; ++i) {
+                    count += func(t, i) ? 1 : 0;
+                }
+                accepted.fetch_add(count);
+            }));
+        }
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " threads=" + std::to_string(numThreads);
+        Bench::report(label.c_str(), perThread * numThreads, timer.elapsedNs());
+        Bench::doNotOptimize(accepted.load());
+    }
+}
+
+// One shared limiter, half of the decisions are rejections
+CPPCORE_BENCHMARK(RateLimiter_Shared) {
+    MutexTokenBucket mutexBucket(50e6, 1000);
+    runThreads("mutex token bucket", [&mutexBucket](size_t, size_t) {
+        return mutexBucket.tryAcquire();
+    });
+
+    TTokenBucket<> bucket(50e6, 1000);
+    runThreads("TTokenBucket", [&bucket](size_t, size_t) {
+        return bucket.tryAcquire();
+    });
+
+    TSlidingWindowLimiter<> window(50000, 1000000);
+    runThreads("TSlidingWindowLimiter", [&window](size_t, size_t) {
+        return window.tryAcquire();
+    });
+}
+
+// Per-tenant limits
+CPPCORE_BENCHMARK(RateLimiter_Keyed) {
+    TKeyedRateLimiter<TTokenBucket<>> limiters([](unsigned int) {
+        return new TTokenBucket<>(1e6, 100);
+    });
+    runThreads("TKeyedRateLimiter<TTokenBucket>", [&limiters](size_t t, size_t i) {
+        return limiters.tryAcquire(static_cast<unsigned int>((i * 7 + t * 131) % NumTenants));
+    });
+}
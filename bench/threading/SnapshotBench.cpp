@@ -0,0 +1,103 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TArray.h>
+#include <cppcore/Threading/TSeqLock.h>
+#include <cppcore/Threading/TSnapshotPublisher.h>
+
+#include "../Benchmark.h"
+
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+using namespace CPPCore;
+
+static const size_t NumReads = 4000000;
+static const size_t MaxThreads = 64;
+static const size_t TableSize = 1024;
+
+struct RouteTable {
+    TArray<int> m_routes;
+
+    RouteTable() {
+        m_routes.resize(TableSize, 1);
+    }
+};
+
+struct Limits {
+    uint64_t m_maxConnections;
+    uint64_t m_maxRequests;
+    uint32_t m_timeoutMs;
+};
+
+template <class Func>
+static void runReaders(const char *name, Func func) {
+    for (size_t numThreads = 1; numThreads <= MaxThreads; numThreads *= 2) {
+        const size_t readsPerThread = NumReads / numThreads;
+        std::vector<std::thread> threads;
+        Bench::Timer timer;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&func, readsPerThread, t]() {
+                size_t sum = 0;
+                for (size_t i = 0; i < readsPerThread; ++i) {
+                    sum += func((i * 7 + t) % TableSize);
+                }
+                Bench::doNotOptimize(sum);
+            }));
+        }
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        const std::string label = std::string(name) + " threads=" + std::to_string(numThreads);
+        Bench::report(label.c_str(), readsPerThread * numThreads, timer.elapsedNs());
+    }
+}
+
+CPPCORE_BENCHMARK(Snapshot_Read) {
+    std::shared_mutex mutex;
+    RouteTable lockedTable;
+    runReaders("shared_mutex + TArray", [&](size_t index) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return static_cast<size_t>(lockedTable.m_routes[index]);
+    });
+
+    TSnapshotPublisher<RouteTable> publisher(new RouteTable);
+    runReaders("TSnapshotPublisher<TArray>", [&](size_t index) {
+        TSnapshotPublisher<RouteTable>::Snapshot snapshot = publisher.read();
+        return static_cast<size_t>(snapshot->m_routes[index]);
+    });
+
+    Limits limits = { 1000, 100000, 250 };
+    TSeqLock<Limits> seqLock(limits);
+    runReaders("TSeqLock<Limits>", [&](size_t) {
+        return static_cast<size_t>(seqLock.load().m_maxConnections);
+    });
+}
+
+CPPCORE_BENCHMARK(Snapshot_Publish) {
+    TSnapshotPublisher<RouteTable> publisher(new RouteTable);
+    Bench::measure("TSnapshotPublisher::update", 10000, [&](size_t i) {
+        publisher.update([i](RouteTable &table) { table.m_routes[i % TableSize] = static_cast<int>(i); });
+    });
+    Rcu::barrier();
+}
@@ -0,0 +1,53 @@
+# cppcore_add_isa_variants( <out_var> <source> <isa>... )
+#
+# Compiles a source file once more per instruction set level. For every isa out of sse42, avx2
+# and avx512 a wrapper file is generated in the build tree, which defines CPPCORE_ISA_<ISA> and
+# includes the source. The wrappers get the matching architecture flags and are appended to
+# <out_var>. The source itself stays in the normal build as the generic variant. Sets
+# CPPCORE_HAS_ISA_VARIANTS to TRUE if the variants were added, which is only done on x86.
+#
+# Floating-point contraction is disabled for all variants, so FMA does not change the results.
+
+SET( CPPCORE_ISA_FLAGS_sse42 -mssse3 -msse4.1 -msse4.2 -mpopcnt )
+SET( CPPCORE_ISA_FLAGS_avx2 ${CPPCORE_ISA_FLAGS_sse42} -mavx -mavx2 -mfma -mbmi -mbmi2 )
+SET( CPPCORE_ISA_FLAGS_avx512 ${CPPCORE_ISA_FLAGS_avx2} -mavx512f -mavx512dq -mavx512bw -mavx512vl )
+
+SET( CPPCORE_ISA_MSVC_FLAGS_sse42 )
+SET( CPPCORE_ISA_MSVC_FLAGS_avx2 /arch:AVX2 )
+SET( CPPCORE_ISA_MSVC_FLAGS_avx512 /arch:AVX512 )
+
+SET( CPPCORE_HAS_ISA_VARIANTS FALSE )
+IF( CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i.86|x86)$" )
+    SET( CPPCORE_HAS_ISA_VARIANTS TRUE )
+ENDIF()
+
+FUNCTION( cppcore_add_isa_variants out_var source )
+    IF( NOT CPPCORE_HAS_ISA_VARIANTS )
+        RETURN()
+    ENDIF()
+
+    GET_FILENAME_COMPONENT( source_path ${source} ABSOLUTE )
+    IF( NOT MSVC )
+        SET_SOURCE_FILES_PROPERTIES( ${source} PROPERTIES COMPILE_FLAGS -ffp-contract=off )
+    ENDIF()
+    GET_FILENAME_COMPONENT( source_name ${source} NAME_WE )
+    SET( variants ${${out_var}} )
+    FOREACH( isa ${ARGN} )
+        STRING( TOUPPER ${isa} isa_upper )
+        SET( wrapper ${CMAKE_CURRENT_BINARY_DIR}/isa/${source_name}_${isa}.cpp )
+
+        # Only touch the wrapper if it changed, else every configure rebuilds it
+        FILE( WRITE ${wrapper}.in "// Generated by cppcore_add_isa_variants\n#define CPPCORE_ISA_${isa_upper} 1\n#include \"${source_path}\"\n" )
+        CONFIGURE_FILE( ${wrapper}.in ${wrapper} COPYONLY )
+
+        IF( MSVC )
+            SET( flags ${CPPCORE_ISA_MSVC_FLAGS_${isa}} )
+        ELSE()
+            SET( flags ${CPPCORE_ISA_FLAGS_${isa}} -ffp-contract=off )
+        ENDIF()
+        STRING( REPLACE ";" " " flags "${flags}" )
+        SET_SOURCE_FILES_PROPERTIES( ${wrapper} PROPERTIES COMPILE_FLAGS "${flags}" )
+        LIST( APPEND variants ${wrapper} )
+    ENDFOREACH()
+    SET( ${out_var} ${variants} PARENT_SCOPE )
+ENDFUNCTION()
@@ -0,0 +1,170 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/AsyncFile.h>
+
+#ifdef CPPCORE_WINDOWS
+#   include <windows.h>
+#else
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+namespace CPPCore {
+
+static const intptr_t InvalidHandle = -1;
+
+AsyncFile::AsyncFile(ThreadPool &pool) :
+        m_pool(pool),
+        m_handle(InvalidHandle) {
+    // empty
+}
+
+AsyncFile::~AsyncFile() {
+    close();
+}
+
+bool AsyncFile::isOpen() const {
+    return InvalidHandle != m_handle;
+}
+
+#ifdef CPPCORE_WINDOWS
+
+bool AsyncFile::open(const char *path, Mode mode) {
+    close();
+    DWORD access = GENERIC_READ;
+    DWORD disposition = OPEN_EXISTING;
+    if (Mode::Write == mode) {
+        access = GENERIC_WRITE;
+        disposition = CREATE_ALWAYS;
+    } else if (Mode::ReadWrite == mode) {
+        access = GENERIC_READ | GENERIC_WRITE;
+        disposition = OPEN_ALWAYS;
+    }
+    HANDLE file = ::CreateFileA(path, access, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        return false;
+    }
+    m_handle = reinterpret_cast<intptr_t>(file);
+
+    return true;
+}
+
+void AsyncFile::close() {
+    if (isOpen()) {
+        ::CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+        m_handle = InvalidHandle;
+    }
+}
+
+int64_t AsyncFile::readAt(uint64_t offset, void *buffer, size_t size) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD numRead = 0;
+    if (!::ReadFile(reinterpret_cast<HANDLE>(m_handle), buffer, static_cast<DWORD>(size), &numRead, &overlapped)) {
+        return ERROR_HANDLE_EOF == ::GetLastError() ? 0 : -1;
+    }
+
+    return numRead;
+}
+
+int64_t AsyncFile::writeAt(uint64_t offset, const void *buffer, size_t size) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD numWritten = 0;
+    if (!::WriteFile(reinterpret_cast<HANDLE>(m_handle), buffer, static_cast<DWORD>(size), &numWritten, &overlapped)) {
+        return -1;
+    }
+
+    return numWritten;
+}
+
+#else
+
+bool AsyncFile::open(const char *path, Mode mode) {
+    close();
+    int flags = O_RDONLY;
+    if (Mode::Write == mode) {
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    } else if (Mode::ReadWrite == mode) {
+        flags = O_RDWR | O_CREAT;
+    }
+    const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    m_handle = fd;
+
+    return true;
+}
+
+void AsyncFile::close() {
+    if (isOpen()) {
+        ::close(static_cast<int>(m_handle));
+        m_handle = InvalidHandle;
+    }
+}
+
+int64_t AsyncFile::readAt(uint64_t offset, void *buffer, size_t size) {
+    // Short reads are continued until the end of the file
+    size_t total = 0;
+    while (total < size) {
+        const ssize_t result = ::pread(static_cast<int>(m_handle), static_cast<char*>(buffer) + total,
+                size - total, static_cast<off_t>(offset + total));
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        if (0 == result) {
+            break;
+        }
+        total += static_cast<size_t>(result);
+    }
+
+    return static_cast<int64_t>(total);
+}
+
+int64_t AsyncFile::writeAt(uint64_t offset, const void *buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        const ssize_t result = ::pwrite(static_cast<int>(m_handle), static_cast<const char*>(buffer) + total,
+                size - total, static_cast<off_t>(offset + total));
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        total += static_cast<size_t>(result);
+    }
+
+    return static_cast<int64_t>(total);
+}
+
+#endif
+
+} // Namespace CPPCore
@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/ThreadPool.h>
+
+namespace CPPCore {
+
+static thread_local const ThreadPool *t_pool = nullptr;
+
+ThreadPool::ThreadPool(size_t numThreads) :
+        m_threads(),
+        m_mutex(),
+        m_wakeup(),
+        m_queue(),
+        m_shutdown(false) {
+    if (0 == numThreads) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    if (0 == numThreads) {
+        numThreads = 1;
+    }
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_threads.emplace_back(&ThreadPool::workerMain, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeup.notify_all();
+    for (size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i].join();
+    }
+}
+
+void ThreadPool::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(handle);
+    }
+    m_wakeup.notify_one();
+}
+
+bool ThreadPool::isInPool() const noexcept {
+    return this == t_pool;
+}
+
+void ThreadPool::workerMain() {
+    t_pool = this;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wakeup.wait(lock, [this]() { return m_shutdown || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            // Shut down and drained
+            break;
+        }
+
+        std::coroutine_handle<> handle = m_queue.front();
+        m_queue.pop_front();
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+    }
+
+    t_pool = nullptr;
+}
+
+} // Namespace CPPCore
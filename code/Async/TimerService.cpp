@@ -0,0 +1,107 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TimerService.h>
+#include <cppcore/Async/ThreadPool.h>
+
+namespace CPPCore {
+
+TimerService::TimerService(ThreadPool *pool) :
+        m_pool(pool),
+        m_mutex(),
+        m_wakeup(),
+        m_timers(),
+        m_sequence(0),
+        m_shutdown(false),
+        m_thread() {
+    m_thread = std::thread(&TimerService::timerMain, this);
+}
+
+TimerService::~TimerService() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeup.notify_one();
+    m_thread.join();
+}
+
+size_t TimerService::getNumPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timers.size();
+}
+
+void TimerService::add(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    bool isFirst = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        isFirst = m_timers.empty() || deadline < m_timers.top().m_deadline;
+        m_timers.push(Timer{ deadline, m_sequence++, handle });
+    }
+
+    // Only a new earliest deadline changes the sleep of the timer thread
+    if (isFirst) {
+        m_wakeup.notify_one();
+    }
+}
+
+void TimerService::resume(std::coroutine_handle<> handle) {
+    if (nullptr != m_pool) {
+        m_pool->post(handle);
+    } else {
+        handle.resume();
+    }
+}
+
+void TimerService::timerMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        if (m_timers.empty()) {
+            if (m_shutdown) {
+                break;
+            }
+            m_wakeup.wait(lock);
+            continue;
+        }
+
+        const Clock::time_point deadline = m_timers.top().m_deadline;
+        if (!m_shutdown && Clock::now() < deadline) {
+            m_wakeup.wait_until(lock, deadline);
+            continue;
+        }
+
+        // Resume all expired timers with one lock round trip
+        std::vector<std::coroutine_handle<>> expired;
+        const Clock::time_point now = Clock::now();
+        while (!m_timers.empty() && (m_shutdown || m_timers.top().m_deadline <= now)) {
+            expired.push_back(m_timers.top().m_handle);
+            m_timers.pop();
+        }
+        lock.unlock();
+        for (size_t i = 0; i < expired.size(); ++i) {
+            resume(expired[i]);
+        }
+        lock.lock();
+    }
+}
+
+} // Namespace CPPCore
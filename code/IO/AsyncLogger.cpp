@@ -0,0 +1,822 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/AsyncLogger.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef CPPCORE_WINDOWS
+#   include <fcntl.h>
+#   include <io.h>
+#else
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <limits.h>
+#   include <sys/uio.h>
+#   include <unistd.h>
+#endif
+
+namespace CPPCore {
+
+using Details::LogArgType;
+using Details::LogRecord;
+
+std::atomic<uint8_t> AsyncLogger::s_level(static_cast<uint8_t>(LogLevel::Off));
+
+// m_numArgs of the filler record which pads the end of a ring in front of a wrap
+static const uint32_t SkipRecord = 0xffffffffu;
+
+// The background thread starts a new output block after this many bytes
+static const size_t OutputBlockSize = 64 * 1024;
+
+static const char *LevelNames[] = { "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL", "OFF  " };
+
+// The byte ring of one thread, the thread writes the records, the background thread reads them
+struct LogRing {
+    alignas(CacheLineSize) std::atomic<uint64_t> m_head;
+    uint64_t m_reserved;
+    uint64_t m_cachedTail;
+    alignas(CacheLineSize) std::atomic<uint64_t> m_tail;
+    char *m_buffer;
+    uint64_t m_mask;
+    uint32_t m_threadId;
+    std::atomic<bool> m_closed;
+};
+
+struct LoggerState {
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_flushed;
+    std::vector<LogRing*> m_rings;
+    std::thread m_thread;
+    bool m_running;
+    bool m_writerAlive;
+    uint64_t m_flushRequested;
+    uint64_t m_flushDone;
+    int m_fd;
+    bool m_ownsFd;
+    LogLevel m_level;
+    uint32_t m_flushIntervalMs;
+    uint32_t m_nextThreadId;
+    std::atomic<bool> m_open;
+    std::atomic<bool> m_wakePending;
+    std::atomic<size_t> m_ringSize;
+    std::atomic<LogFullPolicy> m_policy;
+    std::atomic<uint64_t> m_numDropped;
+
+    // Converts the timestamps of the records into the wall clock
+    uint64_t m_baseTicks;
+    int64_t m_baseNs;
+    double m_ticksPerNs;
+
+    LoggerState() :
+            m_mutex(),
+            m_wakeup(),
+            m_flushed(),
+            m_rings(),
+            m_thread(),
+            m_running(false),
+            m_writerAlive(false),
+            m_flushRequested(0),
+            m_flushDone(0),
+            m_fd(-1),
+            m_ownsFd(false),
+            m_level(LogLevel::Info),
+            m_flushIntervalMs(5),
+            m_nextThreadId(0),
+            m_open(false),
+            m_wakePending(false),
+            m_ringSize(1 << 16),
+            m_policy(LogFullPolicy::Block),
+            m_numDropped(0),
+            m_baseTicks(0),
+            m_baseNs(0),
+            m_ticksPerNs(1.0) {
+        // empty
+    }
+};
+
+static LoggerState &getState() {
+    // Leaked on purpose, threads may log while the static destructors run
+    static LoggerState *state = new LoggerState;
+    return *state;
+}
+
+// Plain data, so the hot path does not go through the TLS init wrapper
+struct ThreadLogState {
+    LogRing *m_ring;
+    bool m_exited;
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+static thread_local ThreadLogState t_logState __attribute__((tls_model("initial-exec")));
+#else
+static thread_local ThreadLogState t_logState;
+#endif
+
+static void releaseRing(LogRing *ring);
+
+// Hands the ring to the background thread when the thread exits, it is freed once drained
+struct LogRingReleaser {
+    ~LogRingReleaser() {
+        if (nullptr != t_logState.m_ring) {
+            releaseRing(t_logState.m_ring);
+            t_logState.m_ring = nullptr;
+        }
+        t_logState.m_exited = true;
+    }
+};
+
+static LogRing *registerRing() {
+    ThreadLogState &thread = t_logState;
+    if (thread.m_exited) {
+        return nullptr;
+    }
+    static thread_local LogRingReleaser releaser;
+    (void) releaser;
+
+    LoggerState &state = getState();
+    const size_t size = state.m_ringSize.load(std::memory_order_relaxed);
+    LogRing *ring = new LogRing;
+    ring->m_head.store(0, std::memory_order_relaxed);
+    ring->m_reserved = 0;
+    ring->m_cachedTail = 0;
+    ring->m_tail.store(0, std::memory_order_relaxed);
+    ring->m_buffer = static_cast<char*>(::operator new(size, std::align_val_t(CacheLineSize)));
+    ring->m_mask = size - 1;
+    ring->m_closed.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        ring->m_threadId = ++state.m_nextThreadId;
+        state.m_rings.push_back(ring);
+    }
+    thread.m_ring = ring;
+
+    return ring;
+}
+
+static void freeRing(LogRing *ring) {
+    ::operator delete(ring->m_buffer, std::align_val_t(CacheLineSize));
+    delete ring;
+}
+
+// Frees the rings of exited threads which are drained, the caller holds the mutex
+static void freeClosedRings(LoggerState &state) {
+    for (size_t i = 0; i < state.m_rings.size();) {
+        LogRing *ring = state.m_rings[i];
+        if (ring->m_closed.load(std::memory_order_acquire) &&
+                ring->m_tail.load(std::memory_order_relaxed) == ring->m_head.load(std::memory_order_acquire)) {
+            freeRing(ring);
+            state.m_rings[i] = state.m_rings.back();
+            state.m_rings.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+static void releaseRing(LogRing *ring) {
+    LoggerState &state = getState();
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    ring->m_closed.store(true, std::memory_order_release);
+    if (!state.m_writerAlive) {
+        // Nobody would drain it before the next open, a drained ring goes at once
+        freeClosedRings(state);
+    }
+}
+
+static void wakeWriter(LoggerState &state) {
+    if (!state.m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        state.m_wakeup.notify_one();
+    }
+}
+
+// Waits until the background thread moved the tail of the ring to at least minTail
+static bool waitForSpace(LogRing &ring, uint64_t minTail) {
+    LoggerState &state = getState();
+    ring.m_cachedTail = ring.m_tail.load(std::memory_order_acquire);
+    if (ring.m_cachedTail >= minTail) {
+        return true;
+    }
+
+    wakeWriter(state);
+    if (LogFullPolicy::Drop == state.m_policy.load(std::memory_order_relaxed)) {
+        state.m_numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Backoff backoff;
+    for (;;) {
+        if (!state.m_open.load(std::memory_order_acquire)) {
+            state.m_numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        backoff.pause();
+        ring.m_cachedTail = ring.m_tail.load(std::memory_order_acquire);
+        if (ring.m_cachedTail >= minTail) {
+            return true;
+        }
+        wakeWriter(state);
+    }
+}
+
+char *AsyncLogger::reserve(size_t size) {
+    LogRing *ring = t_logState.m_ring;
+    if (nullptr == ring) {
+        ring = registerRing();
+        if (nullptr == ring) {
+            return nullptr;
+        }
+    }
+
+    const uint64_t capacity = ring->m_mask + 1;
+    if (size > capacity / 2) {
+        getState().m_numDropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // A record never wraps, a filler takes the rest of the ring instead
+    uint64_t head = ring->m_head.load(std::memory_order_relaxed);
+    const uint64_t offset = head & ring->m_mask;
+    const uint64_t contiguous = capacity - offset;
+    const uint64_t needed = size <= contiguous ? size : contiguous + size;
+    if (head + needed > ring->m_cachedTail + capacity && !waitForSpace(*ring, head + needed - capacity)) {
+        return nullptr;
+    }
+    if (size > contiguous) {
+        const uint32_t skip[2] = { static_cast<uint32_t>(contiguous), SkipRecord };
+        ::memcpy(ring->m_buffer + offset, skip, sizeof(skip));
+        head += contiguous;
+    }
+    ring->m_reserved = head;
+
+    return ring->m_buffer + (head & ring->m_mask);
+}
+
+void AsyncLogger::commit(size_t size) {
+    LogRing *ring = t_logState.m_ring;
+    ring->m_head.store(ring->m_reserved + size, std::memory_order_release);
+}
+
+static int64_t getWallClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t getTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Measures the tick rate against the wall clock, more precise the longer the logger runs
+static void calibrate(LoggerState &state, bool initial) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (initial) {
+        state.m_baseTicks = getTicks();
+        state.m_baseNs = getWallClockNs();
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+        while (std::chrono::steady_clock::now() < end) {
+            cpuRelax();
+        }
+    }
+    const uint64_t ticks = getTicks();
+    const int64_t ns = getWallClockNs();
+    if (ns > state.m_baseNs && ticks > state.m_baseTicks) {
+        state.m_ticksPerNs = static_cast<double>(ticks - state.m_baseTicks) / static_cast<double>(ns - state.m_baseNs);
+    }
+#else
+    if (initial) {
+        state.m_baseTicks = getTicks();
+        state.m_baseNs = getWallClockNs();
+        state.m_ticksPerNs = 1.0;
+    }
+#endif
+}
+
+struct LogArgValue {
+    LogArgType m_type;
+    uint64_t m_raw;
+    const char *m_str;
+    uint32_t m_len;
+};
+
+static int64_t getInt(const LogArgValue &arg) {
+    if (LogArgType::Double == arg.m_type) {
+        double value = 0;
+        ::memcpy(&value, &arg.m_raw, sizeof(value));
+        return static_cast<int64_t>(value);
+    }
+    return static_cast<int64_t>(arg.m_raw);
+}
+
+static double getDouble(const LogArgValue &arg) {
+    if (LogArgType::Double == arg.m_type) {
+        double value = 0;
+        ::memcpy(&value, &arg.m_raw, sizeof(value));
+        return value;
+    }
+    return LogArgType::UInt == arg.m_type ? static_cast<double>(arg.m_raw) : static_cast<double>(static_cast<int64_t>(arg.m_raw));
+}
+
+// Appends a decimal number, padded with zeros to the given number of digits
+static void appendDecimal(std::string &out, uint64_t value, size_t minDigits = 1) {
+    char buffer[24];
+    size_t pos = sizeof(buffer);
+    do {
+        buffer[--pos] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (0 != value || sizeof(buffer) - pos < minDigits);
+    out.append(buffer + pos, sizeof(buffer) - pos);
+}
+
+template <class T>
+static void appendFormatted(std::string &out, const char *spec, T value) {
+    char buffer[128];
+    const int len = ::snprintf(buffer, sizeof(buffer), spec, value);
+    if (len < 0) {
+        return;
+    }
+    if (static_cast<size_t>(len) < sizeof(buffer)) {
+        out.append(buffer, static_cast<size_t>(len));
+        return;
+    }
+    const size_t start = out.size();
+    out.resize(start + static_cast<size_t>(len) + 1);
+    ::snprintf(&out[start], static_cast<size_t>(len) + 1, spec, value);
+    out.resize(start + static_cast<size_t>(len));
+}
+
+// Formats one message like printf would, with the decoded arguments
+static void formatMessage(const char *format, const std::vector<LogArgValue> &args, std::string &scratch, std::string &out) {
+    size_t next = 0;
+    const char *pos = format;
+    while (0 != *pos) {
+        if ('%' != *pos) {
+            const char *start = pos;
+            while (0 != *pos && '%' != *pos) {
+                ++pos;
+            }
+            out.append(start, static_cast<size_t>(pos - start));
+            continue;
+        }
+        if ('%' == pos[1]) {
+            out += '%';
+            pos += 2;
+            continue;
+        }
+
+        // Keep flags, width and precision, the length is replaced by the one of the stored value
+        char spec[40];
+        size_t len = 0;
+        spec[len++] = *pos++;
+        while (0 != *pos && nullptr != ::strchr("-+ #0", *pos) && len < 8) {
+            spec[len++] = *pos++;
+        }
+        while (*pos >= '0' && *pos <= '9' && len < 16) {
+            spec[len++] = *pos++;
+        }
+        if ('.' == *pos) {
+            spec[len++] = *pos++;
+            while (*pos >= '0' && *pos <= '9' && len < 24) {
+                spec[len++] = *pos++;
+            }
+        }
+        while (0 != *pos && nullptr != ::strchr("hlLqjzt", *pos)) {
+            ++pos;
+        }
+        const char conversion = *pos;
+        if (0 == conversion) {
+            break;
+        }
+        ++pos;
+        if (next >= args.size()) {
+            out += "<missing>";
+            continue;
+        }
+
+        const LogArgValue &arg = args[next++];
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                if (1 == len) {
+                    // The plain %d is by far the most common one
+                    const int64_t value = getInt(arg);
+                    if (value < 0) {
+                        out += '-';
+                    }
+                    appendDecimal(out, value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+                    break;
+                }
+                ::memcpy(spec + len, "lld", 4);
+                appendFormatted(out, spec, static_cast<long long>(getInt(arg)));
+                break;
+            case 'u':
+                if (1 == len) {
+                    appendDecimal(out, static_cast<uint64_t>(getInt(arg)));
+                    break;
+                }
+                [[fallthrough]];
+            case 'o':
+            case 'x':
+            case 'X':
+                spec[len++] = 'l';
+                spec[len++] = 'l';
+                spec[len++] = conversion;
+                spec[len] = 0;
+                appendFormatted(out, spec, static_cast<unsigned long long>(getInt(arg)));
+                break;
+            case 'c':
+                spec[len++] = 'c';
+                spec[len] = 0;
+                appendFormatted(out, spec, static_cast<int>(getInt(arg)));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[len++] = conversion;
+                spec[len] = 0;
+                appendFormatted(out, spec, getDouble(arg));
+                break;
+            case 's':
+                if (LogArgType::String != arg.m_type) {
+                    out += "<not a string>";
+                } else if (1 == len) {
+                    out.append(arg.m_str, arg.m_len);
+                } else {
+                    scratch.assign(arg.m_str, arg.m_len);
+                    spec[len++] = 's';
+                    spec[len] = 0;
+                    appendFormatted(out, spec, scratch.c_str());
+                }
+                break;
+            case 'p':
+                appendFormatted(out, "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(arg.m_raw)));
+                break;
+            default:
+                out += '%';
+                out += conversion;
+                break;
+        }
+    }
+}
+
+// The read position of the background thread in one ring during a pass
+struct RingCursor {
+    LogRing *m_ring;
+    uint64_t m_tail;
+    uint64_t m_head;
+};
+
+// Returns the next record of the ring, skips the filler in front of a wrap
+static const LogRecord *getRecord(RingCursor &cursor) {
+    while (cursor.m_tail < cursor.m_head) {
+        const char *memory = cursor.m_ring->m_buffer + (cursor.m_tail & cursor.m_ring->m_mask);
+        uint32_t header[2];
+        ::memcpy(header, memory, sizeof(header));
+        if (SkipRecord != header[1]) {
+            return reinterpret_cast<const LogRecord*>(memory);
+        }
+        cursor.m_tail += header[0];
+    }
+    return nullptr;
+}
+
+class LogWriter {
+public:
+    explicit LogWriter(LoggerState &state) :
+            m_state(state),
+            m_blocks(1),
+            m_numBlocks(1),
+            m_args(),
+            m_scratch(),
+            m_lastSecond(-1) {
+        m_blocks[0].reserve(OutputBlockSize + 1024);
+        m_prefix[0] = 0;
+    }
+
+    // Formats all records of the rings in time order
+    void drain(const std::vector<LogRing*> &rings) {
+        std::vector<RingCursor> cursors;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            RingCursor cursor = { rings[i], rings[i]->m_tail.load(std::memory_order_relaxed), rings[i]->m_head.load(std::memory_order_acquire) };
+            if (cursor.m_tail != cursor.m_head) {
+                cursors.push_back(cursor);
+            }
+        }
+        calibrate(m_state, false);
+
+        for (;;) {
+            RingCursor *oldest = nullptr;
+            const LogRecord *oldestRecord = nullptr;
+            for (size_t i = 0; i < cursors.size(); ++i) {
+                const LogRecord *record = getRecord(cursors[i]);
+                if (nullptr != record && (nullptr == oldestRecord || record->m_timestamp < oldestRecord->m_timestamp)) {
+                    oldest = &cursors[i];
+                    oldestRecord = record;
+                }
+            }
+            if (nullptr == oldestRecord) {
+                break;
+            }
+            format(*oldestRecord, oldest->m_ring->m_threadId);
+            oldest->m_tail += oldestRecord->m_size;
+        }
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            cursors[i].m_ring->m_tail.store(cursors[i].m_tail, std::memory_order_release);
+        }
+    }
+
+    // Writes all formatted lines, up to IOV_MAX blocks per system call
+    void write() {
+        if (m_blocks[0].empty()) {
+            return;
+        }
+#ifdef CPPCORE_WINDOWS
+        for (size_t i = 0; i < m_numBlocks; ++i) {
+            ::_write(m_state.m_fd, m_blocks[i].data(), static_cast<unsigned int>(m_blocks[i].size()));
+        }
+#else
+        std::vector<iovec> iovecs(m_numBlocks);
+        for (size_t i = 0; i < m_numBlocks; ++i) {
+            iovecs[i].iov_base = &m_blocks[i][0];
+            iovecs[i].iov_len = m_blocks[i].size();
+        }
+        size_t first = 0;
+        while (first < iovecs.size()) {
+            const size_t count = iovecs.size() - first < IOV_MAX ? iovecs.size() - first : IOV_MAX;
+            const ssize_t written = ::writev(m_state.m_fd, &iovecs[first], static_cast<int>(count));
+            if (written < 0) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                break;
+            }
+            // Skip what was written, a partial write continues in the middle of a block
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iovecs.size() && remaining >= iovecs[first].iov_len) {
+                remaining -= iovecs[first].iov_len;
+                ++first;
+            }
+            if (first < iovecs.size()) {
+                iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + remaining;
+                iovecs[first].iov_len -= remaining;
+            }
+        }
+#endif
+        for (size_t i = 0; i < m_numBlocks; ++i) {
+            m_blocks[i].clear();
+        }
+        m_numBlocks = 1;
+    }
+
+private:
+    void format(const LogRecord &record, uint32_t threadId) {
+        // Decode the arguments
+        m_args.clear();
+        const char *pos = reinterpret_cast<const char*>(&record) + sizeof(LogRecord);
+        for (uint32_t i = 0; i < record.m_numArgs; ++i) {
+            LogArgValue arg = { static_cast<LogArgType>(*pos++), 0, nullptr, 0 };
+            if (LogArgType::String == arg.m_type) {
+                ::memcpy(&arg.m_len, pos, sizeof(arg.m_len));
+                arg.m_str = pos + sizeof(arg.m_len);
+                pos += sizeof(arg.m_len) + arg.m_len;
+            } else {
+                ::memcpy(&arg.m_raw, pos, sizeof(arg.m_raw));
+                pos += sizeof(arg.m_raw);
+            }
+            m_args.push_back(arg);
+        }
+
+        std::string &out = m_blocks[m_numBlocks - 1];
+        appendTime(out, record.m_timestamp);
+        out += ' ';
+        out += LevelNames[static_cast<size_t>(record.m_site->m_level)];
+        out += " [";
+        appendDecimal(out, threadId);
+        out += "] ";
+        formatMessage(record.m_site->m_format, m_args, m_scratch, out);
+        out += '\n';
+
+        if (out.size() >= OutputBlockSize) {
+            if (m_numBlocks == m_blocks.size()) {
+                m_blocks.push_back(std::string());
+                m_blocks.back().reserve(OutputBlockSize + 1024);
+            }
+            ++m_numBlocks;
+        }
+    }
+
+    // Appends the UTC time with microseconds, the date part is formatted once per second
+    void appendTime(std::string &out, uint64_t ticks) {
+        const double deltaNs = static_cast<double>(static_cast<int64_t>(ticks - m_state.m_baseTicks)) / m_state.m_ticksPerNs;
+        const int64_t ns = m_state.m_baseNs + static_cast<int64_t>(deltaNs);
+        const int64_t second = ns / 1000000000;
+        if (second != m_lastSecond) {
+            const time_t time = static_cast<time_t>(second);
+            struct tm parts;
+#ifdef CPPCORE_WINDOWS
+            ::gmtime_s(&parts, &time);
+#else
+            ::gmtime_r(&time, &parts);
+#endif
+            ::strftime(m_prefix, sizeof(m_prefix), "%Y-%m-%d %H:%M:%S", &parts);
+            m_lastSecond = second;
+        }
+        out += m_prefix;
+        out += '.';
+        appendDecimal(out, static_cast<uint64_t>(ns % 1000000000 / 1000), 6);
+    }
+
+    LoggerState &m_state;
+    std::vector<std::string> m_blocks;
+    size_t m_numBlocks;
+    std::vector<LogArgValue> m_args;
+    std::string m_scratch;
+    int64_t m_lastSecond;
+    char m_prefix[32];
+};
+
+static void removeClosedRings(LoggerState &state) {
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    freeClosedRings(state);
+}
+
+static void runWriter(LoggerState *state) {
+    LogWriter writer(*state);
+    std::vector<LogRing*> rings;
+    for (;;) {
+        bool running = true;
+        uint64_t flushRequested = 0;
+        {
+            std::unique_lock<std::mutex> lock(state->m_mutex);
+            state->m_wakeup.wait_for(lock, std::chrono::milliseconds(state->m_flushIntervalMs), [state]() {
+                return !state->m_running || state->m_wakePending.load(std::memory_order_relaxed) ||
+                       state->m_flushRequested != state->m_flushDone;
+            });
+            running = state->m_running;
+            flushRequested = state->m_flushRequested;
+            rings = state->m_rings;
+        }
+        state->m_wakePending.store(false, std::memory_order_release);
+
+        writer.drain(rings);
+        writer.write();
+        removeClosedRings(*state);
+        {
+            std::lock_guard<std::mutex> lock(state->m_mutex);
+            state->m_flushDone = flushRequested;
+        }
+        state->m_flushed.notify_all();
+        if (!running) {
+            return;
+        }
+    }
+}
+
+bool AsyncLogger::open(const char *path, const LoggerOptions &options) {
+    if (nullptr == path) {
+        return false;
+    }
+#ifdef CPPCORE_WINDOWS
+    const int fd = ::_open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+#else
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    if (!open(fd, options)) {
+#ifdef CPPCORE_WINDOWS
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+        return false;
+    }
+    getState().m_ownsFd = true;
+
+    return true;
+}
+
+bool AsyncLogger::open(int fd, const LoggerOptions &options) {
+    LoggerState &state = getState();
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    if (state.m_running || fd < 0) {
+        return false;
+    }
+
+    size_t ringSize = 1024;
+    while (ringSize < options.m_ringSize) {
+        ringSize *= 2;
+    }
+    state.m_ringSize.store(ringSize, std::memory_order_relaxed);
+    state.m_policy.store(options.m_policy, std::memory_order_relaxed);
+    state.m_flushIntervalMs = 0 == options.m_flushIntervalMs ? 1 : options.m_flushIntervalMs;
+    state.m_level = options.m_level;
+    state.m_fd = fd;
+    state.m_ownsFd = false;
+    state.m_numDropped.store(0, std::memory_order_relaxed);
+    calibrate(state, true);
+    state.m_running = true;
+    state.m_writerAlive = true;
+    state.m_open.store(true, std::memory_order_release);
+    state.m_thread = std::thread(runWriter, &state);
+    s_level.store(static_cast<uint8_t>(state.m_level), std::memory_order_release);
+
+    return true;
+}
+
+void AsyncLogger::close() {
+    LoggerState &state = getState();
+    {
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        if (!state.m_running) {
+            return;
+        }
+        s_level.store(static_cast<uint8_t>(LogLevel::Off), std::memory_order_release);
+        state.m_running = false;
+        state.m_open.store(false, std::memory_order_release);
+    }
+    state.m_wakeup.notify_one();
+    state.m_thread.join();
+    {
+        // Rings of threads which exit from now on are freed by the threads themselves
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        state.m_writerAlive = false;
+        freeClosedRings(state);
+    }
+
+    if (state.m_ownsFd) {
+#ifdef CPPCORE_WINDOWS
+        ::_close(state.m_fd);
+#else
+        ::close(state.m_fd);
+#endif
+    }
+    state.m_fd = -1;
+    state.m_ownsFd = false;
+}
+
+void AsyncLogger::flush() {
+    LoggerState &state = getState();
+    std::unique_lock<std::mutex> lock(state.m_mutex);
+    if (!state.m_running) {
+        return;
+    }
+    const uint64_t ticket = ++state.m_flushRequested;
+    state.m_wakeup.notify_one();
+    state.m_flushed.wait(lock, [&state, ticket]() {
+        return state.m_flushDone >= ticket || !state.m_running;
+    });
+}
+
+void AsyncLogger::setLevel(LogLevel level) {
+    LoggerState &state = getState();
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    state.m_level = level;
+    if (state.m_running) {
+        s_level.store(static_cast<uint8_t>(level), std::memory_order_release);
+    }
+}
+
+LogLevel AsyncLogger::getLevel() {
+    return static_cast<LogLevel>(s_level.load(std::memory_order_relaxed));
+}
+
+uint64_t AsyncLogger::getNumDropped() {
+    return getState().m_numDropped.load(std::memory_order_relaxed);
+}
+
+} // Namespace CPPCore
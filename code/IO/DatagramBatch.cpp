@@ -0,0 +1,120 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/DatagramBatch.h>
+
+#ifdef CPPCORE_GNU_LINUX
+
+#include <errno.h>
+#include <sys/uio.h>
+
+namespace CPPCore {
+
+DatagramBatch::DatagramBatch(size_t capacity, size_t bufferSize) :
+        m_capacity(0 == capacity ? 1 : capacity),
+        m_bufferSize(bufferSize),
+        m_buffer(m_capacity * bufferSize),
+        m_sizes(m_capacity, 0),
+        m_addresses(m_capacity),
+        m_addressLengths(m_capacity, 0),
+        m_messages(nullptr),
+        m_iovecs(nullptr) {
+    m_messages = new mmsghdr[m_capacity];
+    m_iovecs = new iovec[m_capacity];
+}
+
+DatagramBatch::~DatagramBatch() {
+    delete [] m_messages;
+    delete [] m_iovecs;
+}
+
+int DatagramBatch::receive(int fd) {
+    for (size_t i = 0; i < m_capacity; ++i) {
+        m_iovecs[i].iov_base = getData(i);
+        m_iovecs[i].iov_len = m_bufferSize;
+        m_messages[i] = {};
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+        m_messages[i].msg_hdr.msg_name = &m_addresses[i];
+        m_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+    }
+
+    int result = 0;
+    do {
+        result = ::recvmmsg(fd, m_messages, static_cast<unsigned int>(m_capacity), MSG_DONTWAIT, nullptr);
+    } while (result < 0 && EINTR == errno);
+    if (result < 0) {
+        return EAGAIN == errno || EWOULDBLOCK == errno ? 0 : -1;
+    }
+
+    for (int i = 0; i < result; ++i) {
+        m_sizes[i] = m_messages[i].msg_len;
+        m_addressLengths[i] = m_messages[i].msg_hdr.msg_namelen;
+    }
+
+    return result;
+}
+
+int DatagramBatch::send(int fd, size_t count) {
+    if (count > m_capacity) {
+        count = m_capacity;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_iovecs[i].iov_base = getData(i);
+        m_iovecs[i].iov_len = m_sizes[i];
+        m_messages[i] = {};
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+        if (0 != m_addressLengths[i]) {
+            m_messages[i].msg_hdr.msg_name = &m_addresses[i];
+            m_messages[i].msg_hdr.msg_namelen = m_addressLengths[i];
+        }
+    }
+
+    // sendmmsg may stop early, keep going until all went out or the socket is full
+    size_t numSent = 0;
+    while (numSent < count) {
+        const int result = ::sendmmsg(fd, m_messages + numSent, static_cast<unsigned int>(count - numSent), MSG_DONTWAIT);
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            if (EAGAIN == errno || EWOULDBLOCK == errno) {
+                break;
+            }
+            return 0 == numSent ? -1 : static_cast<int>(numSent);
+        }
+        numSent += static_cast<size_t>(result);
+    }
+
+    return static_cast<int>(numSent);
+}
+
+void DatagramBatch::clearAddresses() {
+    for (size_t i = 0; i < m_capacity; ++i) {
+        m_addressLengths[i] = 0;
+    }
+}
+
+} // Namespace CPPCore
+
+#endif // CPPCORE_GNU_LINUX
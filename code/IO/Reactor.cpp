@@ -0,0 +1,341 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/Reactor.h>
+
+#ifdef CPPCORE_GNU_LINUX
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace CPPCore {
+
+static const int MaxEvents = 256;
+static const size_t MaxTasksPerRound = 4096;
+
+struct Reactor::Registration {
+    int m_fd;
+    bool m_active;
+    Handler m_handler;
+};
+
+struct Reactor::PostedTask : public MpscNode {
+    Task m_task;
+};
+
+static uint32_t toEpollEvents(uint32_t events) {
+    uint32_t result = EPOLLET;
+    if (0 != (events & Reactor::Readable)) {
+        result |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (0 != (events & Reactor::Writable)) {
+        result |= EPOLLOUT;
+    }
+    return result;
+}
+
+static uint32_t fromEpollEvents(uint32_t events) {
+    uint32_t result = 0;
+    if (0 != (events & (EPOLLIN | EPOLLRDHUP))) {
+        result |= Reactor::Readable;
+    }
+    if (0 != (events & EPOLLOUT)) {
+        result |= Reactor::Writable;
+    }
+    if (0 != (events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))) {
+        result |= Reactor::Closed;
+    }
+    return result;
+}
+
+Reactor::Reactor() :
+        m_epoll(-1),
+        m_eventFd(-1),
+        m_registrations(),
+        m_graveyard(),
+        m_dispatching(false),
+        m_tasks(),
+        m_wakeupPending(false),
+        m_stopped(false),
+        m_loopThread(),
+        m_timers(0),
+        m_start(std::chrono::steady_clock::now()),
+        m_now(0) {
+    m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    m_eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epoll >= 0 && m_eventFd >= 0) {
+        // The eventfd is told apart from the registrations by a null pointer
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = nullptr;
+        ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_eventFd, &event);
+    }
+}
+
+Reactor::~Reactor() {
+    while (PostedTask *task = m_tasks.pop()) {
+        delete task;
+    }
+    for (size_t i = 0; i < m_registrations.size(); ++i) {
+        delete m_registrations[i];
+    }
+    for (size_t i = 0; i < m_graveyard.size(); ++i) {
+        delete m_graveyard[i];
+    }
+    if (m_eventFd >= 0) {
+        ::close(m_eventFd);
+    }
+    if (m_epoll >= 0) {
+        ::close(m_epoll);
+    }
+}
+
+bool Reactor::isValid() const {
+    return m_epoll >= 0 && m_eventFd >= 0;
+}
+
+bool Reactor::add(int fd, uint32_t events, Handler handler) {
+    if (fd < 0) {
+        return false;
+    }
+    if (static_cast<size_t>(fd) >= m_registrations.size()) {
+        m_registrations.resize(fd + 1, nullptr);
+    }
+    if (nullptr != m_registrations[fd]) {
+        return false;
+    }
+
+    Registration *registration = new Registration{ fd, true, std::move(handler) };
+    epoll_event event = {};
+    event.events = toEpollEvents(events);
+    event.data.ptr = registration;
+    if (0 != ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event)) {
+        delete registration;
+        return false;
+    }
+    m_registrations[fd] = registration;
+
+    return true;
+}
+
+bool Reactor::modify(int fd, uint32_t events) {
+    if (fd < 0 || static_cast<size_t>(fd) >= m_registrations.size() || nullptr == m_registrations[fd]) {
+        return false;
+    }
+
+    epoll_event event = {};
+    event.events = toEpollEvents(events);
+    event.data.ptr = m_registrations[fd];
+
+    return 0 == ::epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event);
+}
+
+bool Reactor::remove(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= m_registrations.size() || nullptr == m_registrations[fd]) {
+        return false;
+    }
+
+    Registration *registration = m_registrations[fd];
+    m_registrations[fd] = nullptr;
+    ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    registration->m_active = false;
+
+    // Events of the current batch may still point to it
+    if (m_dispatching) {
+        m_graveyard.push_back(registration);
+    } else {
+        delete registration;
+    }
+
+    return true;
+}
+
+void Reactor::post(Task task) {
+    PostedTask *posted = new PostedTask;
+    posted->m_task = std::move(task);
+    m_tasks.push(posted);
+
+    // The loop checks the queue before it blocks, only a foreign thread has to wake it
+    if (!isInLoopThread() && !m_wakeupPending.exchange(true, std::memory_order_seq_cst)) {
+        wakeup();
+    }
+}
+
+Reactor::TimerHandle Reactor::runAfter(uint64_t delayMs, Task task) {
+    return m_timers.schedule(m_now + delayMs, std::move(task));
+}
+
+bool Reactor::cancel(TimerHandle &handle) {
+    return m_timers.cancel(handle);
+}
+
+void Reactor::wakeup() {
+    const uint64_t one = 1;
+    ssize_t result = 0;
+    do {
+        result = ::write(m_eventFd, &one, sizeof(one));
+    } while (result < 0 && EINTR == errno);
+}
+
+uint64_t Reactor::readClock() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_start).count());
+}
+
+size_t Reactor::runTasks() {
+    size_t numRun = 0;
+    while (numRun < MaxTasksPerRound) {
+        PostedTask *posted = m_tasks.pop();
+        if (nullptr == posted) {
+            break;
+        }
+        posted->m_task();
+        delete posted;
+        ++numRun;
+    }
+
+    return numRun;
+}
+
+size_t Reactor::runOnce(int timeoutMs) {
+    m_loopThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    m_now = readClock();
+
+    // Do not sleep past the next timer or over pending tasks
+    const uint64_t nextExpiry = m_timers.getNextExpiry();
+    if (std::numeric_limits<uint64_t>::max() != nextExpiry) {
+        const uint64_t delta = nextExpiry > m_now ? nextExpiry - m_now : 0;
+        if (timeoutMs < 0 || delta < static_cast<uint64_t>(timeoutMs)) {
+            // A timer far away would wrap negative and let epoll_wait block forever
+            timeoutMs = static_cast<int>(std::min<uint64_t>(delta, std::numeric_limits<int>::max()));
+        }
+    }
+    if (!m_tasks.isEmpty() || m_stopped.load(std::memory_order_relaxed)) {
+        timeoutMs = 0;
+    }
+
+    epoll_event events[MaxEvents];
+    const int numEvents = ::epoll_wait(m_epoll, events, MaxEvents, timeoutMs);
+    m_now = readClock();
+
+    size_t numRun = 0;
+    m_dispatching = true;
+    for (int i = 0; i < numEvents; ++i) {
+        Registration *registration = static_cast<Registration*>(events[i].data.ptr);
+        if (nullptr == registration) {
+            uint64_t value = 0;
+            while (::read(m_eventFd, &value, sizeof(value)) > 0) {
+                // drain
+            }
+            m_wakeupPending.store(false, std::memory_order_seq_cst);
+            continue;
+        }
+        if (registration->m_active) {
+            registration->m_handler(fromEpollEvents(events[i].events));
+            ++numRun;
+        }
+    }
+    m_dispatching = false;
+    for (size_t i = 0; i < m_graveyard.size(); ++i) {
+        delete m_graveyard[i];
+    }
+    m_graveyard.clear();
+
+    numRun += runTasks();
+    numRun += m_timers.advance(m_now, [](Task &task) {
+        task();
+    });
+
+    return numRun;
+}
+
+void Reactor::run() {
+    while (!m_stopped.load(std::memory_order_acquire)) {
+        runOnce(-1);
+    }
+    m_stopped.store(false, std::memory_order_relaxed);
+}
+
+void Reactor::stop() {
+    m_stopped.store(true, std::memory_order_release);
+    wakeup();
+}
+
+bool Reactor::isInLoopThread() const {
+    return std::this_thread::get_id() == m_loopThread.load(std::memory_order_relaxed);
+}
+
+ReactorGroup::ReactorGroup(size_t numLoops) :
+        m_reactors(),
+        m_threads(),
+        m_next(0) {
+    if (0 == numLoops) {
+        numLoops = std::thread::hardware_concurrency();
+    }
+    if (0 == numLoops) {
+        numLoops = 1;
+    }
+
+    for (size_t i = 0; i < numLoops; ++i) {
+        m_reactors.push_back(new Reactor);
+    }
+    for (size_t i = 0; i < numLoops; ++i) {
+        Reactor *reactor = m_reactors[i];
+        m_threads.push_back(std::thread([reactor]() {
+            reactor->run();
+        }));
+    }
+}
+
+ReactorGroup::~ReactorGroup() {
+    stop();
+    for (size_t i = 0; i < m_reactors.size(); ++i) {
+        delete m_reactors[i];
+    }
+}
+
+Reactor &ReactorGroup::getReactor(size_t index) {
+    return *m_reactors[index];
+}
+
+Reactor &ReactorGroup::getNext() {
+    return *m_reactors[m_next.fetch_add(1, std::memory_order_relaxed) % m_reactors.size()];
+}
+
+void ReactorGroup::stop() {
+    for (size_t i = 0; i < m_reactors.size(); ++i) {
+        m_reactors[i]->stop();
+    }
+    for (size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i].join();
+    }
+    m_threads.clear();
+}
+
+} // Namespace CPPCore
+
+#endif // CPPCORE_GNU_LINUX
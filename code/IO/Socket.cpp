@@ -0,0 +1,193 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/IO/Socket.h>
+
+#ifndef CPPCORE_WINDOWS
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace CPPCore {
+
+static bool makeAddress(const char *address, uint16_t port, sockaddr_in &result) {
+    result = {};
+    result.sin_family = AF_INET;
+    result.sin_port = htons(port);
+    return 1 == ::inet_pton(AF_INET, address, &result.sin_addr);
+}
+
+#ifndef CPPCORE_GNU_LINUX
+
+// Without SOCK_NONBLOCK and SOCK_CLOEXEC the flags are set after the socket was created.
+static int configure(int fd, bool nonBlocking) {
+    if (fd < 0) {
+        return fd;
+    }
+    if (0 != ::fcntl(fd, F_SETFD, FD_CLOEXEC) || (nonBlocking && !Socket::setNonBlocking(fd))) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+#endif // CPPCORE_GNU_LINUX
+
+static int openSocket(int type, bool nonBlocking) {
+#ifdef CPPCORE_GNU_LINUX
+    return ::socket(AF_INET, type | SOCK_CLOEXEC | (nonBlocking ? SOCK_NONBLOCK : 0), 0);
+#else
+    return configure(::socket(AF_INET, type, 0), nonBlocking);
+#endif
+}
+
+static int openBound(int type, const char *address, uint16_t port, bool reusePort) {
+    sockaddr_in addr;
+    if (!makeAddress(address, port, addr)) {
+        return -1;
+    }
+
+    const int fd = openSocket(type, true);
+    if (fd < 0) {
+        return -1;
+    }
+    // For UDP SO_REUSEADDR would let any later socket take over the port
+    const int one = 1;
+    if (SOCK_STREAM == type) {
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+#ifdef SO_REUSEPORT
+    if (reusePort && 0 != ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one))) {
+        ::close(fd);
+        return -1;
+    }
+#else
+    (void) reusePort;
+#endif
+    if (0 != ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr))) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int Socket::openTcpListener(const char *address, uint16_t port, bool reusePort, int backlog) {
+    const int fd = openBound(SOCK_STREAM, address, port, reusePort);
+    if (fd < 0) {
+        return -1;
+    }
+    if (0 != ::listen(fd, backlog)) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int Socket::connectTcp(const char *address, uint16_t port) {
+    sockaddr_in addr;
+    if (!makeAddress(address, port, addr)) {
+        return -1;
+    }
+
+    const int fd = openSocket(SOCK_STREAM, false);
+    if (fd < 0) {
+        return -1;
+    }
+    int result = 0;
+    do {
+        result = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    } while (0 != result && EINTR == errno);
+    if (0 != result || !setNonBlocking(fd)) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int Socket::accept(int listener) {
+    int fd = -1;
+    do {
+#ifdef CPPCORE_GNU_LINUX
+        fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        fd = ::accept(listener, nullptr, nullptr);
+#endif
+    } while (fd < 0 && EINTR == errno);
+
+#ifdef CPPCORE_GNU_LINUX
+    return fd;
+#else
+    return configure(fd, true);
+#endif
+}
+
+int Socket::openUdp(const char *address, uint16_t port, bool reusePort) {
+    return openBound(SOCK_DGRAM, address, port, reusePort);
+}
+
+bool Socket::connectUdp(int fd, const char *address, uint16_t port) {
+    sockaddr_in addr;
+    if (!makeAddress(address, port, addr)) {
+        return false;
+    }
+
+    return 0 == ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+}
+
+bool Socket::setNonBlocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && 0 == ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+bool Socket::setNoDelay(int fd) {
+    const int one = 1;
+    return 0 == ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+uint16_t Socket::getLocalPort(int fd) {
+    sockaddr_in addr = {};
+    socklen_t length = sizeof(addr);
+    if (0 != ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length)) {
+        return 0;
+    }
+
+    return ntohs(addr.sin_port);
+}
+
+void Socket::close(int fd) {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+} // Namespace CPPCore
+
+#endif // CPPCORE_WINDOWS
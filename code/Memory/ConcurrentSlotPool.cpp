@@ -0,0 +1,378 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Memory/ConcurrentSlotPool.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <new>
+
+namespace CPPCore {
+
+// The tagged head keeps the slot address shifted by 4 bits in the low 44 bits, which covers the
+// 48 bit user address space of x86-64 and AArch64, and a 20 bit ABA counter above it. Batches
+// above that, e.g. with 5-level paging, go to a locked list instead.
+static const unsigned AddressShift = 4;
+static const unsigned TagShift = 44;
+static const uint64_t AddressMask = (uint64_t(1) << TagShift) - 1;
+
+static_assert(sizeof(void*) == 8, "The tagged stack head needs 64 bit pointers");
+
+// Lives in the payload of a free slot, m_count is only valid for the first slot of a batch
+struct FreeSlot {
+    FreeSlot *m_next;
+    size_t m_count;
+};
+
+// Lives in front of the payload, so a thread which pops a batch concurrently may still read the
+// link after the slot was handed out
+struct SlotHeader {
+    std::atomic<FreeSlot*> m_nextBatch;
+};
+
+namespace Details {
+
+// The free slots of one thread for one pool, owned by the thread and the pool together
+struct SlotCache {
+    FreeSlot *m_slots;
+    size_t m_numSlots;
+    uint64_t m_poolId;
+    SpinLock m_lock;
+    ConcurrentSlotPool *m_pool;
+    std::atomic<int> m_refs;
+
+    SlotCache(ConcurrentSlotPool *pool) :
+            m_slots(nullptr),
+            m_numSlots(0),
+            m_poolId(pool->m_id),
+            m_lock(),
+            m_pool(pool),
+            m_refs(2) {
+        // empty
+    }
+
+    // Gives the slots back to the pool, if it is still alive
+    void flush() {
+        std::lock_guard<SpinLock> lock(m_lock);
+        if (nullptr != m_pool && nullptr != m_slots) {
+            m_pool->pushBatch(m_slots, m_numSlots);
+        }
+        m_slots = nullptr;
+        m_numSlots = 0;
+        m_pool = nullptr;
+    }
+
+    bool isOrphan() {
+        std::lock_guard<SpinLock> lock(m_lock);
+        return nullptr == m_pool;
+    }
+
+    void releaseRef() {
+        if (1 == m_refs.fetch_sub(1, std::memory_order_acq_rel)) {
+            delete this;
+        }
+    }
+};
+
+} // Namespace Details
+
+using Details::SlotCache;
+
+// The cache of the pool this thread used last, no constructor, so the TLS access stays a load
+struct LastCache {
+    uint64_t m_poolId;
+    SlotCache *m_cache;
+    bool m_exited;
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+static thread_local LastCache t_lastCache __attribute__((tls_model("initial-exec")));
+#else
+static thread_local LastCache t_lastCache;
+#endif
+
+// All caches of the thread, flushed when the thread exits
+struct ThreadSlotCaches {
+    std::vector<SlotCache*> m_caches;
+
+    ~ThreadSlotCaches() {
+        for (size_t i = 0; i < m_caches.size(); ++i) {
+            m_caches[i]->flush();
+            m_caches[i]->releaseRef();
+        }
+        t_lastCache.m_poolId = 0;
+        t_lastCache.m_cache = nullptr;
+        t_lastCache.m_exited = true;
+    }
+};
+
+static std::atomic<uint64_t> s_nextPoolId(1);
+
+static inline size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static inline SlotHeader *getHeader(FreeSlot *slot, size_t headerSize) {
+    return reinterpret_cast<SlotHeader*>(reinterpret_cast<char*>(slot) - headerSize);
+}
+
+ConcurrentSlotPool::ConcurrentSlotPool(size_t slotSize, size_t alignment, size_t chunkSize) :
+        m_id(s_nextPoolId.fetch_add(1, std::memory_order_relaxed)),
+        m_slotSize(slotSize),
+        m_alignment(alignment < 16 ? 16 : alignment),
+        m_headerSize(alignUp(sizeof(SlotHeader), m_alignment)),
+        m_stride(m_headerSize + alignUp(slotSize < sizeof(FreeSlot) ? sizeof(FreeSlot) : slotSize, m_alignment)),
+        m_chunkSize(chunkSize < BatchSize ? BatchSize : chunkSize),
+        m_top(0),
+        m_mutex(),
+        m_chunks(),
+        m_caches(),
+        m_capacity(0),
+        m_highMutex(),
+        m_highBatches(),
+        m_numHighBatches(0) {
+    // empty
+}
+
+ConcurrentSlotPool::~ConcurrentSlotPool() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_caches.size(); ++i) {
+        {
+            std::lock_guard<SpinLock> cacheLock(m_caches[i]->m_lock);
+            m_caches[i]->m_pool = nullptr;
+            m_caches[i]->m_slots = nullptr;
+            m_caches[i]->m_numSlots = 0;
+        }
+        m_caches[i]->releaseRef();
+    }
+    for (size_t i = 0; i < m_chunks.size(); ++i) {
+        ::operator delete(m_chunks[i], std::align_val_t(m_alignment));
+    }
+}
+
+void ConcurrentSlotPool::pushBatch(void *first, size_t count) {
+    FreeSlot *slot = static_cast<FreeSlot*>(first);
+    slot->m_count = count;
+    SlotHeader *header = getHeader(slot, m_headerSize);
+    const uint64_t address = reinterpret_cast<uint64_t>(slot) >> AddressShift;
+    if (address > AddressMask) {
+        // Does not fit into the tagged head. A lock of its own, the destructor holds m_mutex while
+        // it locks the thread caches, which push batches
+        std::lock_guard<std::mutex> lock(m_highMutex);
+        m_highBatches.push_back(slot);
+        m_numHighBatches.store(m_highBatches.size(), std::memory_order_release);
+        return;
+    }
+    uint64_t top = m_top.load(std::memory_order_relaxed);
+    for (;;) {
+        FreeSlot *next = reinterpret_cast<FreeSlot*>((top & AddressMask) << AddressShift);
+        header->m_nextBatch.store(next, std::memory_order_relaxed);
+        const uint64_t tag = (top >> TagShift) + 1;
+        if (m_top.compare_exchange_weak(top, address | (tag << TagShift), std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void *ConcurrentSlotPool::popBatch(size_t &count) {
+    uint64_t top = m_top.load(std::memory_order_acquire);
+    for (;;) {
+        FreeSlot *slot = reinterpret_cast<FreeSlot*>((top & AddressMask) << AddressShift);
+        if (nullptr == slot) {
+            return popHighBatch(count);
+        }
+
+        // The slot may be handed out by now, then the header is stale and the tag has changed
+        FreeSlot *next = getHeader(slot, m_headerSize)->m_nextBatch.load(std::memory_order_relaxed);
+        const uint64_t tag = (top >> TagShift) + 1;
+        const uint64_t address = reinterpret_cast<uint64_t>(next) >> AddressShift;
+        if (m_top.compare_exchange_weak(top, address | (tag << TagShift), std::memory_order_acquire, std::memory_order_acquire)) {
+            count = slot->m_count;
+            return slot;
+        }
+    }
+}
+
+void *ConcurrentSlotPool::popHighBatch(size_t &count) {
+    if (0 == m_numHighBatches.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_highMutex);
+    if (m_highBatches.empty()) {
+        return nullptr;
+    }
+    FreeSlot *slot = static_cast<FreeSlot*>(m_highBatches.back());
+    m_highBatches.pop_back();
+    m_numHighBatches.store(m_highBatches.size(), std::memory_order_release);
+    count = slot->m_count;
+
+    return slot;
+}
+
+void ConcurrentSlotPool::grow(size_t numSlots) {
+    numSlots = alignUp(numSlots, BatchSize);
+    char *chunk = static_cast<char*>(::operator new(numSlots * m_stride, std::align_val_t(m_alignment)));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_chunks.push_back(chunk);
+    }
+
+    // Cut the chunk into batches for the shared stack
+    for (size_t i = 0; i < numSlots; i += BatchSize) {
+        FreeSlot *first = nullptr;
+        for (size_t j = BatchSize; j > 0; --j) {
+            char *memory = chunk + (i + j - 1) * m_stride;
+            new (memory) SlotHeader;
+            FreeSlot *slot = reinterpret_cast<FreeSlot*>(memory + m_headerSize);
+            slot->m_next = first;
+            first = slot;
+        }
+        pushBatch(first, BatchSize);
+    }
+    m_capacity.fetch_add(numSlots, std::memory_order_relaxed);
+}
+
+void ConcurrentSlotPool::reserve(size_t numSlots) {
+    const size_t current = capacity();
+    if (numSlots > current) {
+        grow(numSlots - current);
+    }
+}
+
+SlotCache *ConcurrentSlotPool::registerCache() {
+    static thread_local ThreadSlotCaches caches;
+
+    SlotCache *found = nullptr;
+    for (size_t i = 0; i < caches.m_caches.size();) {
+        SlotCache *cache = caches.m_caches[i];
+        if (cache->m_poolId == m_id) {
+            found = cache;
+            ++i;
+        } else if (cache->isOrphan()) {
+            // The pool is gone
+            cache->releaseRef();
+            caches.m_caches[i] = caches.m_caches.back();
+            caches.m_caches.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    if (nullptr == found) {
+        found = new SlotCache(this);
+        caches.m_caches.push_back(found);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_caches.size();) {
+            if (m_caches[i]->isOrphan()) {
+                // The thread is gone
+                m_caches[i]->releaseRef();
+                m_caches[i] = m_caches.back();
+                m_caches.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        m_caches.push_back(found);
+    }
+    t_lastCache.m_poolId = m_id;
+    t_lastCache.m_cache = found;
+
+    return found;
+}
+
+inline SlotCache *ConcurrentSlotPool::getCache() {
+    LastCache &last = t_lastCache;
+    if (last.m_poolId == m_id) {
+        return last.m_cache;
+    }
+    if (last.m_exited) {
+        return nullptr;
+    }
+
+    return registerCache();
+}
+
+void *ConcurrentSlotPool::refill(SlotCache &cache) {
+    size_t count = 0;
+    void *batch = popBatch(count);
+    while (nullptr == batch) {
+        grow(m_chunkSize);
+        batch = popBatch(count);
+    }
+    cache.m_slots = static_cast<FreeSlot*>(batch);
+    cache.m_numSlots = count;
+
+    return batch;
+}
+
+void *ConcurrentSlotPool::allocate() {
+    SlotCache *cache = getCache();
+    if (nullptr == cache) {
+        // The thread is exiting, take one slot and give the rest of the batch back
+        SlotCache exiting(this);
+        FreeSlot *slot = static_cast<FreeSlot*>(refill(exiting));
+        if (nullptr != slot->m_next) {
+            pushBatch(slot->m_next, exiting.m_numSlots - 1);
+        }
+        return slot;
+    }
+
+    FreeSlot *slot = cache->m_slots;
+    if (nullptr == slot) {
+        slot = static_cast<FreeSlot*>(refill(*cache));
+    }
+    cache->m_slots = slot->m_next;
+    --cache->m_numSlots;
+
+    return slot;
+}
+
+void ConcurrentSlotPool::deallocate(void *ptr) {
+    if (nullptr == ptr) {
+        return;
+    }
+
+    FreeSlot *slot = static_cast<FreeSlot*>(ptr);
+    SlotCache *cache = getCache();
+    if (nullptr == cache) {
+        slot->m_next = nullptr;
+        pushBatch(slot, 1);
+        return;
+    }
+
+    slot->m_next = cache->m_slots;
+    cache->m_slots = slot;
+    if (++cache->m_numSlots > MaxCached) {
+        // Keep the most recently freed slots, they are still warm
+        const size_t numKept = MaxCached - BatchSize;
+        FreeSlot *last = slot;
+        for (size_t i = 1; i < numKept; ++i) {
+            last = last->m_next;
+        }
+        FreeSlot *batch = last->m_next;
+        last->m_next = nullptr;
+        pushBatch(batch, cache->m_numSlots - numKept);
+        cache->m_numSlots = numKept;
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,220 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Memory/ThreadCacheAllocator.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace CPPCore {
+
+static const size_t NumClasses = ThreadCacheAllocator::MaxCachedSize / ThreadCacheAllocator::Granularity;
+
+// Keep at most this many batches per class in the depot, the rest goes back to the heap
+static const size_t MaxDepotBatches = 1024;
+
+struct FreeBlock {
+    FreeBlock *m_next;
+};
+
+// The batches of one size class, each one is a list of BatchSize blocks
+struct alignas(CacheLineSize) DepotClass {
+    SpinLock m_lock;
+    std::vector<FreeBlock*> m_batches;
+};
+
+static DepotClass *getDepot() {
+    // Leaked on purpose, threads may exit after the static destructors ran
+    static DepotClass *depot = new DepotClass[NumClasses];
+    return depot;
+}
+
+// Plain data, so the fast path does not go through the TLS init wrapper
+struct BlockCache {
+    FreeBlock *m_freeLists[NumClasses];
+    uint32_t m_numFree[NumClasses];
+    ThreadCacheAllocator::Stats m_stats;
+    bool m_registered;
+    bool m_exited;
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+static thread_local BlockCache t_cache __attribute__((tls_model("initial-exec")));
+#else
+static thread_local BlockCache t_cache;
+#endif
+
+static inline size_t getClass(size_t size) {
+    return (size + ThreadCacheAllocator::Granularity - 1) / ThreadCacheAllocator::Granularity - 1;
+}
+
+static inline size_t getClassSize(size_t sizeClass) {
+    return (sizeClass + 1) * ThreadCacheAllocator::Granularity;
+}
+
+static void *allocateBlock(size_t sizeClass) {
+    return ::operator new(getClassSize(sizeClass), std::align_val_t(ThreadCacheAllocator::Granularity));
+}
+
+static void freeBlock(void *ptr) {
+    ::operator delete(ptr, std::align_val_t(ThreadCacheAllocator::Granularity));
+}
+
+// Moves the first count blocks of the thread's list to the depot
+static void pushBatch(BlockCache &cache, size_t sizeClass, size_t count) {
+    FreeBlock *first = cache.m_freeLists[sizeClass];
+    FreeBlock *last = first;
+    for (size_t i = 1; i < count; ++i) {
+        last = last->m_next;
+    }
+    cache.m_freeLists[sizeClass] = last->m_next;
+    cache.m_numFree[sizeClass] -= static_cast<uint32_t>(count);
+    last->m_next = nullptr;
+
+    DepotClass &depot = getDepot()[sizeClass];
+    {
+        std::lock_guard<SpinLock> lock(depot.m_lock);
+        if (depot.m_batches.size() < MaxDepotBatches) {
+            depot.m_batches.push_back(first);
+            first = nullptr;
+        }
+    }
+    while (nullptr != first) {
+        FreeBlock *next = first->m_next;
+        freeBlock(first);
+        first = next;
+    }
+}
+
+static bool popBatch(BlockCache &cache, size_t sizeClass) {
+    DepotClass &depot = getDepot()[sizeClass];
+    FreeBlock *batch = nullptr;
+    {
+        std::lock_guard<SpinLock> lock(depot.m_lock);
+        if (depot.m_batches.empty()) {
+            return false;
+        }
+        batch = depot.m_batches.back();
+        depot.m_batches.pop_back();
+    }
+
+    // The thread's list is empty here
+    cache.m_freeLists[sizeClass] = batch;
+    cache.m_numFree[sizeClass] = static_cast<uint32_t>(ThreadCacheAllocator::BatchSize);
+
+    return true;
+}
+
+// Hands the cached blocks to the depot when the thread exits
+struct BlockCacheReleaser {
+    ~BlockCacheReleaser() {
+        BlockCache &cache = t_cache;
+        for (size_t i = 0; i < NumClasses; ++i) {
+            while (cache.m_numFree[i] >= ThreadCacheAllocator::BatchSize) {
+                pushBatch(cache, i, ThreadCacheAllocator::BatchSize);
+            }
+            while (nullptr != cache.m_freeLists[i]) {
+                FreeBlock *block = cache.m_freeLists[i];
+                cache.m_freeLists[i] = block->m_next;
+                freeBlock(block);
+            }
+            cache.m_numFree[i] = 0;
+        }
+        cache.m_registered = false;
+        cache.m_exited = true;
+    }
+};
+
+// Returns false for a thread which is exiting, its blocks go to the heap then
+static bool registerCache(BlockCache &cache) {
+    if (cache.m_exited) {
+        return false;
+    }
+    static thread_local BlockCacheReleaser releaser;
+    (void) releaser;
+    cache.m_registered = true;
+
+    return true;
+}
+
+void *ThreadCacheAllocator::allocate(size_t size) {
+    BlockCache &cache = t_cache;
+    ++cache.m_stats.m_numAllocations;
+    if (0 == size || size > MaxCachedSize) {
+        ++cache.m_stats.m_numHeapAllocations;
+        return ::operator new(size, std::align_val_t(Granularity));
+    }
+
+    const size_t sizeClass = getClass(size);
+    FreeBlock *block = cache.m_freeLists[sizeClass];
+    if (nullptr == block) {
+        if ((!cache.m_registered && !registerCache(cache)) || !popBatch(cache, sizeClass)) {
+            ++cache.m_stats.m_numHeapAllocations;
+            return allocateBlock(sizeClass);
+        }
+        ++cache.m_stats.m_numDepotTransfers;
+        block = cache.m_freeLists[sizeClass];
+    }
+    cache.m_freeLists[sizeClass] = block->m_next;
+    --cache.m_numFree[sizeClass];
+
+    return block;
+}
+
+void ThreadCacheAllocator::deallocate(void *ptr, size_t size) {
+    if (nullptr == ptr) {
+        return;
+    }
+    if (0 == size || size > MaxCachedSize) {
+        ::operator delete(ptr, std::align_val_t(Granularity));
+        return;
+    }
+
+    BlockCache &cache = t_cache;
+    if (!cache.m_registered && !registerCache(cache)) {
+        freeBlock(ptr);
+        return;
+    }
+
+    const size_t sizeClass = getClass(size);
+    FreeBlock *block = static_cast<FreeBlock*>(ptr);
+    block->m_next = cache.m_freeLists[sizeClass];
+    cache.m_freeLists[sizeClass] = block;
+    if (++cache.m_numFree[sizeClass] > MaxCachedPerClass) {
+        pushBatch(cache, sizeClass, BatchSize);
+        ++cache.m_stats.m_numDepotTransfers;
+    }
+}
+
+ThreadCacheAllocator::Stats ThreadCacheAllocator::getThreadStats() {
+    return t_cache.m_stats;
+}
+
+void ThreadCacheAllocator::resetThreadStats() {
+    t_cache.m_stats.m_numAllocations = 0;
+    t_cache.m_stats.m_numHeapAllocations = 0;
+    t_cache.m_stats.m_numDepotTransfers = 0;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,249 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Parallel/Pipeline.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace CPPCore {
+
+namespace Details {
+
+PipelineChannelBase::PipelineChannelBase() :
+        m_closed(false),
+        m_notEmpty(),
+        m_notFull() {
+    // empty
+}
+
+PipelineChannelBase::~PipelineChannelBase() {
+    // empty
+}
+
+void PipelineChannelBase::close() {
+    m_closed.store(true, std::memory_order_release);
+    m_notEmpty.notifyAll();
+}
+
+void PipelineChannelBase::wakeAll() {
+    m_notEmpty.notifyAll();
+    m_notFull.notifyAll();
+}
+
+PipelineStageBase::PipelineStageBase(Pipeline &pipeline, const char *name, size_t parallelism,
+        PipelineChannelBase *input, PipelineChannelBase *output) :
+        m_cancelled(pipeline.m_cancelled),
+        m_window(pipeline.m_window),
+        m_name(nullptr == name ? "" : name),
+        m_parallelism(0 == parallelism ? 1 : parallelism),
+        m_input(input),
+        m_output(output),
+        m_numRunning(m_parallelism),
+        m_numItems(0),
+        m_numBatches(0),
+        m_busyNs(0),
+        m_queueSum(0),
+        m_queueSamples(0),
+        m_maxQueueSize(0) {
+    // empty
+}
+
+PipelineStageBase::~PipelineStageBase() {
+    // empty
+}
+
+void PipelineStageBase::workerDone() {
+    if (1 == m_numRunning.fetch_sub(1, std::memory_order_acq_rel) && nullptr != m_output) {
+        m_output->close();
+    }
+}
+
+size_t PipelineStageBase::getParallelism() const {
+    return m_parallelism;
+}
+
+void PipelineStageBase::getStats(PipelineStageStats &stats, double seconds) const {
+    stats.m_name = m_name;
+    stats.m_parallelism = m_parallelism;
+    stats.m_numItems = m_numItems.load(std::memory_order_relaxed);
+    stats.m_numBatches = m_numBatches.load(std::memory_order_relaxed);
+    stats.m_busyNs = m_busyNs.load(std::memory_order_relaxed);
+    stats.m_itemsPerSecond = 0.0 < seconds ? static_cast<double>(stats.m_numItems) / seconds : 0.0;
+    stats.m_queueCapacity = nullptr != m_input ? m_input->capacity() : 0;
+    const uint64_t samples = m_queueSamples.load(std::memory_order_relaxed);
+    stats.m_avgQueueSize = 0 != samples ?
+            static_cast<double>(m_queueSum.load(std::memory_order_relaxed)) / static_cast<double>(samples) : 0.0;
+    stats.m_maxQueueSize = m_maxQueueSize.load(std::memory_order_relaxed);
+}
+
+uint64_t PipelineStageBase::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void PipelineStageBase::sampleQueue() {
+    const size_t size = m_input->size();
+    m_queueSum.fetch_add(size, std::memory_order_relaxed);
+    m_queueSamples.fetch_add(1, std::memory_order_relaxed);
+    if (size > m_maxQueueSize.load(std::memory_order_relaxed)) {
+        m_maxQueueSize.store(size, std::memory_order_relaxed);
+    }
+}
+
+void PipelineStageBase::record(size_t numItems, uint64_t busyNs) {
+    m_numItems.fetch_add(numItems, std::memory_order_relaxed);
+    m_numBatches.fetch_add(1, std::memory_order_relaxed);
+    m_busyNs.fetch_add(busyNs, std::memory_order_relaxed);
+}
+
+} // Namespace Details
+
+Pipeline::Pipeline(const PipelineOptions &options) :
+        m_options(options),
+        m_channels(),
+        m_stages(),
+        m_threads(),
+        m_cancelled(false),
+        m_window(),
+        m_errorMutex(),
+        m_error(),
+        m_startNs(0),
+        m_endNs(0) {
+    if (0 == m_options.m_queueCapacity) {
+        m_options.m_queueCapacity = 1;
+    }
+    if (0 == m_options.m_batchSize) {
+        m_options.m_batchSize = 1;
+    }
+}
+
+Pipeline::~Pipeline() {
+    if (!m_threads.empty()) {
+        cancel();
+        try {
+            wait();
+        } catch (...) {
+            // The error is lost, nobody waited for the pipeline
+        }
+    }
+}
+
+void Pipeline::addStage(Details::PipelineStageBase *stage) {
+    m_stages.push_back(std::unique_ptr<Details::PipelineStageBase>(stage));
+}
+
+void Pipeline::start() {
+    if (!m_threads.empty()) {
+        return;
+    }
+
+    m_startNs = Details::PipelineStageBase::now();
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        Details::PipelineStageBase *stage = m_stages[i].get();
+        for (size_t j = 0; j < stage->getParallelism(); ++j) {
+            m_threads.push_back(std::thread([this, stage]() {
+                try {
+                    stage->runWorker();
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+                stage->workerDone();
+            }));
+        }
+    }
+}
+
+void Pipeline::wait() {
+    for (size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i].join();
+    }
+    if (!m_threads.empty()) {
+        m_endNs.store(Details::PipelineStageBase::now(), std::memory_order_relaxed);
+    }
+    m_threads.clear();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void Pipeline::cancel() {
+    m_cancelled.store(true, std::memory_order_seq_cst);
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        m_channels[i]->wakeAll();
+    }
+    m_window.wakeAll();
+}
+
+void Pipeline::fail(std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (!m_error) {
+            m_error = error;
+        }
+    }
+    cancel();
+}
+
+void Pipeline::getStats(std::vector<PipelineStageStats> &stats) const {
+    uint64_t end = m_endNs.load(std::memory_order_relaxed);
+    if (0 == end) {
+        end = Details::PipelineStageBase::now();
+    }
+    const double seconds = 0 != m_startNs ? static_cast<double>(end - m_startNs) / 1e9 : 0.0;
+
+    stats.resize(m_stages.size());
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        m_stages[i]->getStats(stats[i], seconds);
+    }
+}
+
+void Pipeline::report(std::string &report) const {
+    std::vector<PipelineStageStats> stats;
+    getStats(stats);
+
+    char line[256];
+    report.clear();
+    ::snprintf(line, sizeof(line), "%-16s %8s %12s %14s %8s %10s %8s\n",
+            "stage", "threads", "items", "items/s", "busy%", "avg queue", "max");
+    report += line;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const PipelineStageStats &stage = stats[i];
+        const double seconds = 0.0 < stage.m_itemsPerSecond ?
+                static_cast<double>(stage.m_numItems) / stage.m_itemsPerSecond : 0.0;
+        const double busy = 0.0 < seconds ?
+                100.0 * static_cast<double>(stage.m_busyNs) / 1e9 / seconds / static_cast<double>(stage.m_parallelism) : 0.0;
+        ::snprintf(line, sizeof(line), "%-16s %8zu %12llu %14.0f %8.1f %6.1f/%-3zu %8zu\n",
+                stage.m_name.c_str(), stage.m_parallelism, static_cast<unsigned long long>(stage.m_numItems),
+                stage.m_itemsPerSecond, busy, stage.m_avgQueueSize, stage.m_queueCapacity, stage.m_maxQueueSize);
+        report += line;
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,227 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Platform/CpuFeatures.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <immintrin.h>
+#   include <intrin.h>
+#   define CPPCORE_CPUID_X86
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <cpuid.h>
+#   define CPPCORE_CPUID_X86
+#endif
+
+namespace CPPCore {
+
+struct CpuInfo {
+    uint32_t m_features;
+    IsaLevel m_detectedLevel;
+    IsaLevel m_level;
+    char m_brand[49];
+};
+
+static inline uint32_t getBit(CpuFeature feature) {
+    return 1u << static_cast<uint32_t>(feature);
+}
+
+#ifdef CPPCORE_CPUID_X86
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#ifdef _MSC_VER
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<uint32_t>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// The register state the operating system saves on a context switch
+static uint64_t xgetbv() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+static void detect(CpuInfo &info) {
+    uint32_t regs[4] = {};
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return;
+    }
+
+    cpuid(1, 0, regs);
+    const uint32_t ecx1 = regs[2];
+    const uint32_t edx1 = regs[3];
+    uint32_t features = 0;
+    features |= (edx1 & (1u << 26)) ? getBit(CpuFeature::Sse2) : 0;
+    features |= (ecx1 & (1u << 0)) ? getBit(CpuFeature::Sse3) : 0;
+    features |= (ecx1 & (1u << 9)) ? getBit(CpuFeature::Ssse3) : 0;
+    features |= (ecx1 & (1u << 19)) ? getBit(CpuFeature::Sse41) : 0;
+    features |= (ecx1 & (1u << 20)) ? getBit(CpuFeature::Sse42) : 0;
+    features |= (ecx1 & (1u << 23)) ? getBit(CpuFeature::Popcnt) : 0;
+
+    // AVX needs the OS to save the YMM state, AVX-512 also the opmask and ZMM state
+    const bool osxsave = 0 != (ecx1 & (1u << 27));
+    const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+    const bool avxState = 0x6 == (xcr0 & 0x6);
+    const bool avx512State = 0xe6 == (xcr0 & 0xe6);
+    if (avxState) {
+        features |= (ecx1 & (1u << 28)) ? getBit(CpuFeature::Avx) : 0;
+        features |= (ecx1 & (1u << 12)) ? getBit(CpuFeature::Fma) : 0;
+    }
+
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        const uint32_t ebx7 = regs[1];
+        features |= (ebx7 & (1u << 3)) ? getBit(CpuFeature::Bmi1) : 0;
+        features |= (ebx7 & (1u << 8)) ? getBit(CpuFeature::Bmi2) : 0;
+        if (avxState) {
+            features |= (ebx7 & (1u << 5)) ? getBit(CpuFeature::Avx2) : 0;
+        }
+        if (avx512State) {
+            features |= (ebx7 & (1u << 16)) ? getBit(CpuFeature::Avx512F) : 0;
+            features |= (ebx7 & (1u << 17)) ? getBit(CpuFeature::Avx512Dq) : 0;
+            features |= (ebx7 & (1u << 30)) ? getBit(CpuFeature::Avx512Bw) : 0;
+            features |= (ebx7 & (1u << 31)) ? getBit(CpuFeature::Avx512Vl) : 0;
+        }
+    }
+    info.m_features = features;
+
+    cpuid(0x80000000u, 0, regs);
+    if (regs[0] >= 0x80000004u) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            cpuid(0x80000002u + i, 0, regs);
+            ::memcpy(info.m_brand + i * 16, regs, 16);
+        }
+        info.m_brand[48] = 0;
+    }
+}
+
+#else
+
+static void detect(CpuInfo &info) {
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    info.m_features = getBit(CpuFeature::Neon);
+#else
+    (void) info;
+#endif
+}
+
+#endif // CPPCORE_CPUID_X86
+
+static IsaLevel getHighestLevel(uint32_t features) {
+    const uint32_t sse42 = getBit(CpuFeature::Ssse3) | getBit(CpuFeature::Sse41) | getBit(CpuFeature::Sse42) |
+                           getBit(CpuFeature::Popcnt);
+    const uint32_t avx2 = sse42 | getBit(CpuFeature::Avx) | getBit(CpuFeature::Avx2) | getBit(CpuFeature::Fma) |
+                          getBit(CpuFeature::Bmi1) | getBit(CpuFeature::Bmi2);
+    const uint32_t avx512 = avx2 | getBit(CpuFeature::Avx512F) | getBit(CpuFeature::Avx512Dq) |
+                            getBit(CpuFeature::Avx512Bw) | getBit(CpuFeature::Avx512Vl);
+    if (avx512 == (features & avx512)) {
+        return IsaLevel::Avx512;
+    }
+    if (avx2 == (features & avx2)) {
+        return IsaLevel::Avx2;
+    }
+    if (sse42 == (features & sse42)) {
+        return IsaLevel::Sse42;
+    }
+    return IsaLevel::Generic;
+}
+
+static const CpuInfo &getInfo() {
+    static const CpuInfo info = []() {
+        CpuInfo result = {};
+        detect(result);
+        result.m_detectedLevel = getHighestLevel(result.m_features);
+        result.m_level = result.m_detectedLevel;
+
+        IsaLevel requested = IsaLevel::Generic;
+        const char *name = ::getenv("CPPCORE_ISA");
+        if (nullptr != name && CpuFeatures::parseLevel(name, requested) && requested < result.m_level) {
+            result.m_level = requested;
+        }
+        return result;
+    }();
+    return info;
+}
+
+// Detect at load time, so the first dispatched call does not pay for it
+static const CpuInfo &s_info = getInfo();
+
+bool CpuFeatures::has(CpuFeature feature) {
+    return 0 != (getInfo().m_features & getBit(feature));
+}
+
+uint32_t CpuFeatures::getFeatureMask() {
+    return getInfo().m_features;
+}
+
+IsaLevel CpuFeatures::getDetectedLevel() {
+    return getInfo().m_detectedLevel;
+}
+
+IsaLevel CpuFeatures::getLevel() {
+    return getInfo().m_level;
+}
+
+const char *CpuFeatures::getLevelName(IsaLevel level) {
+    static const char *Names[] = { "generic", "sse42", "avx2", "avx512" };
+    const size_t index = static_cast<size_t>(level);
+    return index < CPPCORE_ARRAY_SIZE(Names) ? Names[index] : "unknown";
+}
+
+bool CpuFeatures::parseLevel(const char *name, IsaLevel &level) {
+    if (nullptr == name) {
+        return false;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(IsaLevel::NumLevels); ++i) {
+        const char *candidate = getLevelName(static_cast<IsaLevel>(i));
+        size_t pos = 0;
+        while (0 != candidate[pos] && candidate[pos] == (name[pos] | 0x20)) {
+            ++pos;
+        }
+        if (0 == candidate[pos] && 0 == name[pos]) {
+            level = static_cast<IsaLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *CpuFeatures::getBrand() {
+    return getInfo().m_brand;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,84 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Platform/VectorKernels.h>
+#include <cppcore/Platform/TCpuDispatch.h>
+
+namespace CPPCore {
+namespace Details {
+
+namespace IsaGeneric {
+    extern const VectorKernels::Table Kernels;
+}
+
+// The variants only exist when the build compiled VectorKernelsIsa.cpp for them
+#ifdef CPPCORE_HAS_ISA_VARIANTS
+namespace IsaSse42 {
+    extern const VectorKernels::Table Kernels;
+}
+
+namespace IsaAvx2 {
+    extern const VectorKernels::Table Kernels;
+}
+
+namespace IsaAvx512 {
+    extern const VectorKernels::Table Kernels;
+}
+#endif
+
+static const TCpuDispatch<VectorKernels::Table> &getDispatch() {
+#ifdef CPPCORE_HAS_ISA_VARIANTS
+    static const TCpuDispatch<VectorKernels::Table> dispatch(&IsaGeneric::Kernels, &IsaSse42::Kernels,
+            &IsaAvx2::Kernels, &IsaAvx512::Kernels);
+#else
+    static const TCpuDispatch<VectorKernels::Table> dispatch(&IsaGeneric::Kernels);
+#endif
+    return dispatch;
+}
+
+} // Namespace Details
+
+float VectorKernels::sum(const float *values, size_t count) {
+    return Details::getDispatch().get().m_sum(values, count);
+}
+
+float VectorKernels::dot(const float *a, const float *b, size_t count) {
+    return Details::getDispatch().get().m_dot(a, b, count);
+}
+
+size_t VectorKernels::countByte(const uint8_t *data, size_t size, uint8_t value) {
+    return Details::getDispatch().get().m_countByte(data, size, value);
+}
+
+void VectorKernels::minMax(const float *values, size_t count, float &min, float &max) {
+    Details::getDispatch().get().m_minMax(values, count, &min, &max);
+}
+
+IsaLevel VectorKernels::getLevel() {
+    return Details::getDispatch().getLevel();
+}
+
+const VectorKernels::Table &VectorKernels::getTable(IsaLevel level) {
+    return Details::getDispatch().resolve(level);
+}
+
+} // Namespace CPPCore
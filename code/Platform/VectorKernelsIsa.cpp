@@ -0,0 +1,152 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+// The bodies of the vector kernels. This file is compiled once as is for the generic level and
+// once per instruction set level by cppcore_add_isa_variants, which defines CPPCORE_ISA_<LEVEL>.
+// Do not call inline or template functions from headers here: every variant emits its own weak
+// copy, built for its instruction set, and the linker may pick the AVX-512 one for all callers.
+#include <cppcore/Platform/VectorKernels.h>
+
+#include <limits>
+
+#if defined(CPPCORE_ISA_AVX512)
+#   define CPPCORE_ISA_NAMESPACE IsaAvx512
+#elif defined(CPPCORE_ISA_AVX2)
+#   define CPPCORE_ISA_NAMESPACE IsaAvx2
+#elif defined(CPPCORE_ISA_SSE42)
+#   define CPPCORE_ISA_NAMESPACE IsaSse42
+#else
+#   define CPPCORE_ISA_NAMESPACE IsaGeneric
+#endif
+
+namespace CPPCore {
+namespace Details {
+namespace CPPCORE_ISA_NAMESPACE {
+
+// Independent partial sums in fixed lanes, so the compiler vectorizes the loops without reordering
+// the additions and every level gets the same result
+static constexpr size_t NumLanes = 32;
+
+// Constant evaluated, so no out-of-line numeric_limits<float>::infinity() is emitted
+static constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+static float reduceLanes(const float *lanes) {
+    float result = 0.0f;
+    for (size_t i = 0; i < NumLanes; ++i) {
+        result += lanes[i];
+    }
+    return result;
+}
+
+static float sum(const float *values, size_t count) {
+    float lanes[NumLanes] = {};
+    size_t i = 0;
+    for (; i + NumLanes <= count; i += NumLanes) {
+        for (size_t j = 0; j < NumLanes; ++j) {
+            lanes[j] += values[i + j];
+        }
+    }
+    for (size_t j = 0; i < count; ++i, ++j) {
+        lanes[j] += values[i];
+    }
+    return reduceLanes(lanes);
+}
+
+static float dot(const float *a, const float *b, size_t count) {
+    float lanes[NumLanes] = {};
+    size_t i = 0;
+    for (; i + NumLanes <= count; i += NumLanes) {
+        for (size_t j = 0; j < NumLanes; ++j) {
+            lanes[j] += a[i + j] * b[i + j];
+        }
+    }
+    for (size_t j = 0; i < count; ++i, ++j) {
+        lanes[j] += a[i] * b[i];
+    }
+    return reduceLanes(lanes);
+}
+
+static size_t countByte(const uint8_t *data, size_t size, uint8_t value) {
+    static constexpr size_t BlockSize = 64;
+    size_t result = 0;
+    size_t i = 0;
+    while (size - i >= BlockSize) {
+        // Byte counters overflow after 255 blocks
+        uint8_t counters[BlockSize] = {};
+        size_t numBlocks = (size - i) / BlockSize;
+        if (numBlocks > 255) {
+            numBlocks = 255;
+        }
+        for (size_t block = 0; block < numBlocks; ++block, i += BlockSize) {
+            for (size_t j = 0; j < BlockSize; ++j) {
+                counters[j] += static_cast<uint8_t>(data[i + j] == value);
+            }
+        }
+        for (size_t j = 0; j < BlockSize; ++j) {
+            result += counters[j];
+        }
+    }
+    for (; i < size; ++i) {
+        result += data[i] == value ? 1 : 0;
+    }
+    return result;
+}
+
+// The selects map to minps / maxps, so the lanes vectorize without fast-math
+static void minMax(const float *values, size_t count, float *min, float *max) {
+    float minLanes[NumLanes];
+    float maxLanes[NumLanes];
+    for (size_t j = 0; j < NumLanes; ++j) {
+        minLanes[j] = Infinity;
+        maxLanes[j] = -Infinity;
+    }
+    size_t i = 0;
+    for (; i + NumLanes <= count; i += NumLanes) {
+        for (size_t j = 0; j < NumLanes; ++j) {
+            minLanes[j] = values[i + j] < minLanes[j] ? values[i + j] : minLanes[j];
+            maxLanes[j] = values[i + j] > maxLanes[j] ? values[i + j] : maxLanes[j];
+        }
+    }
+    for (size_t j = 0; i < count; ++i, ++j) {
+        minLanes[j] = values[i] < minLanes[j] ? values[i] : minLanes[j];
+        maxLanes[j] = values[i] > maxLanes[j] ? values[i] : maxLanes[j];
+    }
+    *min = minLanes[0];
+    *max = maxLanes[0];
+    for (size_t j = 1; j < NumLanes; ++j) {
+        *min = minLanes[j] < *min ? minLanes[j] : *min;
+        *max = maxLanes[j] > *max ? maxLanes[j] : *max;
+    }
+}
+
+extern const VectorKernels::Table Kernels;
+
+const VectorKernels::Table Kernels = {
+    &sum,
+    &dot,
+    &countByte,
+    &minMax
+};
+
+} // Namespace CPPCORE_ISA_NAMESPACE
+} // Namespace Details
+} // Namespace CPPCore
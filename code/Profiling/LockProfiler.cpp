@@ -0,0 +1,379 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/LockProfiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace CPPCore {
+
+namespace {
+
+static constexpr size_t NumBuckets = LockSiteStats::NumBuckets;
+static constexpr size_t SitesPerPage = 64;
+static constexpr size_t NumPages = LockProfiler::MaxSites / SitesPerPage;
+static constexpr size_t MaxSharedHolds = 16;
+
+// The counters of one site, only written by the owning thread, so no read-modify-write is needed.
+struct SiteCounters {
+    std::atomic<uint64_t> m_acquisitions;
+    std::atomic<uint64_t> m_contended;
+    std::atomic<uint64_t> m_totalWaitNs;
+    std::atomic<uint64_t> m_maxWaitNs;
+    std::atomic<uint64_t> m_totalHoldNs;
+    std::atomic<uint64_t> m_maxHoldNs;
+    std::atomic<uint64_t> m_waitHistogram[NumBuckets];
+    std::atomic<uint64_t> m_holdHistogram[NumBuckets];
+
+    SiteCounters() {
+        clear();
+    }
+
+    void clear() {
+        m_acquisitions.store(0, std::memory_order_relaxed);
+        m_contended.store(0, std::memory_order_relaxed);
+        m_totalWaitNs.store(0, std::memory_order_relaxed);
+        m_maxWaitNs.store(0, std::memory_order_relaxed);
+        m_totalHoldNs.store(0, std::memory_order_relaxed);
+        m_maxHoldNs.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < NumBuckets; ++i) {
+            m_waitHistogram[i].store(0, std::memory_order_relaxed);
+            m_holdHistogram[i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+inline void addTo(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void maxTo(std::atomic<uint64_t> &counter, uint64_t value) {
+    if (value > counter.load(std::memory_order_relaxed)) {
+        counter.store(value, std::memory_order_relaxed);
+    }
+}
+
+void accumulate(LockSiteStats &stats, const SiteCounters &counters) {
+    stats.m_acquisitions += counters.m_acquisitions.load(std::memory_order_relaxed);
+    stats.m_contended += counters.m_contended.load(std::memory_order_relaxed);
+    stats.m_totalWaitNs += counters.m_totalWaitNs.load(std::memory_order_relaxed);
+    stats.m_maxWaitNs = std::max(stats.m_maxWaitNs, static_cast<uint64_t>(counters.m_maxWaitNs.load(std::memory_order_relaxed)));
+    stats.m_totalHoldNs += counters.m_totalHoldNs.load(std::memory_order_relaxed);
+    stats.m_maxHoldNs = std::max(stats.m_maxHoldNs, static_cast<uint64_t>(counters.m_maxHoldNs.load(std::memory_order_relaxed)));
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        stats.m_waitHistogram[i] += counters.m_waitHistogram[i].load(std::memory_order_relaxed);
+        stats.m_holdHistogram[i] += counters.m_holdHistogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+struct SharedHold {
+    const void *m_lock;
+    const LockSite *m_site;
+    uint64_t m_acquiredAt;
+};
+
+struct ThreadBuffer;
+
+// The global registry, intentionally leaked: detached threads may still record during shutdown.
+struct Registry {
+    std::mutex m_mutex;
+    std::vector<const LockSite *> m_sites;
+    std::vector<ThreadBuffer *> m_buffers;
+    std::vector<LockSiteStats> m_retired;
+};
+
+Registry &registry() {
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+struct ThreadBuffer {
+    std::atomic<SiteCounters *> m_pages[NumPages];
+    SharedHold m_sharedHolds[MaxSharedHolds];
+    size_t m_numSharedHolds;
+
+    ThreadBuffer() :
+            m_numSharedHolds(0) {
+        for (size_t i = 0; i < NumPages; ++i) {
+            m_pages[i].store(nullptr, std::memory_order_relaxed);
+        }
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> guard(reg.m_mutex);
+        reg.m_buffers.push_back(this);
+    }
+
+    ~ThreadBuffer() {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> guard(reg.m_mutex);
+        reg.m_buffers.erase(std::remove(reg.m_buffers.begin(), reg.m_buffers.end(), this), reg.m_buffers.end());
+        reg.m_retired.resize(reg.m_sites.size());
+        for (size_t page = 0; page < NumPages; ++page) {
+            SiteCounters *counters = m_pages[page].load(std::memory_order_relaxed);
+            if (nullptr == counters) {
+                continue;
+            }
+            for (size_t i = 0; i < SitesPerPage && page * SitesPerPage + i < reg.m_retired.size(); ++i) {
+                accumulate(reg.m_retired[page * SitesPerPage + i], counters[i]);
+            }
+            delete[] counters;
+        }
+    }
+
+    SiteCounters *get(size_t id) {
+        if (id >= LockProfiler::MaxSites) {
+            return nullptr;
+        }
+
+        std::atomic<SiteCounters *> &page = m_pages[id / SitesPerPage];
+        SiteCounters *counters = page.load(std::memory_order_relaxed);
+        if (nullptr == counters) {
+            counters = new SiteCounters[SitesPerPage];
+            page.store(counters, std::memory_order_release);
+        }
+
+        return &counters[id % SitesPerPage];
+    }
+};
+
+ThreadBuffer &threadBuffer() {
+    static thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+std::string formatNs(uint64_t ns) {
+    char buffer[32];
+    if (ns >= 1000000000ull) {
+        ::snprintf(buffer, sizeof(buffer), "%.2fs", static_cast<double>(ns) / 1e9);
+    } else if (ns >= 1000000ull) {
+        ::snprintf(buffer, sizeof(buffer), "%.2fms", static_cast<double>(ns) / 1e6);
+    } else if (ns >= 1000ull) {
+        ::snprintf(buffer, sizeof(buffer), "%.2fus", static_cast<double>(ns) / 1e3);
+    } else {
+        ::snprintf(buffer, sizeof(buffer), "%uns", static_cast<unsigned int>(ns));
+    }
+
+    return buffer;
+}
+
+// Measures the tick rate of LockProfiler::now() against the steady clock.
+double calibrate() {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+    const uint64_t startTicks = LockProfiler::now();
+    while (Clock::now() - start < std::chrono::milliseconds(2)) {
+        // spin
+    }
+    const uint64_t ticks = LockProfiler::now() - startTicks;
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+    return 0 == ticks ? 1.0 : ns / static_cast<double>(ticks);
+}
+
+// Every record goes through a lock site, constructing the first one runs the calibration, so it
+// never happens on the lock path while a lock is held.
+double nsPerTick() {
+    static const double value = calibrate();
+    return value;
+}
+
+} // namespace
+
+LockSite::LockSite(const char *name, const char *file, int line) :
+        m_name(name),
+        m_file(file),
+        m_line(line),
+        m_id(0) {
+    nsPerTick();
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.m_mutex);
+    m_id = reg.m_sites.size();
+    reg.m_sites.push_back(this);
+}
+
+LockSiteStats::LockSiteStats() :
+        m_site(nullptr),
+        m_acquisitions(0),
+        m_contended(0),
+        m_totalWaitNs(0),
+        m_maxWaitNs(0),
+        m_totalHoldNs(0),
+        m_maxHoldNs(0) {
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        m_waitHistogram[i] = 0;
+        m_holdHistogram[i] = 0;
+    }
+}
+
+const LockSite &LockProfiler::unknownSite() {
+    static const LockSite site("<unknown>", "", 0);
+    return site;
+}
+
+uint64_t LockProfiler::toNanoseconds(uint64_t ticks) {
+    return static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick());
+}
+
+void LockProfiler::recordAcquire(const LockSite &site, bool contended, uint64_t waitTicks) {
+    SiteCounters *counters = threadBuffer().get(site.getId());
+    if (nullptr == counters) {
+        return;
+    }
+
+    addTo(counters->m_acquisitions, 1);
+    if (contended) {
+        const uint64_t waitNs = toNanoseconds(waitTicks);
+        addTo(counters->m_contended, 1);
+        addTo(counters->m_totalWaitNs, waitNs);
+        maxTo(counters->m_maxWaitNs, waitNs);
+        addTo(counters->m_waitHistogram[bucketIndex(waitNs)], 1);
+    }
+}
+
+void LockProfiler::recordRelease(const LockSite &site, uint64_t holdTicks) {
+    SiteCounters *counters = threadBuffer().get(site.getId());
+    if (nullptr == counters) {
+        return;
+    }
+
+    const uint64_t holdNs = toNanoseconds(holdTicks);
+    addTo(counters->m_totalHoldNs, holdNs);
+    maxTo(counters->m_maxHoldNs, holdNs);
+    addTo(counters->m_holdHistogram[bucketIndex(holdNs)], 1);
+}
+
+void LockProfiler::pushSharedHold(const void *lock, const LockSite &site, uint64_t acquiredAt) {
+    ThreadBuffer &buffer = threadBuffer();
+    if (buffer.m_numSharedHolds == MaxSharedHolds) {
+        return;
+    }
+
+    SharedHold &hold = buffer.m_sharedHolds[buffer.m_numSharedHolds++];
+    hold.m_lock = lock;
+    hold.m_site = &site;
+    hold.m_acquiredAt = acquiredAt;
+}
+
+bool LockProfiler::popSharedHold(const void *lock, const LockSite *&site, uint64_t &acquiredAt) {
+    ThreadBuffer &buffer = threadBuffer();
+    for (size_t i = buffer.m_numSharedHolds; i > 0; --i) {
+        if (buffer.m_sharedHolds[i - 1].m_lock != lock) {
+            continue;
+        }
+
+        site = buffer.m_sharedHolds[i - 1].m_site;
+        acquiredAt = buffer.m_sharedHolds[i - 1].m_acquiredAt;
+        for (size_t j = i; j < buffer.m_numSharedHolds; ++j) {
+            buffer.m_sharedHolds[j - 1] = buffer.m_sharedHolds[j];
+        }
+        --buffer.m_numSharedHolds;
+        return true;
+    }
+
+    return false;
+}
+
+void LockProfiler::collect(std::vector<LockSiteStats> &stats) {
+    stats.clear();
+
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.m_mutex);
+    std::vector<LockSiteStats> totals(reg.m_retired);
+    totals.resize(reg.m_sites.size());
+    for (size_t b = 0; b < reg.m_buffers.size(); ++b) {
+        for (size_t page = 0; page < NumPages; ++page) {
+            const SiteCounters *counters = reg.m_buffers[b]->m_pages[page].load(std::memory_order_acquire);
+            if (nullptr == counters) {
+                continue;
+            }
+            for (size_t i = 0; i < SitesPerPage && page * SitesPerPage + i < totals.size(); ++i) {
+                accumulate(totals[page * SitesPerPage + i], counters[i]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < totals.size(); ++i) {
+        if (0 == totals[i].m_acquisitions) {
+            continue;
+        }
+        totals[i].m_site = reg.m_sites[i];
+        stats.push_back(totals[i]);
+    }
+    std::stable_sort(stats.begin(), stats.end(), [](const LockSiteStats &lhs, const LockSiteStats &rhs) {
+        return lhs.m_totalWaitNs > rhs.m_totalWaitNs;
+    });
+}
+
+void LockProfiler::report(std::string &report) {
+    std::vector<LockSiteStats> stats;
+    collect(stats);
+
+    report = "Lock contention report, sorted by total wait time\n";
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const LockSiteStats &s = stats[i];
+        char line[512];
+        ::snprintf(line, sizeof(line), "%-24s %s:%d acquisitions=%llu contended=%llu (%.1f%%) wait=%s max-wait=%s hold=%s max-hold=%s\n",
+                s.m_site->getName(), s.m_site->getFile(), s.m_site->getLine(),
+                static_cast<unsigned long long>(s.m_acquisitions), static_cast<unsigned long long>(s.m_contended),
+                100.0 * static_cast<double>(s.m_contended) / static_cast<double>(s.m_acquisitions),
+                formatNs(s.m_totalWaitNs).c_str(), formatNs(s.m_maxWaitNs).c_str(),
+                formatNs(s.m_totalHoldNs).c_str(), formatNs(s.m_maxHoldNs).c_str());
+        report += line;
+    }
+}
+
+void LockProfiler::reset() {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> guard(reg.m_mutex);
+    reg.m_retired.clear();
+    for (size_t b = 0; b < reg.m_buffers.size(); ++b) {
+        for (size_t page = 0; page < NumPages; ++page) {
+            SiteCounters *counters = reg.m_buffers[b]->m_pages[page].load(std::memory_order_acquire);
+            if (nullptr == counters) {
+                continue;
+            }
+            for (size_t i = 0; i < SitesPerPage; ++i) {
+                counters[i].clear();
+            }
+        }
+    }
+}
+
+size_t LockProfiler::bucketIndex(uint64_t ns) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (ns < 2) {
+        return 0;
+    }
+    return std::min<size_t>(63 - __builtin_clzll(ns), NumBuckets - 1);
+#else
+    size_t index = 0;
+    while (ns > 1 && index < NumBuckets - 1) {
+        ns >>= 1;
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,248 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/Metrics.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace CPPCore {
+
+namespace Details {
+
+static std::atomic<size_t> s_nextThreadShard(0);
+
+size_t getDefaultShardCount() {
+    static const size_t count = []() {
+        size_t numThreads = std::thread::hardware_concurrency();
+        size_t count = 1;
+        while (count < numThreads) {
+            count <<= 1;
+        }
+        return count;
+    }();
+
+    return count;
+}
+
+size_t allocateThreadShard() {
+    return s_nextThreadShard.fetch_add(1, std::memory_order_relaxed);
+}
+
+static size_t roundUpShards(size_t numShards) {
+    if (0 == numShards) {
+        return getDefaultShardCount();
+    }
+    size_t count = 1;
+    while (count < numShards) {
+        count <<= 1;
+    }
+
+    return count;
+}
+
+static MetricCell *createCells(size_t count, int64_t value) {
+    MetricCell *cells = new MetricCell[count];
+    for (size_t i = 0; i < count; ++i) {
+        cells[i].m_value.store(value, std::memory_order_relaxed);
+    }
+
+    return cells;
+}
+
+} // Namespace Details
+
+ShardedCounter::ShardedCounter(size_t numShards) :
+        m_cells(nullptr),
+        m_mask(Details::roundUpShards(numShards) - 1) {
+    m_cells = Details::createCells(m_mask + 1, 0);
+}
+
+ShardedCounter::~ShardedCounter() {
+    delete [] m_cells;
+}
+
+int64_t ShardedCounter::get() const {
+    int64_t sum = 0;
+    for (size_t i = 0; i <= m_mask; ++i) {
+        sum += m_cells[i].m_value.load(std::memory_order_relaxed);
+    }
+
+    return sum;
+}
+
+void ShardedCounter::reset() {
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_cells[i].m_value.store(0, std::memory_order_relaxed);
+    }
+}
+
+ShardedGauge::ShardedGauge(size_t numShards) :
+        ShardedCounter(numShards) {
+    // empty
+}
+
+void ShardedGauge::set(int64_t value) {
+    Details::MetricCell &own = getCell();
+    for (size_t i = 0; i <= m_mask; ++i) {
+        if (&own != &m_cells[i]) {
+            m_cells[i].m_value.store(0, std::memory_order_relaxed);
+        }
+    }
+    own.m_value.store(value, std::memory_order_relaxed);
+}
+
+ShardedMaxTracker::ShardedMaxTracker(size_t numShards) :
+        m_cells(nullptr),
+        m_mask(Details::roundUpShards(numShards) - 1) {
+    m_cells = Details::createCells(m_mask + 1, Empty);
+}
+
+ShardedMaxTracker::~ShardedMaxTracker() {
+    delete [] m_cells;
+}
+
+int64_t ShardedMaxTracker::get() const {
+    int64_t result = Empty;
+    for (size_t i = 0; i <= m_mask; ++i) {
+        result = std::max(result, m_cells[i].m_value.load(std::memory_order_relaxed));
+    }
+
+    return result;
+}
+
+int64_t ShardedMaxTracker::getAndReset() {
+    int64_t result = Empty;
+    for (size_t i = 0; i <= m_mask; ++i) {
+        result = std::max(result, m_cells[i].m_value.exchange(Empty, std::memory_order_relaxed));
+    }
+
+    return result;
+}
+
+MetricsRegistry::MetricsRegistry() :
+        m_mutex(),
+        m_entries() {
+    // empty
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    // empty
+}
+
+MetricsRegistry::Entry *MetricsRegistry::findOrCreate(const std::string &name, MetricType type) {
+    std::map<std::string, Entry>::iterator it = m_entries.find(name);
+    if (m_entries.end() != it) {
+        return type == it->second.m_type ? &it->second : nullptr;
+    }
+
+    Entry &entry = m_entries[name];
+    entry.m_type = type;
+    switch (type) {
+        case MetricType::Counter:
+            entry.m_counter.reset(new ShardedCounter);
+            break;
+        case MetricType::Gauge:
+            entry.m_gauge.reset(new ShardedGauge);
+            break;
+        case MetricType::MaxTracker:
+            entry.m_maxTracker.reset(new ShardedMaxTracker);
+            break;
+    }
+
+    return &entry;
+}
+
+ShardedCounter *MetricsRegistry::getCounter(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry *entry = findOrCreate(name, MetricType::Counter);
+    return nullptr != entry ? entry->m_counter.get() : nullptr;
+}
+
+ShardedGauge *MetricsRegistry::getGauge(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry *entry = findOrCreate(name, MetricType::Gauge);
+    return nullptr != entry ? entry->m_gauge.get() : nullptr;
+}
+
+ShardedMaxTracker *MetricsRegistry::getMaxTracker(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry *entry = findOrCreate(name, MetricType::MaxTracker);
+    return nullptr != entry ? entry->m_maxTracker.get() : nullptr;
+}
+
+size_t MetricsRegistry::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void MetricsRegistry::collect(std::vector<MetricSample> &samples, bool resetMax) const {
+    samples.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    samples.reserve(m_entries.size());
+    for (std::map<std::string, Entry>::const_iterator it = m_entries.begin(); m_entries.end() != it; ++it) {
+        const Entry &entry = it->second;
+        int64_t value = 0;
+        switch (entry.m_type) {
+            case MetricType::Counter:
+                value = entry.m_counter->get();
+                break;
+            case MetricType::Gauge:
+                value = entry.m_gauge->get();
+                break;
+            case MetricType::MaxTracker:
+                value = resetMax ? entry.m_maxTracker->getAndReset() : entry.m_maxTracker->get();
+                break;
+        }
+        samples.push_back(MetricSample{ it->first, entry.m_type, value });
+    }
+}
+
+void MetricsRegistry::report(std::string &report, bool resetMax) const {
+    static const char *TypeNames[] = { "counter", "gauge", "gauge" };
+
+    std::vector<MetricSample> samples;
+    collect(samples, resetMax);
+    report.clear();
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const MetricSample &sample = samples[i];
+        if (MetricType::MaxTracker == sample.m_type && ShardedMaxTracker::Empty == sample.m_value) {
+            continue;
+        }
+        report += "# TYPE ";
+        report += sample.m_name;
+        report += " ";
+        report += TypeNames[static_cast<size_t>(sample.m_type)];
+        report += "\n";
+        report += sample.m_name;
+        report += " ";
+        report += std::to_string(sample.m_value);
+        report += "\n";
+    }
+}
+
+MetricsRegistry &MetricsRegistry::getDefault() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,183 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/RollingWindow.h>
+#include <cppcore/Platform/VectorKernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace CPPCore {
+
+void RollingWindow::CompensatedSum::add(double value) {
+    const double sum = m_sum + value;
+    if (std::abs(m_sum) >= std::abs(value)) {
+        m_compensation += (m_sum - sum) + value;
+    } else {
+        m_compensation += (value - sum) + m_sum;
+    }
+    m_sum = sum;
+}
+
+double RollingWindow::CompensatedSum::get() const {
+    return m_sum + m_compensation;
+}
+
+RollingWindow::RollingWindow(size_t capacity) :
+        m_samples(capacity),
+        m_minQueue(capacity),
+        m_maxQueue(capacity),
+        m_sum{ 0.0, 0.0 },
+        m_sumSq{ 0.0, 0.0 },
+        m_offset(0.0),
+        m_sequence(0),
+        m_scratch() {
+    // empty
+}
+
+RollingWindow::~RollingWindow() {
+    // empty
+}
+
+void RollingWindow::add(float sample) {
+    if (m_samples.isEmpty()) {
+        m_offset = sample;
+    }
+    if (m_samples.isFull()) {
+        const double oldest = m_samples.front() - m_offset;
+        m_sum.add(-oldest);
+        m_sumSq.add(-oldest * oldest);
+    }
+    m_samples.add(sample);
+    const double shifted = sample - m_offset;
+    m_sum.add(shifted);
+    m_sumSq.add(shifted * shifted);
+
+    updateExtremes(m_minQueue, sample, true);
+    updateExtremes(m_maxQueue, sample, false);
+    ++m_sequence;
+
+    // Once per turnover, so the offset follows a drifting series, this is O(1) amortized
+    if (0 == m_sequence % m_samples.capacity()) {
+        rebase();
+    }
+}
+
+void RollingWindow::rebase() {
+    m_offset = m_samples.front();
+    m_sum = CompensatedSum{ 0.0, 0.0 };
+    m_sumSq = CompensatedSum{ 0.0, 0.0 };
+    for (size_t i = 0; i < m_samples.size(); ++i) {
+        const double shifted = m_samples[i] - m_offset;
+        m_sum.add(shifted);
+        m_sumSq.add(shifted * shifted);
+    }
+}
+
+void RollingWindow::updateExtremes(TRingBuffer<Extreme> &queue, float sample, bool isMin) {
+    // The front leaves with its sample, then every candidate which the new sample beats for the
+    // rest of its time in the window is dropped, so the queue stays sorted
+    const size_t capacity = m_samples.capacity();
+    if (!queue.isEmpty() && queue.front().m_sequence + capacity <= m_sequence) {
+        queue.removeFront();
+    }
+    if (isMin) {
+        while (!queue.isEmpty() && queue.back().m_value >= sample) {
+            queue.removeBack();
+        }
+    } else {
+        while (!queue.isEmpty() && queue.back().m_value <= sample) {
+            queue.removeBack();
+        }
+    }
+    queue.add(Extreme{ m_sequence, sample });
+}
+
+void RollingWindow::clear() {
+    m_samples.clear();
+    m_minQueue.clear();
+    m_maxQueue.clear();
+    m_sum = CompensatedSum{ 0.0, 0.0 };
+    m_sumSq = CompensatedSum{ 0.0, 0.0 };
+    m_offset = 0.0;
+    m_sequence = 0;
+}
+
+float RollingWindow::getMin() const {
+    return m_minQueue.isEmpty() ? std::numeric_limits<float>::infinity() : m_minQueue.front().m_value;
+}
+
+float RollingWindow::getMax() const {
+    return m_maxQueue.isEmpty() ? -std::numeric_limits<float>::infinity() : m_maxQueue.front().m_value;
+}
+
+double RollingWindow::getSum() const {
+    return m_offset * static_cast<double>(size()) + m_sum.get();
+}
+
+double RollingWindow::getMean() const {
+    return isEmpty() ? 0.0 : m_offset + m_sum.get() / static_cast<double>(size());
+}
+
+double RollingWindow::getVariance() const {
+    if (isEmpty()) {
+        return 0.0;
+    }
+
+    // The shifted sums are small for a small spread, however large the mean is, so the
+    // difference does not cancel out. The clamp only catches the last rounding step.
+    const double shiftedMean = m_sum.get() / static_cast<double>(size());
+    return std::max(0.0, m_sumSq.get() / static_cast<double>(size()) - shiftedMean * shiftedMean);
+}
+
+float RollingWindow::getPercentile(float fraction) const {
+    if (isEmpty()) {
+        return 0.0f;
+    }
+
+    m_scratch.resize(size());
+    m_samples.copyTo(m_scratch.data());
+    const float rank = std::min(std::max(fraction, 0.0f), 1.0f) * static_cast<float>(size() - 1);
+    const auto nth = m_scratch.begin() + static_cast<ptrdiff_t>(std::lround(rank));
+    std::nth_element(m_scratch.begin(), nth, m_scratch.end());
+
+    return *nth;
+}
+
+float RollingWindow::computeSum() const {
+    const TRingBuffer<float>::Segments segments = m_samples.getSegments();
+    return VectorKernels::sum(segments.m_first, segments.m_firstCount) +
+           VectorKernels::sum(segments.m_second, segments.m_secondCount);
+}
+
+void RollingWindow::computeMinMax(float &min, float &max) const {
+    const TRingBuffer<float>::Segments segments = m_samples.getSegments();
+    float secondMin = 0.0f;
+    float secondMax = 0.0f;
+    VectorKernels::minMax(segments.m_first, segments.m_firstCount, min, max);
+    VectorKernels::minMax(segments.m_second, segments.m_secondCount, secondMin, secondMax);
+    min = std::min(min, secondMin);
+    max = std::max(max, secondMax);
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,629 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/SamplingProfiler.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#ifdef CPPCORE_GNU_LINUX
+#   include <cxxabi.h>
+#   include <elf.h>
+#   include <link.h>
+#   include <pthread.h>
+#   include <signal.h>
+#   include <stdlib.h>
+#   include <time.h>
+#   include <ucontext.h>
+#   include <unwind.h>
+#endif
+
+namespace CPPCore {
+
+namespace {
+
+static constexpr uint32_t SlotFree = 0;
+static constexpr uint32_t SlotCommitted = 1;
+
+static std::atomic<SamplingProfiler *> s_activeProfiler(nullptr);
+
+// The number of signal handlers between reading s_activeProfiler and leaving record().
+static std::atomic<size_t> s_numHandlersInFlight(0);
+
+#ifdef CPPCORE_GNU_LINUX
+
+// The stack of the thread, [m_low, m_high). Zero until the thread was registered, the handler
+// cannot query it itself, pthread_getattr_np is not async-signal-safe.
+struct StackBounds {
+    uintptr_t m_low;
+    uintptr_t m_high;
+};
+
+static thread_local StackBounds t_stackBounds __attribute__((tls_model("initial-exec"))) = { 0, 0 };
+
+struct UnwindState {
+    uintptr_t *m_frames;
+    size_t m_numFrames;
+    size_t m_maxFrames;
+};
+
+static _Unwind_Reason_Code unwindCallback(struct _Unwind_Context *context, void *arg) {
+    UnwindState *state = static_cast<UnwindState *>(arg);
+    if (state->m_numFrames == state->m_maxFrames) {
+        return _URC_END_OF_STACK;
+    }
+
+    int ipBefore = 0;
+    const uintptr_t ip = _Unwind_GetIPInfo(context, &ipBefore);
+    if (0 == ip) {
+        return _URC_END_OF_STACK;
+    }
+    state->m_frames[state->m_numFrames++] = ip;
+
+    return _URC_NO_REASON;
+}
+
+static void getRegisters(void *context, uintptr_t &pc, uintptr_t &fp, uintptr_t &sp) {
+    pc = fp = sp = 0;
+    if (nullptr == context) {
+        return;
+    }
+
+    const ucontext_t *uc = static_cast<const ucontext_t *>(context);
+#if defined(__x86_64__)
+    pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+    fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+    sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__i386__)
+    pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_EIP]);
+    fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_EBP]);
+    sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_ESP]);
+#elif defined(__aarch64__)
+    pc = static_cast<uintptr_t>(uc->uc_mcontext.pc);
+    fp = static_cast<uintptr_t>(uc->uc_mcontext.regs[29]);
+    sp = static_cast<uintptr_t>(uc->uc_mcontext.sp);
+#else
+    (void)uc;
+#endif
+}
+
+static size_t unwindFramePointers(uintptr_t pc, uintptr_t fp, uintptr_t sp, const StackBounds &bounds,
+        uintptr_t *frames, size_t maxFrames) {
+    size_t numFrames = 0;
+    if (0 == pc) {
+        return numFrames;
+    }
+    frames[numFrames++] = pc;
+
+    // Unknown bounds or a stack pointer outside of them, e.g. on an alternate signal stack: there
+    // is no safe range to read from, keep the leaf frame only.
+    if (sp < bounds.m_low || sp >= bounds.m_high) {
+        return numFrames;
+    }
+
+    // Every frame stores the previous frame pointer followed by the return address.
+    static constexpr uintptr_t FrameSize = 2 * sizeof(uintptr_t);
+    while (numFrames < maxFrames) {
+        if (fp < sp || fp > bounds.m_high - FrameSize || 0 != (fp & (sizeof(uintptr_t) - 1))) {
+            break;
+        }
+        const uintptr_t *frame = reinterpret_cast<const uintptr_t *>(fp);
+        const uintptr_t next = frame[0];
+        const uintptr_t ret = frame[1];
+        if (0 == ret) {
+            break;
+        }
+        frames[numFrames++] = ret;
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+
+    return numFrames;
+}
+
+#endif // CPPCORE_GNU_LINUX
+
+static std::string toHex(uintptr_t value) {
+    static const char Digits[] = "0123456789abcdef";
+    std::string hex;
+    do {
+        hex.insert(hex.begin(), Digits[value & 0xf]);
+        value >>= 4;
+    } while (0 != value);
+
+    return "0x" + hex;
+}
+
+static std::string baseName(const std::string &path) {
+    const std::string::size_type pos = path.rfind('/');
+    if (std::string::npos == pos) {
+        return path;
+    }
+
+    return path.substr(pos + 1);
+}
+
+} // namespace
+
+#ifdef CPPCORE_GNU_LINUX
+
+struct SamplingProfiler::SignalHandler {
+    static void onSignal(int, siginfo_t *, void *context) {
+        // Announce the handler before reading the profiler, both are sequentially consistent, so
+        // either stop() sees the count or the handler sees the cleared pointer.
+        s_numHandlersInFlight.fetch_add(1);
+        SamplingProfiler *profiler = s_activeProfiler.load();
+        if (nullptr != profiler) {
+            const int savedErrno = errno;
+            profiler->record(context);
+            errno = savedErrno;
+        }
+        s_numHandlersInFlight.fetch_sub(1, std::memory_order_release);
+    }
+};
+
+#endif // CPPCORE_GNU_LINUX
+
+Symbolizer::Symbolizer() :
+        m_modules() {
+    refresh();
+}
+
+Symbolizer::~Symbolizer() {
+    // empty
+}
+
+void Symbolizer::refresh() {
+    m_modules.clear();
+#ifdef CPPCORE_GNU_LINUX
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        unsigned long start = 0, end = 0, offset = 0;
+        char perms[5] = {};
+        int pathPos = 0;
+        if (4 > sscanf(line.c_str(), "%lx-%lx %4s %lx %*s %*s %n", &start, &end, perms, &offset, &pathPos)) {
+            continue;
+        }
+        if ('x' != perms[2] || 0 == pathPos || static_cast<size_t>(pathPos) >= line.size() || '/' != line[pathPos]) {
+            continue;
+        }
+
+        Module module;
+        module.m_start = start;
+        module.m_end = end;
+        module.m_offset = offset;
+        module.m_path = line.substr(pathPos);
+        module.m_loaded = false;
+        m_modules.push_back(module);
+    }
+#endif
+}
+
+bool Symbolizer::resolve(uintptr_t address, std::string &name) {
+    Module *module = findModule(address);
+    if (nullptr == module) {
+        name = toHex(address);
+        return false;
+    }
+
+    if (!module->m_loaded) {
+        loadSymbols(*module);
+    }
+
+    // Translate the runtime address into the virtual address of the ELF file
+    const uintptr_t fileOffset = address - module->m_start + module->m_offset;
+    uintptr_t vaddr = fileOffset;
+    for (size_t i = 0; i < module->m_segments.size(); ++i) {
+        const uintptr_t segOffset = module->m_segments[i].first;
+        if (fileOffset >= segOffset) {
+            vaddr = fileOffset - segOffset + module->m_segments[i].second;
+        }
+    }
+
+    const std::vector<Symbol> &symbols = module->m_symbols;
+    std::vector<Symbol>::const_iterator it = std::upper_bound(symbols.begin(), symbols.end(), vaddr,
+            [](uintptr_t value, const Symbol &symbol) { return value < symbol.m_start; });
+    if (it != symbols.begin()) {
+        --it;
+        if (vaddr < it->m_start + std::max<uintptr_t>(it->m_size, 1)) {
+            name = it->m_name;
+            return true;
+        }
+    }
+    name = baseName(module->m_path) + "+" + toHex(fileOffset);
+
+    return false;
+}
+
+Symbolizer::Module *Symbolizer::findModule(uintptr_t address) {
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        if (address >= m_modules[i].m_start && address < m_modules[i].m_end) {
+            return &m_modules[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void Symbolizer::loadSymbols(Module &module) {
+    module.m_loaded = true;
+#ifdef CPPCORE_GNU_LINUX
+    // The same file is mapped multiple times, reuse the symbols of an already loaded mapping.
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        if (&m_modules[i] != &module && m_modules[i].m_loaded && m_modules[i].m_path == module.m_path) {
+            module.m_segments = m_modules[i].m_segments;
+            module.m_symbols = m_modules[i].m_symbols;
+            return;
+        }
+    }
+
+    std::ifstream file(module.m_path.c_str(), std::ios::binary);
+    if (!file) {
+        return;
+    }
+    const std::string image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (image.size() < sizeof(ElfW(Ehdr))) {
+        return;
+    }
+
+    const char *base = image.data();
+    const ElfW(Ehdr) *header = reinterpret_cast<const ElfW(Ehdr) *>(base);
+    if (0 != ::memcmp(header->e_ident, ELFMAG, SELFMAG) || header->e_ident[EI_CLASS] != (sizeof(void *) == 8 ? ELFCLASS64 : ELFCLASS32)) {
+        return;
+    }
+
+    if (header->e_phoff + header->e_phnum * sizeof(ElfW(Phdr)) <= image.size()) {
+        const ElfW(Phdr) *phdrs = reinterpret_cast<const ElfW(Phdr) *>(base + header->e_phoff);
+        for (size_t i = 0; i < header->e_phnum; ++i) {
+            if (PT_LOAD == phdrs[i].p_type) {
+                module.m_segments.push_back(std::make_pair(static_cast<uintptr_t>(phdrs[i].p_offset), static_cast<uintptr_t>(phdrs[i].p_vaddr)));
+            }
+        }
+        std::sort(module.m_segments.begin(), module.m_segments.end());
+    }
+
+    if (header->e_shoff + header->e_shnum * sizeof(ElfW(Shdr)) > image.size()) {
+        return;
+    }
+    const ElfW(Shdr) *shdrs = reinterpret_cast<const ElfW(Shdr) *>(base + header->e_shoff);
+    for (size_t i = 0; i < header->e_shnum; ++i) {
+        if (SHT_SYMTAB != shdrs[i].sh_type && SHT_DYNSYM != shdrs[i].sh_type) {
+            continue;
+        }
+        if (shdrs[i].sh_link >= header->e_shnum) {
+            continue;
+        }
+        const ElfW(Shdr) &strtab = shdrs[shdrs[i].sh_link];
+        if (shdrs[i].sh_offset + shdrs[i].sh_size > image.size() || strtab.sh_offset + strtab.sh_size > image.size()) {
+            continue;
+        }
+
+        const ElfW(Sym) *syms = reinterpret_cast<const ElfW(Sym) *>(base + shdrs[i].sh_offset);
+        const size_t numSyms = shdrs[i].sh_size / sizeof(ElfW(Sym));
+        for (size_t j = 0; j < numSyms; ++j) {
+            if (STT_FUNC != ELF64_ST_TYPE(syms[j].st_info) || 0 == syms[j].st_value || syms[j].st_name >= strtab.sh_size) {
+                continue;
+            }
+
+            Symbol symbol;
+            symbol.m_start = syms[j].st_value;
+            symbol.m_size = syms[j].st_size;
+            const char *rawName = base + strtab.sh_offset + syms[j].st_name;
+            int status = 0;
+            char *demangled = abi::__cxa_demangle(rawName, nullptr, nullptr, &status);
+            symbol.m_name = (0 == status && nullptr != demangled) ? demangled : rawName;
+            ::free(demangled);
+            module.m_symbols.push_back(symbol);
+        }
+    }
+
+    std::sort(module.m_symbols.begin(), module.m_symbols.end(),
+            [](const Symbol &lhs, const Symbol &rhs) { return lhs.m_start < rhs.m_start; });
+#endif
+}
+
+SamplingProfiler::SamplingProfiler(size_t frequency, size_t capacity, UnwindMode mode) :
+        m_mode(mode),
+        m_frequency(frequency),
+        m_capacity(capacity),
+        m_samples(nullptr),
+        m_writeIndex(0),
+        m_dropped(0),
+        m_running(false),
+        m_timer(nullptr) {
+    // Preallocate all samples, the signal handler must not allocate.
+    m_samples = new Sample[m_capacity];
+    for (size_t i = 0; i < m_capacity; ++i) {
+        m_samples[i].m_state.store(SlotFree, std::memory_order_relaxed);
+        m_samples[i].m_numFrames = 0;
+    }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+    delete[] m_samples;
+    m_samples = nullptr;
+}
+
+bool SamplingProfiler::start() {
+#ifdef CPPCORE_GNU_LINUX
+    SamplingProfiler *expected = nullptr;
+    if (!s_activeProfiler.compare_exchange_strong(expected, this)) {
+        return false;
+    }
+    registerThread();
+
+    if (SamplingProfiler::UnwindMode::Dwarf == m_mode) {
+        // The first unwind will load libgcc_s and its tables, do this outside of the handler.
+        uintptr_t frames[4];
+        UnwindState state = { frames, 0, 4 };
+        _Unwind_Backtrace(unwindCallback, &state);
+    }
+
+    struct sigaction action;
+    ::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &SamplingProfiler::SignalHandler::onSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (0 != sigaction(SIGPROF, &action, nullptr)) {
+        s_activeProfiler.store(nullptr);
+        return false;
+    }
+
+    struct sigevent event;
+    ::memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = SIGPROF;
+    timer_t timer;
+    if (0 != timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &timer)) {
+        s_activeProfiler.store(nullptr);
+        return false;
+    }
+    m_timer = static_cast<void *>(timer);
+    m_running.store(true);
+    if (!armTimer(m_frequency.load())) {
+        stop();
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+    if (!m_running.load()) {
+        return;
+    }
+
+#ifdef CPPCORE_GNU_LINUX
+    armTimer(0);
+    m_running.store(false);
+    timer_delete(static_cast<timer_t>(m_timer));
+    m_timer = nullptr;
+
+    // Signals already pending will find no active profiler anymore, handlers which are still
+    // recording on other threads must leave before the samples can be freed or cleared.
+    s_activeProfiler.store(nullptr);
+    while (0 != s_numHandlersInFlight.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+bool SamplingProfiler::registerThread() {
+#ifdef CPPCORE_GNU_LINUX
+    if (0 != t_stackBounds.m_high) {
+        return true;
+    }
+
+    pthread_attr_t attr;
+    if (0 != pthread_getattr_np(pthread_self(), &attr)) {
+        return false;
+    }
+    void *stackAddr = nullptr;
+    size_t stackSize = 0;
+    const int result = pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+    pthread_attr_destroy(&attr);
+    if (0 != result || nullptr == stackAddr) {
+        return false;
+    }
+
+    // Publish the lower bound first, a signal in between sees the high bound still at zero.
+    t_stackBounds.m_low = reinterpret_cast<uintptr_t>(stackAddr);
+    std::atomic_signal_fence(std::memory_order_release);
+    t_stackBounds.m_high = t_stackBounds.m_low + stackSize;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SamplingProfiler::isRunning() const {
+    return m_running.load();
+}
+
+void SamplingProfiler::setFrequency(size_t frequency) {
+    m_frequency.store(frequency);
+    if (m_running.load()) {
+        armTimer(frequency);
+    }
+}
+
+size_t SamplingProfiler::getFrequency() const {
+    return m_frequency.load();
+}
+
+size_t SamplingProfiler::numSamples() const {
+    return std::min(m_writeIndex.load(std::memory_order_acquire), m_capacity);
+}
+
+size_t SamplingProfiler::numDropped() const {
+    return m_dropped.load();
+}
+
+const SamplingProfiler::Sample &SamplingProfiler::getSample(size_t index) const {
+    assert(index < numSamples());
+
+    return m_samples[index];
+}
+
+void SamplingProfiler::writeFoldedStacks(std::string &folded) {
+    folded.clear();
+
+    Symbolizer symbolizer;
+    std::unordered_map<uintptr_t, std::string> names;
+    std::map<std::string, size_t> stacks;
+    const size_t numStored = numSamples();
+    for (size_t i = 0; i < numStored; ++i) {
+        const Sample &sample = m_samples[i];
+        if (SlotCommitted != sample.m_state.load(std::memory_order_acquire) || 0 == sample.m_numFrames) {
+            continue;
+        }
+
+        std::string stack;
+        for (size_t j = sample.m_numFrames; j > 0; --j) {
+            // Return addresses point behind the call, look up the call instruction itself.
+            const uintptr_t address = (j > 1) ? sample.m_frames[j - 1] - 1 : sample.m_frames[j - 1];
+            std::unordered_map<uintptr_t, std::string>::iterator it = names.find(address);
+            if (names.end() == it) {
+                std::string name;
+                symbolizer.resolve(address, name);
+                std::replace(name.begin(), name.end(), ';', ':');
+                it = names.insert(std::make_pair(address, name)).first;
+            }
+            if (!stack.empty()) {
+                stack += ";";
+            }
+            stack += it->second;
+        }
+        ++stacks[stack];
+    }
+
+    for (std::map<std::string, size_t>::const_iterator it = stacks.begin(); it != stacks.end(); ++it) {
+        folded += it->first;
+        folded += " ";
+        folded += std::to_string(it->second);
+        folded += "\n";
+    }
+}
+
+bool SamplingProfiler::writeFoldedStacks(const char *filename) {
+    if (nullptr == filename) {
+        return false;
+    }
+
+    std::string folded;
+    writeFoldedStacks(folded);
+    std::ofstream file(filename);
+    if (!file) {
+        return false;
+    }
+    file << folded;
+
+    return file.good();
+}
+
+void SamplingProfiler::clear() {
+    assert(!m_running.load());
+
+    const size_t numStored = numSamples();
+    for (size_t i = 0; i < numStored; ++i) {
+        m_samples[i].m_state.store(SlotFree, std::memory_order_relaxed);
+        m_samples[i].m_numFrames = 0;
+    }
+    m_writeIndex.store(0);
+    m_dropped.store(0);
+}
+
+void SamplingProfiler::record(void *context) {
+#ifdef CPPCORE_GNU_LINUX
+    const size_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Sample &sample = m_samples[index];
+    uintptr_t pc = 0, fp = 0, sp = 0;
+    getRegisters(context, pc, fp, sp);
+    if (UnwindMode::FramePointer == m_mode) {
+        const StackBounds bounds = t_stackBounds;
+        sample.m_numFrames = static_cast<uint32_t>(unwindFramePointers(pc, fp, sp, bounds, sample.m_frames, MaxFrames));
+    } else {
+        // The handler and the signal trampoline are on the stack as well, skip them.
+        static constexpr size_t MaxHandlerFrames = 8;
+        uintptr_t frames[MaxFrames + MaxHandlerFrames];
+        UnwindState state = { frames, 0, MaxFrames + MaxHandlerFrames };
+        _Unwind_Backtrace(unwindCallback, &state);
+        size_t first = 0;
+        for (size_t i = 0; i < state.m_numFrames && i < MaxHandlerFrames; ++i) {
+            if (frames[i] == pc) {
+                first = i;
+                break;
+            }
+        }
+        const size_t numFrames = std::min(state.m_numFrames - first, MaxFrames);
+        for (size_t i = 0; i < numFrames; ++i) {
+            sample.m_frames[i] = frames[first + i];
+        }
+        sample.m_numFrames = static_cast<uint32_t>(numFrames);
+    }
+    sample.m_state.store(SlotCommitted, std::memory_order_release);
+#else
+    (void)context;
+#endif
+}
+
+bool SamplingProfiler::armTimer(size_t frequency) {
+#ifdef CPPCORE_GNU_LINUX
+    // The timer id itself can be zero, so the running flag tells if the timer exists.
+    if (!m_running.load()) {
+        return false;
+    }
+
+    struct itimerspec spec;
+    ::memset(&spec, 0, sizeof(spec));
+    if (0 != frequency) {
+        const long intervalNs = static_cast<long>(1000000000ul / frequency);
+        spec.it_interval.tv_sec = intervalNs / 1000000000l;
+        spec.it_interval.tv_nsec = intervalNs % 1000000000l;
+        spec.it_value = spec.it_interval;
+    }
+
+    return 0 == timer_settime(static_cast<timer_t>(m_timer), 0, &spec, nullptr);
+#else
+    (void)frequency;
+    return false;
+#endif
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,510 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/Bvh.h>
+#include <cppcore/Parallel/ParallelAlgorithms.h>
+
+#include <memory>
+
+namespace CPPCore {
+
+namespace {
+
+// The boxes and centroid bounds of the primitives per bin and axis
+struct BinSet {
+    BoundingBox m_boxes[3][Bvh::MaxBins];
+    BoundingBox m_centroids[3][Bvh::MaxBins];
+    uint32_t m_counts[3][Bvh::MaxBins] = {};
+};
+
+// Below this depth the builder gives up the SAH and splits at the median, so degenerate input
+// cannot overflow the traversal stack
+static constexpr size_t MaxSahDepth = 32;
+
+static void initNode(Details::BvhNode &node) {
+    const float inf = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < 4; ++i) {
+        node.m_minX[i] = node.m_minY[i] = node.m_minZ[i] = inf;
+        node.m_maxX[i] = node.m_maxY[i] = node.m_maxZ[i] = -inf;
+        node.m_children[i] = InvalidSpatialIndex;
+        node.m_counts[i] = 0;
+    }
+}
+
+static void setLaneBox(Details::BvhNode &node, size_t lane, const BoundingBox &box) {
+    node.m_minX[lane] = box.m_min[0];
+    node.m_minY[lane] = box.m_min[1];
+    node.m_minZ[lane] = box.m_min[2];
+    node.m_maxX[lane] = box.m_max[0];
+    node.m_maxY[lane] = box.m_max[1];
+    node.m_maxZ[lane] = box.m_max[2];
+}
+
+static unsigned overlapBox4(const Details::BvhNode &node, const BoundingBox &box) {
+#ifdef CPPCORE_SPATIAL_SSE
+    __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.m_minX), _mm_set1_ps(box.m_max[0])),
+            _mm_cmple_ps(_mm_set1_ps(box.m_min[0]), _mm_load_ps(node.m_maxX)));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_load_ps(node.m_minY), _mm_set1_ps(box.m_max[1])));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_set1_ps(box.m_min[1]), _mm_load_ps(node.m_maxY)));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_load_ps(node.m_minZ), _mm_set1_ps(box.m_max[2])));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_set1_ps(box.m_min[2]), _mm_load_ps(node.m_maxZ)));
+    return static_cast<unsigned>(_mm_movemask_ps(hit));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        if (node.m_minX[i] <= box.m_max[0] && box.m_min[0] <= node.m_maxX[i] &&
+                node.m_minY[i] <= box.m_max[1] && box.m_min[1] <= node.m_maxY[i] &&
+                node.m_minZ[i] <= box.m_max[2] && box.m_min[2] <= node.m_maxZ[i]) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static unsigned overlapSphere4(const Details::BvhNode &node, const Float3 &center, float radiusSq) {
+#ifdef CPPCORE_SPATIAL_SSE
+    // The distance per axis is max(min - c, c - max, 0), empty lanes get an infinite distance
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 centerX = _mm_set1_ps(center[0]);
+    const __m128 centerY = _mm_set1_ps(center[1]);
+    const __m128 centerZ = _mm_set1_ps(center[2]);
+    const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(node.m_minX), centerX), _mm_sub_ps(centerX, _mm_load_ps(node.m_maxX))), zero);
+    const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(node.m_minY), centerY), _mm_sub_ps(centerY, _mm_load_ps(node.m_maxY))), zero);
+    const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(node.m_minZ), centerZ), _mm_sub_ps(centerZ, _mm_load_ps(node.m_maxZ))), zero);
+    const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(distanceSq, _mm_set1_ps(radiusSq))));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        BoundingBox box;
+        box.m_min = Float3{ node.m_minX[i], node.m_minY[i], node.m_minZ[i] };
+        box.m_max = Float3{ node.m_maxX[i], node.m_maxY[i], node.m_maxZ[i] };
+        if (box.getDistanceSq(center) <= radiusSq) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+} // Namespace
+
+//-------------------------------------------------------------------------------------------------
+// Builds the 4-wide tree top-down. A node starts with its whole range as one child and splits the
+// child with the largest surface area until it has 4 children or all of them fit into leaves.
+// Large inner children are built as tasks into their own node arrays, which are appended to the
+// parent array when the tasks are done. The primitive boxes are partitioned in place together with
+// their indices, so the binning reads them sequentially instead of gathering them.
+//-------------------------------------------------------------------------------------------------
+class BvhBuilder {
+public:
+    struct PrimitiveRef {
+        BoundingBox m_box;
+        uint32_t m_index;
+
+        Float3 getCentroid() const {
+            return m_box.getCenter();
+        }
+    };
+
+    struct Range {
+        uint32_t m_begin;
+        uint32_t m_end;
+        BoundingBox m_bounds;
+        BoundingBox m_centroidBounds;
+
+        uint32_t getCount() const {
+            return m_end - m_begin;
+        }
+    };
+
+    BvhBuilder(const BoundingBox *boxes, size_t count, const BvhOptions &options) :
+            m_refs(count),
+            m_options(options),
+            m_scheduler(Details::getScheduler(options.m_scheduler)) {
+        m_options.m_maxLeafSize = std::max<uint32_t>(1, m_options.m_maxLeafSize);
+        m_options.m_numBins = std::min(std::max<uint32_t>(2, m_options.m_numBins), Bvh::MaxBins);
+        m_options.m_parallelThreshold = std::max<size_t>(m_options.m_maxLeafSize + 1, m_options.m_parallelThreshold);
+        parallelFor(0, count, [this, boxes](size_t i) {
+            m_refs[i] = PrimitiveRef{ boxes[i], static_cast<uint32_t>(i) };
+        }, DefaultGrainSize, &m_scheduler);
+    }
+
+    Range getRootRange(size_t count) const {
+        struct Bounds {
+            BoundingBox m_bounds;
+            BoundingBox m_centroidBounds;
+        };
+        const Bounds bounds = parallelReduce(0, count, Bounds(), [this](size_t begin, size_t end, Bounds value) {
+            for (size_t i = begin; i < end; ++i) {
+                value.m_bounds.extend(m_refs[i].m_box);
+                value.m_centroidBounds.extend(m_refs[i].getCentroid());
+            }
+            return value;
+        }, [](Bounds a, const Bounds &b) {
+            a.m_bounds.extend(b.m_bounds);
+            a.m_centroidBounds.extend(b.m_centroidBounds);
+            return a;
+        }, DefaultGrainSize, &m_scheduler);
+
+        return Range{ 0, static_cast<uint32_t>(count), bounds.m_bounds, bounds.m_centroidBounds };
+    }
+
+    void buildNode(std::vector<Details::BvhNode> &nodes, uint32_t nodeIndex, const Range &range, size_t depth) {
+        Range children[4] = { range };
+        size_t numChildren = 1;
+        while (numChildren < 4) {
+            size_t best = numChildren;
+            float bestArea = -1.0f;
+            for (size_t i = 0; i < numChildren; ++i) {
+                const float area = children[i].m_bounds.getSurfaceArea();
+                if (children[i].getCount() > m_options.m_maxLeafSize && area > bestArea) {
+                    best = i;
+                    bestArea = area;
+                }
+            }
+            if (best == numChildren) {
+                break;
+            }
+            splitRange(children[best], depth >= MaxSahDepth, children[best], children[numChildren]);
+            ++numChildren;
+        }
+
+        initNode(nodes[nodeIndex]);
+        std::unique_ptr<std::vector<Details::BvhNode>> subtrees[4];
+        std::unique_ptr<TaskGroup> group;
+        const bool canSpawn = m_scheduler.getNumThreads() > 1;
+        for (size_t lane = 0; lane < numChildren; ++lane) {
+            const Range &child = children[lane];
+            setLaneBox(nodes[nodeIndex], lane, child.m_bounds);
+            if (child.getCount() <= m_options.m_maxLeafSize) {
+                nodes[nodeIndex].m_children[lane] = child.m_begin;
+                nodes[nodeIndex].m_counts[lane] = child.getCount();
+            } else if (canSpawn && child.getCount() > m_options.m_parallelThreshold) {
+                if (nullptr == group) {
+                    group.reset(new TaskGroup(m_scheduler));
+                }
+                subtrees[lane].reset(new std::vector<Details::BvhNode>(1));
+                std::vector<Details::BvhNode> *subtree = subtrees[lane].get();
+                group->run([this, subtree, child, depth]() {
+                    buildNode(*subtree, 0, child, depth + 1);
+                });
+            }
+        }
+        for (size_t lane = 0; lane < numChildren; ++lane) {
+            const Range &child = children[lane];
+            if (child.getCount() > m_options.m_maxLeafSize && nullptr == subtrees[lane]) {
+                const uint32_t childIndex = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+                nodes[nodeIndex].m_children[lane] = childIndex;
+                buildNode(nodes, childIndex, child, depth + 1);
+            }
+        }
+        if (nullptr == group) {
+            return;
+        }
+
+        group->wait();
+        for (size_t lane = 0; lane < numChildren; ++lane) {
+            if (nullptr == subtrees[lane]) {
+                continue;
+            }
+            const uint32_t offset = static_cast<uint32_t>(nodes.size());
+            for (Details::BvhNode &node : *subtrees[lane]) {
+                for (size_t i = 0; i < 4; ++i) {
+                    if (0 == node.m_counts[i] && InvalidSpatialIndex != node.m_children[i]) {
+                        node.m_children[i] += offset;
+                    }
+                }
+            }
+            nodes.insert(nodes.end(), subtrees[lane]->begin(), subtrees[lane]->end());
+            nodes[nodeIndex].m_children[lane] = offset;
+        }
+    }
+
+    const std::vector<PrimitiveRef> &getRefs() const {
+        return m_refs;
+    }
+
+private:
+    BinSet computeBins(const Range &range, const float *binScale) const {
+        auto binRange = [this, &range, binScale](size_t begin, size_t end, BinSet bins) {
+            for (size_t i = begin; i < end; ++i) {
+                const PrimitiveRef &ref = m_refs[i];
+                const Float3 centroid = ref.getCentroid();
+                for (uint32_t axis = 0; axis < 3; ++axis) {
+                    const uint32_t bin = getBin(centroid[axis], range.m_centroidBounds.m_min[axis], binScale[axis]);
+                    bins.m_boxes[axis][bin].extend(ref.m_box);
+                    bins.m_centroids[axis][bin].extend(centroid);
+                    ++bins.m_counts[axis][bin];
+                }
+            }
+            return bins;
+        };
+        if (range.getCount() <= m_options.m_parallelThreshold) {
+            return binRange(range.m_begin, range.m_end, BinSet());
+        }
+
+        const uint32_t numBins = m_options.m_numBins;
+        return parallelReduce(range.m_begin, range.m_end, BinSet(), binRange, [numBins](BinSet a, const BinSet &b) {
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                for (uint32_t bin = 0; bin < numBins; ++bin) {
+                    a.m_boxes[axis][bin].extend(b.m_boxes[axis][bin]);
+                    a.m_centroids[axis][bin].extend(b.m_centroids[axis][bin]);
+                    a.m_counts[axis][bin] += b.m_counts[axis][bin];
+                }
+            }
+            return a;
+        }, DefaultGrainSize, &m_scheduler);
+    }
+
+    uint32_t getBin(float value, float min, float scale) const {
+        const float bin = (value - min) * scale;
+        return std::min(static_cast<uint32_t>(std::max(bin, 0.0f)), m_options.m_numBins - 1);
+    }
+
+    void splitRange(const Range range, bool medianOnly, Range &left, Range &right) {
+        const Float3 extent = range.m_centroidBounds.getExtent();
+        float binScale[3];
+        bool canBin = false;
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            binScale[axis] = extent[axis] > 0.0f ? static_cast<float>(m_options.m_numBins) * 0.99999f / extent[axis] : 0.0f;
+            canBin |= extent[axis] > 0.0f;
+        }
+        if (medianOnly || !canBin) {
+            splitMedian(range, left, right);
+            return;
+        }
+
+        // Sweep the bins from the right to get the costs of all right sides, then from the left
+        const BinSet bins = computeBins(range, binScale);
+        const uint32_t numBins = m_options.m_numBins;
+        float bestCost = std::numeric_limits<float>::infinity();
+        uint32_t bestAxis = 0;
+        uint32_t bestSplit = 0;
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            if (0.0f == binScale[axis]) {
+                continue;
+            }
+            float rightCosts[Bvh::MaxBins];
+            BoundingBox box;
+            uint32_t count = 0;
+            for (uint32_t bin = numBins - 1; bin > 0; --bin) {
+                box.extend(bins.m_boxes[axis][bin]);
+                count += bins.m_counts[axis][bin];
+                rightCosts[bin] = box.getSurfaceArea() * static_cast<float>(count);
+            }
+            box = BoundingBox();
+            count = 0;
+            for (uint32_t split = 1; split < numBins; ++split) {
+                box.extend(bins.m_boxes[axis][split - 1]);
+                count += bins.m_counts[axis][split - 1];
+                const float cost = box.getSurfaceArea() * static_cast<float>(count) + rightCosts[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        const float min = range.m_centroidBounds.m_min[bestAxis];
+        const float scale = binScale[bestAxis];
+        PrimitiveRef *refs = m_refs.data();
+        PrimitiveRef *mid = std::partition(refs + range.m_begin, refs + range.m_end, [&](const PrimitiveRef &ref) {
+            return getBin(ref.getCentroid()[bestAxis], min, scale) < bestSplit;
+        });
+        const uint32_t midIndex = static_cast<uint32_t>(mid - refs);
+        if (midIndex == range.m_begin || midIndex == range.m_end) {
+            splitMedian(range, left, right);
+            return;
+        }
+
+        left = Range{ range.m_begin, midIndex, BoundingBox(), BoundingBox() };
+        right = Range{ midIndex, range.m_end, BoundingBox(), BoundingBox() };
+        for (uint32_t bin = 0; bin < numBins; ++bin) {
+            Range &side = bin < bestSplit ? left : right;
+            side.m_bounds.extend(bins.m_boxes[bestAxis][bin]);
+            side.m_centroidBounds.extend(bins.m_centroids[bestAxis][bin]);
+        }
+    }
+
+    void splitMedian(const Range range, Range &left, Range &right) {
+        const uint32_t axis = range.m_centroidBounds.getLongestAxis();
+        const uint32_t mid = range.m_begin + range.getCount() / 2;
+        PrimitiveRef *refs = m_refs.data();
+        std::nth_element(refs + range.m_begin, refs + mid, refs + range.m_end, [axis](const PrimitiveRef &a, const PrimitiveRef &b) {
+            return a.getCentroid()[axis] < b.getCentroid()[axis];
+        });
+
+        const uint32_t begin = range.m_begin;
+        const uint32_t end = range.m_end;
+        left = Range{ begin, mid, BoundingBox(), BoundingBox() };
+        right = Range{ mid, end, BoundingBox(), BoundingBox() };
+        for (uint32_t i = left.m_begin; i < left.m_end; ++i) {
+            left.m_bounds.extend(m_refs[i].m_box);
+            left.m_centroidBounds.extend(m_refs[i].getCentroid());
+        }
+        for (uint32_t i = right.m_begin; i < right.m_end; ++i) {
+            right.m_bounds.extend(m_refs[i].m_box);
+            right.m_centroidBounds.extend(m_refs[i].getCentroid());
+        }
+    }
+
+private:
+    std::vector<PrimitiveRef> m_refs;
+    BvhOptions m_options;
+    TaskScheduler &m_scheduler;
+};
+
+Bvh::Bvh() :
+        m_nodes(),
+        m_indices(),
+        m_boxes(),
+        m_bounds(),
+        m_rootChild(0),
+        m_rootCount(0) {
+    // empty
+}
+
+Bvh::~Bvh() {
+    // empty
+}
+
+void Bvh::build(const BoundingBox *boxes, size_t count, const BvhOptions &options) {
+    clear();
+    if (0 == count) {
+        return;
+    }
+    assert(count < InvalidSpatialIndex);
+
+    BvhBuilder builder(boxes, count, options);
+    const BvhBuilder::Range root = builder.getRootRange(count);
+    m_bounds = root.m_bounds;
+    if (count <= std::max<uint32_t>(1, options.m_maxLeafSize)) {
+        m_rootChild = 0;
+        m_rootCount = static_cast<uint32_t>(count);
+    } else {
+        m_nodes.emplace_back();
+        builder.buildNode(m_nodes, 0, root, 0);
+    }
+
+    // The boxes stay in leaf order, so a leaf reads them from one place
+    const std::vector<BvhBuilder::PrimitiveRef> &refs = builder.getRefs();
+    m_indices.resize(count);
+    m_boxes.resize(count);
+    parallelFor(0, count, [this, &refs](size_t i) {
+        m_indices[i] = refs[i].m_index;
+        m_boxes[i] = refs[i].m_box;
+    }, DefaultGrainSize, options.m_scheduler);
+}
+
+void Bvh::build(const Float3 *points, size_t count, const BvhOptions &options) {
+    std::vector<BoundingBox> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        boxes[i] = BoundingBox::fromPoint(points[i]);
+    }
+    build(boxes.data(), count, options);
+}
+
+void Bvh::clear() {
+    m_nodes.clear();
+    m_indices.clear();
+    m_boxes.clear();
+    m_bounds = BoundingBox();
+    m_rootChild = 0;
+    m_rootCount = 0;
+}
+
+size_t Bvh::queryBox(const BoundingBox &box, std::vector<uint32_t> &result) const {
+    const size_t oldSize = result.size();
+    auto queryLeaf = [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+            if (m_boxes[i].overlaps(box)) {
+                result.push_back(m_indices[i]);
+            }
+        }
+    };
+    if (isEmpty()) {
+        return 0;
+    }
+    if (0 != m_rootCount) {
+        queryLeaf(m_rootChild, m_rootCount);
+        return result.size() - oldSize;
+    }
+
+    uint32_t stack[StackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = m_rootChild;
+    while (0 != stackSize) {
+        const Details::BvhNode &node = m_nodes[stack[--stackSize]];
+        for (unsigned mask = overlapBox4(node, box); 0 != mask; mask &= mask - 1) {
+            const unsigned lane = static_cast<unsigned>(std::countr_zero(mask));
+            if (0 != node.m_counts[lane]) {
+                queryLeaf(node.m_children[lane], node.m_counts[lane]);
+            } else {
+                stack[stackSize++] = node.m_children[lane];
+            }
+        }
+    }
+
+    return result.size() - oldSize;
+}
+
+size_t Bvh::querySphere(const Float3 &center, float radius, std::vector<uint32_t> &result) const {
+    const size_t oldSize = result.size();
+    const float radiusSq = radius * radius;
+    auto queryLeaf = [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+            if (m_boxes[i].getDistanceSq(center) <= radiusSq) {
+                result.push_back(m_indices[i]);
+            }
+        }
+    };
+    if (isEmpty()) {
+        return 0;
+    }
+    if (0 != m_rootCount) {
+        queryLeaf(m_rootChild, m_rootCount);
+        return result.size() - oldSize;
+    }
+
+    uint32_t stack[StackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = m_rootChild;
+    while (0 != stackSize) {
+        const Details::BvhNode &node = m_nodes[stack[--stackSize]];
+        for (unsigned mask = overlapSphere4(node, center, radiusSq); 0 != mask; mask &= mask - 1) {
+            const unsigned lane = static_cast<unsigned>(std::countr_zero(mask));
+            if (0 != node.m_counts[lane]) {
+                queryLeaf(node.m_children[lane], node.m_counts[lane]);
+            } else {
+                stack[stackSize++] = node.m_children[lane];
+            }
+        }
+    }
+
+    return result.size() - oldSize;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,208 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/HashGrid.h>
+
+#include <cmath>
+
+namespace CPPCore {
+
+namespace {
+
+// Marks an unused point index, a packed cell key never has the top bit set
+static constexpr uint64_t InvalidCellKey = ~uint64_t(0);
+
+// The cell coordinates are packed with 21 bits per axis, far away cells share keys, which only
+// costs time because the queries test the distances anyway
+static constexpr uint64_t CellBits = 21;
+static constexpr uint64_t CellMask = (uint64_t(1) << CellBits) - 1;
+
+static int64_t getCellCoord(float value, float invCellSize) {
+    const float cell = std::floor(value * invCellSize);
+    return static_cast<int64_t>(std::min(std::max(cell, -1.0e12f), 1.0e12f));
+}
+
+static uint64_t packCellKey(int64_t x, int64_t y, int64_t z) {
+    return ((static_cast<uint64_t>(x) & CellMask) << (2 * CellBits)) | ((static_cast<uint64_t>(y) & CellMask) << CellBits) |
+            (static_cast<uint64_t>(z) & CellMask);
+}
+
+} // Namespace
+
+HashGrid::HashGrid(float cellSize) :
+        m_cellSize(cellSize),
+        m_invCellSize(1.0f / cellSize),
+        m_size(0),
+        m_cells(),
+        m_cellKeys(),
+        m_slots() {
+    assert(cellSize > 0.0f);
+}
+
+HashGrid::~HashGrid() {
+    // empty
+}
+
+void HashGrid::insert(uint32_t index, const Float3 &point) {
+    assert(InvalidSpatialIndex != index);
+    if (index >= m_cellKeys.size()) {
+        m_cellKeys.resize(static_cast<size_t>(index) + 1, InvalidCellKey);
+        m_slots.resize(static_cast<size_t>(index) + 1);
+    }
+
+    const uint64_t key = getCellKey(point);
+    if (InvalidCellKey == m_cellKeys[index]) {
+        ++m_size;
+    } else if (key == m_cellKeys[index]) {
+        // Most moves stay in the cell
+        Entry &entry = (*m_cells.find(key))[m_slots[index]];
+        entry.m_x = point[0];
+        entry.m_y = point[1];
+        entry.m_z = point[2];
+        return;
+    } else {
+        removeFromCell(index);
+    }
+    addToCell(index, key, point);
+}
+
+bool HashGrid::remove(uint32_t index) {
+    if (!hasPoint(index)) {
+        return false;
+    }
+
+    removeFromCell(index);
+    m_cellKeys[index] = InvalidCellKey;
+    --m_size;
+
+    return true;
+}
+
+void HashGrid::clear() {
+    m_size = 0;
+    m_cells.clear();
+    m_cellKeys.clear();
+    m_slots.clear();
+}
+
+bool HashGrid::hasPoint(uint32_t index) const {
+    return index < m_cellKeys.size() && InvalidCellKey != m_cellKeys[index];
+}
+
+Float3 HashGrid::getPoint(uint32_t index) const {
+    assert(hasPoint(index));
+    const Entry &entry = (*m_cells.find(m_cellKeys[index]))[m_slots[index]];
+    return Float3{ entry.m_x, entry.m_y, entry.m_z };
+}
+
+size_t HashGrid::queryRadius(const Float3 &center, float radius, std::vector<uint32_t> &result) const {
+    const float radiusSq = radius * radius;
+    const Float3 extent = Float3::filled(radius);
+    const BoundingBox box{ center - extent, center + extent };
+
+    return queryCells(box, result, [&center, radiusSq](const Entry &entry) {
+        const float dx = entry.m_x - center[0];
+        const float dy = entry.m_y - center[1];
+        const float dz = entry.m_z - center[2];
+        return dx * dx + dy * dy + dz * dz <= radiusSq;
+    });
+}
+
+size_t HashGrid::queryBox(const BoundingBox &box, std::vector<uint32_t> &result) const {
+    return queryCells(box, result, [&box](const Entry &entry) {
+        return box.contains(Float3{ entry.m_x, entry.m_y, entry.m_z });
+    });
+}
+
+uint64_t HashGrid::getCellKey(const Float3 &point) const {
+    return packCellKey(getCellCoord(point[0], m_invCellSize), getCellCoord(point[1], m_invCellSize),
+            getCellCoord(point[2], m_invCellSize));
+}
+
+void HashGrid::addToCell(uint32_t index, uint64_t key, const Float3 &point) {
+    std::vector<Entry> &cell = m_cells[key];
+    m_cellKeys[index] = key;
+    m_slots[index] = static_cast<uint32_t>(cell.size());
+    cell.push_back(Entry{ point[0], point[1], point[2], index });
+}
+
+void HashGrid::removeFromCell(uint32_t index) {
+    // The last point of the cell takes the slot, empty cells are removed
+    const uint64_t key = m_cellKeys[index];
+    std::vector<Entry> &cell = *m_cells.find(key);
+    const uint32_t slot = m_slots[index];
+    if (slot + 1 != cell.size()) {
+        cell[slot] = cell.back();
+        m_slots[cell[slot].m_index] = slot;
+    }
+    cell.pop_back();
+    if (cell.empty()) {
+        m_cells.remove(key);
+    }
+}
+
+template <class Func>
+size_t HashGrid::queryCells(const BoundingBox &box, std::vector<uint32_t> &result, Func accept) const {
+    const size_t oldSize = result.size();
+    auto queryCell = [&result, &accept](const std::vector<Entry> &cell) {
+        for (const Entry &entry : cell) {
+            if (accept(entry)) {
+                result.push_back(entry.m_index);
+            }
+        }
+    };
+
+    int64_t min[3];
+    int64_t max[3];
+    double numCells = 1.0;
+    bool isWide = false;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        min[axis] = getCellCoord(box.m_min[axis], m_invCellSize);
+        max[axis] = getCellCoord(box.m_max[axis], m_invCellSize);
+        numCells *= static_cast<double>(max[axis] - min[axis] + 1);
+        isWide |= static_cast<uint64_t>(max[axis] - min[axis]) >= CellMask;
+    }
+
+    // A query over more cells than exist is faster as a scan over the occupied ones. Boxes wider
+    // than the key range would visit shared keys twice, so they are scanned as well
+    if (isWide || numCells > static_cast<double>(m_cells.size())) {
+        for (const auto &cell : m_cells) {
+            queryCell(cell.m_value);
+        }
+        return result.size() - oldSize;
+    }
+
+    for (int64_t x = min[0]; x <= max[0]; ++x) {
+        for (int64_t y = min[1]; y <= max[1]; ++y) {
+            for (int64_t z = min[2]; z <= max[2]; ++z) {
+                const std::vector<Entry> *cell = m_cells.find(packCellKey(x, y, z));
+                if (nullptr != cell) {
+                    queryCell(*cell);
+                }
+            }
+        }
+    }
+
+    return result.size() - oldSize;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,248 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/KdTree.h>
+#include <cppcore/Parallel/ParallelAlgorithms.h>
+
+namespace CPPCore {
+
+namespace {
+
+// Every inner level pushes at most one far child
+static constexpr size_t StackSize = 64;
+
+// Computes the squared distances of a bucket of points in one loop over the coordinate arrays
+static void getDistancesSq(const float *x, const float *y, const float *z, size_t count, const Float3 &query, float *result) {
+    for (size_t i = 0; i < count; ++i) {
+        const float dx = x[i] - query[0];
+        const float dy = y[i] - query[1];
+        const float dz = z[i] - query[2];
+        result[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+} // Namespace
+
+KdTree::KdTree() :
+        m_numLevels(0),
+        m_splits(),
+        m_axes(),
+        m_leafOffsets(),
+        m_x(),
+        m_y(),
+        m_z(),
+        m_indices() {
+    // empty
+}
+
+KdTree::~KdTree() {
+    // empty
+}
+
+void KdTree::build(const Float3 *points, size_t count, const KdTreeOptions &options) {
+    clear();
+    if (0 == count) {
+        return;
+    }
+    assert(count < InvalidSpatialIndex);
+
+    // Split until the leaves fit into a bucket, a split halves the count of a range
+    const size_t bucketSize = std::min(std::max<uint32_t>(1, options.m_bucketSize), MaxBucketSize);
+    while (((count - 1) >> m_numLevels) + 1 > bucketSize) {
+        ++m_numLevels;
+    }
+    const size_t numLeaves = size_t(1) << m_numLevels;
+    m_splits.resize(numLeaves - 1);
+    m_axes.resize(numLeaves - 1);
+    m_leafOffsets.resize(numLeaves + 1);
+    m_leafOffsets[numLeaves] = static_cast<uint32_t>(count);
+
+    // The points are partitioned together with their indices, so the splits read them in order
+    std::vector<PointRef> refs(count);
+    parallelFor(0, count, [&refs, points](size_t i) {
+        refs[i] = PointRef{ points[i], static_cast<uint32_t>(i) };
+    }, DefaultGrainSize, options.m_scheduler);
+    buildNode(0, 0, 0, static_cast<uint32_t>(count), refs.data(), std::max<size_t>(bucketSize, options.m_parallelThreshold),
+            options.m_scheduler);
+
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+    m_indices.resize(count);
+    parallelFor(0, count, [this, &refs](size_t i) {
+        m_x[i] = refs[i].m_point[0];
+        m_y[i] = refs[i].m_point[1];
+        m_z[i] = refs[i].m_point[2];
+        m_indices[i] = refs[i].m_index;
+    }, DefaultGrainSize, options.m_scheduler);
+}
+
+void KdTree::buildNode(size_t node, uint32_t level, uint32_t begin, uint32_t end, PointRef *refs,
+        size_t parallelThreshold, TaskScheduler *scheduler) {
+    if (level == m_numLevels) {
+        m_leafOffsets[node - m_splits.size()] = begin;
+        return;
+    }
+
+    BoundingBox bounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        bounds.extend(refs[i].m_point);
+    }
+    const uint32_t axis = bounds.getLongestAxis();
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(refs + begin, refs + mid, refs + end, [axis](const PointRef &a, const PointRef &b) {
+        return a.m_point[axis] < b.m_point[axis];
+    });
+    m_splits[node] = refs[mid].m_point[axis];
+    m_axes[node] = static_cast<uint8_t>(axis);
+
+    TaskScheduler &sched = Details::getScheduler(scheduler);
+    if (end - begin > parallelThreshold && sched.getNumThreads() > 1) {
+        TaskGroup group(sched);
+        group.run([=, this]() {
+            buildNode(2 * node + 2, level + 1, mid, end, refs, parallelThreshold, scheduler);
+        });
+        buildNode(2 * node + 1, level + 1, begin, mid, refs, parallelThreshold, scheduler);
+        group.wait();
+    } else {
+        buildNode(2 * node + 1, level + 1, begin, mid, refs, parallelThreshold, scheduler);
+        buildNode(2 * node + 2, level + 1, mid, end, refs, parallelThreshold, scheduler);
+    }
+}
+
+void KdTree::clear() {
+    m_numLevels = 0;
+    m_splits.clear();
+    m_axes.clear();
+    m_leafOffsets.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_indices.clear();
+}
+
+size_t KdTree::findNearest(const Float3 &query, size_t k, uint32_t *indices, float *distancesSq, float maxDistance) const {
+    if (isEmpty() || 0 == k) {
+        return 0;
+    }
+
+    // The candidates are kept sorted in the output arrays, the last one bounds the search
+    size_t numFound = 0;
+    float worstSq = maxDistance * maxDistance;
+    const size_t numInner = m_splits.size();
+
+    struct Entry {
+        size_t m_node;
+        float m_distanceSq;
+    };
+    Entry stack[StackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = Entry{ 0, 0.0f };
+    while (0 != stackSize) {
+        const Entry entry = stack[--stackSize];
+        if (entry.m_distanceSq > worstSq) {
+            continue;
+        }
+
+        // Descend to the leaf of the query, remember the far sides
+        size_t node = entry.m_node;
+        while (node < numInner) {
+            const float diff = query[m_axes[node]] - m_splits[node];
+            const size_t nearChild = diff < 0.0f ? 2 * node + 1 : 2 * node + 2;
+            const float farDistanceSq = std::max(entry.m_distanceSq, diff * diff);
+            if (farDistanceSq <= worstSq) {
+                stack[stackSize++] = Entry{ 4 * node + 3 - nearChild, farDistanceSq };
+            }
+            node = nearChild;
+        }
+
+        const size_t leaf = node - numInner;
+        const uint32_t begin = m_leafOffsets[leaf];
+        const uint32_t count = m_leafOffsets[leaf + 1] - begin;
+        float bucket[MaxBucketSize];
+        getDistancesSq(m_x.data() + begin, m_y.data() + begin, m_z.data() + begin, count, query, bucket);
+        for (uint32_t i = 0; i < count; ++i) {
+            const float distanceSq = bucket[i];
+            if (distanceSq > worstSq || (numFound == k && distanceSq == worstSq)) {
+                continue;
+            }
+            size_t pos = numFound < k ? numFound++ : k - 1;
+            for (; pos > 0 && distancesSq[pos - 1] > distanceSq; --pos) {
+                distancesSq[pos] = distancesSq[pos - 1];
+                indices[pos] = indices[pos - 1];
+            }
+            distancesSq[pos] = distanceSq;
+            indices[pos] = m_indices[begin + i];
+            if (numFound == k) {
+                worstSq = distancesSq[k - 1];
+            }
+        }
+    }
+
+    return numFound;
+}
+
+uint32_t KdTree::findNearest(const Float3 &query) const {
+    uint32_t index = InvalidSpatialIndex;
+    float distanceSq;
+    findNearest(query, 1, &index, &distanceSq);
+    return index;
+}
+
+size_t KdTree::queryRadius(const Float3 &center, float radius, std::vector<uint32_t> &result) const {
+    if (isEmpty()) {
+        return 0;
+    }
+
+    const size_t oldSize = result.size();
+    const float radiusSq = radius * radius;
+    const size_t numInner = m_splits.size();
+    size_t stack[StackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (0 != stackSize) {
+        size_t node = stack[--stackSize];
+        while (node < numInner) {
+            const float diff = center[m_axes[node]] - m_splits[node];
+            const size_t nearChild = diff < 0.0f ? 2 * node + 1 : 2 * node + 2;
+            if (diff * diff <= radiusSq) {
+                stack[stackSize++] = 4 * node + 3 - nearChild;
+            }
+            node = nearChild;
+        }
+
+        const size_t leaf = node - numInner;
+        const uint32_t begin = m_leafOffsets[leaf];
+        const uint32_t count = m_leafOffsets[leaf + 1] - begin;
+        float bucket[MaxBucketSize];
+        getDistancesSq(m_x.data() + begin, m_y.data() + begin, m_z.data() + begin, count, center, bucket);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (bucket[i] <= radiusSq) {
+                result.push_back(m_indices[begin + i]);
+            }
+        }
+    }
+
+    return result.size() - oldSize;
+}
+
+} // Namespace CPPCore
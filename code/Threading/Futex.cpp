@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/Futex.h>
+
+#ifdef CPPCORE_GNU_LINUX
+#   include <climits>
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#else
+#   include <condition_variable>
+#   include <mutex>
+#endif
+
+namespace CPPCore {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The futex word must be a plain 32-bit integer.");
+
+#ifdef CPPCORE_GNU_LINUX
+
+static long futex(std::atomic<uint32_t> &word, int op, uint32_t value) {
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, nullptr, nullptr, 0);
+}
+
+void Futex::wait(std::atomic<uint32_t> &word, uint32_t expected) {
+    futex(word, FUTEX_WAIT_PRIVATE, expected);
+}
+
+void Futex::wakeOne(std::atomic<uint32_t> &word) {
+    futex(word, FUTEX_WAKE_PRIVATE, 1);
+}
+
+void Futex::wakeAll(std::atomic<uint32_t> &word) {
+    futex(word, FUTEX_WAKE_PRIVATE, INT_MAX);
+}
+
+#else
+
+// Emulates the futex with a fixed table of wait queues. Different words can share a bucket, so
+// every wake is a broadcast and the waiters recheck their value.
+static const size_t NumBuckets = 64;
+
+struct alignas(CacheLineSize) Bucket {
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+};
+
+static Bucket &getBucket(const void *address) {
+    static Bucket buckets[NumBuckets];
+    const uintptr_t key = reinterpret_cast<uintptr_t>(address);
+    return buckets[((key >> 2) ^ (key >> 9)) % NumBuckets];
+}
+
+void Futex::wait(std::atomic<uint32_t> &word, uint32_t expected) {
+    Bucket &bucket = getBucket(&word);
+    std::unique_lock<std::mutex> lock(bucket.m_mutex);
+    if (word.load(std::memory_order_seq_cst) == expected) {
+        bucket.m_cond.wait(lock);
+    }
+}
+
+void Futex::wakeOne(std::atomic<uint32_t> &word) {
+    wakeAll(word);
+}
+
+void Futex::wakeAll(std::atomic<uint32_t> &word) {
+    Bucket &bucket = getBucket(&word);
+    std::lock_guard<std::mutex> lock(bucket.m_mutex);
+    bucket.m_cond.notify_all();
+}
+
+#endif
+
+} // Namespace CPPCore
@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/McsLock.h>
+
+namespace CPPCore {
+
+// The number of cached nodes per thread, enough for this many MCS locks held at once
+static const uint32_t NumCachedNodes = 16;
+
+struct NodeCache {
+    McsLock::Node m_nodes[NumCachedNodes];
+    uint32_t m_used = 0;
+};
+
+static thread_local NodeCache t_nodeCache;
+
+static McsLock::Node *acquireNode() {
+    NodeCache &cache = t_nodeCache;
+    for (uint32_t i = 0; i < NumCachedNodes; ++i) {
+        if (0 == (cache.m_used & (1u << i))) {
+            cache.m_used |= 1u << i;
+            cache.m_nodes[i].m_allocated = false;
+            return &cache.m_nodes[i];
+        }
+    }
+
+    McsLock::Node *node = new McsLock::Node;
+    node->m_allocated = true;
+
+    return node;
+}
+
+static void releaseNode(McsLock::Node *node) {
+    if (node->m_allocated) {
+        delete node;
+        return;
+    }
+    NodeCache &cache = t_nodeCache;
+    cache.m_used &= ~(1u << static_cast<uint32_t>(node - cache.m_nodes));
+}
+
+void McsLock::lock() {
+    Node *node = acquireNode();
+    lock(*node);
+    m_owner = node;
+}
+
+bool McsLock::try_lock() {
+    Node *node = acquireNode();
+    if (!try_lock(*node)) {
+        releaseNode(node);
+        return false;
+    }
+    m_owner = node;
+
+    return true;
+}
+
+void McsLock::unlock() {
+    Node *node = m_owner;
+    unlock(*node);
+    releaseNode(node);
+}
+
+} // Namespace CPPCore
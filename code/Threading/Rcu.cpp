@@ -0,0 +1,258 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/Rcu.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#ifdef CPPCORE_GNU_LINUX
+#   include <linux/membarrier.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace CPPCore {
+
+// Retire this many objects before the writer tries to reclaim
+static const size_t ReclaimThreshold = 16;
+
+// The epoch a reader started in, 0 while it is outside of a read-side section
+struct alignas(CacheLineSize) ReaderSlot {
+    std::atomic<uint64_t> m_epoch;
+    bool m_inUse;
+    ReaderSlot *m_next;
+};
+
+struct Retired {
+    void *m_object;
+    Rcu::Deleter m_deleter;
+    uint64_t m_epoch;
+};
+
+struct RcuState {
+    std::atomic<uint64_t> m_epoch;
+    std::atomic<ReaderSlot*> m_slots;
+    std::mutex m_mutex;
+    std::vector<Retired> m_retired;
+    bool m_membarrier;
+
+    RcuState() :
+            m_epoch(1),
+            m_slots(nullptr),
+            m_mutex(),
+            m_retired(),
+            m_membarrier(false) {
+#ifdef CPPCORE_GNU_LINUX
+        m_membarrier = 0 == ::syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0);
+#endif
+    }
+};
+
+static RcuState &getState() {
+    // Leaked on purpose, reader threads may outlive the static destructors
+    static RcuState *state = new RcuState;
+    return *state;
+}
+
+// Executes a memory barrier on all threads of the process, pairs with the compiler-only fence of
+// the readers.
+static void heavyFence(RcuState &state) {
+#ifdef CPPCORE_GNU_LINUX
+    if (state.m_membarrier) {
+        ::syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// Plain data, so the readers access it without the TLS init wrapper
+struct ThreadState {
+    ReaderSlot *m_slot;
+    size_t m_depth;
+};
+
+// The readers touch it on every read-side section, so avoid the slow general TLS access model
+#if defined(__GNUC__) || defined(__clang__)
+static thread_local ThreadState t_threadState __attribute__((tls_model("initial-exec")));
+#else
+static thread_local ThreadState t_threadState;
+#endif
+
+// Gives the slot of the thread back when the thread exits
+struct SlotReleaser {
+    ~SlotReleaser() {
+        ReaderSlot *slot = t_threadState.m_slot;
+        if (nullptr != slot) {
+            RcuState &state = getState();
+            std::lock_guard<std::mutex> lock(state.m_mutex);
+            slot->m_epoch.store(0, std::memory_order_release);
+            slot->m_inUse = false;
+            t_threadState.m_slot = nullptr;
+        }
+    }
+};
+
+static ReaderSlot *registerSlot() {
+    static thread_local SlotReleaser releaser;
+    (void) releaser;
+
+    RcuState &state = getState();
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    ReaderSlot *found = nullptr;
+    for (ReaderSlot *slot = state.m_slots.load(std::memory_order_relaxed); nullptr != slot; slot = slot->m_next) {
+        if (!slot->m_inUse) {
+            found = slot;
+            break;
+        }
+    }
+    if (nullptr == found) {
+        found = new ReaderSlot;
+        found->m_epoch.store(0, std::memory_order_relaxed);
+        found->m_next = state.m_slots.load(std::memory_order_relaxed);
+        state.m_slots.store(found, std::memory_order_release);
+    }
+    found->m_inUse = true;
+    t_threadState.m_slot = found;
+
+    return found;
+}
+
+void Rcu::readLock() {
+    ThreadState &threadState = t_threadState;
+    if (0 != threadState.m_depth++) {
+        return;
+    }
+
+    ReaderSlot *slot = threadState.m_slot;
+    if (nullptr == slot) {
+        slot = registerSlot();
+    }
+    RcuState &state = getState();
+    // Acquire keeps the loads of the read section behind the epoch load, with membarrier only a
+    // compiler fence follows and a weakly ordered CPU could read the protected pointer first.
+    slot->m_epoch.store(state.m_epoch.load(std::memory_order_acquire), std::memory_order_release);
+    if (state.m_membarrier) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void Rcu::readUnlock() {
+    ThreadState &threadState = t_threadState;
+    assert(0 != threadState.m_depth);
+    if (0 == --threadState.m_depth) {
+        threadState.m_slot->m_epoch.store(0, std::memory_order_release);
+    }
+}
+
+// Returns the oldest epoch of all active readers.
+static uint64_t getOldestReader(RcuState &state) {
+    heavyFence(state);
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (ReaderSlot *slot = state.m_slots.load(std::memory_order_acquire); nullptr != slot; slot = slot->m_next) {
+        const uint64_t epoch = slot->m_epoch.load(std::memory_order_seq_cst);
+        if (0 != epoch && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    return oldest;
+}
+
+void Rcu::synchronize() {
+    RcuState &state = getState();
+    const uint64_t epoch = state.m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    Backoff backoff;
+    while (getOldestReader(state) <= epoch) {
+        backoff.pause();
+    }
+}
+
+void Rcu::retire(void *object, Deleter deleter) {
+    if (nullptr == object) {
+        return;
+    }
+
+    RcuState &state = getState();
+    bool reclaimNow = false;
+    {
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        // Readers which started after the increment cannot see the unpublished object anymore
+        const Retired retired = { object, deleter, state.m_epoch.fetch_add(1, std::memory_order_seq_cst) };
+        state.m_retired.push_back(retired);
+        reclaimNow = state.m_retired.size() >= ReclaimThreshold;
+    }
+    if (reclaimNow) {
+        reclaim();
+    }
+}
+
+size_t Rcu::reclaim() {
+    RcuState &state = getState();
+    std::vector<Retired> expired;
+    {
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        if (state.m_retired.empty()) {
+            return 0;
+        }
+        const uint64_t oldest = getOldestReader(state);
+        size_t kept = 0;
+        for (size_t i = 0; i < state.m_retired.size(); ++i) {
+            if (state.m_retired[i].m_epoch < oldest) {
+                expired.push_back(state.m_retired[i]);
+            } else {
+                state.m_retired[kept++] = state.m_retired[i];
+            }
+        }
+        state.m_retired.resize(kept);
+    }
+
+    // Run the deleters outside of the lock, they may retire objects as well
+    for (size_t i = 0; i < expired.size(); ++i) {
+        expired[i].m_deleter(expired[i].m_object);
+    }
+
+    return expired.size();
+}
+
+void Rcu::barrier() {
+    synchronize();
+    reclaim();
+}
+
+size_t Rcu::numPending() {
+    RcuState &state = getState();
+    std::lock_guard<std::mutex> lock(state.m_mutex);
+    return state.m_retired.size();
+}
+
+bool Rcu::isUsingMembarrier() {
+    return getState().m_membarrier;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,278 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TaskScheduler.h>
+#include <cppcore/Threading/SpinLock.h>
+#include <cppcore/Threading/TWorkStealingQueue.h>
+
+namespace CPPCore {
+
+static const size_t QueueCapacity = 4096;
+static const size_t SpinRounds = 64;
+static const size_t YieldRounds = 256;
+
+struct TaskScheduler::Task {
+    std::function<void()> m_func;
+    TaskGroup *m_group;
+};
+
+struct alignas(CacheLineSize) TaskScheduler::Worker {
+    TWorkStealingQueue<Task*> m_queue;
+    std::thread m_thread;
+    uint32_t m_seed;
+
+    explicit Worker(uint32_t seed) :
+            m_queue(QueueCapacity),
+            m_thread(),
+            m_seed(seed) {
+        // empty
+    }
+};
+
+// The scheduler and the worker index of the calling thread, if it is a worker
+static thread_local TaskScheduler *t_scheduler = nullptr;
+static thread_local size_t t_workerIndex = 0;
+
+TaskScheduler::TaskScheduler(size_t numThreads) :
+        m_workers(),
+        m_injectMutex(),
+        m_injectQueue(),
+        m_numQueued(0),
+        m_numSleeping(0),
+        m_shutdown(false),
+        m_sleepMutex(),
+        m_wakeup() {
+    if (0 == numThreads) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    if (0 == numThreads) {
+        numThreads = 1;
+    }
+
+    // Create all workers before the first one starts stealing
+    for (size_t i = 1; i < numThreads; ++i) {
+        m_workers.push_back(new Worker(static_cast<uint32_t>(i * 2654435761u) | 1u));
+    }
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->m_thread = std::thread(&TaskScheduler::workerMain, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_shutdown.store(true, std::memory_order_release);
+    }
+    m_wakeup.notify_all();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->m_thread.join();
+    }
+
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        while (Task *task = m_workers[i]->m_queue.pop()) {
+            delete task;
+        }
+        delete m_workers[i];
+    }
+    for (size_t i = 0; i < m_injectQueue.size(); ++i) {
+        delete m_injectQueue[i];
+    }
+}
+
+TaskScheduler &TaskScheduler::getDefault() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+void TaskScheduler::submit(Task *task) {
+    m_numQueued.fetch_add(1, std::memory_order_seq_cst);
+    if (this == t_scheduler) {
+        if (!m_workers[t_workerIndex]->m_queue.push(task)) {
+            // The own deque is full, run it right away
+            m_numQueued.fetch_sub(1, std::memory_order_relaxed);
+            execute(task);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        m_injectQueue.push_back(task);
+    }
+
+    if (0 != m_numSleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeup.notify_one();
+    }
+}
+
+bool TaskScheduler::runOne() {
+    Task *task = findTask(this == t_scheduler ? m_workers[t_workerIndex] : nullptr);
+    if (nullptr == task) {
+        return false;
+    }
+    execute(task);
+
+    return true;
+}
+
+TaskScheduler::Task *TaskScheduler::findTask(Worker *self) {
+    if (0 == m_numQueued.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    Task *task = nullptr;
+    if (nullptr != self) {
+        task = self->m_queue.pop();
+    }
+
+    if (nullptr == task) {
+        std::unique_lock<std::mutex> lock(m_injectMutex, std::try_to_lock);
+        if (lock.owns_lock() && !m_injectQueue.empty()) {
+            task = m_injectQueue.front();
+            m_injectQueue.pop_front();
+        }
+    }
+
+    if (nullptr == task && !m_workers.empty()) {
+        // Start at a random victim, so the thieves do not all hit the same worker
+        size_t start = 0;
+        if (nullptr != self) {
+            self->m_seed ^= self->m_seed << 13;
+            self->m_seed ^= self->m_seed >> 17;
+            self->m_seed ^= self->m_seed << 5;
+            start = self->m_seed % m_workers.size();
+        }
+        for (size_t i = 0; i < m_workers.size() && nullptr == task; ++i) {
+            Worker *victim = m_workers[(start + i) % m_workers.size()];
+            if (victim != self) {
+                task = victim->m_queue.steal();
+            }
+        }
+    }
+
+    if (nullptr != task) {
+        m_numQueued.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return task;
+}
+
+void TaskScheduler::execute(Task *task) {
+    TaskGroup *group = task->m_group;
+    try {
+        task->m_func();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(group->m_errorMutex);
+        if (!group->m_error) {
+            group->m_error = std::current_exception();
+        }
+    }
+    delete task;
+
+    // The group may be gone as soon as the counter drops to zero
+    group->m_pending.fetch_sub(1, std::memory_order_release);
+}
+
+void TaskScheduler::workerMain(size_t index) {
+    t_scheduler = this;
+    t_workerIndex = index;
+
+    size_t idle = 0;
+    while (!m_shutdown.load(std::memory_order_acquire)) {
+        if (runOne()) {
+            idle = 0;
+            continue;
+        }
+
+        ++idle;
+        if (idle < SpinRounds) {
+            cpuRelax();
+            continue;
+        }
+        if (idle < YieldRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_numSleeping.fetch_add(1, std::memory_order_seq_cst);
+        m_wakeup.wait(lock, [this]() {
+            return m_shutdown.load(std::memory_order_relaxed) || 0 != m_numQueued.load(std::memory_order_seq_cst);
+        });
+        m_numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+
+    t_scheduler = nullptr;
+}
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler) :
+        m_scheduler(scheduler),
+        m_pending(0),
+        m_errorMutex(),
+        m_error() {
+    // empty
+}
+
+TaskGroup::~TaskGroup() {
+    helpUntilDone();
+}
+
+void TaskGroup::run(std::function<void()> func) {
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    TaskScheduler::Task *task = new TaskScheduler::Task{ std::move(func), this };
+    if (m_scheduler.m_workers.empty()) {
+        m_scheduler.execute(task);
+        return;
+    }
+    m_scheduler.submit(task);
+}
+
+void TaskGroup::wait() {
+    helpUntilDone();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::helpUntilDone() {
+    size_t idle = 0;
+    while (0 != m_pending.load(std::memory_order_acquire)) {
+        if (m_scheduler.runOne()) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < SpinRounds) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Async/ThreadPool.h>
+
+#include <coroutine>
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		AsyncFile
+///	@ingroup	CPPCore
+///
+///	@brief  A file with awaitable positional reads and writes. The awaiting coroutine is moved
+/// onto the ThreadPool, the blocking transfer runs there and the coroutine continues on the pool
+/// thread once it is complete, so the thread which started the I/O is never blocked.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT AsyncFile {
+public:
+    /// @brief  The open modes.
+    enum class Mode {
+        Read,       ///< Opens an existing file for reading.
+        Write,      ///< Creates or truncates a file for writing.
+        ReadWrite   ///< Opens or creates a file for reading and writing.
+    };
+
+    /// @brief  The awaiter returned by read() and write(), co_await returns the number of
+    /// transferred bytes or -1 on an error.
+    class IoAwaiter {
+    public:
+        IoAwaiter(AsyncFile &file, bool isWrite, uint64_t offset, void *buffer, size_t size) noexcept :
+                m_file(file),
+                m_isWrite(isWrite),
+                m_offset(offset),
+                m_buffer(buffer),
+                m_size(size) {
+            // empty
+        }
+
+        bool await_ready() const noexcept {
+            return m_file.m_pool.isInPool();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            m_file.m_pool.post(handle);
+        }
+
+        int64_t await_resume() {
+            if (m_isWrite) {
+                return m_file.writeAt(m_offset, m_buffer, m_size);
+            }
+            return m_file.readAt(m_offset, m_buffer, m_size);
+        }
+
+    private:
+        AsyncFile &m_file;
+        bool m_isWrite;
+        uint64_t m_offset;
+        void *m_buffer;
+        size_t m_size;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  pool    [in] The pool which performs the transfers.
+    explicit AsyncFile(ThreadPool &pool);
+
+    /// @brief  The class destructor, closes the file.
+    ~AsyncFile();
+
+    /// @brief  Opens a file, an open file will be closed before.
+    /// @param  path    [in] The file path.
+    /// @param  mode    [in] The open mode.
+    /// @return true, if the file was opened.
+    bool open(const char *path, Mode mode);
+
+    /// @brief  Closes the file.
+    void close();
+
+    /// @brief  Returns true, if a file is open.
+    /// @return true, if open.
+    bool isOpen() const;
+
+    /// @brief  Returns an awaitable which reads from a position.
+    /// @param  offset  [in] The file position.
+    /// @param  buffer  [out] The buffer to read into.
+    /// @param  size    [in] The number of bytes to read.
+    /// @return The awaitable.
+    IoAwaiter read(uint64_t offset, void *buffer, size_t size) noexcept;
+
+    /// @brief  Returns an awaitable which writes to a position.
+    /// @param  offset  [in] The file position.
+    /// @param  buffer  [in] The data to write.
+    /// @param  size    [in] The number of bytes to write.
+    /// @return The awaitable.
+    IoAwaiter write(uint64_t offset, const void *buffer, size_t size) noexcept;
+
+    /// @brief  Reads blocking from a position.
+    /// @param  offset  [in] The file position.
+    /// @param  buffer  [out] The buffer to read into.
+    /// @param  size    [in] The number of bytes to read.
+    /// @return The number of bytes read or -1 on an error.
+    int64_t readAt(uint64_t offset, void *buffer, size_t size);
+
+    /// @brief  Writes blocking to a position.
+    /// @param  offset  [in] The file position.
+    /// @param  buffer  [in] The data to write.
+    /// @param  size    [in] The number of bytes to write.
+    /// @return The number of bytes written or -1 on an error.
+    int64_t writeAt(uint64_t offset, const void *buffer, size_t size);
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(AsyncFile)
+
+private:
+    ThreadPool &m_pool;
+    intptr_t m_handle;
+};
+
+inline AsyncFile::IoAwaiter AsyncFile::read(uint64_t offset, void *buffer, size_t size) noexcept {
+    return IoAwaiter(*this, false, offset, buffer, size);
+}
+
+inline AsyncFile::IoAwaiter AsyncFile::write(uint64_t offset, const void *buffer, size_t size) noexcept {
+    return IoAwaiter(*this, true, offset, const_cast<void*>(buffer), size);
+}
+
+} // Namespace CPPCore
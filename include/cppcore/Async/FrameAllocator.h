@@ -0,0 +1,84 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Memory/ThreadCacheAllocator.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		FrameAllocator
+///	@ingroup	CPPCore
+///
+///	@brief  A pool for coroutine frames. The frames are taken from the thread caches of the
+/// ThreadCacheAllocator, so a frame is recycled without touching the global heap, also when the
+/// coroutine ends on another thread than it started. Frames larger than MaxPooledSize come from
+/// the heap directly.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT FrameAllocator {
+public:
+    /// @brief  The granularity of the size classes.
+    static constexpr size_t Granularity = ThreadCacheAllocator::Granularity;
+
+    /// @brief  The largest pooled frame size.
+    static constexpr size_t MaxPooledSize = ThreadCacheAllocator::MaxCachedSize;
+
+    /// @brief  The allocation statistic of the calling thread, shared with the ThreadCacheAllocator.
+    using Stats = ThreadCacheAllocator::Stats;
+
+    /// @brief  Allocates a frame.
+    /// @param  size    [in] The frame size in bytes.
+    /// @return The frame.
+    static void *allocate(size_t size);
+
+    /// @brief  Releases a frame into the free list of the calling thread.
+    /// @param  ptr     [in] The frame.
+    /// @param  size    [in] The size which was used for the allocation.
+    static void deallocate(void *ptr, size_t size);
+
+    /// @brief  Returns the statistic of the calling thread.
+    /// @return The statistic.
+    static Stats getThreadStats();
+
+    /// @brief  Resets the statistic of the calling thread.
+    static void resetThreadStats();
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		PooledFrame
+///	@ingroup	CPPCore
+///
+///	@brief  Base class for promise types, the coroutine frames are then taken from the
+/// FrameAllocator.
+//-------------------------------------------------------------------------------------------------
+struct PooledFrame {
+    static void *operator new(size_t size) {
+        return FrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void *ptr, size_t size) {
+        FrameAllocator::deallocate(ptr, size);
+    }
+};
+
+} // Namespace CPPCore
@@ -0,0 +1,241 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Async/FrameAllocator.h>
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TGenerator
+///	@ingroup	CPPCore
+///
+///	@brief  A synchronous coroutine generator, the values are produced by co_yield on demand while
+/// iterating. A yielded value is referenced, not copied, it is valid until the iterator is
+/// incremented. TGenerator<T> yields const references, TGenerator<T&> mutable ones. The frames come from the FrameAllocator.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TGenerator {
+public:
+    using value_type = std::remove_cv_t<std::remove_reference_t<T>>;
+    using reference = std::conditional_t<std::is_reference<T>::value, T, const T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    class promise_type : public PooledFrame {
+    public:
+        TGenerator get_return_object() noexcept {
+            return TGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(reference value) noexcept {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {
+            // empty
+        }
+
+        void unhandled_exception() noexcept {
+            m_exception = std::current_exception();
+        }
+
+        // co_await is not allowed inside a generator
+        void await_transform() = delete;
+
+        reference value() const noexcept {
+            return *m_value;
+        }
+
+        void rethrowIfFailed() {
+            if (m_exception) {
+                std::rethrow_exception(m_exception);
+            }
+        }
+
+    private:
+        pointer m_value = nullptr;
+        std::exception_ptr m_exception;
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /// @brief  The end marker.
+    struct Sentinel {};
+
+    /// @brief  The input iterator.
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = TGenerator::value_type;
+        using reference = TGenerator::reference;
+        using pointer = TGenerator::pointer;
+
+        Iterator() noexcept :
+                m_handle(nullptr) {
+            // empty
+        }
+
+        explicit Iterator(Handle handle) noexcept :
+                m_handle(handle) {
+            // empty
+        }
+
+        Iterator &operator ++ () {
+            m_handle.resume();
+            if (m_handle.done()) {
+                m_handle.promise().rethrowIfFailed();
+            }
+            return *this;
+        }
+
+        void operator ++ (int) {
+            ++(*this);
+        }
+
+        reference operator * () const noexcept {
+            return m_handle.promise().value();
+        }
+
+        pointer operator -> () const noexcept {
+            return std::addressof(operator*());
+        }
+
+        bool operator == (Sentinel) const noexcept {
+            return !m_handle || m_handle.done();
+        }
+
+        bool operator != (Sentinel rhs) const noexcept {
+            return !(*this == rhs);
+        }
+
+    private:
+        Handle m_handle;
+    };
+
+    /// @brief  The default class constructor, creates an empty generator.
+    TGenerator() noexcept;
+
+    /// @brief  The class constructor.
+    /// @param  handle  [in] The coroutine handle, the generator takes the ownership.
+    explicit TGenerator(Handle handle) noexcept;
+
+    /// @brief  The move constructor.
+    /// @param  rhs     [in] The generator to move from.
+    TGenerator(TGenerator &&rhs) noexcept;
+
+    /// @brief  The class destructor, destroys the coroutine frame.
+    ~TGenerator();
+
+    /// @brief  The move assignment operator.
+    /// @param  rhs     [in] The generator to move from.
+    /// @return The generator.
+    TGenerator &operator = (TGenerator &&rhs) noexcept;
+
+    /// @brief  Runs the coroutine to its first value, may be called once.
+    /// @return The iterator to the first value.
+    Iterator begin();
+
+    /// @brief  Returns the end marker.
+    /// @return The end marker.
+    Sentinel end() const noexcept;
+
+    // Copying is not allowed
+    TGenerator(const TGenerator &) = delete;
+    TGenerator &operator = (const TGenerator &) = delete;
+
+private:
+    Handle m_handle;
+};
+
+template <class T>
+inline TGenerator<T>::TGenerator() noexcept :
+        m_handle(nullptr) {
+    // empty
+}
+
+template <class T>
+inline TGenerator<T>::TGenerator(Handle handle) noexcept :
+        m_handle(handle) {
+    // empty
+}
+
+template <class T>
+inline TGenerator<T>::TGenerator(TGenerator &&rhs) noexcept :
+        m_handle(std::exchange(rhs.m_handle, nullptr)) {
+    // empty
+}
+
+template <class T>
+inline TGenerator<T>::~TGenerator() {
+    if (m_handle) {
+        m_handle.destroy();
+    }
+}
+
+template <class T>
+inline TGenerator<T> &TGenerator<T>::operator = (TGenerator &&rhs) noexcept {
+    if (this != &rhs) {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+        m_handle = std::exchange(rhs.m_handle, nullptr);
+    }
+
+    return *this;
+}
+
+template <class T>
+inline typename TGenerator<T>::Iterator TGenerator<T>::begin() {
+    if (m_handle) {
+        m_handle.resume();
+        if (m_handle.done()) {
+            m_handle.promise().rethrowIfFailed();
+        }
+    }
+
+    return Iterator(m_handle);
+}
+
+template <class T>
+inline typename TGenerator<T>::Sentinel TGenerator<T>::end() const noexcept {
+    return {};
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,421 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Async/FrameAllocator.h>
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+template <class T>
+class TTask;
+
+namespace Details {
+
+// Awaiting a task without a coroutine, e.g. a moved-from or default constructed one
+[[noreturn]] inline void throwEmptyTask() {
+    throw std::logic_error("TTask: the task is empty");
+}
+
+//-------------------------------------------------------------------------------------------------
+/// The common part of all task promises. The task starts suspended, at its end it transfers
+/// control to the awaiting coroutine directly, so long chains of tasks do not grow the stack.
+//-------------------------------------------------------------------------------------------------
+class TaskPromiseBase : public PooledFrame {
+public:
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <class TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().m_continuation;
+            if (continuation) {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {
+            // empty
+        }
+    };
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        m_exception = std::current_exception();
+    }
+
+    void setContinuation(std::coroutine_handle<> continuation) noexcept {
+        m_continuation = continuation;
+    }
+
+protected:
+    void rethrowIfFailed() {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_exception;
+};
+
+template <class T>
+class TTaskPromise : public TaskPromiseBase {
+public:
+    TTask<T> get_return_object() noexcept;
+
+    template <class U>
+    void return_value(U &&value) {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T &result() & {
+        rethrowIfFailed();
+        return *m_value;
+    }
+
+    T result() && {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class TTaskPromise<void> : public TaskPromiseBase {
+public:
+    TTask<void> get_return_object() noexcept;
+
+    void return_void() noexcept {
+        // empty
+    }
+
+    void result() {
+        rethrowIfFailed();
+    }
+};
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TTask
+///	@ingroup	CPPCore
+///
+///	@brief  A lazy coroutine task. The body does not run before the task is awaited, the awaiting
+/// coroutine is resumed by symmetric transfer once the task is done. Exceptions are rethrown to
+/// the awaiter. The frames come from the FrameAllocator. Use syncWait() to run a task from
+/// ordinary code. GCC needs -foptimize-sibling-calls to turn the transfer into a tail call in
+/// unoptimized builds.
+//-------------------------------------------------------------------------------------------------
+template <class T = void>
+class TTask {
+public:
+    using promise_type = Details::TTaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /// @brief  The awaiter returned by co_await.
+    template <bool IsRValue>
+    struct Awaiter {
+        Handle m_handle;
+
+        bool await_ready() const noexcept {
+            return !m_handle || m_handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+            m_handle.promise().setContinuation(awaiter);
+            return m_handle;
+        }
+
+        decltype(auto) await_resume() {
+            if (!m_handle) {
+                Details::throwEmptyTask();
+            }
+            if constexpr (IsRValue) {
+                return std::move(m_handle.promise()).result();
+            } else {
+                return m_handle.promise().result();
+            }
+        }
+    };
+
+    /// @brief  The default class constructor, creates an empty task.
+    TTask() noexcept;
+
+    /// @brief  The class constructor.
+    /// @param  handle  [in] The coroutine handle, the task takes the ownership.
+    explicit TTask(Handle handle) noexcept;
+
+    /// @brief  The move constructor.
+    /// @param  rhs     [in] The task to move from.
+    TTask(TTask &&rhs) noexcept;
+
+    /// @brief  The class destructor, destroys the coroutine frame.
+    ~TTask();
+
+    /// @brief  The move assignment operator.
+    /// @param  rhs     [in] The task to move from.
+    /// @return The task.
+    TTask &operator = (TTask &&rhs) noexcept;
+
+    /// @brief  Returns true, if the task has a coroutine.
+    /// @return true, if valid.
+    bool isValid() const noexcept;
+
+    /// @brief  Returns true, if the task has run to its end.
+    /// @return true, if done.
+    bool isReady() const noexcept;
+
+    /// @brief  Returns the coroutine handle.
+    /// @return The handle.
+    Handle getHandle() const noexcept;
+
+    /// @brief  Starts the task, the result is returned by reference.
+    Awaiter<false> operator co_await() & noexcept;
+
+    /// @brief  Starts the task, the result is moved out.
+    Awaiter<true> operator co_await() && noexcept;
+
+    // Copying is not allowed
+    TTask(const TTask &) = delete;
+    TTask &operator = (const TTask &) = delete;
+
+private:
+    Handle m_handle;
+};
+
+namespace Details {
+
+template <class T>
+inline TTask<T> TTaskPromise<T>::get_return_object() noexcept {
+    return TTask<T>(std::coroutine_handle<TTaskPromise<T>>::from_promise(*this));
+}
+
+inline TTask<void> TTaskPromise<void>::get_return_object() noexcept {
+    return TTask<void>(std::coroutine_handle<TTaskPromise<void>>::from_promise(*this));
+}
+
+// The helper coroutine of syncWait, it signals the waiting thread after it is suspended finally
+class SyncWaitState {
+public:
+    void set() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+        m_condition.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_done; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_done = false;
+};
+
+class SyncWaitTask {
+public:
+    struct promise_type : public PooledFrame {
+        SyncWaitState *m_state = nullptr;
+
+        SyncWaitTask get_return_object() noexcept {
+            return SyncWaitTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        auto final_suspend() noexcept {
+            struct Notifier {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    handle.promise().m_state->set();
+                }
+
+                void await_resume() noexcept {
+                    // empty
+                }
+            };
+            return Notifier{};
+        }
+
+        void return_void() noexcept {
+            // empty
+        }
+
+        void unhandled_exception() noexcept {
+            // The exception stays in the awaited task
+        }
+    };
+
+    explicit SyncWaitTask(std::coroutine_handle<promise_type> handle) noexcept :
+            m_handle(handle) {
+        // empty
+    }
+
+    SyncWaitTask(SyncWaitTask &&rhs) noexcept :
+            m_handle(std::exchange(rhs.m_handle, nullptr)) {
+        // empty
+    }
+
+    ~SyncWaitTask() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    void run(SyncWaitState &state) {
+        m_handle.promise().m_state = &state;
+        m_handle.resume();
+        state.wait();
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <class T>
+inline SyncWaitTask makeSyncWaitTask(TTask<T> &task) {
+    try {
+        (void) co_await task;
+    } catch (...) {
+        // Will be rethrown by syncWait
+    }
+}
+
+} // Namespace Details
+
+template <class T>
+inline TTask<T>::TTask() noexcept :
+        m_handle(nullptr) {
+    // empty
+}
+
+template <class T>
+inline TTask<T>::TTask(Handle handle) noexcept :
+        m_handle(handle) {
+    // empty
+}
+
+template <class T>
+inline TTask<T>::TTask(TTask &&rhs) noexcept :
+        m_handle(std::exchange(rhs.m_handle, nullptr)) {
+    // empty
+}
+
+template <class T>
+inline TTask<T>::~TTask() {
+    if (m_handle) {
+        m_handle.destroy();
+    }
+}
+
+template <class T>
+inline TTask<T> &TTask<T>::operator = (TTask &&rhs) noexcept {
+    if (this != &rhs) {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+        m_handle = std::exchange(rhs.m_handle, nullptr);
+    }
+
+    return *this;
+}
+
+template <class T>
+inline bool TTask<T>::isValid() const noexcept {
+    return static_cast<bool>(m_handle);
+}
+
+template <class T>
+inline bool TTask<T>::isReady() const noexcept {
+    return !m_handle || m_handle.done();
+}
+
+template <class T>
+inline typename TTask<T>::Handle TTask<T>::getHandle() const noexcept {
+    return m_handle;
+}
+
+template <class T>
+inline typename TTask<T>::template Awaiter<false> TTask<T>::operator co_await() & noexcept {
+    return Awaiter<false>{ m_handle };
+}
+
+template <class T>
+inline typename TTask<T>::template Awaiter<true> TTask<T>::operator co_await() && noexcept {
+    return Awaiter<true>{ m_handle };
+}
+
+/// @brief  Runs a task and blocks the calling thread until it is done. The task may continue on
+/// other threads meanwhile.
+/// @param  task    [in] The task to run.
+/// @return The result of the task, an exception of the task is rethrown. An empty task throws
+///         std::logic_error, as awaiting it does.
+template <class T>
+inline T syncWait(TTask<T> &&task) {
+    if (!task.isValid()) {
+        Details::throwEmptyTask();
+    }
+
+    Details::SyncWaitState state;
+    {
+        Details::SyncWaitTask waiter = Details::makeSyncWaitTask(task);
+        waiter.run(state);
+    }
+
+    if constexpr (std::is_void<T>::value) {
+        task.getHandle().promise().result();
+    } else {
+        return std::move(task.getHandle().promise()).result();
+    }
+}
+
+} // Namespace CPPCore
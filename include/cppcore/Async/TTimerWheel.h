@@ -0,0 +1,497 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Memory/TPoolAllocator.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TTimerWheel
+///	@ingroup	CPPCore
+///
+///	@brief  A hierarchical timing wheel for large numbers of timeouts. Time is counted in ticks
+/// chosen by the caller. Four levels of 256 slots cover 2^32 ticks, later timers circle in the
+/// last level. Level 0 holds the timers due within 256 ticks, a slot of a higher level is
+/// cascaded down whenever the level below wraps around, so every timer expires exactly at its
+/// tick.
+/// The timer nodes come from a TPoolAllocator and are recycled through a free list. Every node
+/// knows its slot and its position in it, so schedule and cancel are O(1). The slots are arrays
+/// of node pointers instead of linked lists, cascading and expiring walk them with prefetching
+/// instead of chasing one cache miss after the other. advance() expires all due timers
+/// batch-wise and jumps over empty slots of all levels by occupancy bitmaps.
+/// The wheel is owned by one thread. Other threads hand in timers by post(), which feeds a
+/// queue that the owner drains on every advance().
+/// @code
+/// TTimerWheel<Connection*> wheel;
+/// TTimerWheel<Connection*>::Handle handle = wheel.scheduleAfter(30000, connection);
+/// ...
+/// wheel.cancel(handle);
+/// ...
+/// wheel.advance(nowInMs, [](Connection *connection) { connection->timeout(); });
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TTimerWheel {
+    struct Node;
+
+public:
+    /// @brief  The number of bits per level.
+    static constexpr uint32_t LevelBits = 8;
+
+    /// @brief  The number of slots per level.
+    static constexpr uint32_t NumSlots = 1u << LevelBits;
+
+    /// @brief  The number of levels.
+    static constexpr uint32_t NumLevels = 4;
+
+    /// @brief  A handle to a scheduled timer. It stays safe to use after the timer expired.
+    class Handle {
+    public:
+        Handle() noexcept :
+                m_node(nullptr),
+                m_generation(0) {
+            // empty
+        }
+
+        bool isValid() const noexcept {
+            return nullptr != m_node;
+        }
+
+    private:
+        friend class TTimerWheel;
+
+        Handle(Node *node, uint32_t generation) noexcept :
+                m_node(node),
+                m_generation(generation) {
+            // empty
+        }
+
+        Node *m_node;
+        uint32_t m_generation;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  currentTick [in] The tick the wheel starts at.
+    /// @param  growSize    [in] The number of timer nodes the pool grows by.
+    explicit TTimerWheel(uint64_t currentTick = 0, size_t growSize = 4096);
+
+    /// @brief  The class destructor, pending timers are dropped.
+    ~TTimerWheel() = default;
+
+    /// @brief  Schedules a timer, owner thread only.
+    /// @param  expireTick  [in] The tick to expire at, past ticks expire on the next advance().
+    /// @param  payload     [in] The payload handed to the expiry function.
+    /// @return The timer handle.
+    Handle schedule(uint64_t expireTick, T payload);
+
+    /// @brief  Schedules a timer relative to the current tick, owner thread only.
+    /// @param  delay       [in] The delay in ticks.
+    /// @param  payload     [in] The payload handed to the expiry function.
+    /// @return The timer handle.
+    Handle scheduleAfter(uint64_t delay, T payload);
+
+    /// @brief  Cancels a timer, owner thread only. The handle is reset.
+    /// @param  handle      [inout] The timer handle.
+    /// @return true, if the timer was pending, false if it expired or was cancelled before.
+    bool cancel(Handle &handle);
+
+    /// @brief  Returns true, if the timer of the handle is pending.
+    /// @param  handle      [in] The timer handle.
+    /// @return true, if pending.
+    bool isPending(const Handle &handle) const;
+
+    /// @brief  Hands a timer in from any thread. It is scheduled by the next advance() and cannot
+    /// be cancelled.
+    /// @param  expireTick  [in] The tick to expire at.
+    /// @param  payload     [in] The payload handed to the expiry function.
+    void post(uint64_t expireTick, T payload);
+
+    /// @brief  Advances the wheel and expires all due timers, owner thread only. The expiry
+    /// function may schedule and cancel timers.
+    /// @param  now         [in] The current tick.
+    /// @param  func        [in] Called as func(T &payload) for every expired timer.
+    /// @return The number of expired timers.
+    template <class TFunc>
+    size_t advance(uint64_t now, TFunc func);
+
+    /// @brief  Returns the next tick at which advance() has work, an expiry or a cascade. This is
+    /// a lower bound for the next expiry.
+    /// @return The tick, the maximum value if no timer is pending.
+    uint64_t getNextExpiry() const;
+
+    /// @brief  Returns the last processed tick.
+    /// @return The current tick.
+    uint64_t getCurrentTick() const;
+
+    /// @brief  Returns the number of scheduled timers, posted ones are not counted yet.
+    /// @return The number of timers.
+    size_t size() const;
+
+    /// @brief  Returns true, if no timer is scheduled.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TTimerWheel)
+
+private:
+    static constexpr uint32_t SlotMask = NumSlots - 1;
+    static constexpr uint32_t NumWords = NumSlots / 64;
+    static constexpr uint32_t FreeSlot = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t ExpiringSlot = FreeSlot - 1;
+    static constexpr size_t PrefetchDistance = 8;
+
+    struct Node {
+        uint64_t m_expireTick;
+        uint32_t m_generation;
+        uint32_t m_slot;
+        size_t m_index;
+        Node *m_nextFree;
+        T m_payload;
+
+        Node() :
+                m_expireTick(0),
+                m_generation(0),
+                m_slot(FreeSlot),
+                m_index(0),
+                m_nextFree(nullptr),
+                m_payload() {
+            // empty
+        }
+    };
+
+    struct Posted {
+        uint64_t m_expireTick;
+        T m_payload;
+    };
+
+    Node *allocNode();
+    void freeNode(Node *node);
+    void addNode(Node *node);
+    void removeNode(Node *node);
+    void cascade(uint32_t level);
+    uint32_t findNextSlot(uint32_t level, uint32_t start) const;
+    uint64_t findNextTick() const;
+    void drainPosted();
+
+private:
+    std::vector<Node*> m_slots[NumLevels][NumSlots];
+    uint64_t m_occupied[NumLevels][NumWords];
+    std::vector<Node*> m_batch;
+    TPoolAllocator<Node> m_pool;
+    Node *m_freeList;
+    uint64_t m_nextTick;
+    size_t m_size;
+    std::atomic<bool> m_hasPosted;
+    SpinLock m_postLock;
+    std::vector<Posted> m_posted;
+    std::vector<Posted> m_draining;
+};
+
+template <class T>
+inline TTimerWheel<T>::TTimerWheel(uint64_t currentTick, size_t growSize) :
+        m_slots(),
+        m_occupied(),
+        m_batch(),
+        m_pool(0 == growSize ? 1 : growSize),
+        m_freeList(nullptr),
+        m_nextTick(currentTick + 1),
+        m_size(0),
+        m_hasPosted(false),
+        m_postLock(),
+        m_posted(),
+        m_draining() {
+    // empty
+}
+
+template <class T>
+inline typename TTimerWheel<T>::Node *TTimerWheel<T>::allocNode() {
+    Node *node = m_freeList;
+    if (nullptr != node) {
+        m_freeList = node->m_nextFree;
+        return node;
+    }
+
+    return m_pool.alloc();
+}
+
+template <class T>
+inline void TTimerWheel<T>::freeNode(Node *node) {
+    ++node->m_generation;
+    node->m_slot = FreeSlot;
+    node->m_payload = T();
+    node->m_nextFree = m_freeList;
+    m_freeList = node;
+}
+
+template <class T>
+inline void TTimerWheel<T>::addNode(Node *node) {
+    if (node->m_expireTick < m_nextTick) {
+        node->m_expireTick = m_nextTick;
+    }
+
+    // The level is chosen by the distance, the slot by the absolute tick
+    const uint64_t delta = node->m_expireTick - m_nextTick;
+    uint32_t level = 0;
+    while (level + 1 < NumLevels && delta >= (uint64_t(1) << (LevelBits * (level + 1)))) {
+        ++level;
+    }
+    const uint32_t index = static_cast<uint32_t>(node->m_expireTick >> (LevelBits * level)) & SlotMask;
+
+    std::vector<Node*> &slot = m_slots[level][index];
+    node->m_slot = level * NumSlots + index;
+    node->m_index = slot.size();
+    slot.push_back(node);
+    m_occupied[level][index / 64] |= uint64_t(1) << (index % 64);
+}
+
+template <class T>
+inline void TTimerWheel<T>::removeNode(Node *node) {
+    if (ExpiringSlot == node->m_slot) {
+        // The batch is running, just leave a hole
+        m_batch[node->m_index] = nullptr;
+        return;
+    }
+
+    const uint32_t level = node->m_slot / NumSlots;
+    const uint32_t index = node->m_slot % NumSlots;
+    std::vector<Node*> &slot = m_slots[level][index];
+    Node *last = slot.back();
+    slot[node->m_index] = last;
+    last->m_index = node->m_index;
+    slot.pop_back();
+    if (slot.empty()) {
+        m_occupied[level][index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+}
+
+template <class T>
+inline void TTimerWheel<T>::cascade(uint32_t level) {
+    const uint32_t index = static_cast<uint32_t>(m_nextTick >> (LevelBits * level)) & SlotMask;
+    m_batch.swap(m_slots[level][index]);
+    m_occupied[level][index / 64] &= ~(uint64_t(1) << (index % 64));
+
+    const size_t count = m_batch.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (i + PrefetchDistance < count) {
+            CPPCORE_PREFETCH(m_batch[i + PrefetchDistance]);
+        }
+        addNode(m_batch[i]);
+    }
+    m_batch.clear();
+
+    // The next level is due, when this one wrapped around as well
+    if (0 == index && level + 1 < NumLevels) {
+        cascade(level + 1);
+    }
+}
+
+template <class T>
+inline uint32_t TTimerWheel<T>::findNextSlot(uint32_t level, uint32_t start) const {
+    for (uint32_t word = start / 64; word < NumWords; ++word) {
+        uint64_t bits = m_occupied[level][word];
+        if (word == start / 64) {
+            bits &= ~uint64_t(0) << (start % 64);
+        }
+        if (0 != bits) {
+            return word * 64 + static_cast<uint32_t>(std::countr_zero(bits));
+        }
+    }
+
+    return NumSlots;
+}
+
+template <class T>
+inline uint64_t TTimerWheel<T>::findNextTick() const {
+    if (0 == m_size) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    // A slot of level L is visited at the ticks whose lower L * LevelBits bits are zero
+    uint64_t result = std::numeric_limits<uint64_t>::max();
+    for (uint32_t level = 0; level < NumLevels; ++level) {
+        const uint32_t shift = LevelBits * level;
+        const uint64_t step = uint64_t(1) << shift;
+        const uint64_t aligned = (m_nextTick + step - 1) & ~(step - 1);
+        const uint64_t rotation = aligned & ~((step << LevelBits) - 1);
+        const uint32_t start = static_cast<uint32_t>(aligned >> shift) & SlotMask;
+
+        uint64_t tick = 0;
+        uint32_t slot = findNextSlot(level, start);
+        if (slot < NumSlots) {
+            tick = rotation + (uint64_t(slot) << shift);
+        } else {
+            slot = findNextSlot(level, 0);
+            if (slot == NumSlots) {
+                continue;
+            }
+            tick = rotation + (step << LevelBits) + (uint64_t(slot) << shift);
+        }
+        if (tick < result) {
+            result = tick;
+        }
+    }
+
+    return result;
+}
+
+template <class T>
+inline void TTimerWheel<T>::drainPosted() {
+    if (!m_hasPosted.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    {
+        std::lock_guard<SpinLock> lock(m_postLock);
+        m_draining.swap(m_posted);
+        m_hasPosted.store(false, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_draining.size(); ++i) {
+        schedule(m_draining[i].m_expireTick, std::move(m_draining[i].m_payload));
+    }
+    m_draining.clear();
+}
+
+template <class T>
+inline typename TTimerWheel<T>::Handle TTimerWheel<T>::schedule(uint64_t expireTick, T payload) {
+    Node *node = allocNode();
+    node->m_expireTick = expireTick;
+    node->m_payload = std::move(payload);
+    addNode(node);
+    ++m_size;
+
+    return Handle(node, node->m_generation);
+}
+
+template <class T>
+inline typename TTimerWheel<T>::Handle TTimerWheel<T>::scheduleAfter(uint64_t delay, T payload) {
+    return schedule(m_nextTick - 1 + delay, std::move(payload));
+}
+
+template <class T>
+inline bool TTimerWheel<T>::cancel(Handle &handle) {
+    const bool pending = isPending(handle);
+    if (pending) {
+        removeNode(handle.m_node);
+        freeNode(handle.m_node);
+        --m_size;
+    }
+    handle = Handle();
+
+    return pending;
+}
+
+template <class T>
+inline bool TTimerWheel<T>::isPending(const Handle &handle) const {
+    return nullptr != handle.m_node && handle.m_generation == handle.m_node->m_generation &&
+           FreeSlot != handle.m_node->m_slot;
+}
+
+template <class T>
+inline void TTimerWheel<T>::post(uint64_t expireTick, T payload) {
+    std::lock_guard<SpinLock> lock(m_postLock);
+    m_posted.push_back(Posted{ expireTick, std::move(payload) });
+    m_hasPosted.store(true, std::memory_order_release);
+}
+
+template <class T>
+template <class TFunc>
+inline size_t TTimerWheel<T>::advance(uint64_t now, TFunc func) {
+    drainPosted();
+
+    size_t numExpired = 0;
+    while (m_nextTick <= now) {
+        // Jump straight to the next tick which has something to expire or to cascade
+        const uint64_t tick = findNextTick();
+        if (tick > now) {
+            m_nextTick = now + 1;
+            break;
+        }
+        m_nextTick = tick;
+
+        const uint32_t index = static_cast<uint32_t>(m_nextTick) & SlotMask;
+        if (0 == index) {
+            cascade(1);
+        }
+
+        // Move the due slot aside, so the callbacks may schedule and cancel freely
+        if (!m_slots[0][index].empty()) {
+            m_batch.swap(m_slots[0][index]);
+            m_occupied[0][index / 64] &= ~(uint64_t(1) << (index % 64));
+            for (size_t i = 0; i < m_batch.size(); ++i) {
+                if (i + PrefetchDistance < m_batch.size()) {
+                    CPPCORE_PREFETCH(m_batch[i + PrefetchDistance]);
+                }
+                m_batch[i]->m_slot = ExpiringSlot;
+                m_batch[i]->m_index = i;
+            }
+        }
+        ++m_nextTick;
+
+        for (size_t i = 0; i < m_batch.size(); ++i) {
+            Node *node = m_batch[i];
+            if (nullptr == node) {
+                continue;
+            }
+            T payload = std::move(node->m_payload);
+            freeNode(node);
+            --m_size;
+            ++numExpired;
+            func(payload);
+        }
+        m_batch.clear();
+    }
+
+    return numExpired;
+}
+
+template <class T>
+inline uint64_t TTimerWheel<T>::getNextExpiry() const {
+    return findNextTick();
+}
+
+template <class T>
+inline uint64_t TTimerWheel<T>::getCurrentTick() const {
+    return m_nextTick - 1;
+}
+
+template <class T>
+inline size_t TTimerWheel<T>::size() const {
+    return m_size;
+}
+
+template <class T>
+inline bool TTimerWheel<T>::isEmpty() const {
+    return 0 == m_size;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ThreadPool
+///	@ingroup	CPPCore
+///
+///	@brief  A FIFO executor for coroutines. Suspended coroutines are queued as plain handles, so
+/// posting does not allocate. A coroutine moves onto the pool by co_await pool.schedule().
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ThreadPool {
+public:
+    /// @brief  The awaiter returned by schedule().
+    class ScheduleAwaiter {
+    public:
+        explicit ScheduleAwaiter(ThreadPool &pool) noexcept :
+                m_pool(pool) {
+            // empty
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            m_pool.post(handle);
+        }
+
+        void await_resume() noexcept {
+            // empty
+        }
+
+    private:
+        ThreadPool &m_pool;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  numThreads  [in] The number of worker threads, 0 for the number of hardware threads.
+    explicit ThreadPool(size_t numThreads = 0);
+
+    /// @brief  The class destructor, runs the queued coroutines and joins the workers.
+    ~ThreadPool();
+
+    /// @brief  Queues a coroutine for resumption on a worker.
+    /// @param  handle  [in] The suspended coroutine.
+    void post(std::coroutine_handle<> handle);
+
+    /// @brief  Returns an awaitable which resumes the awaiting coroutine on a worker.
+    /// @return The awaitable.
+    ScheduleAwaiter schedule() noexcept;
+
+    /// @brief  Returns true, if the calling thread is a worker of this pool.
+    /// @return true, if on a worker.
+    bool isInPool() const noexcept;
+
+    /// @brief  Returns the number of worker threads.
+    /// @return The number of workers.
+    size_t getNumThreads() const noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ThreadPool)
+
+private:
+    void workerMain();
+
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<std::coroutine_handle<>> m_queue;
+    bool m_shutdown;
+};
+
+inline ThreadPool::ScheduleAwaiter ThreadPool::schedule() noexcept {
+    return ScheduleAwaiter(*this);
+}
+
+inline size_t ThreadPool::getNumThreads() const noexcept {
+    return m_threads.size();
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace CPPCore {
+
+class ThreadPool;
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TimerService
+///	@ingroup	CPPCore
+///
+///	@brief  Resumes coroutines after a delay. The timers are kept in a min-heap served by one
+/// background thread. Expired coroutines are posted to the given ThreadPool, without a pool they
+/// run on the timer thread and should hand over quickly.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief  The awaiter returned by sleepFor() and sleepUntil().
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(TimerService &service, Clock::time_point deadline) noexcept :
+                m_service(service),
+                m_deadline(deadline) {
+            // empty
+        }
+
+        bool await_ready() const noexcept {
+            return m_deadline <= Clock::now();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            m_service.add(m_deadline, handle);
+        }
+
+        void await_resume() noexcept {
+            // empty
+        }
+
+    private:
+        TimerService &m_service;
+        Clock::time_point m_deadline;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  pool    [in] The pool to resume the coroutines on, nullptr for the timer thread.
+    explicit TimerService(ThreadPool *pool = nullptr);
+
+    /// @brief  The class destructor, resumes all pending coroutines at once.
+    ~TimerService();
+
+    /// @brief  Returns an awaitable which resumes the awaiting coroutine after a delay.
+    /// @param  delay   [in] The delay.
+    /// @return The awaitable.
+    SleepAwaiter sleepFor(Clock::duration delay) noexcept;
+
+    /// @brief  Returns an awaitable which resumes the awaiting coroutine at a point in time.
+    /// @param  deadline    [in] The point in time.
+    /// @return The awaitable.
+    SleepAwaiter sleepUntil(Clock::time_point deadline) noexcept;
+
+    /// @brief  Returns the number of pending timers.
+    /// @return The number of timers.
+    size_t getNumPending();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TimerService)
+
+private:
+    struct Timer {
+        Clock::time_point m_deadline;
+        uint64_t m_sequence;
+        std::coroutine_handle<> m_handle;
+
+        // Earlier deadlines first, equal ones in submission order
+        bool operator < (const Timer &rhs) const {
+            if (m_deadline != rhs.m_deadline) {
+                return m_deadline > rhs.m_deadline;
+            }
+            return m_sequence > rhs.m_sequence;
+        }
+    };
+
+    void add(Clock::time_point deadline, std::coroutine_handle<> handle);
+    void resume(std::coroutine_handle<> handle);
+    void timerMain();
+
+private:
+    ThreadPool *m_pool;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::priority_queue<Timer> m_timers;
+    uint64_t m_sequence;
+    bool m_shutdown;
+    std::thread m_thread;
+};
+
+inline TimerService::SleepAwaiter TimerService::sleepFor(Clock::duration delay) noexcept {
+    return SleepAwaiter(*this, Clock::now() + delay);
+}
+
+inline TimerService::SleepAwaiter TimerService::sleepUntil(Clock::time_point deadline) noexcept {
+    return SleepAwaiter(*this, deadline);
+}
+
+} // Namespace CPPCore
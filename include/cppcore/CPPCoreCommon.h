@@ -29,6 +29,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stdio.h>
 #include <stdarg.h>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <xmmintrin.h>
+#endif
+
 namespace CPPCore {
 
 #if defined( _WIN32 ) || defined( _WIN64 )
@@ -56,6 +60,25 @@ namespace CPPCore {
 #   define DLL_CPPCORE_EXPORT __attribute__((visibility("default")))
 #endif
 
+#ifdef _MSC_VER
+#   define CPPCORE_NOINLINE __declspec(noinline)
+#else
+#   define CPPCORE_NOINLINE __attribute__((noinline))
+#endif
+
+/// @brief  Hints the CPU to load the cache line of an address for reading.
+#if defined(__GNUC__) || defined(__clang__)
+#   define CPPCORE_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <xmmintrin.h>
+#   define CPPCORE_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#   define CPPCORE_PREFETCH(addr) ((void)(addr))
+#endif
+
+/// @brief  The assumed size of a cache line, used to pad shared data against false sharing.
+static constexpr size_t CacheLineSize = 64;
+
 //-------------------------------------------------------------------------------------------------
 /// @fn ContainerClear
 ///
@@ -0,0 +1,578 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Common/Variant.h>
+#include <cppcore/Container/TStaticArray.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+namespace Details {
+
+    // The position of T in Ts, sizeof...(Ts) when T is not in the list
+    template <class T, class... Ts>
+    struct TTypeIndex;
+
+    template <class T>
+    struct TTypeIndex<T> : std::integral_constant<size_t, 0> {};
+
+    template <class T, class First, class... Rest>
+    struct TTypeIndex<T, First, Rest...> : std::integral_constant<size_t,
+            std::is_same_v<T, First> ? 0 : 1 + TTypeIndex<T, Rest...>::value> {};
+
+    template <size_t Index, class... Ts>
+    using TTypeAt = std::tuple_element_t<Index, std::tuple<Ts...>>;
+
+    template <class T, class... Ts>
+    concept OneOfTypes = (std::is_same_v<T, Ts> || ...);
+
+    // The trivial copy subsumes the plain copy, so the defaulted members win when both apply
+    template <class... Ts>
+    concept CopyableTypes = (std::is_copy_constructible_v<Ts> && ...) && (std::is_copy_assignable_v<Ts> && ...);
+
+    template <class... Ts>
+    concept TriviallyCopyableTypes = CopyableTypes<Ts...> && (std::is_trivially_copyable_v<Ts> && ...);
+
+    template <class... Ts>
+    struct TIsUniqueTypeList : std::true_type {};
+
+    template <class First, class... Rest>
+    struct TIsUniqueTypeList<First, Rest...> : std::bool_constant<
+            (!std::is_same_v<First, Rest> && ...) && TIsUniqueTypeList<Rest...>::value> {};
+
+    // Calls func with std::integral_constant<size_t, index> through a table of function pointers,
+    // a single indirect jump instead of an if chain per type
+    template <class TResult, size_t Index, class TFunc>
+    TResult invokeWithIndex(TFunc &func) {
+        return func(std::integral_constant<size_t, Index>());
+    }
+
+    template <class TResult, class TFunc, size_t... Indices>
+    inline TResult dispatchIndex(size_t index, TFunc &func, std::index_sequence<Indices...>) {
+        using Entry = TResult (*)(TFunc &);
+        static constexpr Entry Table[] = { &invokeWithIndex<TResult, Indices, TFunc>... };
+        return Table[index](func);
+    }
+
+    // The types which have a counterpart in the legacy Variant
+    template <class T>
+    struct TLegacyVariantTraits {
+        static constexpr Variant::Type LegacyType = Variant::None;
+    };
+
+    template <>
+    struct TLegacyVariantTraits<unsigned char> {
+        static constexpr Variant::Type LegacyType = Variant::Byte;
+        static void store(unsigned char value, Variant &variant) { variant.setByte(value); }
+        static unsigned char load(const Variant &variant) { return variant.getByte(); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<int> {
+        static constexpr Variant::Type LegacyType = Variant::Int;
+        static void store(int value, Variant &variant) { variant.setInt(value); }
+        static int load(const Variant &variant) { return variant.getInt(); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<float> {
+        static constexpr Variant::Type LegacyType = Variant::Float;
+        static void store(float value, Variant &variant) { variant.setFloat(value); }
+        static float load(const Variant &variant) { return variant.getFloat(); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<bool> {
+        static constexpr Variant::Type LegacyType = Variant::Boolean;
+        static void store(bool value, Variant &variant) { variant.setBool(value); }
+        static bool load(const Variant &variant) { return variant.getBool(); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<std::string> {
+        static constexpr Variant::Type LegacyType = Variant::String;
+        static void store(const std::string &value, Variant &variant) { variant.setStdString(value); }
+        static std::string load(const Variant &variant) { return variant.getString(); }
+    };
+
+    template <class T, size_t len>
+    inline TStaticArray<T, len> loadLegacyArray(const T *data) {
+        TStaticArray<T, len> result;
+        for (size_t i = 0; i < len; ++i) {
+            result.m_array[i] = data[i];
+        }
+        return result;
+    }
+
+    template <>
+    struct TLegacyVariantTraits<TStaticArray<int, 3>> {
+        static constexpr Variant::Type LegacyType = Variant::Int3;
+        static void store(const TStaticArray<int, 3> &value, Variant &variant) { variant.setInt3(value[0], value[1], value[2]); }
+        static TStaticArray<int, 3> load(const Variant &variant) { return loadLegacyArray<int, 3>(variant.getInt3()); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<TStaticArray<int, 4>> {
+        static constexpr Variant::Type LegacyType = Variant::Int4;
+        static void store(const TStaticArray<int, 4> &value, Variant &variant) { variant.setInt4(value[0], value[1], value[2], value[3]); }
+        static TStaticArray<int, 4> load(const Variant &variant) { return loadLegacyArray<int, 4>(variant.getInt4()); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<TStaticArray<float, 3>> {
+        static constexpr Variant::Type LegacyType = Variant::Float3;
+        static void store(const TStaticArray<float, 3> &value, Variant &variant) { variant.setFloat3(value[0], value[1], value[2]); }
+        static TStaticArray<float, 3> load(const Variant &variant) { return loadLegacyArray<float, 3>(variant.getFloat3()); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<TStaticArray<float, 4>> {
+        static constexpr Variant::Type LegacyType = Variant::Float4;
+        static void store(const TStaticArray<float, 4> &value, Variant &variant) { variant.setFloat4(value[0], value[1], value[2], value[3]); }
+        static TStaticArray<float, 4> load(const Variant &variant) { return loadLegacyArray<float, 4>(variant.getFloat4()); }
+    };
+
+    template <>
+    struct TLegacyVariantTraits<TStaticArray<float, 16>> {
+        static constexpr Variant::Type LegacyType = Variant::Float4x4;
+        static void store(const TStaticArray<float, 16> &value, Variant &variant) {
+            // setFloat4x4 only reads, but takes a mutable pointer
+            TStaticArray<float, 16> copy = value;
+            variant.setFloat4x4(copy.m_array);
+        }
+        static TStaticArray<float, 16> load(const Variant &variant) { return loadLegacyArray<float, 16>(variant.getFloat4x4()); }
+    };
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TVariant
+///	@ingroup	CPPCore
+///
+///	@brief  A variant over a fixed list of types, checked at compile time. The value is stored
+///	inline without heap allocations, the index of the type is a compile-time constant per type and
+///	visit() dispatches through a jump table. A default constructed variant is empty.
+///	fromVariant() and toVariant() convert from and to the legacy Variant.
+//-------------------------------------------------------------------------------------------------
+template <class... Ts>
+class TVariant {
+    static_assert(0 < sizeof...(Ts), "TVariant needs at least one type");
+    static_assert(Details::TIsUniqueTypeList<Ts...>::value, "The types of a TVariant must be unique");
+    static_assert(((!std::is_reference_v<Ts> && !std::is_array_v<Ts> && !std::is_void_v<Ts>) && ...),
+            "TVariant can only store object types");
+
+    static constexpr bool IsNothrowMovable = (std::is_nothrow_move_constructible_v<Ts> && ...) &&
+            (std::is_nothrow_move_assignable_v<Ts> && ...);
+    static constexpr bool IsTriviallyDestructible = (std::is_trivially_destructible_v<Ts> && ...);
+    static constexpr size_t StorageSize = std::max({ sizeof(Ts)... });
+
+    using IndexType = std::conditional_t<(sizeof...(Ts) < 255), uint8_t, uint16_t>;
+
+public:
+    /// @brief  The number of types.
+    static constexpr size_t NumTypes = sizeof...(Ts);
+
+    /// @brief  The index of an empty variant.
+    static constexpr size_t NoIndex = NumTypes;
+
+    /// @brief  The index of the type T, a compile-time constant.
+    template <class T>
+    static constexpr size_t IndexOf = Details::TTypeIndex<T, Ts...>::value;
+
+    /// @brief  The type at an index.
+    template <size_t Index>
+    using TypeAt = Details::TTypeAt<Index, Ts...>;
+
+    /// @brief  The class constructor, the variant is empty.
+    TVariant();
+
+    /// @brief  The class constructor with a value of one of the types.
+    /// @param  value   [in] The value.
+    template <class T>
+    requires Details::OneOfTypes<std::remove_cvref_t<T>, Ts...>
+    TVariant(T &&value);
+
+    /// @brief  The copy constructors, trivial when all types are trivially copyable and missing
+    ///         when one type cannot be copied.
+    TVariant(const TVariant &rhs) requires Details::TriviallyCopyableTypes<Ts...> = default;
+    TVariant(const TVariant &rhs) requires Details::CopyableTypes<Ts...>;
+
+    /// @brief  The move constructors, the moved-from variant keeps its type.
+    TVariant(TVariant &&rhs) noexcept requires Details::TriviallyCopyableTypes<Ts...> = default;
+    TVariant(TVariant &&rhs) noexcept(IsNothrowMovable);
+
+    /// @brief  The class destructor.
+    ~TVariant() requires IsTriviallyDestructible = default;
+    ~TVariant();
+
+    /// @brief  Returns the index of the stored type.
+    /// @return The index, NoIndex for an empty variant.
+    size_t getIndex() const;
+
+    /// @brief  Returns true when no value is stored.
+    /// @return true for an empty variant.
+    bool isEmpty() const;
+
+    /// @brief  Returns true when a value of type T is stored.
+    /// @return true for a T.
+    template <class T>
+    bool is() const;
+
+    /// @brief  Constructs a new value in place, the old value is destroyed.
+    /// @param  args    [in] The arguments for the constructor of T.
+    /// @return The new value.
+    template <class T, class... TArgs>
+    T &emplace(TArgs &&...args);
+
+    /// @brief  Will set a new value, a value of the same type is assigned directly.
+    /// @param  value   [in] The new value.
+    template <class T>
+    requires Details::OneOfTypes<std::remove_cvref_t<T>, Ts...>
+    void set(T &&value);
+
+    /// @brief  Returns the stored value, the type must match.
+    /// @return The value.
+    template <class T>
+    T &get();
+
+    template <class T>
+    const T &get() const;
+
+    /// @brief  Returns a pointer to the stored value.
+    /// @return The value or nullptr when another type is stored.
+    template <class T>
+    T *getIf();
+
+    template <class T>
+    const T *getIf() const;
+
+    /// @brief  Calls the visitor with the stored value, the variant must not be empty. All calls
+    ///         must return the same type.
+    /// @param  visitor [in] A callable for all types, like a generic lambda.
+    /// @return The result of the visitor.
+    template <class TVisitor>
+    decltype(auto) visit(TVisitor &&visitor);
+
+    template <class TVisitor>
+    decltype(auto) visit(TVisitor &&visitor) const;
+
+    /// @brief  Destroys the stored value, the variant is empty afterwards.
+    void clear();
+
+    /// @brief  Will set the value from a legacy Variant.
+    /// @param  variant [in] The legacy variant, an empty one clears the instance.
+    /// @return false when the type of the legacy variant is not in the type list.
+    bool fromVariant(const Variant &variant);
+
+    /// @brief  Will store the value into a legacy Variant.
+    /// @param  variant [out] The legacy variant, cleared for an empty instance.
+    /// @return false when the stored type has no counterpart in the legacy Variant.
+    bool toVariant(Variant &variant) const;
+
+    /// @brief  Operator implementations.
+    TVariant &operator=(const TVariant &rhs) requires Details::TriviallyCopyableTypes<Ts...> = default;
+    TVariant &operator=(const TVariant &rhs) requires Details::CopyableTypes<Ts...>;
+    TVariant &operator=(TVariant &&rhs) noexcept requires Details::TriviallyCopyableTypes<Ts...> = default;
+    TVariant &operator=(TVariant &&rhs) noexcept(IsNothrowMovable);
+    bool operator==(const TVariant &rhs) const;
+
+private:
+    template <class T>
+    T *getPointer();
+
+    template <class T>
+    const T *getPointer() const;
+
+    template <class TFunc>
+    decltype(auto) dispatch(TFunc &func) const;
+
+    void copyFrom(const TVariant &rhs);
+    void moveFrom(TVariant &rhs);
+
+private:
+    alignas(Ts...) unsigned char m_storage[StorageSize];
+    IndexType m_index;
+};
+
+template <class... Ts>
+inline TVariant<Ts...>::TVariant() :
+        m_index(static_cast<IndexType>(NoIndex)) {
+    // empty
+}
+
+template <class... Ts>
+template <class T>
+requires Details::OneOfTypes<std::remove_cvref_t<T>, Ts...>
+inline TVariant<Ts...>::TVariant(T &&value) :
+        m_index(static_cast<IndexType>(NoIndex)) {
+    emplace<std::remove_cvref_t<T>>(std::forward<T>(value));
+}
+
+template <class... Ts>
+inline TVariant<Ts...>::TVariant(const TVariant &rhs) requires Details::CopyableTypes<Ts...> :
+        m_index(static_cast<IndexType>(NoIndex)) {
+    copyFrom(rhs);
+}
+
+template <class... Ts>
+inline TVariant<Ts...>::TVariant(TVariant &&rhs) noexcept(IsNothrowMovable) :
+        m_index(static_cast<IndexType>(NoIndex)) {
+    moveFrom(rhs);
+}
+
+template <class... Ts>
+inline TVariant<Ts...>::~TVariant() {
+    clear();
+}
+
+template <class... Ts>
+inline size_t TVariant<Ts...>::getIndex() const {
+    return m_index;
+}
+
+template <class... Ts>
+inline bool TVariant<Ts...>::isEmpty() const {
+    return NoIndex == m_index;
+}
+
+template <class... Ts>
+template <class T>
+inline bool TVariant<Ts...>::is() const {
+    static_assert(NoIndex != IndexOf<T>, "T is not a type of the variant");
+    return IndexOf<T> == m_index;
+}
+
+template <class... Ts>
+template <class T, class... TArgs>
+inline T &TVariant<Ts...>::emplace(TArgs &&...args) {
+    static_assert(NoIndex != IndexOf<T>, "T is not a type of the variant");
+    clear();
+    T *value = ::new (static_cast<void *>(m_storage)) T(std::forward<TArgs>(args)...);
+    m_index = static_cast<IndexType>(IndexOf<T>);
+
+    return *value;
+}
+
+template <class... Ts>
+template <class T>
+requires Details::OneOfTypes<std::remove_cvref_t<T>, Ts...>
+inline void TVariant<Ts...>::set(T &&value) {
+    using Type = std::remove_cvref_t<T>;
+    if (is<Type>()) {
+        *getPointer<Type>() = std::forward<T>(value);
+    } else {
+        emplace<Type>(std::forward<T>(value));
+    }
+}
+
+template <class... Ts>
+template <class T>
+inline T &TVariant<Ts...>::get() {
+    assert(is<T>());
+    return *getPointer<T>();
+}
+
+template <class... Ts>
+template <class T>
+inline const T &TVariant<Ts...>::get() const {
+    assert(is<T>());
+    return *getPointer<T>();
+}
+
+template <class... Ts>
+template <class T>
+inline T *TVariant<Ts...>::getIf() {
+    return is<T>() ? getPointer<T>() : nullptr;
+}
+
+template <class... Ts>
+template <class T>
+inline const T *TVariant<Ts...>::getIf() const {
+    return is<T>() ? getPointer<T>() : nullptr;
+}
+
+template <class... Ts>
+template <class TVisitor>
+inline decltype(auto) TVariant<Ts...>::visit(TVisitor &&visitor) {
+    assert(!isEmpty());
+    auto call = [this, &visitor](auto index) -> decltype(auto) {
+        return visitor(*getPointer<TypeAt<decltype(index)::value>>());
+    };
+    return dispatch(call);
+}
+
+template <class... Ts>
+template <class TVisitor>
+inline decltype(auto) TVariant<Ts...>::visit(TVisitor &&visitor) const {
+    assert(!isEmpty());
+    auto call = [this, &visitor](auto index) -> decltype(auto) {
+        return visitor(*getPointer<TypeAt<decltype(index)::value>>());
+    };
+    return dispatch(call);
+}
+
+template <class... Ts>
+inline void TVariant<Ts...>::clear() {
+    if (isEmpty()) {
+        return;
+    }
+
+    if constexpr (!IsTriviallyDestructible) {
+        auto destroy = [this](auto index) {
+            using Type = TypeAt<decltype(index)::value>;
+            getPointer<Type>()->~Type();
+        };
+        dispatch(destroy);
+    }
+    m_index = static_cast<IndexType>(NoIndex);
+}
+
+template <class... Ts>
+inline bool TVariant<Ts...>::fromVariant(const Variant &variant) {
+    const Variant::Type type = variant.getType();
+    if (Variant::None == type) {
+        clear();
+        return true;
+    }
+
+    // Tries every type with a legacy counterpart until one matches
+    return ([this, &variant, type]() {
+        using Traits = Details::TLegacyVariantTraits<Ts>;
+        if constexpr (Variant::None != Traits::LegacyType) {
+            if (Traits::LegacyType == type) {
+                set(Traits::load(variant));
+                return true;
+            }
+        }
+        return false;
+    }() || ...);
+}
+
+template <class... Ts>
+inline bool TVariant<Ts...>::toVariant(Variant &variant) const {
+    if (isEmpty()) {
+        variant.clear();
+        return true;
+    }
+
+    return visit([&variant](const auto &value) {
+        using Traits = Details::TLegacyVariantTraits<std::remove_cvref_t<decltype(value)>>;
+        if constexpr (Variant::None != Traits::LegacyType) {
+            Traits::store(value, variant);
+            return true;
+        } else {
+            return false;
+        }
+    });
+}
+
+template <class... Ts>
+inline TVariant<Ts...> &TVariant<Ts...>::operator=(const TVariant &rhs) requires Details::CopyableTypes<Ts...> {
+    if (this != &rhs) {
+        copyFrom(rhs);
+    }
+
+    return *this;
+}
+
+template <class... Ts>
+inline TVariant<Ts...> &TVariant<Ts...>::operator=(TVariant &&rhs) noexcept(IsNothrowMovable) {
+    if (this != &rhs) {
+        moveFrom(rhs);
+    }
+
+    return *this;
+}
+
+template <class... Ts>
+inline bool TVariant<Ts...>::operator==(const TVariant &rhs) const {
+    if (m_index != rhs.m_index) {
+        return false;
+    }
+    if (isEmpty()) {
+        return true;
+    }
+
+    return visit([&rhs](const auto &value) {
+        using Type = std::remove_cvref_t<decltype(value)>;
+        return value == *rhs.template getPointer<Type>();
+    });
+}
+
+template <class... Ts>
+template <class T>
+inline T *TVariant<Ts...>::getPointer() {
+    return std::launder(reinterpret_cast<T *>(m_storage));
+}
+
+template <class... Ts>
+template <class T>
+inline const T *TVariant<Ts...>::getPointer() const {
+    return std::launder(reinterpret_cast<const T *>(m_storage));
+}
+
+template <class... Ts>
+template <class TFunc>
+inline decltype(auto) TVariant<Ts...>::dispatch(TFunc &func) const {
+    using Result = decltype(func(std::integral_constant<size_t, 0>()));
+    return Details::dispatchIndex<Result>(m_index, func, std::index_sequence_for<Ts...>());
+}
+
+template <class... Ts>
+inline void TVariant<Ts...>::copyFrom(const TVariant &rhs) {
+    if (rhs.isEmpty()) {
+        clear();
+        return;
+    }
+
+    auto copy = [this, &rhs](auto index) {
+        using Type = TypeAt<decltype(index)::value>;
+        set(*rhs.template getPointer<Type>());
+    };
+    rhs.dispatch(copy);
+}
+
+template <class... Ts>
+inline void TVariant<Ts...>::moveFrom(TVariant &rhs) {
+    if (rhs.isEmpty()) {
+        clear();
+        return;
+    }
+
+    auto moveValue = [this, &rhs](auto index) {
+        using Type = TypeAt<decltype(index)::value>;
+        set(std::move(*rhs.template getPointer<Type>()));
+    };
+    rhs.dispatch(moveValue);
+}
+
+} // Namespace CPPCore
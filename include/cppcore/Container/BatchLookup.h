@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace CPPCore {
+
+namespace Details {
+
+    // The number of lookups in flight, enough to cover the DRAM latency with the line fill
+    // buffers of current cores
+    constexpr size_t BatchLookupGroupSize = 16;
+
+    //---------------------------------------------------------------------------------------------
+    // Runs lookups with group prefetching. The keys are processed in groups, every stage runs for
+    // all keys of a group before the next one starts. A stage reads what the previous stage
+    // prefetched and prefetches the data for the next one, so the cache misses of a group overlap
+    // instead of stalling one after another. Every stage is called as stage(index, state).
+    //---------------------------------------------------------------------------------------------
+    template <class TState, class... TStages>
+    inline void runBatchLookup(size_t count, TStages... stages) {
+        TState states[BatchLookupGroupSize];
+        for (size_t begin = 0; begin < count; begin += BatchLookupGroupSize) {
+            const size_t groupSize = std::min(BatchLookupGroupSize, count - begin);
+            ([&] {
+                for (size_t i = 0; i < groupSize; ++i) {
+                    stages(begin + i, states[i]);
+                }
+            }(), ...);
+        }
+    }
+
+} // Namespace Details
+
+} // Namespace CPPCore
@@ -396,7 +396,7 @@ inline void TArray<T, TAlloc>::resize(size_t size) {
 
     // Store older items
     if (m_Size > 0 && m_Capacity < size) {
-        pTmp = mAllocator.alloc(m_Size * sizeof(T));
+        pTmp = mAllocator.alloc(m_Size);
         for (size_t i = 0; i < m_Size; ++i) {
             pTmp[i] = m_pData[i];
         }
@@ -408,7 +408,7 @@ inline void TArray<T, TAlloc>::resize(size_t size) {
 
     // Realloc memory
     if (size > m_Capacity) {
-        m_pData = mAllocator.alloc(size * sizeof(T));
+        m_pData = mAllocator.alloc(size);
         if (pTmp) {
             for (size_t i = 0; i < oldSize; ++i) {
                 m_pData[i] = pTmp[i];
@@ -0,0 +1,623 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Container/TArray.h>
+#include <cppcore/Container/TStaticArray.h>
+#include <cppcore/Parallel/ParallelAlgorithms.h>
+#include <cppcore/Platform/VectorKernels.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+/// @brief  The settings for evaluating array expressions.
+struct ExpressionOptions {
+    size_t m_parallelThreshold;     ///< Expressions with at least this many items run in parallel, SIZE_MAX never.
+    size_t m_grainSize;             ///< The items per chunk, reductions always combine the chunks in order.
+    TaskScheduler *m_scheduler;     ///< The scheduler for parallel runs, nullptr for the default one.
+
+    ExpressionOptions() :
+            m_parallelThreshold(1 << 18),
+            m_grainSize(DefaultGrainSize),
+            m_scheduler(nullptr) {
+        // empty
+    }
+};
+
+/// @brief  Matches the nodes of array expressions.
+template <class E>
+concept ArrayExpression = requires {
+    std::remove_cvref_t<E>::IsArrayExpression;
+};
+
+namespace Details {
+
+    // A select without control flow, a conditional on floats would stop the vectorizer as the
+    // compiler must assume that the operations may trap
+    template <class T>
+    constexpr T select(bool mask, T onTrue, T onFalse) {
+        if constexpr (std::is_floating_point_v<T> && (4 == sizeof(T) || 8 == sizeof(T))) {
+            using Bits = std::conditional_t<4 == sizeof(T), uint32_t, uint64_t>;
+            const Bits bits = Bits(0) - static_cast<Bits>(mask);
+            return std::bit_cast<T>(static_cast<Bits>((std::bit_cast<Bits>(onTrue) & bits) | (std::bit_cast<Bits>(onFalse) & ~bits)));
+        } else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+            using Bits = std::make_unsigned_t<T>;
+            const Bits bits = Bits(0) - static_cast<Bits>(mask);
+            return static_cast<T>((static_cast<Bits>(onTrue) & bits) | (static_cast<Bits>(onFalse) & static_cast<Bits>(~bits)));
+        } else {
+            return mask ? onTrue : onFalse;
+        }
+    }
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TArrayReference
+///	@ingroup	CPPCore
+///
+///	@brief  The leaf of an array expression, a view to the items of an array. Create it with lazy().
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TArrayReference {
+public:
+    static constexpr bool IsArrayExpression = true;
+    using ValueType = T;
+
+    constexpr TArrayReference(const T *data, size_t size) :
+            m_data(data),
+            m_size(size) {
+        // empty
+    }
+
+    constexpr size_t size() const {
+        return m_size;
+    }
+
+    constexpr T operator[](size_t index) const {
+        return m_data[index];
+    }
+
+    constexpr const T *data() const {
+        return m_data;
+    }
+
+private:
+    const T *m_data;
+    size_t m_size;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TScalarExpression
+///	@ingroup	CPPCore
+///
+///	@brief  A scalar in an array expression, it has the same value for every index.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TScalarExpression {
+public:
+    static constexpr bool IsArrayExpression = true;
+    using ValueType = T;
+
+    constexpr explicit TScalarExpression(T value) :
+            m_value(value) {
+        // empty
+    }
+
+    /// @brief  Scalars fit any size.
+    constexpr size_t size() const {
+        return 0;
+    }
+
+    constexpr T operator[](size_t) const {
+        return m_value;
+    }
+
+private:
+    T m_value;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TUnaryExpression
+///	@ingroup	CPPCore
+///
+///	@brief  Applies TOp to every item of an expression.
+//-------------------------------------------------------------------------------------------------
+template <class TOp, class TExpr>
+class TUnaryExpression {
+public:
+    static constexpr bool IsArrayExpression = true;
+    using ValueType = decltype(TOp::apply(std::declval<typename TExpr::ValueType>()));
+
+    constexpr explicit TUnaryExpression(const TExpr &expr) :
+            m_expr(expr) {
+        // empty
+    }
+
+    constexpr size_t size() const {
+        return m_expr.size();
+    }
+
+    constexpr ValueType operator[](size_t index) const {
+        return TOp::apply(m_expr[index]);
+    }
+
+private:
+    TExpr m_expr;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TBinaryExpression
+///	@ingroup	CPPCore
+///
+///	@brief  Combines the items of two expressions of the same size with TOp.
+//-------------------------------------------------------------------------------------------------
+template <class TOp, class TLeft, class TRight>
+class TBinaryExpression {
+public:
+    static constexpr bool IsArrayExpression = true;
+    using ValueType = decltype(TOp::apply(std::declval<typename TLeft::ValueType>(), std::declval<typename TRight::ValueType>()));
+
+    constexpr TBinaryExpression(const TLeft &left, const TRight &right) :
+            m_left(left),
+            m_right(right) {
+        assert(0 == left.size() || 0 == right.size() || left.size() == right.size());
+    }
+
+    constexpr size_t size() const {
+        return 0 != m_left.size() ? m_left.size() : m_right.size();
+    }
+
+    constexpr ValueType operator[](size_t index) const {
+        return TOp::apply(m_left[index], m_right[index]);
+    }
+
+    constexpr const TLeft &getLeft() const {
+        return m_left;
+    }
+
+    constexpr const TRight &getRight() const {
+        return m_right;
+    }
+
+private:
+    TLeft m_left;
+    TRight m_right;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TWhereExpression
+///	@ingroup	CPPCore
+///
+///	@brief  Selects per index the item of the first or the second expression by a mask.
+//-------------------------------------------------------------------------------------------------
+template <class TMask, class TTrue, class TFalse>
+class TWhereExpression {
+public:
+    static constexpr bool IsArrayExpression = true;
+    using ValueType = std::common_type_t<typename TTrue::ValueType, typename TFalse::ValueType>;
+
+    constexpr TWhereExpression(const TMask &mask, const TTrue &onTrue, const TFalse &onFalse) :
+            m_mask(mask),
+            m_true(onTrue),
+            m_false(onFalse) {
+        // empty
+    }
+
+    constexpr size_t size() const {
+        return 0 != m_mask.size() ? m_mask.size() : (0 != m_true.size() ? m_true.size() : m_false.size());
+    }
+
+    constexpr ValueType operator[](size_t index) const {
+        return Details::select(m_mask[index], static_cast<ValueType>(m_true[index]), static_cast<ValueType>(m_false[index]));
+    }
+
+private:
+    TMask m_mask;
+    TTrue m_true;
+    TFalse m_false;
+};
+
+namespace Details {
+
+    // The same number of lanes as VectorKernels, so both sum in the same order
+    constexpr size_t ExpressionLanes = 32;
+
+    struct AddOp {
+        template <class A, class B>
+        static constexpr auto apply(A a, B b) { return a + b; }
+    };
+
+    struct SubOp {
+        template <class A, class B>
+        static constexpr auto apply(A a, B b) { return a - b; }
+    };
+
+    struct MulOp {
+        template <class A, class B>
+        static constexpr auto apply(A a, B b) { return a * b; }
+    };
+
+    struct DivOp {
+        template <class A, class B>
+        static constexpr auto apply(A a, B b) { return a / b; }
+    };
+
+    struct LessOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a < b; }
+    };
+
+    struct LessEqualOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a <= b; }
+    };
+
+    struct GreaterOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a > b; }
+    };
+
+    struct GreaterEqualOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a >= b; }
+    };
+
+    struct EqualOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a == b; }
+    };
+
+    struct NotEqualOp {
+        template <class A, class B>
+        static constexpr bool apply(A a, B b) { return a != b; }
+    };
+
+    struct AndOp {
+        static constexpr bool apply(bool a, bool b) { return a & b; }
+    };
+
+    struct OrOp {
+        static constexpr bool apply(bool a, bool b) { return a | b; }
+    };
+
+    struct MinOp {
+        template <class A, class B>
+        static constexpr std::common_type_t<A, B> apply(A a, B b) { return b < a ? b : a; }
+    };
+
+    struct MaxOp {
+        template <class A, class B>
+        static constexpr std::common_type_t<A, B> apply(A a, B b) { return a < b ? b : a; }
+    };
+
+    struct NegateOp {
+        template <class A>
+        static constexpr auto apply(A a) { return -a; }
+    };
+
+    struct NotOp {
+        static constexpr bool apply(bool a) { return !a; }
+    };
+
+    struct AbsOp {
+        template <class A>
+        static constexpr A apply(A a) { return a < A(0) ? A(-a) : a; }
+    };
+
+    // A scalar next to a floating point expression takes its type, so float math stays float.
+    // Next to an integer expression it gets the common type, so lazy(ints) * 0.5 keeps its factor
+    template <class V, class S>
+    using TScalarType = std::conditional_t<std::is_floating_point_v<V>, V, std::common_type_t<V, S>>;
+
+    template <class TExpr, class S>
+    constexpr TScalarExpression<TScalarType<typename TExpr::ValueType, S>> makeScalar(S value) {
+        using Scalar = TScalarType<typename TExpr::ValueType, S>;
+        return TScalarExpression<Scalar>(static_cast<Scalar>(value));
+    }
+
+    template <class TExpr>
+    constexpr const TExpr &asExpression(const TExpr &expr) requires ArrayExpression<TExpr> {
+        return expr;
+    }
+
+    template <class S>
+    constexpr TScalarExpression<S> asExpression(S value) requires std::is_arithmetic_v<S> {
+        return TScalarExpression<S>(value);
+    }
+
+    // Scalars next to an expression get their type from makeScalar
+    template <class TOther, class TExpr>
+    constexpr const TExpr &asOperand(const TExpr &expr) requires ArrayExpression<TExpr> {
+        return expr;
+    }
+
+    template <class TOther, class S>
+    constexpr auto asOperand(S value) requires std::is_arithmetic_v<S> {
+        return makeScalar<TOther>(value);
+    }
+
+    template <class T>
+    struct TIsFloatReference : std::false_type {};
+
+    template <>
+    struct TIsFloatReference<TArrayReference<float>> : std::true_type {};
+
+    // Reduces [begin, end) in fixed lanes, which the compiler vectorizes without reordering
+    template <class TAcc, class TExpr, class TOp>
+    inline TAcc reduceExpressionRange(const TExpr &expr, size_t begin, size_t end, TAcc identity, TOp op) {
+        const TExpr local = expr;
+        TAcc lanes[ExpressionLanes];
+        for (size_t j = 0; j < ExpressionLanes; ++j) {
+            lanes[j] = identity;
+        }
+        size_t i = begin;
+        for (; i + ExpressionLanes <= end; i += ExpressionLanes) {
+            for (size_t j = 0; j < ExpressionLanes; ++j) {
+                lanes[j] = op(lanes[j], static_cast<TAcc>(local[i + j]));
+            }
+        }
+        for (size_t j = 0; i < end; ++i, ++j) {
+            lanes[j] = op(lanes[j], static_cast<TAcc>(local[i]));
+        }
+
+        TAcc result = identity;
+        for (size_t j = 0; j < ExpressionLanes; ++j) {
+            result = op(result, lanes[j]);
+        }
+        return result;
+    }
+
+    // The chunks are reduced one by one and combined in order, so the result is the same for
+    // any number of threads
+    template <class TAcc, class TExpr, class TOp, class TRangeFunc>
+    inline TAcc reduceExpression(const TExpr &expr, TAcc identity, TOp op, TRangeFunc rangeFunc, const ExpressionOptions &options) {
+        const size_t size = expr.size();
+        const size_t grainSize = std::max<size_t>(1, options.m_grainSize);
+        if (size >= options.m_parallelThreshold) {
+            return parallelReduce(size_t(0), size, identity, [&rangeFunc](size_t begin, size_t end, TAcc) {
+                return rangeFunc(begin, end);
+            }, op, grainSize, options.m_scheduler);
+        }
+
+        TAcc result = identity;
+        for (size_t begin = 0; begin < size; begin += grainSize) {
+            result = op(result, rangeFunc(begin, std::min(size, begin + grainSize)));
+        }
+        return result;
+    }
+
+} // Namespace Details
+
+/// @brief  Wraps an array as the leaf of a lazy expression.
+/// @param  array   [in] The array, it must outlive the expression.
+/// @return The expression.
+template <class T, class TAlloc>
+inline TArrayReference<T> lazy(const TArray<T, TAlloc> &array) {
+    return TArrayReference<T>(array.isEmpty() ? nullptr : &array[0], array.size());
+}
+
+/// @brief  Wraps a static array as the leaf of a lazy expression.
+/// @param  array   [in] The array, it must outlive the expression.
+/// @return The expression.
+template <class T, size_t len>
+inline constexpr TArrayReference<T> lazy(const TStaticArray<T, len> &array) {
+    return TArrayReference<T>(array.data(), len);
+}
+
+/// @brief  Wraps raw memory as the leaf of a lazy expression.
+/// @param  data    [in] The items.
+/// @param  size    [in] The number of items.
+/// @return The expression.
+template <class T>
+inline constexpr TArrayReference<T> lazy(const T *data, size_t size) {
+    return TArrayReference<T>(data, size);
+}
+
+#define CPPCORE_ARRAY_EXPRESSION_OPERATOR(op, TOp)                                                     \
+    template <ArrayExpression TLeft, ArrayExpression TRight>                                          \
+    inline constexpr auto operator op(const TLeft &left, const TRight &right) {                       \
+        return TBinaryExpression<Details::TOp, TLeft, TRight>(left, right);                           \
+    }                                                                                                 \
+    template <ArrayExpression TLeft, class S>                                                         \
+    requires std::is_arithmetic_v<S>                                                                  \
+    inline constexpr auto operator op(const TLeft &left, S right) {                                   \
+        return TBinaryExpression<Details::TOp, TLeft, decltype(Details::makeScalar<TLeft>(right))>(   \
+                left, Details::makeScalar<TLeft>(right));                                             \
+    }                                                                                                 \
+    template <class S, ArrayExpression TRight>                                                        \
+    requires std::is_arithmetic_v<S>                                                                  \
+    inline constexpr auto operator op(S left, const TRight &right) {                                  \
+        return TBinaryExpression<Details::TOp, decltype(Details::makeScalar<TRight>(left)), TRight>(  \
+                Details::makeScalar<TRight>(left), right);                                            \
+    }
+
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(+, AddOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(-, SubOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(*, MulOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(/, DivOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(<, LessOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(<=, LessEqualOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(>, GreaterOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(>=, GreaterEqualOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(==, EqualOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(!=, NotEqualOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(&, AndOp)
+CPPCORE_ARRAY_EXPRESSION_OPERATOR(|, OrOp)
+
+#undef CPPCORE_ARRAY_EXPRESSION_OPERATOR
+
+template <ArrayExpression TExpr>
+inline constexpr auto operator-(const TExpr &expr) {
+    return TUnaryExpression<Details::NegateOp, TExpr>(expr);
+}
+
+template <ArrayExpression TExpr>
+inline constexpr auto operator!(const TExpr &expr) {
+    return TUnaryExpression<Details::NotOp, TExpr>(expr);
+}
+
+/// @brief  The absolute value per item.
+template <ArrayExpression TExpr>
+inline constexpr auto abs(const TExpr &expr) {
+    return TUnaryExpression<Details::AbsOp, TExpr>(expr);
+}
+
+/// @brief  The smaller item per index, the right side may be a scalar.
+template <ArrayExpression TLeft, class TRight>
+inline constexpr auto minimum(const TLeft &left, const TRight &right) {
+    using RightExpr = std::remove_cvref_t<decltype(Details::asOperand<TLeft>(right))>;
+    return TBinaryExpression<Details::MinOp, TLeft, RightExpr>(left, Details::asOperand<TLeft>(right));
+}
+
+/// @brief  The larger item per index, the right side may be a scalar.
+template <ArrayExpression TLeft, class TRight>
+inline constexpr auto maximum(const TLeft &left, const TRight &right) {
+    using RightExpr = std::remove_cvref_t<decltype(Details::asOperand<TLeft>(right))>;
+    return TBinaryExpression<Details::MaxOp, TLeft, RightExpr>(left, Details::asOperand<TLeft>(right));
+}
+
+/// @brief  Selects onTrue where the mask is set and onFalse elsewhere, both may be scalars.
+/// @param  mask    [in] A boolean expression, like lazy(a) > 0.
+/// @param  onTrue  [in] The expression or scalar for set mask items.
+/// @param  onFalse [in] The expression or scalar for unset mask items.
+/// @return The expression.
+template <ArrayExpression TMask, class TTrue, class TFalse>
+inline constexpr auto where(const TMask &mask, const TTrue &onTrue, const TFalse &onFalse) {
+    using TrueExpr = std::remove_cvref_t<decltype(Details::asExpression(onTrue))>;
+    using FalseExpr = std::remove_cvref_t<decltype(Details::asExpression(onFalse))>;
+    return TWhereExpression<TMask, TrueExpr, FalseExpr>(mask, Details::asExpression(onTrue), Details::asExpression(onFalse));
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Evaluates an expression into memory in a single pass without temporaries. Writing into
+///         an array which is also read by the expression is allowed, every item only depends on
+///         the items with the same index.
+/// @param  out     [out] The target, it must hold expr.size() items.
+/// @param  expr    [in] The expression.
+/// @param  options [in] The settings.
+//-------------------------------------------------------------------------------------------------
+template <class T, ArrayExpression TExpr>
+inline void evaluate(T *out, const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    const size_t size = expr.size();
+    auto evaluateRange = [out, &expr](size_t begin, size_t end) {
+        const TExpr local = expr;
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = static_cast<T>(local[i]);
+        }
+    };
+    if (size >= options.m_parallelThreshold) {
+        parallelForRange(0, size, evaluateRange, options.m_grainSize, options.m_scheduler);
+    } else {
+        evaluateRange(0, size);
+    }
+}
+
+/// @brief  Evaluates an expression into an array, which is resized to the size of the expression.
+template <class T, class TAlloc, ArrayExpression TExpr>
+inline void evaluate(TArray<T, TAlloc> &out, const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    const size_t size = expr.size();
+    if (out.size() != size) {
+        out.resize(size);
+    }
+    if (0 != size) {
+        evaluate(&out[0], expr, options);
+    }
+}
+
+/// @brief  Evaluates an expression into a static array of the same size.
+template <class T, size_t len, ArrayExpression TExpr>
+inline void evaluate(TStaticArray<T, len> &out, const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    assert(len == expr.size());
+    evaluate(out.data(), expr, options);
+}
+
+/// @brief  Returns the sum of all items, a boolean expression returns the number of set items.
+///         The summation order is fixed, so the result does not depend on the threads.
+/// @param  expr    [in] The expression.
+/// @param  options [in] The settings.
+/// @return The sum.
+template <ArrayExpression TExpr>
+inline auto sum(const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    using Value = typename TExpr::ValueType;
+    using Acc = std::conditional_t<std::is_same_v<Value, bool>, size_t, Value>;
+    auto op = [](Acc a, Acc b) { return static_cast<Acc>(a + b); };
+
+    // Plain float sums and dot products run in the dispatched SIMD kernels
+    if constexpr (Details::TIsFloatReference<TExpr>::value) {
+        return Details::reduceExpression(expr, 0.0f, op, [&expr](size_t begin, size_t end) {
+            return VectorKernels::sum(expr.data() + begin, end - begin);
+        }, options);
+    } else if constexpr (std::is_same_v<TExpr, TBinaryExpression<Details::MulOp, TArrayReference<float>, TArrayReference<float>>>) {
+        return Details::reduceExpression(expr, 0.0f, op, [&expr](size_t begin, size_t end) {
+            return VectorKernels::dot(expr.getLeft().data() + begin, expr.getRight().data() + begin, end - begin);
+        }, options);
+    } else {
+        return Details::reduceExpression(expr, Acc(0), op, [&expr, op](size_t begin, size_t end) {
+            return Details::reduceExpressionRange(expr, begin, end, Acc(0), op);
+        }, options);
+    }
+}
+
+/// @brief  Returns the dot product of two expressions.
+template <ArrayExpression TLeft, ArrayExpression TRight>
+inline auto dot(const TLeft &left, const TRight &right, const ExpressionOptions &options = ExpressionOptions()) {
+    return sum(left * right, options);
+}
+
+/// @brief  Returns the number of set items of a boolean expression.
+template <ArrayExpression TExpr>
+inline size_t count(const TExpr &mask, const ExpressionOptions &options = ExpressionOptions()) {
+    static_assert(std::is_same_v<typename TExpr::ValueType, bool>, "count needs a boolean expression");
+    return sum(mask, options);
+}
+
+/// @brief  Returns the smallest item, the largest value of the type for an empty expression.
+template <ArrayExpression TExpr>
+inline auto minElement(const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    using Value = typename TExpr::ValueType;
+    auto op = [](Value a, Value b) { return Details::MinOp::apply(a, b); };
+    const Value identity = std::numeric_limits<Value>::max();
+    return Details::reduceExpression(expr, identity, op, [&expr, op, identity](size_t begin, size_t end) {
+        return Details::reduceExpressionRange(expr, begin, end, identity, op);
+    }, options);
+}
+
+/// @brief  Returns the largest item, the lowest value of the type for an empty expression.
+template <ArrayExpression TExpr>
+inline auto maxElement(const TExpr &expr, const ExpressionOptions &options = ExpressionOptions()) {
+    using Value = typename TExpr::ValueType;
+    auto op = [](Value a, Value b) { return Details::MaxOp::apply(a, b); };
+    const Value identity = std::numeric_limits<Value>::lowest();
+    return Details::reduceExpression(expr, identity, op, [&expr, op, identity](size_t begin, size_t end) {
+        return Details::reduceExpressionRange(expr, begin, end, identity, op);
+    }, options);
+}
+
+} // Namespace CPPCore
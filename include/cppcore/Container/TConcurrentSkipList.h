@@ -0,0 +1,572 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Memory/ThreadCacheAllocator.h>
+#include <cppcore/Profiling/Metrics.h>
+#include <cppcore/Threading/Rcu.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TConcurrentSkipList
+///	@ingroup	CPPCore
+///
+///	@brief  A lock-free ordered map. Every node owns a tower of next pointers which are linked by
+/// CAS, bottom-up on insertion. A removal marks the tower top-down in the low pointer bits, the
+/// thread which marks the bottom level owns the removal, and every search unlinks the marked nodes
+/// it passes. Lookups and range scans only read and never wait.
+///
+/// All operations run in an Rcu read-side section, unlinked nodes are retired in per-thread
+/// batches and deleted after a grace period, so a reader never sees freed memory. The nodes come
+/// from the ThreadCacheAllocator. Values are immutable once inserted, remove and insert a key to
+/// replace its value.
+//-------------------------------------------------------------------------------------------------
+template <class TKey, class TValue, class TCompare = std::less<TKey>>
+class TConcurrentSkipList {
+public:
+    /// @brief  The max. height of a tower, enough for 2^MaxHeight keys.
+    static constexpr uint32_t MaxHeight = 32;
+
+    /// @brief  The class constructor.
+    /// @param  compare     [in] The key order.
+    explicit TConcurrentSkipList(const TCompare &compare = TCompare());
+
+    /// @brief  The class destructor. No other thread may use the list anymore.
+    ~TConcurrentSkipList();
+
+    /// @brief  Inserts a key-value pair.
+    /// @param  key     [in] The key.
+    /// @param  value   [in] The value.
+    /// @return false, if the key is already stored.
+    bool insert(const TKey &key, const TValue &value);
+
+    /// @brief  Removes a key.
+    /// @param  key     [in] The key.
+    /// @return true, if this call removed the key.
+    bool remove(const TKey &key);
+
+    /// @brief  Looks up a key.
+    /// @param  key     [in] The key.
+    /// @param  value   [out] The value, unchanged if the key was not found.
+    /// @return true, if the key was found.
+    bool find(const TKey &key, TValue &value) const;
+
+    /// @brief  Returns true, if the key is stored.
+    /// @param  key     [in] The key.
+    /// @return true, if found.
+    bool contains(const TKey &key) const;
+
+    /// @brief  Returns the smallest key.
+    /// @param  key     [out] The key.
+    /// @param  value   [out] The value.
+    /// @return false, if the list is empty.
+    bool getFirst(TKey &key, TValue &value) const;
+
+    /// @brief  Calls func(key, value) for every key in [first, last) in ascending order. Keys which
+    ///         are inserted or removed during the scan may or may not be visited.
+    /// @param  first   [in] The first key.
+    /// @param  last    [in] The end key, excluded.
+    /// @param  func    [in] The function, returns false to stop the scan.
+    /// @return The number of visited keys.
+    template <class Func>
+    size_t forRange(const TKey &first, const TKey &last, Func func) const;
+
+    /// @brief  Calls func(key, value) for all keys in ascending order.
+    /// @param  func    [in] The function, returns false to stop the scan.
+    /// @return The number of visited keys.
+    template <class Func>
+    size_t forEach(Func func) const;
+
+    /// @brief  Returns the number of keys, a snapshot while other threads modify the list.
+    /// @return The number of keys.
+    size_t size() const;
+
+    /// @brief  Returns true, if the list looks empty.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    /// @brief  Hands the nodes the calling thread removed over to Rcu, without waiting for a full
+    ///         batch. Call Rcu::barrier() afterwards to free them.
+    static void flushRetired();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TConcurrentSkipList)
+
+private:
+    // A node removed while its tower is still being built is retired by the inserter
+    enum NodeState : uint32_t {
+        Building,
+        Linked,
+        RemovedWhileBuilding,
+        Retired
+    };
+
+    struct Node {
+        TKey m_key;
+        TValue m_value;
+        uint32_t m_height;
+        std::atomic<uint32_t> m_state;
+        std::atomic<uintptr_t> m_next[1];
+    };
+
+    static_assert(alignof(Node) <= ThreadCacheAllocator::Granularity, "Over-aligned keys or values are not supported");
+
+    struct RetireList {
+        std::vector<Node*> *m_nodes;
+
+        RetireList() :
+                m_nodes(nullptr) {
+            // empty
+        }
+
+        ~RetireList() {
+            flush();
+        }
+
+        void flush() {
+            if (nullptr != m_nodes) {
+                Rcu::retire(m_nodes, &TConcurrentSkipList::deleteBatch);
+                m_nodes = nullptr;
+            }
+        }
+    };
+
+    static constexpr size_t RetireBatchSize = 64;
+    static constexpr uintptr_t Mark = 1;
+
+    static Node *getNode(uintptr_t word);
+    static bool isMarked(uintptr_t word);
+    static size_t getNodeSize(uint32_t height);
+    static Node *createNode(const TKey &key, const TValue &value, uint32_t height);
+    static void destroyNode(Node *node);
+    static void deleteBatch(void *object);
+    static RetireList &getRetireList();
+    static void retireNode(Node *node);
+    static uint32_t getRandomHeight();
+
+    std::atomic<uintptr_t> &getNext(Node *node, uint32_t level);
+    const std::atomic<uintptr_t> &getNext(const Node *node, uint32_t level) const;
+    bool search(const TKey &key, Node **preds, Node **succs);
+    const Node *lowerBound(const TKey &key) const;
+    const Node *findNode(const TKey &key) const;
+    void release(Node *node, bool isInserter);
+
+private:
+    std::atomic<uintptr_t> m_head[MaxHeight];
+    TCompare m_compare;
+    ShardedCounter m_size;
+};
+
+template <class TKey, class TValue, class TCompare>
+inline TConcurrentSkipList<TKey, TValue, TCompare>::TConcurrentSkipList(const TCompare &compare) :
+        m_compare(compare),
+        m_size() {
+    for (uint32_t i = 0; i < MaxHeight; ++i) {
+        m_head[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+template <class TKey, class TValue, class TCompare>
+inline TConcurrentSkipList<TKey, TValue, TCompare>::~TConcurrentSkipList() {
+    Node *node = getNode(m_head[0].load(std::memory_order_acquire));
+    while (nullptr != node) {
+        Node *next = getNode(node->m_next[0].load(std::memory_order_relaxed));
+        destroyNode(node);
+        node = next;
+    }
+}
+
+template <class TKey, class TValue, class TCompare>
+inline typename TConcurrentSkipList<TKey, TValue, TCompare>::Node *TConcurrentSkipList<TKey, TValue, TCompare>::getNode(uintptr_t word) {
+    return reinterpret_cast<Node*>(word & ~Mark);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::isMarked(uintptr_t word) {
+    return 0 != (word & Mark);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline size_t TConcurrentSkipList<TKey, TValue, TCompare>::getNodeSize(uint32_t height) {
+    return sizeof(Node) + (height - 1) * sizeof(std::atomic<uintptr_t>);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline typename TConcurrentSkipList<TKey, TValue, TCompare>::Node *TConcurrentSkipList<TKey, TValue, TCompare>::createNode(
+        const TKey &key, const TValue &value, uint32_t height) {
+    void *memory = ThreadCacheAllocator::allocate(getNodeSize(height));
+    Node *node = static_cast<Node*>(memory);
+    new (&node->m_key) TKey(key);
+    new (&node->m_value) TValue(value);
+    node->m_height = height;
+    new (&node->m_state) std::atomic<uint32_t>(Building);
+    for (uint32_t i = 0; i < height; ++i) {
+        new (&node->m_next[i]) std::atomic<uintptr_t>(0);
+    }
+
+    return node;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline void TConcurrentSkipList<TKey, TValue, TCompare>::destroyNode(Node *node) {
+    const size_t size = getNodeSize(node->m_height);
+    node->m_key.~TKey();
+    node->m_value.~TValue();
+    ThreadCacheAllocator::deallocate(node, size);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline void TConcurrentSkipList<TKey, TValue, TCompare>::deleteBatch(void *object) {
+    std::vector<Node*> *nodes = static_cast<std::vector<Node*>*>(object);
+    for (size_t i = 0; i < nodes->size(); ++i) {
+        destroyNode((*nodes)[i]);
+    }
+    delete nodes;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline typename TConcurrentSkipList<TKey, TValue, TCompare>::RetireList &TConcurrentSkipList<TKey, TValue, TCompare>::getRetireList() {
+    static thread_local RetireList t_retired;
+    return t_retired;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline void TConcurrentSkipList<TKey, TValue, TCompare>::retireNode(Node *node) {
+    // One Rcu::retire per batch, it takes a global lock
+    RetireList &retired = getRetireList();
+    if (nullptr == retired.m_nodes) {
+        retired.m_nodes = new std::vector<Node*>;
+        retired.m_nodes->reserve(RetireBatchSize);
+    }
+    retired.m_nodes->push_back(node);
+    if (retired.m_nodes->size() >= RetireBatchSize) {
+        retired.flush();
+    }
+}
+
+template <class TKey, class TValue, class TCompare>
+inline void TConcurrentSkipList<TKey, TValue, TCompare>::flushRetired() {
+    getRetireList().flush();
+}
+
+template <class TKey, class TValue, class TCompare>
+inline uint32_t TConcurrentSkipList<TKey, TValue, TCompare>::getRandomHeight() {
+    // Every level has half the nodes of the one below
+    static thread_local uint64_t t_state = 0;
+    if (0 == t_state) {
+        t_state = reinterpret_cast<uintptr_t>(&t_state) * 0x9E3779B97F4A7C15ull | 1;
+    }
+    t_state ^= t_state << 13;
+    t_state ^= t_state >> 7;
+    t_state ^= t_state << 17;
+
+    uint32_t height = 1;
+    uint64_t bits = t_state;
+    while (0 != (bits & 1) && height < MaxHeight) {
+        ++height;
+        bits >>= 1;
+    }
+
+    return height;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline std::atomic<uintptr_t> &TConcurrentSkipList<TKey, TValue, TCompare>::getNext(Node *node, uint32_t level) {
+    return nullptr == node ? m_head[level] : node->m_next[level];
+}
+
+template <class TKey, class TValue, class TCompare>
+inline const std::atomic<uintptr_t> &TConcurrentSkipList<TKey, TValue, TCompare>::getNext(const Node *node, uint32_t level) const {
+    return nullptr == node ? m_head[level] : node->m_next[level];
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::search(const TKey &key, Node **preds, Node **succs) {
+retry:
+    // nullptr stands for the head
+    Node *pred = nullptr;
+    for (uint32_t level = MaxHeight; 0 != level--;) {
+        Node *curr = getNode(getNext(pred, level).load(std::memory_order_acquire));
+        while (nullptr != curr) {
+            uintptr_t succ = curr->m_next[level].load(std::memory_order_acquire);
+            while (isMarked(succ)) {
+                // Unlink the removed node, start over if pred changed meanwhile
+                uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                if (!getNext(pred, level).compare_exchange_strong(expected, succ & ~Mark,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    goto retry;
+                }
+                curr = getNode(succ);
+                if (nullptr == curr) {
+                    break;
+                }
+                succ = curr->m_next[level].load(std::memory_order_acquire);
+            }
+            if (nullptr == curr || !m_compare(curr->m_key, key)) {
+                break;
+            }
+            pred = curr;
+            curr = getNode(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+
+    return nullptr != succs[0] && !m_compare(key, succs[0]->m_key);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline const typename TConcurrentSkipList<TKey, TValue, TCompare>::Node *TConcurrentSkipList<TKey, TValue, TCompare>::lowerBound(
+        const TKey &key) const {
+    // Read-only, removed nodes are passed over but not unlinked
+    const Node *pred = nullptr;
+    const Node *curr = nullptr;
+    for (uint32_t level = MaxHeight; 0 != level--;) {
+        curr = getNode(getNext(pred, level).load(std::memory_order_acquire));
+        while (nullptr != curr && m_compare(curr->m_key, key)) {
+            pred = curr;
+            curr = getNode(curr->m_next[level].load(std::memory_order_acquire));
+        }
+    }
+    while (nullptr != curr && isMarked(curr->m_next[0].load(std::memory_order_acquire))) {
+        curr = getNode(curr->m_next[0].load(std::memory_order_acquire));
+    }
+
+    return curr;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline const typename TConcurrentSkipList<TKey, TValue, TCompare>::Node *TConcurrentSkipList<TKey, TValue, TCompare>::findNode(
+        const TKey &key) const {
+    const Node *node = lowerBound(key);
+    return nullptr != node && !m_compare(key, node->m_key) ? node : nullptr;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline void TConcurrentSkipList<TKey, TValue, TCompare>::release(Node *node, bool isInserter) {
+    // The inserter and the remover both finish with the node, the later one retires it
+    uint32_t state = node->m_state.load(std::memory_order_acquire);
+    uint32_t next = 0;
+    do {
+        if (isInserter) {
+            next = Building == state ? Linked : Retired;
+        } else {
+            next = Building == state ? RemovedWhileBuilding : Retired;
+        }
+    } while (!node->m_state.compare_exchange_weak(state, next, std::memory_order_acq_rel));
+
+    if (Retired == next) {
+        // Whoever comes last, the inserter may have linked a level after the remover's search,
+        // so unlink the tower once more before it is retired
+        Node *preds[MaxHeight];
+        Node *succs[MaxHeight];
+        search(node->m_key, preds, succs);
+        retireNode(node);
+    }
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::insert(const TKey &key, const TValue &value) {
+    Node *preds[MaxHeight];
+    Node *succs[MaxHeight];
+    const uint32_t height = getRandomHeight();
+    Node *node = nullptr;
+
+    RcuReadGuard guard;
+    for (;;) {
+        if (search(key, preds, succs)) {
+            if (nullptr != node) {
+                destroyNode(node);
+            }
+            return false;
+        }
+        if (nullptr == node) {
+            node = createNode(key, value, height);
+        }
+        for (uint32_t level = 0; level < height; ++level) {
+            node->m_next[level].store(reinterpret_cast<uintptr_t>(succs[level]), std::memory_order_relaxed);
+        }
+
+        // Linking the bottom level inserts the key
+        uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+        if (getNext(preds[0], 0).compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node),
+                std::memory_order_release, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    m_size.increment();
+
+    for (uint32_t level = 1; level < height; ++level) {
+        for (;;) {
+            uintptr_t next = node->m_next[level].load(std::memory_order_acquire);
+            if (isMarked(next)) {
+                // Already being removed, stop building
+                release(node, true);
+                return true;
+            }
+            if (next != reinterpret_cast<uintptr_t>(succs[level]) &&
+                    !node->m_next[level].compare_exchange_strong(next, reinterpret_cast<uintptr_t>(succs[level]),
+                    std::memory_order_release, std::memory_order_relaxed)) {
+                continue;
+            }
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[level]);
+            if (getNext(preds[level], level).compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node),
+                    std::memory_order_release, std::memory_order_relaxed)) {
+                break;
+            }
+            search(key, preds, succs);
+            if (succs[0] != node) {
+                release(node, true);
+                return true;
+            }
+        }
+    }
+    release(node, true);
+
+    return true;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::remove(const TKey &key) {
+    Node *preds[MaxHeight];
+    Node *succs[MaxHeight];
+
+    RcuReadGuard guard;
+    if (!search(key, preds, succs)) {
+        return false;
+    }
+
+    // Mark the tower top-down, the thread which marks the bottom level wins
+    Node *node = succs[0];
+    for (uint32_t level = node->m_height - 1; 0 < level; --level) {
+        node->m_next[level].fetch_or(Mark, std::memory_order_acq_rel);
+    }
+    if (isMarked(node->m_next[0].fetch_or(Mark, std::memory_order_acq_rel))) {
+        return false;
+    }
+    m_size.add(-1);
+
+    search(key, preds, succs);
+    release(node, false);
+
+    return true;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::find(const TKey &key, TValue &value) const {
+    RcuReadGuard guard;
+    const Node *node = findNode(key);
+    if (nullptr == node) {
+        return false;
+    }
+    value = node->m_value;
+
+    return true;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::contains(const TKey &key) const {
+    RcuReadGuard guard;
+    return nullptr != findNode(key);
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::getFirst(TKey &key, TValue &value) const {
+    RcuReadGuard guard;
+    const Node *node = getNode(m_head[0].load(std::memory_order_acquire));
+    while (nullptr != node && isMarked(node->m_next[0].load(std::memory_order_acquire))) {
+        node = getNode(node->m_next[0].load(std::memory_order_acquire));
+    }
+    if (nullptr == node) {
+        return false;
+    }
+    key = node->m_key;
+    value = node->m_value;
+
+    return true;
+}
+
+template <class TKey, class TValue, class TCompare>
+template <class Func>
+inline size_t TConcurrentSkipList<TKey, TValue, TCompare>::forRange(const TKey &first, const TKey &last, Func func) const {
+    RcuReadGuard guard;
+    size_t count = 0;
+    for (const Node *node = lowerBound(first); nullptr != node && m_compare(node->m_key, last);) {
+        const uintptr_t next = node->m_next[0].load(std::memory_order_acquire);
+        if (!isMarked(next)) {
+            ++count;
+            if (!func(node->m_key, node->m_value)) {
+                break;
+            }
+        }
+        node = getNode(next);
+    }
+
+    return count;
+}
+
+template <class TKey, class TValue, class TCompare>
+template <class Func>
+inline size_t TConcurrentSkipList<TKey, TValue, TCompare>::forEach(Func func) const {
+    RcuReadGuard guard;
+    size_t count = 0;
+    for (const Node *node = getNode(m_head[0].load(std::memory_order_acquire)); nullptr != node;) {
+        const uintptr_t next = node->m_next[0].load(std::memory_order_acquire);
+        if (!isMarked(next)) {
+            ++count;
+            if (!func(node->m_key, node->m_value)) {
+                break;
+            }
+        }
+        node = getNode(next);
+    }
+
+    return count;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline size_t TConcurrentSkipList<TKey, TValue, TCompare>::size() const {
+    const int64_t size = m_size.get();
+    return 0 < size ? static_cast<size_t>(size) : 0;
+}
+
+template <class TKey, class TValue, class TCompare>
+inline bool TConcurrentSkipList<TKey, TValue, TCompare>::isEmpty() const {
+    RcuReadGuard guard;
+    const Node *node = getNode(m_head[0].load(std::memory_order_acquire));
+    while (nullptr != node && isMarked(node->m_next[0].load(std::memory_order_acquire))) {
+        node = getNode(node->m_next[0].load(std::memory_order_acquire));
+    }
+
+    return nullptr == node;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,483 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Container/BatchLookup.h>
+#include <cppcore/Container/TPerfectHashMap.h>
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+namespace Details {
+
+    // Multiplied into the stored hash to get the tag, so the tag does not repeat the bits of the
+    // home slot which all neighbors in a probe run share
+    constexpr uint32_t DenseHashTagMul = 0x9e3779b9u;
+
+    // The smallest index has 8 slots
+    constexpr uint32_t DenseHashMinBits = 3;
+
+    // Strings, integers and enums use the hash of the perfect hash maps, all other keys std::hash
+    template <class TKey>
+    inline uint64_t hashDenseKey(const TKey &key) {
+        if constexpr (std::is_integral_v<TKey> || std::is_enum_v<TKey> || std::is_convertible_v<const TKey &, std::string_view>) {
+            return hashPerfectKey(key, 0);
+        } else {
+            return mixPerfectHash(static_cast<uint64_t>(std::hash<TKey>()(key)));
+        }
+    }
+
+    // The index is filled up to 3/4, linear probing stays short then
+    constexpr size_t getDenseHashCapacity(uint32_t bits) {
+        return (size_t(1) << bits) / 4 * 3;
+    }
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TDenseHashMap
+///	@ingroup	CPPCore
+///
+///	@brief  A hash map which stores its key-value pairs contiguously in insertion order, so a full
+/// iteration runs at the speed of an array. A separate open-addressing index of 32-bit slots maps
+/// the keys to the entries, every slot holds the entry index and a tag of the hash, so most
+/// mismatches are rejected without touching the entries. remove() moves the last entry into the
+/// gap, which changes the order of that one entry. Pointers to entries and values are invalidated
+/// by insertions and removals.
+/// @code
+/// TDenseHashMap<std::string, int> map;
+/// map.insert("one", 1);
+/// for (const auto &entry : map) {
+///     ::printf("%s = %d\n", entry.m_key.c_str(), entry.m_value);
+/// }
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class K, class V>
+class TDenseHashMap {
+public:
+    /// @brief  A key-value pair.
+    struct Entry {
+        K m_key;
+        V m_value;
+    };
+
+    /// @brief  The class constructor, no memory is allocated until the first insert.
+    TDenseHashMap();
+
+    /// @brief  The class destructor.
+    ~TDenseHashMap();
+
+    /// @brief  Returns the number of stored items.
+    /// @return The number of items.
+    size_t size() const;
+
+    /// @brief  Returns the number of items which can be stored without growing.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    /// @brief  Will return true, if the map is empty.
+    /// @return true for empty.
+    bool isEmpty() const;
+
+    /// @brief  Grows the map, so it can hold count items without growing again.
+    /// @param  count   [in] The number of items.
+    void reserve(size_t count);
+
+    /// @brief  Removes all items and releases the memory.
+    void clear();
+
+    /// @brief  Adds a key-value pair, the value of an existing key is replaced.
+    /// @param  key     [in] The key.
+    /// @param  value   [in] The value.
+    /// @return true, if the key was new.
+    bool insert(const K &key, const V &value);
+
+    /// @brief  Removes a key-value pair, the last entry takes its place.
+    /// @param  key     [in] The key to look for.
+    /// @return true, if the key was found and removed.
+    template <class TKey>
+    bool remove(const TKey &key);
+
+    /// @brief  Looks up a key.
+    /// @param  key     [in] The key to look for, anything comparable to K with the same hash.
+    /// @return The value, nullptr if the key is not stored.
+    template <class TKey>
+    V *find(const TKey &key);
+
+    template <class TKey>
+    const V *find(const TKey &key) const;
+
+    /// @brief  Looks for a given key.
+    /// @param  key     [in] The key to look for.
+    /// @return true, if the key is stored.
+    template <class TKey>
+    bool hasKey(const TKey &key) const;
+
+    /// @brief  Returns the assigned value for the given key.
+    /// @param  key     [in] The key to look for.
+    /// @param  value   [out] The value, unchanged when the key was not found.
+    /// @return true, if the key was found.
+    template <class TKey>
+    bool getValue(const TKey &key, V &value) const;
+
+    /// @brief  Looks up many keys at once, the index slots and entries of a group of keys are
+    ///         prefetched before they are read.
+    /// @param  keys    [in] The keys to look for.
+    /// @param  count   [in] The number of keys.
+    /// @param  values  [out] The value per key, nullptr when the key was not found.
+    /// @return The number of found keys.
+    template <class TKey>
+    size_t findBatch(const TKey *keys, size_t count, const V **values) const;
+
+    /// @brief  Returns the value of a key, a default constructed value is inserted for a new key.
+    /// @param  key     [in] The key.
+    /// @return The value.
+    V &operator[](const K &key);
+
+    /// @brief  The entries in insertion order.
+    Entry *begin();
+    Entry *end();
+    const Entry *begin() const;
+    const Entry *end() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TDenseHashMap)
+
+private:
+    size_t getHome(uint32_t hash) const;
+    uint32_t getTag(uint32_t hash) const;
+    size_t findSlot(uint32_t hash, size_t index) const;
+    void grow(uint32_t bits);
+
+    template <class TKey>
+    bool findSlot(const TKey &key, uint32_t hash, size_t &slot) const;
+
+private:
+    std::allocator<Entry> m_allocator;
+    Entry *m_entries;
+    uint32_t *m_hashes;
+    uint32_t *m_slots;
+    size_t m_numItems;
+    uint32_t m_slotBits;
+    uint32_t m_slotMask;
+};
+
+template <class K, class V>
+inline TDenseHashMap<K, V>::TDenseHashMap() :
+        m_allocator(),
+        m_entries(nullptr),
+        m_hashes(nullptr),
+        m_slots(nullptr),
+        m_numItems(0),
+        m_slotBits(0),
+        m_slotMask(0) {
+    // empty
+}
+
+template <class K, class V>
+inline TDenseHashMap<K, V>::~TDenseHashMap() {
+    clear();
+}
+
+template <class K, class V>
+inline size_t TDenseHashMap<K, V>::size() const {
+    return m_numItems;
+}
+
+template <class K, class V>
+inline size_t TDenseHashMap<K, V>::capacity() const {
+    return 0 == m_slotBits ? 0 : Details::getDenseHashCapacity(m_slotBits);
+}
+
+template <class K, class V>
+inline bool TDenseHashMap<K, V>::isEmpty() const {
+    return 0 == m_numItems;
+}
+
+template <class K, class V>
+inline void TDenseHashMap<K, V>::reserve(size_t count) {
+    uint32_t bits = std::max(m_slotBits, Details::DenseHashMinBits);
+    while (Details::getDenseHashCapacity(bits) < count) {
+        ++bits;
+    }
+    if (bits != m_slotBits) {
+        grow(bits);
+    }
+}
+
+template <class K, class V>
+inline void TDenseHashMap<K, V>::clear() {
+    if (nullptr == m_slots) {
+        return;
+    }
+
+    std::destroy_n(m_entries, m_numItems);
+    m_allocator.deallocate(m_entries, capacity());
+    delete[] m_hashes;
+    delete[] m_slots;
+    m_entries = nullptr;
+    m_hashes = nullptr;
+    m_slots = nullptr;
+    m_numItems = 0;
+    m_slotBits = 0;
+    m_slotMask = 0;
+}
+
+template <class K, class V>
+inline bool TDenseHashMap<K, V>::insert(const K &key, const V &value) {
+    const uint32_t hash = static_cast<uint32_t>(Details::hashDenseKey(key) >> 32);
+    size_t slot = 0;
+    if (findSlot(key, hash, slot)) {
+        m_entries[(m_slots[slot] & m_slotMask) - 1].m_value = value;
+        return false;
+    }
+
+    if (m_numItems == capacity()) {
+        grow(0 == m_slotBits ? Details::DenseHashMinBits : m_slotBits + 1);
+        findSlot(key, hash, slot);
+    }
+    ::new (static_cast<void *>(m_entries + m_numItems)) Entry{ key, value };
+    m_hashes[m_numItems] = hash;
+    ++m_numItems;
+    m_slots[slot] = getTag(hash) | static_cast<uint32_t>(m_numItems);
+
+    return true;
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TDenseHashMap<K, V>::remove(const TKey &key) {
+    const uint32_t hash = static_cast<uint32_t>(Details::hashDenseKey(key) >> 32);
+    size_t hole = 0;
+    if (!findSlot(key, hash, hole)) {
+        return false;
+    }
+    const size_t index = (m_slots[hole] & m_slotMask) - 1;
+
+    // Backward shift deletion, the following slots of the probe run move up unless that would
+    // place them before their home slot, so no tombstones are needed
+    for (size_t next = (hole + 1) & m_slotMask; 0 != m_slots[next]; next = (next + 1) & m_slotMask) {
+        const size_t home = getHome(m_hashes[(m_slots[next] & m_slotMask) - 1]);
+        if (((next - home) & m_slotMask) >= ((next - hole) & m_slotMask)) {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+    }
+    m_slots[hole] = 0;
+
+    // The last entry fills the gap and its slot is redirected
+    const size_t last = m_numItems - 1;
+    if (index != last) {
+        const size_t lastSlot = findSlot(m_hashes[last], last);
+        m_slots[lastSlot] = (m_slots[lastSlot] & ~m_slotMask) | static_cast<uint32_t>(index + 1);
+        m_entries[index] = std::move(m_entries[last]);
+        m_hashes[index] = m_hashes[last];
+    }
+    std::destroy_at(m_entries + last);
+    --m_numItems;
+
+    return true;
+}
+
+template <class K, class V>
+template <class TKey>
+inline V *TDenseHashMap<K, V>::find(const TKey &key) {
+    return const_cast<V *>(static_cast<const TDenseHashMap *>(this)->find(key));
+}
+
+template <class K, class V>
+template <class TKey>
+inline const V *TDenseHashMap<K, V>::find(const TKey &key) const {
+    if (0 == m_numItems) {
+        return nullptr;
+    }
+
+    size_t slot = 0;
+    if (!findSlot(key, static_cast<uint32_t>(Details::hashDenseKey(key) >> 32), slot)) {
+        return nullptr;
+    }
+
+    return &m_entries[(m_slots[slot] & m_slotMask) - 1].m_value;
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TDenseHashMap<K, V>::hasKey(const TKey &key) const {
+    return nullptr != find(key);
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TDenseHashMap<K, V>::getValue(const TKey &key, V &value) const {
+    const V *found = find(key);
+    if (nullptr == found) {
+        return false;
+    }
+    value = *found;
+
+    return true;
+}
+
+template <class K, class V>
+template <class TKey>
+inline size_t TDenseHashMap<K, V>::findBatch(const TKey *keys, size_t count, const V **values) const {
+    if (0 == m_numItems) {
+        std::fill_n(values, count, nullptr);
+        return 0;
+    }
+
+    struct State {
+        uint32_t m_hash;
+    };
+    size_t numFound = 0;
+    Details::runBatchLookup<State>(count,
+            [this, keys](size_t i, State &state) {
+                state.m_hash = static_cast<uint32_t>(Details::hashDenseKey(keys[i]) >> 32);
+                CPPCORE_PREFETCH(&m_slots[getHome(state.m_hash)]);
+            },
+            [this](size_t, State &state) {
+                const uint32_t slot = m_slots[getHome(state.m_hash)];
+                if (0 != slot) {
+                    CPPCORE_PREFETCH(&m_entries[(slot & m_slotMask) - 1]);
+                }
+            },
+            [this, keys, values, &numFound](size_t i, State &state) {
+                size_t slot = 0;
+                if (findSlot(keys[i], state.m_hash, slot)) {
+                    values[i] = &m_entries[(m_slots[slot] & m_slotMask) - 1].m_value;
+                    ++numFound;
+                } else {
+                    values[i] = nullptr;
+                }
+            });
+
+    return numFound;
+}
+
+template <class K, class V>
+inline V &TDenseHashMap<K, V>::operator[](const K &key) {
+    V *value = find(key);
+    if (nullptr != value) {
+        return *value;
+    }
+    insert(key, V());
+
+    return m_entries[m_numItems - 1].m_value;
+}
+
+template <class K, class V>
+inline typename TDenseHashMap<K, V>::Entry *TDenseHashMap<K, V>::begin() {
+    return m_entries;
+}
+
+template <class K, class V>
+inline typename TDenseHashMap<K, V>::Entry *TDenseHashMap<K, V>::end() {
+    return m_entries + m_numItems;
+}
+
+template <class K, class V>
+inline const typename TDenseHashMap<K, V>::Entry *TDenseHashMap<K, V>::begin() const {
+    return m_entries;
+}
+
+template <class K, class V>
+inline const typename TDenseHashMap<K, V>::Entry *TDenseHashMap<K, V>::end() const {
+    return m_entries + m_numItems;
+}
+
+template <class K, class V>
+inline size_t TDenseHashMap<K, V>::getHome(uint32_t hash) const {
+    return hash >> (32 - m_slotBits);
+}
+
+template <class K, class V>
+inline uint32_t TDenseHashMap<K, V>::getTag(uint32_t hash) const {
+    return (hash * Details::DenseHashTagMul) & ~m_slotMask;
+}
+
+template <class K, class V>
+inline size_t TDenseHashMap<K, V>::findSlot(uint32_t hash, size_t index) const {
+    size_t slot = getHome(hash);
+    while ((m_slots[slot] & m_slotMask) != index + 1) {
+        slot = (slot + 1) & m_slotMask;
+    }
+
+    return slot;
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TDenseHashMap<K, V>::findSlot(const TKey &key, uint32_t hash, size_t &slot) const {
+    if (0 == m_slotBits) {
+        return false;
+    }
+
+    const uint32_t tag = getTag(hash);
+    for (slot = getHome(hash); 0 != m_slots[slot]; slot = (slot + 1) & m_slotMask) {
+        const uint32_t value = m_slots[slot];
+        if ((value & ~m_slotMask) == tag && m_entries[(value & m_slotMask) - 1].m_key == key) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <class K, class V>
+inline void TDenseHashMap<K, V>::grow(uint32_t bits) {
+    // The tag needs at least one bit next to the entry index
+    assert(bits < 32);
+    const size_t newCapacity = Details::getDenseHashCapacity(bits);
+    Entry *entries = m_allocator.allocate(newCapacity);
+    uint32_t *hashes = new uint32_t[newCapacity];
+    std::uninitialized_move_n(m_entries, m_numItems, entries);
+    std::copy_n(m_hashes, m_numItems, hashes);
+
+    const size_t numItems = m_numItems;
+    clear();
+    m_entries = entries;
+    m_hashes = hashes;
+    m_numItems = numItems;
+    m_slotBits = bits;
+    m_slotMask = static_cast<uint32_t>((size_t(1) << bits) - 1);
+    m_slots = new uint32_t[size_t(1) << bits]();
+
+    // The stored hashes rebuild the index without hashing the keys again
+    for (size_t i = 0; i < m_numItems; ++i) {
+        size_t slot = getHome(m_hashes[i]);
+        while (0 != m_slots[slot]) {
+            slot = (slot + 1) & m_slotMask;
+        }
+        m_slots[slot] = getTag(m_hashes[i]) | static_cast<uint32_t>(i + 1);
+    }
+}
+
+} // Namespace CPPCore
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include <cppcore/Common/Hash.h>
+#include <cppcore/Container/BatchLookup.h>
 #include <cppcore/Memory/TDefaultAllocator.h>
 
 namespace CPPCore {
@@ -97,13 +98,22 @@ public:
     ///	@return true, if key-value pair was found, false if not.
     bool getValue(const T &key, U &value) const;
 
+    ///	@brief  Looks up many keys at once. The buckets and nodes of a group of keys are prefetched
+    ///         before they are read, so the cache misses overlap. For maps larger than the cache
+    ///         this is much faster than single lookups.
+    ///	@param  keys    [in] The keys to look for.
+    ///	@param  count   [in] The number of keys.
+    ///	@param  values  [out] The value per key, nullptr when the key was not found.
+    ///	@return The number of found keys.
+    size_t findBatch(const T *keys, size_t count, const U **values) const;
+
     ///	@brief  Returns the assigned value for the given key.
     ///	@param  key     [in] The key to look for.
     ///	@return The value, will unset when no key-value pair was found.
     U &operator[](const T &key) const;
 
     /// Avoid copying.
-    THashMap<T, U, TAlloc>(const THashMap<T, U> &) = delete;
+    THashMap(const THashMap<T, U> &) = delete;
     THashMap<T, U, TAlloc> &operator=(const THashMap<T, U> &) = delete;
 
 private:
@@ -245,23 +255,61 @@ inline bool THashMap<T, U, TAlloc>::hasKey(const T &key) const {
 
 template <class T, class U, class TAlloc>
 inline bool THashMap<T, U, TAlloc>::getValue(const T &key, U &value) const {
-    const size_t pos = Hash::toHash(key, (unsigned int)m_buffersize);
-    if (m_buffer[pos]->m_key == key) {
-        value = m_buffer[pos]->m_value;
-        return true;
+    if (0 == m_buffersize) {
+        return false;
     }
 
-    Node *node = m_buffer[pos];
-    Node *next = node->m_next;
-    while (next->m_key != key) {
-        next = next->m_next;
-        if (nullptr == next) {
-            return false;
+    const size_t pos = Hash::toHash(key, (unsigned int)m_buffersize);
+    for (const Node *node = m_buffer[pos]; nullptr != node; node = node->m_next) {
+        if (node->m_key == key) {
+            value = node->m_value;
+            return true;
         }
     }
-    value = next->m_value;
 
-    return true;
+    return false;
+}
+
+template <class T, class U, class TAlloc>
+inline size_t THashMap<T, U, TAlloc>::findBatch(const T *keys, size_t count, const U **values) const {
+    if (0 == m_buffersize) {
+        std::fill_n(values, count, nullptr);
+        return 0;
+    }
+
+    struct State {
+        Node *const *m_bucket;
+    };
+    size_t numFound = 0;
+    Details::runBatchLookup<State>(count,
+            [this, keys](size_t i, State &state) {
+                state.m_bucket = &m_buffer[Hash::toHash(keys[i], (unsigned int)m_buffersize)];
+                CPPCORE_PREFETCH(state.m_bucket);
+            },
+            [](size_t, State &state) {
+                if (nullptr != *state.m_bucket) {
+                    CPPCORE_PREFETCH(*state.m_bucket);
+                }
+            },
+            [keys](size_t i, State &state) {
+                // Colliding keys are chained, so also fetch the second node when the first one misses
+                const Node *node = *state.m_bucket;
+                if (nullptr != node && node->m_key != keys[i] && nullptr != node->m_next) {
+                    CPPCORE_PREFETCH(node->m_next);
+                }
+            },
+            [keys, values, &numFound](size_t i, State &state) {
+                values[i] = nullptr;
+                for (const Node *node = *state.m_bucket; nullptr != node; node = node->m_next) {
+                    if (node->m_key == keys[i]) {
+                        values[i] = &node->m_value;
+                        ++numFound;
+                        break;
+                    }
+                }
+            });
+
+    return numFound;
 }
 
 template <class T, class U, class TAlloc>
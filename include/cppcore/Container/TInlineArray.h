@@ -0,0 +1,430 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+namespace Details {
+
+    // The smallest integer which holds all sizes up to the capacity
+    template <size_t N>
+    using InlineArraySize = std::conditional_t<(N <= 0xFF), uint8_t, std::conditional_t<(N <= 0xFFFF), uint16_t, size_t>>;
+
+    // Types without construction and destruction work are stored as a plain array, so the array
+    // stays trivially copyable and usable in constant expressions
+    template <class T>
+    constexpr bool IsTrivialInlineItem = std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>;
+
+    template <class T, size_t N, bool IsTrivial = IsTrivialInlineItem<T>>
+    struct InlineArrayStorage {
+        T m_items[N];
+    };
+
+    // All other types live in a union, so the items are only constructed when they are added
+    template <class T, size_t N>
+    struct InlineArrayStorage<T, N, false> {
+        union {
+            T m_items[N];
+        };
+
+        constexpr InlineArrayStorage() {
+            // empty
+        }
+
+        InlineArrayStorage(const InlineArrayStorage &) requires std::is_trivially_copyable_v<T> = default;
+        InlineArrayStorage &operator=(const InlineArrayStorage &) requires std::is_trivially_copyable_v<T> = default;
+
+        ~InlineArrayStorage() requires std::is_trivially_destructible_v<T> = default;
+        constexpr ~InlineArrayStorage() {
+            // empty, the array destroys the items
+        }
+    };
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TInlineArray
+///	@ingroup	CPPCore
+///
+///	@brief  An array with a fixed capacity and a size, all items are stored inside the object, so
+/// it never allocates. Use it for small bounded collections on hot paths, where TArray would pay
+/// for a heap allocation and TStaticArray needs a count beside it. Adding to a full array and
+/// accessing behind the size are caught by asserts in debug builds. The array is trivially copyable,
+/// if T is, and usable in constant expressions for trivially constructible and destructible items.
+/// @code
+/// TInlineArray<int, 8> values = { 1, 2, 3 };
+/// values.add(4);
+/// values.remove(0);
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class T, size_t N>
+class TInlineArray {
+    static_assert(N > 0, "A TInlineArray needs a capacity of at least one item");
+
+public:
+    /// @brief  The class constructor, the array is empty.
+    constexpr TInlineArray();
+
+    /// @brief  The class constructor with initial items.
+    /// @param  items   [in] The items, at most N.
+    constexpr TInlineArray(std::initializer_list<T> items);
+
+    /// @brief  The copy constructors, trivial for trivially copyable items.
+    TInlineArray(const TInlineArray &rhs) requires std::is_trivially_copyable_v<T> = default;
+    constexpr TInlineArray(const TInlineArray &rhs);
+
+    /// @brief  The move constructors, trivial for trivially copyable items.
+    TInlineArray(TInlineArray &&rhs) requires std::is_trivially_copyable_v<T> = default;
+    constexpr TInlineArray(TInlineArray &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /// @brief  The class destructor.
+    ~TInlineArray() requires std::is_trivially_destructible_v<T> = default;
+    constexpr ~TInlineArray();
+
+    /// @brief  The assignment operators, trivial for trivially copyable items.
+    TInlineArray &operator=(const TInlineArray &rhs) requires std::is_trivially_copyable_v<T> = default;
+    constexpr TInlineArray &operator=(const TInlineArray &rhs);
+    TInlineArray &operator=(TInlineArray &&rhs) requires std::is_trivially_copyable_v<T> = default;
+    constexpr TInlineArray &operator=(TInlineArray &&rhs) noexcept(std::is_nothrow_move_assignable_v<T>);
+
+    /// @brief  Returns the number of items which fit into the array.
+    /// @return The capacity N.
+    static constexpr size_t capacity();
+
+    /// @brief  Returns the number of items.
+    /// @return The size.
+    constexpr size_t size() const;
+
+    /// @brief  Returns true, if the array is empty.
+    /// @return true for empty.
+    constexpr bool isEmpty() const;
+
+    /// @brief  Returns true, if the capacity is used up.
+    /// @return true for full.
+    constexpr bool isFull() const;
+
+    /// @brief  Adds an item at the end, the array must not be full.
+    /// @param  value   [in] The new item.
+    constexpr void add(const T &value);
+    constexpr void add(T &&value);
+
+    /// @brief  Constructs an item at the end, the array must not be full.
+    /// @param  args    [in] The constructor arguments.
+    /// @return The new item.
+    template <class... Args>
+    constexpr T &emplace(Args &&...args);
+
+    /// @brief  Inserts an item, the following items move up by one.
+    /// @param  index   [in] The position, at most size().
+    /// @param  value   [in] The new item.
+    constexpr void insert(size_t index, const T &value);
+
+    /// @brief  Removes an item, the following items move down by one.
+    /// @param  index   [in] The position of the item.
+    constexpr void remove(size_t index);
+
+    /// @brief  Removes an item, the last item takes its place, which does not keep the order.
+    /// @param  index   [in] The position of the item.
+    constexpr void removeUnordered(size_t index);
+
+    /// @brief  Removes the last item.
+    constexpr void removeBack();
+
+    /// @brief  Removes all items.
+    constexpr void clear();
+
+    /// @brief  Returns the first item.
+    constexpr T &front();
+    constexpr const T &front() const;
+
+    /// @brief  Returns the last item.
+    constexpr T &back();
+    constexpr const T &back() const;
+
+    /// @brief  Returns a pointer to the first item.
+    /// @return The pointer.
+    constexpr T *data();
+    constexpr const T *data() const;
+
+    /// @brief  Returns the iterators for range-based for loops.
+    constexpr T *begin();
+    constexpr T *end();
+    constexpr const T *begin() const;
+    constexpr const T *end() const;
+
+    /// @brief  The index op.
+    constexpr T &operator[](size_t index);
+    constexpr const T &operator[](size_t index) const;
+
+    /// @brief  Compares the sizes and all items.
+    constexpr bool operator==(const TInlineArray &rhs) const;
+
+private:
+    constexpr void destroyItems();
+
+private:
+    Details::InlineArrayStorage<T, N> m_storage;
+    Details::InlineArraySize<N> m_size;
+};
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N>::TInlineArray() :
+        m_size(0) {
+    // The storage is not initialized, the items are constructed when they are added
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N>::TInlineArray(std::initializer_list<T> items) :
+        m_size(0) {
+    assert(items.size() <= N);
+    for (const T &item : items) {
+        add(item);
+    }
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N>::TInlineArray(const TInlineArray &rhs) :
+        m_size(0) {
+    for (const T &item : rhs) {
+        add(item);
+    }
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N>::TInlineArray(TInlineArray &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) :
+        m_size(0) {
+    for (T &item : rhs) {
+        add(std::move(item));
+    }
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N>::~TInlineArray() {
+    destroyItems();
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N> &TInlineArray<T, N>::operator=(const TInlineArray &rhs) {
+    if (this != &rhs) {
+        clear();
+        for (const T &item : rhs) {
+            add(item);
+        }
+    }
+    return *this;
+}
+
+template <class T, size_t N>
+inline constexpr TInlineArray<T, N> &TInlineArray<T, N>::operator=(TInlineArray &&rhs) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    if (this != &rhs) {
+        clear();
+        for (T &item : rhs) {
+            add(std::move(item));
+        }
+    }
+    return *this;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TInlineArray<T, N>::capacity() {
+    return N;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TInlineArray<T, N>::size() const {
+    return m_size;
+}
+
+template <class T, size_t N>
+inline constexpr bool TInlineArray<T, N>::isEmpty() const {
+    return 0 == m_size;
+}
+
+template <class T, size_t N>
+inline constexpr bool TInlineArray<T, N>::isFull() const {
+    return N == m_size;
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::add(const T &value) {
+    emplace(value);
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::add(T &&value) {
+    emplace(std::move(value));
+}
+
+template <class T, size_t N>
+template <class... Args>
+inline constexpr T &TInlineArray<T, N>::emplace(Args &&...args) {
+    assert(m_size < N);
+
+    T *item = std::construct_at(m_storage.m_items + m_size, std::forward<Args>(args)...);
+    ++m_size;
+
+    return *item;
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::insert(size_t index, const T &value) {
+    assert(index <= m_size);
+    assert(m_size < N);
+
+    if (index == m_size) {
+        emplace(value);
+        return;
+    }
+
+    // The value may be an item of this array, so it is copied before the items move
+    T copy(value);
+    T *items = m_storage.m_items;
+    std::construct_at(items + m_size, std::move(items[m_size - 1]));
+    std::move_backward(items + index, items + m_size - 1, items + m_size);
+    items[index] = std::move(copy);
+    ++m_size;
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::remove(size_t index) {
+    assert(index < m_size);
+
+    T *items = m_storage.m_items;
+    std::move(items + index + 1, items + m_size, items + index);
+    removeBack();
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::removeUnordered(size_t index) {
+    assert(index < m_size);
+
+    if (index + 1 != m_size) {
+        m_storage.m_items[index] = std::move(m_storage.m_items[m_size - 1]);
+    }
+    removeBack();
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::removeBack() {
+    assert(0 != m_size);
+
+    --m_size;
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy_at(m_storage.m_items + m_size);
+    }
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::clear() {
+    destroyItems();
+    m_size = 0;
+}
+
+template <class T, size_t N>
+inline constexpr T &TInlineArray<T, N>::front() {
+    assert(0 != m_size);
+    return m_storage.m_items[0];
+}
+
+template <class T, size_t N>
+inline constexpr const T &TInlineArray<T, N>::front() const {
+    assert(0 != m_size);
+    return m_storage.m_items[0];
+}
+
+template <class T, size_t N>
+inline constexpr T &TInlineArray<T, N>::back() {
+    assert(0 != m_size);
+    return m_storage.m_items[m_size - 1];
+}
+
+template <class T, size_t N>
+inline constexpr const T &TInlineArray<T, N>::back() const {
+    assert(0 != m_size);
+    return m_storage.m_items[m_size - 1];
+}
+
+template <class T, size_t N>
+inline constexpr T *TInlineArray<T, N>::data() {
+    return m_storage.m_items;
+}
+
+template <class T, size_t N>
+inline constexpr const T *TInlineArray<T, N>::data() const {
+    return m_storage.m_items;
+}
+
+template <class T, size_t N>
+inline constexpr T *TInlineArray<T, N>::begin() {
+    return m_storage.m_items;
+}
+
+template <class T, size_t N>
+inline constexpr T *TInlineArray<T, N>::end() {
+    return m_storage.m_items + m_size;
+}
+
+template <class T, size_t N>
+inline constexpr const T *TInlineArray<T, N>::begin() const {
+    return m_storage.m_items;
+}
+
+template <class T, size_t N>
+inline constexpr const T *TInlineArray<T, N>::end() const {
+    return m_storage.m_items + m_size;
+}
+
+template <class T, size_t N>
+inline constexpr T &TInlineArray<T, N>::operator[](size_t index) {
+    assert(index < m_size);
+    return m_storage.m_items[index];
+}
+
+template <class T, size_t N>
+inline constexpr const T &TInlineArray<T, N>::operator[](size_t index) const {
+    assert(index < m_size);
+    return m_storage.m_items[index];
+}
+
+template <class T, size_t N>
+inline constexpr bool TInlineArray<T, N>::operator==(const TInlineArray &rhs) const {
+    return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+}
+
+template <class T, size_t N>
+inline constexpr void TInlineArray<T, N>::destroyItems() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy(m_storage.m_items, m_storage.m_items + m_size);
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,617 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Container/BatchLookup.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace CPPCore {
+
+namespace Details {
+
+    constexpr uint64_t PerfectHashPilotMul = 0x9e3779b97f4a7c15ull;
+    constexpr uint64_t PerfectHashSlotMul = 0xd6e8feb86659fd93ull;
+
+    // The average number of keys per bucket, a pilot is searched for every bucket
+    constexpr size_t PerfectHashBucketSize = 4;
+
+    // The number of seeds tried before the build gives up, each one is very unlikely to fail
+    constexpr uint64_t PerfectHashMaxSeeds = 16;
+
+    enum class PerfectHashResult {
+        Ok,
+        DuplicateKey,
+        Failed
+    };
+
+    // The splitmix64 finalizer
+    constexpr uint64_t mixPerfectHash(uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    // Little-endian on every platform, compilers merge it into one load. Only fixed sizes are used,
+    // so the same code runs at compile time and at runtime without byte loops.
+    template <size_t Size>
+    constexpr uint64_t loadPerfectHashWord(const char *data) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < Size; ++i) {
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+        }
+        return word;
+    }
+
+    constexpr uint64_t hashPerfectKey(std::string_view key, uint64_t seed) {
+        const char *data = key.data();
+        const size_t size = key.size();
+        uint64_t hash = seed ^ (size * PerfectHashPilotMul);
+        uint64_t tail = 0;
+        if (size > 8) {
+            for (size_t i = 0; i + 8 < size; i += 8) {
+                hash = (hash ^ loadPerfectHashWord<8>(data + i)) * 0xff51afd7ed558ccdull;
+                hash ^= hash >> 32;
+            }
+            // The last word overlaps the previous one
+            tail = loadPerfectHashWord<8>(data + size - 8);
+        } else if (size >= 4) {
+            tail = loadPerfectHashWord<4>(data) | (loadPerfectHashWord<4>(data + size - 4) << 32);
+        } else if (size > 0) {
+            tail = loadPerfectHashWord<1>(data) | (loadPerfectHashWord<1>(data + size / 2) << 8) |
+                   (loadPerfectHashWord<1>(data + size - 1) << 16);
+        }
+        return mixPerfectHash(hash ^ tail);
+    }
+
+    template <class K>
+    requires(std::is_integral_v<K> || std::is_enum_v<K>)
+    constexpr uint64_t hashPerfectKey(K key, uint64_t seed) {
+        return mixPerfectHash(static_cast<uint64_t>(key) ^ seed);
+    }
+
+    constexpr size_t getPerfectHashBuckets(size_t count) {
+        return count / PerfectHashBucketSize + 1;
+    }
+
+    // The table has a power of two size and a load factor of at most 0.8
+    constexpr uint32_t getPerfectHashTableBits(size_t count) {
+        uint32_t bits = 1;
+        while ((size_t(1) << bits) < count + count / 4 + 1) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    constexpr size_t getPerfectHashBucket(uint64_t hash, size_t numBuckets) {
+        return static_cast<size_t>(((hash >> 32) * numBuckets) >> 32);
+    }
+
+    // The multiply spreads the pilot over all bits, a plain xor could not separate keys of a bucket
+    // whose low bits are equal
+    constexpr size_t getPerfectHashSlot(uint64_t hash, uint16_t pilot, uint32_t bits) {
+        return static_cast<size_t>(((hash ^ (pilot * PerfectHashPilotMul)) * PerfectHashSlotMul) >> (64 - bits));
+    }
+
+    template <class TSlot, class TGetKey>
+    constexpr PerfectHashResult placePerfectHashBuckets(size_t count, TGetKey getKey, uint64_t seed, size_t numBuckets,
+            uint32_t bits, uint16_t *pilots, TSlot *slots, uint64_t *hashes, uint32_t *bucketStarts, uint32_t *order,
+            uint32_t *bucketOrder) {
+        constexpr TSlot EmptySlot = static_cast<TSlot>(~TSlot(0));
+        const size_t tableSize = size_t(1) << bits;
+
+        // Sort the keys by bucket
+        for (size_t b = 0; b <= numBuckets; ++b) {
+            bucketStarts[b] = 0;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            hashes[i] = hashPerfectKey(getKey(i), seed);
+            ++bucketStarts[getPerfectHashBucket(hashes[i], numBuckets) + 1];
+        }
+        for (size_t b = 0; b < numBuckets; ++b) {
+            bucketStarts[b + 1] += bucketStarts[b];
+            bucketOrder[b] = bucketStarts[b];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            order[bucketOrder[getPerfectHashBucket(hashes[i], numBuckets)]++] = static_cast<uint32_t>(i);
+        }
+
+        // Equal keys have equal hashes, equal hashes of different keys need another seed
+        for (size_t b = 0; b < numBuckets; ++b) {
+            for (uint32_t i = bucketStarts[b]; i < bucketStarts[b + 1]; ++i) {
+                for (uint32_t j = i + 1; j < bucketStarts[b + 1]; ++j) {
+                    if (hashes[order[i]] == hashes[order[j]]) {
+                        return getKey(order[i]) == getKey(order[j]) ? PerfectHashResult::DuplicateKey : PerfectHashResult::Failed;
+                    }
+                }
+            }
+        }
+
+        // The largest buckets are placed first, while the table is still empty
+        for (size_t b = 0; b < numBuckets; ++b) {
+            bucketOrder[b] = static_cast<uint32_t>(b);
+        }
+        std::sort(bucketOrder, bucketOrder + numBuckets, [bucketStarts](uint32_t lhs, uint32_t rhs) {
+            const uint32_t lhsSize = bucketStarts[lhs + 1] - bucketStarts[lhs];
+            const uint32_t rhsSize = bucketStarts[rhs + 1] - bucketStarts[rhs];
+            return lhsSize != rhsSize ? lhsSize > rhsSize : lhs < rhs;
+        });
+
+        for (size_t i = 0; i < tableSize; ++i) {
+            slots[i] = EmptySlot;
+        }
+        for (size_t b = 0; b < numBuckets; ++b) {
+            pilots[b] = 0;
+        }
+        for (size_t i = 0; i < numBuckets; ++i) {
+            const uint32_t bucket = bucketOrder[i];
+            const uint32_t start = bucketStarts[bucket];
+            const uint32_t end = bucketStarts[bucket + 1];
+            if (start == end) {
+                break;
+            }
+
+            bool found = false;
+            for (uint32_t pilot = 0; pilot <= 0xffff && !found; ++pilot) {
+                uint32_t placed = start;
+                for (; placed < end; ++placed) {
+                    const size_t slot = getPerfectHashSlot(hashes[order[placed]], static_cast<uint16_t>(pilot), bits);
+                    if (EmptySlot != slots[slot]) {
+                        break;
+                    }
+                    slots[slot] = static_cast<TSlot>(order[placed]);
+                }
+                if (placed == end) {
+                    pilots[bucket] = static_cast<uint16_t>(pilot);
+                    found = true;
+                } else {
+                    for (uint32_t j = start; j < placed; ++j) {
+                        slots[getPerfectHashSlot(hashes[order[j]], static_cast<uint16_t>(pilot), bits)] = EmptySlot;
+                    }
+                }
+            }
+            if (!found) {
+                return PerfectHashResult::Failed;
+            }
+        }
+
+        return PerfectHashResult::Ok;
+    }
+
+    // PTHash-style construction: the keys are split into small buckets, and for every bucket a
+    // pilot value is searched which moves all its keys into free slots. A lookup hashes the key,
+    // reads the pilot of its bucket and probes exactly one slot.
+    template <class TSlot, class TGetKey>
+    constexpr PerfectHashResult buildPerfectHash(size_t count, TGetKey getKey, size_t numBuckets, uint32_t bits,
+            uint16_t *pilots, TSlot *slots, uint64_t &seed) {
+        uint64_t *hashes = new uint64_t[count + 1];
+        uint32_t *bucketStarts = new uint32_t[numBuckets + 1];
+        uint32_t *order = new uint32_t[count + 1];
+        uint32_t *bucketOrder = new uint32_t[numBuckets];
+
+        PerfectHashResult result = PerfectHashResult::Failed;
+        for (uint64_t attempt = 0; attempt < PerfectHashMaxSeeds && PerfectHashResult::Failed == result; ++attempt) {
+            seed = mixPerfectHash(attempt + 1);
+            result = placePerfectHashBuckets(count, getKey, seed, numBuckets, bits, pilots, slots, hashes, bucketStarts,
+                    order, bucketOrder);
+        }
+
+        delete[] bucketOrder;
+        delete[] order;
+        delete[] bucketStarts;
+        delete[] hashes;
+
+        return result;
+    }
+
+    // Not constexpr on purpose, a failed build in a constant expression stops the compilation in
+    // one of these, the name tells the reason
+    inline void perfectHashDuplicateKeys() {
+        assert(false && "Duplicate keys in a perfect hash map");
+    }
+
+    inline void perfectHashNoSeedFound() {
+        assert(false && "No seed of the perfect hash map placed all keys");
+    }
+
+    template <size_t N>
+    using PerfectHashSlot = std::conditional_t<(N < 0xff), uint8_t, std::conditional_t<(N < 0xffff), uint16_t, uint32_t>>;
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TStaticPerfectHashMap
+///	@ingroup	CPPCore
+///
+///	@brief  A read-only map for a fixed set of keys, built at compile time. Every key maps to its
+/// own slot, so a lookup is one hash, one pilot read and one key compare, and the whole table
+/// lives in read-only data without any startup cost. Keys are std::string_view, integers or enums.
+/// Create it with makePerfectHashMap:
+/// @code
+/// static constexpr auto Commands = makePerfectHashMap<std::string_view, int>({
+///     { "get", 1 }, { "set", 2 }, { "del", 3 } });
+/// const int *command = Commands.find(name);
+/// @endcode
+/// Duplicate keys stop the compilation in perfectHashDuplicateKeys(). When no seed places all keys,
+/// e.g. for distinct keys with the same 64 bit hash, it stops in perfectHashNoSeedFound().
+//-------------------------------------------------------------------------------------------------
+template <class K, class V, size_t N>
+class TStaticPerfectHashMap {
+public:
+    /// @brief  The number of buckets, one pilot per bucket.
+    static constexpr size_t NumBuckets = Details::getPerfectHashBuckets(N);
+    /// @brief  The number of slots is 1 << TableBits.
+    static constexpr uint32_t TableBits = Details::getPerfectHashTableBits(N);
+
+    /// @brief  A key-value pair.
+    struct Entry {
+        K m_key;
+        V m_value;
+    };
+
+    /// @brief  The class constructor, builds the table.
+    /// @param  items   [in] The key-value pairs.
+    constexpr explicit TStaticPerfectHashMap(const std::pair<K, V> (&items)[N]);
+
+    /// @brief  Returns the number of stored items.
+    /// @return The number of items.
+    static constexpr size_t size();
+
+    /// @brief  Looks up a key.
+    /// @param  key     [in] The key to look for.
+    /// @return The value, nullptr if the key is not stored.
+    constexpr const V *find(const K &key) const;
+
+    /// @brief  Looks for a given key.
+    /// @param  key     [in] The key to look for.
+    /// @return true, if the key is stored.
+    constexpr bool hasKey(const K &key) const;
+
+    /// @brief  Returns the assigned value for the given key.
+    /// @param  key     [in] The key to look for.
+    /// @param  value   [out] The value, unchanged when the key was not found.
+    /// @return true, if the key was found.
+    constexpr bool getValue(const K &key, V &value) const;
+
+    /// @brief  Returns the items in their initial order.
+    constexpr const Entry *begin() const;
+    constexpr const Entry *end() const;
+
+private:
+    using Slot = Details::PerfectHashSlot<N>;
+
+    Entry m_entries[N];
+    uint16_t m_pilots[NumBuckets];
+    Slot m_slots[size_t(1) << TableBits];
+    uint64_t m_seed;
+};
+
+template <class K, class V, size_t N>
+inline constexpr TStaticPerfectHashMap<K, V, N>::TStaticPerfectHashMap(const std::pair<K, V> (&items)[N]) :
+        m_entries{},
+        m_pilots{},
+        m_slots{},
+        m_seed(0) {
+    for (size_t i = 0; i < N; ++i) {
+        m_entries[i].m_key = items[i].first;
+        m_entries[i].m_value = items[i].second;
+    }
+    const Details::PerfectHashResult result = Details::buildPerfectHash(
+            N, [this](size_t i) { return m_entries[i].m_key; }, NumBuckets, TableBits, m_pilots, m_slots, m_seed);
+    if (Details::PerfectHashResult::DuplicateKey == result) {
+        Details::perfectHashDuplicateKeys();
+    } else if (Details::PerfectHashResult::Failed == result) {
+        Details::perfectHashNoSeedFound();
+    }
+}
+
+template <class K, class V, size_t N>
+inline constexpr size_t TStaticPerfectHashMap<K, V, N>::size() {
+    return N;
+}
+
+template <class K, class V, size_t N>
+inline constexpr const V *TStaticPerfectHashMap<K, V, N>::find(const K &key) const {
+    const uint64_t hash = Details::hashPerfectKey(key, m_seed);
+    const uint16_t pilot = m_pilots[Details::getPerfectHashBucket(hash, NumBuckets)];
+    const Slot index = m_slots[Details::getPerfectHashSlot(hash, pilot, TableBits)];
+    if (index < N && m_entries[index].m_key == key) {
+        return &m_entries[index].m_value;
+    }
+
+    return nullptr;
+}
+
+template <class K, class V, size_t N>
+inline constexpr bool TStaticPerfectHashMap<K, V, N>::hasKey(const K &key) const {
+    return nullptr != find(key);
+}
+
+template <class K, class V, size_t N>
+inline constexpr bool TStaticPerfectHashMap<K, V, N>::getValue(const K &key, V &value) const {
+    const V *found = find(key);
+    if (nullptr == found) {
+        return false;
+    }
+    value = *found;
+
+    return true;
+}
+
+template <class K, class V, size_t N>
+inline constexpr const typename TStaticPerfectHashMap<K, V, N>::Entry *TStaticPerfectHashMap<K, V, N>::begin() const {
+    return m_entries;
+}
+
+template <class K, class V, size_t N>
+inline constexpr const typename TStaticPerfectHashMap<K, V, N>::Entry *TStaticPerfectHashMap<K, V, N>::end() const {
+    return m_entries + N;
+}
+
+/// @brief  Builds a TStaticPerfectHashMap, the number of items is deduced.
+/// @param  items   [in] The key-value pairs.
+/// @return The map.
+template <class K, class V, size_t N>
+constexpr TStaticPerfectHashMap<K, V, N> makePerfectHashMap(const std::pair<K, V> (&items)[N]) {
+    return TStaticPerfectHashMap<K, V, N>(items);
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TPerfectHashMap
+///	@ingroup	CPPCore
+///
+///	@brief  The runtime-built variant of TStaticPerfectHashMap for large key sets which are only
+/// known at runtime, like keys loaded from a file. The build takes a few hundred nanoseconds per
+/// key, afterwards every lookup probes a single slot. The map cannot be changed after init().
+/// Keys are std::string, std::string_view, integers or enums.
+//-------------------------------------------------------------------------------------------------
+template <class K, class V>
+class TPerfectHashMap {
+public:
+    /// @brief  A key-value pair.
+    struct Entry {
+        K m_key;
+        V m_value;
+    };
+
+    /// @brief  The class constructor, the map is empty.
+    TPerfectHashMap();
+
+    /// @brief  The class destructor.
+    ~TPerfectHashMap();
+
+    /// @brief  Builds the map, the previous content is released.
+    /// @param  keys    [in] The keys.
+    /// @param  values  [in] The values, one per key.
+    /// @param  count   [in] The number of keys.
+    /// @return false, if the keys contain duplicates or if no seed placed all keys, e.g. for
+    ///         distinct keys with the same hash. The map is empty then.
+    bool init(const K *keys, const V *values, size_t count);
+
+    /// @brief  Releases the content.
+    void clear();
+
+    /// @brief  Returns the number of stored items.
+    /// @return The number of items.
+    size_t size() const;
+
+    /// @brief  Will return true, if the map is empty.
+    /// @return true for empty.
+    bool isEmpty() const;
+
+    /// @brief  Looks up a key.
+    /// @param  key     [in] The key to look for.
+    /// @return The value, nullptr if the key is not stored.
+    template <class TKey>
+    const V *find(const TKey &key) const;
+
+    /// @brief  Looks for a given key.
+    /// @param  key     [in] The key to look for.
+    /// @return true, if the key is stored.
+    template <class TKey>
+    bool hasKey(const TKey &key) const;
+
+    /// @brief  Returns the assigned value for the given key.
+    /// @param  key     [in] The key to look for.
+    /// @param  value   [out] The value, unchanged when the key was not found.
+    /// @return true, if the key was found.
+    template <class TKey>
+    bool getValue(const TKey &key, V &value) const;
+
+    /// @brief  Looks up many keys at once, the pilots, slots and entries of a group of keys are
+    ///         prefetched before they are read.
+    /// @param  keys    [in] The keys to look for.
+    /// @param  count   [in] The number of keys.
+    /// @param  values  [out] The value per key, nullptr when the key was not found.
+    /// @return The number of found keys.
+    template <class TKey>
+    size_t findBatch(const TKey *keys, size_t count, const V **values) const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TPerfectHashMap)
+
+private:
+    Entry *m_entries;
+    uint16_t *m_pilots;
+    uint32_t *m_slots;
+    size_t m_numItems;
+    size_t m_numBuckets;
+    uint32_t m_tableBits;
+    uint64_t m_seed;
+};
+
+template <class K, class V>
+inline TPerfectHashMap<K, V>::TPerfectHashMap() :
+        m_entries(nullptr),
+        m_pilots(nullptr),
+        m_slots(nullptr),
+        m_numItems(0),
+        m_numBuckets(0),
+        m_tableBits(0),
+        m_seed(0) {
+    // empty
+}
+
+template <class K, class V>
+inline TPerfectHashMap<K, V>::~TPerfectHashMap() {
+    clear();
+}
+
+template <class K, class V>
+inline bool TPerfectHashMap<K, V>::init(const K *keys, const V *values, size_t count) {
+    clear();
+    if (0 == count) {
+        return true;
+    }
+
+    m_numBuckets = Details::getPerfectHashBuckets(count);
+    m_tableBits = Details::getPerfectHashTableBits(count);
+    m_pilots = new uint16_t[m_numBuckets];
+    m_slots = new uint32_t[size_t(1) << m_tableBits];
+    const Details::PerfectHashResult result = Details::buildPerfectHash(
+            count, [keys](size_t i) -> const K & { return keys[i]; }, m_numBuckets, m_tableBits, m_pilots, m_slots, m_seed);
+    if (Details::PerfectHashResult::Ok != result) {
+        clear();
+        return false;
+    }
+
+    m_entries = new Entry[count];
+    for (size_t i = 0; i < count; ++i) {
+        m_entries[i].m_key = keys[i];
+        m_entries[i].m_value = values[i];
+    }
+    m_numItems = count;
+
+    return true;
+}
+
+template <class K, class V>
+inline void TPerfectHashMap<K, V>::clear() {
+    delete[] m_entries;
+    delete[] m_pilots;
+    delete[] m_slots;
+    m_entries = nullptr;
+    m_pilots = nullptr;
+    m_slots = nullptr;
+    m_numItems = 0;
+    m_numBuckets = 0;
+    m_tableBits = 0;
+}
+
+template <class K, class V>
+inline size_t TPerfectHashMap<K, V>::size() const {
+    return m_numItems;
+}
+
+template <class K, class V>
+inline bool TPerfectHashMap<K, V>::isEmpty() const {
+    return 0 == m_numItems;
+}
+
+template <class K, class V>
+template <class TKey>
+inline const V *TPerfectHashMap<K, V>::find(const TKey &key) const {
+    if (0 == m_numItems) {
+        return nullptr;
+    }
+
+    const uint64_t hash = Details::hashPerfectKey(key, m_seed);
+    const uint16_t pilot = m_pilots[Details::getPerfectHashBucket(hash, m_numBuckets)];
+    const uint32_t index = m_slots[Details::getPerfectHashSlot(hash, pilot, m_tableBits)];
+    if (index < m_numItems && m_entries[index].m_key == key) {
+        return &m_entries[index].m_value;
+    }
+
+    return nullptr;
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TPerfectHashMap<K, V>::hasKey(const TKey &key) const {
+    return nullptr != find(key);
+}
+
+template <class K, class V>
+template <class TKey>
+inline bool TPerfectHashMap<K, V>::getValue(const TKey &key, V &value) const {
+    const V *found = find(key);
+    if (nullptr == found) {
+        return false;
+    }
+    value = *found;
+
+    return true;
+}
+
+template <class K, class V>
+template <class TKey>
+inline size_t TPerfectHashMap<K, V>::findBatch(const TKey *keys, size_t count, const V **values) const {
+    if (0 == m_numItems) {
+        std::fill_n(values, count, nullptr);
+        return 0;
+    }
+
+    // The three tables are separate misses, each stage resolves one of them
+    struct State {
+        uint64_t m_hash;
+        size_t m_position;
+    };
+    size_t numFound = 0;
+    Details::runBatchLookup<State>(count,
+            [this, keys](size_t i, State &state) {
+                state.m_hash = Details::hashPerfectKey(keys[i], m_seed);
+                state.m_position = Details::getPerfectHashBucket(state.m_hash, m_numBuckets);
+                CPPCORE_PREFETCH(&m_pilots[state.m_position]);
+            },
+            [this](size_t, State &state) {
+                state.m_position = Details::getPerfectHashSlot(state.m_hash, m_pilots[state.m_position], m_tableBits);
+                CPPCORE_PREFETCH(&m_slots[state.m_position]);
+            },
+            [this](size_t, State &state) {
+                state.m_position = m_slots[state.m_position];
+                if (state.m_position < m_numItems) {
+                    CPPCORE_PREFETCH(&m_entries[state.m_position]);
+                }
+            },
+            [this, keys, values, &numFound](size_t i, State &state) {
+                if (state.m_position < m_numItems && m_entries[state.m_position].m_key == keys[i]) {
+                    values[i] = &m_entries[state.m_position].m_value;
+                    ++numFound;
+                } else {
+                    values[i] = nullptr;
+                }
+            });
+
+    return numFound;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,251 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TRingBuffer
+///	@ingroup	CPPCore
+///
+///	@brief  A ring buffer with a fixed capacity, which is allocated once by the constructor. Adding
+/// to a full buffer overwrites the oldest item, so it keeps the last capacity() items. Items can be
+/// removed at both ends, which makes it usable as a bounded deque. The items are stored in at most
+/// two contiguous segments, getSegments() returns them oldest first for loops and SIMD scans.
+/// @code
+/// TRingBuffer<float> samples(3);
+/// for (float sample : { 1.0f, 2.0f, 3.0f, 4.0f }) {
+///     samples.add(sample);
+/// }
+/// // samples[0] is 2, the 1 was overwritten
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TRingBuffer {
+public:
+    /// @brief  The stored items as two contiguous segments, the first one holds the oldest items.
+    struct Segments {
+        const T *m_first;
+        size_t m_firstCount;
+        const T *m_second;
+        size_t m_secondCount;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  capacity    [in] The number of items, at least 1.
+    explicit TRingBuffer(size_t capacity);
+
+    /// @brief  The class destructor.
+    ~TRingBuffer();
+
+    /// @brief  Returns the number of items which fit into the buffer.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    /// @brief  Returns the number of items.
+    /// @return The size.
+    size_t size() const;
+
+    /// @brief  Returns true, if the buffer is empty.
+    /// @return true for empty.
+    bool isEmpty() const;
+
+    /// @brief  Returns true, if the next add() overwrites the oldest item.
+    /// @return true for full.
+    bool isFull() const;
+
+    /// @brief  Adds an item behind the newest one, overwrites the oldest item of a full buffer.
+    /// @param  value   [in] The new item.
+    void add(const T &value);
+
+    /// @brief  Removes the oldest item.
+    void removeFront();
+
+    /// @brief  Removes the newest item.
+    void removeBack();
+
+    /// @brief  Removes all items, the capacity stays.
+    void clear();
+
+    /// @brief  Returns the oldest item.
+    T &front();
+    const T &front() const;
+
+    /// @brief  Returns the newest item.
+    T &back();
+    const T &back() const;
+
+    /// @brief  Returns the items as two contiguous segments.
+    /// @return The segments, oldest first, the second one is empty unless the items wrap around.
+    Segments getSegments() const;
+
+    /// @brief  Copies the items oldest first.
+    /// @param  dest    [out] Receives size() items.
+    void copyTo(T *dest) const;
+
+    /// @brief  The index op, 0 is the oldest item.
+    T &operator[](size_t index);
+    const T &operator[](size_t index) const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TRingBuffer)
+
+private:
+    size_t getSlot(size_t index) const;
+
+private:
+    std::vector<T> m_items;
+    size_t m_head;
+    size_t m_size;
+};
+
+template <class T>
+inline TRingBuffer<T>::TRingBuffer(size_t capacity) :
+        m_items(std::max<size_t>(1, capacity)),
+        m_head(0),
+        m_size(0) {
+    assert(0 != capacity);
+}
+
+template <class T>
+inline TRingBuffer<T>::~TRingBuffer() {
+    // empty
+}
+
+template <class T>
+inline size_t TRingBuffer<T>::capacity() const {
+    return m_items.size();
+}
+
+template <class T>
+inline size_t TRingBuffer<T>::size() const {
+    return m_size;
+}
+
+template <class T>
+inline bool TRingBuffer<T>::isEmpty() const {
+    return 0 == m_size;
+}
+
+template <class T>
+inline bool TRingBuffer<T>::isFull() const {
+    return m_items.size() == m_size;
+}
+
+template <class T>
+inline void TRingBuffer<T>::add(const T &value) {
+    if (isFull()) {
+        m_items[m_head] = value;
+        m_head = getSlot(1);
+        return;
+    }
+
+    m_items[getSlot(m_size)] = value;
+    ++m_size;
+}
+
+template <class T>
+inline void TRingBuffer<T>::removeFront() {
+    assert(!isEmpty());
+
+    m_head = getSlot(1);
+    --m_size;
+}
+
+template <class T>
+inline void TRingBuffer<T>::removeBack() {
+    assert(!isEmpty());
+
+    --m_size;
+}
+
+template <class T>
+inline void TRingBuffer<T>::clear() {
+    m_head = 0;
+    m_size = 0;
+}
+
+template <class T>
+inline T &TRingBuffer<T>::front() {
+    assert(!isEmpty());
+    return m_items[m_head];
+}
+
+template <class T>
+inline const T &TRingBuffer<T>::front() const {
+    assert(!isEmpty());
+    return m_items[m_head];
+}
+
+template <class T>
+inline T &TRingBuffer<T>::back() {
+    assert(!isEmpty());
+    return m_items[getSlot(m_size - 1)];
+}
+
+template <class T>
+inline const T &TRingBuffer<T>::back() const {
+    assert(!isEmpty());
+    return m_items[getSlot(m_size - 1)];
+}
+
+template <class T>
+inline typename TRingBuffer<T>::Segments TRingBuffer<T>::getSegments() const {
+    const size_t firstCount = std::min(m_size, m_items.size() - m_head);
+    return Segments{ m_items.data() + m_head, firstCount, m_items.data(), m_size - firstCount };
+}
+
+template <class T>
+inline void TRingBuffer<T>::copyTo(T *dest) const {
+    const Segments segments = getSegments();
+    dest = std::copy(segments.m_first, segments.m_first + segments.m_firstCount, dest);
+    std::copy(segments.m_second, segments.m_second + segments.m_secondCount, dest);
+}
+
+template <class T>
+inline T &TRingBuffer<T>::operator[](size_t index) {
+    assert(index < m_size);
+    return m_items[getSlot(index)];
+}
+
+template <class T>
+inline const T &TRingBuffer<T>::operator[](size_t index) const {
+    assert(index < m_size);
+    return m_items[getSlot(index)];
+}
+
+template <class T>
+inline size_t TRingBuffer<T>::getSlot(size_t index) const {
+    // A compare instead of a modulo, the index is below the capacity
+    const size_t slot = m_head + index;
+    return slot >= m_items.size() ? slot - m_items.size() : slot;
+}
+
+} // Namespace CPPCore
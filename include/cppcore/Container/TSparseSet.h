@@ -0,0 +1,428 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CPPCore {
+
+namespace Details {
+
+    // The sparse array is split into pages of 4096 slots, a page is allocated with the first id in
+    // its range, so large and scattered ids only cost memory for the used ranges
+    constexpr uint32_t SparseSetPageBits = 12;
+    constexpr uint32_t SparseSetPageSize = 1u << SparseSetPageBits;
+    constexpr uint32_t SparseSetPageMask = SparseSetPageSize - 1;
+
+    // Takes the place of the value array in a set without values
+    struct SparseSetNoValues {
+        // empty
+    };
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TSparseSet
+///	@ingroup	CPPCore
+///
+///	@brief  A set of integer ids with O(1) insert, remove and lookup and dense iteration. The ids
+/// are packed into a dense array, optionally together with a value per id, and a paged sparse array
+/// maps every id to its dense index. remove() moves the last id into the gap. The dense order can
+/// be sorted, sortAs() moves the ids shared with another set to the front in the order of the other
+/// set, so both can be iterated side by side. Pointers to values are invalidated by insertions,
+/// removals and sorting. bool values are not supported, the values are kept in a std::vector, use
+/// uint8_t instead.
+/// @code
+/// TSparseSet<float> health;
+/// health.insert(42, 100.0f);
+/// const uint32_t *ids = health.getIds();
+/// float *values = health.getValues();
+/// for (size_t i = 0; i < health.size(); ++i) {
+///     ::printf("%u: %f\n", ids[i], values[i]);
+/// }
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class V = void>
+class TSparseSet {
+public:
+    /// @brief  The dense index of an id which is not stored, ids must be smaller.
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    /// @brief  true, if the set stores a value per id.
+    static constexpr bool HasValues = !std::is_void_v<V>;
+
+    // std::vector<bool> is packed, it can hand out neither the value array nor value pointers
+    static_assert(!std::is_same_v<std::remove_cv_t<V>, bool>, "bool values are not supported, use uint8_t");
+
+    /// @brief  The class constructor, no memory is allocated until the first insert.
+    TSparseSet();
+
+    /// @brief  The class destructor.
+    ~TSparseSet();
+
+    /// @brief  Returns the number of stored ids.
+    /// @return The number of ids.
+    size_t size() const;
+
+    /// @brief  Will return true, if the set is empty.
+    /// @return true for empty.
+    bool isEmpty() const;
+
+    /// @brief  Grows the dense arrays, so they can hold count ids without growing again.
+    /// @param  count   [in] The number of ids.
+    void reserve(size_t count);
+
+    /// @brief  Removes all ids and releases the memory.
+    void clear();
+
+    /// @brief  Adds an id, the value of a new id is default constructed.
+    /// @param  id      [in] The id.
+    /// @return true, if the id was new.
+    bool insert(uint32_t id);
+
+    /// @brief  Adds an id with a value, the value of an existing id is replaced.
+    /// @param  id      [in] The id.
+    /// @param  value   [in] The value.
+    /// @return true, if the id was new.
+    template <class TValue = V>
+    requires(!std::is_void_v<TValue>)
+    bool insert(uint32_t id, const TValue &value);
+
+    /// @brief  Removes an id, the last id of the dense array takes its place.
+    /// @param  id      [in] The id.
+    /// @return true, if the id was found and removed.
+    bool remove(uint32_t id);
+
+    /// @brief  Looks for an id.
+    /// @param  id      [in] The id.
+    /// @return true, if the id is stored.
+    bool contains(uint32_t id) const;
+
+    /// @brief  Returns the position of an id in the dense array.
+    /// @param  id      [in] The id.
+    /// @return The dense index, InvalidIndex if the id is not stored.
+    uint32_t getIndex(uint32_t id) const;
+
+    /// @brief  Looks up the value of an id.
+    /// @param  id      [in] The id.
+    /// @return The value, nullptr if the id is not stored.
+    template <class TValue = V>
+    requires(!std::is_void_v<TValue>)
+    TValue *find(uint32_t id);
+
+    template <class TValue = V>
+    requires(!std::is_void_v<TValue>)
+    const TValue *find(uint32_t id) const;
+
+    /// @brief  Returns the dense array of ids.
+    /// @return The ids, size() many.
+    const uint32_t *getIds() const;
+
+    /// @brief  Returns the dense array of values, in the order of getIds().
+    /// @return The values, size() many.
+    template <class TValue = V>
+    requires(!std::is_void_v<TValue>)
+    TValue *getValues();
+
+    template <class TValue = V>
+    requires(!std::is_void_v<TValue>)
+    const TValue *getValues() const;
+
+    /// @brief  Sorts the dense arrays.
+    /// @param  compare [in] Returns true, if the first id goes before the second one.
+    template <class Compare>
+    void sort(Compare compare);
+
+    /// @brief  Sorts the dense arrays by ascending id.
+    void sort();
+
+    /// @brief  Moves the ids, which are stored in another set, to the front of the dense arrays in
+    ///         the order of the other set, the remaining ids follow in no particular order.
+    /// @param  other   [in] The other set.
+    /// @return The number of shared ids.
+    template <class U>
+    size_t sortAs(const TSparseSet<U> &other);
+
+    /// @brief  The dense ids.
+    const uint32_t *begin() const;
+    const uint32_t *end() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TSparseSet)
+
+private:
+    uint32_t &getSlot(uint32_t id);
+    void swapDense(uint32_t a, uint32_t b);
+
+private:
+    using ValueArray = std::conditional_t<HasValues, std::vector<std::conditional_t<HasValues, V, char>>, Details::SparseSetNoValues>;
+
+    std::vector<std::unique_ptr<uint32_t[]>> m_pages;
+    std::vector<uint32_t> m_ids;
+    [[no_unique_address]] ValueArray m_values;
+};
+
+template <class V>
+inline TSparseSet<V>::TSparseSet() :
+        m_pages(),
+        m_ids(),
+        m_values() {
+    // empty
+}
+
+template <class V>
+inline TSparseSet<V>::~TSparseSet() {
+    // empty
+}
+
+template <class V>
+inline size_t TSparseSet<V>::size() const {
+    return m_ids.size();
+}
+
+template <class V>
+inline bool TSparseSet<V>::isEmpty() const {
+    return m_ids.empty();
+}
+
+template <class V>
+inline void TSparseSet<V>::reserve(size_t count) {
+    m_ids.reserve(count);
+    if constexpr (HasValues) {
+        m_values.reserve(count);
+    }
+}
+
+template <class V>
+inline void TSparseSet<V>::clear() {
+    std::vector<std::unique_ptr<uint32_t[]>>().swap(m_pages);
+    std::vector<uint32_t>().swap(m_ids);
+    if constexpr (HasValues) {
+        ValueArray().swap(m_values);
+    }
+}
+
+template <class V>
+inline bool TSparseSet<V>::insert(uint32_t id) {
+    uint32_t &slot = getSlot(id);
+    if (InvalidIndex != slot) {
+        return false;
+    }
+
+    slot = static_cast<uint32_t>(m_ids.size());
+    m_ids.push_back(id);
+    if constexpr (HasValues) {
+        m_values.emplace_back();
+    }
+
+    return true;
+}
+
+template <class V>
+template <class TValue>
+requires(!std::is_void_v<TValue>)
+inline bool TSparseSet<V>::insert(uint32_t id, const TValue &value) {
+    uint32_t &slot = getSlot(id);
+    if (InvalidIndex != slot) {
+        m_values[slot] = value;
+        return false;
+    }
+
+    slot = static_cast<uint32_t>(m_ids.size());
+    m_ids.push_back(id);
+    m_values.push_back(value);
+
+    return true;
+}
+
+template <class V>
+inline bool TSparseSet<V>::remove(uint32_t id) {
+    const uint32_t index = getIndex(id);
+    if (InvalidIndex == index) {
+        return false;
+    }
+
+    const uint32_t last = m_ids.back();
+    m_ids[index] = last;
+    m_pages[last >> Details::SparseSetPageBits][last & Details::SparseSetPageMask] = index;
+    m_pages[id >> Details::SparseSetPageBits][id & Details::SparseSetPageMask] = InvalidIndex;
+    m_ids.pop_back();
+    if constexpr (HasValues) {
+        if (index != m_values.size() - 1) {
+            m_values[index] = std::move(m_values.back());
+        }
+        m_values.pop_back();
+    }
+
+    return true;
+}
+
+template <class V>
+inline bool TSparseSet<V>::contains(uint32_t id) const {
+    return InvalidIndex != getIndex(id);
+}
+
+template <class V>
+inline uint32_t TSparseSet<V>::getIndex(uint32_t id) const {
+    const size_t page = id >> Details::SparseSetPageBits;
+    if (page >= m_pages.size() || nullptr == m_pages[page]) {
+        return InvalidIndex;
+    }
+    return m_pages[page][id & Details::SparseSetPageMask];
+}
+
+template <class V>
+template <class TValue>
+requires(!std::is_void_v<TValue>)
+inline TValue *TSparseSet<V>::find(uint32_t id) {
+    const uint32_t index = getIndex(id);
+    return InvalidIndex == index ? nullptr : &m_values[index];
+}
+
+template <class V>
+template <class TValue>
+requires(!std::is_void_v<TValue>)
+inline const TValue *TSparseSet<V>::find(uint32_t id) const {
+    const uint32_t index = getIndex(id);
+    return InvalidIndex == index ? nullptr : &m_values[index];
+}
+
+template <class V>
+inline const uint32_t *TSparseSet<V>::getIds() const {
+    return m_ids.data();
+}
+
+template <class V>
+template <class TValue>
+requires(!std::is_void_v<TValue>)
+inline TValue *TSparseSet<V>::getValues() {
+    return m_values.data();
+}
+
+template <class V>
+template <class TValue>
+requires(!std::is_void_v<TValue>)
+inline const TValue *TSparseSet<V>::getValues() const {
+    return m_values.data();
+}
+
+template <class V>
+template <class Compare>
+inline void TSparseSet<V>::sort(Compare compare) {
+    if constexpr (HasValues) {
+        // The values move once, in the order of a sorted permutation
+        std::vector<uint32_t> order(m_ids.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [this, &compare](uint32_t a, uint32_t b) {
+            return compare(m_ids[a], m_ids[b]);
+        });
+        std::vector<uint32_t> ids(m_ids.size());
+        ValueArray values;
+        values.reserve(m_values.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            ids[i] = m_ids[order[i]];
+            values.push_back(std::move(m_values[order[i]]));
+        }
+        m_ids.swap(ids);
+        m_values.swap(values);
+    } else {
+        std::sort(m_ids.begin(), m_ids.end(), compare);
+    }
+
+    for (size_t i = 0; i < m_ids.size(); ++i) {
+        const uint32_t id = m_ids[i];
+        m_pages[id >> Details::SparseSetPageBits][id & Details::SparseSetPageMask] = static_cast<uint32_t>(i);
+    }
+}
+
+template <class V>
+inline void TSparseSet<V>::sort() {
+    sort([](uint32_t a, uint32_t b) {
+        return a < b;
+    });
+}
+
+template <class V>
+template <class U>
+inline size_t TSparseSet<V>::sortAs(const TSparseSet<U> &other) {
+    uint32_t numShared = 0;
+    for (const uint32_t id : other) {
+        const uint32_t index = getIndex(id);
+        if (InvalidIndex != index) {
+            swapDense(index, numShared++);
+        }
+    }
+    return numShared;
+}
+
+template <class V>
+inline const uint32_t *TSparseSet<V>::begin() const {
+    return m_ids.data();
+}
+
+template <class V>
+inline const uint32_t *TSparseSet<V>::end() const {
+    return m_ids.data() + m_ids.size();
+}
+
+template <class V>
+inline uint32_t &TSparseSet<V>::getSlot(uint32_t id) {
+    assert(InvalidIndex != id);
+    const size_t page = id >> Details::SparseSetPageBits;
+    if (page >= m_pages.size()) {
+        m_pages.resize(page + 1);
+    }
+    if (nullptr == m_pages[page]) {
+        m_pages[page].reset(new uint32_t[Details::SparseSetPageSize]);
+        std::fill_n(m_pages[page].get(), Details::SparseSetPageSize, InvalidIndex);
+    }
+    return m_pages[page][id & Details::SparseSetPageMask];
+}
+
+template <class V>
+inline void TSparseSet<V>::swapDense(uint32_t a, uint32_t b) {
+    if (a == b) {
+        return;
+    }
+
+    const uint32_t idA = m_ids[a];
+    const uint32_t idB = m_ids[b];
+    std::swap(m_ids[a], m_ids[b]);
+    m_pages[idA >> Details::SparseSetPageBits][idA & Details::SparseSetPageMask] = b;
+    m_pages[idB >> Details::SparseSetPageBits][idB & Details::SparseSetPageMask] = a;
+    if constexpr (HasValues) {
+        using std::swap;
+        swap(m_values[a], m_values[b]);
+    }
+}
+
+} // Namespace CPPCore
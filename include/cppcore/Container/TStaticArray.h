@@ -24,133 +24,271 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string.h>
 #include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
 
 namespace CPPCore {
 
+namespace Details {
+
+    // Element-wise loops up to this length are unrolled at compile time, longer ones are left to
+    // the vectorizer
+    constexpr size_t MaxUnrolledLength = 16;
+
+    template <size_t len, class TFunc>
+    constexpr void forEachIndex(TFunc func) {
+        if constexpr (len <= MaxUnrolledLength) {
+            [&func]<size_t... Index>(std::index_sequence<Index...>) {
+                (func(Index), ...);
+            }(std::make_index_sequence<len>());
+        } else {
+            for (size_t i = 0; i < len; ++i) {
+                func(i);
+            }
+        }
+    }
+
+} // Namespace Details
+
 //-------------------------------------------------------------------------------------------------
-///	@class		TArray
+///	@class		TStaticArray
 ///	@ingroup	CPPCore
 ///
-///	@brief	This template class implements a simple array with dynamic boundaries.
-/// You can use it to add new items, remove them and iterate through them. The data items are
-/// stores in an array.
+///	@brief	This template class implements an array with a fixed length. It is an aggregate without
+/// any overhead, so it can be brace-initialized, used in constant expressions and is trivially
+/// copyable for trivially copyable types:
+/// @code
+/// constexpr TStaticArray<int, 3> values = { 1, 2, 3 };
+/// static_assert(6 == values[0] + values[1] + values[2]);
+/// @endcode
+/// Fill, compare and copy use memset, memcmp and memcpy where the type allows it. Arrays of
+/// arithmetic types support element-wise arithmetic, unrolled for short arrays.
 //-------------------------------------------------------------------------------------------------
 template <class T, size_t len>
 class TStaticArray {
-public:
-    /// @brief  The default class constructor.
-    TStaticArray();
+    static_assert(len > 0, "A TStaticArray needs at least one item");
 
-    /// @brief  The class constructor with the initial value.
-    /// @param  initValue   [in] The initial value.
-    TStaticArray(T initValue);
-
-    /// @brief  The copy constructor.
-    /// @param  rhs [in] The array to copy from.
-    TStaticArray(const TStaticArray<T, len> &rhs);
-
-    /// @brief  The class destructor.
-    ~TStaticArray() = default;
+public:
+    /// @brief  Returns an array with all items set to the same value.
+    /// @param  value   [in] The initial value.
+    /// @return The array.
+    static constexpr TStaticArray<T, len> filled(const T &value);
 
     /// @brief  Returns the number of items in the array.
-    /// @retun  The size of the array.
-    size_t size() const;
+    /// @return The size of the array.
+    static constexpr size_t size();
 
     /// @brief  Will set the item at the given index.
     /// @param  index   [in] The requested index.
     /// @param  value   [in] The new value.
-    void set(size_t index, T value);
+    constexpr void set(size_t index, const T &value);
 
     /// @brief  Will set all values to the same value.
     /// @param  value.  [in] The value to set.
-    void memset(T value);
+    constexpr void memset(const T &value);
 
-    /// @brief  The index op.
-    T operator[](size_t index) const;
+    /// @brief  Returns a pointer to the first item.
+    /// @return The pointer.
+    constexpr T *data();
+
+    /// @brief  Returns a pointer to the first item.
+    /// @return The pointer.
+    constexpr const T *data() const;
+
+    /// @brief  Returns the iterators for range-based for loops.
+    constexpr T *begin();
+    constexpr T *end();
+    constexpr const T *begin() const;
+    constexpr const T *end() const;
 
     /// @brief  The index op.
-    T &operator[](size_t index);
-    bool operator==(const TStaticArray<T, len> &rhs) const;
-    TStaticArray<T, len> &operator=(const TStaticArray<T, len> &rhs);
+    constexpr const T &operator[](size_t index) const;
 
-private:
+    /// @brief  The index op.
+    constexpr T &operator[](size_t index);
+
+    /// @brief  Compares all items.
+    constexpr bool operator==(const TStaticArray<T, len> &rhs) const;
+
+    /// @brief  Element-wise arithmetic, only for arithmetic types.
+    constexpr TStaticArray<T, len> &operator+=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> &operator-=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> &operator*=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> &operator/=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> &operator*=(T scalar) requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> operator+(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> operator-(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> operator*(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> operator/(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T>;
+    constexpr TStaticArray<T, len> operator*(T scalar) const requires std::is_arithmetic_v<T>;
+
+    /// @brief  The items, public only to keep the class an aggregate. Use the accessors.
     T m_array[len];
-    size_t m_len;
 };
 
 template <class T, size_t len>
-inline TStaticArray<T, len>::TStaticArray() :
-        m_len(len) {
-    // empty
-}
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::filled(const T &value) {
+    TStaticArray<T, len> result{};
+    result.memset(value);
 
-template <class T, size_t len>
-inline TStaticArray<T, len>::TStaticArray(T initValue) :
-        m_len(len) {
-    memset(initValue);
+    return result;
 }
 
 template <class T, size_t len>
-inline TStaticArray<T, len>::TStaticArray(const TStaticArray<T, len> &rhs) :
-        m_len(rhs.m_len) {
-    for (size_t i = 0; i < m_len; ++i) {
-        m_array[i] = rhs.m_array[i];
-    }
+inline constexpr size_t TStaticArray<T, len>::size() {
+    return len;
 }
 
 template <class T, size_t len>
-inline void TStaticArray<T, len>::set(size_t index, T value) {
-    assert(index < m_len);
+inline constexpr void TStaticArray<T, len>::set(size_t index, const T &value) {
+    assert(index < len);
 
     m_array[index] = value;
 }
 
 template <class T, size_t len>
-inline void TStaticArray<T, len>::memset(T value) {
-    for (size_t i = 0; i < m_len; ++i) {
+inline constexpr void TStaticArray<T, len>::memset(const T &value) {
+    if constexpr (std::is_trivially_copyable_v<T> && 1 == sizeof(T)) {
+        if (!std::is_constant_evaluated()) {
+            unsigned char byte = 0;
+            ::memcpy(&byte, &value, 1);
+            ::memset(m_array, byte, len);
+            return;
+        }
+    }
+    for (size_t i = 0; i < len; ++i) {
         m_array[i] = value;
     }
 }
 
 template <class T, size_t len>
-inline size_t TStaticArray<T, len>::size() const {
-    return m_len;
+inline constexpr T *TStaticArray<T, len>::data() {
+    return m_array;
 }
 
 template <class T, size_t len>
-inline T TStaticArray<T, len>::operator[](size_t index) const {
-    assert(index < m_len);
+inline constexpr const T *TStaticArray<T, len>::data() const {
+    return m_array;
+}
+
+template <class T, size_t len>
+inline constexpr T *TStaticArray<T, len>::begin() {
+    return m_array;
+}
+
+template <class T, size_t len>
+inline constexpr T *TStaticArray<T, len>::end() {
+    return m_array + len;
+}
+
+template <class T, size_t len>
+inline constexpr const T *TStaticArray<T, len>::begin() const {
+    return m_array;
+}
+
+template <class T, size_t len>
+inline constexpr const T *TStaticArray<T, len>::end() const {
+    return m_array + len;
+}
+
+template <class T, size_t len>
+inline constexpr const T &TStaticArray<T, len>::operator[](size_t index) const {
+    assert(index < len);
 
     return m_array[index];
 }
 
 template <class T, size_t len>
-inline T &TStaticArray<T, len>::operator[](size_t index) {
+inline constexpr T &TStaticArray<T, len>::operator[](size_t index) {
+    assert(index < len);
+
     return m_array[index];
 }
 
 template <class T, size_t len>
-inline bool TStaticArray<T, len>::operator==(const TStaticArray<T, len> &rhs) const {
-    for (size_t i = 0; i < m_len; ++i) {
-        if (m_array[i] != rhs.m_array[i]) {
-            return false;
+inline constexpr bool TStaticArray<T, len>::operator==(const TStaticArray<T, len> &rhs) const {
+    // Equal values have equal bytes only without padding and for integers, not for floats
+    if constexpr (std::has_unique_object_representations_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            return 0 == ::memcmp(m_array, rhs.m_array, sizeof(m_array));
         }
     }
+    if constexpr (std::is_arithmetic_v<T>) {
+        // No early exit, so the compiler can vectorize it
+        bool equal = true;
+        for (size_t i = 0; i < len; ++i) {
+            equal &= m_array[i] == rhs.m_array[i];
+        }
+        return equal;
+    } else {
+        for (size_t i = 0; i < len; ++i) {
+            if (!(m_array[i] == rhs.m_array[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
 
-    return true;
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> &TStaticArray<T, len>::operator+=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T> {
+    Details::forEachIndex<len>([this, &rhs](size_t i) { m_array[i] += rhs.m_array[i]; });
+    return *this;
 }
 
 template <class T, size_t len>
-inline TStaticArray<T, len> &TStaticArray<T, len>::operator=(const TStaticArray<T, len> &rhs) {
-    if (*this == rhs) {
-        return *this;
-    }
+inline constexpr TStaticArray<T, len> &TStaticArray<T, len>::operator-=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T> {
+    Details::forEachIndex<len>([this, &rhs](size_t i) { m_array[i] -= rhs.m_array[i]; });
+    return *this;
+}
 
-    for (unsigned int i = 0; i < m_len; ++i) {
-        m_array[i] = rhs.m_array[i];
-    }
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> &TStaticArray<T, len>::operator*=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T> {
+    Details::forEachIndex<len>([this, &rhs](size_t i) { m_array[i] *= rhs.m_array[i]; });
+    return *this;
+}
 
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> &TStaticArray<T, len>::operator/=(const TStaticArray<T, len> &rhs) requires std::is_arithmetic_v<T> {
+    Details::forEachIndex<len>([this, &rhs](size_t i) { m_array[i] /= rhs.m_array[i]; });
     return *this;
 }
 
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> &TStaticArray<T, len>::operator*=(T scalar) requires std::is_arithmetic_v<T> {
+    Details::forEachIndex<len>([this, scalar](size_t i) { m_array[i] *= scalar; });
+    return *this;
+}
+
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::operator+(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T> {
+    TStaticArray<T, len> result = *this;
+    return result += rhs;
+}
+
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::operator-(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T> {
+    TStaticArray<T, len> result = *this;
+    return result -= rhs;
+}
+
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::operator*(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T> {
+    TStaticArray<T, len> result = *this;
+    return result *= rhs;
+}
+
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::operator/(const TStaticArray<T, len> &rhs) const requires std::is_arithmetic_v<T> {
+    TStaticArray<T, len> result = *this;
+    return result /= rhs;
+}
+
+template <class T, size_t len>
+inline constexpr TStaticArray<T, len> TStaticArray<T, len>::operator*(T scalar) const requires std::is_arithmetic_v<T> {
+    TStaticArray<T, len> result = *this;
+    return result *= scalar;
+}
+
 } // namespace CPPCore
@@ -0,0 +1,283 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/// @brief  Log calls below this level are removed at compile time, 0 keeps all levels.
+#ifndef CPPCORE_LOG_MIN_LEVEL
+#   define CPPCORE_LOG_MIN_LEVEL 0
+#endif
+
+namespace CPPCore {
+
+/// @brief  The severity of a log message.
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Fatal,
+    Off
+};
+
+/// @brief  What a thread does when its ring buffer is full.
+enum class LogFullPolicy {
+    Block,  ///< Waits for the background thread, no message is lost.
+    Drop    ///< Drops the message and counts it.
+};
+
+/// @brief  A log call site, the static instance of the site serves as the id of its format string.
+struct LogSite {
+    LogLevel m_level;
+    const char *m_format;
+    const char *m_file;
+    int m_line;
+};
+
+/// @brief  The settings of the logger.
+struct LoggerOptions {
+    size_t m_ringSize;              ///< The ring buffer size per thread in bytes, a power of two.
+    LogFullPolicy m_policy;         ///< The behavior for a full ring buffer.
+    LogLevel m_level;               ///< The initial runtime level.
+    uint32_t m_flushIntervalMs;     ///< The time the background thread sleeps between two passes.
+
+    LoggerOptions() :
+            m_ringSize(1 << 16),
+            m_policy(LogFullPolicy::Block),
+            m_level(LogLevel::Info),
+            m_flushIntervalMs(5) {
+        // empty
+    }
+};
+
+namespace Details {
+
+    enum class LogArgType : uint8_t {
+        Int,
+        UInt,
+        Double,
+        String,
+        Pointer
+    };
+
+    // The head of every record in a ring buffer, the arguments follow as type tag and raw value
+    struct LogRecord {
+        uint32_t m_size;
+        uint32_t m_numArgs;
+        const LogSite *m_site;
+        uint64_t m_timestamp;
+    };
+
+    template <class T>
+    constexpr LogArgType getLogArgType() {
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_floating_point_v<Type>) {
+            return LogArgType::Double;
+        } else if constexpr (std::is_same_v<Type, bool>) {
+            return LogArgType::Int;
+        } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+            return std::is_signed_v<Type> || std::is_enum_v<Type> ? LogArgType::Int : LogArgType::UInt;
+        } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*> || std::is_same_v<Type, std::string>) {
+            return LogArgType::String;
+        } else {
+            static_assert(std::is_pointer_v<Type>, "Unsupported log argument type");
+            return LogArgType::Pointer;
+        }
+    }
+
+    template <class T>
+    inline const char *getLogString(const T &value) {
+        if constexpr (std::is_same_v<std::decay_t<T>, std::string>) {
+            return value.c_str();
+        } else if constexpr (std::is_array_v<T>) {
+            return value;
+        } else {
+            return nullptr == value ? "(null)" : static_cast<const char*>(value);
+        }
+    }
+
+    template <class T>
+    inline size_t getLogArgSize(const T &value) {
+        if constexpr (LogArgType::String == getLogArgType<T>()) {
+            return 1 + sizeof(uint32_t) + ::strlen(getLogString(value));
+        } else {
+            return 1 + sizeof(uint64_t);
+        }
+    }
+
+    template <class T>
+    inline char *encodeLogArg(char *out, const T &value) {
+        constexpr LogArgType type = getLogArgType<T>();
+        *out++ = static_cast<char>(type);
+        if constexpr (LogArgType::String == type) {
+            const char *str = getLogString(value);
+            const uint32_t len = static_cast<uint32_t>(::strlen(str));
+            ::memcpy(out, &len, sizeof(len));
+            ::memcpy(out + sizeof(len), str, len);
+            return out + sizeof(len) + len;
+        } else {
+            uint64_t raw = 0;
+            if constexpr (LogArgType::Double == type) {
+                const double converted = static_cast<double>(value);
+                ::memcpy(&raw, &converted, sizeof(raw));
+            } else if constexpr (LogArgType::Pointer == type) {
+                raw = reinterpret_cast<uintptr_t>(value);
+            } else {
+                raw = static_cast<uint64_t>(value);
+            }
+            ::memcpy(out, &raw, sizeof(raw));
+            return out + sizeof(raw);
+        }
+    }
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		AsyncLogger
+///	@ingroup	CPPCore
+///
+///	@brief  A low-latency logger for hot paths. A log call copies the id of its call site, a
+/// timestamp and the raw arguments into a ring buffer of the calling thread, nothing else. A
+/// background thread merges the rings by time, formats the messages printf-style and writes them
+/// with writev in batches. Use the macros, which drop levels below CPPCORE_LOG_MIN_LEVEL at compile
+/// time and check the runtime level before the arguments are evaluated:
+/// @code
+/// AsyncLogger::open("service.log");
+/// CPPCORE_LOG_INFO("accepted %s on port %d", address, port);
+/// AsyncLogger::close();
+/// @endcode
+/// Arguments may be integers, floating point values, C strings, std::string and pointers. The
+/// format supports the printf conversions except for '*' widths and %n.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT AsyncLogger {
+public:
+    /// @brief  Opens the log file in append mode and starts the background thread.
+    /// @param  path    [in] The file name.
+    /// @param  options [in] The settings.
+    /// @return false, if the file cannot be opened or the logger is already open.
+    static bool open(const char *path, const LoggerOptions &options = LoggerOptions());
+
+    /// @brief  Starts the background thread writing into an open file descriptor, like 2 for stderr.
+    /// @param  fd      [in] The file descriptor, it stays open on close.
+    /// @param  options [in] The settings.
+    /// @return false, if the logger is already open.
+    static bool open(int fd, const LoggerOptions &options = LoggerOptions());
+
+    /// @brief  Writes all pending messages and stops the background thread.
+    static void close();
+
+    /// @brief  Waits until all messages logged before the call are written.
+    static void flush();
+
+    /// @brief  Sets the runtime level, messages below it are ignored.
+    /// @param  level   [in] The level.
+    static void setLevel(LogLevel level);
+
+    /// @brief  Returns the runtime level.
+    /// @return The level, Off while the logger is closed.
+    static LogLevel getLevel();
+
+    /// @brief  Checks the runtime level.
+    /// @param  level   [in] The level of a message.
+    /// @return true, if messages of this level are logged.
+    static bool isEnabled(LogLevel level);
+
+    /// @brief  Returns the number of dropped messages since the logger was opened.
+    /// @return The number of dropped messages.
+    static uint64_t getNumDropped();
+
+    /// @brief  Logs a message, use the CPPCORE_LOG macros instead.
+    /// @param  site    [in] The static call site.
+    /// @param  args    [in] The arguments of the format string.
+    template <class... Args>
+    static void log(const LogSite &site, const Args &...args);
+
+private:
+    static char *reserve(size_t size);
+    static void commit(size_t size);
+
+    // The TSC on x86, steady clock ticks elsewhere, the background thread converts it
+    static uint64_t getTimestamp();
+
+    static std::atomic<uint8_t> s_level;
+};
+
+inline bool AsyncLogger::isEnabled(LogLevel level) {
+    return static_cast<uint8_t>(level) >= s_level.load(std::memory_order_relaxed);
+}
+
+inline uint64_t AsyncLogger::getTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+template <class... Args>
+inline void AsyncLogger::log(const LogSite &site, const Args &...args) {
+    const size_t size = (sizeof(Details::LogRecord) + (size_t(0) + ... + Details::getLogArgSize(args)) + 7) & ~size_t(7);
+    char *memory = reserve(size);
+    if (nullptr == memory) {
+        return;
+    }
+
+    Details::LogRecord *record = reinterpret_cast<Details::LogRecord*>(memory);
+    record->m_size = static_cast<uint32_t>(size);
+    record->m_numArgs = static_cast<uint32_t>(sizeof...(Args));
+    record->m_site = &site;
+    record->m_timestamp = getTimestamp();
+    char *out = memory + sizeof(Details::LogRecord);
+    ((out = Details::encodeLogArg(out, args)), ...);
+    (void) out;
+    commit(size);
+}
+
+} // Namespace CPPCore
+
+/// @brief  Logs a printf-style message with the given level.
+#define CPPCORE_LOG(level, format, ...)                                                                 \
+    do {                                                                                                \
+        if constexpr (static_cast<int>(level) >= CPPCORE_LOG_MIN_LEVEL) {                               \
+            if (::CPPCore::AsyncLogger::isEnabled(level)) {                                             \
+                static constexpr ::CPPCore::LogSite cppcoreLogSite = { level, format, __FILE__, __LINE__ }; \
+                ::CPPCore::AsyncLogger::log(cppcoreLogSite __VA_OPT__(,) __VA_ARGS__);                  \
+            }                                                                                           \
+        }                                                                                               \
+    } while (false)
+
+#define CPPCORE_LOG_TRACE(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Trace, format __VA_OPT__(,) __VA_ARGS__)
+#define CPPCORE_LOG_DEBUG(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Debug, format __VA_OPT__(,) __VA_ARGS__)
+#define CPPCORE_LOG_INFO(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Info, format __VA_OPT__(,) __VA_ARGS__)
+#define CPPCORE_LOG_WARN(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Warn, format __VA_OPT__(,) __VA_ARGS__)
+#define CPPCORE_LOG_ERROR(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Error, format __VA_OPT__(,) __VA_ARGS__)
+#define CPPCORE_LOG_FATAL(format, ...) CPPCORE_LOG(::CPPCore::LogLevel::Fatal, format __VA_OPT__(,) __VA_ARGS__)
@@ -0,0 +1,125 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <sys/socket.h>
+
+#include <vector>
+
+struct mmsghdr;
+struct iovec;
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		DatagramBatch
+///	@ingroup	CPPCore
+///
+///	@brief  A set of datagram buffers for recvmmsg and sendmmsg, so one system call moves many
+/// datagrams. All buffers live in one block. After receive() every datagram keeps its source
+/// address, sending the same batch back answers every sender. Available on Linux only.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT DatagramBatch {
+public:
+    /// @brief  The class constructor.
+    /// @param  capacity    [in] The number of datagrams.
+    /// @param  bufferSize  [in] The buffer size per datagram.
+    DatagramBatch(size_t capacity, size_t bufferSize);
+
+    /// @brief  The class destructor.
+    ~DatagramBatch();
+
+    /// @brief  Receives as many datagrams as available, up to the capacity, without blocking.
+    /// @param  fd      [in] The socket.
+    /// @return The number of datagrams, 0 if none is available, -1 on an error.
+    int receive(int fd);
+
+    /// @brief  Sends the first datagrams of the batch, to their addresses if set.
+    /// @param  fd      [in] The socket.
+    /// @param  count   [in] The number of datagrams to send.
+    /// @return The number of sent datagrams, -1 on an error.
+    int send(int fd, size_t count);
+
+    /// @brief  Returns the number of datagrams.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    /// @brief  Returns the buffer of a datagram.
+    /// @param  index   [in] The datagram index.
+    /// @return The buffer with getBufferSize() bytes.
+    char *getData(size_t index);
+
+    /// @brief  Returns the size of a datagram.
+    /// @param  index   [in] The datagram index.
+    /// @return The size in bytes.
+    size_t getSize(size_t index) const;
+
+    /// @brief  Sets the size of a datagram to send.
+    /// @param  index   [in] The datagram index.
+    /// @param  size    [in] The size in bytes, at most getBufferSize().
+    void setSize(size_t index, size_t size);
+
+    /// @brief  Returns the buffer size per datagram.
+    /// @return The buffer size.
+    size_t getBufferSize() const;
+
+    /// @brief  Clears the addresses, the datagrams go to the connected peer then.
+    void clearAddresses();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(DatagramBatch)
+
+private:
+    size_t m_capacity;
+    size_t m_bufferSize;
+    std::vector<char> m_buffer;
+    std::vector<size_t> m_sizes;
+    std::vector<sockaddr_storage> m_addresses;
+    std::vector<socklen_t> m_addressLengths;
+    mmsghdr *m_messages;
+    iovec *m_iovecs;
+};
+
+inline size_t DatagramBatch::capacity() const {
+    return m_capacity;
+}
+
+inline char *DatagramBatch::getData(size_t index) {
+    return &m_buffer[index * m_bufferSize];
+}
+
+inline size_t DatagramBatch::getSize(size_t index) const {
+    return m_sizes[index];
+}
+
+inline void DatagramBatch::setSize(size_t index, size_t size) {
+    m_sizes[index] = size < m_bufferSize ? size : m_bufferSize;
+}
+
+inline size_t DatagramBatch::getBufferSize() const {
+    return m_bufferSize;
+}
+
+} // Namespace CPPCore
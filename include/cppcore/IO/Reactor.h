@@ -0,0 +1,205 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Async/TTimerWheel.h>
+#include <cppcore/Threading/TMpscQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Reactor
+///	@ingroup	CPPCore
+///
+///	@brief  An event loop on epoll. File descriptors are watched edge-triggered, so a handler has
+/// to read or write until EAGAIN. Other threads hand tasks in by post(), they go through a
+/// lock-free queue and an eventfd wakes the loop, at most one wakeup is pending at a time. The
+/// timers live in a TTimerWheel with a tick of one millisecond, the epoll timeout is taken from
+/// the next expiry. Everything but post() and stop() must be called from the loop thread.
+/// Available on Linux only.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Reactor {
+public:
+    /// @brief  The event bits.
+    enum EventBits : uint32_t {
+        Readable = 1,   ///< Data can be read.
+        Writable = 2,   ///< Data can be written.
+        Closed = 4      ///< The peer hung up or an error occurred.
+    };
+
+    /// @brief  The handler of a file descriptor, gets the event bits.
+    using Handler = std::function<void(uint32_t events)>;
+
+    /// @brief  A task or timer function.
+    using Task = std::function<void()>;
+
+    /// @brief  The handle of a timer.
+    using TimerHandle = TTimerWheel<Task>::Handle;
+
+    /// @brief  The class constructor.
+    Reactor();
+
+    /// @brief  The class destructor, pending tasks are dropped.
+    ~Reactor();
+
+    /// @brief  Returns true, if epoll and the eventfd could be created.
+    /// @return true, if valid.
+    bool isValid() const;
+
+    /// @brief  Starts watching a file descriptor, it should be non-blocking.
+    /// @param  fd      [in] The file descriptor.
+    /// @param  events  [in] The event bits of interest, Readable and / or Writable.
+    /// @param  handler [in] The handler.
+    /// @return true, if successful.
+    bool add(int fd, uint32_t events, Handler handler);
+
+    /// @brief  Changes the events of interest of a watched file descriptor.
+    /// @param  fd      [in] The file descriptor.
+    /// @param  events  [in] The event bits of interest.
+    /// @return true, if successful.
+    bool modify(int fd, uint32_t events);
+
+    /// @brief  Stops watching a file descriptor, it may be removed from within its handler.
+    /// @param  fd      [in] The file descriptor.
+    /// @return true, if it was watched.
+    bool remove(int fd);
+
+    /// @brief  Runs a task in the loop thread, can be called from any thread.
+    /// @param  task    [in] The task.
+    void post(Task task);
+
+    /// @brief  Runs a function after a delay.
+    /// @param  delayMs [in] The delay in milliseconds.
+    /// @param  task    [in] The function.
+    /// @return The timer handle.
+    TimerHandle runAfter(uint64_t delayMs, Task task);
+
+    /// @brief  Cancels a timer.
+    /// @param  handle  [inout] The timer handle.
+    /// @return true, if the timer was pending.
+    bool cancel(TimerHandle &handle);
+
+    /// @brief  Runs one round: waits for events, then runs the handlers, the posted tasks and
+    /// the expired timers.
+    /// @param  timeoutMs   [in] The maximum wait in milliseconds, -1 to wait without limit.
+    /// @return The number of handlers, tasks and timers which were run.
+    size_t runOnce(int timeoutMs);
+
+    /// @brief  Runs the loop until stop() is called.
+    void run();
+
+    /// @brief  Lets run() return, can be called from any thread.
+    void stop();
+
+    /// @brief  Returns true, if the calling thread runs this loop.
+    /// @return true, if in the loop thread.
+    bool isInLoopThread() const;
+
+    /// @brief  Returns the loop time in milliseconds since the construction.
+    /// @return The time.
+    uint64_t getNow() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Reactor)
+
+private:
+    struct Registration;
+    struct PostedTask;
+
+    void wakeup();
+    size_t runTasks();
+    uint64_t readClock() const;
+
+private:
+    int m_epoll;
+    int m_eventFd;
+    std::vector<Registration*> m_registrations;
+    std::vector<Registration*> m_graveyard;
+    bool m_dispatching;
+    TMpscQueue<PostedTask> m_tasks;
+    std::atomic<bool> m_wakeupPending;
+    std::atomic<bool> m_stopped;
+    std::atomic<std::thread::id> m_loopThread;
+    TTimerWheel<Task> m_timers;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_now;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ReactorGroup
+///	@ingroup	CPPCore
+///
+///	@brief  Runs one Reactor per thread, usually one per core. Together with SO_REUSEPORT every
+/// loop can own a listening socket on the same port and the kernel spreads the load.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ReactorGroup {
+public:
+    /// @brief  The class constructor, starts the loops.
+    /// @param  numLoops    [in] The number of loops, 0 for the number of hardware threads.
+    explicit ReactorGroup(size_t numLoops = 0);
+
+    /// @brief  The class destructor, stops and joins the loops.
+    ~ReactorGroup();
+
+    /// @brief  Returns the number of loops.
+    /// @return The number of loops.
+    size_t getNumLoops() const;
+
+    /// @brief  Returns a loop.
+    /// @param  index   [in] The loop index.
+    /// @return The loop.
+    Reactor &getReactor(size_t index);
+
+    /// @brief  Returns the loops round robin.
+    /// @return The next loop.
+    Reactor &getNext();
+
+    /// @brief  Stops and joins all loops.
+    void stop();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ReactorGroup)
+
+private:
+    std::vector<Reactor*> m_reactors;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_next;
+};
+
+inline uint64_t Reactor::getNow() const {
+    return m_now;
+}
+
+inline size_t ReactorGroup::getNumLoops() const {
+    return m_reactors.size();
+}
+
+} // Namespace CPPCore
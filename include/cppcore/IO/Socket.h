@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Socket
+///	@ingroup	CPPCore
+///
+///	@brief  Helpers for IPv4 sockets on POSIX systems. The returned sockets are non-blocking and
+/// close-on-exec, -1 is returned on errors. With reusePort several sockets can be bound to the
+/// same port, one per event loop, and the kernel balances the traffic between them.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Socket {
+public:
+    /// @brief  Opens a listening TCP socket.
+    /// @param  address     [in] The address to bind to, e.g. "127.0.0.1" or "0.0.0.0".
+    /// @param  port        [in] The port, 0 for an ephemeral one.
+    /// @param  reusePort   [in] true to set SO_REUSEPORT.
+    /// @param  backlog     [in] The listen backlog.
+    /// @return The socket.
+    static int openTcpListener(const char *address, uint16_t port, bool reusePort, int backlog = 128);
+
+    /// @brief  Opens a TCP connection, the connect itself is blocking.
+    /// @param  address     [in] The address to connect to.
+    /// @param  port        [in] The port.
+    /// @return The socket.
+    static int connectTcp(const char *address, uint16_t port);
+
+    /// @brief  Accepts a connection.
+    /// @param  listener    [in] The listening socket.
+    /// @return The socket, -1 if none is pending.
+    static int accept(int listener);
+
+    /// @brief  Opens a bound UDP socket.
+    /// @param  address     [in] The address to bind to.
+    /// @param  port        [in] The port, 0 for an ephemeral one.
+    /// @param  reusePort   [in] true to set SO_REUSEPORT.
+    /// @return The socket.
+    static int openUdp(const char *address, uint16_t port, bool reusePort);
+
+    /// @brief  Connects a UDP socket to a default peer.
+    /// @param  fd          [in] The socket.
+    /// @param  address     [in] The peer address.
+    /// @param  port        [in] The peer port.
+    /// @return true, if successful.
+    static bool connectUdp(int fd, const char *address, uint16_t port);
+
+    /// @brief  Switches a file descriptor to non-blocking mode.
+    /// @param  fd          [in] The file descriptor.
+    /// @return true, if successful.
+    static bool setNonBlocking(int fd);
+
+    /// @brief  Disables Nagle's algorithm.
+    /// @param  fd          [in] The TCP socket.
+    /// @return true, if successful.
+    static bool setNoDelay(int fd);
+
+    /// @brief  Returns the local port of a bound socket.
+    /// @param  fd          [in] The socket.
+    /// @return The port, 0 on an error.
+    static uint16_t getLocalPort(int fd);
+
+    /// @brief  Closes a socket.
+    /// @param  fd          [in] The socket.
+    static void close(int fd);
+};
+
+} // Namespace CPPCore
@@ -0,0 +1,124 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace CPPCore {
+
+namespace Details {
+    struct SlotCache;
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ConcurrentSlotPool
+///	@ingroup	CPPCore
+///
+///	@brief  A thread-safe pool of equally sized slots. Every thread keeps its own list of free
+/// slots, so allocate and deallocate do not synchronize in the common case. Threads exchange
+/// whole batches of slots through a lock-free Treiber stack, its head is a tagged pointer, so a
+/// batch which was popped and pushed again in between cannot fool a pending compare-exchange (ABA).
+/// Slots may be freed on another thread than they were allocated on. The memory is given back when
+/// the pool is destroyed.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ConcurrentSlotPool {
+public:
+    /// @brief  The number of slots moved between a thread and the shared stack at once.
+    static constexpr size_t BatchSize = 32;
+    /// @brief  The number of free slots a thread keeps.
+    static constexpr size_t MaxCached = 2 * BatchSize;
+
+    /// @brief  The class constructor.
+    /// @param  slotSize    [in] The size of a slot in bytes.
+    /// @param  alignment   [in] The alignment of a slot, at least 16.
+    /// @param  chunkSize   [in] The number of slots allocated when the pool runs dry.
+    ConcurrentSlotPool(size_t slotSize, size_t alignment, size_t chunkSize = 1024);
+
+    /// @brief  The class destructor, all slots must be given back before.
+    ~ConcurrentSlotPool();
+
+    /// @brief  Returns a free slot.
+    /// @return The slot.
+    void *allocate();
+
+    /// @brief  Gives a slot back, may be called on any thread.
+    /// @param  ptr     [in] The slot.
+    void deallocate(void *ptr);
+
+    /// @brief  Makes sure that at least the given number of slots were created.
+    /// @param  numSlots    [in] The number of slots.
+    void reserve(size_t numSlots);
+
+    /// @brief  Returns the number of created slots.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    /// @brief  Returns the size of a slot.
+    /// @return The slot size in bytes.
+    size_t getSlotSize() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ConcurrentSlotPool)
+
+private:
+    Details::SlotCache *getCache();
+    Details::SlotCache *registerCache();
+    void *refill(Details::SlotCache &cache);
+    void grow(size_t numSlots);
+    void pushBatch(void *first, size_t count);
+    void *popBatch(size_t &count);
+    void *popHighBatch(size_t &count);
+
+    friend struct Details::SlotCache;
+
+private:
+    const uint64_t m_id;
+    const size_t m_slotSize;
+    const size_t m_alignment;
+    const size_t m_headerSize;
+    const size_t m_stride;
+    const size_t m_chunkSize;
+    alignas(CacheLineSize) std::atomic<uint64_t> m_top;
+    alignas(CacheLineSize) std::mutex m_mutex;
+    std::vector<void*> m_chunks;
+    std::vector<Details::SlotCache*> m_caches;
+    std::atomic<size_t> m_capacity;
+    std::mutex m_highMutex;
+    std::vector<void*> m_highBatches;
+    std::atomic<size_t> m_numHighBatches;
+};
+
+inline size_t ConcurrentSlotPool::capacity() const {
+    return m_capacity.load(std::memory_order_relaxed);
+}
+
+inline size_t ConcurrentSlotPool::getSlotSize() const {
+    return m_slotSize;
+}
+
+} // Namespace CPPCore
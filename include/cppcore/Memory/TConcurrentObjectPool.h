@@ -0,0 +1,251 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Memory/ConcurrentSlotPool.h>
+
+#include <new>
+#include <utility>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TConcurrentObjectPool
+///	@ingroup	CPPCore
+///
+///	@brief  A thread-safe object pool on top of the ConcurrentSlotPool. Objects can be created on
+/// one thread and destroyed on another one. Use the Handle to give an object back automatically:
+/// @code
+/// TConcurrentObjectPool<Message> pool;
+/// TConcurrentObjectPool<Message>::Handle message = pool.acquire(id, payload);
+/// queue.push(std::move(message));
+/// @endcode
+/// All objects must be destroyed before the pool.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TConcurrentObjectPool {
+public:
+    //---------------------------------------------------------------------------------------------
+    ///	@brief  Owns one object of the pool, the object is destroyed when the handle goes away.
+    //---------------------------------------------------------------------------------------------
+    class Handle {
+    public:
+        /// @brief  The default class constructor, creates an empty handle.
+        Handle() noexcept;
+
+        /// @brief  Takes over the object from the other handle.
+        /// @param  other   [in] The other handle, empty afterwards.
+        Handle(Handle &&other) noexcept;
+
+        /// @brief  The class destructor, gives the object back to the pool.
+        ~Handle();
+
+        /// @brief  Gives the own object back and takes over the object of the other handle.
+        /// @param  other   [in] The other handle, empty afterwards.
+        /// @return The handle.
+        Handle &operator=(Handle &&other) noexcept;
+
+        /// @brief  Gives the object back to the pool.
+        void reset();
+
+        /// @brief  Releases the ownership, the caller has to call destroy.
+        /// @return The object.
+        T *release() noexcept;
+
+        /// @brief  Returns the object.
+        /// @return The object or nullptr.
+        T *get() const noexcept;
+
+        T *operator->() const noexcept;
+        T &operator*() const noexcept;
+        explicit operator bool() const noexcept;
+
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+
+    private:
+        friend class TConcurrentObjectPool<T>;
+        Handle(TConcurrentObjectPool<T> *pool, T *object) noexcept;
+
+        TConcurrentObjectPool<T> *m_pool;
+        T *m_object;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  chunkSize   [in] The number of objects allocated when the pool runs dry.
+    explicit TConcurrentObjectPool(size_t chunkSize = 1024);
+
+    /// @brief  The class destructor.
+    ~TConcurrentObjectPool() = default;
+
+    /// @brief  Constructs a new object.
+    /// @param  args    [in] The constructor arguments.
+    /// @return The object.
+    template <class... Args>
+    T *create(Args &&...args);
+
+    /// @brief  Destroys an object of this pool, may be called on any thread.
+    /// @param  object  [in] The object.
+    void destroy(T *object);
+
+    /// @brief  Constructs a new object owned by a handle.
+    /// @param  args    [in] The constructor arguments.
+    /// @return The handle.
+    template <class... Args>
+    Handle acquire(Args &&...args);
+
+    /// @brief  Makes sure that storage for the given number of objects exists.
+    /// @param  numObjects  [in] The number of objects.
+    void reserve(size_t numObjects);
+
+    /// @brief  Returns the number of objects the pool has storage for.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TConcurrentObjectPool)
+
+private:
+    ConcurrentSlotPool m_slots;
+};
+
+template <class T>
+inline TConcurrentObjectPool<T>::TConcurrentObjectPool(size_t chunkSize) :
+        m_slots(sizeof(T), alignof(T), chunkSize) {
+    // empty
+}
+
+template <class T>
+template <class... Args>
+inline T *TConcurrentObjectPool<T>::create(Args &&...args) {
+    void *memory = m_slots.allocate();
+    try {
+        return new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        m_slots.deallocate(memory);
+        throw;
+    }
+}
+
+template <class T>
+inline void TConcurrentObjectPool<T>::destroy(T *object) {
+    if (nullptr == object) {
+        return;
+    }
+    object->~T();
+    m_slots.deallocate(object);
+}
+
+template <class T>
+template <class... Args>
+inline typename TConcurrentObjectPool<T>::Handle TConcurrentObjectPool<T>::acquire(Args &&...args) {
+    return Handle(this, create(std::forward<Args>(args)...));
+}
+
+template <class T>
+inline void TConcurrentObjectPool<T>::reserve(size_t numObjects) {
+    m_slots.reserve(numObjects);
+}
+
+template <class T>
+inline size_t TConcurrentObjectPool<T>::capacity() const {
+    return m_slots.capacity();
+}
+
+template <class T>
+inline TConcurrentObjectPool<T>::Handle::Handle() noexcept :
+        m_pool(nullptr),
+        m_object(nullptr) {
+    // empty
+}
+
+template <class T>
+inline TConcurrentObjectPool<T>::Handle::Handle(TConcurrentObjectPool<T> *pool, T *object) noexcept :
+        m_pool(pool),
+        m_object(object) {
+    // empty
+}
+
+template <class T>
+inline TConcurrentObjectPool<T>::Handle::Handle(Handle &&other) noexcept :
+        m_pool(other.m_pool),
+        m_object(other.m_object) {
+    other.m_pool = nullptr;
+    other.m_object = nullptr;
+}
+
+template <class T>
+inline TConcurrentObjectPool<T>::Handle::~Handle() {
+    reset();
+}
+
+template <class T>
+inline typename TConcurrentObjectPool<T>::Handle &TConcurrentObjectPool<T>::Handle::operator=(Handle &&other) noexcept {
+    if (this != &other) {
+        reset();
+        m_pool = other.m_pool;
+        m_object = other.m_object;
+        other.m_pool = nullptr;
+        other.m_object = nullptr;
+    }
+    return *this;
+}
+
+template <class T>
+inline void TConcurrentObjectPool<T>::Handle::reset() {
+    if (nullptr != m_object) {
+        m_pool->destroy(m_object);
+        m_object = nullptr;
+    }
+    m_pool = nullptr;
+}
+
+template <class T>
+inline T *TConcurrentObjectPool<T>::Handle::release() noexcept {
+    T *object = m_object;
+    m_object = nullptr;
+    m_pool = nullptr;
+    return object;
+}
+
+template <class T>
+inline T *TConcurrentObjectPool<T>::Handle::get() const noexcept {
+    return m_object;
+}
+
+template <class T>
+inline T *TConcurrentObjectPool<T>::Handle::operator->() const noexcept {
+    return m_object;
+}
+
+template <class T>
+inline T &TConcurrentObjectPool<T>::Handle::operator*() const noexcept {
+    return *m_object;
+}
+
+template <class T>
+inline TConcurrentObjectPool<T>::Handle::operator bool() const noexcept {
+    return nullptr != m_object;
+}
+
+} // Namespace CPPCore
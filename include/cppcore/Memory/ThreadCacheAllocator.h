@@ -0,0 +1,78 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ThreadCacheAllocator
+///	@ingroup	CPPCore
+///
+///	@brief  A small-object allocator for concurrent containers. Blocks are rounded up to size
+/// classes of 16 bytes and every thread keeps a free list per class, so the fast path does not
+/// synchronize at all. A thread which frees more blocks than it caches moves a batch of them to a
+/// global depot, where threads which run dry pick them up again. So blocks which are allocated on
+/// one thread and freed on another are recycled instead of piling up. Larger blocks come from the
+/// heap directly. The coroutine frames of the FrameAllocator come from here as well.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ThreadCacheAllocator {
+public:
+    /// @brief  The granularity of the size classes, also the alignment of the blocks.
+    static constexpr size_t Granularity = 16;
+    /// @brief  The largest cached block size.
+    static constexpr size_t MaxCachedSize = 4096;
+    /// @brief  The number of blocks moved between a thread and the depot at once.
+    static constexpr size_t BatchSize = 32;
+    /// @brief  The number of free blocks a thread keeps per size class.
+    static constexpr size_t MaxCachedPerClass = 2 * BatchSize;
+
+    /// @brief  The allocation statistic of the calling thread.
+    struct Stats {
+        uint64_t m_numAllocations;      ///< All allocations.
+        uint64_t m_numHeapAllocations;  ///< The allocations which had to go to the heap.
+        uint64_t m_numDepotTransfers;   ///< The batches moved from or to the depot.
+    };
+
+    /// @brief  Allocates a block.
+    /// @param  size    [in] The size in bytes.
+    /// @return The block.
+    static void *allocate(size_t size);
+
+    /// @brief  Releases a block into the cache of the calling thread.
+    /// @param  ptr     [in] The block.
+    /// @param  size    [in] The size which was used for the allocation.
+    static void deallocate(void *ptr, size_t size);
+
+    /// @brief  Returns the statistic of the calling thread.
+    /// @return The statistic.
+    static Stats getThreadStats();
+
+    /// @brief  Resets the statistic of the calling thread.
+    static void resetThreadStats();
+};
+
+} // Namespace CPPCore
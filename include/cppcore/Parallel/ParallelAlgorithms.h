@@ -0,0 +1,395 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/TaskScheduler.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace CPPCore {
+
+/// @brief  The default number of elements per chunk. The chunking only depends on the grain size,
+///         not on the number of threads, so reductions give the same result on any machine.
+static constexpr size_t DefaultGrainSize = 16384;
+
+namespace Details {
+
+template <class T>
+struct TNonDeduced {
+    using type = T;
+};
+
+// Wraps the partial results, so a vector of bool does not pack them into shared words.
+template <class T>
+struct TSlot {
+    T m_value;
+};
+
+inline TaskScheduler &getScheduler(TaskScheduler *scheduler) {
+    return nullptr == scheduler ? TaskScheduler::getDefault() : *scheduler;
+}
+
+inline size_t getNumChunks(size_t count, size_t grainSize) {
+    return (count + grainSize - 1) / grainSize;
+}
+
+template <class Func>
+inline void splitChunks(TaskGroup &group, size_t first, size_t last, const Func &func) {
+    // Hand the upper half to the thieves and keep on splitting the lower one
+    while (last - first > 1) {
+        const size_t mid = first + (last - first) / 2;
+        group.run([&group, &func, mid, last]() {
+            splitChunks(group, mid, last, func);
+        });
+        last = mid;
+    }
+    func(first);
+}
+
+template <class Func>
+inline void forEachChunk(size_t numChunks, TaskScheduler *scheduler, const Func &func) {
+    if (0 == numChunks) {
+        return;
+    }
+
+    TaskScheduler &sched = getScheduler(scheduler);
+    if (1 == numChunks || 1 == sched.getNumThreads()) {
+        for (size_t i = 0; i < numChunks; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    TaskGroup group(sched);
+    splitChunks(group, 0, numChunks, func);
+    group.wait();
+}
+
+template <class T, class Compare>
+inline void parallelMerge(T *a, size_t numA, T *b, size_t numB, T *out, Compare comp, size_t grainSize, TaskScheduler *scheduler) {
+    // Split the larger range into grain-sized pieces and find the matching part of the other one.
+    // Equal elements of a always go first, as with std::merge. The pieces copy instead of move,
+    // because the neighbour piece still reads its first element for the split.
+    if (numA >= numB) {
+        forEachChunk(getNumChunks(numA, grainSize), scheduler, [=](size_t piece) {
+            const size_t aBegin = piece * grainSize;
+            const size_t aEnd = std::min(numA, aBegin + grainSize);
+            const size_t bBegin = 0 == piece ? 0 : std::lower_bound(b, b + numB, a[aBegin], comp) - b;
+            const size_t bEnd = numA == aEnd ? numB : std::lower_bound(b, b + numB, a[aEnd], comp) - b;
+            std::merge(a + aBegin, a + aEnd, b + bBegin, b + bEnd, out + aBegin + bBegin, comp);
+        });
+    } else {
+        forEachChunk(getNumChunks(numB, grainSize), scheduler, [=](size_t piece) {
+            const size_t bBegin = piece * grainSize;
+            const size_t bEnd = std::min(numB, bBegin + grainSize);
+            const size_t aBegin = 0 == piece ? 0 : std::upper_bound(a, a + numA, b[bBegin], comp) - a;
+            const size_t aEnd = numB == bEnd ? numA : std::upper_bound(a, a + numA, b[bEnd], comp) - a;
+            std::merge(a + aBegin, a + aEnd, b + bBegin, b + bEnd, out + aBegin + bBegin, comp);
+        });
+    }
+}
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Calls func(chunkBegin, chunkEnd) for grain-sized chunks of [begin, end) in parallel.
+/// @param  begin       [in] The first index.
+/// @param  end         [in] The end index.
+/// @param  func        [in] The function to call per chunk.
+/// @param  grainSize   [in] The number of indices per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+//-------------------------------------------------------------------------------------------------
+template <class Func>
+inline void parallelForRange(size_t begin, size_t end, Func func, size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    if (end <= begin) {
+        return;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    Details::forEachChunk(Details::getNumChunks(end - begin, grainSize), scheduler, [&](size_t chunk) {
+        const size_t chunkBegin = begin + chunk * grainSize;
+        func(chunkBegin, chunkBegin + std::min(grainSize, end - chunkBegin));
+    });
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Calls func(index) for all indices in [begin, end) in parallel.
+/// @param  begin       [in] The first index.
+/// @param  end         [in] The end index.
+/// @param  func        [in] The function to call per index.
+/// @param  grainSize   [in] The number of indices per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+//-------------------------------------------------------------------------------------------------
+template <class Func>
+inline void parallelFor(size_t begin, size_t end, Func func, size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    parallelForRange(begin, end, [&func](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            func(i);
+        }
+    }, grainSize, scheduler);
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Reduces the index range [begin, end). Every chunk is reduced by
+///         rangeFunc(chunkBegin, chunkEnd, identity), the partial results are combined in chunk
+///         order, so the result does not depend on the number of threads.
+/// @param  begin       [in] The first index.
+/// @param  end         [in] The end index.
+/// @param  identity    [in] The identity of the combine operation.
+/// @param  rangeFunc   [in] Reduces one chunk.
+/// @param  combine     [in] Combines two partial results.
+/// @param  grainSize   [in] The number of indices per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+/// @return The reduced value.
+//-------------------------------------------------------------------------------------------------
+template <class T, class RangeFunc, class Combine>
+inline T parallelReduce(size_t begin, size_t end, const T &identity, RangeFunc rangeFunc, Combine combine,
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    if (end <= begin) {
+        return identity;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    const size_t numChunks = Details::getNumChunks(end - begin, grainSize);
+    std::vector<Details::TSlot<T>> partials(numChunks, Details::TSlot<T>{ identity });
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const size_t chunkBegin = begin + chunk * grainSize;
+        partials[chunk].m_value = rangeFunc(chunkBegin, chunkBegin + std::min(grainSize, end - chunkBegin), identity);
+    });
+
+    T result = identity;
+    for (size_t i = 0; i < numChunks; ++i) {
+        result = combine(result, partials[i].m_value);
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Reduces the elements [first, last) with an associative operation. The result is the
+///         same for any number of threads.
+/// @param  first       [in] The first element.
+/// @param  last        [in] The end of the elements.
+/// @param  init        [in] The initial value.
+/// @param  op          [in] The associative operation.
+/// @param  grainSize   [in] The number of elements per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+/// @return The reduced value.
+//-------------------------------------------------------------------------------------------------
+template <class T, class Op = std::plus<T>>
+inline T parallelReduce(const T *first, const T *last, typename Details::TNonDeduced<T>::type init, Op op = Op(),
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    const size_t count = last - first;
+    if (0 == count) {
+        return init;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    const size_t numChunks = Details::getNumChunks(count, grainSize);
+    std::vector<Details::TSlot<T>> partials(numChunks, Details::TSlot<T>{ init });
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const T *it = first + chunk * grainSize;
+        const T *chunkEnd = it + std::min(grainSize, static_cast<size_t>(last - it));
+        T value = *it;
+        for (++it; it != chunkEnd; ++it) {
+            value = op(value, *it);
+        }
+        partials[chunk].m_value = value;
+    });
+
+    T result = init;
+    for (size_t i = 0; i < numChunks; ++i) {
+        result = op(result, partials[i].m_value);
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Computes the inclusive prefix scan of [first, last) into out, in place is allowed. The
+///         chunk totals are scanned first, the chunks are then rescanned with their offsets.
+/// @param  first       [in] The first element.
+/// @param  last        [in] The end of the elements.
+/// @param  out         [out] The output, must hold last - first elements.
+/// @param  op          [in] The associative operation.
+/// @param  grainSize   [in] The number of elements per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+/// @return The end of the output.
+//-------------------------------------------------------------------------------------------------
+template <class T, class Op = std::plus<T>>
+inline T *parallelInclusiveScan(const T *first, const T *last, T *out, Op op = Op(),
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    const size_t count = last - first;
+    if (0 == count) {
+        return out;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    const size_t numChunks = Details::getNumChunks(count, grainSize);
+    std::vector<Details::TSlot<T>> totals(numChunks, Details::TSlot<T>{ *first });
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const T *it = first + chunk * grainSize;
+        const T *chunkEnd = it + std::min(grainSize, static_cast<size_t>(last - it));
+        T value = *it;
+        for (++it; it != chunkEnd; ++it) {
+            value = op(value, *it);
+        }
+        totals[chunk].m_value = value;
+    });
+
+    // totals[i] becomes the total of the chunks 0 to i
+    for (size_t i = 2; i < numChunks; ++i) {
+        totals[i - 1].m_value = op(totals[i - 2].m_value, totals[i - 1].m_value);
+    }
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const size_t chunkBegin = chunk * grainSize;
+        const size_t chunkEnd = chunkBegin + std::min(grainSize, count - chunkBegin);
+        T value = 0 == chunk ? first[chunkBegin] : op(totals[chunk - 1].m_value, first[chunkBegin]);
+        out[chunkBegin] = value;
+        for (size_t i = chunkBegin + 1; i < chunkEnd; ++i) {
+            value = op(value, first[i]);
+            out[i] = value;
+        }
+    });
+
+    return out + count;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Writes func(element) for all elements of [first, last) into out.
+/// @param  first       [in] The first element.
+/// @param  last        [in] The end of the elements.
+/// @param  out         [out] The output, must hold last - first elements.
+/// @param  func        [in] The transformation.
+/// @param  grainSize   [in] The number of elements per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+/// @return The end of the output.
+//-------------------------------------------------------------------------------------------------
+template <class T, class U, class Func>
+inline U *parallelTransform(const T *first, const T *last, U *out, Func func,
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    const size_t count = last - first;
+    parallelForRange(0, count, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            out[i] = func(first[i]);
+        }
+    }, grainSize, scheduler);
+
+    return out + count;
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Copies all elements of [first, last) which match pred into out, keeping their order.
+///         The matches are counted per chunk first, so pred is called twice per element.
+/// @param  first       [in] The first element.
+/// @param  last        [in] The end of the elements.
+/// @param  out         [out] The output, must not overlap the input.
+/// @param  pred        [in] The predicate.
+/// @param  grainSize   [in] The number of elements per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+/// @return The end of the output.
+//-------------------------------------------------------------------------------------------------
+template <class T, class Pred>
+inline T *parallelCopyIf(const T *first, const T *last, T *out, Pred pred,
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    const size_t count = last - first;
+    if (0 == count) {
+        return out;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    const size_t numChunks = Details::getNumChunks(count, grainSize);
+    std::vector<size_t> offsets(numChunks + 1, 0);
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const size_t chunkBegin = chunk * grainSize;
+        const size_t chunkEnd = chunkBegin + std::min(grainSize, count - chunkBegin);
+        size_t matches = 0;
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            if (pred(first[i])) {
+                ++matches;
+            }
+        }
+        offsets[chunk + 1] = matches;
+    });
+
+    for (size_t i = 1; i <= numChunks; ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    Details::forEachChunk(numChunks, scheduler, [&](size_t chunk) {
+        const size_t chunkBegin = chunk * grainSize;
+        const size_t chunkEnd = chunkBegin + std::min(grainSize, count - chunkBegin);
+        T *target = out + offsets[chunk];
+        for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+            if (pred(first[i])) {
+                *target++ = first[i];
+            }
+        }
+    });
+
+    return out + offsets[numChunks];
+}
+
+//-------------------------------------------------------------------------------------------------
+/// @brief  Sorts [first, last). The grain-sized chunks are sorted in parallel and then merged
+///         pairwise, every merge is split into grain-sized pieces as well.
+/// @param  first       [in] The first element.
+/// @param  last        [in] The end of the elements.
+/// @param  comp        [in] The strict weak ordering.
+/// @param  grainSize   [in] The number of elements per chunk.
+/// @param  scheduler   [in] The scheduler, nullptr for the default one.
+//-------------------------------------------------------------------------------------------------
+template <class T, class Compare = std::less<T>>
+inline void parallelSort(T *first, T *last, Compare comp = Compare(),
+        size_t grainSize = DefaultGrainSize, TaskScheduler *scheduler = nullptr) {
+    const size_t count = last - first;
+    grainSize = std::max<size_t>(1, grainSize);
+    if (count <= grainSize || 1 == Details::getScheduler(scheduler).getNumThreads()) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    Details::forEachChunk(Details::getNumChunks(count, grainSize), scheduler, [&](size_t chunk) {
+        T *chunkBegin = first + chunk * grainSize;
+        std::sort(chunkBegin, chunkBegin + std::min(grainSize, count - chunk * grainSize), comp);
+    });
+
+    std::unique_ptr<T[]> buffer(new T[count]);
+    T *src = first;
+    T *dst = buffer.get();
+    for (size_t width = grainSize; width < count; width *= 2) {
+        const size_t numPairs = Details::getNumChunks(count, 2 * width);
+        Details::forEachChunk(numPairs, scheduler, [&](size_t pair) {
+            const size_t begin = pair * 2 * width;
+            const size_t numA = std::min(width, count - begin);
+            const size_t numB = std::min(width, count - begin - numA);
+            Details::parallelMerge(src + begin, numA, src + begin + numA, numB, dst + begin, comp, grainSize, scheduler);
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != first) {
+        parallelForRange(0, count, [&](size_t chunkBegin, size_t chunkEnd) {
+            std::move(src + chunkBegin, src + chunkEnd, first + chunkBegin);
+        }, grainSize, scheduler);
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,783 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Threading/Futex.h>
+#include <cppcore/Threading/SpinLock.h>
+#include <cppcore/Threading/TBoundedQueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CPPCore {
+
+class Pipeline;
+
+template <class T>
+class TPipelineStage;
+
+/// @brief  The settings of a pipeline.
+struct PipelineOptions {
+    size_t m_queueCapacity;     ///< The number of batches a queue between two stages can hold.
+    size_t m_batchSize;         ///< The max. number of items the source puts into one batch.
+    bool m_ordered;             ///< true to hand the items to the sink in source order, the source
+                                ///  runs at most m_queueCapacity batches ahead of the sink then.
+
+    /// @brief  The default class constructor.
+    PipelineOptions() :
+            m_queueCapacity(16),
+            m_batchSize(64),
+            m_ordered(false) {
+        // empty
+    }
+};
+
+/// @brief  The statistics of one pipeline stage.
+struct PipelineStageStats {
+    std::string m_name;         ///< The name of the stage.
+    size_t m_parallelism;       ///< The number of worker threads.
+    uint64_t m_numItems;        ///< The number of items produced by the source or taken by a stage.
+    uint64_t m_numBatches;      ///< The number of batches.
+    uint64_t m_busyNs;          ///< The time spent in the stage function, summed over all workers.
+    double m_itemsPerSecond;    ///< The throughput over the run time of the pipeline.
+    size_t m_queueCapacity;     ///< The capacity of the input queue in batches, 0 for the source.
+    double m_avgQueueSize;      ///< The average input queue size, sampled whenever a batch is taken.
+    size_t m_maxQueueSize;      ///< The largest sampled input queue size.
+};
+
+namespace Details {
+
+// An event count on a futex word. Notifying is a fence and a load as long as nobody waits.
+class PipelineSignal {
+public:
+    PipelineSignal() :
+            m_epoch(0),
+            m_waiters(0) {
+        // empty
+    }
+
+    uint32_t prepareWait() {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    void wait(uint32_t epoch) {
+        Futex::wait(m_epoch, epoch);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void cancelWait() {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (0 != m_waiters.load(std::memory_order_relaxed)) {
+            notifyAll();
+        }
+    }
+
+    void notifyAll() {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        Futex::wakeAll(m_epoch);
+    }
+
+private:
+    std::atomic<uint32_t> m_epoch;
+    std::atomic<uint32_t> m_waiters;
+};
+
+// The window of an ordered pipeline. The source waits before a batch, which is a full window
+// ahead of the next one the sink will emit, so a stalled batch cannot make the sink park an
+// unbounded number of batches behind it.
+class PipelineWindow {
+public:
+    PipelineWindow() :
+            m_emitted(0),
+            m_advanced() {
+        // empty
+    }
+
+    // Blocks until the sequence fits into the window, returns false when the pipeline was cancelled
+    bool acquire(uint64_t sequence, uint64_t size, const std::atomic<bool> &cancelled) {
+        for (;;) {
+            if (sequence < m_emitted.load(std::memory_order_acquire) + size) {
+                return true;
+            }
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            const uint32_t epoch = m_advanced.prepareWait();
+            if (sequence < m_emitted.load(std::memory_order_seq_cst) + size) {
+                m_advanced.cancelWait();
+                return true;
+            }
+            if (cancelled.load(std::memory_order_relaxed)) {
+                m_advanced.cancelWait();
+                return false;
+            }
+            m_advanced.wait(epoch);
+        }
+    }
+
+    // The sink has emitted all batches before the sequence
+    void advance(uint64_t sequence) {
+        m_emitted.store(sequence, std::memory_order_release);
+        m_advanced.notify();
+    }
+
+    // Wakes the source, used for the cancellation
+    void wakeAll() {
+        m_advanced.notifyAll();
+    }
+
+private:
+    std::atomic<uint64_t> m_emitted;
+    PipelineSignal m_advanced;
+};
+
+template <class T>
+struct TPipelineBatch {
+    uint64_t m_sequence;
+    std::vector<T> m_items;
+};
+
+class DLL_CPPCORE_EXPORT PipelineChannelBase {
+public:
+    PipelineChannelBase();
+    virtual ~PipelineChannelBase();
+    virtual size_t size() const = 0;
+    virtual size_t capacity() const = 0;
+
+    // No more batches will be pushed, wakes the consumers
+    void close();
+
+    // Wakes everybody, used for the cancellation
+    void wakeAll();
+
+protected:
+    static constexpr size_t SpinRounds = 64;
+
+    std::atomic<bool> m_closed;
+    PipelineSignal m_notEmpty;
+    PipelineSignal m_notFull;
+};
+
+template <class T>
+class TPipelineChannel : public PipelineChannelBase {
+public:
+    using Batch = TPipelineBatch<T>;
+
+    explicit TPipelineChannel(size_t capacity);
+    ~TPipelineChannel() override;
+    size_t size() const override;
+    size_t capacity() const override;
+
+    // Blocks while the queue is full, returns false when the pipeline was cancelled
+    bool push(Batch *batch, const std::atomic<bool> &cancelled);
+
+    // Blocks while the queue is empty, returns nullptr at the end of the stream or when cancelled
+    Batch *pop(const std::atomic<bool> &cancelled);
+
+private:
+    TBoundedQueue<Batch*> m_queue;
+};
+
+class DLL_CPPCORE_EXPORT PipelineStageBase {
+public:
+    PipelineStageBase(Pipeline &pipeline, const char *name, size_t parallelism,
+            PipelineChannelBase *input, PipelineChannelBase *output);
+    virtual ~PipelineStageBase();
+    virtual void runWorker() = 0;
+
+    // Called by every worker when it is done, the last one closes the output queue
+    void workerDone();
+
+    size_t getParallelism() const;
+    void getStats(PipelineStageStats &stats, double seconds) const;
+    static uint64_t now();
+
+protected:
+    void sampleQueue();
+    void record(size_t numItems, uint64_t busyNs);
+
+protected:
+    const std::atomic<bool> &m_cancelled;
+    PipelineWindow &m_window;
+
+private:
+    std::string m_name;
+    size_t m_parallelism;
+    PipelineChannelBase *m_input;
+    PipelineChannelBase *m_output;
+    std::atomic<size_t> m_numRunning;
+    std::atomic<uint64_t> m_numItems;
+    std::atomic<uint64_t> m_numBatches;
+    std::atomic<uint64_t> m_busyNs;
+    std::atomic<uint64_t> m_queueSum;
+    std::atomic<uint64_t> m_queueSamples;
+    std::atomic<size_t> m_maxQueueSize;
+};
+
+template <class T, class Func>
+class TPipelineSource : public PipelineStageBase {
+public:
+    TPipelineSource(Pipeline &pipeline, const char *name, Func func, TPipelineChannel<T> *output, size_t batchSize,
+            size_t windowSize);
+    void runWorker() override;
+
+private:
+    Func m_func;
+    TPipelineChannel<T> *m_output;
+    size_t m_batchSize;
+    size_t m_windowSize;
+};
+
+template <class T, class U, class Func>
+class TPipelineTransform : public PipelineStageBase {
+public:
+    TPipelineTransform(Pipeline &pipeline, const char *name, size_t parallelism, Func func,
+            TPipelineChannel<T> *input, TPipelineChannel<U> *output);
+    void runWorker() override;
+
+private:
+    Func m_func;
+    TPipelineChannel<T> *m_input;
+    TPipelineChannel<U> *m_output;
+};
+
+template <class T, class Pred>
+class TPipelineFilter : public PipelineStageBase {
+public:
+    TPipelineFilter(Pipeline &pipeline, const char *name, size_t parallelism, Pred pred,
+            TPipelineChannel<T> *input, TPipelineChannel<T> *output, bool keepEmpty);
+    void runWorker() override;
+
+private:
+    Pred m_pred;
+    TPipelineChannel<T> *m_input;
+    TPipelineChannel<T> *m_output;
+    bool m_keepEmpty;
+};
+
+template <class T, class Func>
+class TPipelineSink : public PipelineStageBase {
+public:
+    TPipelineSink(Pipeline &pipeline, const char *name, size_t parallelism, Func func,
+            TPipelineChannel<T> *input, bool ordered);
+    ~TPipelineSink() override;
+    void runWorker() override;
+
+private:
+    void consume(TPipelineBatch<T> *batch);
+
+private:
+    Func m_func;
+    TPipelineChannel<T> *m_input;
+    bool m_ordered;
+    uint64_t m_nextSequence;
+    std::map<uint64_t, TPipelineBatch<T>*> m_pending;
+};
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Pipeline
+///	@ingroup	CPPCore
+///
+///	@brief  A chain of typed stages which run on their own threads. The stages are connected by
+/// bounded lock-free queues, so a slow stage blocks its producers (backpressure) instead of letting
+/// the queues grow. Items travel in batches, the queues are touched once per batch. In ordered
+/// mode the sink gets the items in source order, the stages in between may still run in parallel.
+///
+/// @code
+/// Pipeline pipeline;
+/// pipeline.source<std::string>("read", [&](std::string &line) { return readLine(file, line); })
+///         .then("parse", 2, [](std::string &&line) { return parse(line); })
+///         .sink("write", 1, [&](Record &&record) { write(record); });
+/// pipeline.run();
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Pipeline {
+public:
+    /// @brief  The class constructor.
+    /// @param  options     [in] The settings.
+    explicit Pipeline(const PipelineOptions &options = PipelineOptions());
+
+    /// @brief  The class destructor, cancels a running pipeline and waits for it.
+    ~Pipeline();
+
+    /// @brief  Adds the source, it runs on one thread.
+    /// @param  name    [in] The name of the stage.
+    /// @param  func    [in] Called as bool func(T &item), returns false at the end of the stream.
+    /// @return The output of the source, every chain has to end in a sink.
+    template <class T, class Func>
+    TPipelineStage<T> source(const char *name, Func func);
+
+    /// @brief  Starts all threads.
+    void start();
+
+    /// @brief  Waits until all stages are done. Rethrows the first exception of a stage. A throwing
+    ///         stage cancels the pipeline, the batches in flight are dropped.
+    void wait();
+
+    /// @brief  Starts the pipeline and waits for it.
+    void run();
+
+    /// @brief  Stops all stages after their current batch, items in the queues are dropped.
+    void cancel();
+
+    /// @brief  Returns true, if the pipeline was cancelled or a stage failed.
+    /// @return true, if cancelled.
+    bool isCancelled() const;
+
+    /// @brief  Returns the settings.
+    /// @return The settings.
+    const PipelineOptions &getOptions() const;
+
+    /// @brief  Will collect the statistics of all stages, also while running.
+    /// @param  stats   [out] The statistics in stage order.
+    void getStats(std::vector<PipelineStageStats> &stats) const;
+
+    /// @brief  Will write a human readable report of the statistics.
+    /// @param  report  [out] The report.
+    void report(std::string &report) const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Pipeline)
+
+private:
+    template <class T>
+    friend class TPipelineStage;
+    friend class Details::PipelineStageBase;
+
+    template <class T>
+    Details::TPipelineChannel<T> *createChannel();
+    void addStage(Details::PipelineStageBase *stage);
+    void fail(std::exception_ptr error);
+
+private:
+    PipelineOptions m_options;
+    std::vector<std::unique_ptr<Details::PipelineChannelBase>> m_channels;
+    std::vector<std::unique_ptr<Details::PipelineStageBase>> m_stages;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_cancelled;
+    Details::PipelineWindow m_window;
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+    uint64_t m_startNs;
+    std::atomic<uint64_t> m_endNs;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TPipelineStage
+///	@ingroup	CPPCore
+///
+///	@brief  The typed output of a pipeline stage, the next stage is attached to it. Each output
+/// takes exactly one next stage.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TPipelineStage {
+public:
+    /// @brief  Adds a stage which maps every item.
+    /// @param  name        [in] The name of the stage.
+    /// @param  parallelism [in] The number of worker threads.
+    /// @param  func        [in] Called as U func(T &&item).
+    /// @return The output of the new stage.
+    template <class Func, class U = std::decay_t<std::invoke_result_t<Func&, T&&>>>
+    TPipelineStage<U> then(const char *name, size_t parallelism, Func func);
+
+    /// @brief  Adds a stage which drops items.
+    /// @param  name        [in] The name of the stage.
+    /// @param  parallelism [in] The number of worker threads.
+    /// @param  pred        [in] Called as bool pred(const T &item), returns true to keep the item.
+    /// @return The output of the new stage.
+    template <class Pred>
+    TPipelineStage<T> filter(const char *name, size_t parallelism, Pred pred);
+
+    /// @brief  Adds the final stage. In ordered mode the sink always runs on one thread.
+    /// @param  name        [in] The name of the stage.
+    /// @param  parallelism [in] The number of worker threads.
+    /// @param  func        [in] Called as func(T &&item).
+    template <class Func>
+    void sink(const char *name, size_t parallelism, Func func);
+
+private:
+    friend class Pipeline;
+    template <class U>
+    friend class TPipelineStage;
+
+    TPipelineStage(Pipeline &pipeline, Details::TPipelineChannel<T> *channel);
+
+private:
+    Pipeline *m_pipeline;
+    Details::TPipelineChannel<T> *m_channel;
+};
+
+namespace Details {
+
+template <class T>
+inline TPipelineChannel<T>::TPipelineChannel(size_t capacity) :
+        PipelineChannelBase(),
+        m_queue(capacity) {
+    // empty
+}
+
+template <class T>
+inline TPipelineChannel<T>::~TPipelineChannel() {
+    Batch *batch = nullptr;
+    while (m_queue.tryPop(batch)) {
+        delete batch;
+    }
+}
+
+template <class T>
+inline size_t TPipelineChannel<T>::size() const {
+    return m_queue.size();
+}
+
+template <class T>
+inline size_t TPipelineChannel<T>::capacity() const {
+    return m_queue.capacity();
+}
+
+template <class T>
+inline bool TPipelineChannel<T>::push(Batch *batch, const std::atomic<bool> &cancelled) {
+    for (size_t round = 0;; ++round) {
+        if (m_queue.tryPush(batch)) {
+            m_notEmpty.notify();
+            return true;
+        }
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (round < SpinRounds) {
+            cpuRelax();
+            continue;
+        }
+
+        const uint32_t epoch = m_notFull.prepareWait();
+        if (m_queue.tryPush(batch)) {
+            m_notFull.cancelWait();
+            m_notEmpty.notify();
+            return true;
+        }
+        if (cancelled.load(std::memory_order_relaxed)) {
+            m_notFull.cancelWait();
+            return false;
+        }
+        m_notFull.wait(epoch);
+    }
+}
+
+template <class T>
+inline typename TPipelineChannel<T>::Batch *TPipelineChannel<T>::pop(const std::atomic<bool> &cancelled) {
+    Batch *batch = nullptr;
+    for (size_t round = 0;; ++round) {
+        if (m_queue.tryPop(batch)) {
+            m_notFull.notify();
+            return batch;
+        }
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        if (m_closed.load(std::memory_order_acquire)) {
+            // Batches pushed before the close are visible now
+            if (m_queue.tryPop(batch)) {
+                return batch;
+            }
+            return nullptr;
+        }
+        if (round < SpinRounds) {
+            cpuRelax();
+            continue;
+        }
+
+        const uint32_t epoch = m_notEmpty.prepareWait();
+        if (m_queue.tryPop(batch)) {
+            m_notEmpty.cancelWait();
+            m_notFull.notify();
+            return batch;
+        }
+        if (cancelled.load(std::memory_order_relaxed) || m_closed.load(std::memory_order_acquire)) {
+            m_notEmpty.cancelWait();
+            continue;
+        }
+        m_notEmpty.wait(epoch);
+    }
+}
+
+template <class T, class Func>
+inline TPipelineSource<T, Func>::TPipelineSource(Pipeline &pipeline, const char *name, Func func,
+        TPipelineChannel<T> *output, size_t batchSize, size_t windowSize) :
+        PipelineStageBase(pipeline, name, 1, nullptr, output),
+        m_func(std::move(func)),
+        m_output(output),
+        m_batchSize(0 == batchSize ? 1 : batchSize),
+        m_windowSize(windowSize) {
+    // empty
+}
+
+template <class T, class Func>
+inline void TPipelineSource<T, Func>::runWorker() {
+    uint64_t sequence = 0;
+    bool more = true;
+    while (more && !m_cancelled.load(std::memory_order_relaxed)) {
+        if (0 != m_windowSize && !m_window.acquire(sequence, m_windowSize, m_cancelled)) {
+            break;
+        }
+
+        // Owned until the push, a throwing m_func must not leak it
+        std::unique_ptr<TPipelineBatch<T>> batch(new TPipelineBatch<T>);
+        batch->m_sequence = sequence++;
+        batch->m_items.reserve(m_batchSize);
+
+        const uint64_t start = now();
+        while (batch->m_items.size() < m_batchSize) {
+            T item{};
+            if (!m_func(item)) {
+                more = false;
+                break;
+            }
+            batch->m_items.push_back(std::move(item));
+        }
+        record(batch->m_items.size(), now() - start);
+
+        if (batch->m_items.empty() || !m_output->push(batch.get(), m_cancelled)) {
+            break;
+        }
+        batch.release();
+    }
+}
+
+template <class T, class U, class Func>
+inline TPipelineTransform<T, U, Func>::TPipelineTransform(Pipeline &pipeline, const char *name, size_t parallelism,
+        Func func, TPipelineChannel<T> *input, TPipelineChannel<U> *output) :
+        PipelineStageBase(pipeline, name, parallelism, input, output),
+        m_func(std::move(func)),
+        m_input(input),
+        m_output(output) {
+    // empty
+}
+
+template <class T, class U, class Func>
+inline void TPipelineTransform<T, U, Func>::runWorker() {
+    for (;;) {
+        sampleQueue();
+        std::unique_ptr<TPipelineBatch<T>> input(m_input->pop(m_cancelled));
+        if (nullptr == input) {
+            return;
+        }
+
+        std::unique_ptr<TPipelineBatch<U>> output(new TPipelineBatch<U>);
+        output->m_sequence = input->m_sequence;
+        output->m_items.reserve(input->m_items.size());
+        const uint64_t start = now();
+        for (size_t i = 0; i < input->m_items.size(); ++i) {
+            output->m_items.push_back(m_func(std::move(input->m_items[i])));
+        }
+        record(input->m_items.size(), now() - start);
+
+        if (!m_output->push(output.get(), m_cancelled)) {
+            return;
+        }
+        output.release();
+    }
+}
+
+template <class T, class Pred>
+inline TPipelineFilter<T, Pred>::TPipelineFilter(Pipeline &pipeline, const char *name, size_t parallelism,
+        Pred pred, TPipelineChannel<T> *input, TPipelineChannel<T> *output, bool keepEmpty) :
+        PipelineStageBase(pipeline, name, parallelism, input, output),
+        m_pred(std::move(pred)),
+        m_input(input),
+        m_output(output),
+        m_keepEmpty(keepEmpty) {
+    // empty
+}
+
+template <class T, class Pred>
+inline void TPipelineFilter<T, Pred>::runWorker() {
+    for (;;) {
+        sampleQueue();
+        std::unique_ptr<TPipelineBatch<T>> batch(m_input->pop(m_cancelled));
+        if (nullptr == batch) {
+            return;
+        }
+
+        const size_t numItems = batch->m_items.size();
+        const uint64_t start = now();
+        batch->m_items.erase(std::remove_if(batch->m_items.begin(), batch->m_items.end(), [this](const T &item) {
+            return !m_pred(item);
+        }), batch->m_items.end());
+        record(numItems, now() - start);
+
+        // The ordered sink needs every sequence number, so empty batches are only dropped unordered
+        if (batch->m_items.empty() && !m_keepEmpty) {
+            continue;
+        }
+        if (!m_output->push(batch.get(), m_cancelled)) {
+            return;
+        }
+        batch.release();
+    }
+}
+
+template <class T, class Func>
+inline TPipelineSink<T, Func>::TPipelineSink(Pipeline &pipeline, const char *name, size_t parallelism,
+        Func func, TPipelineChannel<T> *input, bool ordered) :
+        PipelineStageBase(pipeline, name, ordered ? 1 : parallelism, input, nullptr),
+        m_func(std::move(func)),
+        m_input(input),
+        m_ordered(ordered),
+        m_nextSequence(0),
+        m_pending() {
+    // empty
+}
+
+template <class T, class Func>
+inline TPipelineSink<T, Func>::~TPipelineSink() {
+    for (typename std::map<uint64_t, TPipelineBatch<T>*>::iterator it = m_pending.begin(); m_pending.end() != it; ++it) {
+        delete it->second;
+    }
+}
+
+template <class T, class Func>
+inline void TPipelineSink<T, Func>::runWorker() {
+    for (;;) {
+        sampleQueue();
+        TPipelineBatch<T> *batch = m_input->pop(m_cancelled);
+        if (nullptr == batch) {
+            return;
+        }
+        if (!m_ordered) {
+            consume(batch);
+            continue;
+        }
+
+        // Park early batches until the gap before them is filled, the window bounds their number
+        std::unique_ptr<TPipelineBatch<T>> owner(batch);
+        m_pending.insert(std::make_pair(batch->m_sequence, batch));
+        owner.release();
+        const uint64_t first = m_nextSequence;
+        while (!m_pending.empty() && m_nextSequence == m_pending.begin()->first) {
+            TPipelineBatch<T> *next = m_pending.begin()->second;
+            m_pending.erase(m_pending.begin());
+            ++m_nextSequence;
+            consume(next);
+        }
+        if (first != m_nextSequence) {
+            m_window.advance(m_nextSequence);
+        }
+    }
+}
+
+template <class T, class Func>
+inline void TPipelineSink<T, Func>::consume(TPipelineBatch<T> *batch) {
+    std::unique_ptr<TPipelineBatch<T>> owner(batch);
+    const uint64_t start = now();
+    for (size_t i = 0; i < batch->m_items.size(); ++i) {
+        m_func(std::move(batch->m_items[i]));
+    }
+    record(batch->m_items.size(), now() - start);
+}
+
+} // Namespace Details
+
+template <class T, class Func>
+inline TPipelineStage<T> Pipeline::source(const char *name, Func func) {
+    Details::TPipelineChannel<T> *output = createChannel<T>();
+    addStage(new Details::TPipelineSource<T, Func>(*this, name, std::move(func), output, m_options.m_batchSize,
+            m_options.m_ordered ? m_options.m_queueCapacity : 0));
+
+    return TPipelineStage<T>(*this, output);
+}
+
+template <class T>
+inline Details::TPipelineChannel<T> *Pipeline::createChannel() {
+    Details::TPipelineChannel<T> *channel = new Details::TPipelineChannel<T>(m_options.m_queueCapacity);
+    m_channels.push_back(std::unique_ptr<Details::PipelineChannelBase>(channel));
+
+    return channel;
+}
+
+inline void Pipeline::run() {
+    start();
+    wait();
+}
+
+inline bool Pipeline::isCancelled() const {
+    return m_cancelled.load(std::memory_order_relaxed);
+}
+
+inline const PipelineOptions &Pipeline::getOptions() const {
+    return m_options;
+}
+
+template <class T>
+inline TPipelineStage<T>::TPipelineStage(Pipeline &pipeline, Details::TPipelineChannel<T> *channel) :
+        m_pipeline(&pipeline),
+        m_channel(channel) {
+    // empty
+}
+
+template <class T>
+template <class Func, class U>
+inline TPipelineStage<U> TPipelineStage<T>::then(const char *name, size_t parallelism, Func func) {
+    Details::TPipelineChannel<U> *output = m_pipeline->createChannel<U>();
+    m_pipeline->addStage(new Details::TPipelineTransform<T, U, Func>(*m_pipeline, name, parallelism,
+            std::move(func), m_channel, output));
+
+    return TPipelineStage<U>(*m_pipeline, output);
+}
+
+template <class T>
+template <class Pred>
+inline TPipelineStage<T> TPipelineStage<T>::filter(const char *name, size_t parallelism, Pred pred) {
+    Details::TPipelineChannel<T> *output = m_pipeline->createChannel<T>();
+    m_pipeline->addStage(new Details::TPipelineFilter<T, Pred>(*m_pipeline, name, parallelism,
+            std::move(pred), m_channel, output, m_pipeline->getOptions().m_ordered));
+
+    return TPipelineStage<T>(*m_pipeline, output);
+}
+
+template <class T>
+template <class Func>
+inline void TPipelineStage<T>::sink(const char *name, size_t parallelism, Func func) {
+    m_pipeline->addStage(new Details::TPipelineSink<T, Func>(*m_pipeline, name, parallelism,
+            std::move(func), m_channel, m_pipeline->getOptions().m_ordered));
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <cstdint>
+
+namespace CPPCore {
+
+/// @brief  The detected instruction set extensions.
+enum class CpuFeature : uint32_t {
+    Sse2 = 0,
+    Sse3,
+    Ssse3,
+    Sse41,
+    Sse42,
+    Popcnt,
+    Avx,
+    Avx2,
+    Fma,
+    Bmi1,
+    Bmi2,
+    Avx512F,
+    Avx512Dq,
+    Avx512Bw,
+    Avx512Vl,
+    Neon,
+    NumFeatures
+};
+
+/// @brief  The instruction set levels the SIMD code paths are built for, the x86-64 levels
+///         v1 to v4 on x86 and only Generic elsewhere.
+enum class IsaLevel : uint8_t {
+    Generic = 0,    ///< Plain C++, SSE2 on x86-64.
+    Sse42,          ///< SSSE3, SSE4.1, SSE4.2 and POPCNT.
+    Avx2,           ///< AVX, AVX2, FMA, BMI1 and BMI2.
+    Avx512,         ///< AVX-512 F, DQ, BW and VL.
+    NumLevels
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		CpuFeatures
+///	@ingroup	CPPCore
+///
+///	@brief  Detects the features of the CPU once at startup with cpuid, and with xgetbv whether the
+/// operating system saves the AVX and AVX-512 registers. The active level is the highest one which
+/// the CPU supports. The environment variable CPPCORE_ISA (generic, sse42, avx2 or avx512) lowers
+/// it to test the other code paths on the same machine, it never raises it above the hardware.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT CpuFeatures {
+public:
+    /// @brief  Checks for a feature.
+    /// @param  feature [in] The feature.
+    /// @return true, if the CPU and the operating system support it.
+    static bool has(CpuFeature feature);
+
+    /// @brief  Returns all detected features.
+    /// @return One bit per CpuFeature.
+    static uint32_t getFeatureMask();
+
+    /// @brief  Returns the highest level the hardware supports.
+    /// @return The level.
+    static IsaLevel getDetectedLevel();
+
+    /// @brief  Returns the level the dispatched code paths use, the detected one or the lower
+    ///         one from CPPCORE_ISA.
+    /// @return The level.
+    static IsaLevel getLevel();
+
+    /// @brief  Returns the name of a level, like used by CPPCORE_ISA.
+    /// @param  level   [in] The level.
+    /// @return The name.
+    static const char *getLevelName(IsaLevel level);
+
+    /// @brief  Parses the name of a level.
+    /// @param  name    [in] The name, case-insensitive.
+    /// @param  level   [out] The level.
+    /// @return false for an unknown name.
+    static bool parseLevel(const char *name, IsaLevel &level);
+
+    /// @brief  Returns the brand string of the CPU.
+    /// @return The brand string, empty if unknown.
+    static const char *getBrand();
+
+    CpuFeatures() = delete;
+    ~CpuFeatures() = delete;
+};
+
+} // Namespace CPPCore
@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Platform/CpuFeatures.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TCpuDispatch
+///	@ingroup	CPPCore
+///
+///	@brief  Selects one of several tables of function pointers, one table per instruction set
+/// level. The table is resolved once in the constructor, a call through it costs one indirect
+/// call. Levels without a table fall back to the next lower one, so only the generic table is
+/// required. Keep the dispatcher in a function-local static:
+/// @code
+/// static const TCpuDispatch<Kernels> dispatch(&genericKernels, &sse42Kernels, &avx2Kernels);
+/// dispatch.get().sum(values, count);
+/// @endcode
+//-------------------------------------------------------------------------------------------------
+template <class TTable>
+class TCpuDispatch {
+public:
+    /// @brief  The class constructor, resolves the table for CpuFeatures::getLevel().
+    /// @param  generic [in] The table for plain C++, must not be nullptr.
+    /// @param  sse42   [in] The table for SSE 4.2, or nullptr.
+    /// @param  avx2    [in] The table for AVX2, or nullptr.
+    /// @param  avx512  [in] The table for AVX-512, or nullptr.
+    TCpuDispatch(const TTable *generic, const TTable *sse42 = nullptr, const TTable *avx2 = nullptr,
+            const TTable *avx512 = nullptr);
+
+    /// @brief  Returns the active table.
+    /// @return The table.
+    const TTable &get() const;
+
+    /// @brief  Returns the best table up to a level.
+    /// @param  level   [in] The highest level to use.
+    /// @return The table.
+    const TTable &resolve(IsaLevel level) const;
+
+    /// @brief  Returns the level of the active table.
+    /// @return The level.
+    IsaLevel getLevel() const;
+
+private:
+    const TTable *m_tables[static_cast<size_t>(IsaLevel::NumLevels)];
+    const TTable *m_active;
+    IsaLevel m_level;
+};
+
+template <class TTable>
+inline TCpuDispatch<TTable>::TCpuDispatch(const TTable *generic, const TTable *sse42, const TTable *avx2,
+        const TTable *avx512) :
+        m_tables{ generic, sse42, avx2, avx512 },
+        m_active(nullptr),
+        m_level(IsaLevel::Generic) {
+    size_t index = static_cast<size_t>(CpuFeatures::getLevel());
+    while (index > 0 && nullptr == m_tables[index]) {
+        --index;
+    }
+    m_active = m_tables[index];
+    m_level = static_cast<IsaLevel>(index);
+}
+
+template <class TTable>
+inline const TTable &TCpuDispatch<TTable>::get() const {
+    return *m_active;
+}
+
+template <class TTable>
+inline const TTable &TCpuDispatch<TTable>::resolve(IsaLevel level) const {
+    size_t index = static_cast<size_t>(level);
+    if (index > static_cast<size_t>(CpuFeatures::getDetectedLevel())) {
+        index = static_cast<size_t>(CpuFeatures::getDetectedLevel());
+    }
+    while (index > 0 && nullptr == m_tables[index]) {
+        --index;
+    }
+    return *m_tables[index];
+}
+
+template <class TTable>
+inline IsaLevel TCpuDispatch<TTable>::getLevel() const {
+    return m_level;
+}
+
+} // Namespace CPPCore
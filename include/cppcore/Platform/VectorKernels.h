@@ -0,0 +1,90 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Platform/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		VectorKernels
+///	@ingroup	CPPCore
+///
+///	@brief  Simple loops over arrays, compiled once per instruction set level and dispatched at
+/// runtime by TCpuDispatch. The floating-point results do not depend on the level, every variant
+/// adds in the same order.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT VectorKernels {
+public:
+    /// @brief  The function pointers of one level.
+    struct Table {
+        float (*m_sum)(const float *values, size_t count);
+        float (*m_dot)(const float *a, const float *b, size_t count);
+        size_t (*m_countByte)(const uint8_t *data, size_t size, uint8_t value);
+        void (*m_minMax)(const float *values, size_t count, float *min, float *max);
+    };
+
+    /// @brief  Adds up floats.
+    /// @param  values  [in] The values.
+    /// @param  count   [in] The number of values.
+    /// @return The sum.
+    static float sum(const float *values, size_t count);
+
+    /// @brief  Computes the dot product.
+    /// @param  a       [in] The first vector.
+    /// @param  b       [in] The second vector.
+    /// @param  count   [in] The number of elements.
+    /// @return The dot product.
+    static float dot(const float *a, const float *b, size_t count);
+
+    /// @brief  Counts the occurrences of a byte.
+    /// @param  data    [in] The bytes.
+    /// @param  size    [in] The number of bytes.
+    /// @param  value   [in] The byte to count.
+    /// @return The number of occurrences.
+    static size_t countByte(const uint8_t *data, size_t size, uint8_t value);
+
+    /// @brief  Finds the smallest and the largest float, NaNs are skipped.
+    /// @param  values  [in] The values.
+    /// @param  count   [in] The number of values.
+    /// @param  min     [out] The smallest value, +inf for no values.
+    /// @param  max     [out] The largest value, -inf for no values.
+    static void minMax(const float *values, size_t count, float &min, float &max);
+
+    /// @brief  Returns the level of the active table.
+    /// @return The level.
+    static IsaLevel getLevel();
+
+    /// @brief  Returns the table of a level, the best one up to the level for missing variants.
+    /// @param  level   [in] The level.
+    /// @return The table.
+    static const Table &getTable(IsaLevel level);
+
+    VectorKernels() = delete;
+    ~VectorKernels() = delete;
+};
+
+} // Namespace CPPCore
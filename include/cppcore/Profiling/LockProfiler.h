@@ -0,0 +1,463 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#else
+#   include <chrono>
+#endif
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		LockSite
+///	@ingroup	CPPCore
+///
+///	@brief  Describes one place in the code which acquires a lock. Sites are created once per call
+/// site by CPPCORE_LOCK_SITE and live until the end of the program.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT LockSite {
+public:
+    /// @brief  The class constructor, will register the site.
+    /// @param  name    [in] The name of the lock.
+    /// @param  file    [in] The source file.
+    /// @param  line    [in] The source line.
+    LockSite(const char *name, const char *file, int line);
+
+    /// @brief  The class destructor.
+    ~LockSite() = default;
+
+    /// @brief  Returns the name of the lock.
+    const char *getName() const { return m_name; }
+
+    /// @brief  Returns the source file.
+    const char *getFile() const { return m_file; }
+
+    /// @brief  Returns the source line.
+    int getLine() const { return m_line; }
+
+    /// @brief  Returns the unique id of the site.
+    size_t getId() const { return m_id; }
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(LockSite)
+
+private:
+    const char *m_name;
+    const char *m_file;
+    int m_line;
+    size_t m_id;
+};
+
+/// @brief  The aggregated statistics of one lock site.
+struct LockSiteStats {
+    /// The number of histogram buckets, bucket i counts durations in [2^i, 2^(i+1)) ns.
+    static constexpr size_t NumBuckets = 32;
+
+    const LockSite *m_site;             ///< The lock site.
+    uint64_t m_acquisitions;            ///< Number of acquisitions.
+    uint64_t m_contended;               ///< Number of acquisitions which had to wait.
+    uint64_t m_totalWaitNs;             ///< Accumulated waiting time.
+    uint64_t m_maxWaitNs;               ///< Longest wait.
+    uint64_t m_totalHoldNs;             ///< Accumulated hold time.
+    uint64_t m_maxHoldNs;               ///< Longest hold.
+    uint64_t m_waitHistogram[NumBuckets]; ///< Wait time histogram of the contended acquisitions.
+    uint64_t m_holdHistogram[NumBuckets]; ///< Hold time histogram.
+
+    /// @brief  The default class constructor.
+    LockSiteStats();
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		LockProfiler
+///	@ingroup	CPPCore
+///
+///	@brief  Collects the lock statistics of all threads. Each thread records into its own buffer,
+/// so the instrumented locks do not share any counters. The buffers will be summed up when a
+/// report is requested, buffers of finished threads are merged into a global one.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT LockProfiler {
+public:
+    /// @brief  The max. number of lock sites.
+    static constexpr size_t MaxSites = 1024;
+
+    /// @brief  Returns the site used for acquisitions without a site.
+    /// @return The unknown site.
+    static const LockSite &unknownSite();
+
+    /// @brief  Returns a cheap timestamp in ticks, this is the time stamp counter on x86.
+    /// @return The timestamp.
+    static uint64_t now();
+
+    /// @brief  Converts a tick interval into nanoseconds.
+    /// @param  ticks   [in] The number of ticks.
+    /// @return The interval in nanoseconds.
+    static uint64_t toNanoseconds(uint64_t ticks);
+
+    /// @brief  Will record an acquisition for the calling thread.
+    /// @param  site        [in] The lock site.
+    /// @param  contended   [in] true, if the lock was not available at once.
+    /// @param  waitTicks   [in] The waiting time in ticks.
+    static void recordAcquire(const LockSite &site, bool contended, uint64_t waitTicks);
+
+    /// @brief  Will record a release for the calling thread.
+    /// @param  site        [in] The lock site.
+    /// @param  holdTicks   [in] The hold time in ticks.
+    static void recordRelease(const LockSite &site, uint64_t holdTicks);
+
+    /// @brief  Remembers a shared hold of the calling thread, shared locks have no single owner.
+    static void pushSharedHold(const void *lock, const LockSite &site, uint64_t acquiredAt);
+
+    /// @brief  Finds and removes a shared hold of the calling thread.
+    /// @return true, if the hold was found.
+    static bool popSharedHold(const void *lock, const LockSite *&site, uint64_t &acquiredAt);
+
+    /// @brief  Will collect the statistics of all sites with at least one acquisition.
+    /// @param  stats   [out] The statistics, sorted by total waiting time, descending.
+    static void collect(std::vector<LockSiteStats> &stats);
+
+    /// @brief  Will write a human readable report, sorted by total waiting time.
+    /// @param  report  [out] The report.
+    static void report(std::string &report);
+
+    /// @brief  Will reset all statistics. Counts of threads currently locking may get lost.
+    static void reset();
+
+    /// @brief  Returns the histogram bucket for a duration.
+    /// @param  ns      [in] The duration in nanoseconds.
+    /// @return The bucket index.
+    static size_t bucketIndex(uint64_t ns);
+
+    LockProfiler() = delete;
+    ~LockProfiler() = delete;
+};
+
+inline uint64_t LockProfiler::now() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TProfiledLock
+///	@ingroup	CPPCore
+///
+///	@brief  This class wraps a lock and records acquisitions, contention, wait- and hold-times.
+/// The uncontended path costs one try_lock and two timestamps. The wrapped lock type must provide
+/// lock, try_lock and unlock, shared locking is available when it provides the shared versions.
+//-------------------------------------------------------------------------------------------------
+template <class TLock>
+class TProfiledLock {
+public:
+    /// @brief  The default class constructor.
+    TProfiledLock();
+
+    /// @brief  The class destructor.
+    ~TProfiledLock() = default;
+
+    /// @brief  Will acquire the lock for an unknown site.
+    void lock();
+
+    /// @brief  Will acquire the lock.
+    /// @param  site    [in] The lock site.
+    void lock(const LockSite &site);
+
+    /// @brief  Tries to acquire the lock.
+    /// @return true, if the lock was acquired.
+    bool try_lock();
+
+    /// @brief  Tries to acquire the lock.
+    /// @param  site    [in] The lock site.
+    /// @return true, if the lock was acquired.
+    bool try_lock(const LockSite &site);
+
+    /// @brief  Will release the lock.
+    void unlock();
+
+    /// @brief  Will acquire the lock shared for an unknown site.
+    template <class L = TLock>
+    auto lock_shared() -> decltype(std::declval<L &>().lock_shared());
+
+    /// @brief  Will acquire the lock shared.
+    /// @param  site    [in] The lock site.
+    template <class L = TLock>
+    auto lock_shared(const LockSite &site) -> decltype(std::declval<L &>().lock_shared());
+
+    /// @brief  Will release a shared lock.
+    template <class L = TLock>
+    auto unlock_shared() -> decltype(std::declval<L &>().unlock_shared());
+
+    /// @brief  Returns the wrapped lock.
+    /// @return The native lock.
+    TLock &native();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TProfiledLock)
+
+private:
+    TLock m_lock;
+    const LockSite *m_owner;
+    uint64_t m_acquiredAt;
+};
+
+template <class TLock>
+inline TProfiledLock<TLock>::TProfiledLock() :
+        m_lock(),
+        m_owner(nullptr),
+        m_acquiredAt(0) {
+    // empty
+}
+
+template <class TLock>
+inline void TProfiledLock<TLock>::lock() {
+    lock(LockProfiler::unknownSite());
+}
+
+template <class TLock>
+inline void TProfiledLock<TLock>::lock(const LockSite &site) {
+    if (m_lock.try_lock()) {
+        m_owner = &site;
+        m_acquiredAt = LockProfiler::now();
+        LockProfiler::recordAcquire(site, false, 0);
+        return;
+    }
+
+    const uint64_t start = LockProfiler::now();
+    m_lock.lock();
+    m_owner = &site;
+    m_acquiredAt = LockProfiler::now();
+    LockProfiler::recordAcquire(site, true, m_acquiredAt - start);
+}
+
+template <class TLock>
+inline bool TProfiledLock<TLock>::try_lock() {
+    return try_lock(LockProfiler::unknownSite());
+}
+
+template <class TLock>
+inline bool TProfiledLock<TLock>::try_lock(const LockSite &site) {
+    if (!m_lock.try_lock()) {
+        return false;
+    }
+    m_owner = &site;
+    m_acquiredAt = LockProfiler::now();
+    LockProfiler::recordAcquire(site, false, 0);
+
+    return true;
+}
+
+template <class TLock>
+inline void TProfiledLock<TLock>::unlock() {
+    const LockSite *site = m_owner;
+    const uint64_t held = LockProfiler::now() - m_acquiredAt;
+    m_owner = nullptr;
+    m_lock.unlock();
+    LockProfiler::recordRelease(*site, held);
+}
+
+template <class TLock>
+template <class L>
+inline auto TProfiledLock<TLock>::lock_shared() -> decltype(std::declval<L &>().lock_shared()) {
+    lock_shared(LockProfiler::unknownSite());
+}
+
+template <class TLock>
+template <class L>
+inline auto TProfiledLock<TLock>::lock_shared(const LockSite &site) -> decltype(std::declval<L &>().lock_shared()) {
+    bool contended = false;
+    uint64_t waitTicks = 0;
+    if (!m_lock.try_lock_shared()) {
+        const uint64_t start = LockProfiler::now();
+        m_lock.lock_shared();
+        waitTicks = LockProfiler::now() - start;
+        contended = true;
+    }
+    LockProfiler::pushSharedHold(this, site, LockProfiler::now());
+    LockProfiler::recordAcquire(site, contended, waitTicks);
+}
+
+template <class TLock>
+template <class L>
+inline auto TProfiledLock<TLock>::unlock_shared() -> decltype(std::declval<L &>().unlock_shared()) {
+    const LockSite *site = nullptr;
+    uint64_t acquiredAt = 0;
+    const bool found = LockProfiler::popSharedHold(this, site, acquiredAt);
+    const uint64_t now = LockProfiler::now();
+    m_lock.unlock_shared();
+    if (found) {
+        LockProfiler::recordRelease(*site, now - acquiredAt);
+    }
+}
+
+template <class TLock>
+inline TLock &TProfiledLock<TLock>::native() {
+    return m_lock;
+}
+
+namespace Details {
+
+template <class TLock>
+inline void lockAt(TLock &lock, const LockSite &) {
+    lock.lock();
+}
+
+template <class TLock>
+inline void lockAt(TProfiledLock<TLock> &lock, const LockSite &site) {
+    lock.lock(site);
+}
+
+template <class TLock>
+inline void lockSharedAt(TLock &lock, const LockSite &) {
+    lock.lock_shared();
+}
+
+template <class TLock>
+inline void lockSharedAt(TProfiledLock<TLock> &lock, const LockSite &site) {
+    lock.lock_shared(site);
+}
+
+template <class TLock>
+inline TLock &bareLock(TLock &lock) {
+    return lock;
+}
+
+template <class TLock>
+inline TLock &bareLock(TProfiledLock<TLock> &lock) {
+    return lock.native();
+}
+
+} // namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TLockGuard
+///	@ingroup	CPPCore
+///
+///	@brief  Scoped exclusive lock. Profiled locks get the site, bare locks ignore it.
+//-------------------------------------------------------------------------------------------------
+template <class TLock>
+class TLockGuard {
+public:
+    TLockGuard(TLock &lock, const LockSite &site) :
+            m_lock(lock) {
+        Details::lockAt(m_lock, site);
+    }
+
+    ~TLockGuard() {
+        m_lock.unlock();
+    }
+
+    CPPCORE_NONE_COPYING(TLockGuard)
+
+private:
+    TLock &m_lock;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TSharedLockGuard
+///	@ingroup	CPPCore
+///
+///	@brief  Scoped shared lock. Profiled locks get the site, bare locks ignore it.
+//-------------------------------------------------------------------------------------------------
+template <class TLock>
+class TSharedLockGuard {
+public:
+    TSharedLockGuard(TLock &lock, const LockSite &site) :
+            m_lock(lock) {
+        Details::lockSharedAt(m_lock, site);
+    }
+
+    ~TSharedLockGuard() {
+        m_lock.unlock_shared();
+    }
+
+    CPPCORE_NONE_COPYING(TSharedLockGuard)
+
+private:
+    TLock &m_lock;
+};
+
+#define CPPCORE_LOCK_CONCAT_IMPL(a, b) a##b
+#define CPPCORE_LOCK_CONCAT(a, b) CPPCORE_LOCK_CONCAT_IMPL(a, b)
+
+/// @def    CPPCORE_LOCK_SITE
+/// @brief  Returns the static lock site for this place in the code.
+#define CPPCORE_LOCK_SITE(name) \
+    ([]() -> const ::CPPCore::LockSite & { static const ::CPPCore::LockSite site(name, __FILE__, __LINE__); return site; }())
+
+#ifdef CPPCORE_LOCK_PROFILING
+
+/// The lock types used by the library, instrumented.
+using ProfiledMutex = TProfiledLock<std::mutex>;
+using ProfiledSpinLock = TProfiledLock<SpinLock>;
+using ProfiledSharedMutex = TProfiledLock<std::shared_mutex>;
+
+/// @def    CPPCORE_LOCK_GUARD
+/// @brief  Locks the given lock until the end of the scope and records this place as its site.
+#   define CPPCORE_LOCK_GUARD(lock)                                                                      \
+        ::CPPCore::TLockGuard<typename std::remove_reference<decltype(lock)>::type> CPPCORE_LOCK_CONCAT(lockGuard_, __LINE__)( \
+                lock, CPPCORE_LOCK_SITE(#lock))
+
+/// @def    CPPCORE_SHARED_LOCK_GUARD
+/// @brief  Locks the given lock shared until the end of the scope and records this place as its site.
+#   define CPPCORE_SHARED_LOCK_GUARD(lock)                                                               \
+        ::CPPCore::TSharedLockGuard<typename std::remove_reference<decltype(lock)>::type> CPPCORE_LOCK_CONCAT(sharedLockGuard_, __LINE__)( \
+                lock, CPPCORE_LOCK_SITE(#lock))
+
+#else
+
+/// The lock types used by the library, bare when lock profiling is disabled.
+using ProfiledMutex = std::mutex;
+using ProfiledSpinLock = SpinLock;
+using ProfiledSharedMutex = std::shared_mutex;
+
+// Without profiling the guards are the standard ones on the bare lock, a TProfiledLock is bypassed
+// as well. Use TLockGuard with an explicit site to record a profiled lock in any build.
+#   define CPPCORE_LOCK_GUARD(lock)                                                                      \
+        std::lock_guard<typename std::remove_reference<decltype(::CPPCore::Details::bareLock(lock))>::type> \
+                CPPCORE_LOCK_CONCAT(lockGuard_, __LINE__)(::CPPCore::Details::bareLock(lock))
+
+#   define CPPCORE_SHARED_LOCK_GUARD(lock)                                                               \
+        std::shared_lock<typename std::remove_reference<decltype(::CPPCore::Details::bareLock(lock))>::type> \
+                CPPCORE_LOCK_CONCAT(sharedLockGuard_, __LINE__)(::CPPCore::Details::bareLock(lock))
+
+#endif // CPPCORE_LOCK_PROFILING
+
+} // Namespace CPPCore
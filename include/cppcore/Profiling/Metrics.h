@@ -0,0 +1,319 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(CPPCORE_GNU_LINUX) && defined(__GLIBC__) && defined(__has_include)
+#   if __has_include(<sys/rseq.h>)
+#       include <sys/rseq.h>
+#       define CPPCORE_HAS_RSEQ 1
+#   endif
+#endif
+
+namespace CPPCore {
+
+namespace Details {
+
+/// @brief  One shard of a metric, every shard owns a full cache line.
+struct alignas(CacheLineSize) MetricCell {
+    std::atomic<int64_t> m_value;
+};
+
+/// @brief  Returns the number of shards used by default, the number of hardware threads rounded up
+///         to a power of two.
+/// @return The number of shards.
+DLL_CPPCORE_EXPORT size_t getDefaultShardCount();
+
+/// @brief  Hands out a new shard index for a thread which has no CPU hint.
+/// @return The shard index.
+DLL_CPPCORE_EXPORT size_t allocateThreadShard();
+
+/// @brief  Returns the shard hint of the calling thread. This is the CPU the thread is running on,
+///         read from the rseq area the C library registers with the kernel. Without rseq every
+///         thread gets its own index at its first call.
+/// @return The shard hint, callers mask it with their shard count.
+inline size_t getShardHint() {
+#ifdef CPPCORE_HAS_RSEQ
+    if (0 != __rseq_size) {
+        const struct rseq *area = reinterpret_cast<const struct rseq *>(
+                static_cast<const char *>(__builtin_thread_pointer()) + __rseq_offset);
+        const int32_t cpu = static_cast<int32_t>(*static_cast<const volatile uint32_t *>(&area->cpu_id));
+        if (0 <= cpu) {
+            return static_cast<size_t>(cpu);
+        }
+    }
+#endif
+    static thread_local const size_t t_shard = allocateThreadShard();
+    return t_shard;
+}
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ShardedCounter
+///	@ingroup	CPPCore
+///
+///	@brief  A counter for hot paths. The value is split into cache-line sized shards and every
+/// thread adds to the shard of the CPU it is running on with a relaxed atomic, so incrementing
+/// threads do not share cache lines. Reading sums up all shards, the result is exact once all
+/// writers are done and a snapshot while they are running.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ShardedCounter {
+public:
+    /// @brief  The class constructor.
+    /// @param  numShards   [in] The number of shards, will be rounded up to a power of two.
+    ///                     0 for the default shard count.
+    explicit ShardedCounter(size_t numShards = 0);
+
+    /// @brief  The class destructor.
+    ~ShardedCounter();
+
+    /// @brief  Adds a value.
+    /// @param  value   [in] The value to add.
+    void add(int64_t value);
+
+    /// @brief  Adds one.
+    void increment();
+
+    /// @brief  Returns the sum of all shards.
+    /// @return The value.
+    int64_t get() const;
+
+    /// @brief  Sets the counter back to zero. Concurrent adds may or may not be kept.
+    void reset();
+
+    /// @brief  Returns the number of shards.
+    /// @return The number of shards.
+    size_t getNumShards() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ShardedCounter)
+
+protected:
+    Details::MetricCell &getCell() const;
+
+protected:
+    Details::MetricCell *m_cells;
+    size_t m_mask;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ShardedGauge
+///	@ingroup	CPPCore
+///
+///	@brief  A sharded value which goes up and down, like the number of open connections.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ShardedGauge : public ShardedCounter {
+public:
+    /// @brief  The class constructor.
+    /// @param  numShards   [in] The number of shards, 0 for the default shard count.
+    explicit ShardedGauge(size_t numShards = 0);
+
+    /// @brief  Subtracts one.
+    void decrement();
+
+    /// @brief  Subtracts a value.
+    /// @param  value   [in] The value to subtract.
+    void sub(int64_t value);
+
+    /// @brief  Sets the gauge to a value. This touches all shards, adds running at the same time
+    ///         may or may not be part of the result.
+    /// @param  value   [in] The new value.
+    void set(int64_t value);
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ShardedMaxTracker
+///	@ingroup	CPPCore
+///
+///	@brief  Tracks the largest value seen, e.g. the longest latency of a reporting interval. A
+/// shard is only written when the value is a new maximum for it, so updates quickly become
+/// read-only.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT ShardedMaxTracker {
+public:
+    /// @brief  The value returned while no value was tracked.
+    static constexpr int64_t Empty = std::numeric_limits<int64_t>::min();
+
+    /// @brief  The class constructor.
+    /// @param  numShards   [in] The number of shards, 0 for the default shard count.
+    explicit ShardedMaxTracker(size_t numShards = 0);
+
+    /// @brief  The class destructor.
+    ~ShardedMaxTracker();
+
+    /// @brief  Tracks a value.
+    /// @param  value   [in] The value.
+    void update(int64_t value);
+
+    /// @brief  Returns the maximum of all shards.
+    /// @return The maximum or Empty.
+    int64_t get() const;
+
+    /// @brief  Returns the maximum and starts a new interval.
+    /// @return The maximum of the finished interval or Empty.
+    int64_t getAndReset();
+
+    /// @brief  Returns the number of shards.
+    /// @return The number of shards.
+    size_t getNumShards() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ShardedMaxTracker)
+
+private:
+    Details::MetricCell *m_cells;
+    size_t m_mask;
+};
+
+/// @brief  The metric types of the registry.
+enum class MetricType {
+    Counter,
+    Gauge,
+    MaxTracker
+};
+
+/// @brief  The value of one metric at the time of collection.
+struct MetricSample {
+    std::string m_name;     ///< The name of the metric.
+    MetricType m_type;      ///< The type of the metric.
+    int64_t m_value;        ///< The value, ShardedMaxTracker::Empty for an unused max-tracker.
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		MetricsRegistry
+///	@ingroup	CPPCore
+///
+///	@brief  Owns named metrics and exports them. Looking a metric up takes a lock, so callers
+/// should keep the returned pointer and use it on the hot path. Metrics live as long as the
+/// registry.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT MetricsRegistry {
+public:
+    /// @brief  The class constructor.
+    MetricsRegistry();
+
+    /// @brief  The class destructor.
+    ~MetricsRegistry();
+
+    /// @brief  Returns the counter with the given name, it will be created on first use.
+    /// @param  name    [in] The name.
+    /// @return The counter or nullptr, if the name is used by a metric of another type.
+    ShardedCounter *getCounter(const std::string &name);
+
+    /// @brief  Returns the gauge with the given name, it will be created on first use.
+    /// @param  name    [in] The name.
+    /// @return The gauge or nullptr, if the name is used by a metric of another type.
+    ShardedGauge *getGauge(const std::string &name);
+
+    /// @brief  Returns the max-tracker with the given name, it will be created on first use.
+    /// @param  name    [in] The name.
+    /// @return The max-tracker or nullptr, if the name is used by a metric of another type.
+    ShardedMaxTracker *getMaxTracker(const std::string &name);
+
+    /// @brief  Returns the number of metrics.
+    /// @return The number of metrics.
+    size_t size() const;
+
+    /// @brief  Will read all metrics.
+    /// @param  samples     [out] The samples, sorted by name.
+    /// @param  resetMax    [in] true to start a new interval for the max-trackers.
+    void collect(std::vector<MetricSample> &samples, bool resetMax = false) const;
+
+    /// @brief  Will write all metrics in the Prometheus text format. Unused max-trackers are
+    ///         left out.
+    /// @param  report      [out] The report.
+    /// @param  resetMax    [in] true to start a new interval for the max-trackers.
+    void report(std::string &report, bool resetMax = false) const;
+
+    /// @brief  Returns the process-wide registry.
+    /// @return The default registry.
+    static MetricsRegistry &getDefault();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(MetricsRegistry)
+
+private:
+    struct Entry {
+        MetricType m_type;
+        std::unique_ptr<ShardedCounter> m_counter;
+        std::unique_ptr<ShardedGauge> m_gauge;
+        std::unique_ptr<ShardedMaxTracker> m_maxTracker;
+    };
+
+    Entry *findOrCreate(const std::string &name, MetricType type);
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, Entry> m_entries;
+};
+
+inline Details::MetricCell &ShardedCounter::getCell() const {
+    return m_cells[Details::getShardHint() & m_mask];
+}
+
+inline void ShardedCounter::add(int64_t value) {
+    getCell().m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline void ShardedCounter::increment() {
+    add(1);
+}
+
+inline size_t ShardedCounter::getNumShards() const {
+    return m_mask + 1;
+}
+
+inline void ShardedGauge::decrement() {
+    add(-1);
+}
+
+inline void ShardedGauge::sub(int64_t value) {
+    add(-value);
+}
+
+inline void ShardedMaxTracker::update(int64_t value) {
+    std::atomic<int64_t> &cell = m_cells[Details::getShardHint() & m_mask].m_value;
+    int64_t current = cell.load(std::memory_order_relaxed);
+    while (value > current) {
+        if (cell.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+inline size_t ShardedMaxTracker::getNumShards() const {
+    return m_mask + 1;
+}
+
+} // Namespace CPPCore
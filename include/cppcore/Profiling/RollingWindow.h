@@ -0,0 +1,161 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Container/TRingBuffer.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		RollingWindow
+///	@ingroup	CPPCore
+///
+///	@brief  Keeps the last samples of a time series, e.g. the frame times of the last seconds, and
+/// updates its aggregates incrementally, so a tick does not rescan the window. Min and max come
+/// from monotonic queues, the sum and the sum of squares are compensated running sums in double
+/// precision. They sum up the samples minus a reference sample of the window, which is renewed
+/// once per turnover, so the variance stays exact for a large mean with a small spread, e.g.
+/// latencies in nanoseconds. All of them are O(1) amortized per sample and per query. Percentiles
+/// select on a copy of the window, computeSum() and computeMinMax() rescan it with the vector
+/// kernels. NaN samples are not supported.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT RollingWindow {
+public:
+    /// @brief  The class constructor.
+    /// @param  capacity    [in] The number of samples in a full window, at least 1.
+    explicit RollingWindow(size_t capacity);
+
+    /// @brief  The class destructor.
+    ~RollingWindow();
+
+    /// @brief  Adds a sample, the oldest one leaves a full window.
+    /// @param  sample  [in] The sample.
+    void add(float sample);
+
+    /// @brief  Removes all samples.
+    void clear();
+
+    /// @brief  Returns the number of samples in the window.
+    /// @return The number of samples.
+    size_t size() const;
+
+    /// @brief  Returns the number of samples of a full window.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    /// @brief  Returns true, if the window holds no sample.
+    /// @return true for empty.
+    bool isEmpty() const;
+
+    /// @brief  Returns the smallest sample of the window.
+    /// @return The smallest sample, +inf for an empty window.
+    float getMin() const;
+
+    /// @brief  Returns the largest sample of the window.
+    /// @return The largest sample, -inf for an empty window.
+    float getMax() const;
+
+    /// @brief  Returns the sum of the window.
+    /// @return The sum.
+    double getSum() const;
+
+    /// @brief  Returns the mean of the window.
+    /// @return The mean, 0 for an empty window.
+    double getMean() const;
+
+    /// @brief  Returns the population variance of the window.
+    /// @return The variance, 0 for an empty window.
+    double getVariance() const;
+
+    /// @brief  Returns a percentile by the nearest rank, this is O(size()).
+    /// @param  fraction    [in] The percentile between 0 and 1, 0.5 for the median.
+    /// @return The sample, 0 for an empty window.
+    float getPercentile(float fraction) const;
+
+    /// @brief  Adds up the window in a full scan.
+    /// @return The sum in float precision.
+    float computeSum() const;
+
+    /// @brief  Finds the smallest and largest sample in a full scan.
+    /// @param  min     [out] The smallest sample, +inf for an empty window.
+    /// @param  max     [out] The largest sample, -inf for an empty window.
+    void computeMinMax(float &min, float &max) const;
+
+    /// @brief  Returns the samples, oldest first.
+    /// @return The ring buffer.
+    const TRingBuffer<float> &getSamples() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(RollingWindow)
+
+private:
+    // A candidate of a monotonic queue, the sequence number tells when it leaves the window
+    struct Extreme {
+        uint64_t m_sequence;
+        float m_value;
+    };
+
+    // A sum with Neumaier compensation, which stays exact while large and small terms alternate
+    struct CompensatedSum {
+        double m_sum;
+        double m_compensation;
+
+        void add(double value);
+        double get() const;
+    };
+
+    void updateExtremes(TRingBuffer<Extreme> &queue, float sample, bool isMin);
+    void rebase();
+
+private:
+    TRingBuffer<float> m_samples;
+    TRingBuffer<Extreme> m_minQueue;
+    TRingBuffer<Extreme> m_maxQueue;
+    CompensatedSum m_sum;
+    CompensatedSum m_sumSq;
+    double m_offset;
+    uint64_t m_sequence;
+    mutable std::vector<float> m_scratch;
+};
+
+inline size_t RollingWindow::size() const {
+    return m_samples.size();
+}
+
+inline size_t RollingWindow::capacity() const {
+    return m_samples.capacity();
+}
+
+inline bool RollingWindow::isEmpty() const {
+    return m_samples.isEmpty();
+}
+
+inline const TRingBuffer<float> &RollingWindow::getSamples() const {
+    return m_samples;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,213 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Symbolizer
+///	@ingroup	CPPCore
+///
+///	@brief  This class resolves code addresses of the running process into function names. The
+/// mapped modules are read from /proc/self/maps, the names are taken from the ELF symbol tables
+/// (.symtab and .dynsym) of the mapped files. Nothing of this is async-signal-safe, so use it
+/// offline after the samples were taken.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Symbolizer {
+public:
+    /// @brief  The class constructor, will read the current module mapping.
+    Symbolizer();
+
+    /// @brief  The class destructor.
+    ~Symbolizer();
+
+    /// @brief  Will re-read the module mapping, use this after loading new shared objects.
+    void refresh();
+
+    /// @brief  Will resolve the given address.
+    /// @param  address     [in] The code address.
+    /// @param  name        [out] The demangled function name or module+offset as a fallback.
+    /// @return true, if a symbol was found, false if only the fallback name was generated.
+    bool resolve(uintptr_t address, std::string &name);
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Symbolizer)
+
+private:
+    struct Symbol {
+        uintptr_t m_start;
+        uintptr_t m_size;
+        std::string m_name;
+    };
+
+    struct Module {
+        uintptr_t m_start;
+        uintptr_t m_end;
+        uintptr_t m_offset;
+        std::string m_path;
+        bool m_loaded;
+        std::vector<std::pair<uintptr_t, uintptr_t>> m_segments; // p_offset, p_vaddr
+        std::vector<Symbol> m_symbols;
+    };
+
+    Module *findModule(uintptr_t address);
+    void loadSymbols(Module &module);
+
+private:
+    std::vector<Module> m_modules;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		SamplingProfiler
+///	@ingroup	CPPCore
+///
+///	@brief  This class implements a statistical CPU profiler. A CPU-time timer raises SIGPROF with
+/// the configured frequency, the signal handler unwinds the interrupted call stack into a
+/// preallocated, lock-free sample buffer. The samples will be symbolized offline and can be
+/// written as folded stacks, which is the input format of flamegraph.pl and friends:
+/// @code
+/// SamplingProfiler profiler(99);
+/// profiler.start();
+/// doWork();
+/// profiler.stop();
+/// std::string folded;
+/// profiler.writeFoldedStacks(folded);
+/// @endcode
+/// There can only be one running profiler per process, the timer and the signal are process-wide.
+/// The frame-pointer walk only reads inside the stack of the sampled thread. The bounds are known
+/// for the thread which called start(), other threads have to call registerThread(), otherwise
+/// their samples only contain the leaf frame.
+/// At the moment only Linux is supported, start() will return false on other platforms.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT SamplingProfiler {
+public:
+    /// @brief  The max. number of frames stored per sample.
+    static constexpr size_t MaxFrames = 64;
+    /// @brief  The default sampling frequency. Not a multiple of 10 to avoid lock-step sampling.
+    static constexpr size_t DefaultFrequency = 99;
+    /// @brief  The default number of samples the buffer can hold.
+    static constexpr size_t DefaultCapacity = 16384;
+
+    /// @brief  This enum describes the used stack unwinding strategy.
+    enum class UnwindMode {
+        FramePointer,   ///< Follows the frame-pointer chain, cheap and async-signal-safe. Code
+                        ///  built without frame pointers shows up with truncated stacks.
+        Dwarf           ///< Unwinds using the unwind tables, works without frame pointers. Opt-in
+                        ///  and not async-signal-safe: _Unwind_Backtrace takes the loader lock
+                        ///  and may allocate, a sample taken inside malloc or dlopen can deadlock.
+    };
+
+    /// @brief  One sampled call stack, the leaf frame comes first.
+    struct Sample {
+        std::atomic<uint32_t> m_state;
+        uint32_t m_numFrames;
+        uintptr_t m_frames[MaxFrames];
+    };
+
+    /// @brief  The class constructor.
+    /// @param  frequency   [in] The sampling frequency in Hz per consumed CPU second.
+    /// @param  capacity    [in] The number of samples the buffer can hold.
+    /// @param  mode        [in] The unwinding strategy.
+    SamplingProfiler(size_t frequency = DefaultFrequency, size_t capacity = DefaultCapacity,
+            UnwindMode mode = UnwindMode::FramePointer);
+
+    /// @brief  The class destructor, a running profiler will be stopped.
+    ~SamplingProfiler();
+
+    /// @brief  Will start the sampling.
+    /// @return true, if successful, false if another profiler is running or the timer failed.
+    bool start();
+
+    /// @brief  Will stop the sampling. Already taken samples will be kept.
+    void stop();
+
+    /// @brief  Will record the stack bounds of the calling thread, so the frame-pointer walk can
+    ///         unwind its samples. Call it once per thread, before or while profiling.
+    /// @return true, if the bounds are known.
+    static bool registerThread();
+
+    /// @brief  Returns true, when the profiler is sampling.
+    /// @return true for running.
+    bool isRunning() const;
+
+    /// @brief  Will set a new sampling frequency, a running timer will be updated.
+    /// @param  frequency   [in] The new frequency in Hz.
+    void setFrequency(size_t frequency);
+
+    /// @brief  Returns the sampling frequency.
+    /// @return The frequency in Hz.
+    size_t getFrequency() const;
+
+    /// @brief  Returns the number of samples in the buffer.
+    /// @return The number of samples.
+    size_t numSamples() const;
+
+    /// @brief  Returns the number of samples lost because the buffer was full.
+    /// @return The number of dropped samples.
+    size_t numDropped() const;
+
+    /// @brief  Will return the stored sample.
+    /// @param  index   [in] The sample index, must be lower than numSamples().
+    /// @return The sample.
+    const Sample &getSample(size_t index) const;
+
+    /// @brief  Will symbolize all samples and write them as folded stacks, one line per distinct
+    ///         stack, root frame first: "main;run;compute 42".
+    /// @param  folded  [out] The folded stacks.
+    void writeFoldedStacks(std::string &folded);
+
+    /// @brief  Will write the folded stacks into a file.
+    /// @param  filename    [in] The name of the file.
+    /// @return true, if successful.
+    bool writeFoldedStacks(const char *filename);
+
+    /// @brief  Will remove all samples, the profiler must be stopped.
+    void clear();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(SamplingProfiler)
+
+private:
+    struct SignalHandler;
+    void record(void *context);
+    bool armTimer(size_t frequency);
+
+private:
+    UnwindMode m_mode;
+    std::atomic<size_t> m_frequency;
+    size_t m_capacity;
+    Sample *m_samples;
+    std::atomic<size_t> m_writeIndex;
+    std::atomic<size_t> m_dropped;
+    std::atomic<bool> m_running;
+    void *m_timer;
+};
+
+} // Namespace CPPCore
@@ -0,0 +1,298 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Spatial/SpatialTypes.h>
+
+#include <bit>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define CPPCORE_SPATIAL_SSE
+#endif
+
+namespace CPPCore {
+
+class TaskScheduler;
+
+/// @brief  The build settings of a Bvh.
+struct BvhOptions {
+    /// The largest number of primitives per leaf
+    uint32_t m_maxLeafSize = 4;
+    /// The number of SAH bins per axis, at most Bvh::MaxBins
+    uint32_t m_numBins = 16;
+    /// Ranges with more primitives are built as tasks and binned in parallel
+    size_t m_parallelThreshold = 16384;
+    /// The scheduler, nullptr for the default one
+    TaskScheduler *m_scheduler = nullptr;
+};
+
+namespace Details {
+
+    // A node of the 4-wide tree. The child boxes are stored per coordinate, so one SSE register
+    // holds the same bound of all 4 children and a box test checks them at once. Inner children
+    // have a count of 0 and store the node index, leaves store the first primitive and the
+    // number of primitives. Unused lanes keep the empty box.
+    struct alignas(64) BvhNode {
+        float m_minX[4];
+        float m_minY[4];
+        float m_minZ[4];
+        float m_maxX[4];
+        float m_maxY[4];
+        float m_maxZ[4];
+        uint32_t m_children[4];
+        uint32_t m_counts[4];
+    };
+
+    // The ray with the reciprocal direction, broadcast for the slab tests
+    struct BvhRay {
+        float m_origin[3];
+        float m_invDirection[3];
+    };
+
+    // Returns the mask of the children whose boxes the ray hits between 0 and maxDistance and
+    // their entry distances
+    inline unsigned intersectRay4(const BvhNode &node, const BvhRay &ray, float maxDistance, float *distances) {
+#ifdef CPPCORE_SPATIAL_SSE
+        const __m128 originX = _mm_set1_ps(ray.m_origin[0]);
+        const __m128 originY = _mm_set1_ps(ray.m_origin[1]);
+        const __m128 originZ = _mm_set1_ps(ray.m_origin[2]);
+        const __m128 invX = _mm_set1_ps(ray.m_invDirection[0]);
+        const __m128 invY = _mm_set1_ps(ray.m_invDirection[1]);
+        const __m128 invZ = _mm_set1_ps(ray.m_invDirection[2]);
+        const __m128 minX = _mm_load_ps(node.m_minX);
+        const __m128 maxX = _mm_load_ps(node.m_maxX);
+        const __m128 x0 = _mm_mul_ps(_mm_sub_ps(minX, originX), invX);
+        const __m128 x1 = _mm_mul_ps(_mm_sub_ps(maxX, originX), invX);
+        const __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.m_minY), originY), invY);
+        const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.m_maxY), originY), invY);
+        const __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.m_minZ), originZ), invZ);
+        const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.m_maxZ), originZ), invZ);
+        __m128 nearDist = _mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1));
+        nearDist = _mm_max_ps(nearDist, _mm_max_ps(_mm_min_ps(z0, z1), _mm_setzero_ps()));
+        __m128 farDist = _mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1));
+        farDist = _mm_min_ps(farDist, _mm_min_ps(_mm_max_ps(z0, z1), _mm_set1_ps(maxDistance)));
+        _mm_storeu_ps(distances, nearDist);
+
+        // The slabs of an empty box still overlap, so unused lanes are masked by min <= max
+        const __m128 hit = _mm_and_ps(_mm_cmple_ps(nearDist, farDist), _mm_cmple_ps(minX, maxX));
+        return static_cast<unsigned>(_mm_movemask_ps(hit));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            const float x0 = (node.m_minX[i] - ray.m_origin[0]) * ray.m_invDirection[0];
+            const float x1 = (node.m_maxX[i] - ray.m_origin[0]) * ray.m_invDirection[0];
+            const float y0 = (node.m_minY[i] - ray.m_origin[1]) * ray.m_invDirection[1];
+            const float y1 = (node.m_maxY[i] - ray.m_origin[1]) * ray.m_invDirection[1];
+            const float z0 = (node.m_minZ[i] - ray.m_origin[2]) * ray.m_invDirection[2];
+            const float z1 = (node.m_maxZ[i] - ray.m_origin[2]) * ray.m_invDirection[2];
+            const float nearDist = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+            const float farDist = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::min(std::max(z0, z1), maxDistance));
+            distances[i] = nearDist;
+            if (nearDist <= farDist && node.m_minX[i] <= node.m_maxX[i]) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+} // Namespace Details
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Bvh
+///	@ingroup	CPPCore
+///
+///	@brief  A bounding volume hierarchy over boxes or points. The tree is built top-down with the
+/// binned surface area heuristic, large ranges are binned in parallel and their subtrees are built
+/// as tasks. Every node holds 4 children in SoA layout, so a query tests 4 boxes with one SSE
+/// instruction per bound. The leaves reference the primitives by their original index.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Bvh {
+public:
+    /// @brief  The most SAH bins per axis.
+    static constexpr uint32_t MaxBins = 32;
+
+    /// @brief  The class constructor, the tree is empty.
+    Bvh();
+
+    /// @brief  The class destructor.
+    ~Bvh();
+
+    /// @brief  Builds the tree over boxes, replaces the old one.
+    /// @param  boxes   [in] The primitive boxes.
+    /// @param  count   [in] The number of boxes.
+    /// @param  options [in] The build settings.
+    void build(const BoundingBox *boxes, size_t count, const BvhOptions &options = BvhOptions());
+
+    /// @brief  Builds the tree over points, replaces the old one.
+    /// @param  points  [in] The points.
+    /// @param  count   [in] The number of points.
+    /// @param  options [in] The build settings.
+    void build(const Float3 *points, size_t count, const BvhOptions &options = BvhOptions());
+
+    /// @brief  Removes the tree.
+    void clear();
+
+    /// @brief  Appends the indices of all primitives which overlap a box.
+    /// @param  box     [in] The query box.
+    /// @param  result  [out] Receives the primitive indices.
+    /// @return The number of appended indices.
+    size_t queryBox(const BoundingBox &box, std::vector<uint32_t> &result) const;
+
+    /// @brief  Appends the indices of all primitives which overlap a sphere.
+    /// @param  center  [in] The center of the sphere.
+    /// @param  radius  [in] The radius of the sphere.
+    /// @param  result  [out] Receives the primitive indices.
+    /// @return The number of appended indices.
+    size_t querySphere(const Float3 &center, float radius, std::vector<uint32_t> &result) const;
+
+    /// @brief  Finds the closest hit along a ray. The nodes are visited front to back, func(index)
+    ///         is called for the primitives whose boxes the ray hits and returns the hit distance
+    ///         or a negative value for a miss. Hits shorten the ray.
+    /// @param  ray         [in] The ray.
+    /// @param  maxDistance [in] The length of the ray.
+    /// @param  func        [in] Intersects a primitive.
+    /// @param  hitIndex    [out] The closest primitive, InvalidSpatialIndex without a hit.
+    /// @return The distance of the closest hit, maxDistance without a hit.
+    template <class Func>
+    float intersectRay(const Ray &ray, float maxDistance, Func func, uint32_t &hitIndex) const;
+
+    /// @brief  Returns the number of primitives.
+    /// @return The number of primitives.
+    size_t getNumPrimitives() const;
+
+    /// @brief  Returns the number of nodes.
+    /// @return The number of nodes.
+    size_t getNumNodes() const;
+
+    /// @brief  Returns the box around all primitives.
+    /// @return The box.
+    const BoundingBox &getBounds() const;
+
+    /// @brief  Returns true, if the tree holds no primitives.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Bvh)
+
+private:
+    friend class BvhBuilder;
+
+    // A tree of depth MaxDepth pushes at most 3 children per level
+    static constexpr size_t MaxDepth = 64;
+    static constexpr size_t StackSize = 3 * MaxDepth + 4;
+
+private:
+    std::vector<Details::BvhNode> m_nodes;
+    std::vector<uint32_t> m_indices;
+    std::vector<BoundingBox> m_boxes;
+    BoundingBox m_bounds;
+    uint32_t m_rootChild;
+    uint32_t m_rootCount;
+};
+
+inline size_t Bvh::getNumPrimitives() const {
+    return m_indices.size();
+}
+
+inline size_t Bvh::getNumNodes() const {
+    return m_nodes.size();
+}
+
+inline const BoundingBox &Bvh::getBounds() const {
+    return m_bounds;
+}
+
+inline bool Bvh::isEmpty() const {
+    return m_indices.empty();
+}
+
+template <class Func>
+inline float Bvh::intersectRay(const Ray &ray, float maxDistance, Func func, uint32_t &hitIndex) const {
+    hitIndex = InvalidSpatialIndex;
+    if (isEmpty()) {
+        return maxDistance;
+    }
+
+    Details::BvhRay bvhRay;
+    for (size_t i = 0; i < 3; ++i) {
+        bvhRay.m_origin[i] = ray.m_origin[i];
+        bvhRay.m_invDirection[i] = 1.0f / ray.m_direction[i];
+    }
+
+    auto intersectLeaf = [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+            const float distance = func(m_indices[i]);
+            if (0.0f <= distance && distance < maxDistance) {
+                maxDistance = distance;
+                hitIndex = m_indices[i];
+            }
+        }
+    };
+
+    // A small tree is a single leaf without nodes
+    if (0 != m_rootCount) {
+        intersectLeaf(m_rootChild, m_rootCount);
+        return maxDistance;
+    }
+
+    struct Entry {
+        uint32_t m_node;
+        float m_distance;
+    };
+    Entry stack[StackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = Entry{ m_rootChild, 0.0f };
+    while (0 != stackSize) {
+        const Entry entry = stack[--stackSize];
+        if (entry.m_distance > maxDistance) {
+            continue;
+        }
+
+        const Details::BvhNode &node = m_nodes[entry.m_node];
+        float distances[4];
+        unsigned mask = Details::intersectRay4(node, bvhRay, maxDistance, distances);
+
+        // Push the hit inner children far to near, so the nearest one is visited first
+        const size_t firstPushed = stackSize;
+        for (; 0 != mask; mask &= mask - 1) {
+            const unsigned lane = static_cast<unsigned>(std::countr_zero(mask));
+            if (0 != node.m_counts[lane]) {
+                intersectLeaf(node.m_children[lane], node.m_counts[lane]);
+                continue;
+            }
+            size_t pos = stackSize++;
+            for (; pos > firstPushed && stack[pos - 1].m_distance < distances[lane]; --pos) {
+                stack[pos] = stack[pos - 1];
+            }
+            stack[pos] = Entry{ node.m_children[lane], distances[lane] };
+        }
+    }
+
+    return maxDistance;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,137 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Container/TDenseHashMap.h>
+#include <cppcore/Spatial/SpatialTypes.h>
+
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		HashGrid
+///	@ingroup	CPPCore
+///
+///	@brief  A uniform grid over moving points. Only occupied cells exist, they are kept in a
+/// TDenseHashMap by their packed coordinates and store their points contiguously, so a query reads
+/// one array per cell. Inserting, moving and removing a point is O(1), moving within the same cell
+/// only stores the new position. The points are identified by their index.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT HashGrid {
+public:
+    /// @brief  The class constructor.
+    /// @param  cellSize    [in] The edge length of a cell, about the typical query radius.
+    explicit HashGrid(float cellSize);
+
+    /// @brief  The class destructor.
+    ~HashGrid();
+
+    /// @brief  Inserts a point or moves it, if the index is already in use.
+    /// @param  index   [in] The index of the point.
+    /// @param  point   [in] The position.
+    void insert(uint32_t index, const Float3 &point);
+
+    /// @brief  Moves a point, same as insert().
+    /// @param  index   [in] The index of the point.
+    /// @param  point   [in] The new position.
+    void move(uint32_t index, const Float3 &point);
+
+    /// @brief  Removes a point.
+    /// @param  index   [in] The index of the point.
+    /// @return true, if the point was found.
+    bool remove(uint32_t index);
+
+    /// @brief  Removes all points.
+    void clear();
+
+    /// @brief  Returns true, if a point with the index exists.
+    /// @param  index   [in] The index of the point.
+    /// @return true, if it exists.
+    bool hasPoint(uint32_t index) const;
+
+    /// @brief  Returns the position of a point.
+    /// @param  index   [in] The index of an existing point.
+    /// @return The position.
+    Float3 getPoint(uint32_t index) const;
+
+    /// @brief  Appends the indices of all points within a radius.
+    /// @param  center  [in] The center of the sphere.
+    /// @param  radius  [in] The radius of the sphere.
+    /// @param  result  [out] Receives the point indices.
+    /// @return The number of appended indices.
+    size_t queryRadius(const Float3 &center, float radius, std::vector<uint32_t> &result) const;
+
+    /// @brief  Appends the indices of all points inside a box.
+    /// @param  box     [in] The query box.
+    /// @param  result  [out] Receives the point indices.
+    /// @return The number of appended indices.
+    size_t queryBox(const BoundingBox &box, std::vector<uint32_t> &result) const;
+
+    /// @brief  Returns the number of points.
+    /// @return The number of points.
+    size_t size() const;
+
+    /// @brief  Returns the edge length of a cell.
+    /// @return The cell size.
+    float getCellSize() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(HashGrid)
+
+private:
+    struct Entry {
+        float m_x;
+        float m_y;
+        float m_z;
+        uint32_t m_index;
+    };
+
+    uint64_t getCellKey(const Float3 &point) const;
+    void addToCell(uint32_t index, uint64_t key, const Float3 &point);
+    void removeFromCell(uint32_t index);
+    template <class Func>
+    size_t queryCells(const BoundingBox &box, std::vector<uint32_t> &result, Func accept) const;
+
+private:
+    float m_cellSize;
+    float m_invCellSize;
+    size_t m_size;
+    TDenseHashMap<uint64_t, std::vector<Entry>> m_cells;
+    std::vector<uint64_t> m_cellKeys;
+    std::vector<uint32_t> m_slots;
+};
+
+inline void HashGrid::move(uint32_t index, const Float3 &point) {
+    insert(index, point);
+}
+
+inline size_t HashGrid::size() const {
+    return m_size;
+}
+
+inline float HashGrid::getCellSize() const {
+    return m_cellSize;
+}
+
+} // Namespace CPPCore
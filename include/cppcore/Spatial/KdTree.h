@@ -0,0 +1,133 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Spatial/SpatialTypes.h>
+
+#include <vector>
+
+namespace CPPCore {
+
+class TaskScheduler;
+
+/// @brief  The build settings of a KdTree.
+struct KdTreeOptions {
+    /// The largest number of points per leaf, at most KdTree::MaxBucketSize
+    uint32_t m_bucketSize = 16;
+    /// Ranges with more points are built as tasks
+    size_t m_parallelThreshold = 16384;
+    /// The scheduler, nullptr for the default one
+    TaskScheduler *m_scheduler = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		KdTree
+///	@ingroup	CPPCore
+///
+///	@brief  A k-d tree over static points for k-nearest-neighbour and radius queries. The tree is
+/// balanced and implicit, the children of node i are 2i + 1 and 2i + 2, so an inner node is just
+/// its split value and axis. The points are stored per coordinate in leaf order, a leaf is a
+/// bucket of consecutive points whose distances are computed in one vectorized loop.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT KdTree {
+public:
+    /// @brief  The most points per leaf.
+    static constexpr uint32_t MaxBucketSize = 64;
+
+    /// @brief  The class constructor, the tree is empty.
+    KdTree();
+
+    /// @brief  The class destructor.
+    ~KdTree();
+
+    /// @brief  Builds the tree, replaces the old one.
+    /// @param  points  [in] The points.
+    /// @param  count   [in] The number of points.
+    /// @param  options [in] The build settings.
+    void build(const Float3 *points, size_t count, const KdTreeOptions &options = KdTreeOptions());
+
+    /// @brief  Removes the tree.
+    void clear();
+
+    /// @brief  Finds the k nearest points, sorted by distance.
+    /// @param  query       [in] The query point.
+    /// @param  k           [in] The number of points to find.
+    /// @param  indices     [out] Receives up to k point indices.
+    /// @param  distancesSq [out] Receives the squared distances of the points.
+    /// @param  maxDistance [in] Points further away are ignored.
+    /// @return The number of found points, less than k for small trees or a short maxDistance.
+    size_t findNearest(const Float3 &query, size_t k, uint32_t *indices, float *distancesSq,
+            float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+    /// @brief  Finds the nearest point.
+    /// @param  query   [in] The query point.
+    /// @return The index of the nearest point, InvalidSpatialIndex for an empty tree.
+    uint32_t findNearest(const Float3 &query) const;
+
+    /// @brief  Appends the indices of all points within a radius.
+    /// @param  center  [in] The center of the sphere.
+    /// @param  radius  [in] The radius of the sphere.
+    /// @param  result  [out] Receives the point indices.
+    /// @return The number of appended indices.
+    size_t queryRadius(const Float3 &center, float radius, std::vector<uint32_t> &result) const;
+
+    /// @brief  Returns the number of points.
+    /// @return The number of points.
+    size_t getNumPoints() const;
+
+    /// @brief  Returns true, if the tree holds no points.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(KdTree)
+
+private:
+    struct PointRef {
+        Float3 m_point;
+        uint32_t m_index;
+    };
+
+    void buildNode(size_t node, uint32_t level, uint32_t begin, uint32_t end, PointRef *refs,
+            size_t parallelThreshold, TaskScheduler *scheduler);
+
+private:
+    uint32_t m_numLevels;
+    std::vector<float> m_splits;
+    std::vector<uint8_t> m_axes;
+    std::vector<uint32_t> m_leafOffsets;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+    std::vector<uint32_t> m_indices;
+};
+
+inline size_t KdTree::getNumPoints() const {
+    return m_indices.size();
+}
+
+inline bool KdTree::isEmpty() const {
+    return m_indices.empty();
+}
+
+} // Namespace CPPCore
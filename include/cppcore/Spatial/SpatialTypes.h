@@ -0,0 +1,203 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Container/TStaticArray.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace CPPCore {
+
+/// @brief  A point or vector with 3 float components, the same layout as a Float3 Variant.
+using Float3 = TStaticArray<float, 3>;
+
+/// @brief  The index of a point or primitive in a spatial structure.
+static constexpr uint32_t InvalidSpatialIndex = 0xFFFFFFFFu;
+
+/// @brief  Returns the dot product of two vectors.
+/// @param  a   [in] The first vector.
+/// @param  b   [in] The second vector.
+/// @return The dot product.
+inline constexpr float dot(const Float3 &a, const Float3 &b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/// @brief  Returns the squared distance between two points.
+/// @param  a   [in] The first point.
+/// @param  b   [in] The second point.
+/// @return The squared distance.
+inline constexpr float getDistanceSq(const Float3 &a, const Float3 &b) {
+    const Float3 delta = a - b;
+    return dot(delta, delta);
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@class		BoundingBox
+///	@ingroup	CPPCore
+///
+///	@brief  An axis-aligned bounding box. The default box is empty, min is +inf and max is -inf,
+/// so extending it by the first point or box gives exactly that point or box.
+//-------------------------------------------------------------------------------------------------
+struct BoundingBox {
+    Float3 m_min = Float3::filled(std::numeric_limits<float>::infinity());
+    Float3 m_max = Float3::filled(-std::numeric_limits<float>::infinity());
+
+    /// @brief  Returns the box of a single point.
+    /// @param  point   [in] The point.
+    /// @return The box.
+    static constexpr BoundingBox fromPoint(const Float3 &point);
+
+    /// @brief  Returns true, if the box contains no point.
+    /// @return true, if empty.
+    constexpr bool isEmpty() const;
+
+    /// @brief  Grows the box to contain a point.
+    /// @param  point   [in] The point.
+    constexpr void extend(const Float3 &point);
+
+    /// @brief  Grows the box to contain another box.
+    /// @param  box     [in] The other box.
+    constexpr void extend(const BoundingBox &box);
+
+    /// @brief  Returns the center of the box.
+    /// @return The center.
+    constexpr Float3 getCenter() const;
+
+    /// @brief  Returns the size of the box per axis.
+    /// @return The size.
+    constexpr Float3 getExtent() const;
+
+    /// @brief  Returns the axis with the largest extent.
+    /// @return 0, 1 or 2 for x, y or z.
+    constexpr uint32_t getLongestAxis() const;
+
+    /// @brief  Returns the surface area, 0 for an empty box.
+    /// @return The surface area.
+    constexpr float getSurfaceArea() const;
+
+    /// @brief  Returns true, if the box contains a point, the border counts as inside.
+    /// @param  point   [in] The point.
+    /// @return true, if inside.
+    constexpr bool contains(const Float3 &point) const;
+
+    /// @brief  Returns true, if two boxes overlap, touching borders count as overlap.
+    /// @param  box     [in] The other box.
+    /// @return true, if they overlap.
+    constexpr bool overlaps(const BoundingBox &box) const;
+
+    /// @brief  Returns the squared distance from a point to the box, 0 for points inside.
+    /// @param  point   [in] The point.
+    /// @return The squared distance.
+    constexpr float getDistanceSq(const Float3 &point) const;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Ray
+///	@ingroup	CPPCore
+///
+///	@brief  A ray with an origin and a direction, the direction does not need to be normalized.
+/// The hit distances are measured in multiples of the direction.
+//-------------------------------------------------------------------------------------------------
+struct Ray {
+    Float3 m_origin;
+    Float3 m_direction;
+
+    /// @brief  Returns the point at a distance along the ray.
+    /// @param  distance    [in] The distance.
+    /// @return The point.
+    constexpr Float3 getPoint(float distance) const {
+        return m_origin + m_direction * distance;
+    }
+};
+
+inline constexpr BoundingBox BoundingBox::fromPoint(const Float3 &point) {
+    return BoundingBox{ point, point };
+}
+
+inline constexpr bool BoundingBox::isEmpty() const {
+    return m_min[0] > m_max[0] || m_min[1] > m_max[1] || m_min[2] > m_max[2];
+}
+
+inline constexpr void BoundingBox::extend(const Float3 &point) {
+    for (size_t i = 0; i < 3; ++i) {
+        m_min[i] = std::min(m_min[i], point[i]);
+        m_max[i] = std::max(m_max[i], point[i]);
+    }
+}
+
+inline constexpr void BoundingBox::extend(const BoundingBox &box) {
+    for (size_t i = 0; i < 3; ++i) {
+        m_min[i] = std::min(m_min[i], box.m_min[i]);
+        m_max[i] = std::max(m_max[i], box.m_max[i]);
+    }
+}
+
+inline constexpr Float3 BoundingBox::getCenter() const {
+    return (m_min + m_max) * 0.5f;
+}
+
+inline constexpr Float3 BoundingBox::getExtent() const {
+    return m_max - m_min;
+}
+
+inline constexpr uint32_t BoundingBox::getLongestAxis() const {
+    const Float3 extent = getExtent();
+    if (extent[0] >= extent[1] && extent[0] >= extent[2]) {
+        return 0;
+    }
+    return extent[1] >= extent[2] ? 1 : 2;
+}
+
+inline constexpr float BoundingBox::getSurfaceArea() const {
+    if (isEmpty()) {
+        return 0.0f;
+    }
+    const Float3 extent = getExtent();
+    return 2.0f * (extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0]);
+}
+
+inline constexpr bool BoundingBox::contains(const Float3 &point) const {
+    return m_min[0] <= point[0] && point[0] <= m_max[0] &&
+           m_min[1] <= point[1] && point[1] <= m_max[1] &&
+           m_min[2] <= point[2] && point[2] <= m_max[2];
+}
+
+inline constexpr bool BoundingBox::overlaps(const BoundingBox &box) const {
+    return m_min[0] <= box.m_max[0] && box.m_min[0] <= m_max[0] &&
+           m_min[1] <= box.m_max[1] && box.m_min[1] <= m_max[1] &&
+           m_min[2] <= box.m_max[2] && box.m_min[2] <= m_max[2];
+}
+
+inline constexpr float BoundingBox::getDistanceSq(const Float3 &point) const {
+    float result = 0.0f;
+    for (size_t i = 0; i < 3; ++i) {
+        const float delta = std::max(std::max(m_min[i] - point[i], point[i] - m_max[i]), 0.0f);
+        result += delta * delta;
+    }
+    return result;
+}
+
+} // Namespace CPPCore
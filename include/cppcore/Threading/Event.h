@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/Futex.h>
+#include <cppcore/Threading/SpinLock.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Event
+///	@ingroup	CPPCore
+///
+///	@brief  A manual-reset event on a futex word. Once set, all waiting threads are released and
+/// wait() returns at once until the event is reset again.
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) Event {
+public:
+    /// @brief  The class constructor.
+    /// @param  isSet   [in] true for an initially set event.
+    explicit Event(bool isSet = false) noexcept;
+
+    /// @brief  The class destructor.
+    ~Event() = default;
+
+    /// @brief  Sets the event and wakes all waiting threads.
+    void set() noexcept;
+
+    /// @brief  Resets the event.
+    void reset() noexcept;
+
+    /// @brief  Waits until the event is set.
+    void wait() noexcept;
+
+    /// @brief  Returns true, if the event is set.
+    /// @return true, if set.
+    bool isSet() const noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Event)
+
+private:
+    std::atomic<uint32_t> m_state;
+    std::atomic<uint32_t> m_waiters;
+};
+
+inline Event::Event(bool isSet) noexcept :
+        m_state(isSet ? 1 : 0),
+        m_waiters(0) {
+    // empty
+}
+
+inline void Event::set() noexcept {
+    if (0 == m_state.exchange(1, std::memory_order_seq_cst) && 0 != m_waiters.load(std::memory_order_seq_cst)) {
+        Futex::wakeAll(m_state);
+    }
+}
+
+inline void Event::reset() noexcept {
+    m_state.store(0, std::memory_order_relaxed);
+}
+
+inline void Event::wait() noexcept {
+    for (uint32_t spins = 0; spins < 100; ++spins) {
+        if (isSet()) {
+            return;
+        }
+        cpuRelax();
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    while (0 == m_state.load(std::memory_order_seq_cst)) {
+        Futex::wait(m_state, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline bool Event::isSet() const noexcept {
+    return 0 != m_state.load(std::memory_order_acquire);
+}
+
+} // Namespace CPPCore
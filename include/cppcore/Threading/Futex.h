@@ -0,0 +1,56 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Futex
+///	@ingroup	CPPCore
+///
+///	@brief  Blocks threads on the value of a 32-bit word. On Linux this is the futex syscall, the
+/// other platforms use a table of condition variables hashed by the address. Like the syscall,
+/// wait() may return spuriously, so callers have to recheck their condition in a loop.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Futex {
+public:
+    /// @brief  Blocks while the word contains the expected value.
+    /// @param  word        [in] The word to wait on.
+    /// @param  expected    [in] The value to sleep on, returns at once for any other value.
+    static void wait(std::atomic<uint32_t> &word, uint32_t expected);
+
+    /// @brief  Wakes up to one thread which waits on the word.
+    /// @param  word        [in] The word.
+    static void wakeOne(std::atomic<uint32_t> &word);
+
+    /// @brief  Wakes all threads which wait on the word.
+    /// @param  word        [in] The word.
+    static void wakeAll(std::atomic<uint32_t> &word);
+};
+
+} // Namespace CPPCore
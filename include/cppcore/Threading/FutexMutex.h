@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/Futex.h>
+#include <cppcore/Threading/SpinLock.h>
+
+#include <algorithm>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		FutexMutex
+///	@ingroup	CPPCore
+///
+///	@brief  A mutex on a single futex word: 0 is free, 1 is locked and 2 is locked with sleeping
+/// waiters, so an uncontended unlock never enters the kernel. Before sleeping the lock spins
+/// adaptively: the spin limit follows a running average of the spins which were successful in
+/// the past.
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) FutexMutex {
+public:
+    /// @brief  The upper limit for the adaptive spin phase.
+    static constexpr int32_t MaxSpins = 200;
+
+    /// @brief  The default class constructor.
+    FutexMutex() noexcept;
+
+    /// @brief  The class destructor.
+    ~FutexMutex() = default;
+
+    /// @brief  Will acquire the lock.
+    void lock() noexcept;
+
+    /// @brief  Tries to acquire the lock without waiting.
+    /// @return true, if the lock was acquired.
+    bool try_lock() noexcept;
+
+    /// @brief  Will release the lock.
+    void unlock() noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(FutexMutex)
+
+private:
+    void lockSlow() noexcept;
+
+private:
+    std::atomic<uint32_t> m_state;
+    std::atomic<int32_t> m_spinEstimate;
+};
+
+inline FutexMutex::FutexMutex() noexcept :
+        m_state(0),
+        m_spinEstimate(MaxSpins / 4) {
+    // empty
+}
+
+inline void FutexMutex::lock() noexcept {
+    uint32_t expected = 0;
+    if (!m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        lockSlow();
+    }
+}
+
+inline bool FutexMutex::try_lock() noexcept {
+    uint32_t expected = 0;
+    return m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+inline void FutexMutex::unlock() noexcept {
+    if (2 == m_state.exchange(0, std::memory_order_release)) {
+        Futex::wakeOne(m_state);
+    }
+}
+
+inline void FutexMutex::lockSlow() noexcept {
+    const int32_t estimate = m_spinEstimate.load(std::memory_order_relaxed);
+    const int32_t maxSpins = std::min(MaxSpins, estimate * 2 + 10);
+    for (int32_t spins = 0; spins < maxSpins; ++spins) {
+        uint32_t expected = 0;
+        if (0 == m_state.load(std::memory_order_relaxed) &&
+                m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            m_spinEstimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+            return;
+        }
+        cpuRelax();
+    }
+    m_spinEstimate.store(estimate + (maxSpins - estimate) / 8, std::memory_order_relaxed);
+
+    // Mark the lock as contended and sleep until we get it
+    uint32_t state = m_state.exchange(2, std::memory_order_acquire);
+    while (0 != state) {
+        Futex::wait(m_state, 2);
+        state = m_state.exchange(2, std::memory_order_acquire);
+    }
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,130 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/SpinLock.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		McsLock
+///	@ingroup	CPPCore
+///
+///	@brief  The MCS queue lock. Waiting threads form a linked list and every thread spins on the
+/// flag of its own node, so a release only touches the cache line of the next waiter. The lock is
+/// fair and scales well under heavy contention.
+///
+/// The queue nodes can be passed explicitly, e.g. from the stack. lock() and unlock() without a
+/// node take one from a small per-thread cache, so the lock can be used with std::lock_guard.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT McsLock {
+public:
+    /// @brief  A queue node, one per waiting or owning thread.
+    struct alignas(CacheLineSize) Node {
+        std::atomic<Node*> m_next;
+        std::atomic<bool> m_locked;
+        bool m_allocated;
+    };
+
+    /// @brief  The default class constructor.
+    McsLock() noexcept;
+
+    /// @brief  The class destructor.
+    ~McsLock() = default;
+
+    /// @brief  Will acquire the lock, the node must stay valid until unlock.
+    /// @param  node    [in] The queue node of this thread.
+    void lock(Node &node) noexcept;
+
+    /// @brief  Tries to acquire the lock without waiting.
+    /// @param  node    [in] The queue node of this thread.
+    /// @return true, if the lock was acquired.
+    bool try_lock(Node &node) noexcept;
+
+    /// @brief  Will release the lock.
+    /// @param  node    [in] The node which was used for locking.
+    void unlock(Node &node) noexcept;
+
+    /// @brief  Will acquire the lock with a node of the per-thread cache.
+    void lock();
+
+    /// @brief  Tries to acquire the lock with a node of the per-thread cache.
+    /// @return true, if the lock was acquired.
+    bool try_lock();
+
+    /// @brief  Will release the lock, must be called by the owning thread.
+    void unlock();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(McsLock)
+
+private:
+    alignas(CacheLineSize) std::atomic<Node*> m_tail;
+    Node *m_owner;
+};
+
+inline McsLock::McsLock() noexcept :
+        m_tail(nullptr),
+        m_owner(nullptr) {
+    // empty
+}
+
+inline void McsLock::lock(Node &node) noexcept {
+    node.m_next.store(nullptr, std::memory_order_relaxed);
+    node.m_locked.store(true, std::memory_order_relaxed);
+    Node *prev = m_tail.exchange(&node, std::memory_order_acq_rel);
+    if (nullptr == prev) {
+        return;
+    }
+
+    prev->m_next.store(&node, std::memory_order_release);
+    Backoff backoff;
+    while (node.m_locked.load(std::memory_order_acquire)) {
+        backoff.pause();
+    }
+}
+
+inline bool McsLock::try_lock(Node &node) noexcept {
+    node.m_next.store(nullptr, std::memory_order_relaxed);
+    node.m_locked.store(false, std::memory_order_relaxed);
+    Node *expected = nullptr;
+    return m_tail.compare_exchange_strong(expected, &node, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+inline void McsLock::unlock(Node &node) noexcept {
+    Node *next = node.m_next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+        Node *expected = &node;
+        if (m_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+
+        // A successor has swapped the tail but not linked itself yet
+        while (nullptr == (next = node.m_next.load(std::memory_order_acquire))) {
+            cpuRelax();
+        }
+    }
+    next->m_locked.store(false, std::memory_order_release);
+}
+
+} // Namespace CPPCore
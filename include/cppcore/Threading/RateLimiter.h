@@ -0,0 +1,434 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+#include <cppcore/Container/THashMap.h>
+#include <cppcore/Threading/ReaderWriterLock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		SteadyClock
+///	@ingroup	CPPCore
+///
+///	@brief  The default clock of the rate limiters, the monotonic clock in nanoseconds.
+//-------------------------------------------------------------------------------------------------
+struct SteadyClock {
+    /// @brief  Returns the current time.
+    /// @return The time in nanoseconds.
+    uint64_t now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ManualClock
+///	@ingroup	CPPCore
+///
+///	@brief  A clock which only moves when it is told to, for deterministic tests. Copies share
+/// the same time, so a test can keep one copy and hand another one to a limiter.
+//-------------------------------------------------------------------------------------------------
+class ManualClock {
+public:
+    /// @brief  The class constructor.
+    /// @param  start   [in] The start time in nanoseconds.
+    explicit ManualClock(uint64_t start = 0);
+
+    /// @brief  Returns the current time.
+    /// @return The time in nanoseconds.
+    uint64_t now() const;
+
+    /// @brief  Sets the current time.
+    /// @param  time    [in] The time in nanoseconds.
+    void set(uint64_t time);
+
+    /// @brief  Moves the clock forward.
+    /// @param  delta   [in] The interval in nanoseconds.
+    void advance(uint64_t delta);
+
+private:
+    std::shared_ptr<std::atomic<uint64_t>> m_time;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TTokenBucket
+///	@ingroup	CPPCore
+///
+///	@brief  A lock-free token bucket. The whole state is one 64-bit word: the time at which the
+/// bucket will be full again (the generic cell rate algorithm). Taking n tokens moves that time
+/// n intervals forward, the request is allowed while it stays within one burst of now. So every
+/// decision is one load and one CAS, and a rejection does not write at all.
+//-------------------------------------------------------------------------------------------------
+template <class TClock = SteadyClock>
+class TTokenBucket {
+public:
+    /// @brief  The class constructor, the bucket starts full.
+    /// @param  ratePerSecond   [in] The refill rate in tokens per second, more than 0 and at most
+    ///                         10^9. Tokens are refilled at nanosecond resolution.
+    /// @param  burst           [in] The capacity of the bucket, at least 1.
+    /// @param  clock           [in] The clock.
+    TTokenBucket(double ratePerSecond, uint64_t burst, const TClock &clock = TClock());
+
+    /// @brief  Tries to take tokens.
+    /// @param  numTokens   [in] The number of tokens.
+    /// @return true, if the tokens were taken.
+    bool tryAcquire(uint64_t numTokens = 1);
+
+    /// @brief  Returns the number of tokens available now.
+    /// @return The number of tokens.
+    uint64_t getAvailable() const;
+
+    /// @brief  Returns the time until the given number of tokens will be available.
+    /// @param  numTokens   [in] The number of tokens, at most the burst.
+    /// @return The waiting time in nanoseconds, 0 if they are available now.
+    uint64_t getWaitTime(uint64_t numTokens = 1) const;
+
+    /// @brief  Returns the clock.
+    /// @return The clock.
+    const TClock &getClock() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TTokenBucket)
+
+private:
+    alignas(CacheLineSize) std::atomic<uint64_t> m_fullAt;
+    uint64_t m_interval;
+    uint64_t m_tolerance;
+    TClock m_clock;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TSlidingWindowLimiter
+///	@ingroup	CPPCore
+///
+///	@brief  Allows at most limit events in any window of the given length. The log of the last
+/// limit accepted events is kept in a ring buffer, an event is allowed when the slot it would
+/// overwrite expired. A slot carries a sequence number like a bounded MPMC queue, so a thread
+/// which was preempted between claiming a slot and storing its time cannot be overtaken by one
+/// which wrapped around. In that case the limiter answers conservatively and rejects.
+//-------------------------------------------------------------------------------------------------
+template <class TClock = SteadyClock>
+class TSlidingWindowLimiter {
+public:
+    /// @brief  The class constructor.
+    /// @param  limit       [in] The max. number of events per window, at least 1.
+    /// @param  windowNs    [in] The window length in nanoseconds.
+    /// @param  clock       [in] The clock.
+    TSlidingWindowLimiter(size_t limit, uint64_t windowNs, const TClock &clock = TClock());
+
+    /// @brief  The class destructor.
+    ~TSlidingWindowLimiter();
+
+    /// @brief  Tries to record one event.
+    /// @return true, if the event is allowed.
+    bool tryAcquire();
+
+    /// @brief  Returns the number of accepted events within the current window.
+    /// @return The number of events, a snapshot while other threads are recording.
+    size_t getNumInWindow() const;
+
+    /// @brief  Returns the clock.
+    /// @return The clock.
+    const TClock &getClock() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TSlidingWindowLimiter)
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> m_sequence;
+        std::atomic<uint64_t> m_expiresAt;
+    };
+
+    alignas(CacheLineSize) std::atomic<uint64_t> m_head;
+    Slot *m_slots;
+    size_t m_limit;
+    uint64_t m_window;
+    TClock m_clock;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TKeyedRateLimiter
+///	@ingroup	CPPCore
+///
+///	@brief  One limiter per key, e.g. per tenant. The keys are spread over shards, every shard
+/// owns a hash map guarded by a reader-writer lock. Existing limiters are found under the shared
+/// lock, new ones are created by the factory under the exclusive lock. Limiters are kept until the
+/// table is destroyed.
+//-------------------------------------------------------------------------------------------------
+template <class TLimiter>
+class TKeyedRateLimiter {
+public:
+    /// @brief  Creates the limiter of a new key.
+    using Factory = std::function<TLimiter*(unsigned int key)>;
+
+    /// @brief  The class constructor.
+    /// @param  factory     [in] Creates the limiters, the table takes the ownership.
+    /// @param  numShards   [in] The number of shards, will be rounded up to a power of two.
+    explicit TKeyedRateLimiter(Factory factory, size_t numShards = 16);
+
+    /// @brief  The class destructor, will delete all limiters.
+    ~TKeyedRateLimiter();
+
+    /// @brief  Tries to record one event for a key.
+    /// @param  key     [in] The key.
+    /// @return true, if the event is allowed.
+    bool tryAcquire(unsigned int key);
+
+    /// @brief  Returns the limiter of a key, it will be created on first use.
+    /// @param  key     [in] The key.
+    /// @return The limiter.
+    TLimiter *get(unsigned int key);
+
+    /// @brief  Returns the number of keys.
+    /// @return The number of keys.
+    size_t size() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TKeyedRateLimiter)
+
+private:
+    struct alignas(CacheLineSize) Shard {
+        mutable ReaderWriterLock m_lock;
+        THashMap<unsigned int, TLimiter*> m_limiters;
+        std::vector<std::unique_ptr<TLimiter>> m_owned;
+    };
+
+    Shard &getShard(unsigned int key) const;
+
+private:
+    Factory m_factory;
+    Shard *m_shards;
+    size_t m_mask;
+};
+
+inline ManualClock::ManualClock(uint64_t start) :
+        m_time(std::make_shared<std::atomic<uint64_t>>(start)) {
+    // empty
+}
+
+inline uint64_t ManualClock::now() const {
+    return m_time->load(std::memory_order_acquire);
+}
+
+inline void ManualClock::set(uint64_t time) {
+    m_time->store(time, std::memory_order_release);
+}
+
+inline void ManualClock::advance(uint64_t delta) {
+    m_time->fetch_add(delta, std::memory_order_acq_rel);
+}
+
+template <class TClock>
+inline TTokenBucket<TClock>::TTokenBucket(double ratePerSecond, uint64_t burst, const TClock &clock) :
+        m_fullAt(0),
+        m_interval(1),
+        m_tolerance(0),
+        m_clock(clock) {
+    if (0.0 < ratePerSecond && ratePerSecond < 1e9) {
+        m_interval = static_cast<uint64_t>(1e9 / ratePerSecond + 0.5);
+    }
+    m_tolerance = m_interval * (0 == burst ? 1 : burst);
+}
+
+template <class TClock>
+inline bool TTokenBucket<TClock>::tryAcquire(uint64_t numTokens) {
+    const uint64_t cost = m_interval * numTokens;
+    if (cost > m_tolerance) {
+        return false;
+    }
+
+    const uint64_t now = m_clock.now();
+    uint64_t fullAt = m_fullAt.load(std::memory_order_relaxed);
+    for (;;) {
+        // Tokens which overflowed the bucket are gone, so an idle bucket starts from now
+        const uint64_t next = (fullAt > now ? fullAt : now) + cost;
+        if (next - now > m_tolerance) {
+            return false;
+        }
+        if (m_fullAt.compare_exchange_weak(fullAt, next, std::memory_order_relaxed, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+template <class TClock>
+inline uint64_t TTokenBucket<TClock>::getAvailable() const {
+    const uint64_t now = m_clock.now();
+    const uint64_t fullAt = m_fullAt.load(std::memory_order_relaxed);
+    const uint64_t debt = fullAt > now ? fullAt - now : 0;
+
+    return (m_tolerance - debt) / m_interval;
+}
+
+template <class TClock>
+inline uint64_t TTokenBucket<TClock>::getWaitTime(uint64_t numTokens) const {
+    const uint64_t now = m_clock.now();
+    const uint64_t fullAt = m_fullAt.load(std::memory_order_relaxed);
+    const uint64_t next = (fullAt > now ? fullAt : now) + m_interval * numTokens;
+
+    return next - now > m_tolerance ? next - now - m_tolerance : 0;
+}
+
+template <class TClock>
+inline const TClock &TTokenBucket<TClock>::getClock() const {
+    return m_clock;
+}
+
+template <class TClock>
+inline TSlidingWindowLimiter<TClock>::TSlidingWindowLimiter(size_t limit, uint64_t windowNs, const TClock &clock) :
+        m_head(0),
+        m_slots(nullptr),
+        m_limit(0 == limit ? 1 : limit),
+        m_window(windowNs),
+        m_clock(clock) {
+    m_slots = new Slot[m_limit];
+    for (size_t i = 0; i < m_limit; ++i) {
+        m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+        m_slots[i].m_expiresAt.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <class TClock>
+inline TSlidingWindowLimiter<TClock>::~TSlidingWindowLimiter() {
+    delete [] m_slots;
+}
+
+template <class TClock>
+inline bool TSlidingWindowLimiter<TClock>::tryAcquire() {
+    const uint64_t now = m_clock.now();
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &slot = m_slots[head % m_limit];
+        const uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+        if (sequence != head) {
+            if (sequence < head) {
+                // The previous owner has not stored its time yet, it is a recent event
+                return false;
+            }
+            head = m_head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.m_expiresAt.load(std::memory_order_relaxed) > now) {
+            return false;
+        }
+        if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed, std::memory_order_relaxed)) {
+            slot.m_expiresAt.store(now + m_window, std::memory_order_relaxed);
+            slot.m_sequence.store(head + m_limit, std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+template <class TClock>
+inline size_t TSlidingWindowLimiter<TClock>::getNumInWindow() const {
+    const uint64_t now = m_clock.now();
+    size_t count = 0;
+    for (size_t i = 0; i < m_limit; ++i) {
+        if (m_slots[i].m_expiresAt.load(std::memory_order_relaxed) > now) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+template <class TClock>
+inline const TClock &TSlidingWindowLimiter<TClock>::getClock() const {
+    return m_clock;
+}
+
+template <class TLimiter>
+inline TKeyedRateLimiter<TLimiter>::TKeyedRateLimiter(Factory factory, size_t numShards) :
+        m_factory(std::move(factory)),
+        m_shards(nullptr),
+        m_mask(0) {
+    size_t count = 1;
+    while (count < numShards) {
+        count <<= 1;
+    }
+    m_shards = new Shard[count];
+    m_mask = count - 1;
+}
+
+template <class TLimiter>
+inline TKeyedRateLimiter<TLimiter>::~TKeyedRateLimiter() {
+    delete [] m_shards;
+}
+
+template <class TLimiter>
+inline typename TKeyedRateLimiter<TLimiter>::Shard &TKeyedRateLimiter<TLimiter>::getShard(unsigned int key) const {
+    // Fibonacci hashing, the hash map uses the low bits of the key itself
+    const uint32_t hash = static_cast<uint32_t>(key) * 2654435761u;
+    return m_shards[(hash >> 16) & m_mask];
+}
+
+template <class TLimiter>
+inline TLimiter *TKeyedRateLimiter<TLimiter>::get(unsigned int key) {
+    Shard &shard = getShard(key);
+    TLimiter *limiter = nullptr;
+    {
+        std::shared_lock<ReaderWriterLock> lock(shard.m_lock);
+        if (shard.m_limiters.getValue(key, limiter)) {
+            return limiter;
+        }
+    }
+
+    std::lock_guard<ReaderWriterLock> lock(shard.m_lock);
+    if (!shard.m_limiters.getValue(key, limiter)) {
+        limiter = m_factory(key);
+        shard.m_owned.emplace_back(limiter);
+        shard.m_limiters.insert(key, limiter);
+    }
+
+    return limiter;
+}
+
+template <class TLimiter>
+inline bool TKeyedRateLimiter<TLimiter>::tryAcquire(unsigned int key) {
+    return get(key)->tryAcquire();
+}
+
+template <class TLimiter>
+inline size_t TKeyedRateLimiter<TLimiter>::size() const {
+    size_t count = 0;
+    for (size_t i = 0; i <= m_mask; ++i) {
+        std::shared_lock<ReaderWriterLock> lock(m_shards[i].m_lock);
+        count += m_shards[i].m_owned.size();
+    }
+
+    return count;
+}
+
+} // Namespace CPPCore
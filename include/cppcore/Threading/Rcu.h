@@ -0,0 +1,100 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Rcu
+///	@ingroup	CPPCore
+///
+///	@brief  Epoch-based read-copy-update. Readers announce the epoch they started in, in a slot
+/// which only they write, so entering a read-side section never writes shared counters. Writers
+/// publish a new version, retire the old one and free it after a grace period, i.e. when every
+/// reader which might still see it has left its read-side section.
+///
+/// On Linux the readers avoid the full memory fence, the writers use the membarrier syscall
+/// instead. Read-side sections may be nested, but must not block on a writer.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT Rcu {
+public:
+    /// @brief  The deleter of a retired object.
+    using Deleter = void (*)(void *object);
+
+    /// @brief  Enters a read-side section.
+    static void readLock();
+
+    /// @brief  Leaves a read-side section.
+    static void readUnlock();
+
+    /// @brief  Waits until all read-side sections which were active at the call have ended.
+    static void synchronize();
+
+    /// @brief  Hands an unpublished object over, it will be deleted after a grace period.
+    /// @param  object      [in] The object to delete.
+    /// @param  deleter     [in] The function to delete it.
+    static void retire(void *object, Deleter deleter);
+
+    /// @brief  Deletes all retired objects whose grace period is over, without waiting.
+    /// @return The number of deleted objects.
+    static size_t reclaim();
+
+    /// @brief  Waits for a grace period and deletes all objects retired before the call.
+    static void barrier();
+
+    /// @brief  Returns the number of retired objects which wait for their deletion.
+    /// @return The number of pending objects.
+    static size_t numPending();
+
+    /// @brief  Returns true, if the readers run without memory fences.
+    /// @return true, if membarrier is used.
+    static bool isUsingMembarrier();
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		RcuReadGuard
+///	@ingroup	CPPCore
+///
+///	@brief  Holds a read-side section for its lifetime.
+//-------------------------------------------------------------------------------------------------
+class RcuReadGuard {
+public:
+    /// @brief  Enters the read-side section.
+    RcuReadGuard() {
+        Rcu::readLock();
+    }
+
+    /// @brief  Leaves the read-side section.
+    ~RcuReadGuard() {
+        Rcu::readUnlock();
+    }
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(RcuReadGuard)
+};
+
+} // Namespace CPPCore
@@ -0,0 +1,159 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/Futex.h>
+#include <cppcore/Threading/SpinLock.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		ReaderWriterLock
+///	@ingroup	CPPCore
+///
+///	@brief  A reader-biased reader-writer lock on a single futex word. Readers get in whenever no
+/// writer holds the lock, even if writers are waiting, so a steady stream of readers can starve
+/// the writers. Use it for read-mostly data. Waiters spin briefly, then sleep on the futex.
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) ReaderWriterLock {
+public:
+    /// @brief  The default class constructor.
+    ReaderWriterLock() noexcept;
+
+    /// @brief  The class destructor.
+    ~ReaderWriterLock() = default;
+
+    /// @brief  Will acquire the lock exclusively.
+    void lock() noexcept;
+
+    /// @brief  Tries to acquire the lock exclusively without waiting.
+    /// @return true, if the lock was acquired.
+    bool try_lock() noexcept;
+
+    /// @brief  Will release the exclusive lock.
+    void unlock() noexcept;
+
+    /// @brief  Will acquire the lock shared.
+    void lock_shared() noexcept;
+
+    /// @brief  Tries to acquire the lock shared without waiting.
+    /// @return true, if the lock was acquired.
+    bool try_lock_shared() noexcept;
+
+    /// @brief  Will release the shared lock.
+    void unlock_shared() noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(ReaderWriterLock)
+
+private:
+    void wait(uint32_t state) noexcept;
+
+private:
+    static constexpr uint32_t Writer = 1u << 30;
+    static constexpr uint32_t Waiters = 1u << 31;
+    static constexpr uint32_t ReaderMask = Writer - 1;
+    static constexpr uint32_t SpinRounds = 100;
+
+    std::atomic<uint32_t> m_state;
+};
+
+inline ReaderWriterLock::ReaderWriterLock() noexcept :
+        m_state(0) {
+    // empty
+}
+
+inline void ReaderWriterLock::lock() noexcept {
+    uint32_t rounds = 0;
+    for (;;) {
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+        if (0 == (state & (Writer | ReaderMask))) {
+            if (m_state.compare_exchange_weak(state, state | Writer, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        if (++rounds < SpinRounds) {
+            cpuRelax();
+            continue;
+        }
+        wait(state);
+    }
+}
+
+inline bool ReaderWriterLock::try_lock() noexcept {
+    uint32_t state = m_state.load(std::memory_order_relaxed);
+    return 0 == (state & (Writer | ReaderMask)) &&
+           m_state.compare_exchange_strong(state, state | Writer, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+inline void ReaderWriterLock::unlock() noexcept {
+    if (0 != (m_state.fetch_and(~(Writer | Waiters), std::memory_order_release) & Waiters)) {
+        Futex::wakeAll(m_state);
+    }
+}
+
+inline void ReaderWriterLock::lock_shared() noexcept {
+    uint32_t rounds = 0;
+    for (;;) {
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+        if (0 == (state & Writer)) {
+            if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        if (++rounds < SpinRounds) {
+            cpuRelax();
+            continue;
+        }
+        wait(state);
+    }
+}
+
+inline bool ReaderWriterLock::try_lock_shared() noexcept {
+    uint32_t state = m_state.load(std::memory_order_relaxed);
+    return 0 == (state & Writer) &&
+           m_state.compare_exchange_strong(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+inline void ReaderWriterLock::unlock_shared() noexcept {
+    const uint32_t state = m_state.fetch_sub(1, std::memory_order_release);
+    if (1 == (state & ReaderMask) && 0 != (state & Waiters)) {
+        // The last reader is gone, let the waiting writers retry
+        if (0 != (m_state.fetch_and(~Waiters, std::memory_order_relaxed) & Waiters)) {
+            Futex::wakeAll(m_state);
+        }
+    }
+}
+
+inline void ReaderWriterLock::wait(uint32_t state) noexcept {
+    // Announce the waiter, the holder wakes everybody on release
+    if (0 == (state & Waiters) &&
+            !m_state.compare_exchange_strong(state, state | Waiters, std::memory_order_relaxed, std::memory_order_relaxed)) {
+        return;
+    }
+    Futex::wait(m_state, state | Waiters);
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/Futex.h>
+#include <cppcore/Threading/SpinLock.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Semaphore
+///	@ingroup	CPPCore
+///
+///	@brief  A counting semaphore on a futex word. release() only enters the kernel when a thread
+/// is sleeping in acquire().
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) Semaphore {
+public:
+    /// @brief  The class constructor.
+    /// @param  count   [in] The initial count.
+    explicit Semaphore(uint32_t count = 0) noexcept;
+
+    /// @brief  The class destructor.
+    ~Semaphore() = default;
+
+    /// @brief  Decrements the count, waits while it is zero.
+    void acquire() noexcept;
+
+    /// @brief  Decrements the count if it is not zero.
+    /// @return true, if the count was decremented.
+    bool tryAcquire() noexcept;
+
+    /// @brief  Increments the count and wakes waiting threads.
+    /// @param  count   [in] The number to add.
+    void release(uint32_t count = 1) noexcept;
+
+    /// @brief  Returns the current count.
+    /// @return The count.
+    uint32_t getCount() const noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(Semaphore)
+
+private:
+    std::atomic<uint32_t> m_count;
+    std::atomic<uint32_t> m_waiters;
+};
+
+inline Semaphore::Semaphore(uint32_t count) noexcept :
+        m_count(count),
+        m_waiters(0) {
+    // empty
+}
+
+inline void Semaphore::acquire() noexcept {
+    for (uint32_t spins = 0; spins < 100; ++spins) {
+        if (tryAcquire()) {
+            return;
+        }
+        cpuRelax();
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    while (!tryAcquire()) {
+        Futex::wait(m_count, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline bool Semaphore::tryAcquire() noexcept {
+    uint32_t count = m_count.load(std::memory_order_relaxed);
+    while (0 != count) {
+        if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline void Semaphore::release(uint32_t count) noexcept {
+    m_count.fetch_add(count, std::memory_order_seq_cst);
+    if (0 != m_waiters.load(std::memory_order_seq_cst)) {
+        if (1 == count) {
+            Futex::wakeOne(m_count);
+        } else {
+            Futex::wakeAll(m_count);
+        }
+    }
+}
+
+inline uint32_t Semaphore::getCount() const noexcept {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,153 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#endif
+
+namespace CPPCore {
+
+/// @brief  Tells the CPU that we are spinning, this saves power and frees resources for the
+///         sibling hyper-thread.
+inline void cpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@class		Backoff
+///	@ingroup	CPPCore
+///
+///	@brief  Exponential backoff for spin loops. Every call doubles the number of pause instructions
+/// up to MaxSpins, after that the thread yields, so oversubscribed spinners let the lock holder run.
+//-------------------------------------------------------------------------------------------------
+class Backoff {
+public:
+    /// @brief  The maximal number of pause instructions per call before yielding.
+    static constexpr uint32_t MaxSpins = 64;
+
+    /// @brief  The default class constructor.
+    Backoff() noexcept;
+
+    /// @brief  Waits for the next backoff step.
+    void pause() noexcept;
+
+    /// @brief  Starts again with the shortest step.
+    void reset() noexcept;
+
+private:
+    uint32_t m_spins;
+};
+
+inline Backoff::Backoff() noexcept :
+        m_spins(1) {
+    // empty
+}
+
+inline void Backoff::pause() noexcept {
+    if (m_spins > MaxSpins) {
+        std::this_thread::yield();
+        return;
+    }
+    for (uint32_t i = 0; i < m_spins; ++i) {
+        cpuRelax();
+    }
+    m_spins <<= 1;
+}
+
+inline void Backoff::reset() noexcept {
+    m_spins = 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@class		SpinLock
+///	@ingroup	CPPCore
+///
+///	@brief  This class implements a test-and-test-and-set spinlock. Waiting threads spin on a
+/// plain load with exponential backoff, so the cache line is only written when the lock looks free.
+/// Use it for very short critical sections only. The lock occupies a whole cache line to avoid
+/// false sharing.
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) SpinLock {
+public:
+    /// @brief  The default class constructor.
+    SpinLock() noexcept;
+
+    /// @brief  The class destructor.
+    ~SpinLock() = default;
+
+    /// @brief  Will acquire the lock, spins until it is available.
+    void lock() noexcept;
+
+    /// @brief  Tries to acquire the lock without waiting.
+    /// @return true, if the lock was acquired.
+    bool try_lock() noexcept;
+
+    /// @brief  Will release the lock.
+    void unlock() noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(SpinLock)
+
+private:
+    std::atomic<bool> m_locked;
+};
+
+inline SpinLock::SpinLock() noexcept :
+        m_locked(false) {
+    // empty
+}
+
+inline void SpinLock::lock() noexcept {
+    Backoff backoff;
+    for (;;) {
+        if (!m_locked.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        while (m_locked.load(std::memory_order_relaxed)) {
+            backoff.pause();
+        }
+    }
+}
+
+inline bool SpinLock::try_lock() noexcept {
+    return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+}
+
+inline void SpinLock::unlock() noexcept {
+    m_locked.store(false, std::memory_order_release);
+}
+
+} // Namespace CPPCore
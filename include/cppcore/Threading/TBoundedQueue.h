@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TBoundedQueue
+///	@ingroup	CPPCore
+///
+///	@brief  A bounded lock-free multi-producer multi-consumer queue (Dmitry Vyukov's design).
+/// Every cell carries a sequence number which tells producers and consumers whose turn it is, so
+/// push and pop each need one CAS on their index and never touch the other side's index.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TBoundedQueue {
+public:
+    /// @brief  The class constructor.
+    /// @param  capacity    [in] The capacity, will be rounded up to a power of two.
+    explicit TBoundedQueue(size_t capacity = 1024);
+
+    /// @brief  The class destructor.
+    ~TBoundedQueue();
+
+    /// @brief  Appends an item, can be called from any thread.
+    /// @param  item    [in] The item.
+    /// @return false, if the queue is full.
+    bool tryPush(T item);
+
+    /// @brief  Takes the oldest item, can be called from any thread.
+    /// @param  item    [out] The item.
+    /// @return false, if the queue is empty.
+    bool tryPop(T &item);
+
+    /// @brief  Returns the number of items. The result is only a snapshot.
+    /// @return The number of items.
+    size_t size() const;
+
+    /// @brief  Returns true, if the queue looks empty. The result is only a snapshot.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    /// @brief  Returns the capacity.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TBoundedQueue)
+
+private:
+    struct Cell {
+        std::atomic<size_t> m_sequence;
+        T m_item;
+    };
+
+    Cell *m_cells;
+    size_t m_mask;
+    alignas(CacheLineSize) std::atomic<size_t> m_pushPos;
+    alignas(CacheLineSize) std::atomic<size_t> m_popPos;
+};
+
+template <class T>
+inline TBoundedQueue<T>::TBoundedQueue(size_t capacity) :
+        m_cells(nullptr),
+        m_mask(0),
+        m_pushPos(0),
+        m_popPos(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_cells = new Cell[size];
+    for (size_t i = 0; i < size; ++i) {
+        m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+}
+
+template <class T>
+inline TBoundedQueue<T>::~TBoundedQueue() {
+    delete [] m_cells;
+}
+
+template <class T>
+inline bool TBoundedQueue<T>::tryPush(T item) {
+    size_t pos = m_pushPos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell &cell = m_cells[pos & m_mask];
+        const size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (0 == diff) {
+            if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.m_item = std::move(item);
+                cell.m_sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (0 > diff) {
+            // The cell still holds the item of the previous round
+            return false;
+        } else {
+            pos = m_pushPos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <class T>
+inline bool TBoundedQueue<T>::tryPop(T &item) {
+    size_t pos = m_popPos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell &cell = m_cells[pos & m_mask];
+        const size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (0 == diff) {
+            if (m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                item = std::move(cell.m_item);
+                cell.m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (0 > diff) {
+            return false;
+        } else {
+            pos = m_popPos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <class T>
+inline size_t TBoundedQueue<T>::size() const {
+    const size_t popPos = m_popPos.load(std::memory_order_relaxed);
+    const size_t pushPos = m_pushPos.load(std::memory_order_relaxed);
+
+    return pushPos > popPos ? pushPos - popPos : 0;
+}
+
+template <class T>
+inline bool TBoundedQueue<T>::isEmpty() const {
+    return 0 == size();
+}
+
+template <class T>
+inline size_t TBoundedQueue<T>::capacity() const {
+    return m_mask + 1;
+}
+
+} // Namespace CPPCore
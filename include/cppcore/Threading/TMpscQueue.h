@@ -0,0 +1,143 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		MpscNode
+///	@ingroup	CPPCore
+///
+///	@brief  The link of an item in a TMpscQueue, derive the item type from it.
+//-------------------------------------------------------------------------------------------------
+struct MpscNode {
+    std::atomic<MpscNode*> m_next{ nullptr };
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TMpscQueue
+///	@ingroup	CPPCore
+///
+///	@brief  An unbounded intrusive multi-producer single-consumer queue (Vyukov). push() is
+/// wait-free, a single exchange on the tail, pop() is lock-free for the one consumer. The queue
+/// does not own the items. While a producer is between its exchange and its link, pop() may
+/// return nullptr for a moment although the queue is not empty.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TMpscQueue {
+public:
+    /// @brief  The class constructor.
+    TMpscQueue();
+
+    /// @brief  The class destructor.
+    ~TMpscQueue() = default;
+
+    /// @brief  Pushes an item, can be called from any thread.
+    /// @param  item    [in] The item, derived from MpscNode.
+    void push(T *item);
+
+    /// @brief  Pops the oldest item, consumer thread only.
+    /// @return The item or nullptr.
+    T *pop();
+
+    /// @brief  Returns true, if the queue looks empty, consumer thread only.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TMpscQueue)
+
+private:
+    void pushNode(MpscNode *node);
+
+private:
+    alignas(CacheLineSize) std::atomic<MpscNode*> m_tail;
+    alignas(CacheLineSize) MpscNode *m_head;
+    MpscNode m_stub;
+};
+
+template <class T>
+inline TMpscQueue<T>::TMpscQueue() :
+        m_tail(&m_stub),
+        m_head(&m_stub),
+        m_stub() {
+    // empty
+}
+
+template <class T>
+inline void TMpscQueue<T>::push(T *item) {
+    pushNode(item);
+}
+
+template <class T>
+inline void TMpscQueue<T>::pushNode(MpscNode *node) {
+    node->m_next.store(nullptr, std::memory_order_relaxed);
+    MpscNode *prev = m_tail.exchange(node, std::memory_order_acq_rel);
+    prev->m_next.store(node, std::memory_order_release);
+}
+
+template <class T>
+inline T *TMpscQueue<T>::pop() {
+    MpscNode *head = m_head;
+    MpscNode *next = head->m_next.load(std::memory_order_acquire);
+    if (&m_stub == head) {
+        if (nullptr == next) {
+            return nullptr;
+        }
+        // Skip the stub
+        m_head = next;
+        head = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+
+    if (nullptr != next) {
+        m_head = next;
+        return static_cast<T*>(head);
+    }
+
+    if (head != m_tail.load(std::memory_order_acquire)) {
+        // A producer has not linked its item yet
+        return nullptr;
+    }
+
+    // The last item, put the stub behind it so it can be taken
+    pushNode(&m_stub);
+    next = head->m_next.load(std::memory_order_acquire);
+    if (nullptr != next) {
+        m_head = next;
+        return static_cast<T*>(head);
+    }
+
+    return nullptr;
+}
+
+template <class T>
+inline bool TMpscQueue<T>::isEmpty() const {
+    return &m_stub == m_head && &m_stub == m_tail.load(std::memory_order_acquire);
+}
+
+} // Namespace CPPCore
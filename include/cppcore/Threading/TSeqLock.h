@@ -0,0 +1,143 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/SpinLock.h>
+
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TSeqLock
+///	@ingroup	CPPCore
+///
+///	@brief  A sequence lock for small trivially copyable values. The writer makes the sequence
+/// number odd while it writes, readers copy the value and retry when the sequence changed in
+/// between. Readers never write, so they do not contend with each other. The value is stored in
+/// relaxed atomic words, so the torn reads which get discarded are no data races.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TSeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "TSeqLock requires a trivially copyable type.");
+
+public:
+    /// @brief  The class constructor.
+    /// @param  value   [in] The initial value.
+    explicit TSeqLock(const T &value = T());
+
+    /// @brief  The class destructor.
+    ~TSeqLock() = default;
+
+    /// @brief  Stores a new value, concurrent writers are serialized.
+    /// @param  value   [in] The new value.
+    void store(const T &value);
+
+    /// @brief  Reads a consistent copy of the value, retries while a write is in progress.
+    /// @return The value.
+    T load() const;
+
+    /// @brief  Tries to read the value once.
+    /// @param  value   [out] Receives the value on success.
+    /// @return false, if a write was in progress.
+    bool tryLoad(T &value) const;
+
+    /// @brief  Returns the sequence number, it is incremented by two per write.
+    /// @return The sequence number.
+    uint64_t getSequence() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TSeqLock)
+
+private:
+    static constexpr size_t NumWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(CacheLineSize) std::atomic<uint64_t> m_sequence;
+    std::atomic<uint64_t> m_words[NumWords];
+    SpinLock m_writeLock;
+};
+
+template <class T>
+inline TSeqLock<T>::TSeqLock(const T &value) :
+        m_sequence(0),
+        m_writeLock() {
+    for (size_t i = 0; i < NumWords; ++i) {
+        m_words[i].store(0, std::memory_order_relaxed);
+    }
+    store(value);
+}
+
+template <class T>
+inline void TSeqLock<T>::store(const T &value) {
+    uint64_t words[NumWords] = {};
+    ::memcpy(words, &value, sizeof(T));
+
+    std::lock_guard<SpinLock> lock(m_writeLock);
+    const uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < NumWords; ++i) {
+        m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <class T>
+inline T TSeqLock<T>::load() const {
+    T value;
+    Backoff backoff;
+    while (!tryLoad(value)) {
+        backoff.pause();
+    }
+
+    return value;
+}
+
+template <class T>
+inline bool TSeqLock<T>::tryLoad(T &value) const {
+    const uint64_t before = m_sequence.load(std::memory_order_acquire);
+    if (0 != (before & 1)) {
+        return false;
+    }
+
+    uint64_t words[NumWords];
+    for (size_t i = 0; i < NumWords; ++i) {
+        words[i] = m_words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (before != m_sequence.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    ::memcpy(&value, words, sizeof(T));
+
+    return true;
+}
+
+template <class T>
+inline uint64_t TSeqLock<T>::getSequence() const {
+    return m_sequence.load(std::memory_order_acquire);
+}
+
+} // Namespace CPPCore
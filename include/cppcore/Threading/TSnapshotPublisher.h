@@ -0,0 +1,196 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/Rcu.h>
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TSnapshotPublisher
+///	@ingroup	CPPCore
+///
+///	@brief  Publishes immutable versions of read-mostly data, e.g. configuration or routing
+/// tables. Readers get a snapshot without locking and without writing shared memory, writers
+/// build a new version and swap it in atomically. Old versions are deleted via Rcu after all
+/// readers which might still use them have released their snapshots.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TSnapshotPublisher {
+public:
+    //---------------------------------------------------------------------------------------------
+    /// @brief  A read-side view of the current version. The version stays valid as long as the
+    ///         snapshot lives, keep it short, because it delays the reclamation.
+    //---------------------------------------------------------------------------------------------
+    class Snapshot {
+    public:
+        /// @brief  Takes over the snapshot of another instance.
+        Snapshot(Snapshot &&other) noexcept;
+
+        /// @brief  Releases the snapshot.
+        ~Snapshot();
+
+        /// @brief  Returns the version, nullptr if nothing was published.
+        const T *get() const;
+
+        /// @brief  Accesses the version.
+        const T *operator->() const;
+
+        /// @brief  Accesses the version.
+        const T &operator*() const;
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        Snapshot &operator=(Snapshot &&) = delete;
+
+    private:
+        friend class TSnapshotPublisher<T>;
+        explicit Snapshot(const T *value);
+
+        const T *m_value;
+        bool m_active;
+    };
+
+    /// @brief  The class constructor.
+    /// @param  initial     [in] The initial version, the publisher takes the ownership.
+    explicit TSnapshotPublisher(T *initial = nullptr);
+
+    /// @brief  The class destructor, waits until no reader uses the versions anymore.
+    ~TSnapshotPublisher();
+
+    /// @brief  Returns a snapshot of the current version.
+    /// @return The snapshot.
+    Snapshot read() const;
+
+    /// @brief  Publishes a new version, the old one will be deleted after a grace period.
+    /// @param  version     [in] The new version, the publisher takes the ownership.
+    void publish(T *version);
+
+    /// @brief  Publishes a copy of the value.
+    /// @param  value       [in] The new value.
+    void publish(const T &value);
+
+    /// @brief  Copies the current version, lets func modify the copy and publishes it. Concurrent
+    ///         updates are serialized.
+    /// @param  func        [in] Called with a reference to the copy.
+    template <class Func>
+    void update(Func func);
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TSnapshotPublisher)
+
+private:
+    static void deleteVersion(void *version);
+
+private:
+    std::atomic<T*> m_current;
+    std::mutex m_writeMutex;
+};
+
+template <class T>
+inline TSnapshotPublisher<T>::Snapshot::Snapshot(const T *value) :
+        m_value(value),
+        m_active(true) {
+    // empty
+}
+
+template <class T>
+inline TSnapshotPublisher<T>::Snapshot::Snapshot(Snapshot &&other) noexcept :
+        m_value(other.m_value),
+        m_active(other.m_active) {
+    other.m_active = false;
+}
+
+template <class T>
+inline TSnapshotPublisher<T>::Snapshot::~Snapshot() {
+    if (m_active) {
+        Rcu::readUnlock();
+    }
+}
+
+template <class T>
+inline const T *TSnapshotPublisher<T>::Snapshot::get() const {
+    return m_value;
+}
+
+template <class T>
+inline const T *TSnapshotPublisher<T>::Snapshot::operator->() const {
+    return m_value;
+}
+
+template <class T>
+inline const T &TSnapshotPublisher<T>::Snapshot::operator*() const {
+    return *m_value;
+}
+
+template <class T>
+inline TSnapshotPublisher<T>::TSnapshotPublisher(T *initial) :
+        m_current(initial),
+        m_writeMutex() {
+    // empty
+}
+
+template <class T>
+inline TSnapshotPublisher<T>::~TSnapshotPublisher() {
+    Rcu::synchronize();
+    delete m_current.load(std::memory_order_relaxed);
+    Rcu::reclaim();
+}
+
+template <class T>
+inline typename TSnapshotPublisher<T>::Snapshot TSnapshotPublisher<T>::read() const {
+    Rcu::readLock();
+    return Snapshot(m_current.load(std::memory_order_acquire));
+}
+
+template <class T>
+inline void TSnapshotPublisher<T>::publish(T *version) {
+    T *old = m_current.exchange(version, std::memory_order_acq_rel);
+    Rcu::retire(old, &TSnapshotPublisher<T>::deleteVersion);
+}
+
+template <class T>
+inline void TSnapshotPublisher<T>::publish(const T &value) {
+    publish(new T(value));
+}
+
+template <class T>
+template <class Func>
+inline void TSnapshotPublisher<T>::update(Func func) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    const T *current = m_current.load(std::memory_order_acquire);
+    T *version = nullptr == current ? new T() : new T(*current);
+    func(*version);
+    publish(version);
+}
+
+template <class T>
+inline void TSnapshotPublisher<T>::deleteVersion(void *version) {
+    delete static_cast<T*>(version);
+}
+
+} // Namespace CPPCore
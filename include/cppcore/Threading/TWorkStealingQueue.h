@@ -0,0 +1,167 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TWorkStealingQueue
+///	@ingroup	CPPCore
+///
+///	@brief  A bounded Chase-Lev work-stealing deque. The owning thread pushes and pops at the
+/// bottom in LIFO order, any other thread may steal from the top in FIFO order. T must be a
+/// pointer type, nullptr is returned when no item could be taken.
+//-------------------------------------------------------------------------------------------------
+template <class T>
+class TWorkStealingQueue {
+public:
+    /// @brief  The class constructor.
+    /// @param  capacity    [in] The capacity, will be rounded up to a power of two.
+    explicit TWorkStealingQueue(size_t capacity = 4096);
+
+    /// @brief  The class destructor.
+    ~TWorkStealingQueue();
+
+    /// @brief  Pushes an item, owner thread only.
+    /// @param  item    [in] The item to push.
+    /// @return false, if the queue is full.
+    bool push(T item);
+
+    /// @brief  Pops the most recently pushed item, owner thread only.
+    /// @return The item or nullptr if the queue is empty.
+    T pop();
+
+    /// @brief  Steals the oldest item, can be called from any thread.
+    /// @return The item or nullptr if the queue is empty or the race was lost.
+    T steal();
+
+    /// @brief  Returns true, if the queue looks empty. The result is only a snapshot.
+    /// @return true, if empty.
+    bool isEmpty() const;
+
+    /// @brief  Returns the capacity.
+    /// @return The capacity.
+    size_t capacity() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TWorkStealingQueue)
+
+private:
+    alignas(CacheLineSize) std::atomic<int64_t> m_top;
+    alignas(CacheLineSize) std::atomic<int64_t> m_bottom;
+    alignas(CacheLineSize) std::atomic<T> *m_buffer;
+    size_t m_mask;
+};
+
+template <class T>
+inline TWorkStealingQueue<T>::TWorkStealingQueue(size_t capacity) :
+        m_top(0),
+        m_bottom(0),
+        m_buffer(nullptr),
+        m_mask(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_buffer = new std::atomic<T>[size];
+    for (size_t i = 0; i < size; ++i) {
+        m_buffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+}
+
+template <class T>
+inline TWorkStealingQueue<T>::~TWorkStealingQueue() {
+    delete [] m_buffer;
+}
+
+template <class T>
+inline bool TWorkStealingQueue<T>::push(T item) {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<int64_t>(m_mask)) {
+        return false;
+    }
+
+    m_buffer[bottom & m_mask].store(item, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <class T>
+inline T TWorkStealingQueue<T>::pop() {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    T item = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // The last item, race against the thieves
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            item = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return item;
+}
+
+template <class T>
+inline T TWorkStealingQueue<T>::steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    T item = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    return item;
+}
+
+template <class T>
+inline bool TWorkStealingQueue<T>::isEmpty() const {
+    return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+}
+
+template <class T>
+inline size_t TWorkStealingQueue<T>::capacity() const {
+    return m_mask + 1;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,142 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/CPPCoreCommon.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CPPCore {
+
+class TaskGroup;
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TaskScheduler
+///	@ingroup	CPPCore
+///
+///	@brief  A work-stealing task scheduler. Every worker thread owns a Chase-Lev deque, it runs
+/// its own tasks in LIFO order and steals from the other workers when it runs dry. Tasks from
+/// foreign threads are put into a shared injection queue. Threads which wait for a TaskGroup
+/// execute pending tasks meanwhile, so the calling thread counts as one of the threads.
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT TaskScheduler {
+public:
+    /// @brief  The class constructor.
+    /// @param  numThreads  [in] The number of threads including the waiting caller, 0 for the
+    ///                     number of hardware threads. A value of 1 runs everything inline.
+    explicit TaskScheduler(size_t numThreads = 0);
+
+    /// @brief  The class destructor, will join all workers.
+    ~TaskScheduler();
+
+    /// @brief  Returns the number of threads including the waiting caller.
+    /// @return The number of threads.
+    size_t getNumThreads() const;
+
+    /// @brief  Returns the process-wide scheduler, created on first use.
+    /// @return The default scheduler.
+    static TaskScheduler &getDefault();
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TaskScheduler)
+
+private:
+    friend class TaskGroup;
+    struct Task;
+    struct Worker;
+
+    void submit(Task *task);
+    bool runOne();
+    Task *findTask(Worker *self);
+    void execute(Task *task);
+    void workerMain(size_t index);
+
+private:
+    std::vector<Worker*> m_workers;
+    std::mutex m_injectMutex;
+    std::deque<Task*> m_injectQueue;
+    std::atomic<size_t> m_numQueued;
+    std::atomic<size_t> m_numSleeping;
+    std::atomic<bool> m_shutdown;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TaskGroup
+///	@ingroup	CPPCore
+///
+///	@brief  A group of tasks which can be waited for. The first exception thrown by a task is
+/// rethrown by wait().
+//-------------------------------------------------------------------------------------------------
+class DLL_CPPCORE_EXPORT TaskGroup {
+public:
+    /// @brief  The class constructor.
+    /// @param  scheduler   [in] The scheduler to run the tasks on.
+    explicit TaskGroup(TaskScheduler &scheduler = TaskScheduler::getDefault());
+
+    /// @brief  The class destructor, will wait for all pending tasks.
+    ~TaskGroup();
+
+    /// @brief  Spawns a new task.
+    /// @param  func    [in] The function to run.
+    void run(std::function<void()> func);
+
+    /// @brief  Waits until all tasks are done, helps executing tasks meanwhile.
+    void wait();
+
+    /// @brief  Returns the scheduler of the group.
+    /// @return The scheduler.
+    TaskScheduler &getScheduler() const;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TaskGroup)
+
+private:
+    friend class TaskScheduler;
+
+    void helpUntilDone();
+
+private:
+    TaskScheduler &m_scheduler;
+    std::atomic<size_t> m_pending;
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+};
+
+inline size_t TaskScheduler::getNumThreads() const {
+    return m_workers.size() + 1;
+}
+
+inline TaskScheduler &TaskGroup::getScheduler() const {
+    return m_scheduler;
+}
+
+} // Namespace CPPCore
@@ -0,0 +1,100 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Threading/SpinLock.h>
+
+namespace CPPCore {
+
+//-------------------------------------------------------------------------------------------------
+///	@class		TicketLock
+///	@ingroup	CPPCore
+///
+///	@brief  A fair FIFO spinlock. Every thread draws a ticket and waits until it is served. The
+/// waiting time is proportional to the number of threads ahead. Both counters live on their own
+/// cache line, so drawing a ticket does not disturb the threads polling the served counter.
+//-------------------------------------------------------------------------------------------------
+class alignas(CacheLineSize) TicketLock {
+public:
+    /// @brief  The default class constructor.
+    TicketLock() noexcept;
+
+    /// @brief  The class destructor.
+    ~TicketLock() = default;
+
+    /// @brief  Will acquire the lock, waits until the own ticket is served.
+    void lock() noexcept;
+
+    /// @brief  Tries to acquire the lock without waiting.
+    /// @return true, if the lock was acquired.
+    bool try_lock() noexcept;
+
+    /// @brief  Will release the lock.
+    void unlock() noexcept;
+
+    // Copying is not allowed
+    CPPCORE_NONE_COPYING(TicketLock)
+
+private:
+    alignas(CacheLineSize) std::atomic<uint32_t> m_next;
+    alignas(CacheLineSize) std::atomic<uint32_t> m_serving;
+};
+
+inline TicketLock::TicketLock() noexcept :
+        m_next(0),
+        m_serving(0) {
+    // empty
+}
+
+inline void TicketLock::lock() noexcept {
+    const uint32_t ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+    size_t rounds = 0;
+    for (;;) {
+        const uint32_t serving = m_serving.load(std::memory_order_acquire);
+        if (serving == ticket) {
+            return;
+        }
+
+        // Proportional backoff, yield when it takes too long, the thread to serve may not run
+        if (++rounds > 8) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < (ticket - serving) * 16; ++i) {
+            cpuRelax();
+        }
+    }
+}
+
+inline bool TicketLock::try_lock() noexcept {
+    // Acquire pairs with the release in unlock(), as in lock()
+    const uint32_t serving = m_serving.load(std::memory_order_acquire);
+    uint32_t expected = serving;
+    return m_next.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+inline void TicketLock::unlock() noexcept {
+    m_serving.store(m_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+} // Namespace CPPCore
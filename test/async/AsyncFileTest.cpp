@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/AsyncFile.h>
+#include <cppcore/Async/TTask.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace CPPCore;
+
+class AsyncFileTest : public testing::Test {
+protected:
+    void SetUp() override {
+        m_path = testing::TempDir() + "cppcore_asyncfile_test.bin";
+    }
+
+    void TearDown() override {
+        std::remove(m_path.c_str());
+    }
+
+    std::string m_path;
+};
+
+TEST_F(AsyncFileTest, openTest) {
+    ThreadPool pool(1);
+    AsyncFile file(pool);
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_FALSE(file.open((m_path + ".missing").c_str(), AsyncFile::Mode::Read));
+    EXPECT_TRUE(file.open(m_path.c_str(), AsyncFile::Mode::Write));
+    EXPECT_TRUE(file.isOpen());
+    file.close();
+    EXPECT_FALSE(file.isOpen());
+}
+
+TEST_F(AsyncFileTest, readWriteTest) {
+    ThreadPool pool(2);
+    AsyncFile file(pool);
+    ASSERT_TRUE(file.open(m_path.c_str(), AsyncFile::Mode::ReadWrite));
+
+    auto body = [](AsyncFile &file, ThreadPool &pool) -> TTask<bool> {
+        std::vector<char> data(100000);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(i * 7);
+        }
+        const int64_t written = co_await file.write(0, data.data(), data.size());
+        if (static_cast<int64_t>(data.size()) != written || !pool.isInPool()) {
+            co_return false;
+        }
+
+        std::vector<char> buffer(data.size());
+        const int64_t numRead = co_await file.read(0, buffer.data(), buffer.size());
+        if (static_cast<int64_t>(data.size()) != numRead || buffer != data) {
+            co_return false;
+        }
+
+        // Reads beyond the end are short
+        char tail[16];
+        const int64_t tailRead = co_await file.read(data.size() - 4, tail, sizeof(tail));
+        co_return 4 == tailRead;
+    };
+    EXPECT_TRUE(syncWait(body(file, pool)));
+}
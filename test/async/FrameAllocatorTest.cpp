@@ -0,0 +1,68 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/FrameAllocator.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+
+using namespace CPPCore;
+
+class FrameAllocatorTest : public testing::Test {};
+
+TEST_F(FrameAllocatorTest, recycleTest) {
+    void *first = FrameAllocator::allocate(100);
+    ASSERT_NE(nullptr, first);
+    ::memset(first, 0xab, 100);
+    FrameAllocator::deallocate(first, 100);
+
+    // The same size class hands out the cached frame again
+    FrameAllocator::resetThreadStats();
+    void *second = FrameAllocator::allocate(110);
+    EXPECT_EQ(first, second);
+    FrameAllocator::deallocate(second, 110);
+
+    const FrameAllocator::Stats stats = FrameAllocator::getThreadStats();
+    EXPECT_EQ(1u, stats.m_numAllocations);
+    EXPECT_EQ(0u, stats.m_numHeapAllocations);
+}
+
+TEST_F(FrameAllocatorTest, largeFrameTest) {
+    FrameAllocator::resetThreadStats();
+    void *frame = FrameAllocator::allocate(FrameAllocator::MaxPooledSize + 1);
+    ASSERT_NE(nullptr, frame);
+    FrameAllocator::deallocate(frame, FrameAllocator::MaxPooledSize + 1);
+    EXPECT_EQ(1u, FrameAllocator::getThreadStats().m_numHeapAllocations);
+}
+
+TEST_F(FrameAllocatorTest, crossThreadTest) {
+    // A frame may be released on another thread than it was allocated on
+    void *frame = FrameAllocator::allocate(256);
+    std::thread other([frame]() {
+        FrameAllocator::deallocate(frame, 256);
+        void *again = FrameAllocator::allocate(256);
+        FrameAllocator::deallocate(again, 256);
+    });
+    other.join();
+}
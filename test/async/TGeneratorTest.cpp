@@ -0,0 +1,114 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TGenerator.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace CPPCore;
+
+class TGeneratorTest : public testing::Test {
+protected:
+    static TGenerator<int> range(int first, int last) {
+        for (int i = first; i < last; ++i) {
+            co_yield i;
+        }
+    }
+
+    static TGenerator<int> fibonacci() {
+        int a = 0, b = 1;
+        for (;;) {
+            co_yield a;
+            const int next = a + b;
+            a = b;
+            b = next;
+        }
+    }
+
+    static TGenerator<int&> elements(std::vector<int> &values) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            co_yield values[i];
+        }
+    }
+
+    static TGenerator<int> failing() {
+        co_yield 1;
+        throw std::runtime_error("failed");
+    }
+};
+
+TEST_F(TGeneratorTest, iterateTest) {
+    int expected = 3;
+    for (int value : range(3, 10)) {
+        EXPECT_EQ(expected, value);
+        ++expected;
+    }
+    EXPECT_EQ(10, expected);
+
+    size_t count = 0;
+    for (int value : range(5, 5)) {
+        (void) value;
+        ++count;
+    }
+    EXPECT_EQ(0u, count);
+}
+
+TEST_F(TGeneratorTest, infiniteTest) {
+    std::vector<int> values;
+    for (int value : fibonacci()) {
+        if (value > 50) {
+            break;
+        }
+        values.push_back(value);
+    }
+    const std::vector<int> expected = { 0, 1, 1, 2, 3, 5, 8, 13, 21, 34 };
+    EXPECT_EQ(expected, values);
+}
+
+TEST_F(TGeneratorTest, referenceTest) {
+    std::vector<int> values = { 1, 2, 3 };
+    for (int &value : elements(values)) {
+        value *= 10;
+    }
+    EXPECT_EQ(10, values[0]);
+    EXPECT_EQ(30, values[2]);
+}
+
+TEST_F(TGeneratorTest, exceptionTest) {
+    TGenerator<int> generator = failing();
+    TGenerator<int>::Iterator it = generator.begin();
+    EXPECT_EQ(1, *it);
+    EXPECT_THROW(++it, std::runtime_error);
+}
+
+TEST_F(TGeneratorTest, moveTest) {
+    TGenerator<int> generator = range(0, 3);
+    TGenerator<int> other(std::move(generator));
+    int sum = 0;
+    for (int value : other) {
+        sum += value;
+    }
+    EXPECT_EQ(3, sum);
+}
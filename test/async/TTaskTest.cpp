@@ -0,0 +1,161 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TTask.h>
+#include <cppcore/Async/ThreadPool.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace CPPCore;
+
+class TTaskTest : public testing::Test {
+protected:
+    static TTask<int> square(int value) {
+        co_return value * value;
+    }
+
+    static TTask<int> sumOfSquares(int a, int b) {
+        const int x = co_await square(a);
+        const int y = co_await square(b);
+        co_return x + y;
+    }
+
+    static TTask<void> fail() {
+        throw std::runtime_error("failed");
+        co_return;
+    }
+
+    static TTask<int> countDown(int depth) {
+        if (0 == depth) {
+            co_return 0;
+        }
+        co_return 1 + co_await countDown(depth - 1);
+    }
+
+    static TTask<int> identity(int value) {
+        co_return value;
+    }
+};
+
+TEST_F(TTaskTest, valueTest) {
+    EXPECT_EQ(25, syncWait(sumOfSquares(3, 4)));
+
+    TTask<std::string> task = []() -> TTask<std::string> {
+        co_return std::string("hello");
+    }();
+    EXPECT_EQ("hello", syncWait(std::move(task)));
+}
+
+TEST_F(TTaskTest, lazyTest) {
+    bool hasRun = false;
+    auto body = [](bool &flag) -> TTask<void> {
+        flag = true;
+        co_return;
+    };
+    TTask<void> task = body(hasRun);
+    EXPECT_TRUE(task.isValid());
+    EXPECT_FALSE(task.isReady());
+    EXPECT_FALSE(hasRun);
+
+    syncWait(std::move(task));
+    EXPECT_TRUE(hasRun);
+}
+
+TEST_F(TTaskTest, exceptionTest) {
+    EXPECT_THROW(syncWait(fail()), std::runtime_error);
+
+    auto caller = []() -> TTask<bool> {
+        try {
+            co_await fail();
+        } catch (const std::runtime_error &) {
+            co_return true;
+        }
+        co_return false;
+    };
+    EXPECT_TRUE(syncWait(caller()));
+}
+
+TEST_F(TTaskTest, emptyTaskTest) {
+    EXPECT_THROW(syncWait(TTask<int>()), std::logic_error);
+
+    auto caller = []() -> TTask<bool> {
+        TTask<int> task = square(2);
+        TTask<int> other = std::move(task);
+        bool thrown = false;
+        try {
+            co_await task;
+        } catch (const std::logic_error &) {
+            thrown = true;
+        }
+        co_return thrown && 4 == co_await std::move(other);
+    };
+    EXPECT_TRUE(syncWait(caller()));
+}
+
+TEST_F(TTaskTest, moveTest) {
+    TTask<int> task = square(5);
+    TTask<int> other(std::move(task));
+    EXPECT_FALSE(task.isValid());
+    task = std::move(other);
+    EXPECT_EQ(25, syncWait(std::move(task)));
+}
+
+TEST_F(TTaskTest, symmetricTransferTest) {
+    // A loop of synchronously completing tasks must not grow the stack
+    auto loop = []() -> TTask<int> {
+        int sum = 0;
+        for (int i = 0; i < 1000000; ++i) {
+            sum += co_await identity(1);
+        }
+        co_return sum;
+    };
+    EXPECT_EQ(1000000, syncWait(loop()));
+    EXPECT_EQ(1000, syncWait(countDown(1000)));
+}
+
+TEST_F(TTaskTest, threadPoolTest) {
+    ThreadPool pool(2);
+    const std::thread::id caller = std::this_thread::get_id();
+    auto body = [](ThreadPool &pool, std::thread::id caller) -> TTask<bool> {
+        co_await pool.schedule();
+        const bool onWorker = pool.isInPool() && caller != std::this_thread::get_id();
+        const int value = co_await square(3);
+        co_return onWorker && 9 == value;
+    };
+    EXPECT_TRUE(syncWait(body(pool, caller)));
+}
+
+TEST_F(TTaskTest, frameAllocatorTest) {
+    // Warm up the free list, then all frames must be recycled
+    syncWait(sumOfSquares(1, 2));
+    FrameAllocator::resetThreadStats();
+    for (int i = 0; i < 100; ++i) {
+        syncWait(sumOfSquares(i, i));
+    }
+    const FrameAllocator::Stats stats = FrameAllocator::getThreadStats();
+    EXPECT_EQ(400u, stats.m_numAllocations);
+    EXPECT_EQ(0u, stats.m_numHeapAllocations);
+}
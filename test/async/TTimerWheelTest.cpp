@@ -0,0 +1,238 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/TTimerWheel.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TTimerWheelTest : public testing::Test {
+protected:
+    using Wheel = TTimerWheel<uint64_t>;
+
+    // Advances tick by tick and checks every timer fires exactly at its tick
+    static void expectExact(Wheel &wheel, uint64_t last, std::multimap<uint64_t, uint64_t> &expected) {
+        for (uint64_t tick = wheel.getCurrentTick() + 1; tick <= last; ++tick) {
+            wheel.advance(tick, [&](uint64_t id) {
+                auto it = expected.find(tick);
+                ASSERT_NE(expected.end(), it) << "timer " << id << " fired at " << tick;
+                bool found = false;
+                for (; it != expected.end() && it->first == tick; ++it) {
+                    if (it->second == id) {
+                        expected.erase(it);
+                        found = true;
+                        break;
+                    }
+                }
+                EXPECT_TRUE(found) << "timer " << id << " fired at " << tick;
+            });
+        }
+    }
+};
+
+TEST_F(TTimerWheelTest, scheduleTest) {
+    Wheel wheel;
+    EXPECT_TRUE(wheel.isEmpty());
+    EXPECT_EQ(0u, wheel.getCurrentTick());
+
+    Wheel::Handle handle = wheel.schedule(10, 1);
+    EXPECT_TRUE(handle.isValid());
+    EXPECT_TRUE(wheel.isPending(handle));
+    EXPECT_EQ(1u, wheel.size());
+
+    std::vector<uint64_t> fired;
+    auto collect = [&](uint64_t id) { fired.push_back(id); };
+    EXPECT_EQ(0u, wheel.advance(9, collect));
+    EXPECT_EQ(1u, wheel.advance(10, collect));
+    ASSERT_EQ(1u, fired.size());
+    EXPECT_EQ(1u, fired[0]);
+    EXPECT_FALSE(wheel.isPending(handle));
+    EXPECT_TRUE(wheel.isEmpty());
+    EXPECT_EQ(10u, wheel.getCurrentTick());
+
+    // Past ticks fire on the next advance
+    wheel.schedule(3, 2);
+    EXPECT_EQ(1u, wheel.advance(11, collect));
+}
+
+TEST_F(TTimerWheelTest, cancelTest) {
+    Wheel wheel;
+    Wheel::Handle first = wheel.scheduleAfter(100, 1);
+    Wheel::Handle second = wheel.scheduleAfter(100, 2);
+    Wheel::Handle far = wheel.scheduleAfter(100000, 3);
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(first.isValid());
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_TRUE(wheel.cancel(far));
+
+    std::vector<uint64_t> fired;
+    wheel.advance(200000, [&](uint64_t id) { fired.push_back(id); });
+    ASSERT_EQ(1u, fired.size());
+    EXPECT_EQ(2u, fired[0]);
+
+    // The node of an expired timer is recycled, the old handle must not cancel the new timer
+    Wheel::Handle reused = wheel.scheduleAfter(5, 4);
+    EXPECT_FALSE(wheel.cancel(second));
+    EXPECT_TRUE(wheel.isPending(reused));
+}
+
+TEST_F(TTimerWheelTest, cascadeTest) {
+    Wheel wheel(1000);
+    std::multimap<uint64_t, uint64_t> expected;
+    const uint64_t delays[] = { 1, 255, 256, 257, 511, 65535, 65536, 65537, 70000, 200000 };
+    uint64_t id = 0;
+    for (uint64_t delay : delays) {
+        wheel.scheduleAfter(delay, id);
+        expected.insert(std::make_pair(1000 + delay, id));
+        ++id;
+    }
+    expectExact(wheel, 1000 + 200000, expected);
+    EXPECT_TRUE(expected.empty());
+    EXPECT_TRUE(wheel.isEmpty());
+}
+
+TEST_F(TTimerWheelTest, farTimerTest) {
+    Wheel wheel;
+    const uint64_t farTick = (uint64_t(1) << 33) + 12345;
+    wheel.schedule(farTick, 1);
+    wheel.schedule(uint64_t(1) << 24, 2);
+
+    std::vector<std::pair<uint64_t, uint64_t>> fired;
+    uint64_t now = 0;
+    // Jump in big steps, the timers must still fire exactly at their tick
+    while (fired.size() < 2 && now < farTick + 10) {
+        const uint64_t next = wheel.getNextExpiry();
+        ASSERT_GT(next, now);
+        now = next;
+        wheel.advance(now, [&](uint64_t id) { fired.push_back(std::make_pair(id, now)); });
+    }
+    ASSERT_EQ(2u, fired.size());
+    EXPECT_EQ(2u, fired[0].first);
+    EXPECT_EQ(uint64_t(1) << 24, fired[0].second);
+    EXPECT_EQ(1u, fired[1].first);
+    EXPECT_EQ(farTick, fired[1].second);
+}
+
+TEST_F(TTimerWheelTest, randomTest) {
+    Wheel wheel;
+    std::mt19937_64 random(42);
+    std::map<uint64_t, std::pair<uint64_t, Wheel::Handle>> timers;
+    uint64_t nextId = 0;
+    uint64_t now = 0;
+    size_t numFired = 0;
+
+    for (size_t round = 0; round < 2000; ++round) {
+        for (size_t i = 0; i < 20; ++i) {
+            const uint64_t delay = random() % (1u << (random() % 20));
+            const uint64_t id = nextId++;
+            timers[id] = std::make_pair(now + delay, wheel.scheduleAfter(delay, id));
+        }
+        for (size_t i = 0; i < 5 && !timers.empty(); ++i) {
+            auto it = timers.lower_bound(random() % nextId);
+            if (it != timers.end()) {
+                EXPECT_TRUE(wheel.cancel(it->second.second));
+                timers.erase(it);
+            }
+        }
+
+        now += random() % 300;
+        wheel.advance(now, [&](uint64_t id) {
+            auto it = timers.find(id);
+            ASSERT_NE(timers.end(), it);
+            EXPECT_LE(it->second.first, now);
+            timers.erase(it);
+            ++numFired;
+        });
+        EXPECT_EQ(timers.size(), wheel.size());
+    }
+
+    // Everything left must be due later
+    for (auto it = timers.begin(); it != timers.end(); ++it) {
+        EXPECT_GT(it->second.first, now);
+    }
+    EXPECT_LT(0u, numFired);
+}
+
+TEST_F(TTimerWheelTest, exactExpiryTest) {
+    Wheel wheel(77);
+    std::mt19937_64 random(7);
+    std::multimap<uint64_t, uint64_t> expected;
+    for (uint64_t id = 0; id < 5000; ++id) {
+        const uint64_t tick = 78 + random() % 100000;
+        wheel.schedule(tick, id);
+        expected.insert(std::make_pair(tick, id));
+    }
+    expectExact(wheel, 78 + 100000, expected);
+    EXPECT_TRUE(expected.empty());
+}
+
+TEST_F(TTimerWheelTest, rescheduleFromCallbackTest) {
+    Wheel wheel;
+    wheel.schedule(10, 1);
+    Wheel::Handle victim = wheel.schedule(10, 100);
+    std::vector<uint64_t> fired;
+    wheel.advance(50, [&](uint64_t id) {
+        fired.push_back(id);
+        if (1 == id) {
+            // Timers of one slot expire in scheduling order, cancel the next one of the batch
+            EXPECT_TRUE(wheel.cancel(victim));
+            wheel.scheduleAfter(5, 2);
+        } else if (2 == id && fired.size() < 5) {
+            wheel.scheduleAfter(5, 2);
+        }
+    });
+    const std::vector<uint64_t> expected = { 1, 2, 2, 2, 2 };
+    EXPECT_EQ(expected, fired);
+    EXPECT_EQ(50u, wheel.getCurrentTick());
+}
+
+TEST_F(TTimerWheelTest, postTest) {
+    Wheel wheel;
+    static const size_t NumThreads = 4;
+    static const size_t NumPerThread = 1000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NumThreads; ++t) {
+        threads.push_back(std::thread([&wheel, t]() {
+            for (size_t i = 0; i < NumPerThread; ++i) {
+                wheel.post(1 + i % 500, t * NumPerThread + i);
+            }
+        }));
+    }
+
+    size_t numFired = 0;
+    uint64_t now = 0;
+    while (numFired < NumThreads * NumPerThread && now < 100000) {
+        now += 10;
+        numFired += wheel.advance(now, [](uint64_t) {});
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    numFired += wheel.advance(now + 1000, [](uint64_t) {});
+    EXPECT_EQ(NumThreads * NumPerThread, numFired);
+}
@@ -0,0 +1,72 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/ThreadPool.h>
+#include <cppcore/Async/TTask.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+using namespace CPPCore;
+
+class ThreadPoolTest : public testing::Test {
+protected:
+    static TTask<void> increment(ThreadPool &pool, std::atomic<int> &counter) {
+        co_await pool.schedule();
+        counter.fetch_add(1);
+    }
+
+    static TTask<void> fanOut(ThreadPool &pool, std::atomic<int> &counter, int count) {
+        for (int i = 0; i < count; ++i) {
+            co_await increment(pool, counter);
+        }
+    }
+};
+
+TEST_F(ThreadPoolTest, createTest) {
+    ThreadPool pool(3);
+    EXPECT_EQ(3u, pool.getNumThreads());
+    EXPECT_FALSE(pool.isInPool());
+}
+
+TEST_F(ThreadPoolTest, scheduleTest) {
+    ThreadPool pool(2);
+    std::atomic<int> counter(0);
+    syncWait(fanOut(pool, counter, 1000));
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST_F(ThreadPoolTest, concurrentWaitersTest) {
+    ThreadPool pool(2);
+    std::atomic<int> counter(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([&]() {
+            syncWait(fanOut(pool, counter, 250));
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(1000, counter.load());
+}
@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Async/ThreadPool.h>
+#include <cppcore/Async/TimerService.h>
+#include <cppcore/Async/TTask.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <vector>
+
+using namespace CPPCore;
+
+class TimerServiceTest : public testing::Test {
+protected:
+    using Clock = TimerService::Clock;
+};
+
+TEST_F(TimerServiceTest, sleepTest) {
+    TimerService timers;
+    auto body = [](TimerService &timers) -> TTask<Clock::duration> {
+        const Clock::time_point start = Clock::now();
+        co_await timers.sleepFor(std::chrono::milliseconds(20));
+        co_return Clock::now() - start;
+    };
+    EXPECT_GE(syncWait(body(timers)), std::chrono::milliseconds(20));
+    EXPECT_EQ(0u, timers.getNumPending());
+}
+
+TEST_F(TimerServiceTest, expiredTest) {
+    TimerService timers;
+    auto body = [](TimerService &timers) -> TTask<bool> {
+        co_await timers.sleepUntil(Clock::now() - std::chrono::seconds(1));
+        co_return true;
+    };
+    EXPECT_TRUE(syncWait(body(timers)));
+}
+
+TEST_F(TimerServiceTest, orderTest) {
+    ThreadPool pool(1);
+    TimerService timers(&pool);
+    std::mutex mutex;
+    std::vector<int> order;
+
+    auto sleeper = [](TimerService &timers, int delay, std::mutex &mutex, std::vector<int> &order) -> TTask<void> {
+        co_await timers.sleepFor(std::chrono::milliseconds(delay));
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(delay);
+    };
+
+    std::vector<std::thread> threads;
+    const int delays[] = { 60, 20, 40 };
+    for (int delay : delays) {
+        threads.push_back(std::thread([&, delay]() {
+            syncWait(sleeper(timers, delay, mutex, order));
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+
+    const std::vector<int> expected = { 20, 40, 60 };
+    EXPECT_EQ(expected, order);
+}
@@ -0,0 +1,200 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Common/TVariant.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+using namespace CPPCore;
+
+class TVariantTest : public testing::Test {
+    // empty
+};
+
+struct Counted {
+    static int s_numAlive;
+
+    explicit Counted(int value) :
+            m_value(value) {
+        ++s_numAlive;
+    }
+
+    Counted(const Counted &rhs) :
+            m_value(rhs.m_value) {
+        ++s_numAlive;
+    }
+
+    ~Counted() {
+        --s_numAlive;
+    }
+
+    Counted &operator=(const Counted &) = default;
+
+    bool operator==(const Counted &rhs) const {
+        return m_value == rhs.m_value;
+    }
+
+    int m_value;
+};
+
+int Counted::s_numAlive = 0;
+
+using Number = TVariant<int, float, double>;
+using Value = TVariant<int, std::string, Counted>;
+using Owner = TVariant<int, std::unique_ptr<int>>;
+
+TEST_F(TVariantTest, indexTest) {
+    static_assert(0 == Number::IndexOf<int>);
+    static_assert(2 == Number::IndexOf<double>);
+    static_assert(Number::NoIndex == Number::IndexOf<char>);
+    static_assert(std::is_same_v<float, Number::TypeAt<1>>);
+    static_assert(std::is_trivially_copyable_v<Number>);
+    static_assert(!std::is_trivially_copyable_v<Value>);
+    static_assert(std::is_copy_constructible_v<Value>);
+    static_assert(!std::is_copy_constructible_v<Owner>);
+    static_assert(std::is_nothrow_move_constructible_v<Owner>);
+    static_assert(sizeof(Number) == 2 * sizeof(double));
+
+    Number number;
+    EXPECT_TRUE(number.isEmpty());
+    EXPECT_EQ(Number::NoIndex, number.getIndex());
+
+    number = 1.5f;
+    EXPECT_TRUE(number.is<float>());
+    EXPECT_FALSE(number.is<int>());
+    EXPECT_EQ(1.5f, number.get<float>());
+    EXPECT_EQ(nullptr, number.getIf<double>());
+    ASSERT_NE(nullptr, number.getIf<float>());
+
+    number.set(2.0);
+    EXPECT_EQ(2u, number.getIndex());
+    EXPECT_EQ(2.0, number.get<double>());
+
+    Number copy = number;
+    EXPECT_EQ(number, copy);
+    copy.set(2);
+    EXPECT_FALSE(number == copy);
+    number.clear();
+    EXPECT_TRUE(number.isEmpty());
+    EXPECT_EQ(Number(), number);
+}
+
+TEST_F(TVariantTest, visitTest) {
+    Number values[] = { Number(1), Number(2.5f), Number(4.0) };
+    double total = 0.0;
+    for (const Number &value : values) {
+        total += value.visit([](auto item) {
+            return static_cast<double>(item);
+        });
+    }
+    EXPECT_DOUBLE_EQ(7.5, total);
+
+    // The visitor may change the value
+    values[0].visit([](auto &item) {
+        item *= 3;
+    });
+    EXPECT_EQ(3, values[0].get<int>());
+}
+
+TEST_F(TVariantTest, lifetimeTest) {
+    {
+        Value value(Counted(5));
+        EXPECT_EQ(1, Counted::s_numAlive);
+        Value copy(value);
+        EXPECT_EQ(2, Counted::s_numAlive);
+        EXPECT_EQ(value, copy);
+
+        copy = std::string("text");
+        EXPECT_EQ(1, Counted::s_numAlive);
+        EXPECT_EQ("text", copy.get<std::string>());
+
+        // Moving keeps the type of the source, the string itself is moved
+        Value moved(std::move(copy));
+        EXPECT_EQ("text", moved.get<std::string>());
+        EXPECT_TRUE(copy.is<std::string>());
+
+        value.emplace<int>(3);
+        EXPECT_EQ(0, Counted::s_numAlive);
+        value.emplace<Counted>(9);
+        moved = value;
+        EXPECT_EQ(2, Counted::s_numAlive);
+        EXPECT_EQ(9, moved.get<Counted>().m_value);
+
+        // Move-only types can be moved
+        Owner source(std::make_unique<int>(7));
+        Owner owner(std::move(source));
+        EXPECT_EQ(7, *owner.get<std::unique_ptr<int>>());
+        EXPECT_EQ(nullptr, source.get<std::unique_ptr<int>>());
+        source = std::move(owner);
+        EXPECT_EQ(7, *source.get<std::unique_ptr<int>>());
+    }
+    EXPECT_EQ(0, Counted::s_numAlive);
+}
+
+TEST_F(TVariantTest, legacyTest) {
+    using Legacy = TVariant<int, float, bool, std::string, TStaticArray<float, 3>, TStaticArray<float, 16>, double>;
+
+    Variant variant;
+    variant.setInt(42);
+    Legacy value;
+    EXPECT_TRUE(value.fromVariant(variant));
+    EXPECT_EQ(42, value.get<int>());
+
+    variant.setFloat3(1.0f, 2.0f, 3.0f);
+    EXPECT_TRUE(value.fromVariant(variant));
+    EXPECT_EQ(2.0f, (value.get<TStaticArray<float, 3>>()[1]));
+
+    variant.setStdString("hello");
+    EXPECT_TRUE(value.fromVariant(variant));
+    EXPECT_EQ("hello", value.get<std::string>());
+
+    // Int4 has no counterpart in the type list
+    variant.setInt4(1, 2, 3, 4);
+    EXPECT_FALSE(value.fromVariant(variant));
+    EXPECT_TRUE(value.is<std::string>());
+
+    Variant result;
+    value.set(true);
+    EXPECT_TRUE(value.toVariant(result));
+    EXPECT_EQ(Variant::Boolean, result.getType());
+    EXPECT_TRUE(result.getBool());
+
+    TStaticArray<float, 16> matrix = TStaticArray<float, 16>::filled(0.0f);
+    matrix.set(5, 1.0f);
+    value.set(matrix);
+    EXPECT_TRUE(value.toVariant(result));
+    EXPECT_EQ(Variant::Float4x4, result.getType());
+    EXPECT_EQ(1.0f, result.getFloat4x4()[5]);
+
+    Legacy roundTrip;
+    EXPECT_TRUE(roundTrip.fromVariant(result));
+    EXPECT_EQ(value, roundTrip);
+
+    value.set(1.0);
+    EXPECT_FALSE(value.toVariant(result));
+    value.clear();
+    EXPECT_TRUE(value.toVariant(result));
+    EXPECT_EQ(Variant::None, result.getType());
+}
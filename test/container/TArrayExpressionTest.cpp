@@ -0,0 +1,178 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TArrayExpression.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace CPPCore;
+
+class TArrayExpressionTest : public testing::Test {
+    // empty
+};
+
+static void fill(TArray<float> &array, size_t size, float scale) {
+    array.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        array[i] = static_cast<float>(i % 97) * scale - 10.0f;
+    }
+}
+
+TEST_F(TArrayExpressionTest, evaluateTest) {
+    TArray<float> a, b, c, result;
+    fill(a, 1000, 0.5f);
+    fill(b, 1000, 0.25f);
+    fill(c, 1000, 2.0f);
+
+    evaluate(result, lazy(a) * lazy(b) + lazy(c) - 1.0f);
+    ASSERT_EQ(1000u, result.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_FLOAT_EQ(a[i] * b[i] + c[i] - 1.0f, result[i]);
+    }
+
+    // Scalars on the left, unary operators and functions
+    evaluate(result, 2 * abs(-lazy(a)) / 4.0f + maximum(lazy(b), lazy(c)));
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_FLOAT_EQ(2.0f * std::abs(a[i]) / 4.0f + std::max(b[i], c[i]), result[i]);
+    }
+
+    // The output may be an input
+    evaluate(a, lazy(a) * 2.0f);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_FLOAT_EQ((static_cast<float>(i % 97) * 0.5f - 10.0f) * 2.0f, a[i]);
+    }
+
+    // Static arrays and raw memory
+    TStaticArray<int, 4> ints = { { 1, 2, 3, 4 } };
+    TStaticArray<int, 4> squares = TStaticArray<int, 4>::filled(0);
+    evaluate(squares, lazy(ints) * lazy(ints));
+    EXPECT_EQ(16, squares[3]);
+    std::vector<double> doubles(5, 0.0);
+    // Integer math stays integer, a floating point scalar turns it into double math
+    evaluate(doubles.data(), lazy(ints.data(), 4) / 2 + 0.5);
+    EXPECT_DOUBLE_EQ(0.5, doubles[0]);
+    EXPECT_DOUBLE_EQ(2.5, doubles[3]);
+    EXPECT_DOUBLE_EQ(0.0, doubles[4]);
+
+    TArray<float> empty;
+    evaluate(result, lazy(empty) + 1.0f);
+    EXPECT_TRUE(result.isEmpty());
+}
+
+TEST_F(TArrayExpressionTest, mixedTypesTest) {
+    TArray<int> ints;
+    ints.resize(100);
+    for (size_t i = 0; i < ints.size(); ++i) {
+        ints[i] = static_cast<int>(i);
+    }
+
+    // The scalar must not be truncated to the int value type of the array
+    TArray<double> halves;
+    evaluate(halves, lazy(ints) * 0.5);
+    for (size_t i = 0; i < halves.size(); ++i) {
+        EXPECT_DOUBLE_EQ(static_cast<double>(i) * 0.5, halves[i]);
+    }
+    EXPECT_DOUBLE_EQ(99 * 100 / 2 * 0.5, sum(0.5 * lazy(ints)));
+    EXPECT_EQ(97u, count(lazy(ints) > 2.5));
+    EXPECT_DOUBLE_EQ(0.25, maxElement(minimum(lazy(ints), 0.25)));
+
+    // Float expressions keep their type next to double literals
+    TArray<float> floats;
+    fill(floats, 10, 1.0f);
+    static_assert(std::is_same_v<float, decltype(lazy(floats) * 0.5)::ValueType>);
+}
+
+TEST_F(TArrayExpressionTest, maskTest) {
+    TArray<int> values;
+    values.resize(200);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i) - 100;
+    }
+
+    EXPECT_EQ(99u, count(lazy(values) > 0));
+    EXPECT_EQ(10u, count((lazy(values) >= 0) & (lazy(values) < 10)));
+    EXPECT_EQ(190u, count(!((lazy(values) >= 0) & (lazy(values) < 10))));
+    EXPECT_EQ(2u, count((lazy(values) == -100) | (lazy(values) == 99)));
+
+    // Sums of the positive items only
+    EXPECT_EQ(99 * 100 / 2, sum(where(lazy(values) > 0, lazy(values), 0)));
+
+    TArray<int> clamped;
+    evaluate(clamped, where(lazy(values) < -5, -5, minimum(lazy(values), 5)));
+    EXPECT_EQ(-5, clamped[0]);
+    EXPECT_EQ(0, clamped[100]);
+    EXPECT_EQ(5, clamped[199]);
+}
+
+TEST_F(TArrayExpressionTest, reduceTest) {
+    TArray<float> a, b;
+    fill(a, 100003, 0.5f);
+    fill(b, 100003, 0.25f);
+
+    double expectedSum = 0.0, expectedDot = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        expectedSum += a[i];
+        expectedDot += static_cast<double>(a[i]) * b[i];
+    }
+    EXPECT_NEAR(expectedSum, sum(lazy(a)), 1.0);
+    EXPECT_NEAR(expectedDot, dot(lazy(a), lazy(b)), std::abs(expectedDot) * 1e-5);
+    EXPECT_FLOAT_EQ(-10.0f, minElement(lazy(a)));
+    EXPECT_FLOAT_EQ(38.0f, maxElement(lazy(a)));
+    EXPECT_FLOAT_EQ(-38.0f, minElement(-lazy(a)));
+
+    // The SIMD kernels and the generic path sum in the same order
+    EXPECT_EQ(sum(lazy(a)), sum(lazy(a) + 0.0f));
+    EXPECT_EQ(dot(lazy(a), lazy(b)), sum(lazy(a) * lazy(b) + 0.0f));
+
+    TArray<float> empty;
+    EXPECT_EQ(0.0f, sum(lazy(empty)));
+    EXPECT_EQ(std::numeric_limits<float>::max(), minElement(lazy(empty)));
+}
+
+TEST_F(TArrayExpressionTest, parallelTest) {
+    TArray<float> a, b, serial, parallel;
+    fill(a, 300001, 0.5f);
+    fill(b, 300001, 0.125f);
+
+    ExpressionOptions serialOptions;
+    serialOptions.m_parallelThreshold = std::numeric_limits<size_t>::max();
+    ExpressionOptions parallelOptions;
+    parallelOptions.m_parallelThreshold = 0;
+    parallelOptions.m_grainSize = 4096;
+    serialOptions.m_grainSize = 4096;
+
+    evaluate(serial, lazy(a) * lazy(b) + lazy(a), serialOptions);
+    evaluate(parallel, lazy(a) * lazy(b) + lazy(a), parallelOptions);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        ASSERT_EQ(serial[i], parallel[i]);
+    }
+
+    // Reductions give bit identical results with and without threads
+    EXPECT_EQ(sum(lazy(a), serialOptions), sum(lazy(a), parallelOptions));
+    EXPECT_EQ(dot(lazy(a), lazy(b), serialOptions), dot(lazy(a), lazy(b), parallelOptions));
+    EXPECT_EQ(sum(lazy(a) * 3.0f - lazy(b), serialOptions), sum(lazy(a) * 3.0f - lazy(b), parallelOptions));
+    EXPECT_EQ(count(lazy(a) > lazy(b), serialOptions), count(lazy(a) > lazy(b), parallelOptions));
+    EXPECT_EQ(maxElement(lazy(b), serialOptions), maxElement(lazy(b), parallelOptions));
+}
@@ -0,0 +1,245 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TConcurrentSkipList.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TConcurrentSkipListTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TConcurrentSkipListTest, insertFindRemoveTest) {
+    TConcurrentSkipList<int, std::string> list;
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_EQ(0u, list.size());
+
+    EXPECT_TRUE(list.insert(5, "five"));
+    EXPECT_TRUE(list.insert(1, "one"));
+    EXPECT_TRUE(list.insert(3, "three"));
+    EXPECT_FALSE(list.insert(3, "drei"));
+    EXPECT_EQ(3u, list.size());
+    EXPECT_FALSE(list.isEmpty());
+
+    std::string value;
+    EXPECT_TRUE(list.find(3, value));
+    EXPECT_EQ("three", value);
+    EXPECT_FALSE(list.find(4, value));
+    EXPECT_TRUE(list.contains(1));
+    EXPECT_FALSE(list.contains(2));
+
+    int key = 0;
+    EXPECT_TRUE(list.getFirst(key, value));
+    EXPECT_EQ(1, key);
+    EXPECT_EQ("one", value);
+
+    EXPECT_TRUE(list.remove(1));
+    EXPECT_FALSE(list.remove(1));
+    EXPECT_FALSE(list.contains(1));
+    EXPECT_TRUE(list.getFirst(key, value));
+    EXPECT_EQ(3, key);
+
+    // A removed key can be inserted again with a new value
+    EXPECT_TRUE(list.remove(3));
+    EXPECT_TRUE(list.insert(3, "drei"));
+    EXPECT_TRUE(list.find(3, value));
+    EXPECT_EQ("drei", value);
+    EXPECT_EQ(2u, list.size());
+}
+
+TEST_F(TConcurrentSkipListTest, orderTest) {
+    TConcurrentSkipList<uint32_t, uint32_t> list;
+    std::set<uint32_t> reference;
+    std::mt19937 random(7);
+    for (size_t i = 0; i < 5000; ++i) {
+        const uint32_t key = random() % 10000;
+        EXPECT_EQ(reference.insert(key).second, list.insert(key, key * 2));
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+        const uint32_t key = random() % 10000;
+        EXPECT_EQ(1u == reference.erase(key), list.remove(key));
+    }
+    EXPECT_EQ(reference.size(), list.size());
+
+    std::vector<uint32_t> keys;
+    list.forEach([&keys](const uint32_t &key, const uint32_t &value) {
+        EXPECT_EQ(key * 2, value);
+        keys.push_back(key);
+        return true;
+    });
+    EXPECT_EQ(std::vector<uint32_t>(reference.begin(), reference.end()), keys);
+
+    // [1000, 2000), then a scan which stops after 10 keys
+    keys.clear();
+    list.forRange(1000, 2000, [&keys](const uint32_t &key, const uint32_t &) {
+        keys.push_back(key);
+        return true;
+    });
+    EXPECT_EQ(std::vector<uint32_t>(reference.lower_bound(1000), reference.lower_bound(2000)), keys);
+    size_t count = 0;
+    EXPECT_EQ(10u, list.forRange(0, 10000, [&count](const uint32_t &, const uint32_t &) {
+        return ++count < 10;
+    }));
+}
+
+TEST_F(TConcurrentSkipListTest, compareTest) {
+    TConcurrentSkipList<int, int, std::greater<int>> list;
+    for (int i = 0; i < 10; ++i) {
+        list.insert(i, i);
+    }
+    int key = 0;
+    int value = 0;
+    EXPECT_TRUE(list.getFirst(key, value));
+    EXPECT_EQ(9, key);
+
+    std::vector<int> keys;
+    list.forRange(7, 3, [&keys](const int &key, const int &) {
+        keys.push_back(key);
+        return true;
+    });
+    EXPECT_EQ(std::vector<int>({ 7, 6, 5, 4 }), keys);
+}
+
+TEST_F(TConcurrentSkipListTest, concurrentTest) {
+    static const size_t NumThreads = 4;
+    static const uint32_t NumKeys = 512;
+    static const size_t NumOps = 20000;
+
+    // Every key counts its successful inserts minus removes, which must end up as 0 or 1
+    TConcurrentSkipList<uint32_t, uint32_t> list;
+    std::vector<std::atomic<int>> balance(NumKeys);
+    std::atomic<bool> done(false);
+    std::atomic<size_t> numOrderErrors(0);
+
+    std::thread scanner([&list, &done, &numOrderErrors]() {
+        while (!done.load()) {
+            uint32_t last = 0;
+            bool first = true;
+            list.forEach([&](const uint32_t &key, const uint32_t &value) {
+                if ((!first && key <= last) || value != key + 1) {
+                    numOrderErrors.fetch_add(1);
+                }
+                first = false;
+                last = key;
+                return true;
+            });
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NumThreads; ++t) {
+        threads.push_back(std::thread([&list, &balance, t]() {
+            std::mt19937 random(static_cast<uint32_t>(t + 1));
+            for (size_t i = 0; i < NumOps; ++i) {
+                const uint32_t key = random() % NumKeys;
+                if (0 == random() % 2) {
+                    if (list.insert(key, key + 1)) {
+                        balance[key].fetch_add(1);
+                    }
+                } else if (list.remove(key)) {
+                    balance[key].fetch_sub(1);
+                }
+            }
+            TConcurrentSkipList<uint32_t, uint32_t>::flushRetired();
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    done.store(true);
+    scanner.join();
+
+    EXPECT_EQ(0u, numOrderErrors.load());
+    size_t count = 0;
+    for (uint32_t key = 0; key < NumKeys; ++key) {
+        const int value = balance[key].load();
+        ASSERT_TRUE(0 == value || 1 == value);
+        EXPECT_EQ(1 == value, list.contains(key));
+        count += static_cast<size_t>(value);
+    }
+    EXPECT_EQ(count, list.size());
+    EXPECT_EQ(count, list.forEach([](const uint32_t &, const uint32_t &) { return true; }));
+
+    // All removed nodes are freed after a grace period
+    TConcurrentSkipList<uint32_t, uint32_t>::flushRetired();
+    Rcu::barrier();
+    EXPECT_EQ(0u, Rcu::numPending());
+}
+
+TEST_F(TConcurrentSkipListTest, insertRemoveRaceTest) {
+    static const uint32_t NumFillers = 4096;
+    static const uint32_t NumKeys = 4;
+    static const size_t NumOps = 50000;
+
+    // Fillers give the upper levels neighbours, so the towers of the raced keys are linked level
+    // by level while the removers mark and unlink them
+    TConcurrentSkipList<uint32_t, uint32_t> list;
+    for (uint32_t i = 0; i < NumFillers; ++i) {
+        list.insert(i * 2 + 1, i);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&list, t]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                const uint32_t key = static_cast<uint32_t>(i % NumKeys) * 1024;
+                if (0 == t % 2) {
+                    list.insert(key, key);
+                } else {
+                    list.remove(key);
+                }
+                if (0 == i % 256) {
+                    TConcurrentSkipList<uint32_t, uint32_t>::flushRetired();
+                }
+            }
+            TConcurrentSkipList<uint32_t, uint32_t>::flushRetired();
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (uint32_t i = 0; i < NumKeys; ++i) {
+        list.remove(i * 1024);
+    }
+    TConcurrentSkipList<uint32_t, uint32_t>::flushRetired();
+    Rcu::barrier();
+
+    // A node retired while still linked on an upper level would be walked into here
+    EXPECT_EQ(NumFillers, list.size());
+    for (uint32_t i = 0; i < NumFillers; ++i) {
+        ASSERT_TRUE(list.contains(i * 2 + 1));
+    }
+    for (uint32_t i = 0; i < NumKeys; ++i) {
+        EXPECT_FALSE(list.contains(i * 1024));
+        EXPECT_TRUE(list.insert(i * 1024, i));
+    }
+    EXPECT_EQ(NumFillers + NumKeys, list.forEach([](const uint32_t &, const uint32_t &) { return true; }));
+}
@@ -0,0 +1,171 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TDenseHashMap.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CPPCore;
+
+class TDenseHashMapTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TDenseHashMapTest, insertFindTest) {
+    TDenseHashMap<std::string, int> map;
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(0u, map.capacity());
+    EXPECT_EQ(nullptr, map.find("missing"));
+
+    EXPECT_TRUE(map.insert("one", 1));
+    EXPECT_TRUE(map.insert("two", 2));
+    EXPECT_TRUE(map.insert("three", 3));
+    EXPECT_FALSE(map.insert("two", 22));
+    EXPECT_EQ(3u, map.size());
+
+    // Lookups without building a std::string
+    ASSERT_NE(nullptr, map.find("two"));
+    EXPECT_EQ(22, *map.find(std::string_view("two")));
+    int value = 0;
+    EXPECT_TRUE(map.getValue("three", value));
+    EXPECT_EQ(3, value);
+    EXPECT_FALSE(map.hasKey("four"));
+
+    map["four"] += 4;
+    EXPECT_EQ(4, *map.find("four"));
+
+    // Iteration follows the insertion order
+    const char *order[] = { "one", "two", "three", "four" };
+    size_t i = 0;
+    for (const auto &entry : map) {
+        EXPECT_EQ(order[i++], entry.m_key);
+    }
+    EXPECT_EQ(4u, i);
+
+    map.clear();
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_FALSE(map.hasKey("one"));
+}
+
+TEST_F(TDenseHashMapTest, removeTest) {
+    TDenseHashMap<int, int> map;
+    for (int i = 0; i < 10; ++i) {
+        map.insert(i, i * 10);
+    }
+
+    // The last entry takes the place of the removed one
+    EXPECT_TRUE(map.remove(3));
+    EXPECT_FALSE(map.remove(3));
+    EXPECT_EQ(9u, map.size());
+    EXPECT_EQ(9, map.begin()[3].m_key);
+    EXPECT_EQ(90, *map.find(9));
+    EXPECT_EQ(nullptr, map.find(3));
+
+    EXPECT_TRUE(map.remove(8));
+    EXPECT_EQ(8u, map.size());
+    for (const auto &entry : map) {
+        EXPECT_EQ(entry.m_key * 10, entry.m_value);
+        EXPECT_EQ(entry.m_value, *map.find(entry.m_key));
+    }
+}
+
+TEST_F(TDenseHashMapTest, randomTest) {
+    // A random sequence of inserts and removes against std::unordered_map
+    TDenseHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < 200000; ++i) {
+        const uint64_t key = random() % 5000;
+        if (0 == random() % 3) {
+            EXPECT_EQ(reference.erase(key) == 1, map.remove(key));
+        } else {
+            EXPECT_EQ(reference.find(key) == reference.end(), map.insert(key, i));
+            reference[key] = i;
+        }
+    }
+
+    ASSERT_EQ(reference.size(), map.size());
+    for (const auto &entry : reference) {
+        const uint64_t *value = map.find(entry.first);
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(entry.second, *value);
+    }
+    size_t count = 0;
+    for (const auto &entry : map) {
+        EXPECT_EQ(1u, reference.count(entry.m_key));
+        ++count;
+    }
+    EXPECT_EQ(reference.size(), count);
+}
+
+TEST_F(TDenseHashMapTest, reserveTest) {
+    TDenseHashMap<int, std::string> map;
+    map.reserve(1000);
+    const size_t capacity = map.capacity();
+    EXPECT_LE(1000u, capacity);
+    for (int i = 0; i < 1000; ++i) {
+        map.insert(i, std::to_string(i));
+    }
+    EXPECT_EQ(capacity, map.capacity());
+    EXPECT_EQ("777", *map.find(777));
+
+    // Growing moves the strings
+    for (int i = 1000; i < 5000; ++i) {
+        map.insert(i, std::to_string(i));
+    }
+    EXPECT_EQ("4321", *map.find(4321));
+    EXPECT_EQ("0", map.begin()->m_value);
+}
+
+TEST_F(TDenseHashMapTest, findBatchTest) {
+    TDenseHashMap<std::string, int> map;
+    const std::string keys[] = { "a", "b", "c", "d", "e" };
+    const int *values[5];
+    EXPECT_EQ(0u, map.findBatch(keys, 5, values));
+
+    map.insert("b", 2);
+    map.insert("d", 4);
+    map.insert("x", 0);
+    EXPECT_EQ(2u, map.findBatch(keys, 5, values));
+    EXPECT_EQ(nullptr, values[0]);
+    EXPECT_EQ(2, *values[1]);
+    EXPECT_EQ(nullptr, values[2]);
+    EXPECT_EQ(4, *values[3]);
+    EXPECT_EQ(nullptr, values[4]);
+
+    // Batches longer than one prefetch group
+    TDenseHashMap<int, int> numbers;
+    std::vector<int> queries;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.insert(i, -i);
+        queries.push_back(i * 2);
+    }
+    std::vector<const int *> found(queries.size());
+    EXPECT_EQ(500u, numbers.findBatch(queries.data(), queries.size(), found.data()));
+    EXPECT_EQ(-998, *found[499]);
+    EXPECT_EQ(nullptr, found[500]);
+}
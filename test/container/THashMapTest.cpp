@@ -174,3 +174,43 @@ TEST_F( THashMapTest, Reinit_Successful ) {
     myHashMap.insert( 1, 10 );
     EXPECT_TRUE( myHashMap.hasKey( 1 ) );
 }
+
+TEST_F( THashMapTest, GetValueOfMissingKey_ReturnsFalse ) {
+    THashMap<unsigned int, unsigned int> myHashMap( 10 );
+    unsigned int value = 0;
+    EXPECT_FALSE( myHashMap.getValue( 1, value ) );
+
+    myHashMap.insert( 1, 10 );
+    myHashMap.insert( 11, 110 );
+    EXPECT_FALSE( myHashMap.getValue( 21, value ) );
+    EXPECT_TRUE( myHashMap.getValue( 11, value ) );
+    EXPECT_EQ( 110u, value );
+
+    myHashMap.clear();
+    EXPECT_FALSE( myHashMap.getValue( 1, value ) );
+}
+
+TEST_F( THashMapTest, FindBatch_Successful ) {
+    THashMap<unsigned int, unsigned int> myHashMap( 64 );
+    const unsigned int *values[ 100 ];
+    unsigned int keys[ 100 ];
+    for ( unsigned int i = 0; i < 100; ++i ) {
+        keys[ i ] = i * 3;
+    }
+    EXPECT_EQ( 0u, myHashMap.findBatch( keys, 100, values ) );
+
+    for ( unsigned int i = 0; i < 150; i += 2 ) {
+        myHashMap.insert( i, i * 10 );
+    }
+
+    // Every even key below 150 was inserted
+    EXPECT_EQ( 25u, myHashMap.findBatch( keys, 100, values ) );
+    for ( unsigned int i = 0; i < 100; ++i ) {
+        if ( 0 == keys[ i ] % 2 && keys[ i ] < 150 ) {
+            ASSERT_NE( nullptr, values[ i ] );
+            EXPECT_EQ( keys[ i ] * 10, *values[ i ] );
+        } else {
+            EXPECT_EQ( nullptr, values[ i ] );
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TInlineArray.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using namespace CPPCore;
+
+class TInlineArrayTest : public testing::Test {
+    // empty
+};
+
+namespace {
+
+struct Counted {
+    static int s_numAlive;
+
+    int m_value;
+
+    Counted(int value) :
+            m_value(value) {
+        ++s_numAlive;
+    }
+
+    Counted(const Counted &rhs) :
+            m_value(rhs.m_value) {
+        ++s_numAlive;
+    }
+
+    Counted &operator=(const Counted &rhs) = default;
+
+    ~Counted() {
+        --s_numAlive;
+    }
+};
+
+int Counted::s_numAlive = 0;
+
+// Trivially copyable, but not trivially default constructible
+struct Initialized {
+    int m_value = 1;
+};
+
+constexpr int getConstexprSum() {
+    TInlineArray<int, 8> values = { 1, 2, 3 };
+    values.add(4);
+    values.insert(0, 10);
+    values.remove(2);
+    values.removeUnordered(0);
+    int sum = 0;
+    for (int value : values) {
+        sum += value;
+    }
+    return sum * 10 + static_cast<int>(values.size());
+}
+
+} // Namespace
+
+static_assert(std::is_trivially_copyable_v<TInlineArray<int, 4>>);
+static_assert(std::is_trivially_copyable_v<TInlineArray<Initialized, 4>>);
+static_assert(!std::is_trivially_copyable_v<TInlineArray<std::string, 4>>);
+static_assert(sizeof(TInlineArray<uint32_t, 3>) == 4 * sizeof(uint32_t));
+static_assert(83 == getConstexprSum());
+
+TEST_F(TInlineArrayTest, addRemoveTest) {
+    TInlineArray<int, 4> values;
+    EXPECT_TRUE(values.isEmpty());
+    EXPECT_EQ(4u, values.capacity());
+
+    values.add(1);
+    values.add(2);
+    values.emplace(3);
+    EXPECT_EQ(3u, values.size());
+    EXPECT_EQ(1, values.front());
+    EXPECT_EQ(3, values.back());
+
+    values.insert(1, 5);
+    EXPECT_TRUE(values.isFull());
+    EXPECT_EQ((TInlineArray<int, 4>{ 1, 5, 2, 3 }), values);
+
+    values.remove(0);
+    EXPECT_EQ((TInlineArray<int, 4>{ 5, 2, 3 }), values);
+    values.removeUnordered(0);
+    EXPECT_EQ((TInlineArray<int, 4>{ 3, 2 }), values);
+    values.removeBack();
+    EXPECT_EQ(1u, values.size());
+
+    TInlineArray<int, 4> copy = values;
+    values.clear();
+    EXPECT_TRUE(values.isEmpty());
+    EXPECT_EQ(3, copy[0]);
+}
+
+TEST_F(TInlineArrayTest, insertOwnItemTest) {
+    TInlineArray<std::string, 4> values = { "a", "b", "c" };
+    values.insert(0, values[2]);
+    EXPECT_EQ("c", values[0]);
+    EXPECT_EQ("a", values[1]);
+    EXPECT_EQ("c", values[3]);
+}
+
+TEST_F(TInlineArrayTest, lifetimeTest) {
+    {
+        TInlineArray<Counted, 8> values;
+        EXPECT_EQ(0, Counted::s_numAlive);
+        values.emplace(1);
+        values.add(Counted(2));
+        values.insert(0, Counted(3));
+        EXPECT_EQ(3, Counted::s_numAlive);
+
+        TInlineArray<Counted, 8> copy = values;
+        EXPECT_EQ(6, Counted::s_numAlive);
+        copy.remove(1);
+        copy.removeUnordered(0);
+        EXPECT_EQ(4, Counted::s_numAlive);
+        EXPECT_EQ(2, copy[0].m_value);
+
+        copy = values;
+        EXPECT_EQ(6, Counted::s_numAlive);
+        values.clear();
+        EXPECT_EQ(3, Counted::s_numAlive);
+    }
+    EXPECT_EQ(0, Counted::s_numAlive);
+
+    TInlineArray<std::unique_ptr<int>, 2> pointers;
+    pointers.add(std::make_unique<int>(7));
+    TInlineArray<std::unique_ptr<int>, 2> moved = std::move(pointers);
+    EXPECT_EQ(7, *moved[0]);
+}
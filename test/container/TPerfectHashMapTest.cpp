@@ -0,0 +1,159 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TPerfectHashMap.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace CPPCore;
+
+class TPerfectHashMapTest : public testing::Test {
+    // empty
+};
+
+enum class Color {
+    Red,
+    Green,
+    Blue
+};
+
+static constexpr auto Commands = makePerfectHashMap<std::string_view, int>({
+        { "get", 1 }, { "set", 2 }, { "del", 3 }, { "incr", 4 }, { "decr", 5 }, { "expire", 6 }, { "keys", 7 },
+        { "subscribe", 8 }, { "unsubscribe", 9 }, { "publish", 10 }, { "multi", 11 }, { "exec", 12 } });
+
+TEST_F(TPerfectHashMapTest, staticTest) {
+    // The lookups work in constant expressions as well
+    static_assert(12 == Commands.size());
+    static_assert(8 == *Commands.find("subscribe"));
+    static_assert(nullptr == Commands.find("watch"));
+
+    for (const auto &entry : Commands) {
+        const int *value = Commands.find(entry.m_key);
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(entry.m_value, *value);
+    }
+    const std::string name = "publish";
+    int value = 0;
+    EXPECT_TRUE(Commands.getValue(name, value));
+    EXPECT_EQ(10, value);
+    EXPECT_FALSE(Commands.hasKey(""));
+    EXPECT_FALSE(Commands.hasKey("gets"));
+    EXPECT_FALSE(Commands.hasKey("ge"));
+
+    static constexpr auto Colors = makePerfectHashMap<Color, std::string_view>({
+            { Color::Red, "red" }, { Color::Green, "green" }, { Color::Blue, "blue" } });
+    static_assert("green" == *Colors.find(Color::Green));
+
+    static constexpr auto Single = makePerfectHashMap<int, int>({ { 42, 1 } });
+    static_assert(Single.hasKey(42));
+    static_assert(!Single.hasKey(43));
+}
+
+TEST_F(TPerfectHashMapTest, runtimeTest) {
+    const size_t count = 100000;
+    std::vector<std::string> keys;
+    std::vector<size_t> values;
+    for (size_t i = 0; i < count; ++i) {
+        keys.push_back("key_" + std::to_string(i * 7919));
+        values.push_back(i);
+    }
+
+    TPerfectHashMap<std::string, size_t> map;
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_FALSE(map.hasKey("key_0"));
+    ASSERT_TRUE(map.init(keys.data(), values.data(), count));
+    EXPECT_EQ(count, map.size());
+    for (size_t i = 0; i < count; ++i) {
+        const size_t *value = map.find(keys[i]);
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(i, *value);
+    }
+    size_t value = 0;
+    EXPECT_TRUE(map.getValue(std::string_view("key_7919"), value));
+    EXPECT_EQ(1u, value);
+    EXPECT_FALSE(map.hasKey("key_1"));
+    EXPECT_FALSE(map.hasKey(""));
+
+    map.clear();
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_FALSE(map.hasKey(keys[0]));
+}
+
+TEST_F(TPerfectHashMapTest, integerKeysTest) {
+    std::vector<uint64_t> keys;
+    std::vector<int> values;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        keys.push_back(i * 0x10000);
+        values.push_back(static_cast<int>(i));
+    }
+
+    TPerfectHashMap<uint64_t, int> map;
+    ASSERT_TRUE(map.init(keys.data(), values.data(), keys.size()));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i), *map.find(keys[i]));
+        EXPECT_FALSE(map.hasKey(keys[i] + 1));
+    }
+}
+
+TEST_F(TPerfectHashMapTest, duplicateKeysTest) {
+    const std::string keys[] = { "a", "b", "a" };
+    const int values[] = { 1, 2, 3 };
+    TPerfectHashMap<std::string, int> map;
+    EXPECT_FALSE(map.init(keys, values, 3));
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_FALSE(map.hasKey("a"));
+
+    EXPECT_TRUE(map.init(keys, values, 2));
+    EXPECT_EQ(2, *map.find("b"));
+}
+
+TEST_F(TPerfectHashMapTest, findBatchTest) {
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        keys.push_back(i * 7);
+        values.push_back(i);
+    }
+    TPerfectHashMap<uint32_t, uint32_t> map;
+    const uint32_t *found[40];
+    EXPECT_EQ(0u, map.findBatch(keys.data(), 40, found));
+    EXPECT_EQ(nullptr, found[0]);
+
+    ASSERT_TRUE(map.init(keys.data(), values.data(), keys.size()));
+    std::vector<uint32_t> queries;
+    for (uint32_t i = 0; i < 40; ++i) {
+        queries.push_back(i * 14 + (i % 2));
+    }
+    // Only the even queries are keys
+    EXPECT_EQ(20u, map.findBatch(queries.data(), queries.size(), found));
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (0 == i % 2) {
+            ASSERT_NE(nullptr, found[i]);
+            EXPECT_EQ(queries[i] / 7, *found[i]);
+        } else {
+            EXPECT_EQ(nullptr, found[i]);
+        }
+    }
+}
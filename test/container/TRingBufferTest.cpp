@@ -0,0 +1,91 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TRingBuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace CPPCore;
+
+class TRingBufferTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TRingBufferTest, addRemoveTest) {
+    TRingBuffer<int> buffer(3);
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_EQ(3u, buffer.capacity());
+
+    buffer.add(1);
+    buffer.add(2);
+    buffer.add(3);
+    EXPECT_TRUE(buffer.isFull());
+    EXPECT_EQ(1, buffer.front());
+    EXPECT_EQ(3, buffer.back());
+
+    // The oldest item is overwritten
+    buffer.add(4);
+    EXPECT_EQ(3u, buffer.size());
+    EXPECT_EQ(2, buffer[0]);
+    EXPECT_EQ(3, buffer[1]);
+    EXPECT_EQ(4, buffer[2]);
+
+    buffer.removeFront();
+    EXPECT_EQ(3, buffer.front());
+    buffer.removeBack();
+    EXPECT_EQ(3, buffer.back());
+    EXPECT_EQ(1u, buffer.size());
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_EQ(3u, buffer.capacity());
+}
+
+TEST_F(TRingBufferTest, segmentsTest) {
+    TRingBuffer<int> buffer(5);
+    TRingBuffer<int>::Segments segments = buffer.getSegments();
+    EXPECT_EQ(0u, segments.m_firstCount + segments.m_secondCount);
+
+    for (int i = 0; i < 4; ++i) {
+        buffer.add(i);
+    }
+    segments = buffer.getSegments();
+    EXPECT_EQ(4u, segments.m_firstCount);
+    EXPECT_EQ(0u, segments.m_secondCount);
+
+    // 3 wrapped items in the second segment
+    for (int i = 4; i < 8; ++i) {
+        buffer.add(i);
+    }
+    segments = buffer.getSegments();
+    ASSERT_EQ(2u, segments.m_firstCount);
+    ASSERT_EQ(3u, segments.m_secondCount);
+    EXPECT_EQ(3, segments.m_first[0]);
+    EXPECT_EQ(5, segments.m_second[0]);
+    EXPECT_EQ(7, segments.m_second[2]);
+
+    std::vector<int> items(buffer.size());
+    buffer.copyTo(items.data());
+    EXPECT_EQ((std::vector<int>{ 3, 4, 5, 6, 7 }), items);
+}
@@ -0,0 +1,146 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Container/TSparseSet.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CPPCore;
+
+class TSparseSetTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TSparseSetTest, insertRemoveTest) {
+    TSparseSet<> set;
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_EQ(TSparseSet<>::InvalidIndex, set.getIndex(123456));
+    EXPECT_FALSE(set.remove(7));
+
+    EXPECT_TRUE(set.insert(7));
+    EXPECT_TRUE(set.insert(0));
+    EXPECT_TRUE(set.insert(100000));
+    EXPECT_FALSE(set.insert(7));
+    EXPECT_EQ(3u, set.size());
+    EXPECT_TRUE(set.contains(100000));
+    EXPECT_FALSE(set.contains(100001));
+    EXPECT_EQ(1u, set.getIndex(0));
+
+    // The last id takes the place of the removed one
+    EXPECT_TRUE(set.remove(7));
+    EXPECT_FALSE(set.contains(7));
+    EXPECT_EQ(2u, set.size());
+    EXPECT_EQ(100000u, set.getIds()[0]);
+    EXPECT_EQ(0u, set.getIndex(100000));
+
+    EXPECT_TRUE(set.remove(0));
+    EXPECT_TRUE(set.remove(100000));
+    EXPECT_TRUE(set.isEmpty());
+
+    set.insert(5);
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(5));
+}
+
+TEST_F(TSparseSetTest, valuesTest) {
+    TSparseSet<std::string> set;
+    EXPECT_EQ(nullptr, set.find(1));
+    EXPECT_TRUE(set.insert(1, "one"));
+    EXPECT_TRUE(set.insert(2, "two"));
+    EXPECT_TRUE(set.insert(3));
+    EXPECT_FALSE(set.insert(2, "zwei"));
+    ASSERT_NE(nullptr, set.find(2));
+    EXPECT_EQ("zwei", *set.find(2));
+    EXPECT_EQ("", *set.find(3));
+
+    EXPECT_TRUE(set.remove(1));
+    EXPECT_EQ(nullptr, set.find(1));
+    EXPECT_EQ("zwei", *set.find(2));
+    EXPECT_EQ(set.getIndex(3), static_cast<uint32_t>(set.find(3) - set.getValues()));
+}
+
+TEST_F(TSparseSetTest, randomTest) {
+    // Compare against a reference map with ids spread over many pages
+    TSparseSet<uint32_t> set;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::mt19937 random(42);
+    for (uint32_t i = 0; i < 20000; ++i) {
+        const uint32_t id = random() % 200000;
+        if (random() % 3 == 0) {
+            EXPECT_EQ(reference.erase(id) != 0, set.remove(id));
+        } else {
+            EXPECT_EQ(reference.count(id) == 0, set.insert(id, i));
+            reference[id] = i;
+        }
+    }
+
+    ASSERT_EQ(reference.size(), set.size());
+    for (size_t i = 0; i < set.size(); ++i) {
+        const uint32_t id = set.getIds()[i];
+        EXPECT_EQ(i, set.getIndex(id));
+        EXPECT_EQ(reference[id], set.getValues()[i]);
+    }
+}
+
+TEST_F(TSparseSetTest, sortTest) {
+    TSparseSet<int> set;
+    const uint32_t ids[] = { 9, 3, 70000, 1, 42 };
+    for (uint32_t id : ids) {
+        set.insert(id, static_cast<int>(id) * 2);
+    }
+
+    set.sort();
+    std::vector<uint32_t> sorted(set.begin(), set.end());
+    EXPECT_EQ((std::vector<uint32_t>{ 1, 3, 9, 42, 70000 }), sorted);
+    for (size_t i = 0; i < set.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(set.getIds()[i]) * 2, set.getValues()[i]);
+        EXPECT_EQ(i, set.getIndex(set.getIds()[i]));
+    }
+
+    set.sort([](uint32_t a, uint32_t b) {
+        return a > b;
+    });
+    EXPECT_EQ(70000u, set.getIds()[0]);
+    EXPECT_EQ(140000, *set.find(70000));
+
+    // The shared ids come first in the order of the other set
+    TSparseSet<> other;
+    other.insert(42);
+    other.insert(5);
+    other.insert(1);
+    other.insert(9);
+    EXPECT_EQ(3u, set.sortAs(other));
+    EXPECT_EQ(42u, set.getIds()[0]);
+    EXPECT_EQ(1u, set.getIds()[1]);
+    EXPECT_EQ(9u, set.getIds()[2]);
+    EXPECT_EQ(18, set.getValues()[2]);
+    for (size_t i = 0; i < set.size(); ++i) {
+        EXPECT_EQ(i, set.getIndex(set.getIds()[i]));
+    }
+}
@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <string>
+#include <type_traits>
 
 using namespace CPPCore;
 
@@ -41,7 +42,7 @@ class TStaticArrayTest : public testing::Test {
 };
 
 TEST_F(TStaticArrayTest, constructTest) {
-    TStaticArray<int, 4> arr(0);
+    TStaticArray<int, 4> arr = TStaticArray<int, 4>::filled(0);
     EXPECT_EQ(4u, arr.size());
     EXPECT_EQ(0, arr[0]);
     EXPECT_EQ(0, arr[3]);
@@ -94,3 +95,62 @@ TEST_F(TStaticArrayTest, string_Test) {
     }
 }
 
+TEST_F(TStaticArrayTest, constexprTest) {
+    static constexpr TStaticArray<int, 3> values = { 1, 2, 3 };
+    static_assert(3 == values.size());
+    static_assert(6 == values[0] + values[1] + values[2]);
+    static_assert(sizeof(TStaticArray<int, 3>) == 3 * sizeof(int));
+    static_assert(std::is_aggregate_v<TStaticArray<int, 3>>);
+    static_assert(std::is_trivially_copyable_v<TStaticArray<int, 3>>);
+    static_assert(TStaticArray<char, 5>::filled('x') == TStaticArray<char, 5>{ 'x', 'x', 'x', 'x', 'x' });
+
+    constexpr TStaticArray<int, 3> sum = values + values * 2;
+    static_assert(TStaticArray<int, 3>{ 3, 6, 9 } == sum);
+
+    int total = 0;
+    for (int value : values) {
+        total += value;
+    }
+    EXPECT_EQ(6, total);
+}
+
+TEST_F(TStaticArrayTest, compareAndCopyTest) {
+    TStaticArray<int, 100> a = TStaticArray<int, 100>::filled(7);
+    TStaticArray<int, 100> b = a;
+    EXPECT_TRUE(a == b);
+    b[99] = 8;
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a != b);
+    a = b;
+    EXPECT_EQ(8, a[99]);
+    EXPECT_TRUE(a == b);
+
+    // Floats compare by value, not by bytes
+    TStaticArray<float, 2> zeros = { 0.0f, 0.0f };
+    TStaticArray<float, 2> negativeZeros = { -0.0f, 0.0f };
+    EXPECT_TRUE(zeros == negativeZeros);
+
+    TStaticArray<std::string, 2> strings = { "a", "b" };
+    TStaticArray<std::string, 2> copy = strings;
+    EXPECT_TRUE(strings == copy);
+    copy[1] = "c";
+    EXPECT_FALSE(strings == copy);
+
+    TStaticArray<unsigned char, 33> bytes = TStaticArray<unsigned char, 33>::filled(0xab);
+    EXPECT_EQ(0xab, bytes[32]);
+}
+
+TEST_F(TStaticArrayTest, arithmeticTest) {
+    TStaticArray<float, 4> a = { 1.0f, 2.0f, 3.0f, 4.0f };
+    TStaticArray<float, 4> b = { 4.0f, 3.0f, 2.0f, 1.0f };
+    EXPECT_TRUE((TStaticArray<float, 4>{ 5.0f, 5.0f, 5.0f, 5.0f } == a + b));
+    EXPECT_TRUE((TStaticArray<float, 4>{ -3.0f, -1.0f, 1.0f, 3.0f } == a - b));
+    EXPECT_TRUE((TStaticArray<float, 4>{ 4.0f, 6.0f, 6.0f, 4.0f } == a * b));
+    EXPECT_TRUE((TStaticArray<float, 4>{ 0.25f, 2.0f / 3.0f, 1.5f, 4.0f } == a / b));
+
+    // Longer arrays are not unrolled
+    TStaticArray<int, 64> c = TStaticArray<int, 64>::filled(2);
+    c *= 3;
+    c -= TStaticArray<int, 64>::filled(1);
+    EXPECT_TRUE((TStaticArray<int, 64>::filled(5) == c));
+}
@@ -0,0 +1,184 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/CPPCoreCommon.h>
+
+#ifdef CPPCORE_GNU_LINUX
+
+#include <cppcore/IO/AsyncLogger.h>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class AsyncLoggerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/cppcore_logXXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_LE(0, fd);
+        ::close(fd);
+        m_path = path;
+    }
+
+    void TearDown() override {
+        AsyncLogger::close();
+        ::unlink(m_path.c_str());
+    }
+
+    // Returns the messages of the log file without the time, level and thread prefix
+    std::vector<std::string> readMessages() {
+        std::vector<std::string> messages;
+        std::ifstream file(m_path.c_str());
+        std::string line;
+        while (std::getline(file, line)) {
+            const size_t pos = line.find("] ");
+            messages.push_back(std::string::npos == pos ? line : line.substr(pos + 2));
+        }
+        return messages;
+    }
+
+    std::string m_path;
+};
+
+TEST_F(AsyncLoggerTest, formatTest) {
+    EXPECT_EQ(LogLevel::Off, AsyncLogger::getLevel());
+    ASSERT_TRUE(AsyncLogger::open(m_path.c_str()));
+    EXPECT_FALSE(AsyncLogger::open(m_path.c_str()));
+    EXPECT_EQ(LogLevel::Info, AsyncLogger::getLevel());
+
+    const std::string name("reactor");
+    const char *nothing = nullptr;
+    CPPCORE_LOG_INFO("plain message");
+    CPPCORE_LOG_INFO("%d %i %u %x %05.2f %c %%", -42, 7, 42u, 255, 3.14159, 'z');
+    CPPCORE_LOG_WARN("%s: [%8s] [%-4s] %s", name, "ab", "cd", nothing);
+    CPPCORE_LOG_ERROR("%lld %zu %lu %e", static_cast<long long>(-1), static_cast<size_t>(12), 13ul, 1.5);
+    CPPCORE_LOG_INFO("%d %d", 1);
+    CPPCORE_LOG_DEBUG("filtered by the runtime level");
+    AsyncLogger::close();
+    EXPECT_EQ(LogLevel::Off, AsyncLogger::getLevel());
+
+    const std::vector<std::string> messages = readMessages();
+    ASSERT_EQ(5u, messages.size());
+    EXPECT_EQ("plain message", messages[0]);
+    EXPECT_EQ("-42 7 42 ff 03.14 z %", messages[1]);
+    EXPECT_EQ("reactor: [      ab] [cd  ] (null)", messages[2]);
+    EXPECT_EQ("-1 12 13 1.500000e+00", messages[3]);
+    EXPECT_EQ("1 <missing>", messages[4]);
+
+    std::ifstream file(m_path.c_str());
+    std::string line;
+    std::getline(file, line);
+    EXPECT_NE(std::string::npos, line.find(" INFO  [")) << line;
+    EXPECT_EQ('-', line[4]);
+    EXPECT_EQ('.', line[19]);
+}
+
+TEST_F(AsyncLoggerTest, levelTest) {
+    LoggerOptions options;
+    options.m_level = LogLevel::Trace;
+    ASSERT_TRUE(AsyncLogger::open(m_path.c_str(), options));
+    EXPECT_TRUE(AsyncLogger::isEnabled(LogLevel::Trace));
+    CPPCORE_LOG_TRACE("trace %d", 1);
+
+    AsyncLogger::setLevel(LogLevel::Error);
+    EXPECT_FALSE(AsyncLogger::isEnabled(LogLevel::Warn));
+    EXPECT_TRUE(AsyncLogger::isEnabled(LogLevel::Fatal));
+
+    // The arguments of a filtered message are not evaluated
+    int calls = 0;
+    CPPCORE_LOG_WARN("warn %d", ++calls);
+    CPPCORE_LOG_FATAL("fatal %d", ++calls);
+    EXPECT_EQ(1, calls);
+    AsyncLogger::flush();
+
+    const std::vector<std::string> messages = readMessages();
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_EQ("trace 1", messages[0]);
+    EXPECT_EQ("fatal 1", messages[1]);
+}
+
+TEST_F(AsyncLoggerTest, blockingTest) {
+    static const size_t NumThreads = 4;
+    static const int NumMessages = 20000;
+
+    // Tiny rings, the threads have to wait for the background thread all the time
+    LoggerOptions options;
+    options.m_ringSize = 1024;
+    ASSERT_TRUE(AsyncLogger::open(m_path.c_str(), options));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NumThreads; ++t) {
+        threads.push_back(std::thread([t]() {
+            for (int i = 0; i < NumMessages; ++i) {
+                CPPCORE_LOG_INFO("thread %zu message %d", t, i);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    AsyncLogger::close();
+    EXPECT_EQ(0u, AsyncLogger::getNumDropped());
+
+    // No message is lost and the order per thread is kept
+    const std::vector<std::string> messages = readMessages();
+    ASSERT_EQ(NumThreads * NumMessages, messages.size());
+    std::vector<int> next(NumThreads, 0);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        size_t thread = 0;
+        int message = 0;
+        ASSERT_EQ(2, ::sscanf(messages[i].c_str(), "thread %zu message %d", &thread, &message));
+        ASSERT_LT(thread, NumThreads);
+        EXPECT_EQ(next[thread], message);
+        next[thread] = message + 1;
+    }
+}
+
+TEST_F(AsyncLoggerTest, dropTest) {
+    static const int NumMessages = 10000;
+
+    LoggerOptions options;
+    options.m_ringSize = 1024;
+    options.m_policy = LogFullPolicy::Drop;
+    options.m_flushIntervalMs = 1000;
+    ASSERT_TRUE(AsyncLogger::open(m_path.c_str(), options));
+    std::thread producer([]() {
+        for (int i = 0; i < NumMessages; ++i) {
+            CPPCORE_LOG_INFO("message %d with some payload to fill the ring", i);
+        }
+    });
+    producer.join();
+    AsyncLogger::close();
+
+    const std::vector<std::string> messages = readMessages();
+    EXPECT_LT(0u, AsyncLogger::getNumDropped());
+    EXPECT_EQ(static_cast<uint64_t>(NumMessages), messages.size() + AsyncLogger::getNumDropped());
+}
+
+#endif // CPPCORE_GNU_LINUX
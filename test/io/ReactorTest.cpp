@@ -0,0 +1,330 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/CPPCoreCommon.h>
+
+#ifdef CPPCORE_GNU_LINUX
+
+#include <cppcore/IO/DatagramBatch.h>
+#include <cppcore/IO/Reactor.h>
+#include <cppcore/IO/Socket.h>
+
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class ReactorTest : public testing::Test {
+protected:
+    // Runs the loop until the condition holds or the time is up
+    template <class Func>
+    static bool runUntil(Reactor &reactor, Func condition, int maxMs = 5000) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxMs);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            reactor.runOnce(10);
+        }
+        return true;
+    }
+
+    // Reads until EAGAIN, as required by edge-triggered events
+    static std::string readAll(int fd) {
+        std::string result;
+        char buffer[256];
+        for (;;) {
+            const ssize_t numRead = ::read(fd, buffer, sizeof(buffer));
+            if (numRead <= 0) {
+                break;
+            }
+            result.append(buffer, static_cast<size_t>(numRead));
+        }
+        return result;
+    }
+};
+
+TEST_F(ReactorTest, createTest) {
+    Reactor reactor;
+    EXPECT_TRUE(reactor.isValid());
+    EXPECT_FALSE(reactor.isInLoopThread());
+    EXPECT_EQ(0u, reactor.runOnce(0));
+    EXPECT_TRUE(reactor.isInLoopThread());
+}
+
+TEST_F(ReactorTest, unixSocketTest) {
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+
+    Reactor reactor;
+    std::string received;
+    bool closed = false;
+    ASSERT_TRUE(reactor.add(fds[0], Reactor::Readable, [&](uint32_t events) {
+        if (0 != (events & Reactor::Readable)) {
+            received += readAll(fds[0]);
+        }
+        if (0 != (events & Reactor::Closed)) {
+            closed = true;
+            reactor.remove(fds[0]);
+        }
+    }));
+    EXPECT_FALSE(reactor.add(fds[0], Reactor::Readable, [](uint32_t) {}));
+
+    ASSERT_EQ(5, ::write(fds[1], "hello", 5));
+    ASSERT_EQ(6, ::write(fds[1], " world", 6));
+    EXPECT_TRUE(runUntil(reactor, [&]() { return 11 == received.size(); }));
+    EXPECT_EQ("hello world", received);
+
+    ::close(fds[1]);
+    EXPECT_TRUE(runUntil(reactor, [&]() { return closed; }));
+    EXPECT_FALSE(reactor.remove(fds[0]));
+    ::close(fds[0]);
+}
+
+TEST_F(ReactorTest, writableTest) {
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+
+    Reactor reactor;
+    size_t numWritable = 0;
+    ASSERT_TRUE(reactor.add(fds[0], Reactor::Readable, [&](uint32_t events) {
+        if (0 != (events & Reactor::Writable)) {
+            ++numWritable;
+        }
+    }));
+    reactor.runOnce(0);
+    EXPECT_EQ(0u, numWritable);
+
+    ASSERT_TRUE(reactor.modify(fds[0], Reactor::Readable | Reactor::Writable));
+    EXPECT_TRUE(runUntil(reactor, [&]() { return 0 != numWritable; }));
+    EXPECT_TRUE(reactor.remove(fds[0]));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_F(ReactorTest, postTest) {
+    Reactor reactor;
+    std::atomic<size_t> numRun(0);
+    std::atomic<bool> wrongThread(false);
+    reactor.runOnce(0);
+
+    static const size_t NumThreads = 4;
+    static const size_t NumTasks = 1000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NumThreads; ++t) {
+        threads.push_back(std::thread([&]() {
+            for (size_t i = 0; i < NumTasks; ++i) {
+                reactor.post([&]() {
+                    if (!reactor.isInLoopThread()) {
+                        wrongThread = true;
+                    }
+                    ++numRun;
+                });
+            }
+        }));
+    }
+    EXPECT_TRUE(runUntil(reactor, [&]() { return NumThreads * NumTasks == numRun.load(); }));
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    EXPECT_FALSE(wrongThread.load());
+}
+
+TEST_F(ReactorTest, timerTest) {
+    Reactor reactor;
+    std::vector<int> order;
+    reactor.runAfter(30, [&]() { order.push_back(30); });
+    reactor.runAfter(10, [&]() { order.push_back(10); });
+    Reactor::TimerHandle cancelled = reactor.runAfter(20, [&]() { order.push_back(20); });
+    EXPECT_TRUE(reactor.cancel(cancelled));
+
+    const uint64_t start = reactor.getNow();
+    EXPECT_TRUE(runUntil(reactor, [&]() { return 2 == order.size(); }));
+    EXPECT_LE(start + 30, reactor.getNow());
+    const std::vector<int> expected = { 10, 30 };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(ReactorTest, tcpEchoTest) {
+    Reactor reactor;
+    const int listener = Socket::openTcpListener("127.0.0.1", 0, false);
+    ASSERT_LE(0, listener);
+    const uint16_t port = Socket::getLocalPort(listener);
+    ASSERT_NE(0, port);
+
+    std::vector<int> connections;
+    ASSERT_TRUE(reactor.add(listener, Reactor::Readable, [&](uint32_t) {
+        for (int fd = Socket::accept(listener); fd >= 0; fd = Socket::accept(listener)) {
+            connections.push_back(fd);
+            reactor.add(fd, Reactor::Readable, [&reactor, fd](uint32_t events) {
+                const std::string data = readAll(fd);
+                if (!data.empty()) {
+                    EXPECT_EQ(static_cast<ssize_t>(data.size()), ::write(fd, data.data(), data.size()));
+                }
+                if (0 != (events & Reactor::Closed)) {
+                    reactor.remove(fd);
+                }
+            });
+        }
+    }));
+
+    const int client = Socket::connectTcp("127.0.0.1", port);
+    ASSERT_LE(0, client);
+    EXPECT_TRUE(Socket::setNoDelay(client));
+    ASSERT_EQ(4, ::write(client, "ping", 4));
+
+    std::string reply;
+    EXPECT_TRUE(runUntil(reactor, [&]() {
+        reply += readAll(client);
+        return 4 == reply.size();
+    }));
+    EXPECT_EQ("ping", reply);
+
+    Socket::close(client);
+    for (size_t i = 0; i < connections.size(); ++i) {
+        reactor.remove(connections[i]);
+        Socket::close(connections[i]);
+    }
+    reactor.remove(listener);
+    Socket::close(listener);
+}
+
+TEST_F(ReactorTest, datagramBatchTest) {
+    const int server = Socket::openUdp("127.0.0.1", 0, false);
+    const int client = Socket::openUdp("127.0.0.1", 0, false);
+    ASSERT_LE(0, server);
+    ASSERT_LE(0, client);
+    ASSERT_TRUE(Socket::connectUdp(client, "127.0.0.1", Socket::getLocalPort(server)));
+
+    DatagramBatch out(8, 64);
+    for (size_t i = 0; i < 8; ++i) {
+        const std::string text = "message " + std::to_string(i);
+        ::memcpy(out.getData(i), text.data(), text.size());
+        out.setSize(i, text.size());
+    }
+    EXPECT_EQ(8, out.send(client, 8));
+
+    // Echo the batch back to the senders
+    Reactor reactor;
+    DatagramBatch batch(4, 64);
+    size_t numEchoed = 0;
+    ASSERT_TRUE(reactor.add(server, Reactor::Readable, [&](uint32_t) {
+        for (int count = batch.receive(server); count > 0; count = batch.receive(server)) {
+            EXPECT_EQ(count, batch.send(server, static_cast<size_t>(count)));
+            numEchoed += static_cast<size_t>(count);
+        }
+    }));
+    EXPECT_TRUE(runUntil(reactor, [&]() { return 8 == numEchoed; }));
+
+    DatagramBatch in(16, 64);
+    size_t numReceived = 0;
+    for (int round = 0; round < 100 && numReceived < 8; ++round) {
+        const int count = in.receive(client);
+        ASSERT_LE(0, count);
+        for (int i = 0; i < count; ++i) {
+            const std::string text(in.getData(i), in.getSize(i));
+            EXPECT_EQ("message " + std::to_string(numReceived), text);
+            ++numReceived;
+        }
+        if (0 == count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_EQ(8u, numReceived);
+
+    reactor.remove(server);
+    Socket::close(server);
+    Socket::close(client);
+}
+
+TEST_F(ReactorTest, reactorGroupTest) {
+    static const size_t NumLoops = 3;
+    ReactorGroup group(NumLoops);
+    EXPECT_EQ(NumLoops, group.getNumLoops());
+
+    // One SO_REUSEPORT socket per loop on the same port
+    const int first = Socket::openUdp("127.0.0.1", 0, true);
+    ASSERT_LE(0, first);
+    const uint16_t port = Socket::getLocalPort(first);
+    std::vector<int> sockets = { first };
+    for (size_t i = 1; i < NumLoops; ++i) {
+        const int fd = Socket::openUdp("127.0.0.1", port, true);
+        ASSERT_LE(0, fd);
+        sockets.push_back(fd);
+    }
+    const int blocked = Socket::openUdp("127.0.0.1", port, false);
+    EXPECT_EQ(-1, blocked);
+
+    std::atomic<size_t> numReceived(0);
+    std::atomic<size_t> numAdded(0);
+    for (size_t i = 0; i < NumLoops; ++i) {
+        Reactor &reactor = group.getReactor(i);
+        const int fd = sockets[i];
+        reactor.post([&reactor, fd, &numReceived, &numAdded]() {
+            reactor.add(fd, Reactor::Readable, [fd, &numReceived](uint32_t) {
+                char buffer[64];
+                while (::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+                    ++numReceived;
+                }
+            });
+            ++numAdded;
+        });
+    }
+    while (numAdded.load() < NumLoops) {
+        std::this_thread::yield();
+    }
+
+    // Different source ports are spread over the sockets by the kernel
+    static const size_t NumClients = 16;
+    std::vector<int> clients;
+    for (size_t i = 0; i < NumClients; ++i) {
+        const int client = Socket::openUdp("127.0.0.1", 0, false);
+        ASSERT_LE(0, client);
+        ASSERT_TRUE(Socket::connectUdp(client, "127.0.0.1", port));
+        ASSERT_EQ(1, ::send(client, "x", 1, 0));
+        clients.push_back(client);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (numReceived.load() < NumClients && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(NumClients, numReceived.load());
+
+    group.stop();
+    for (size_t i = 0; i < clients.size(); ++i) {
+        Socket::close(clients[i]);
+    }
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        Socket::close(sockets[i]);
+    }
+}
+
+#endif // CPPCORE_GNU_LINUX
@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Memory/TConcurrentObjectPool.h>
+#include <cppcore/Threading/TBoundedQueue.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TConcurrentObjectPoolTest : public testing::Test {
+    // empty
+};
+
+namespace {
+
+struct Tracked {
+    static std::atomic<int> s_alive;
+    int m_value;
+
+    explicit Tracked(int value) :
+            m_value(value) {
+        s_alive.fetch_add(1);
+    }
+
+    ~Tracked() {
+        s_alive.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Tracked::s_alive(0);
+
+struct alignas(64) Aligned {
+    char m_data[100];
+};
+
+} // Namespace
+
+TEST_F(TConcurrentObjectPoolTest, createDestroyTest) {
+    TConcurrentObjectPool<Tracked> pool(64);
+    EXPECT_EQ(0u, pool.capacity());
+
+    std::set<Tracked*> objects;
+    for (int i = 0; i < 200; ++i) {
+        Tracked *object = pool.create(i);
+        EXPECT_EQ(i, object->m_value);
+        EXPECT_TRUE(objects.insert(object).second);
+    }
+    EXPECT_EQ(200, Tracked::s_alive.load());
+    EXPECT_LE(200u, pool.capacity());
+
+    const size_t capacity = pool.capacity();
+    for (std::set<Tracked*>::iterator it = objects.begin(); it != objects.end(); ++it) {
+        pool.destroy(*it);
+    }
+    EXPECT_EQ(0, Tracked::s_alive.load());
+
+    // The storage is reused
+    for (int i = 0; i < 200; ++i) {
+        pool.destroy(pool.create(i));
+    }
+    EXPECT_EQ(capacity, pool.capacity());
+
+    TConcurrentObjectPool<Aligned> alignedPool;
+    for (int i = 0; i < 10; ++i) {
+        Aligned *object = alignedPool.create();
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(object) % 64);
+        alignedPool.destroy(object);
+    }
+}
+
+TEST_F(TConcurrentObjectPoolTest, handleTest) {
+    TConcurrentObjectPool<Tracked> pool;
+    {
+        TConcurrentObjectPool<Tracked>::Handle handle = pool.acquire(42);
+        ASSERT_TRUE(handle);
+        EXPECT_EQ(42, handle->m_value);
+        EXPECT_EQ(1, Tracked::s_alive.load());
+
+        TConcurrentObjectPool<Tracked>::Handle other(std::move(handle));
+        EXPECT_FALSE(handle);
+        EXPECT_EQ(42, (*other).m_value);
+
+        other = pool.acquire(43);
+        EXPECT_EQ(1, Tracked::s_alive.load());
+        EXPECT_EQ(43, other.get()->m_value);
+
+        Tracked *object = other.release();
+        EXPECT_FALSE(other);
+        pool.destroy(object);
+        EXPECT_EQ(0, Tracked::s_alive.load());
+
+        other = pool.acquire(44);
+    }
+    EXPECT_EQ(0, Tracked::s_alive.load());
+}
+
+TEST_F(TConcurrentObjectPoolTest, crossThreadTest) {
+    static const size_t NumPairs = 2;
+    static const int NumObjects = 50000;
+
+    // Producers create the objects, consumers check and destroy them
+    TConcurrentObjectPool<Tracked> pool(256);
+    std::vector<std::thread> threads;
+    std::atomic<long> sum(0);
+    std::vector<TBoundedQueue<Tracked*>*> queues;
+    for (size_t p = 0; p < NumPairs; ++p) {
+        queues.push_back(new TBoundedQueue<Tracked*>(128));
+    }
+    for (size_t p = 0; p < NumPairs; ++p) {
+        TBoundedQueue<Tracked*> *queue = queues[p];
+        threads.push_back(std::thread([&pool, queue]() {
+            for (int i = 0; i < NumObjects; ++i) {
+                Tracked *object = pool.create(i);
+                while (!queue->tryPush(object)) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+        threads.push_back(std::thread([&pool, &sum, queue]() {
+            for (int i = 0; i < NumObjects; ++i) {
+                Tracked *object = nullptr;
+                while (!queue->tryPop(object)) {
+                    std::this_thread::yield();
+                }
+                EXPECT_EQ(i, object->m_value);
+                sum.fetch_add(object->m_value);
+                pool.destroy(object);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    for (size_t p = 0; p < NumPairs; ++p) {
+        delete queues[p];
+    }
+
+    EXPECT_EQ(0, Tracked::s_alive.load());
+    EXPECT_EQ(static_cast<long>(NumPairs) * NumObjects * (NumObjects - 1) / 2, sum.load());
+
+    // The slots came back when the threads exited, so no new chunks are needed
+    const size_t capacity = pool.capacity();
+    std::vector<Tracked*> objects;
+    for (size_t i = 0; i < capacity; ++i) {
+        objects.push_back(pool.create(0));
+    }
+    EXPECT_EQ(capacity, pool.capacity());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        pool.destroy(objects[i]);
+    }
+}
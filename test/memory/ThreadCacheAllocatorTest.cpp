@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Memory/ThreadCacheAllocator.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class ThreadCacheAllocatorTest : public testing::Test {
+protected:
+    void SetUp() override {
+        ThreadCacheAllocator::resetThreadStats();
+    }
+};
+
+TEST_F(ThreadCacheAllocatorTest, reuseTest) {
+    void *first = ThreadCacheAllocator::allocate(40);
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % ThreadCacheAllocator::Granularity);
+    ::memset(first, 0xab, 40);
+    ThreadCacheAllocator::deallocate(first, 40);
+
+    // The same size class hands the block out again
+    void *second = ThreadCacheAllocator::allocate(48);
+    EXPECT_EQ(first, second);
+    ThreadCacheAllocator::deallocate(second, 48);
+
+    const ThreadCacheAllocator::Stats stats = ThreadCacheAllocator::getThreadStats();
+    EXPECT_EQ(2u, stats.m_numAllocations);
+    EXPECT_GE(1u, stats.m_numHeapAllocations);
+}
+
+TEST_F(ThreadCacheAllocatorTest, largeTest) {
+    void *block = ThreadCacheAllocator::allocate(ThreadCacheAllocator::MaxCachedSize + 1);
+    ASSERT_NE(nullptr, block);
+    ::memset(block, 0, ThreadCacheAllocator::MaxCachedSize + 1);
+    ThreadCacheAllocator::deallocate(block, ThreadCacheAllocator::MaxCachedSize + 1);
+    EXPECT_EQ(1u, ThreadCacheAllocator::getThreadStats().m_numHeapAllocations);
+}
+
+TEST_F(ThreadCacheAllocatorTest, crossThreadTest) {
+    static const size_t NumBlocks = 1000;
+    static const size_t Size = 200;
+
+    // Allocated here, freed on another thread, picked up from the depot by a third one
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < NumBlocks; ++i) {
+        blocks.push_back(ThreadCacheAllocator::allocate(Size));
+    }
+    std::thread releaser([&blocks]() {
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            ThreadCacheAllocator::deallocate(blocks[i], Size);
+        }
+        EXPECT_LT(0u, ThreadCacheAllocator::getThreadStats().m_numDepotTransfers);
+    });
+    releaser.join();
+
+    std::thread user([]() {
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < NumBlocks; ++i) {
+            blocks.push_back(ThreadCacheAllocator::allocate(Size));
+        }
+        const ThreadCacheAllocator::Stats stats = ThreadCacheAllocator::getThreadStats();
+        EXPECT_EQ(NumBlocks, stats.m_numAllocations);
+        EXPECT_LT(stats.m_numHeapAllocations, NumBlocks / 2);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            ThreadCacheAllocator::deallocate(blocks[i], Size);
+        }
+    });
+    user.join();
+}
@@ -0,0 +1,192 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Parallel/ParallelAlgorithms.h>
+#include <cppcore/Container/TArray.h>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+using namespace CPPCore;
+
+class ParallelAlgorithmsTest : public testing::Test {
+protected:
+    void SetUp() override {
+        m_scheduler = new TaskScheduler(4);
+    }
+
+    void TearDown() override {
+        delete m_scheduler;
+        m_scheduler = nullptr;
+    }
+
+    static void fill(TArray<int> &array, size_t size) {
+        array.resize(size);
+        unsigned int state = 12345;
+        for (size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            array[i] = static_cast<int>((state >> 8) % 10000) - 5000;
+        }
+    }
+
+    TaskScheduler *m_scheduler = nullptr;
+};
+
+TEST_F(ParallelAlgorithmsTest, parallelForTest) {
+    static const size_t Size = 10007;
+    TArray<int> array;
+    array.resize(Size, 0);
+    parallelFor(0, Size, [&array](size_t i) { array[i] += static_cast<int>(i); }, 100, m_scheduler);
+    for (size_t i = 0; i < Size; ++i) {
+        ASSERT_EQ(static_cast<int>(i), array[i]);
+    }
+
+    // Empty and reversed ranges do nothing
+    size_t calls = 0;
+    parallelFor(10, 10, [&calls](size_t) { ++calls; }, 1, m_scheduler);
+    parallelFor(10, 5, [&calls](size_t) { ++calls; }, 1, m_scheduler);
+    EXPECT_EQ(0u, calls);
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelForRangeTest) {
+    std::atomic<size_t> numChunks(0);
+    std::atomic<size_t> numIndices(0);
+    parallelForRange(5, 1005, [&](size_t begin, size_t end) {
+        EXPECT_EQ(0u, (begin - 5) % 64);
+        EXPECT_LE(end - begin, 64u);
+        numChunks.fetch_add(1);
+        numIndices.fetch_add(end - begin);
+    }, 64, m_scheduler);
+    EXPECT_EQ(16u, numChunks.load());
+    EXPECT_EQ(1000u, numIndices.load());
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelReduceTest) {
+    TArray<int> array;
+    fill(array, 100000);
+    const long long expected = std::accumulate(array.begin(), array.end(), 0ll);
+    const long long sum = parallelReduce(size_t(0), array.size(), 0ll,
+            [&array](size_t begin, size_t end, long long value) {
+                for (size_t i = begin; i < end; ++i) {
+                    value += array[i];
+                }
+                return value;
+            },
+            std::plus<long long>(), 1000, m_scheduler);
+    EXPECT_EQ(expected, sum);
+
+    const int maxValue = parallelReduce(array.begin(), array.end(), -100000,
+            [](int a, int b) { return std::max(a, b); }, 1000, m_scheduler);
+    EXPECT_EQ(*std::max_element(array.begin(), array.end()), maxValue);
+
+    const int *empty = nullptr;
+    EXPECT_EQ(42, parallelReduce(empty, empty, 42));
+}
+
+TEST_F(ParallelAlgorithmsTest, deterministicReduceTest) {
+    TArray<float> array;
+    array.resize(100000);
+    for (size_t i = 0; i < array.size(); ++i) {
+        array[i] = 1.0f / static_cast<float>(i + 1);
+    }
+
+    // The same chunking gives bit-identical sums for any number of threads
+    const float reference = parallelReduce(array.begin(), array.end(), 0.0f, std::plus<float>(), 333, m_scheduler);
+    for (size_t numThreads = 1; numThreads <= 3; ++numThreads) {
+        TaskScheduler scheduler(numThreads);
+        for (size_t run = 0; run < 5; ++run) {
+            EXPECT_EQ(reference, parallelReduce(array.begin(), array.end(), 0.0f, std::plus<float>(), 333, &scheduler));
+        }
+    }
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelInclusiveScanTest) {
+    TArray<int> array;
+    fill(array, 54321);
+    std::vector<int> expected(array.size());
+    std::partial_sum(array.begin(), array.end(), expected.begin());
+
+    TArray<int> result;
+    result.resize(array.size());
+    int *end = parallelInclusiveScan(array.begin(), array.end(), result.begin(), std::plus<int>(), 500, m_scheduler);
+    EXPECT_EQ(result.end(), end);
+    for (size_t i = 0; i < array.size(); ++i) {
+        ASSERT_EQ(expected[i], result[i]);
+    }
+
+    // In place
+    parallelInclusiveScan(array.begin(), array.end(), array.begin(), std::plus<int>(), 777, m_scheduler);
+    for (size_t i = 0; i < array.size(); ++i) {
+        ASSERT_EQ(expected[i], array[i]);
+    }
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelTransformTest) {
+    TArray<int> array;
+    fill(array, 30000);
+    TArray<double> result;
+    result.resize(array.size());
+    parallelTransform(array.begin(), array.end(), result.begin(), [](int value) { return value * 0.5; }, 1000, m_scheduler);
+    for (size_t i = 0; i < array.size(); ++i) {
+        ASSERT_EQ(array[i] * 0.5, result[i]);
+    }
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelCopyIfTest) {
+    TArray<int> array;
+    fill(array, 40000);
+    std::vector<int> expected;
+    std::copy_if(array.begin(), array.end(), std::back_inserter(expected), [](int value) { return value > 1000; });
+
+    TArray<int> result;
+    result.resize(array.size());
+    int *end = parallelCopyIf(array.begin(), array.end(), result.begin(), [](int value) { return value > 1000; }, 999, m_scheduler);
+    ASSERT_EQ(expected.size(), static_cast<size_t>(end - result.begin()));
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i], result[i]);
+    }
+}
+
+TEST_F(ParallelAlgorithmsTest, parallelSortTest) {
+    const size_t sizes[] = { 0, 1, 100, 1000, 4097, 65536, 100003 };
+    for (size_t s = 0; s < CPPCORE_ARRAY_SIZE(sizes); ++s) {
+        TArray<int> array;
+        fill(array, sizes[s]);
+        std::vector<int> expected(array.begin(), array.end());
+        std::sort(expected.begin(), expected.end());
+
+        parallelSort(array.begin(), array.end(), std::less<int>(), 1024, m_scheduler);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i], array[i]);
+        }
+    }
+
+    // Descending with many duplicates
+    TArray<int> array;
+    array.resize(50000);
+    for (size_t i = 0; i < array.size(); ++i) {
+        array[i] = static_cast<int>(i % 17);
+    }
+    parallelSort(array.begin(), array.end(), std::greater<int>(), 300, m_scheduler);
+    EXPECT_TRUE(std::is_sorted(array.begin(), array.end(), std::greater<int>()));
+}
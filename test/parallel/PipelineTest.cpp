@@ -0,0 +1,306 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Parallel/Pipeline.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+namespace {
+
+// Counts the living items, so dropped batches which are not freed show up
+struct Tracked {
+    static std::atomic<int> s_numAlive;
+
+    size_t m_value;
+
+    Tracked(size_t value = 0) :
+            m_value(value) {
+        ++s_numAlive;
+    }
+
+    Tracked(const Tracked &rhs) :
+            m_value(rhs.m_value) {
+        ++s_numAlive;
+    }
+
+    Tracked &operator = (const Tracked &rhs) = default;
+
+    ~Tracked() {
+        --s_numAlive;
+    }
+};
+
+std::atomic<int> Tracked::s_numAlive(0);
+
+} // Namespace
+
+class PipelineTest : public testing::Test {
+protected:
+    // A source which produces the numbers [0, count)
+    static std::function<bool(size_t&)> counter(size_t count) {
+        std::shared_ptr<size_t> next = std::make_shared<size_t>(0);
+        return [next, count](size_t &item) {
+            if (*next == count) {
+                return false;
+            }
+            item = (*next)++;
+            return true;
+        };
+    }
+};
+
+TEST_F(PipelineTest, chainTest) {
+    static const size_t Count = 10000;
+
+    Pipeline pipeline;
+    uint64_t sum = 0;
+    size_t numItems = 0;
+    pipeline.source<size_t>("source", counter(Count))
+            .then("square", 2, [](size_t &&value) { return static_cast<uint64_t>(value) * value; })
+            .filter("even", 2, [](const uint64_t &value) { return 0 == value % 2; })
+            .then("text", 1, [](uint64_t &&value) { return std::to_string(value); })
+            .sink("sum", 1, [&sum, &numItems](std::string &&text) {
+                sum += std::stoull(text);
+                ++numItems;
+            });
+    pipeline.run();
+    EXPECT_FALSE(pipeline.isCancelled());
+
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < Count; i += 2) {
+        expected += i * i;
+    }
+    EXPECT_EQ(expected, sum);
+    EXPECT_EQ(Count / 2, numItems);
+
+    std::vector<PipelineStageStats> stats;
+    pipeline.getStats(stats);
+    ASSERT_EQ(5u, stats.size());
+    EXPECT_EQ("source", stats[0].m_name);
+    EXPECT_EQ(Count, stats[0].m_numItems);
+    EXPECT_EQ(0u, stats[0].m_queueCapacity);
+    EXPECT_EQ(2u, stats[1].m_parallelism);
+    EXPECT_EQ(Count, stats[1].m_numItems);
+    EXPECT_EQ(Count, stats[2].m_numItems);
+    EXPECT_EQ(Count / 2, stats[3].m_numItems);
+    EXPECT_EQ(Count / 2, stats[4].m_numItems);
+    EXPECT_EQ(16u, stats[4].m_queueCapacity);
+    EXPECT_LE(stats[4].m_maxQueueSize, 16u);
+
+    std::string report;
+    pipeline.report(report);
+    EXPECT_NE(std::string::npos, report.find("square"));
+    EXPECT_NE(std::string::npos, report.find("sum"));
+}
+
+TEST_F(PipelineTest, orderedTest) {
+    static const size_t Count = 20000;
+
+    PipelineOptions options;
+    options.m_ordered = true;
+    options.m_batchSize = 7;
+    Pipeline pipeline(options);
+    std::vector<size_t> received;
+    pipeline.source<size_t>("source", counter(Count))
+            .then("work", 4, [](size_t &&value) {
+                // Uneven work, so the batches overtake each other
+                if (0 == value % 97) {
+                    std::this_thread::yield();
+                }
+                return value;
+            })
+            .filter("drop", 3, [](const size_t &value) { return 0 != value % 5; })
+            .sink("collect", 4, [&received](size_t &&value) { received.push_back(value); });
+    pipeline.run();
+
+    ASSERT_EQ(Count - Count / 5, received.size());
+    size_t expected = 0;
+    for (size_t i = 0; i < received.size(); ++i, ++expected) {
+        if (0 == expected % 5) {
+            ++expected;
+        }
+        ASSERT_EQ(expected, received[i]);
+    }
+}
+
+TEST_F(PipelineTest, orderedWindowTest) {
+    PipelineOptions options;
+    options.m_ordered = true;
+    options.m_queueCapacity = 4;
+    options.m_batchSize = 1;
+    Pipeline pipeline(options);
+
+    std::atomic<size_t> produced(0);
+    size_t producedWhileStalled = 0;
+    std::vector<size_t> received;
+    pipeline.source<size_t>("source", [&produced](size_t &item) {
+                item = produced.fetch_add(1);
+                return item < 200;
+            })
+            .then("stall", 2, [&produced, &producedWhileStalled](size_t &&value) {
+                if (0 == value) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    producedWhileStalled = produced.load();
+                }
+                return value;
+            })
+            .sink("collect", 1, [&received](size_t &&value) { received.push_back(value); });
+    pipeline.run();
+
+    // The first batch holds back the sink, the source must not run more than the window ahead
+    EXPECT_LE(producedWhileStalled, 4u);
+    ASSERT_EQ(200u, received.size());
+    for (size_t i = 0; i < received.size(); ++i) {
+        ASSERT_EQ(i, received[i]);
+    }
+}
+
+TEST_F(PipelineTest, unorderedParallelSinkTest) {
+    static const size_t Count = 10000;
+
+    Pipeline pipeline;
+    std::mutex mutex;
+    std::vector<size_t> received;
+    pipeline.source<size_t>("source", counter(Count))
+            .sink("collect", 3, [&mutex, &received](size_t &&value) {
+                std::lock_guard<std::mutex> lock(mutex);
+                received.push_back(value);
+            });
+    pipeline.run();
+
+    ASSERT_EQ(Count, received.size());
+    std::sort(received.begin(), received.end());
+    for (size_t i = 0; i < Count; ++i) {
+        EXPECT_EQ(i, received[i]);
+    }
+}
+
+TEST_F(PipelineTest, backpressureTest) {
+    PipelineOptions options;
+    options.m_queueCapacity = 2;
+    options.m_batchSize = 1;
+    Pipeline pipeline(options);
+
+    std::atomic<size_t> produced(0);
+    size_t maxInFlight = 0;
+    size_t consumed = 0;
+    pipeline.source<size_t>("source", [&produced](size_t &item) {
+                item = produced.fetch_add(1);
+                return item < 2000;
+            })
+            .sink("slow", 1, [&produced, &maxInFlight, &consumed](size_t &&) {
+                ++consumed;
+                maxInFlight = std::max(maxInFlight, produced.load() - consumed);
+                if (0 == consumed % 100) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+    pipeline.run();
+
+    // The queue, the batch of the sink and the one the source is working on
+    EXPECT_EQ(2000u, consumed);
+    EXPECT_LE(maxInFlight, 4u);
+}
+
+TEST_F(PipelineTest, cancelTest) {
+    Pipeline pipeline;
+    std::atomic<size_t> consumed(0);
+    pipeline.source<size_t>("endless", [](size_t &item) {
+                item = 1;
+                return true;
+            })
+            .then("pass", 2, [](size_t &&value) { return value; })
+            .sink("count", 1, [&consumed](size_t &&value) { consumed.fetch_add(value); });
+    pipeline.start();
+    while (consumed.load() < 10000) {
+        std::this_thread::yield();
+    }
+    pipeline.cancel();
+    pipeline.wait();
+    EXPECT_TRUE(pipeline.isCancelled());
+    EXPECT_LE(10000u, consumed.load());
+}
+
+TEST_F(PipelineTest, exceptionTest) {
+    Pipeline pipeline;
+    pipeline.source<size_t>("source", counter(1000000))
+            .then("fail", 2, [](size_t &&value) {
+                if (500 == value) {
+                    throw std::runtime_error("bad record");
+                }
+                return value;
+            })
+            .sink("drop", 1, [](size_t &&) {});
+    EXPECT_THROW(pipeline.run(), std::runtime_error);
+    EXPECT_TRUE(pipeline.isCancelled());
+}
+
+TEST_F(PipelineTest, throwingStageTest) {
+    // Every stage may throw, the pipeline is cancelled and no batch in flight is leaked
+    for (size_t failing = 0; failing < 4; ++failing) {
+        {
+            PipelineOptions options;
+            options.m_ordered = true;
+            options.m_batchSize = 8;
+            Pipeline pipeline(options);
+            size_t next = 0;
+            pipeline.source<Tracked>("source", [&next, failing](Tracked &item) {
+                        if (0 == failing && 300 == next) {
+                            throw std::runtime_error("source");
+                        }
+                        item = Tracked(next++);
+                        return next <= 100000;
+                    })
+                    .then("map", 2, [failing](Tracked &&item) {
+                        if (1 == failing && 300 == item.m_value) {
+                            throw std::runtime_error("map");
+                        }
+                        return item;
+                    })
+                    .filter("keep", 2, [failing](const Tracked &item) {
+                        if (2 == failing && 300 == item.m_value) {
+                            throw std::runtime_error("keep");
+                        }
+                        return true;
+                    })
+                    .sink("drop", 1, [failing](Tracked &&item) {
+                        if (3 == failing && 300 == item.m_value) {
+                            throw std::runtime_error("drop");
+                        }
+                    });
+            EXPECT_THROW(pipeline.run(), std::runtime_error);
+            EXPECT_TRUE(pipeline.isCancelled());
+        }
+        EXPECT_EQ(0, Tracked::s_numAlive.load());
+    }
+}
@@ -0,0 +1,156 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Platform/CpuFeatures.h>
+#include <cppcore/Platform/TCpuDispatch.h>
+#include <cppcore/Platform/VectorKernels.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace CPPCore;
+
+class CpuFeaturesTest : public testing::Test {
+    // empty
+};
+
+TEST_F(CpuFeaturesTest, detectTest) {
+    const IsaLevel detected = CpuFeatures::getDetectedLevel();
+    EXPECT_LE(CpuFeatures::getLevel(), detected);
+    EXPECT_NE(nullptr, CpuFeatures::getBrand());
+
+    // The levels imply their features
+    if (detected >= IsaLevel::Sse42) {
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Sse42));
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Popcnt));
+    }
+    if (detected >= IsaLevel::Avx2) {
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Avx2));
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Fma));
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Bmi2));
+    }
+    if (detected >= IsaLevel::Avx512) {
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Avx512F));
+        EXPECT_TRUE(CpuFeatures::has(CpuFeature::Avx512Bw));
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_TRUE(CpuFeatures::has(CpuFeature::Sse2));
+#endif
+    EXPECT_EQ(CpuFeatures::has(CpuFeature::Avx), 0 != (CpuFeatures::getFeatureMask() & (1u << static_cast<uint32_t>(CpuFeature::Avx))));
+}
+
+TEST_F(CpuFeaturesTest, levelNameTest) {
+    for (size_t i = 0; i < static_cast<size_t>(IsaLevel::NumLevels); ++i) {
+        const IsaLevel level = static_cast<IsaLevel>(i);
+        IsaLevel parsed = IsaLevel::NumLevels;
+        EXPECT_TRUE(CpuFeatures::parseLevel(CpuFeatures::getLevelName(level), parsed));
+        EXPECT_EQ(level, parsed);
+    }
+
+    IsaLevel parsed = IsaLevel::Generic;
+    EXPECT_TRUE(CpuFeatures::parseLevel("AVX2", parsed));
+    EXPECT_EQ(IsaLevel::Avx2, parsed);
+    EXPECT_FALSE(CpuFeatures::parseLevel("avx", parsed));
+    EXPECT_FALSE(CpuFeatures::parseLevel("avx2x", parsed));
+    EXPECT_FALSE(CpuFeatures::parseLevel(nullptr, parsed));
+}
+
+struct TestTable {
+    int m_id;
+};
+
+TEST_F(CpuFeaturesTest, dispatchTest) {
+    static const TestTable generic = { 0 };
+    static const TestTable avx2 = { 2 };
+
+    // Missing levels fall back to the next lower table
+    TCpuDispatch<TestTable> dispatch(&generic, nullptr, &avx2);
+    EXPECT_EQ(0, dispatch.resolve(IsaLevel::Generic).m_id);
+    EXPECT_EQ(0, dispatch.resolve(IsaLevel::Sse42).m_id);
+    const int expected = CpuFeatures::getDetectedLevel() >= IsaLevel::Avx2 ? 2 : 0;
+    EXPECT_EQ(expected, dispatch.resolve(IsaLevel::Avx512).m_id);
+    EXPECT_LE(dispatch.getLevel(), CpuFeatures::getLevel());
+    EXPECT_EQ(&dispatch.get(), &dispatch.resolve(dispatch.getLevel()));
+
+    TCpuDispatch<TestTable> genericOnly(&generic);
+    EXPECT_EQ(IsaLevel::Generic, genericOnly.getLevel());
+    EXPECT_EQ(0, genericOnly.get().m_id);
+}
+
+TEST_F(CpuFeaturesTest, kernelsTest) {
+    // Odd sizes to run the tails as well
+    const size_t count = 1000 + 13;
+    std::vector<float> a(count);
+    std::vector<float> b(count);
+    std::vector<uint8_t> bytes(64 * 300 + 7);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = static_cast<float>(i % 17) * 0.25f - 1.0f;
+        b[i] = static_cast<float>(i % 5) + 0.5f;
+    }
+    a[500] = -3.5f;
+    a[count - 1] = 9.0f;
+    double expectedSum = 0.0;
+    for (float value : a) {
+        expectedSum += value;
+    }
+    size_t numSevens = 0;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>((i * 7) % 11);
+        numSevens += 7 == bytes[i] ? 1 : 0;
+    }
+
+    // Every level must give bit-identical results
+    const VectorKernels::Table &reference = VectorKernels::getTable(IsaLevel::Generic);
+    const float sum = reference.m_sum(a.data(), count);
+    const float dot = reference.m_dot(a.data(), b.data(), count);
+    EXPECT_NEAR(expectedSum, sum, 0.01);
+    EXPECT_EQ(numSevens, reference.m_countByte(bytes.data(), bytes.size(), 7));
+
+    for (size_t i = 0; i <= static_cast<size_t>(CpuFeatures::getDetectedLevel()); ++i) {
+        const VectorKernels::Table &table = VectorKernels::getTable(static_cast<IsaLevel>(i));
+        const float levelSum = table.m_sum(a.data(), count);
+        const float levelDot = table.m_dot(a.data(), b.data(), count);
+        EXPECT_EQ(0, ::memcmp(&sum, &levelSum, sizeof(float))) << CpuFeatures::getLevelName(static_cast<IsaLevel>(i));
+        EXPECT_EQ(0, ::memcmp(&dot, &levelDot, sizeof(float))) << CpuFeatures::getLevelName(static_cast<IsaLevel>(i));
+        EXPECT_EQ(numSevens, table.m_countByte(bytes.data(), bytes.size(), 7));
+        EXPECT_EQ(0u, table.m_countByte(bytes.data(), 0, 7));
+        EXPECT_EQ(0.0f, table.m_sum(a.data(), 0));
+        float min = 0.0f;
+        float max = 0.0f;
+        table.m_minMax(a.data(), count, &min, &max);
+        EXPECT_EQ(-3.5f, min);
+        EXPECT_EQ(9.0f, max);
+        table.m_minMax(a.data(), 0, &min, &max);
+        EXPECT_GT(min, max);
+    }
+
+    EXPECT_EQ(sum, VectorKernels::sum(a.data(), count));
+    EXPECT_EQ(dot, VectorKernels::dot(a.data(), b.data(), count));
+    EXPECT_EQ(numSevens, VectorKernels::countByte(bytes.data(), bytes.size(), 7));
+    float min = 0.0f;
+    float max = 0.0f;
+    VectorKernels::minMax(a.data() + 1, 5, min, max);
+    EXPECT_EQ(-1.0f + 0.25f, min);
+    EXPECT_EQ(-1.0f + 1.25f, max);
+}
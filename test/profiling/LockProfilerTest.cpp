@@ -0,0 +1,166 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/LockProfiler.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace CPPCore;
+
+class LockProfilerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        LockProfiler::reset();
+    }
+
+    static const LockSiteStats *find(const std::vector<LockSiteStats> &stats, const LockSite &site) {
+        for (size_t i = 0; i < stats.size(); ++i) {
+            if (stats[i].m_site == &site) {
+                return &stats[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(LockProfilerTest, bucketIndexTest) {
+    EXPECT_EQ(0u, LockProfiler::bucketIndex(0));
+    EXPECT_EQ(0u, LockProfiler::bucketIndex(1));
+    EXPECT_EQ(1u, LockProfiler::bucketIndex(2));
+    EXPECT_EQ(1u, LockProfiler::bucketIndex(3));
+    EXPECT_EQ(10u, LockProfiler::bucketIndex(1024));
+    EXPECT_EQ(LockSiteStats::NumBuckets - 1, LockProfiler::bucketIndex(~0ull));
+}
+
+TEST_F(LockProfilerTest, uncontendedTest) {
+    static const LockSite site("uncontended", __FILE__, __LINE__);
+    TProfiledLock<std::mutex> mutex;
+    for (size_t i = 0; i < 10; ++i) {
+        mutex.lock(site);
+        mutex.unlock();
+    }
+    EXPECT_TRUE(mutex.try_lock(site));
+    mutex.unlock();
+
+    std::vector<LockSiteStats> stats;
+    LockProfiler::collect(stats);
+    const LockSiteStats *result = find(stats, site);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(11u, result->m_acquisitions);
+    EXPECT_EQ(0u, result->m_contended);
+    EXPECT_EQ(0u, result->m_totalWaitNs);
+
+    uint64_t holds = 0;
+    for (size_t i = 0; i < LockSiteStats::NumBuckets; ++i) {
+        holds += result->m_holdHistogram[i];
+    }
+    EXPECT_EQ(11u, holds);
+}
+
+TEST_F(LockProfilerTest, contendedTest) {
+    static const LockSite site("contended", __FILE__, __LINE__);
+    TProfiledLock<SpinLock> lock;
+    lock.lock(site);
+    std::thread waiter([&lock]() {
+        lock.lock(site);
+        lock.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lock.unlock();
+    waiter.join();
+
+    // The finished thread has been merged into the retired statistics.
+    std::vector<LockSiteStats> stats;
+    LockProfiler::collect(stats);
+    const LockSiteStats *result = find(stats, site);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(2u, result->m_acquisitions);
+    EXPECT_EQ(1u, result->m_contended);
+    EXPECT_LT(1000000u, result->m_totalWaitNs);
+    EXPECT_EQ(result->m_totalWaitNs, result->m_maxWaitNs);
+    EXPECT_LE(10000000u, result->m_maxHoldNs);
+}
+
+TEST_F(LockProfilerTest, sharedTest) {
+    static const LockSite site("shared", __FILE__, __LINE__);
+    TProfiledLock<std::shared_mutex> lock;
+    lock.lock_shared(site);
+    lock.lock_shared(site);
+    lock.unlock_shared();
+    lock.unlock_shared();
+
+    std::vector<LockSiteStats> stats;
+    LockProfiler::collect(stats);
+    const LockSiteStats *result = find(stats, site);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(2u, result->m_acquisitions);
+    uint64_t holds = 0;
+    for (size_t i = 0; i < LockSiteStats::NumBuckets; ++i) {
+        holds += result->m_holdHistogram[i];
+    }
+    EXPECT_EQ(2u, holds);
+}
+
+TEST_F(LockProfilerTest, reportSortedTest) {
+    static const LockSite hot("hot", __FILE__, __LINE__);
+    static const LockSite cold("cold", __FILE__, __LINE__);
+    TProfiledLock<std::mutex> mutex;
+    mutex.lock(cold);
+    mutex.unlock();
+
+    mutex.lock(hot);
+    std::thread waiter([&mutex]() {
+        mutex.lock(hot);
+        mutex.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    mutex.unlock();
+    waiter.join();
+
+    std::vector<LockSiteStats> stats;
+    LockProfiler::collect(stats);
+    ASSERT_LE(2u, stats.size());
+    EXPECT_EQ(&hot, stats[0].m_site);
+
+    std::string report;
+    LockProfiler::report(report);
+    EXPECT_LT(report.find("hot"), report.find("cold"));
+}
+
+TEST_F(LockProfilerTest, guardTest) {
+    ProfiledMutex mutex;
+    ProfiledSharedMutex sharedMutex;
+    int value = 0;
+    {
+        CPPCORE_LOCK_GUARD(mutex);
+        ++value;
+    }
+    {
+        CPPCORE_SHARED_LOCK_GUARD(sharedMutex);
+        ++value;
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_EQ(2, value);
+}
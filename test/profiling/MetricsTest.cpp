@@ -0,0 +1,149 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/Metrics.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace CPPCore;
+
+class MetricsTest : public testing::Test {
+    // empty
+};
+
+TEST_F(MetricsTest, counterTest) {
+    ShardedCounter counter(3);
+    EXPECT_EQ(4u, counter.getNumShards());
+    EXPECT_EQ(0, counter.get());
+
+    counter.increment();
+    counter.add(41);
+    EXPECT_EQ(42, counter.get());
+
+    counter.reset();
+    EXPECT_EQ(0, counter.get());
+
+    ShardedCounter defaultCounter;
+    EXPECT_EQ(0u, defaultCounter.getNumShards() & (defaultCounter.getNumShards() - 1));
+}
+
+TEST_F(MetricsTest, concurrentCounterTest) {
+    static const size_t NumThreads = 8;
+    static const size_t NumIncrements = 100000;
+
+    ShardedCounter counter(2);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NumThreads; ++i) {
+        threads.push_back(std::thread([&counter]() {
+            for (size_t j = 0; j < NumIncrements; ++j) {
+                counter.increment();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(static_cast<int64_t>(NumThreads * NumIncrements), counter.get());
+}
+
+TEST_F(MetricsTest, gaugeTest) {
+    ShardedGauge gauge;
+    gauge.add(10);
+    gauge.decrement();
+    gauge.sub(4);
+    EXPECT_EQ(5, gauge.get());
+
+    std::thread other([&gauge]() {
+        gauge.add(100);
+    });
+    other.join();
+    EXPECT_EQ(105, gauge.get());
+
+    gauge.set(-7);
+    EXPECT_EQ(-7, gauge.get());
+}
+
+TEST_F(MetricsTest, maxTrackerTest) {
+    ShardedMaxTracker tracker;
+    EXPECT_EQ(ShardedMaxTracker::Empty, tracker.get());
+
+    std::vector<std::thread> threads;
+    for (int64_t i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([&tracker, i]() {
+            for (int64_t j = 0; j < 1000; ++j) {
+                tracker.update(j * 4 + i);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    tracker.update(-5);
+    EXPECT_EQ(3999, tracker.get());
+
+    EXPECT_EQ(3999, tracker.getAndReset());
+    EXPECT_EQ(ShardedMaxTracker::Empty, tracker.get());
+    tracker.update(-5);
+    EXPECT_EQ(-5, tracker.get());
+}
+
+TEST_F(MetricsTest, registryTest) {
+    MetricsRegistry registry;
+    ShardedCounter *requests = registry.getCounter("requests_total");
+    ASSERT_NE(nullptr, requests);
+    EXPECT_EQ(requests, registry.getCounter("requests_total"));
+    EXPECT_EQ(nullptr, registry.getGauge("requests_total"));
+    EXPECT_EQ(nullptr, registry.getMaxTracker("requests_total"));
+
+    ShardedGauge *connections = registry.getGauge("connections");
+    ShardedMaxTracker *latency = registry.getMaxTracker("latency_max_ns");
+    ShardedMaxTracker *unused = registry.getMaxTracker("unused_max");
+    ASSERT_NE(nullptr, connections);
+    ASSERT_NE(nullptr, latency);
+    ASSERT_NE(nullptr, unused);
+    EXPECT_EQ(4u, registry.size());
+
+    requests->add(3);
+    connections->add(2);
+    latency->update(1500);
+
+    std::vector<MetricSample> samples;
+    registry.collect(samples);
+    ASSERT_EQ(4u, samples.size());
+    EXPECT_EQ("connections", samples[0].m_name);
+    EXPECT_EQ(MetricType::Gauge, samples[0].m_type);
+    EXPECT_EQ(2, samples[0].m_value);
+    EXPECT_EQ("latency_max_ns", samples[1].m_name);
+    EXPECT_EQ(1500, samples[1].m_value);
+    EXPECT_EQ("requests_total", samples[2].m_name);
+    EXPECT_EQ(3, samples[2].m_value);
+    EXPECT_EQ(ShardedMaxTracker::Empty, samples[3].m_value);
+
+    std::string report;
+    registry.report(report, true);
+    EXPECT_EQ("# TYPE connections gauge\nconnections 2\n"
+              "# TYPE latency_max_ns gauge\nlatency_max_ns 1500\n"
+              "# TYPE requests_total counter\nrequests_total 3\n", report);
+    EXPECT_EQ(ShardedMaxTracker::Empty, latency->get());
+}
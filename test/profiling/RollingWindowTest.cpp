@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/RollingWindow.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace CPPCore;
+
+class RollingWindowTest : public testing::Test {
+    // empty
+};
+
+TEST_F(RollingWindowTest, emptyTest) {
+    RollingWindow window(4);
+    EXPECT_TRUE(window.isEmpty());
+    EXPECT_GT(window.getMin(), window.getMax());
+    EXPECT_EQ(0.0, window.getMean());
+    EXPECT_EQ(0.0, window.getVariance());
+    EXPECT_EQ(0.0f, window.getPercentile(0.5f));
+    EXPECT_EQ(0.0f, window.computeSum());
+
+    window.add(2.0f);
+    window.clear();
+    EXPECT_TRUE(window.isEmpty());
+    EXPECT_EQ(0.0, window.getSum());
+}
+
+TEST_F(RollingWindowTest, aggregatesTest) {
+    // Compare against a rescan of the last samples after every update
+    const size_t capacity = 37;
+    RollingWindow window(capacity);
+    std::vector<float> samples;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    for (size_t i = 0; i < 1000; ++i) {
+        const float sample = distribution(random);
+        window.add(sample);
+        samples.push_back(sample);
+
+        const size_t count = std::min(samples.size(), capacity);
+        const std::vector<float> last(samples.end() - static_cast<ptrdiff_t>(count), samples.end());
+        ASSERT_EQ(count, window.size());
+        EXPECT_EQ(*std::min_element(last.begin(), last.end()), window.getMin());
+        EXPECT_EQ(*std::max_element(last.begin(), last.end()), window.getMax());
+
+        double sum = 0.0;
+        double sumSq = 0.0;
+        for (float value : last) {
+            sum += value;
+            sumSq += static_cast<double>(value) * value;
+        }
+        const double mean = sum / static_cast<double>(count);
+        EXPECT_NEAR(sum, window.getSum(), 1e-9);
+        EXPECT_NEAR(mean, window.getMean(), 1e-9);
+        EXPECT_NEAR(sumSq / static_cast<double>(count) - mean * mean, window.getVariance(), 1e-6);
+
+        float min = 0.0f;
+        float max = 0.0f;
+        window.computeMinMax(min, max);
+        EXPECT_EQ(window.getMin(), min);
+        EXPECT_EQ(window.getMax(), max);
+        EXPECT_NEAR(sum, window.computeSum(), 1e-2);
+    }
+}
+
+TEST_F(RollingWindowTest, percentileTest) {
+    RollingWindow window(5);
+    for (float sample : { 100.0f, 9.0f, 1.0f, 5.0f, 3.0f, 7.0f }) {
+        window.add(sample);
+    }
+
+    // The window holds 9, 1, 5, 3, 7
+    EXPECT_EQ(1.0f, window.getPercentile(0.0f));
+    EXPECT_EQ(5.0f, window.getPercentile(0.5f));
+    EXPECT_EQ(9.0f, window.getPercentile(1.0f));
+    EXPECT_EQ(7.0f, window.getPercentile(0.7f));
+    EXPECT_EQ(9.0f, window.getMax());
+}
+
+TEST_F(RollingWindowTest, largeOffsetTest) {
+    // Latencies around one second in nanoseconds with a small spread, floats are 64 apart there
+    const size_t capacity = 100;
+    RollingWindow window(capacity);
+    std::vector<float> samples;
+    std::mt19937 random(11);
+    for (size_t i = 0; i < 1000; ++i) {
+        const float sample = 1e9f + static_cast<float>(random() % 16) * 64.0f + static_cast<float>(i / 250) * 1e6f;
+        window.add(sample);
+        samples.push_back(sample);
+
+        // The reference is two-pass, it does not cancel out
+        const size_t count = std::min(samples.size(), capacity);
+        double mean = 0.0;
+        for (size_t j = samples.size() - count; j < samples.size(); ++j) {
+            mean += samples[j];
+        }
+        mean /= static_cast<double>(count);
+        double variance = 0.0;
+        for (size_t j = samples.size() - count; j < samples.size(); ++j) {
+            variance += (samples[j] - mean) * (samples[j] - mean);
+        }
+        variance /= static_cast<double>(count);
+
+        EXPECT_NEAR(mean, window.getMean(), 1e-3);
+        EXPECT_NEAR(variance, window.getVariance(), 1e-6 * variance + 1e-3);
+    }
+}
@@ -0,0 +1,127 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Profiling/SamplingProfiler.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace CPPCore;
+
+class SamplingProfilerTest : public testing::Test {
+protected:
+    // empty
+};
+
+// Keep the workload out of line, it must show up as an own frame in the samples.
+CPPCORE_NOINLINE double samplingProfilerWorkload(size_t milliseconds) {
+    volatile double sum = 0.0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(milliseconds)) {
+        for (int i = 1; i < 10000; ++i) {
+            sum = sum + 1.0 / static_cast<double>(i);
+        }
+    }
+
+    return sum;
+}
+
+TEST_F(SamplingProfilerTest, createTest) {
+    SamplingProfiler profiler;
+    EXPECT_FALSE(profiler.isRunning());
+    EXPECT_EQ(SamplingProfiler::DefaultFrequency, profiler.getFrequency());
+    EXPECT_EQ(0u, profiler.numSamples());
+    EXPECT_EQ(0u, profiler.numDropped());
+}
+
+TEST_F(SamplingProfilerTest, setFrequencyTest) {
+    SamplingProfiler profiler(100);
+    profiler.setFrequency(500);
+    EXPECT_EQ(500u, profiler.getFrequency());
+}
+
+#ifdef CPPCORE_GNU_LINUX
+
+TEST_F(SamplingProfilerTest, onlyOneActiveTest) {
+    SamplingProfiler first, second;
+    EXPECT_TRUE(first.start());
+    EXPECT_FALSE(second.start());
+    first.stop();
+    EXPECT_TRUE(second.start());
+    second.stop();
+}
+
+TEST_F(SamplingProfilerTest, resolveTest) {
+    Symbolizer symbolizer;
+    std::string name;
+    EXPECT_TRUE(symbolizer.resolve(reinterpret_cast<uintptr_t>(&samplingProfilerWorkload), name));
+    EXPECT_NE(std::string::npos, name.find("samplingProfilerWorkload"));
+}
+
+TEST_F(SamplingProfilerTest, sampleWorkloadTest) {
+    SamplingProfiler profiler(1000);
+    EXPECT_TRUE(profiler.start());
+    samplingProfilerWorkload(200);
+    profiler.stop();
+    EXPECT_FALSE(profiler.isRunning());
+    ASSERT_LT(0u, profiler.numSamples());
+
+    std::string folded;
+    profiler.writeFoldedStacks(folded);
+    EXPECT_NE(std::string::npos, folded.find("samplingProfilerWorkload"));
+    EXPECT_EQ('\n', folded[folded.size() - 1]);
+
+    profiler.clear();
+    EXPECT_EQ(0u, profiler.numSamples());
+}
+
+TEST_F(SamplingProfilerTest, registerThreadTest) {
+    SamplingProfiler profiler(1000);
+    EXPECT_TRUE(profiler.start());
+    std::thread worker([]() {
+        EXPECT_TRUE(SamplingProfiler::registerThread());
+        samplingProfilerWorkload(200);
+    });
+    worker.join();
+    profiler.stop();
+    ASSERT_LT(0u, profiler.numSamples());
+
+    size_t maxFrames = 0;
+    for (size_t i = 0; i < profiler.numSamples(); ++i) {
+        maxFrames = std::max<size_t>(maxFrames, profiler.getSample(i).m_numFrames);
+    }
+    EXPECT_LT(1u, maxFrames);
+}
+
+TEST_F(SamplingProfilerTest, dropWhenFullTest) {
+    SamplingProfiler profiler(1000, 4);
+    EXPECT_TRUE(profiler.start());
+    samplingProfilerWorkload(100);
+    profiler.stop();
+    EXPECT_EQ(4u, profiler.numSamples());
+    EXPECT_LT(0u, profiler.numDropped());
+}
+
+#endif // CPPCORE_GNU_LINUX
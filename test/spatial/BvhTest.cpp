@@ -0,0 +1,157 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/Bvh.h>
+#include <cppcore/Threading/TaskScheduler.h>
+
+#include <gtest/gtest.h>
+
+#include "SpatialTestHelper.h"
+
+#include <algorithm>
+
+using namespace CPPCore;
+
+class BvhTest : public testing::Test {
+protected:
+    static std::vector<Float3> createPoints(size_t count) {
+        return SpatialTestHelper::createPoints(count, 12345);
+    }
+
+    static std::vector<uint32_t> sorted(std::vector<uint32_t> indices) {
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+};
+
+TEST_F(BvhTest, emptyTest) {
+    Bvh bvh;
+    EXPECT_TRUE(bvh.isEmpty());
+    std::vector<uint32_t> result;
+    EXPECT_EQ(0u, bvh.queryBox(BoundingBox{ Float3{ 0, 0, 0 }, Float3{ 1, 1, 1 } }, result));
+    EXPECT_EQ(0u, bvh.querySphere(Float3{ 0, 0, 0 }, 10.0f, result));
+
+    uint32_t hit = 0;
+    const Ray ray{ Float3{ 0, 0, 0 }, Float3{ 1, 0, 0 } };
+    EXPECT_EQ(5.0f, bvh.intersectRay(ray, 5.0f, [](uint32_t) { return 1.0f; }, hit));
+    EXPECT_EQ(InvalidSpatialIndex, hit);
+}
+
+TEST_F(BvhTest, queryTest) {
+    static const size_t NumPoints = 20000;
+    const std::vector<Float3> points = createPoints(NumPoints);
+    TaskScheduler scheduler(4);
+    BvhOptions options;
+    options.m_parallelThreshold = 1000;
+    options.m_scheduler = &scheduler;
+    Bvh bvh;
+    bvh.build(points.data(), points.size(), options);
+    EXPECT_EQ(NumPoints, bvh.getNumPrimitives());
+    EXPECT_LT(0u, bvh.getNumNodes());
+
+    for (size_t query = 0; query < 50; ++query) {
+        const Float3 &center = points[query * 97];
+        const BoundingBox box{ center - Float3{ 3, 4, 5 }, center + Float3{ 5, 4, 3 } };
+        std::vector<uint32_t> expectedBox;
+        std::vector<uint32_t> expectedSphere;
+        for (uint32_t i = 0; i < NumPoints; ++i) {
+            if (box.contains(points[i])) {
+                expectedBox.push_back(i);
+            }
+            if (getDistanceSq(points[i], center) <= 16.0f) {
+                expectedSphere.push_back(i);
+            }
+        }
+
+        std::vector<uint32_t> result;
+        EXPECT_EQ(expectedBox.size(), bvh.queryBox(box, result));
+        EXPECT_EQ(expectedBox, sorted(result));
+        result.clear();
+        EXPECT_EQ(expectedSphere.size(), bvh.querySphere(center, 4.0f, result));
+        EXPECT_EQ(expectedSphere, sorted(result));
+    }
+}
+
+TEST_F(BvhTest, intersectRayTest) {
+    // Small cubes around the points, the ray hits the nearest one
+    static const size_t NumBoxes = 5000;
+    const std::vector<Float3> points = createPoints(NumBoxes);
+    std::vector<BoundingBox> boxes(NumBoxes);
+    for (size_t i = 0; i < NumBoxes; ++i) {
+        boxes[i] = BoundingBox{ points[i] - Float3::filled(0.5f), points[i] + Float3::filled(0.5f) };
+    }
+    Bvh bvh;
+    bvh.build(boxes.data(), boxes.size());
+
+    auto intersectBox = [](const Ray &ray, const BoundingBox &box) {
+        float nearDist = 0.0f;
+        float farDist = std::numeric_limits<float>::infinity();
+        for (size_t axis = 0; axis < 3; ++axis) {
+            const float t0 = (box.m_min[axis] - ray.m_origin[axis]) / ray.m_direction[axis];
+            const float t1 = (box.m_max[axis] - ray.m_origin[axis]) / ray.m_direction[axis];
+            nearDist = std::max(nearDist, std::min(t0, t1));
+            farDist = std::min(farDist, std::max(t0, t1));
+        }
+        return nearDist <= farDist ? nearDist : -1.0f;
+    };
+
+    size_t numHits = 0;
+    for (size_t query = 0; query < 50; ++query) {
+        const Ray ray{ points[query * 13] + Float3{ 0.0f, 0.0f, 0.75f }, Float3{ 0.3f, -0.2f, 1.0f } };
+        float expected = 1000.0f;
+        for (size_t i = 0; i < NumBoxes; ++i) {
+            const float distance = intersectBox(ray, boxes[i]);
+            if (0.0f <= distance && distance < expected) {
+                expected = distance;
+            }
+        }
+
+        uint32_t hit = InvalidSpatialIndex;
+        const float distance = bvh.intersectRay(ray, 1000.0f, [&](uint32_t index) {
+            return intersectBox(ray, boxes[index]);
+        }, hit);
+        EXPECT_EQ(expected, distance);
+        if (1000.0f == expected) {
+            EXPECT_EQ(InvalidSpatialIndex, hit);
+            continue;
+        }
+        ++numHits;
+        ASSERT_NE(InvalidSpatialIndex, hit);
+        EXPECT_EQ(expected, intersectBox(ray, boxes[hit]));
+    }
+    EXPECT_LT(0u, numHits);
+}
+
+TEST_F(BvhTest, degenerateTest) {
+    // Equal points cannot be binned and are split at the median
+    const std::vector<Float3> points(1000, Float3{ 1, 2, 3 });
+    Bvh bvh;
+    bvh.build(points.data(), points.size());
+    std::vector<uint32_t> result;
+    EXPECT_EQ(1000u, bvh.querySphere(Float3{ 1, 2, 3 }, 0.0f, result));
+    result.clear();
+    EXPECT_EQ(0u, bvh.querySphere(Float3{ 2, 2, 3 }, 0.5f, result));
+
+    bvh.build(points.data(), 3);
+    EXPECT_EQ(0u, bvh.getNumNodes());
+    EXPECT_EQ(3u, bvh.querySphere(Float3{ 1, 2, 3 }, 0.0f, result));
+}
@@ -0,0 +1,121 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/HashGrid.h>
+
+#include <gtest/gtest.h>
+
+#include "SpatialTestHelper.h"
+
+#include <algorithm>
+
+using namespace CPPCore;
+
+class HashGridTest : public testing::Test {
+protected:
+    static Float3 createPoint(unsigned int &state) {
+        return SpatialTestHelper::createPoint(state, -50.0f);
+    }
+};
+
+TEST_F(HashGridTest, insertRemoveTest) {
+    HashGrid grid(1.0f);
+    EXPECT_EQ(0u, grid.size());
+    grid.insert(5, Float3{ 1.5f, 2.5f, 3.5f });
+    EXPECT_EQ(1u, grid.size());
+    EXPECT_TRUE(grid.hasPoint(5));
+    EXPECT_FALSE(grid.hasPoint(4));
+    EXPECT_EQ((Float3{ 1.5f, 2.5f, 3.5f }), grid.getPoint(5));
+
+    grid.move(5, Float3{ -1.5f, 2.5f, 3.5f });
+    EXPECT_EQ(1u, grid.size());
+    std::vector<uint32_t> result;
+    EXPECT_EQ(0u, grid.queryRadius(Float3{ 1.5f, 2.5f, 3.5f }, 1.0f, result));
+    EXPECT_EQ(1u, grid.queryRadius(Float3{ -1.5f, 2.5f, 3.5f }, 1.0f, result));
+    EXPECT_EQ(5u, result[0]);
+
+    EXPECT_TRUE(grid.remove(5));
+    EXPECT_FALSE(grid.remove(5));
+    EXPECT_EQ(0u, grid.size());
+    result.clear();
+    EXPECT_EQ(0u, grid.queryRadius(Float3{ -1.5f, 2.5f, 3.5f }, 1.0f, result));
+}
+
+TEST_F(HashGridTest, queryTest) {
+    static const uint32_t NumPoints = 5000;
+    HashGrid grid(2.0f);
+    std::vector<Float3> points(NumPoints);
+    unsigned int state = 42;
+    for (uint32_t i = 0; i < NumPoints; ++i) {
+        points[i] = createPoint(state);
+        grid.insert(i, points[i]);
+    }
+
+    // Move, remove and insert again, the queries must follow
+    for (size_t round = 0; round < 3; ++round) {
+        for (uint32_t i = 0; i < NumPoints; i += 3) {
+            points[i] = points[i] + Float3{ 0.7f, -1.3f, 2.9f };
+            grid.move(i, points[i]);
+        }
+        for (uint32_t i = 1; i < NumPoints; i += 7) {
+            grid.remove(i);
+        }
+
+        for (size_t query = 0; query < 30; ++query) {
+            const Float3 center = createPoint(state);
+            const float radius = 1.0f + static_cast<float>(query % 5) * 1.5f;
+            const BoundingBox box{ center - Float3{ 3, 2, 1 }, center + Float3{ 1, 2, 3 } };
+            std::vector<uint32_t> expectedRadius;
+            std::vector<uint32_t> expectedBox;
+            for (uint32_t i = 0; i < NumPoints; ++i) {
+                if (!grid.hasPoint(i)) {
+                    continue;
+                }
+                if (getDistanceSq(points[i], center) <= radius * radius) {
+                    expectedRadius.push_back(i);
+                }
+                if (box.contains(points[i])) {
+                    expectedBox.push_back(i);
+                }
+            }
+
+            std::vector<uint32_t> result;
+            EXPECT_EQ(expectedRadius.size(), grid.queryRadius(center, radius, result));
+            std::sort(result.begin(), result.end());
+            EXPECT_EQ(expectedRadius, result);
+            result.clear();
+            EXPECT_EQ(expectedBox.size(), grid.queryBox(box, result));
+            std::sort(result.begin(), result.end());
+            EXPECT_EQ(expectedBox, result);
+        }
+
+        for (uint32_t i = 1; i < NumPoints; i += 7) {
+            grid.insert(i, points[i]);
+        }
+    }
+
+    // A huge radius scans all points
+    std::vector<uint32_t> result;
+    EXPECT_EQ(grid.size(), grid.queryRadius(Float3{ 0, 0, 0 }, 1.0e6f, result));
+    grid.clear();
+    EXPECT_EQ(0u, grid.size());
+}
@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Spatial/KdTree.h>
+#include <cppcore/Threading/TaskScheduler.h>
+
+#include <gtest/gtest.h>
+
+#include "SpatialTestHelper.h"
+
+#include <algorithm>
+
+using namespace CPPCore;
+
+class KdTreeTest : public testing::Test {
+protected:
+    static std::vector<Float3> createPoints(size_t count) {
+        return SpatialTestHelper::createPoints(count, 4711);
+    }
+};
+
+TEST_F(KdTreeTest, emptyTest) {
+    KdTree tree;
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_EQ(InvalidSpatialIndex, tree.findNearest(Float3{ 0, 0, 0 }));
+    std::vector<uint32_t> result;
+    EXPECT_EQ(0u, tree.queryRadius(Float3{ 0, 0, 0 }, 1.0f, result));
+}
+
+TEST_F(KdTreeTest, findNearestTest) {
+    static const size_t NumPoints = 20000;
+    static const size_t K = 8;
+    const std::vector<Float3> points = createPoints(NumPoints);
+    TaskScheduler scheduler(4);
+    KdTreeOptions options;
+    options.m_parallelThreshold = 1000;
+    options.m_scheduler = &scheduler;
+    KdTree tree;
+    tree.build(points.data(), points.size(), options);
+    EXPECT_EQ(NumPoints, tree.getNumPoints());
+
+    const std::vector<Float3> queries = createPoints(NumPoints + 100);
+    for (size_t query = NumPoints; query < queries.size(); ++query) {
+        const Float3 &center = queries[query];
+        std::vector<float> expected(NumPoints);
+        for (size_t i = 0; i < NumPoints; ++i) {
+            expected[i] = getDistanceSq(points[i], center);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        uint32_t indices[K];
+        float distancesSq[K];
+        ASSERT_EQ(K, tree.findNearest(center, K, indices, distancesSq));
+        for (size_t i = 0; i < K; ++i) {
+            EXPECT_EQ(expected[i], distancesSq[i]);
+            EXPECT_EQ(distancesSq[i], getDistanceSq(points[indices[i]], center));
+        }
+        EXPECT_EQ(expected[0], getDistanceSq(points[tree.findNearest(center)], center));
+
+        // A short search radius returns fewer points
+        const size_t numInside = std::upper_bound(expected.begin(), expected.end(), 4.0f) - expected.begin();
+        EXPECT_EQ(std::min(K, numInside), tree.findNearest(center, K, indices, distancesSq, 2.0f));
+    }
+}
+
+TEST_F(KdTreeTest, queryRadiusTest) {
+    static const size_t NumPoints = 5000;
+    const std::vector<Float3> points = createPoints(NumPoints);
+    KdTree tree;
+    tree.build(points.data(), points.size());
+    for (size_t query = 0; query < 50; ++query) {
+        const Float3 &center = points[query * 31];
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < NumPoints; ++i) {
+            if (getDistanceSq(points[i], center) <= 25.0f) {
+                expected.push_back(i);
+            }
+        }
+
+        std::vector<uint32_t> result;
+        EXPECT_EQ(expected.size(), tree.queryRadius(center, 5.0f, result));
+        std::sort(result.begin(), result.end());
+        EXPECT_EQ(expected, result);
+    }
+}
+
+TEST_F(KdTreeTest, smallTreeTest) {
+    const std::vector<Float3> points = createPoints(3);
+    KdTree tree;
+    tree.build(points.data(), points.size());
+    uint32_t indices[8];
+    float distancesSq[8];
+    EXPECT_EQ(3u, tree.findNearest(points[1], 8, indices, distancesSq));
+    EXPECT_EQ(1u, indices[0]);
+    EXPECT_EQ(0.0f, distancesSq[0]);
+}
@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <cppcore/Spatial/SpatialTypes.h>
+
+#include <vector>
+
+namespace SpatialTestHelper {
+
+/// @brief  Creates a pseudo-random point with coordinates in [offset, offset + 100). A linear
+///         congruential generator is used, so the point sets are the same on all platforms.
+/// @param  state   [inout] The generator state.
+/// @param  offset  [in] The offset added to every coordinate.
+/// @return The point.
+inline CPPCore::Float3 createPoint(unsigned int &state, float offset = 0.0f) {
+    CPPCore::Float3 point;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        state = state * 1103515245u + 12345u;
+        point[axis] = static_cast<float>((state >> 8) % 10000) / 100.0f + offset;
+    }
+    return point;
+}
+
+/// @brief  Creates a set of pseudo-random points, see createPoint().
+/// @param  count   [in] The number of points.
+/// @param  seed    [in] The initial generator state.
+/// @return The points.
+inline std::vector<CPPCore::Float3> createPoints(size_t count, unsigned int seed) {
+    std::vector<CPPCore::Float3> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        points[i] = createPoint(seed);
+    }
+    return points;
+}
+
+} // Namespace SpatialTestHelper
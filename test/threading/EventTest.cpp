@@ -0,0 +1,74 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/Event.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class EventTest : public testing::Test {
+protected:
+    template <class Func>
+    static void runThreads(size_t numThreads, Func func) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(func));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+    }
+};
+
+TEST_F(EventTest, setResetTest) {
+    Event event;
+    EXPECT_FALSE(event.isSet());
+    event.set();
+    EXPECT_TRUE(event.isSet());
+    event.wait();
+    event.reset();
+    EXPECT_FALSE(event.isSet());
+
+    Event initiallySet(true);
+    EXPECT_TRUE(initiallySet.isSet());
+}
+
+TEST_F(EventTest, wakeAllTest) {
+    static const size_t NumWaiters = 4;
+    Event event;
+    std::atomic<size_t> woken(0);
+    std::thread setter([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        event.set();
+    });
+    runThreads(NumWaiters, [&]() {
+        event.wait();
+        ++woken;
+    });
+    setter.join();
+    EXPECT_EQ(NumWaiters, woken.load());
+}
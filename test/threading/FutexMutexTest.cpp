@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/FutexMutex.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class FutexMutexTest : public testing::Test {
+protected:
+    template <class Func>
+    static void runThreads(size_t numThreads, Func func) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(func));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+    }
+};
+
+TEST_F(FutexMutexTest, tryLockTest) {
+    FutexMutex lock;
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+TEST_F(FutexMutexTest, mutualExclusionTest) {
+    static const size_t NumThreads = 8;
+    static const size_t NumIterations = 20000;
+    FutexMutex lock;
+    size_t counter = 0;
+    runThreads(NumThreads, [&]() {
+        for (size_t i = 0; i < NumIterations; ++i) {
+            std::lock_guard<FutexMutex> guard(lock);
+            ++counter;
+        }
+    });
+    EXPECT_EQ(NumThreads * NumIterations, counter);
+}
+
+TEST_F(FutexMutexTest, sleepingWaiterTest) {
+    FutexMutex lock;
+    lock.lock();
+    bool acquired = false;
+    std::thread waiter([&]() {
+        lock.lock();
+        acquired = true;
+        lock.unlock();
+    });
+    // Long enough for the waiter to give up spinning and sleep on the futex
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lock.unlock();
+    waiter.join();
+    EXPECT_TRUE(acquired);
+}
@@ -0,0 +1,165 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/RateLimiter.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+static const uint64_t Millisecond = 1000000;
+static const uint64_t Second = 1000 * Millisecond;
+
+class RateLimiterTest : public testing::Test {
+    // empty
+};
+
+TEST_F(RateLimiterTest, tokenBucketTest) {
+    ManualClock clock(5 * Second);
+    TTokenBucket<ManualClock> bucket(10.0, 5, clock);
+    EXPECT_EQ(5u, bucket.getAvailable());
+
+    // The full burst, then nothing
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(bucket.tryAcquire());
+    }
+    EXPECT_FALSE(bucket.tryAcquire());
+    EXPECT_EQ(0u, bucket.getAvailable());
+    EXPECT_EQ(100 * Millisecond, bucket.getWaitTime());
+
+    // One token every 100 ms
+    clock.advance(99 * Millisecond);
+    EXPECT_FALSE(bucket.tryAcquire());
+    clock.advance(Millisecond);
+    EXPECT_TRUE(bucket.tryAcquire());
+    EXPECT_FALSE(bucket.tryAcquire());
+
+    // Idle time does not fill the bucket above its burst
+    clock.advance(10 * Second);
+    EXPECT_EQ(5u, bucket.getAvailable());
+    EXPECT_TRUE(bucket.tryAcquire(3));
+    EXPECT_FALSE(bucket.tryAcquire(3));
+    EXPECT_TRUE(bucket.tryAcquire(2));
+
+    // More than the burst can never be taken
+    clock.advance(10 * Second);
+    EXPECT_FALSE(bucket.tryAcquire(6));
+    EXPECT_EQ(5u, bucket.getAvailable());
+}
+
+TEST_F(RateLimiterTest, concurrentTokenBucketTest) {
+    static const size_t NumThreads = 8;
+
+    ManualClock clock(Second);
+    TTokenBucket<ManualClock> bucket(1000.0, 1000, clock);
+    std::atomic<size_t> accepted(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NumThreads; ++i) {
+        threads.push_back(std::thread([&bucket, &accepted]() {
+            for (size_t j = 0; j < 1000; ++j) {
+                if (bucket.tryAcquire()) {
+                    accepted.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(1000u, accepted.load());
+}
+
+TEST_F(RateLimiterTest, slidingWindowTest) {
+    ManualClock clock(0);
+    TSlidingWindowLimiter<ManualClock> limiter(3, Second, clock);
+    EXPECT_TRUE(limiter.tryAcquire());
+    clock.advance(400 * Millisecond);
+    EXPECT_TRUE(limiter.tryAcquire());
+    EXPECT_TRUE(limiter.tryAcquire());
+    EXPECT_FALSE(limiter.tryAcquire());
+    EXPECT_EQ(3u, limiter.getNumInWindow());
+
+    // The first event leaves the window after one second, the others 400 ms later
+    clock.set(Second - 1);
+    EXPECT_FALSE(limiter.tryAcquire());
+    clock.set(Second);
+    EXPECT_EQ(2u, limiter.getNumInWindow());
+    EXPECT_TRUE(limiter.tryAcquire());
+    EXPECT_FALSE(limiter.tryAcquire());
+    clock.set(1400 * Millisecond);
+    EXPECT_TRUE(limiter.tryAcquire());
+    EXPECT_TRUE(limiter.tryAcquire());
+    EXPECT_FALSE(limiter.tryAcquire());
+}
+
+TEST_F(RateLimiterTest, concurrentSlidingWindowTest) {
+    static const size_t NumThreads = 8;
+
+    ManualClock clock(0);
+    TSlidingWindowLimiter<ManualClock> limiter(100, Second, clock);
+    for (size_t round = 0; round < 3; ++round) {
+        std::atomic<size_t> accepted(0);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < NumThreads; ++i) {
+            threads.push_back(std::thread([&limiter, &accepted]() {
+                for (size_t j = 0; j < 100; ++j) {
+                    if (limiter.tryAcquire()) {
+                        accepted.fetch_add(1);
+                    }
+                }
+            }));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+        EXPECT_EQ(100u, accepted.load());
+        clock.advance(Second);
+    }
+}
+
+TEST_F(RateLimiterTest, keyedTest) {
+    ManualClock clock(0);
+    TKeyedRateLimiter<TTokenBucket<ManualClock>> limiters([&clock](unsigned int key) {
+        // Tenant 0 gets a larger burst
+        return new TTokenBucket<ManualClock>(1.0, 0 == key ? 4 : 2, clock);
+    }, 4);
+    EXPECT_EQ(0u, limiters.size());
+
+    for (unsigned int key = 0; key < 100; ++key) {
+        EXPECT_TRUE(limiters.tryAcquire(key));
+        EXPECT_TRUE(limiters.tryAcquire(key));
+    }
+    EXPECT_EQ(100u, limiters.size());
+    EXPECT_TRUE(limiters.tryAcquire(0));
+    EXPECT_TRUE(limiters.tryAcquire(0));
+    EXPECT_FALSE(limiters.tryAcquire(0));
+    EXPECT_FALSE(limiters.tryAcquire(1));
+    EXPECT_FALSE(limiters.tryAcquire(99));
+    EXPECT_EQ(limiters.get(42), limiters.get(42));
+
+    clock.advance(Second);
+    EXPECT_TRUE(limiters.tryAcquire(1));
+    EXPECT_FALSE(limiters.tryAcquire(1));
+}
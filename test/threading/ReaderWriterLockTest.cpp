@@ -0,0 +1,104 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/ReaderWriterLock.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class ReaderWriterLockTest : public testing::Test {
+protected:
+    template <class Func>
+    static void runThreads(size_t numThreads, Func func) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(func));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+    }
+};
+
+TEST_F(ReaderWriterLockTest, tryLockTest) {
+    ReaderWriterLock lock;
+    EXPECT_TRUE(lock.try_lock_shared());
+    EXPECT_TRUE(lock.try_lock_shared());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock_shared();
+    lock.unlock_shared();
+
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock_shared());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock_shared());
+    lock.unlock_shared();
+}
+
+TEST_F(ReaderWriterLockTest, readersAndWritersTest) {
+    static const size_t NumThreads = 8;
+    static const size_t NumIterations = 10000;
+    ReaderWriterLock lock;
+    size_t values[2] = { 0, 0 };
+    std::atomic<size_t> mismatches(0);
+    std::atomic<size_t> thread(0);
+    runThreads(NumThreads, [&]() {
+        const bool writer = 0 == thread.fetch_add(1) % 2;
+        for (size_t i = 0; i < NumIterations; ++i) {
+            if (writer) {
+                lock.lock();
+                ++values[0];
+                ++values[1];
+                lock.unlock();
+            } else {
+                lock.lock_shared();
+                if (values[0] != values[1]) {
+                    ++mismatches;
+                }
+                lock.unlock_shared();
+            }
+        }
+    });
+    EXPECT_EQ(0u, mismatches.load());
+    EXPECT_EQ(NumThreads / 2 * NumIterations, values[0]);
+}
+
+TEST_F(ReaderWriterLockTest, sleepingWriterTest) {
+    ReaderWriterLock lock;
+    lock.lock_shared();
+    bool written = false;
+    std::thread writer([&]() {
+        lock.lock();
+        written = true;
+        lock.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lock.unlock_shared();
+    writer.join();
+    EXPECT_TRUE(written);
+}
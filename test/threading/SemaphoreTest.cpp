@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/Semaphore.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class SemaphoreTest : public testing::Test {
+protected:
+    template <class Func>
+    static void runThreads(size_t numThreads, Func func) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(func));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+    }
+};
+
+TEST_F(SemaphoreTest, countTest) {
+    Semaphore semaphore(2);
+    EXPECT_EQ(2u, semaphore.getCount());
+    EXPECT_TRUE(semaphore.tryAcquire());
+    semaphore.acquire();
+    EXPECT_FALSE(semaphore.tryAcquire());
+    semaphore.release(3);
+    EXPECT_EQ(3u, semaphore.getCount());
+}
+
+TEST_F(SemaphoreTest, producerConsumerTest) {
+    static const size_t NumConsumers = 4;
+    static const size_t NumItems = 10000;
+    Semaphore semaphore;
+    std::atomic<size_t> consumed(0);
+    std::thread producer([&]() {
+        for (size_t i = 0; i < NumItems * NumConsumers; ++i) {
+            semaphore.release();
+        }
+    });
+    runThreads(NumConsumers, [&]() {
+        for (size_t i = 0; i < NumItems; ++i) {
+            semaphore.acquire();
+            ++consumed;
+        }
+    });
+    producer.join();
+    EXPECT_EQ(NumItems * NumConsumers, consumed.load());
+    EXPECT_EQ(0u, semaphore.getCount());
+}
@@ -0,0 +1,127 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TBoundedQueue.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TBoundedQueueTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TBoundedQueueTest, fifoTest) {
+    TBoundedQueue<int> queue(3);
+    EXPECT_EQ(4u, queue.capacity());
+    EXPECT_TRUE(queue.isEmpty());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(4u, queue.size());
+
+    int item = -1;
+    for (int round = 0; round < 10; ++round) {
+        EXPECT_TRUE(queue.tryPop(item));
+        EXPECT_EQ(round, item);
+        EXPECT_TRUE(queue.tryPush(round + 4));
+    }
+    for (int i = 10; i < 14; ++i) {
+        EXPECT_TRUE(queue.tryPop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_FALSE(queue.tryPop(item));
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(TBoundedQueueTest, moveOnlyTest) {
+    TBoundedQueue<std::unique_ptr<int>> queue(2);
+    EXPECT_TRUE(queue.tryPush(std::make_unique<int>(42)));
+    std::unique_ptr<int> item;
+    EXPECT_TRUE(queue.tryPop(item));
+    ASSERT_NE(nullptr, item);
+    EXPECT_EQ(42, *item);
+}
+
+TEST_F(TBoundedQueueTest, mpmcTest) {
+    static const size_t NumProducers = 4;
+    static const size_t NumConsumers = 4;
+    static const size_t NumItems = 20000;
+
+    TBoundedQueue<size_t> queue(64);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < NumProducers; ++p) {
+        threads.push_back(std::thread([&queue, p]() {
+            for (size_t i = 0; i < NumItems; ++i) {
+                while (!queue.tryPush(p * NumItems + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<std::vector<size_t>> received(NumConsumers);
+    std::atomic<size_t> numReceived(0);
+    for (size_t c = 0; c < NumConsumers; ++c) {
+        threads.push_back(std::thread([&queue, &received, &numReceived, c]() {
+            size_t item = 0;
+            while (numReceived.load() < NumProducers * NumItems) {
+                if (queue.tryPop(item)) {
+                    received[c].push_back(item);
+                    numReceived.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+
+    // Every item arrives once and each consumer sees the items of a producer in order
+    std::vector<bool> seen(NumProducers * NumItems, false);
+    for (size_t c = 0; c < NumConsumers; ++c) {
+        std::vector<size_t> last(NumProducers, 0);
+        std::vector<bool> hasLast(NumProducers, false);
+        for (size_t i = 0; i < received[c].size(); ++i) {
+            const size_t item = received[c][i];
+            const size_t producer = item / NumItems;
+            EXPECT_FALSE(seen[item]);
+            seen[item] = true;
+            if (hasLast[producer]) {
+                EXPECT_LT(last[producer], item);
+            }
+            last[producer] = item;
+            hasLast[producer] = true;
+        }
+    }
+    for (size_t i = 0; i < seen.size(); ++i) {
+        EXPECT_TRUE(seen[i]);
+    }
+}
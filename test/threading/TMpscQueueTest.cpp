@@ -0,0 +1,99 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TMpscQueue.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TMpscQueueTest : public testing::Test {
+protected:
+    struct Item : public MpscNode {
+        size_t m_producer;
+        size_t m_value;
+    };
+};
+
+TEST_F(TMpscQueueTest, fifoTest) {
+    TMpscQueue<Item> queue;
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(nullptr, queue.pop());
+
+    Item items[3];
+    for (size_t i = 0; i < 3; ++i) {
+        items[i].m_value = i;
+        queue.push(&items[i]);
+    }
+    EXPECT_FALSE(queue.isEmpty());
+    for (size_t i = 0; i < 3; ++i) {
+        Item *item = queue.pop();
+        ASSERT_NE(nullptr, item);
+        EXPECT_EQ(i, item->m_value);
+    }
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.isEmpty());
+
+    // Reuse after running empty
+    queue.push(&items[1]);
+    EXPECT_EQ(&items[1], queue.pop());
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(TMpscQueueTest, producersTest) {
+    static const size_t NumProducers = 4;
+    static const size_t NumItems = 20000;
+    TMpscQueue<Item> queue;
+    std::vector<Item> items(NumProducers * NumItems);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < NumProducers; ++p) {
+        threads.push_back(std::thread([&queue, &items, p]() {
+            for (size_t i = 0; i < NumItems; ++i) {
+                Item &item = items[p * NumItems + i];
+                item.m_producer = p;
+                item.m_value = i;
+                queue.push(&item);
+            }
+        }));
+    }
+
+    // Every producer's items must arrive in order
+    std::vector<size_t> expected(NumProducers, 0);
+    size_t numPopped = 0;
+    while (numPopped < NumProducers * NumItems) {
+        Item *item = queue.pop();
+        if (nullptr == item) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(expected[item->m_producer], item->m_value);
+        expected[item->m_producer] = item->m_value + 1;
+        ++numPopped;
+    }
+    for (size_t p = 0; p < threads.size(); ++p) {
+        threads[p].join();
+    }
+    EXPECT_EQ(nullptr, queue.pop());
+}
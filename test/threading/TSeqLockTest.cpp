@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TSeqLock.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace CPPCore;
+
+class TSeqLockTest : public testing::Test {
+protected:
+    struct Triple {
+        uint32_t m_a;
+        uint64_t m_b;
+        uint16_t m_c;
+    };
+};
+
+TEST_F(TSeqLockTest, storeLoadTest) {
+    Triple initial = { 1, 2, 3 };
+    TSeqLock<Triple> lock(initial);
+    const uint64_t sequence = lock.getSequence();
+    EXPECT_EQ(0u, sequence & 1);
+
+    Triple value = lock.load();
+    EXPECT_EQ(1u, value.m_a);
+    EXPECT_EQ(2u, value.m_b);
+    EXPECT_EQ(3u, value.m_c);
+
+    Triple next = { 4, 5, 6 };
+    lock.store(next);
+    EXPECT_EQ(sequence + 2, lock.getSequence());
+    EXPECT_TRUE(lock.tryLoad(value));
+    EXPECT_EQ(4u, value.m_a);
+    EXPECT_EQ(5u, value.m_b);
+    EXPECT_EQ(6u, value.m_c);
+}
+
+TEST_F(TSeqLockTest, consistentReadTest) {
+    static const uint32_t NumWrites = 50000;
+    TSeqLock<Triple> lock;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> torn(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            const Triple value = lock.load();
+            if (value.m_a != value.m_b || static_cast<uint16_t>(value.m_a) != value.m_c) {
+                ++torn;
+            }
+        }
+    });
+    for (uint32_t i = 1; i <= NumWrites; ++i) {
+        Triple value = { i, i, static_cast<uint16_t>(i) };
+        lock.store(value);
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(0u, torn.load());
+    EXPECT_EQ(NumWrites, lock.load().m_a);
+}
@@ -0,0 +1,158 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TSnapshotPublisher.h>
+#include <cppcore/Threading/Event.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TSnapshotPublisherTest : public testing::Test {
+protected:
+    struct Config {
+        static std::atomic<int> s_numAlive;
+
+        Config() :
+                m_version(0),
+                m_values(4, 0) {
+            ++s_numAlive;
+        }
+
+        Config(const Config &rhs) :
+                m_version(rhs.m_version),
+                m_values(rhs.m_values) {
+            ++s_numAlive;
+        }
+
+        ~Config() {
+            --s_numAlive;
+        }
+
+        int m_version;
+        std::vector<int> m_values;
+    };
+
+    void TearDown() override {
+        Rcu::barrier();
+    }
+};
+
+std::atomic<int> TSnapshotPublisherTest::Config::s_numAlive(0);
+
+TEST_F(TSnapshotPublisherTest, publishTest) {
+    {
+        TSnapshotPublisher<Config> publisher;
+        EXPECT_EQ(nullptr, publisher.read().get());
+
+        publisher.publish(new Config);
+        publisher.update([](Config &config) { config.m_version = 2; });
+        {
+            TSnapshotPublisher<Config>::Snapshot snapshot = publisher.read();
+            ASSERT_NE(nullptr, snapshot.get());
+            EXPECT_EQ(2, snapshot->m_version);
+            EXPECT_EQ(4u, (*snapshot).m_values.size());
+        }
+
+        Rcu::barrier();
+        EXPECT_EQ(1, Config::s_numAlive.load());
+    }
+    EXPECT_EQ(0, Config::s_numAlive.load());
+}
+
+TEST_F(TSnapshotPublisherTest, gracePeriodTest) {
+    TSnapshotPublisher<Config> publisher(new Config);
+    Event haveSnapshot;
+    Event released;
+    std::thread reader([&]() {
+        TSnapshotPublisher<Config>::Snapshot snapshot = publisher.read();
+        haveSnapshot.set();
+        released.wait();
+        EXPECT_EQ(0, snapshot->m_version);
+    });
+    haveSnapshot.wait();
+
+    // The old version is still in use by the reader
+    publisher.update([](Config &config) { config.m_version = 1; });
+    Rcu::reclaim();
+    EXPECT_EQ(2, Config::s_numAlive.load());
+    EXPECT_EQ(1, publisher.read()->m_version);
+
+    released.set();
+    reader.join();
+    Rcu::barrier();
+    EXPECT_EQ(1, Config::s_numAlive.load());
+}
+
+TEST_F(TSnapshotPublisherTest, concurrentReadersTest) {
+    static const size_t NumReaders = 4;
+    static const int NumUpdates = 2000;
+    TSnapshotPublisher<Config> publisher(new Config);
+    std::atomic<bool> done(false);
+    std::atomic<size_t> errors(0);
+
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < NumReaders; ++i) {
+        readers.push_back(std::thread([&]() {
+            int lastVersion = 0;
+            while (!done.load()) {
+                TSnapshotPublisher<Config>::Snapshot snapshot = publisher.read();
+                // Versions never go back and every version is internally consistent
+                if (snapshot->m_version < lastVersion || snapshot->m_values[3] != snapshot->m_version) {
+                    ++errors;
+                }
+                lastVersion = snapshot->m_version;
+            }
+        }));
+    }
+    for (int i = 1; i <= NumUpdates; ++i) {
+        publisher.update([i](Config &config) {
+            config.m_version = i;
+            for (size_t j = 0; j < config.m_values.size(); ++j) {
+                config.m_values[j] = i;
+            }
+        });
+    }
+    done = true;
+    for (size_t i = 0; i < readers.size(); ++i) {
+        readers[i].join();
+    }
+    EXPECT_EQ(0u, errors.load());
+
+    Rcu::barrier();
+    EXPECT_EQ(1, Config::s_numAlive.load());
+    EXPECT_EQ(0u, Rcu::numPending());
+}
+
+TEST_F(TSnapshotPublisherTest, nestedReadTest) {
+    TSnapshotPublisher<Config> first(new Config);
+    TSnapshotPublisher<Config> second(new Config);
+    TSnapshotPublisher<Config>::Snapshot a = first.read();
+    {
+        TSnapshotPublisher<Config>::Snapshot b = second.read();
+        EXPECT_EQ(0, b->m_version);
+    }
+    EXPECT_EQ(0, a->m_version);
+}
@@ -0,0 +1,100 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TWorkStealingQueue.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace CPPCore;
+
+class TWorkStealingQueueTest : public testing::Test {
+    // empty
+};
+
+TEST_F(TWorkStealingQueueTest, pushPopTest) {
+    TWorkStealingQueue<int*> queue(4);
+    EXPECT_EQ(4u, queue.capacity());
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(nullptr, queue.pop());
+
+    int values[5] = {};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.push(&values[i]));
+    }
+    EXPECT_FALSE(queue.push(&values[4]));
+
+    // The owner pops LIFO, thieves steal FIFO
+    EXPECT_EQ(&values[3], queue.pop());
+    EXPECT_EQ(&values[0], queue.steal());
+    EXPECT_EQ(&values[2], queue.pop());
+    EXPECT_EQ(&values[1], queue.pop());
+    EXPECT_EQ(nullptr, queue.steal());
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(TWorkStealingQueueTest, concurrentStealTest) {
+    static const size_t NumItems = 100000;
+    static const size_t NumThieves = 3;
+    std::vector<int> items(NumItems, 0);
+    TWorkStealingQueue<int*> queue(1024);
+    std::atomic<size_t> taken(0);
+
+    std::vector<std::thread> thieves;
+    for (size_t t = 0; t < NumThieves; ++t) {
+        thieves.push_back(std::thread([&]() {
+            while (taken.load() < NumItems) {
+                if (int *item = queue.steal()) {
+                    ++*item;
+                    ++taken;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    size_t pushed = 0;
+    while (pushed < NumItems) {
+        if (queue.push(&items[pushed])) {
+            ++pushed;
+        } else if (int *item = queue.pop()) {
+            ++*item;
+            ++taken;
+        }
+    }
+    while (int *item = queue.pop()) {
+        ++*item;
+        ++taken;
+    }
+    for (size_t t = 0; t < thieves.size(); ++t) {
+        thieves[t].join();
+    }
+
+    // Every item was taken exactly once
+    EXPECT_EQ(NumItems, taken.load());
+    for (size_t i = 0; i < NumItems; ++i) {
+        ASSERT_EQ(1, items[i]);
+    }
+}
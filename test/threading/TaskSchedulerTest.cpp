@@ -0,0 +1,88 @@
+/*-------------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2014-2022 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------------------------*/
+#include <cppcore/Threading/TaskScheduler.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace CPPCore;
+
+class TaskSchedulerTest : public testing::Test {
+protected:
+    static void spawnTree(TaskGroup &group, std::atomic<size_t> &counter, size_t depth) {
+        counter.fetch_add(1);
+        if (0 == depth) {
+            return;
+        }
+        group.run([&group, &counter, depth]() { spawnTree(group, counter, depth - 1); });
+        group.run([&group, &counter, depth]() { spawnTree(group, counter, depth - 1); });
+    }
+};
+
+TEST_F(TaskSchedulerTest, createTest) {
+    TaskScheduler inlineScheduler(1);
+    EXPECT_EQ(1u, inlineScheduler.getNumThreads());
+
+    TaskScheduler scheduler(4);
+    EXPECT_EQ(4u, scheduler.getNumThreads());
+    EXPECT_LE(1u, TaskScheduler::getDefault().getNumThreads());
+}
+
+TEST_F(TaskSchedulerTest, runTest) {
+    TaskScheduler scheduler(4);
+    std::atomic<size_t> counter(0);
+    TaskGroup group(scheduler);
+    for (size_t i = 0; i < 1000; ++i) {
+        group.run([&counter]() { counter.fetch_add(1); });
+    }
+    group.wait();
+    EXPECT_EQ(1000u, counter.load());
+}
+
+TEST_F(TaskSchedulerTest, nestedTest) {
+    // Tasks spawned by workers go to their own deques and get stolen from there
+    for (size_t numThreads = 1; numThreads <= 4; ++numThreads) {
+        TaskScheduler scheduler(numThreads);
+        std::atomic<size_t> counter(0);
+        TaskGroup group(scheduler);
+        group.run([&group, &counter]() { spawnTree(group, counter, 12); });
+        group.wait();
+        EXPECT_EQ((1u << 13) - 1, counter.load());
+    }
+}
+
+TEST_F(TaskSchedulerTest, exceptionTest) {
+    TaskScheduler scheduler(2);
+    TaskGroup group(scheduler);
+    std::atomic<size_t> counter(0);
+    group.run([]() { throw std::runtime_error("failed"); });
+    group.run([&counter]() { counter.fetch_add(1); });
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(1u, counter.load());
+
+    // The error has been consumed
+    group.run([&counter]() { counter.fetch_add(1); });
+    EXPECT_NO_THROW(group.wait());
+    EXPECT_EQ(2u, counter.load());
+}